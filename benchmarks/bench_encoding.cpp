@@ -8,6 +8,13 @@
  *   - API 风格对比 (返回值 vs 输出参数 vs Ex)
  *   - 批处理 vs 并行批处理 vs 逐条处理
  *   - 不同文本类型的影响 (ASCII vs CJK vs Emoji vs Mixed)
+ *   - 线程池调度开销 (工作窃取 vs 旧版互斥队列)
+ *   - 各转换路径 1..N 线程扩展曲线、小消息 p50/p99/p999 尾延迟
+ *   - 冷启动（描述符创建）、StringBufferPool 档位耗尽
+ *   - 真实语料（script/generate_test_files.py --bench-corpus）
+ *
+ * 版本间对比：--benchmark_out=<file>.json --benchmark_out_format=json 输出后
+ * 用 script/compare_bench.py 比较（或构建 UniConvBenchJson 目标）。
  */
 
 #ifdef _WIN32
@@ -22,6 +29,17 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
 
 #ifdef UNICONV_HAS_SIMDUTF
 #include <simdutf.h>
@@ -706,3 +724,1039 @@ static void BM_Mode_Stateless_BatchParallel(benchmark::State& state) {
     state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * total_bytes);
 }
 BENCHMARK(BM_Mode_Stateless_BatchParallel)->RangeMultiplier(4)->Range(16, 4096);
+
+// ============================================================================
+// 11. 线程池调度：工作窃取 vs 旧版互斥队列
+// ============================================================================
+namespace {
+
+/// 旧版 ThreadPool（单一互斥队列 + 每块一个 packaged_task），仅作为基准对照
+class LegacyQueueThreadPool {
+public:
+    explicit LegacyQueueThreadPool(size_t num_threads) {
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers_.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~LegacyQueueThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    template<typename F>
+    void ParallelFor(size_t total_items, F&& task_func, size_t min_chunk_size = 1) {
+        if (total_items == 0) return;
+        const size_t chunk_size = (std::max)(min_chunk_size, (total_items + workers_.size() - 1) / workers_.size());
+        std::vector<std::future<void>> futures;
+        futures.reserve((total_items + chunk_size - 1) / chunk_size);
+        for (size_t start = 0; start < total_items; start += chunk_size) {
+            const size_t end = (std::min)(start + chunk_size, total_items);
+            auto task = std::make_shared<std::packaged_task<void()>>([&task_func, start, end] { task_func(start, end); });
+            futures.emplace_back(task->get_future());
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                tasks_.emplace([task] { (*task)(); });
+            }
+            condition_.notify_one();
+        }
+        for (auto& future : futures) future.wait();
+    }
+
+private:
+    void WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex queue_mutex_;
+    std::condition_variable condition_;
+    bool stop_ = false;
+};
+
+size_t BenchPoolThreads() {
+    const size_t hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 4 : hw;
+}
+
+/// 偏斜负载：每 16 条中有 1 条 16KB 长文本，其余为 64B 短文本
+const std::vector<std::string>& SkewedInputs() {
+    static const std::vector<std::string> inputs = [] {
+        std::vector<std::string> v;
+        for (int i = 0; i < 4096; ++i) v.push_back(GenerateChinese(i % 16 == 0 ? 16384 : 64));
+        return v;
+    }();
+    return inputs;
+}
+
+template<typename Pool>
+void RunPoolConversion(benchmark::State& state, Pool& pool, const std::vector<std::string>& inputs) {
+    std::vector<std::string> outputs(inputs.size());
+    int64_t total_bytes = 0;
+    for (const auto& s : inputs) total_bytes += static_cast<int64_t>(s.size());
+
+    for (auto _ : state) {
+        pool.ParallelFor(inputs.size(), [&](size_t start, size_t end) {
+            auto& conv = UniConv::ThreadLocal();
+            for (size_t i = start; i < end; ++i) {
+                conv.ConvertEncodingFast(std::string_view(inputs[i]), "UTF-8", "GBK", outputs[i]);
+            }
+        });
+        benchmark::DoNotOptimize(outputs);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * total_bytes);
+}
+
+template<typename Pool>
+void RunPoolDispatch(benchmark::State& state, Pool& pool) {
+    const size_t items = static_cast<size_t>(state.range(0));
+    std::atomic<size_t> sink{0};
+    for (auto _ : state) {
+        pool.ParallelFor(items, [&sink](size_t start, size_t end) {
+            sink.fetch_add(end - start, std::memory_order_relaxed);
+        });
+    }
+    benchmark::DoNotOptimize(sink.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(items));
+}
+
+} // anonymous namespace
+
+static void BM_Pool_Legacy_Dispatch(benchmark::State& state) {
+    static LegacyQueueThreadPool pool(BenchPoolThreads());
+    RunPoolDispatch(state, pool);
+}
+BENCHMARK(BM_Pool_Legacy_Dispatch)->RangeMultiplier(8)->Range(8, 4096)->UseRealTime();
+
+static void BM_Pool_WorkStealing_Dispatch(benchmark::State& state) {
+    static ThreadPool pool(BenchPoolThreads());
+    RunPoolDispatch(state, pool);
+}
+BENCHMARK(BM_Pool_WorkStealing_Dispatch)->RangeMultiplier(8)->Range(8, 4096)->UseRealTime();
+
+static void BM_Pool_Legacy_SkewedBatch(benchmark::State& state) {
+    static LegacyQueueThreadPool pool(BenchPoolThreads());
+    RunPoolConversion(state, pool, SkewedInputs());
+}
+BENCHMARK(BM_Pool_Legacy_SkewedBatch)->UseRealTime();
+
+static void BM_Pool_WorkStealing_SkewedBatch(benchmark::State& state) {
+    static ThreadPool pool(BenchPoolThreads());
+    RunPoolConversion(state, pool, SkewedInputs());
+}
+BENCHMARK(BM_Pool_WorkStealing_SkewedBatch)->UseRealTime();
+
+// ============================================================================
+// 12. 偏斜批量：大量短文本 + 单个超大文档
+// ============================================================================
+
+static void BM_BatchParallel_SkewedOneLargeDoc(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    std::vector<std::string> inputs(10000, GenerateChinese(140));
+    inputs[inputs.size() / 2] = GenerateChinese(static_cast<size_t>(state.range(0)) << 20);
+    int64_t total_bytes = 0;
+    for (const auto& s : inputs) total_bytes += static_cast<int64_t>(s.size());
+
+    std::vector<std::string> outputs;
+    for (auto _ : state) {
+        conv->ConvertEncodingBatchParallel(inputs, "UTF-8", "GBK", outputs, 0);
+        benchmark::DoNotOptimize(outputs);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * total_bytes);
+    state.SetLabel("10k x 140B + 1 large (MB)");
+}
+BENCHMARK(BM_BatchParallel_SkewedOneLargeDoc)->Arg(8)->Arg(50)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// 13. 前导 ASCII 段预扫描：95% ASCII + 末尾少量 CJK 的 UTF-8 -> GBK
+// ============================================================================
+
+static void BM_AsciiPrefix_MostlyAsciiToGbk(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const size_t size = static_cast<size_t>(state.range(0));
+    const std::string tail = GenerateChinese(size / 20);
+    std::string input(size - tail.size(), 'a');
+    input += tail;
+
+    std::string output;
+    for (auto _ : state) {
+        conv->ConvertEncodingFast(std::string_view(input), "UTF-8", "GBK", output);
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_AsciiPrefix_MostlyAsciiToGbk)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+// ============================================================================
+// 14. 内置单字节码页：CP1251 西里尔文本 <-> UTF-8（查表，不经 iconv）
+// ============================================================================
+
+static std::string GenerateCp1251(size_t size) {
+    // 每 8 字节一个空格，其余为 0xC0-0xFF 的西里尔字母
+    std::string s;
+    s.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        s.push_back(i % 8 == 7 ? ' ' : static_cast<char>(0xC0 + (i * 7) % 64));
+    }
+    return s;
+}
+
+static void BM_Sbcs_Cp1251ToUtf8(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = GenerateCp1251(static_cast<size_t>(state.range(0)));
+    std::string output;
+    for (auto _ : state) {
+        conv->ConvertEncodingFast(std::string_view(input), "CP1251", "UTF-8", output);
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Sbcs_Cp1251ToUtf8)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+static void BM_Sbcs_Utf8ToCp1251(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input =
+        conv->ConvertEncodingFast(GenerateCp1251(static_cast<size_t>(state.range(0))), "CP1251", "UTF-8").GetValue();
+    std::string output;
+    for (auto _ : state) {
+        conv->ConvertEncodingFast(std::string_view(input), "UTF-8", "CP1251", output);
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Sbcs_Utf8ToCp1251)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+// ============================================================================
+// 15. 内置双字节码页：中文 / 日文文本 UTF-8 <-> GBK、Shift_JIS（查表，不经 iconv）
+// ============================================================================
+
+static void BM_Dbcs_Utf8ToGbk(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = GenerateChinese(static_cast<size_t>(state.range(0)));
+    std::string output;
+    for (auto _ : state) {
+        conv->ConvertEncodingFast(std::string_view(input), "UTF-8", "GBK", output);
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Dbcs_Utf8ToGbk)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+static void BM_Dbcs_GbkToUtf8(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input =
+        conv->ConvertEncodingFast(GenerateChinese(static_cast<size_t>(state.range(0))), "UTF-8", "GBK").GetValue();
+    std::string output;
+    for (auto _ : state) {
+        conv->ConvertEncodingFast(std::string_view(input), "GBK", "UTF-8", output);
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Dbcs_GbkToUtf8)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+static void BM_Dbcs_ShiftJisToUtf8(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    // 平假名、片假名与常用汉字混排
+    static const char* const kPieces[] = {"\xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81\xAF",
+                                          "\xE3\x82\xAB\xE3\x82\xBF\xE3\x82\xAB\xE3\x83\x8A",
+                                          "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", ", "};
+    std::string utf8;
+    for (size_t i = 0; utf8.size() < static_cast<size_t>(state.range(0)); ++i) {
+        utf8 += kPieces[i % 4];
+    }
+    const std::string input = conv->ConvertEncodingFast(utf8, "UTF-8", "SHIFT_JIS").GetValue();
+    std::string output;
+    for (auto _ : state) {
+        conv->ConvertEncodingFast(std::string_view(input), "SHIFT_JIS", "UTF-8", output);
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Dbcs_ShiftJisToUtf8)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+// ============================================================================
+// 16. 编码检测：DetectEncoding（只读 64KB 前缀）vs 逐个候选整段试转换
+// ============================================================================
+
+static void BM_Detect_GbkText(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input =
+        conv->ConvertEncodingFast(GenerateChinese(static_cast<size_t>(state.range(0))), "UTF-8", "GBK").GetValue();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->DetectEncoding(input));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Detect_GbkText)->RangeMultiplier(16)->Range(4096, 1 << 20);
+
+static void BM_Detect_GuessByConversion(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input =
+        conv->ConvertEncodingFast(GenerateChinese(static_cast<size_t>(state.range(0))), "UTF-8", "GBK").GetValue();
+    std::string output;
+    for (auto _ : state) {
+        for (const char* candidate : {"UTF-8", "SHIFT_JIS", "BIG5", "GBK"}) {
+            if (conv->ConvertEncodingFast(std::string_view(input), candidate, "UTF-16LE", output) == ErrorCode::Success) {
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Detect_GuessByConversion)->RangeMultiplier(16)->Range(4096, 1 << 20);
+
+// ============================================================================
+// 17. 校验与计长：CountOutputUnits（不写输出）vs 完整转换
+// ============================================================================
+
+static void BM_Count_Utf8ToUtf16(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = GenerateChinese(static_cast<size_t>(state.range(0)));
+    size_t units = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->CountOutputUnits(input, "UTF-8", "UTF-16LE", units));
+        benchmark::DoNotOptimize(units);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Count_Utf8ToUtf16)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+static void BM_Count_Utf8ToUtf16_ByConversion(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = GenerateChinese(static_cast<size_t>(state.range(0)));
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "UTF-8", "UTF-16LE", output));
+        benchmark::DoNotOptimize(output.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Count_Utf8ToUtf16_ByConversion)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+static void BM_Validate_Gbk(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input =
+        conv->ConvertEncodingFast(GenerateChinese(static_cast<size_t>(state.range(0))), "UTF-8", "GBK").GetValue();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->Validate(input, "GBK"));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Validate_Gbk)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+static void BM_Validate_Gbk_ByConversion(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input =
+        conv->ConvertEncodingFast(GenerateChinese(static_cast<size_t>(state.range(0))), "UTF-8", "GBK").GetValue();
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "GBK", "UTF-8", output));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Validate_Gbk_ByConversion)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+// ============================================================================
+// 18. 容错转换：ErrorPolicy::Replace（坏序列后续接）vs 失败后修补并整段重转
+// ============================================================================
+
+// 每 4KB 插入一个非法字节的中文 UTF-8
+static std::string GenerateDirtyChinese(size_t size) {
+    std::string text = GenerateChinese(size);
+    for (size_t i = 4096; i < text.size(); i += 4096) {
+        text[i] = '\xFF';
+    }
+    return text;
+}
+
+static void BM_ErrorPolicy_Replace_Dirty(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = GenerateDirtyChinese(static_cast<size_t>(state.range(0)));
+    std::string output;
+    ConversionReport report;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(input, "UTF-8", "UTF-16LE", output,
+                                                           ErrorPolicy::Replace, &report));
+        benchmark::DoNotOptimize(output.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_ErrorPolicy_Replace_Dirty)->RangeMultiplier(8)->Range(8 << 10, 1 << 20);
+
+static void BM_ErrorPolicy_PatchAndRetry_Dirty(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = GenerateDirtyChinese(static_cast<size_t>(state.range(0)));
+    std::string output;
+    for (auto _ : state) {
+        // 调用方自行容错：定位坏字节、改成 '?'，再从头转换
+        std::string patched = input;
+        while (conv->ConvertEncodingFast(std::string_view(patched), "UTF-8", "UTF-16LE", output) != ErrorCode::Success) {
+            size_t offset = 0;
+            conv->Validate(patched, "UTF-8", offset);
+            patched[offset] = '?';
+        }
+        benchmark::DoNotOptimize(output.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_ErrorPolicy_PatchAndRetry_Dirty)->RangeMultiplier(8)->Range(8 << 10, 1 << 20);
+
+static void BM_ErrorPolicy_Replace_Clean(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = GenerateChinese(static_cast<size_t>(state.range(0)));
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(input, "UTF-8", "UTF-16LE", output, ErrorPolicy::Replace));
+        benchmark::DoNotOptimize(output.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_ErrorPolicy_Replace_Clean)->RangeMultiplier(8)->Range(8 << 10, 1 << 20);
+
+// ============================================================================
+// 19. iconv 描述符缓存：短字符串热路径（线程私有 CLOCK 槽位命中）与超出槽位数的编码对轮转
+// ============================================================================
+
+static void BM_DescriptorCache_ShortEucKr(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = conv->ConvertEncodingFast(std::string("\xED\x95\x9C\xEA\xB5\xAD\xEC\x96\xB4 text"),
+                                                        "UTF-8", "EUC-KR").GetValue();
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "EUC-KR", "UTF-8", output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_DescriptorCache_ShortEucKr)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_DescriptorCache_RotatingPairs(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    // 48 个编码对轮转，超出线程私有缓存的 32 个槽位，每次签出/归还都经过分片空闲池
+    const char* encodings[] = {
+        "EUC-KR", "euc-kr", "EUCKR", "euckr", "CP949", "EUC-TW", "CP932", "CP950",
+        "ARMSCII-8", "GEORGIAN-PS", "VISCII", "CP1255", "TIS-620", "CP852", "CP855", "CP857",
+        "CP860", "CP861", "CP863", "CP864", "CP865", "CP869", "UTF-16", "UTF-32",
+    };
+    const std::string input("a\0b\0c\0", 6);
+    std::string output;
+    for (auto _ : state) {
+        for (const char* encoding : encodings) {
+            benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "UTF-16LE", encoding, output));
+            benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "UTF-16BE", encoding, output));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 48);
+}
+BENCHMARK(BM_DescriptorCache_RotatingPairs)->ThreadRange(1, 8)->UseRealTime();
+
+// ============================================================================
+// 20. EncodingHandle：短字符串上名称接口（strlen + 哈希 + 名称校验）vs 句柄接口（查表）
+// ============================================================================
+
+static void BM_EncodingHandle_ShortUtf8ToUtf16_ByName(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = "order #1024 shipped";
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "UTF-8", "UTF-16LE", output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_EncodingHandle_ShortUtf8ToUtf16_ByName);
+
+static void BM_EncodingHandle_ShortUtf8ToUtf16_ByHandle(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = "order #1024 shipped";
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(input, UniConv::Encoding::utf_8,
+                                                           UniConv::Encoding::utf_16le, output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_EncodingHandle_ShortUtf8ToUtf16_ByHandle);
+
+static void BM_EncodingHandle_ShortEucKr_ByName(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = conv->ConvertEncodingFast(std::string("\xED\x95\x9C\xEA\xB5\xAD\xEC\x96\xB4"),
+                                                        "UTF-8", "EUC-KR").GetValue();
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "EUC-KR", "UTF-8", output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_EncodingHandle_ShortEucKr_ByName);
+
+static void BM_EncodingHandle_ShortEucKr_ByHandle(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = conv->ConvertEncodingFast(std::string("\xED\x95\x9C\xEA\xB5\xAD\xEC\x96\xB4"),
+                                                        "UTF-8", "EUC-KR").GetValue();
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(input, UniConv::Encoding::euc_kr,
+                                                           UniConv::Encoding::utf_8, output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_EncodingHandle_ShortEucKr_ByHandle);
+
+// ============================================================================
+// 21. 融合流水线：BOM 剥离 + 转换 + 换行 / NUL 规整，逐阶段整段处理 vs 按 64KB 块一次完成
+// ============================================================================
+
+/// 约 8MB 的 Windows 风格日志：UTF-16LE + BOM，CRLF 换行，夹杂中文
+static std::string MakeUtf16CrlfLog(UniConv& conv) {
+    const std::string line = "2024-05-01 12:00:00 INFO request served \xE8\xAF\xB7\xE6\xB1\x82\xE5\xAE\x8C\xE6\x88\x90\r\n";
+    std::string utf8;
+    while (utf8.size() < 4 * 1024 * 1024) {
+        utf8 += line;
+    }
+    return "\xFF\xFE" + conv.ConvertEncodingFast(utf8, "UTF-8", "UTF-16LE").GetValue();
+}
+
+static void BM_Pipeline_Utf16CrlfLog_SeparatePasses(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = MakeUtf16CrlfLog(*conv);
+    std::string converted;
+    std::string output;
+    for (auto _ : state) {
+        std::string_view payload(input);
+        if (payload.size() >= 2 && payload.compare(0, 2, "\xFF\xFE") == 0) {
+            payload.remove_prefix(2);
+        }
+        conv->ConvertEncodingFast(payload, "UTF-16LE", "UTF-8", converted);
+        output.clear();
+        for (size_t i = 0; i < converted.size(); ++i) {
+            if (converted[i] == '\r') {
+                output += '\n';
+                if (i + 1 < converted.size() && converted[i + 1] == '\n') {
+                    ++i;
+                }
+            } else {
+                output += converted[i];
+            }
+        }
+        output.erase(std::remove(output.begin(), output.end(), '\0'), output.end());
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Pipeline_Utf16CrlfLog_SeparatePasses)->Unit(benchmark::kMillisecond);
+
+static void BM_Pipeline_Utf16CrlfLog_Fused(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = MakeUtf16CrlfLog(*conv);
+    auto pipeline = conv->MakePipeline("UTF-16LE", "UTF-8");
+    pipeline.StripBom().NormalizeNewlines().StripNul();
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pipeline.Run(input, output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Pipeline_Utf16CrlfLog_Fused)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// 22. Unicode 正规化：先转换再单独 NFC vs 转换时融合 NFC（已正规的 CJK 日志 / 分解形式的拉丁文本）
+// ============================================================================
+static std::string MakeNormalizationText(UniConv& conv, bool decomposed) {
+    // 分解形式：e + U+0301、o + U+0308、か + U+3099
+    const std::string line = decomposed
+        ? "Cafe\xCC\x81 re\xCC\x81sume\xCC\x81 co\xCC\x88operate \xE3\x81\x8B\xE3\x82\x99 naive\xCC\x88\n"
+        : "2024-05-01 INFO \xE8\xAF\xB7\xE6\xB1\x82\xE5\xAE\x8C\xE6\x88\x90 user=\xE5\xBC\xA0\xE4\xB8\x89\n";
+    std::string utf8;
+    while (utf8.size() < 4 * 1024 * 1024) {
+        utf8 += line;
+    }
+    return conv.ConvertEncodingFast(utf8, "UTF-8", "UTF-16LE").GetValue();
+}
+
+static void BM_Normalize_Utf16ToNfc_SeparatePass(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = MakeNormalizationText(*conv, state.range(0) != 0);
+    std::string converted;
+    std::string output;
+    for (auto _ : state) {
+        conv->ConvertEncodingFast(input, "UTF-16LE", "UTF-8", converted);
+        benchmark::DoNotOptimize(UniConv::NormalizeUtf8(converted, NormalizationForm::NFC, output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Normalize_Utf16ToNfc_SeparatePass)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_Normalize_Utf16ToNfc_Fused(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const std::string input = MakeNormalizationText(*conv, state.range(0) != 0);
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            conv->ConvertEncodingFast(input, "UTF-16LE", "UTF-8", output, NormalizationForm::NFC));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Normalize_Utf16ToNfc_Fused)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// 23. 转换指标开销：短字符串 / 4KB 热路径（以 -DUNICONV_ENABLE_METRICS=ON 与默认构建对比）与快照合并
+// ============================================================================
+static void BM_Metrics_ConvertUtf8ToUtf16(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    std::string input;
+    while (input.size() < static_cast<size_t>(state.range(0))) {
+        input += "order #1024 \xE5\xB7\xB2\xE5\x8F\x91\xE8\xB4\xA7 ";
+    }
+    input.resize(static_cast<size_t>(state.range(0)));
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "UTF-8", "UTF-16LE", output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetLabel(UniConv::GetConversionMetrics().enabled ? "metrics on" : "metrics off");
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Metrics_ConvertUtf8ToUtf16)->Arg(19)->Arg(4096);
+
+static void BM_Metrics_Snapshot(benchmark::State& state) {
+    auto conv = UniConv::Create();
+    const char* const targets[] = {"UTF-16LE", "UTF-16BE", "UTF-32LE", "GBK", "BIG5", "SHIFT_JIS", "EUC-KR", "ISO-8859-1"};
+    std::string output;
+    for (const char* target : targets) {
+        conv->ConvertEncodingFast(std::string_view("abc \xC3\xA9"), "UTF-8", target, output);
+    }
+    for (auto _ : state) {
+        auto snapshot = UniConv::GetConversionMetrics();
+        benchmark::DoNotOptimize(snapshot.pairs.data());
+        benchmark::DoNotOptimize(snapshot.ToPrometheusText());
+    }
+}
+BENCHMARK(BM_Metrics_Snapshot);
+
+// ============================================================================
+// 24. 追踪钩子开销：未安装（Arg 0）与安装空回调（Arg 1）时的短字符串转换
+// ============================================================================
+static void BM_Tracing_ShortUtf8ToUtf16(benchmark::State& state) {
+    static const TraceHooks hooks{nullptr,
+                                  [](void*, const TraceSpan& span) { benchmark::DoNotOptimize(span.bytes_in); },
+                                  [](void*, const TraceSpan& span) { benchmark::DoNotOptimize(span.bytes_out); }};
+    auto conv = UniConv::Create();
+    const std::string input = "order #1024 \xE5\xB7\xB2\xE5\x8F\x91\xE8\xB4\xA7";
+    std::string output;
+    UniConv::SetTraceHooks(state.range(0) != 0 ? &hooks : nullptr);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "UTF-8", "UTF-16LE", output));
+        benchmark::DoNotOptimize(output.data());
+    }
+    UniConv::SetTraceHooks(nullptr);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_Tracing_ShortUtf8ToUtf16)->Arg(0)->Arg(1);
+
+// ============================================================================
+// 25. 线程扩展曲线：各转换路径在 1..N 线程下的吞吐量（共享同一实例，定位多线程塌缩）
+// ============================================================================
+namespace {
+
+struct ScalingPath {
+    const char* name;
+    const char* from;
+    const char* to;
+    bool chinese;     // 中文文本（否则 ASCII）
+    bool stateless;   // 走 ConvertEncodingStatelessFast
+};
+
+// 路径与 ConversionPath 对应：同编码拷贝 / ASCII 快速通道 / 内置 UTF / 内置双字节码页 / iconv / 每次 iconv_open
+const ScalingPath kScalingPaths[] = {
+    {"copy",        "UTF-8",  "UTF-8",    true,  false},
+    {"ascii",       "UTF-8",  "GBK",      false, false},
+    {"native_utf",  "UTF-8",  "UTF-16LE", true,  false},
+    {"native_dbcs", "UTF-8",  "GBK",      true,  false},
+    {"iconv",       "EUC-KR", "UTF-8",    false, false},
+    {"stateless",   "EUC-KR", "UTF-8",    false, true},
+};
+
+UniConv& SharedBenchConverter() {
+    static const std::unique_ptr<UniConv> conv = UniConv::Create();
+    return *conv;
+}
+
+int BenchMaxThreads() {
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+std::string MakeScalingInput(UniConv& conv, const ScalingPath& path, size_t bytes) {
+    if (std::string(path.from) == "EUC-KR") {
+        std::string korean;
+        while (korean.size() < bytes) {
+            korean += "\xED\x95\x9C\xEA\xB5\xAD\xEC\x96\xB4 \xED\x85\x8C\xEC\x8A\xA4\xED\x8A\xB8 log line 42\n"; // 한국어 테스트
+        }
+        korean.resize(bytes);
+        while (!korean.empty() && (static_cast<unsigned char>(korean.back()) & 0xC0) == 0x80) {
+            korean.pop_back();
+        }
+        if (!korean.empty() && static_cast<unsigned char>(korean.back()) >= 0xC0) {
+            korean.pop_back();
+        }
+        return conv.ConvertEncodingFast(korean, "UTF-8", "EUC-KR").GetValue();
+    }
+    return path.chinese ? GenerateChinese(bytes) : GenerateAscii(bytes);
+}
+
+} // namespace
+
+static void BM_Scaling_Path(benchmark::State& state) {
+    const ScalingPath& path = kScalingPaths[state.range(0)];
+    UniConv& conv = SharedBenchConverter();
+    const std::string input = MakeScalingInput(conv, path, static_cast<size_t>(state.range(1)));
+    std::string output;
+    for (auto _ : state) {
+        if (path.stateless) {
+            benchmark::DoNotOptimize(conv.ConvertEncodingStatelessFast(std::string_view(input), path.from, path.to, output));
+        } else {
+            benchmark::DoNotOptimize(conv.ConvertEncodingFast(std::string_view(input), path.from, path.to, output));
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+    state.SetLabel(std::string(path.name) + " " + std::to_string(input.size()) + "B x T" + std::to_string(state.threads()));
+}
+BENCHMARK(BM_Scaling_Path)
+    ->ArgsProduct({benchmark::CreateDenseRange(0, static_cast<int64_t>(std::size(kScalingPaths)) - 1, 1), {4096, 1 << 20}})
+    ->ArgNames({"path", "bytes"})
+    ->UseRealTime()
+    ->ThreadRange(1, BenchMaxThreads());
+
+// ============================================================================
+// 26. 尾延迟：16B-512B 小消息逐次计时，报告每线程 p50 / p99 / p999（纳秒，含计时开销 clock_ns）
+// ============================================================================
+namespace {
+
+// 对数线性直方图：每个 2 的幂区间再分 16 档，相对误差 < 6.25%，记录为 O(1)、不分配内存
+class LatencyHistogram {
+public:
+    void Record(uint64_t ns) noexcept {
+        ++m_buckets[BucketOf(ns)];
+        ++m_count;
+    }
+
+    /// 第 q 分位（0 < q < 1）所在档位的上界
+    double Percentile(double q) const noexcept {
+        const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(m_count));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += m_buckets[i];
+            if (seen > rank) {
+                return static_cast<double>(UpperBound(i));
+            }
+        }
+        return 0.0;
+    }
+
+private:
+    static constexpr size_t kSubBits = 4;
+    static constexpr size_t kSub = size_t(1) << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSub;
+
+    static size_t BucketOf(uint64_t ns) noexcept {
+        if (ns < kSub) {
+            return static_cast<size_t>(ns);
+        }
+        size_t log2 = 63;
+        while (!(ns >> log2)) {
+            --log2;
+        }
+        const size_t shift = log2 - kSubBits;
+        return (shift + 1) * kSub + static_cast<size_t>((ns >> shift) & (kSub - 1));
+    }
+
+    static uint64_t UpperBound(size_t bucket) noexcept {
+        if (bucket < kSub) {
+            return bucket;
+        }
+        const size_t shift = bucket / kSub - 1;
+        return ((kSub + bucket % kSub + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> m_buckets = std::vector<uint64_t>(kBuckets, 0);
+    uint64_t m_count = 0;
+};
+
+struct SmallMessage {
+    std::string text;
+    const char* from;
+    const char* to;
+};
+
+// 固定种子的小消息混合负载：UTF-8 → UTF-16LE / GBK（内置路径）与 UTF-8 → EUC-KR（iconv）
+std::vector<SmallMessage> MakeSmallMessages() {
+    const char* const pieces[] = {
+        "GET /api/v2/orders ", "\xE8\xAE\xA2\xE5\x8D\x95\xE5\xB7\xB2\xE5\x8F\x91\xE8\xB4\xA7 ",
+        "user=42 ", "\xE6\x94\xAF\xE4\xBB\x98\xE6\x88\x90\xE5\x8A\x9F ", "\xEC\xA3\xBC\xEB\xAC\xB8 ", "ok ",
+    };
+    const char* const targets[] = {"UTF-16LE", "GBK", "UTF-16LE", "EUC-KR"};
+    uint32_t seed = 20260301u;
+    auto next = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    std::vector<SmallMessage> messages;
+    for (size_t i = 0; i < 256; ++i) {
+        const size_t target_bytes = 16 + next() % (512 - 16);
+        const char* to = targets[next() % std::size(targets)];
+        std::string text;
+        while (text.size() < target_bytes) {
+            // EUC-KR 不含中文，只混入 ASCII 与韩文片段
+            const size_t piece = next() % std::size(pieces);
+            text += std::string(to) == "EUC-KR" && (piece == 1 || piece == 3) ? pieces[0] : pieces[piece];
+        }
+        messages.push_back({std::move(text), "UTF-8", to});
+    }
+    return messages;
+}
+
+double MeasureClockOverheadNs() {
+    using Clock = std::chrono::steady_clock;
+    LatencyHistogram histogram;
+    for (int i = 0; i < 10000; ++i) {
+        const auto begin = Clock::now();
+        const auto end = Clock::now();
+        histogram.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+    }
+    return histogram.Percentile(0.5);
+}
+
+} // namespace
+
+static void BM_TailLatency_SmallMessages(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    UniConv& conv = SharedBenchConverter();
+    static const std::vector<SmallMessage> messages = MakeSmallMessages();
+    LatencyHistogram histogram;
+    std::string output;
+    size_t next = static_cast<size_t>(state.thread_index()) * 61;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const SmallMessage& message = messages[next++ % messages.size()];
+        const auto begin = Clock::now();
+        benchmark::DoNotOptimize(conv.ConvertEncodingFast(std::string_view(message.text), message.from, message.to, output));
+        const auto end = Clock::now();
+        histogram.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+        bytes += static_cast<int64_t>(message.text.size());
+    }
+    state.counters["p50_ns"] = benchmark::Counter(histogram.Percentile(0.5), benchmark::Counter::kAvgThreads);
+    state.counters["p99_ns"] = benchmark::Counter(histogram.Percentile(0.99), benchmark::Counter::kAvgThreads);
+    state.counters["p999_ns"] = benchmark::Counter(histogram.Percentile(0.999), benchmark::Counter::kAvgThreads);
+    state.counters["clock_ns"] = benchmark::Counter(MeasureClockOverheadNs(), benchmark::Counter::kAvgThreads);
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_TailLatency_SmallMessages)->UseRealTime()->ThreadRange(1, BenchMaxThreads());
+
+// ============================================================================
+// 27. 冷启动：新实例 + 新线程上的首次 iconv 转换（iconv_open + 缓存插入），对照同一线程上的第二次调用
+// ============================================================================
+static void BM_ColdStart_FirstIconvConversion(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    const std::string input = "\xC7\xD1\xB1\xB9\xBE\xEE text"; // EUC-KR "한국어 text"
+    double warm_seconds = 0.0;
+    for (auto _ : state) {
+        auto conv = UniConv::Create();
+        double cold = 0.0;
+        double warm = 0.0;
+        // 新线程保证线程私有描述符缓存为空，新实例保证全局空闲池为空
+        std::thread worker([&] {
+            std::string output;
+            auto begin = Clock::now();
+            benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "EUC-KR", "UTF-8", output));
+            auto end = Clock::now();
+            cold = std::chrono::duration<double>(end - begin).count();
+            begin = Clock::now();
+            benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), "EUC-KR", "UTF-8", output));
+            end = Clock::now();
+            warm = std::chrono::duration<double>(end - begin).count();
+        });
+        worker.join();
+        state.SetIterationTime(cold);
+        warm_seconds += warm;
+    }
+    state.counters["warm_ns"] = benchmark::Counter(
+        warm_seconds * 1e9 / static_cast<double>(std::max<benchmark::IterationCount>(1, state.iterations())));
+}
+BENCHMARK(BM_ColdStart_FirstIconvConversion)->UseManualTime()->Iterations(2000)->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// 28. StringBufferPool 档位耗尽：预先占住 held 个租约后，单次签出 / 归还的成本（label 标明命中池或回退分配）
+// ============================================================================
+static void BM_BufferPool_TierExhaustion(benchmark::State& state) {
+    const size_t hint = static_cast<size_t>(state.range(0));
+    StringBufferPool pool;
+    std::vector<StringBufferPool::BufferLease> held;
+    for (int64_t i = 0; i < state.range(1); ++i) {
+        held.push_back(pool.acquire(hint));
+    }
+    bool from_pool = false;
+    for (auto _ : state) {
+        auto lease = pool.acquire(hint);
+        from_pool = lease.is_from_pool();
+        benchmark::DoNotOptimize(lease.get().data());
+    }
+    state.SetLabel(from_pool ? "pooled" : "fallback");
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+// 小档上限 256 个槽位，大档上限 32 个
+BENCHMARK(BM_BufferPool_TierExhaustion)
+    ->Args({4096, 0})
+    ->Args({4096, 320})
+    ->Args({1 << 17, 0})
+    ->Args({1 << 17, 31})
+    ->Args({1 << 17, 64})
+    ->ArgNames({"hint", "held"});
+
+// ============================================================================
+// 29. 真实语料：script/generate_test_files.py --bench-corpus 生成的 CJK 混合日志、脏数据、超大单文件
+//     目录默认 testdata/bench，可用环境变量 UNICONV_BENCH_CORPUS 指定；语料缺失时跳过
+// ============================================================================
+namespace {
+
+std::string CorpusPath(const char* name) {
+    const char* dir = std::getenv("UNICONV_BENCH_CORPUS");
+    return std::string(dir && *dir ? dir : "testdata/bench") + "/" + name;
+}
+
+bool LoadCorpus(benchmark::State& state, const char* name, std::string& data) {
+    std::ifstream file(CorpusPath(name), std::ios::binary);
+    if (!file) {
+        state.SkipWithError((CorpusPath(name) + " not found; run python script/generate_test_files.py --bench-corpus").c_str());
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace
+
+static void BM_Corpus_MixedCjkLog(benchmark::State& state) {
+    struct Case { const char* file; const char* from; const char* to; };
+    static const Case cases[] = {
+        {"mixed_cjk_log.txt",         "UTF-8",   "GBK"},
+        {"mixed_cjk_log.txt",         "UTF-8",   "UTF-16LE"},
+        {"mixed_cjk_log_gb18030.txt", "GB18030", "UTF-8"},
+    };
+    const Case& c = cases[state.range(0)];
+    std::string input;
+    if (!LoadCorpus(state, c.file, input)) {
+        return;
+    }
+    // 日志里的日文假名与韩文不在 GBK 中，按替换策略转换以覆盖整个文件
+    auto conv = UniConv::Create();
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingFast(std::string_view(input), c.from, c.to, output, ErrorPolicy::Replace));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+    state.SetLabel(std::string(c.from) + " -> " + c.to);
+}
+BENCHMARK(BM_Corpus_MixedCjkLog)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+static void BM_Corpus_DirtyData(benchmark::State& state) {
+    std::string input;
+    if (!LoadCorpus(state, "dirty_data.txt", input)) {
+        return;
+    }
+    auto conv = UniConv::Create();
+    std::string output;
+    ConversionReport report;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            conv->ConvertEncodingFast(std::string_view(input), "UTF-8", "UTF-16LE", output, ErrorPolicy::Replace, &report));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.counters["replaced"] = static_cast<double>(report.replaced);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+}
+BENCHMARK(BM_Corpus_DirtyData)->Unit(benchmark::kMillisecond);
+
+static void BM_Corpus_HugeSingleFile_Parallel(benchmark::State& state) {
+    std::string input;
+    if (!LoadCorpus(state, "huge_single_utf16le.txt", input)) {
+        return;
+    }
+    auto conv = UniConv::Create();
+    // 跳过生成脚本写入的 FF FE
+    std::string_view body(input);
+    if (body.size() >= 2 && body.compare(0, 2, "\xFF\xFE") == 0) {
+        body.remove_prefix(2);
+    }
+    std::string output;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertEncodingParallel(body, "UTF-16LE", "UTF-8", output,
+                                                              static_cast<size_t>(state.range(0))));
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(body.size()));
+    state.SetLabel(state.range(0) == 0 ? "auto threads" : std::to_string(state.range(0)) + " threads");
+}
+BENCHMARK(BM_Corpus_HugeSingleFile_Parallel)->Arg(1)->Arg(0)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_Corpus_HugeSingleFile_ConvertFile(benchmark::State& state) {
+    const std::string source = CorpusPath("huge_single_utf16le.txt");
+    if (!std::ifstream(source, std::ios::binary)) {
+        state.SkipWithError((source + " not found; run python script/generate_test_files.py --bench-corpus").c_str());
+        return;
+    }
+    const std::string target = source + ".bench_out";
+    auto conv = UniConv::Create();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conv->ConvertFile(source, "UTF-16LE", "UTF-8", target));
+    }
+    std::ifstream file(source, std::ios::binary | std::ios::ate);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(file.tellg()));
+    std::remove(target.c_str());
+}
+BENCHMARK(BM_Corpus_HugeSingleFile_ConvertFile)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// 构建配置写入输出 context（--benchmark_out 的 JSON 中可见），便于 script/compare_bench.py 对照两次结果
+// ============================================================================
+namespace {
+
+const bool g_benchContextRegistered = [] {
+#ifdef UNICONV_BENCH_VERSION
+    benchmark::AddCustomContext("uniconv_version", UNICONV_BENCH_VERSION);
+#endif
+#ifdef UNICONV_HAS_SIMDUTF
+    benchmark::AddCustomContext("uniconv_simdutf", "on");
+#else
+    benchmark::AddCustomContext("uniconv_simdutf", "off");
+#endif
+    benchmark::AddCustomContext("uniconv_metrics", UniConv::GetConversionMetrics().enabled ? "on" : "off");
+    return true;
+}();
+
+} // namespace
@@ -69,6 +69,8 @@
 #include <future>
 #include <thread>
 #include <queue>
+#include <deque>
+#include <exception>
 #include <condition_variable>
 #include <chrono>
 
@@ -314,6 +316,44 @@ namespace detail {
 // Make sure the C++ standard version is at least C++11
 static_assert(CPP_STANDARD >= 201103L, "Error: This code requires C++11 or later");
 
+// C++20 coroutine support (UniConv::AwaitConvertEncoding)
+#ifndef UNICONV_HAS_COROUTINES
+    #if CPP_STANDARD >= 202002L && defined(__cpp_impl_coroutine) && defined(__has_include)
+        #if __has_include(<coroutine>)
+            #define UNICONV_HAS_COROUTINES 1
+        #endif
+    #endif
+#endif
+#ifndef UNICONV_HAS_COROUTINES
+    #define UNICONV_HAS_COROUTINES 0
+#endif
+#if UNICONV_HAS_COROUTINES
+#include <coroutine>
+#endif
+
+// std::pmr outputs (UniConv::ConvertEncodingFast(..., std::pmr::string&) etc.)
+#ifndef UNICONV_HAS_PMR
+    #if defined(__has_include)
+        #if __has_include(<memory_resource>)
+            #include <memory_resource>
+            #if defined(__cpp_lib_memory_resource)
+                #define UNICONV_HAS_PMR 1
+            #endif
+        #endif
+    #endif
+#endif
+#ifndef UNICONV_HAS_PMR
+    #define UNICONV_HAS_PMR 0
+#endif
+#if UNICONV_HAS_PMR
+#include <memory_resource>
+#endif
+
+// Per-encoding-pair conversion metrics (UniConv::GetConversionMetrics()); compiled out by default
+#ifndef UNICONV_ENABLE_METRICS
+    #define UNICONV_ENABLE_METRICS 0
+#endif
+
 /**
  * @brief Get the current C++ standard version as a string.
  * @return A string_view representing the current C++ standard version.
@@ -530,35 +570,56 @@ public:
 //----------------------------------------------------------------------------------------------------------------------
 
 /**
- * @brief Thread pool for parallel batch processing
+ * @brief Work-stealing thread pool for parallel batch processing
  * @details Provides efficient task scheduling with:
  *          - Pre-created worker threads (no creation overhead per batch)
- *          - Mutex + condition_variable task queue
+ *          - Per-worker task deques: owners pop LIFO, idle workers steal FIFO from others
+ *          - Allocation-free ParallelFor: the job and its per-participant chunk ranges live on
+ *            the caller's stack, the calling thread takes part, and idle threads steal the
+ *            upper half of a busy participant's remaining range
  *          - Automatic thread count based on hardware
- *          - Support for waiting on specific task batches
  */
 class ThreadPool {
 public:
+    /// Maximum number of independently stealable ranges per ParallelFor call
+    static constexpr size_t MAX_RANGE_SLOTS = 64;
+    /// Target number of chunks per participant (leaves room for stealing)
+    static constexpr size_t CHUNKS_PER_PARTICIPANT = 4;
+
+    /**
+     * @brief Observer of the threads taking part in one ParallelFor call
+     * @details enter(context) runs on a participant right before its first chunk and leave(context)
+     *          on the same thread after its last one; a thread that joins but finds no chunk left
+     *          calls neither. Both must not throw.
+     */
+    struct ParticipantObserver {
+        const void* context = nullptr;
+        void (*enter)(const void* context) = nullptr;
+        void (*leave)(const void* context) = nullptr;
+    };
+
     /**
      * @brief Construct thread pool with specified number of workers
      * @param num_threads Number of worker threads (0 = hardware_concurrency)
      */
-    explicit ThreadPool(size_t num_threads = 0) : stop_(false) {
+    explicit ThreadPool(size_t num_threads = 0) {
         if (num_threads == 0) {
             num_threads = std::thread::hardware_concurrency();
             if (num_threads == 0) num_threads = 4;  // Fallback
         }
         
+        queues_ = std::make_unique<WorkerQueue[]>(num_threads);
+        num_queues_ = num_threads;
         workers_.reserve(num_threads);
         for (size_t i = 0; i < num_threads; ++i) {
-            workers_.emplace_back([this] { WorkerLoop(); });
+            workers_.emplace_back([this, i] { WorkerLoop(i); });
         }
     }
     
     ~ThreadPool() {
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            stop_ = true;
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_.store(true, std::memory_order_release);
         }
         condition_.notify_all();
         for (auto& worker : workers_) {
@@ -579,6 +640,7 @@ public:
      * @tparam F Callable type
      * @param task Task to execute
      * @return std::future for the task result
+     * @note Tasks submitted from a worker go to that worker's own deque; others are distributed round-robin.
      */
     template<typename F>
     auto Submit(F&& task) -> std::future<decltype(task())> {
@@ -588,15 +650,20 @@ public:
             std::forward<F>(task));
         
         std::future<ReturnType> future = packaged_task->get_future();
-        
+
+        const WorkerIdentity& self = CurrentWorker();
+        const size_t target = (self.pool == this)
+            ? self.index
+            : next_queue_.fetch_add(1, std::memory_order_relaxed) % num_queues_;
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            if (stop_) {
+            std::lock_guard<std::mutex> lock(queues_[target].mutex);
+            if (stop_.load(std::memory_order_acquire)) {
                 throw std::runtime_error("ThreadPool is stopped");
             }
-            tasks_.emplace([packaged_task]() { (*packaged_task)(); });
+            queues_[target].tasks.emplace_back([packaged_task]() { (*packaged_task)(); });
         }
-        condition_.notify_one();
+        pending_tasks_.fetch_add(1, std::memory_order_release);
+        WakeWorkers(false);
         
         return future;
     }
@@ -607,27 +674,68 @@ public:
      * @param total_items Total number of items to process
      * @param task_func Function to call with (start_idx, end_idx) range
      * @param min_chunk_size Minimum items per chunk (default: 1)
+     * @param observer Optional per-participant enter/leave callbacks (must outlive the call)
+     * @details Performs no heap allocation. The range is cut into about CHUNKS_PER_PARTICIPANT
+     * chunks per participant (never smaller than min_chunk_size); the calling thread runs chunks
+     * too, so nested calls from a worker cannot deadlock. The first exception thrown by
+     * task_func is rethrown after all chunks have finished.
      */
     template<typename F>
-    void ParallelFor(size_t total_items, F&& task_func, size_t min_chunk_size = 1) {
+    void ParallelFor(size_t total_items, F&& task_func, size_t min_chunk_size = 1,
+                     const ParticipantObserver* observer = nullptr) {
         if (total_items == 0) return;
-        
-        size_t num_threads = workers_.size();
-        size_t chunk_size = (std::max)(min_chunk_size, (total_items + num_threads - 1) / num_threads);
-        
-        std::vector<std::future<void>> futures;
-        futures.reserve((total_items + chunk_size - 1) / chunk_size);
-        
-        for (size_t start = 0; start < total_items; start += chunk_size) {
-            size_t end = (std::min)(start + chunk_size, total_items);
-            futures.emplace_back(Submit([&task_func, start, end]() {
-                task_func(start, end);
-            }));
+        if (min_chunk_size == 0) min_chunk_size = 1;
+
+        const size_t participants = workers_.size() + 1;
+        size_t chunk_size = (std::max)(min_chunk_size, total_items / (participants * CHUNKS_PER_PARTICIPANT));
+        size_t num_chunks = (total_items + chunk_size - 1) / chunk_size;
+        if (num_chunks > RANGE_MASK) {
+            chunk_size = (total_items + RANGE_MASK - 1) / RANGE_MASK;
+            num_chunks = (total_items + chunk_size - 1) / chunk_size;
         }
-        
-        // Wait for all tasks to complete
-        for (auto& future : futures) {
-            future.wait();
+        if (num_chunks == 1) {
+            if (observer) observer->enter(observer->context);
+            try {
+                task_func(size_t(0), total_items);
+            } catch (...) {
+                if (observer) observer->leave(observer->context);
+                throw;
+            }
+            if (observer) observer->leave(observer->context);
+            return;
+        }
+
+        using Func = std::remove_reference_t<F>;
+        ParallelForJob job;
+        job.invoke = [](const void* func, size_t start, size_t end) {
+            (*static_cast<Func*>(const_cast<void*>(func)))(start, end);
+        };
+        job.func = std::addressof(task_func);
+        job.total_items = total_items;
+        job.chunk_size = chunk_size;
+        job.num_chunks = num_chunks;
+        job.num_slots = (std::min)({MAX_RANGE_SLOTS, participants, num_chunks});
+        job.observer = observer;
+        for (size_t s = 0; s < job.num_slots; ++s) {
+            const uint64_t begin = num_chunks * s / job.num_slots;
+            const uint64_t end = num_chunks * (s + 1) / job.num_slots;
+            job.slots[s].range.store(PackRange(begin, end), std::memory_order_relaxed);
+        }
+
+        PublishJob(job);
+        RunParticipant(job, 0);
+
+        // 等待其他参与者完成已领取的块
+        if (job.done.load(std::memory_order_acquire) < num_chunks) {
+            std::unique_lock<std::mutex> lock(job.mutex);
+            job.finished.wait(lock, [&job] {
+                return job.done.load(std::memory_order_acquire) >= job.num_chunks;
+            });
+        }
+        RetireJob(job);
+
+        if (job.error) {
+            std::rethrow_exception(job.error);
         }
     }
     
@@ -642,36 +750,255 @@ public:
      * @brief Get number of pending tasks
      */
     [[nodiscard]] size_t GetPendingTaskCount() const noexcept {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        return tasks_.size();
+        return pending_tasks_.load(std::memory_order_acquire);
     }
 
 private:
-    void WorkerLoop() {
+    static constexpr uint64_t RANGE_MASK = 0xFFFFFFFFull;
+
+    /// Task deque owned by one worker (owner pushes/pops at the back, thieves take from the front)
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    /// One stealable [begin, end) range of chunk indices, packed as (begin << 32) | end
+    struct alignas(64) RangeSlot {
+        std::atomic<uint64_t> range{0};
+    };
+
+    /// ParallelFor state; lives on the caller's stack for the duration of the call
+    struct ParallelForJob {
+        void (*invoke)(const void* func, size_t start, size_t end) = nullptr;
+        const void* func = nullptr;
+        size_t total_items = 0;
+        size_t chunk_size = 0;
+        size_t num_chunks = 0;
+        size_t num_slots = 0;
+        std::array<RangeSlot, MAX_RANGE_SLOTS> slots;
+        std::atomic<size_t> next_slot{1};       // slot 0 belongs to the caller
+        std::atomic<size_t> done{0};            // completed chunks
+        std::atomic<size_t> active{0};          // workers currently inside the job
+        std::atomic<bool> exhausted{false};     // no claimable chunk left
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+        const ParticipantObserver* observer = nullptr;
+        ParallelForJob* next = nullptr;         // intrusive list of open jobs
+    };
+
+    struct WorkerIdentity {
+        const ThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+
+    static WorkerIdentity& CurrentWorker() noexcept {
+        static thread_local WorkerIdentity identity;
+        return identity;
+    }
+
+    static constexpr uint64_t PackRange(uint64_t begin, uint64_t end) noexcept {
+        return (begin << 32) | end;
+    }
+
+    void WakeWorkers(bool all) {
+        // 经过 sleep_mutex_ 同步，避免等待方检查条件后、进入等待前的唤醒丢失
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        if (all) {
+            condition_.notify_all();
+        } else {
+            condition_.notify_one();
+        }
+    }
+
+    void PublishJob(ParallelForJob& job) {
+        {
+            std::lock_guard<std::mutex> lock(jobs_mutex_);
+            job.next = jobs_head_;
+            jobs_head_ = &job;
+        }
+        open_jobs_.fetch_add(1, std::memory_order_release);
+        WakeWorkers(true);
+    }
+
+    void RetireJob(ParallelForJob& job) {
+        {
+            std::lock_guard<std::mutex> lock(jobs_mutex_);
+            for (ParallelForJob** link = &jobs_head_; *link; link = &(*link)->next) {
+                if (*link == &job) {
+                    *link = job.next;
+                    break;
+                }
+            }
+        }
+        // 已加入的工作线程只会在找不到块后离开，此时只剩极短的收尾
+        while (job.active.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    /// Claim the next chunk: own slot first, then steal the upper half of another slot
+    static bool ClaimChunk(ParallelForJob& job, size_t slot, size_t& chunk,
+                           size_t& private_begin, size_t& private_end) noexcept {
+        std::atomic<uint64_t>& own = job.slots[slot].range;
+        uint64_t r = own.load(std::memory_order_acquire);
+        while ((r >> 32) < (r & RANGE_MASK)) {
+            if (own.compare_exchange_weak(r, PackRange((r >> 32) + 1, r & RANGE_MASK),
+                                          std::memory_order_acq_rel, std::memory_order_acquire)) {
+                chunk = static_cast<size_t>(r >> 32);
+                return true;
+            }
+        }
+
+        for (size_t k = 1; k < job.num_slots; ++k) {
+            std::atomic<uint64_t>& victim = job.slots[(slot + k) % job.num_slots].range;
+            uint64_t v = victim.load(std::memory_order_acquire);
+            while ((v >> 32) < (v & RANGE_MASK)) {
+                const uint64_t begin = v >> 32;
+                const uint64_t end = v & RANGE_MASK;
+                const uint64_t mid = begin + (end - begin) / 2;
+                if (!victim.compare_exchange_weak(v, PackRange(begin, mid),
+                                                  std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    continue;
+                }
+                chunk = static_cast<size_t>(mid);
+                if (mid + 1 < end) {
+                    // 其余部分发布到自己的槽位供他人再窃取；槽位被共享且非空时私下处理
+                    uint64_t mine = own.load(std::memory_order_acquire);
+                    if ((mine >> 32) >= (mine & RANGE_MASK) &&
+                        own.compare_exchange_strong(mine, PackRange(mid + 1, end),
+                                                    std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        return true;
+                    }
+                    private_begin = static_cast<size_t>(mid + 1);
+                    private_end = static_cast<size_t>(end);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void RunParticipant(ParallelForJob& job, size_t slot) noexcept {
+        size_t private_begin = 0, private_end = 0;
+        size_t chunk = 0;
+        bool entered = false;
         while (true) {
-            std::function<void()> task;
-            
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
-                
-                if (stop_ && tasks_.empty()) {
-                    return;
+            if (private_begin < private_end) {
+                chunk = private_begin++;
+            } else if (!ClaimChunk(job, slot, chunk, private_begin, private_end)) {
+                break;
+            }
+            if (job.observer && !entered) {
+                job.observer->enter(job.observer->context);
+                entered = true;
+            }
+
+            const size_t start = chunk * job.chunk_size;
+            const size_t end = (std::min)(start + job.chunk_size, job.total_items);
+            try {
+                job.invoke(job.func, start, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job.mutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+            }
+
+            if (job.done.fetch_add(1, std::memory_order_acq_rel) + 1 == job.num_chunks) {
+                { std::lock_guard<std::mutex> lock(job.mutex); }
+                job.finished.notify_all();
+            }
+        }
+        if (entered) {
+            job.observer->leave(job.observer->context);
+        }
+        if (!job.exhausted.exchange(true, std::memory_order_acq_rel)) {
+            open_jobs_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    /// Join an open ParallelFor job, if any
+    bool HelpParallelJobs() {
+        ParallelForJob* job = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(jobs_mutex_);
+            for (ParallelForJob* j = jobs_head_; j; j = j->next) {
+                if (!j->exhausted.load(std::memory_order_acquire)) {
+                    job = j;
+                    job->active.fetch_add(1, std::memory_order_acq_rel);
+                    break;
                 }
-                
-                task = std::move(tasks_.front());
-                tasks_.pop();
             }
-            
-            task();
+        }
+        if (!job) return false;
+
+        const size_t slot = job->next_slot.fetch_add(1, std::memory_order_relaxed) % job->num_slots;
+        RunParticipant(*job, slot);
+        job->active.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    /// Pop from the own deque (LIFO), otherwise steal from another worker (FIFO)
+    bool PopTask(size_t index, std::function<void()>& task) {
+        {
+            WorkerQueue& own = queues_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < num_queues_; ++k) {
+            WorkerQueue& victim = queues_[(index + k) % num_queues_];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t index) {
+        CurrentWorker() = WorkerIdentity{this, index};
+        while (true) {
+            if (open_jobs_.load(std::memory_order_acquire) > 0 && HelpParallelJobs()) {
+                continue;
+            }
+
+            std::function<void()> task;
+            if (PopTask(index, task)) {
+                pending_tasks_.fetch_sub(1, std::memory_order_acq_rel);
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            condition_.wait(lock, [this] {
+                return stop_.load(std::memory_order_acquire) ||
+                       pending_tasks_.load(std::memory_order_acquire) > 0 ||
+                       open_jobs_.load(std::memory_order_acquire) > 0;
+            });
+            if (stop_.load(std::memory_order_acquire) && pending_tasks_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
         }
     }
     
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
-    mutable std::mutex queue_mutex_;
+    std::unique_ptr<WorkerQueue[]> queues_;
+    size_t num_queues_ = 0;
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<size_t> pending_tasks_{0};
+    std::atomic<size_t> open_jobs_{0};
+    std::mutex jobs_mutex_;
+    ParallelForJob* jobs_head_ = nullptr;
+    std::mutex sleep_mutex_;
     std::condition_variable condition_;
-    bool stop_;
+    std::atomic<bool> stop_{false};
 };
 
 /**
@@ -703,6 +1030,44 @@ public:
     UniConvThreadPool() = delete;
 };
 
+/**
+ * @brief Per-byte cost class of a conversion path, used to key parallel thresholds
+ * @details Each (source, target) pair maps to one class through the path that will
+ *          actually convert it (see UniConv::ClassifyParallelCost()).
+ */
+enum class ParallelCostClass : uint8_t {
+    Copy = 0,        ///< Same encoding / ASCII passthrough (memcpy)
+    Simdutf,         ///< simdutf kernels
+    NativeUtf,       ///< Built-in UTF-8/16/32 kernels and single-/double-byte codepage tables
+    IconvUnicode,    ///< iconv between Unicode encodings (BOM-dependent UTF-16/32 etc.)
+    IconvSingleByte, ///< iconv to/from single-byte codepages (ISO-8859-1, Windows-1252, ...)
+    IconvMultiByte,  ///< iconv to/from multi-byte codepages (EUC-KR, unknown, CJK with BOM-dependent UTF-16/32 etc.)
+    Count
+};
+
+/**
+ * @brief Parallelization thresholds for one cost class
+ * @details Defaults match the historical AdaptiveParallelPolicy constants;
+ *          UniConv::CalibrateParallelPolicy() derives measured values per class.
+ */
+struct ParallelThresholds {
+    size_t serial_bytes = 10 * 1024;           ///< Batches below this: always serial
+    size_t light_parallel_bytes = 100 * 1024;  ///< Batches below this: use light_parallel_threads
+    size_t light_parallel_threads = 2;         ///< Thread count for medium batches
+    size_t min_bytes_per_chunk = 256 * 1024;   ///< Single-buffer split: minimum bytes per chunk
+};
+
+/**
+ * @brief Result of UniConv::CalibrateParallelPolicy()
+ */
+struct ParallelCalibration {
+    static constexpr size_t CLASS_COUNT = static_cast<size_t>(ParallelCostClass::Count);
+
+    double dispatch_ns = 0.0;                     ///< Measured cost of one ParallelFor dispatch (ns)
+    double ns_per_byte[CLASS_COUNT] = {};         ///< Measured per-input-byte cost per class (0 = not measured)
+    ParallelThresholds thresholds[CLASS_COUNT];   ///< Thresholds installed for each class
+};
+
 /**
  * @brief Adaptive parallel execution policy
  * @details Determines optimal parallelization strategy based on workload characteristics
@@ -711,6 +1076,7 @@ struct AdaptiveParallelPolicy {
     static constexpr size_t SERIAL_THRESHOLD_ITEMS = 10;        // Items below this: always serial
     static constexpr size_t SERIAL_THRESHOLD_BYTES = 10 * 1024; // Bytes below this: always serial
     static constexpr size_t LIGHT_PARALLEL_BYTES = 100 * 1024;  // Bytes below this: use 2 threads
+    static constexpr size_t MIN_BYTES_PER_CHUNK = 256 * 1024;  // Single-buffer split: minimum bytes per chunk
     
     /**
      * @brief Determine recommended thread count based on workload
@@ -720,19 +1086,29 @@ struct AdaptiveParallelPolicy {
      * @return Recommended thread count (0 = use serial processing)
      */
     static size_t GetRecommendedThreads(size_t num_items, size_t total_bytes, size_t max_threads) noexcept {
+        return GetRecommendedThreads(num_items, total_bytes, max_threads, ParallelThresholds{});
+    }
+
+    /**
+     * @brief Determine recommended thread count using per-class thresholds
+     * @param thresholds Thresholds of the conversion's cost class
+     * @return Recommended thread count (0 = use serial processing)
+     */
+    static size_t GetRecommendedThreads(size_t num_items, size_t total_bytes, size_t max_threads,
+                                        const ParallelThresholds& thresholds) noexcept {
         // Too few items: serial
         if (num_items < SERIAL_THRESHOLD_ITEMS) {
             return 0;
         }
         
         // Small data: serial
-        if (total_bytes < SERIAL_THRESHOLD_BYTES) {
+        if (total_bytes < thresholds.serial_bytes) {
             return 0;
         }
         
         // Medium data: light parallel
-        if (total_bytes < LIGHT_PARALLEL_BYTES) {
-            return (std::min)(size_t(2), max_threads);
+        if (total_bytes < thresholds.light_parallel_bytes) {
+            return (std::min)(thresholds.light_parallel_threads, max_threads);
         }
         
         // Large data: full parallel, but don't over-subscribe
@@ -747,6 +1123,11 @@ struct AdaptiveParallelPolicy {
     }
 };
 
+static_assert(ParallelThresholds{}.serial_bytes == AdaptiveParallelPolicy::SERIAL_THRESHOLD_BYTES &&
+              ParallelThresholds{}.light_parallel_bytes == AdaptiveParallelPolicy::LIGHT_PARALLEL_BYTES &&
+              ParallelThresholds{}.min_bytes_per_chunk == AdaptiveParallelPolicy::MIN_BYTES_PER_CHUNK,
+              "ParallelThresholds defaults must match AdaptiveParallelPolicy constants");
+
 //----------------------------------------------------------------------------------------------------------------------
 // === CPU Optimization Detection  ===
 //----------------------------------------------------------------------------------------------------------------------
@@ -901,6 +1282,18 @@ private:
     CpuOptimization() = delete;
 };
 
+namespace detail {
+    /**
+     * @brief Open a TraceSpanKind::BufferPoolFallback span if tracing hooks are installed
+     * @return Opaque token for EndBufferPoolFallbackSpan(), nullptr when tracing is off
+     * @see UniConv::SetTraceHooks
+     */
+    [[nodiscard]] const void* BeginBufferPoolFallbackSpan(size_t bytes) noexcept;
+
+    /// Close a span opened by BeginBufferPoolFallbackSpan() (no-op for a nullptr token)
+    void EndBufferPoolFallbackSpan(const void* token, size_t bytes, bool allocated) noexcept;
+}
+
 /**
  * @brief High-performance tiered string buffer pool
  * @details Provides three tiers of buffer sizes optimized for different use cases:
@@ -909,6 +1302,10 @@ private:
  *          - Large (1MB): Large file and batch processing
  * 
  * Lock-free design using atomic compare-exchange for buffer acquisition.
+ * 每个 tier 的槽位数量按 miss 率自适应伸缩（GROWTH_MISS_DIVISOR / SHRINK_WINDOW），
+ * 缓冲区内存在首次签出时才按需预留；每个线程记住自己最近归还的槽位，
+ * 下次签出优先命中该槽位（线程本地 tier 缓存，槽位本身仍归全局池所有）。
+ * 归还时容量超过 tier 尺寸 TRIM_FACTOR 倍的缓冲区会被释放，避免长期占用内存。
  */
 class StringBufferPool {
 private:
@@ -917,37 +1314,79 @@ private:
     static constexpr size_t MEDIUM_BUFFER_SIZE  = 65536;      // 64KB
     static constexpr size_t LARGE_BUFFER_SIZE   = 1048576;    // 1MB
     
-    // Pool sizes per tier (balanced for memory vs concurrency)
+    // Initial pool sizes per tier (balanced for memory vs concurrency)
     static constexpr size_t SMALL_POOL_SIZE  = 32;  // High frequency, more buffers
     static constexpr size_t MEDIUM_POOL_SIZE = 8;   // Medium frequency
     static constexpr size_t LARGE_POOL_SIZE  = 2;   // Low frequency, large memory footprint
-    
-    // Legacy constant for compatibility
-    static constexpr size_t POOL_SIZE = SMALL_POOL_SIZE;
-    
+
+    // Upper bound of slots per tier after growth
+    static constexpr size_t SMALL_POOL_MAX   = 256;
+    static constexpr size_t MEDIUM_POOL_MAX  = 64;
+    static constexpr size_t LARGE_POOL_MAX   = 32;
+
+    static constexpr size_t   TIER_COUNT          = 3;
+    static constexpr size_t   LOCAL_HINTS         = 2;     // 每线程每 tier 记住的槽位数
+    static constexpr size_t   TRIM_FACTOR         = 4;     // 容量 > tier 尺寸 * 4 时归还即释放
+    static constexpr uint64_t GROWTH_MISS_DIVISOR = 16;    // 窗口内 miss 率 >= 1/16 时扩容
+    static constexpr uint64_t SHRINK_WINDOW       = 1024;  // 每 1024 次签出评估一次缩容
+
     struct Buffer {
         std::string        data;
         std::atomic<bool>  in_use{false};
-        size_t             tier_size;  // Pre-allocated tier size
+        size_t             tier_size = SMALL_BUFFER_SIZE;  // Nominal tier size
+        uint32_t           tier = 0;                       // Owning tier index
+        uint32_t           index = 0;                      // Slot index within the tier
+
+        Buffer() noexcept = default;
 
-        explicit Buffer(size_t reserve_size = SMALL_BUFFER_SIZE) : tier_size(reserve_size) {
+        explicit Buffer(size_t reserve_size) : tier_size(reserve_size) {
             data.reserve(reserve_size);
         }
     };
-    
-    // Tiered buffer arrays
-    std::array<Buffer, SMALL_POOL_SIZE>  small_buffers_;
-    std::array<Buffer, MEDIUM_POOL_SIZE> medium_buffers_;
-    std::array<Buffer, LARGE_POOL_SIZE>  large_buffers_;
-    
-    // Per-tier round-robin indices
-    std::atomic<size_t> small_next_index_{0};
-    std::atomic<size_t> medium_next_index_{0};
-    std::atomic<size_t> large_next_index_{0};
-    
-    // Legacy member for compatibility
-    std::array<Buffer, SMALL_POOL_SIZE>& buffers_ = small_buffers_;
-    std::atomic<size_t>& next_index_ = small_next_index_;
+
+    struct TierState {
+        size_t                    buffer_size = 0;
+        size_t                    base_slots = 0;
+        size_t                    max_slots = 0;
+        std::unique_ptr<Buffer[]> buffers;                 // max_slots 个槽位，仅前 capacity 个参与签出
+
+        std::atomic<size_t>       capacity{0};
+        std::atomic<size_t>       next_index{0};
+        std::atomic<size_t>       active{0};
+        std::atomic<size_t>       peak_active{0};          // 当前评估窗口内的峰值
+
+        std::atomic<uint64_t>     acquisitions{0};
+        std::atomic<uint64_t>     misses{0};
+        std::atomic<uint64_t>     window_acquisitions{0};
+        std::atomic<uint64_t>     window_misses{0};
+        std::atomic<uint64_t>     grows{0};
+        std::atomic<uint64_t>     shrinks{0};
+        std::atomic<uint64_t>     trims{0};
+    };
+
+    /**
+     * @brief Per-thread slot affinity for the most recently used pool
+     * @details 只保存池 id 与槽位下标，不持有缓冲区：线程退出或池析构后无需归还，
+     *          过期的下标在签出时经 CAS 校验，最多退化为一次普通扫描。
+     */
+    struct LocalTierCache {
+        uint64_t pool_id = 0;
+        uint32_t hints[TIER_COUNT][LOCAL_HINTS] = {};
+        uint32_t hint_count[TIER_COUNT] = {};
+    };
+
+    static LocalTierCache& LocalCache() noexcept {
+        static thread_local LocalTierCache cache;
+        return cache;
+    }
+
+    static uint64_t NextPoolId() noexcept {
+        static std::atomic<uint64_t> next_id{1};
+        return next_id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::array<TierState, TIER_COUNT> tiers_;
+    const uint64_t                     pool_id_ = NextPoolId();
 
 public:
     /**
@@ -956,23 +1395,17 @@ public:
     enum class Tier { Small, Medium, Large };
     
     /**
-     * @brief Initialize tiered buffer pool with pre-allocated buffers
+     * @brief Initialize tiered buffer pool
+     * @details 只分配槽位头部；各缓冲区的字符串内存在首次签出时按 hint 预留。
      */
     StringBufferPool() {
-        // Initialize medium and large buffers with appropriate sizes
-        for (auto& buf : medium_buffers_) {
-            buf.tier_size = MEDIUM_BUFFER_SIZE;
-            buf.data.reserve(MEDIUM_BUFFER_SIZE);
-        }
-        for (auto& buf : large_buffers_) {
-            buf.tier_size = LARGE_BUFFER_SIZE;
-            buf.data.reserve(LARGE_BUFFER_SIZE);
-        }
-        // Small buffers are initialized with default constructor (4KB)
-        for (auto& buf : small_buffers_) {
-            buf.tier_size = SMALL_BUFFER_SIZE;
-        }
+        InitTier(tiers_[0], 0, SMALL_BUFFER_SIZE,  SMALL_POOL_SIZE,  SMALL_POOL_MAX);
+        InitTier(tiers_[1], 1, MEDIUM_BUFFER_SIZE, MEDIUM_POOL_SIZE, MEDIUM_POOL_MAX);
+        InitTier(tiers_[2], 2, LARGE_BUFFER_SIZE,  LARGE_POOL_SIZE,  LARGE_POOL_MAX);
     }
+
+    StringBufferPool(const StringBufferPool&) = delete;
+    StringBufferPool& operator=(const StringBufferPool&) = delete;
     
     // RAII缓冲区lease类
     class BufferLease {
@@ -981,16 +1414,11 @@ public:
         bool              is_from_pool_;   // 标记是否来自池（用于统计）
         bool              is_emergency_;   // 标记是否是 emergency_buffer（不能 delete）
 
-    public:
-        BufferLease(Buffer* buf, StringBufferPool* pool, bool from_pool = true, bool is_emergency = false) noexcept
-            : buffer_(buf), pool_(pool), is_from_pool_(from_pool), is_emergency_(is_emergency) {}
-
-        ~BufferLease() noexcept {
+        void reset() noexcept {
             if (buffer_) {
                 if (is_from_pool_) {
-                    // 从池中获取的缓冲区，清理并标记为可用
-                    buffer_->data.clear();
-                    buffer_->in_use.store(false, std::memory_order_release);
+                    // 从池中获取的缓冲区，交还池（可能裁剪过大的容量）
+                    pool_->Release(buffer_);
                 } else if (is_emergency_) {
                     // emergency_buffer 是 static thread_local，只清理不 delete
                     buffer_->data.clear();
@@ -999,9 +1427,18 @@ public:
                     // 临时分配的缓冲区，必须释放内存
                     delete buffer_;
                 }
+                buffer_ = nullptr;
             }
         }
 
+    public:
+        BufferLease(Buffer* buf, StringBufferPool* pool, bool from_pool = true, bool is_emergency = false) noexcept
+            : buffer_(buf), pool_(pool), is_from_pool_(from_pool), is_emergency_(is_emergency) {}
+
+        ~BufferLease() noexcept {
+            reset();
+        }
+
         // 移动构造和赋值
         BufferLease(BufferLease&& other) noexcept
             : buffer_(other.buffer_), pool_(other.pool_), is_from_pool_(other.is_from_pool_), is_emergency_(other.is_emergency_) {
@@ -1010,17 +1447,7 @@ public:
 
         BufferLease& operator=(BufferLease&& other) noexcept {
             if (this != &other) {
-                if (buffer_) {
-                    if (is_from_pool_) {
-                        buffer_->data.clear();
-                        buffer_->in_use.store(false, std::memory_order_release);
-                    } else if (is_emergency_) {
-                        buffer_->data.clear();
-                        buffer_->in_use.store(false, std::memory_order_release);
-                    } else {
-                        delete buffer_;  // 释放临时分配的内存
-                    }
-                }
+                reset();
                 buffer_ = other.buffer_;
                 pool_ = other.pool_;
                 is_from_pool_ = other.is_from_pool_;
@@ -1077,31 +1504,169 @@ public:
     };
 
 private:
+    static void InitTier(TierState& tier, uint32_t tier_index, size_t buffer_size, size_t base_slots, size_t max_slots) {
+        tier.buffer_size = buffer_size;
+        tier.base_slots = base_slots;
+        tier.max_slots = max_slots;
+        tier.buffers.reset(new Buffer[max_slots]);
+        for (size_t i = 0; i < max_slots; ++i) {
+            tier.buffers[i].tier_size = buffer_size;
+            tier.buffers[i].tier = tier_index;
+            tier.buffers[i].index = static_cast<uint32_t>(i);
+        }
+        tier.capacity.store(base_slots, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static bool TryClaim(Buffer& buffer) noexcept {
+        bool expected = false;
+        return !buffer.in_use.load(std::memory_order_relaxed) &&
+               buffer.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire);
+    }
+
+    static void NotePeak(TierState& tier, size_t active) noexcept {
+        size_t peak = tier.peak_active.load(std::memory_order_relaxed);
+        while (active > peak &&
+               !tier.peak_active.compare_exchange_weak(peak, active, std::memory_order_relaxed)) {
+        }
+    }
+
     /**
      * @brief Try to acquire a buffer from a specific tier
-     * @tparam N Pool size
-     * @param buffers Buffer array
-     * @param next_index Atomic index counter
-     * @return BufferLease if successful, nullptr otherwise
+     * @details 先尝试本线程最近归还的槽位，再按轮转下标扫描当前容量内的槽位。
+     * @return Claimed buffer, or nullptr when every active slot is taken
      */
-    template<size_t N>
-    [[nodiscard]] Buffer* TryAcquireFromTier(
-        std::array<Buffer, N>& buffers,
-        std::atomic<size_t>& next_index) noexcept 
-    {
-        constexpr int max_attempts = static_cast<int>(N * 2);
-        
-        for (int attempt = 0; attempt < max_attempts; ++attempt) {
-            size_t index = next_index.fetch_add(1, std::memory_order_relaxed) % N;
-            
-            bool expected = false;
-            if (buffers[index].in_use.compare_exchange_weak(
-                    expected, true, std::memory_order_acquire)) {
-                buffers[index].data.clear();
-                return &buffers[index];
+    [[nodiscard]] Buffer* TryAcquireFromTier(size_t tier_index) noexcept {
+        TierState& tier = tiers_[tier_index];
+        const size_t capacity = tier.capacity.load(std::memory_order_acquire);
+        Buffer* claimed = nullptr;
+
+        LocalTierCache& local = LocalCache();
+        if (local.pool_id == pool_id_) {
+            for (uint32_t i = local.hint_count[tier_index]; i > 0 && !claimed; --i) {
+                const uint32_t slot = local.hints[tier_index][i - 1];
+                if (slot < capacity && TryClaim(tier.buffers[slot])) {
+                    claimed = &tier.buffers[slot];
+                }
+            }
+        }
+
+        const size_t max_attempts = capacity * 2;
+        for (size_t attempt = 0; attempt < max_attempts && !claimed; ++attempt) {
+            const size_t index = tier.next_index.fetch_add(1, std::memory_order_relaxed) % capacity;
+            if (TryClaim(tier.buffers[index])) {
+                claimed = &tier.buffers[index];
+            }
+        }
+
+        if (claimed) {
+            claimed->data.clear();
+            NotePeak(tier, tier.active.fetch_add(1, std::memory_order_relaxed) + 1);
+        }
+        return claimed;
+    }
+
+    /**
+     * @brief Double the active slot count of a tier (bounded by max_slots)
+     */
+    static bool GrowTier(TierState& tier) noexcept {
+        size_t capacity = tier.capacity.load(std::memory_order_relaxed);
+        while (capacity < tier.max_slots) {
+            const size_t grown = (std::min)(capacity * 2, tier.max_slots);
+            if (tier.capacity.compare_exchange_weak(capacity, grown, std::memory_order_release, std::memory_order_relaxed)) {
+                tier.grows.fetch_add(1, std::memory_order_relaxed);
+                tier.window_acquisitions.store(0, std::memory_order_relaxed);
+                tier.window_misses.store(0, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Halve an oversized tier once its window shows no misses and low peak use
+     * @details 退出容量范围的空闲槽位立即释放内存；仍被占用的槽位在归还时释放。
+     */
+    void MaybeShrinkTier(TierState& tier) noexcept {
+        const size_t capacity = tier.capacity.load(std::memory_order_relaxed);
+        const bool idle = tier.window_misses.load(std::memory_order_relaxed) == 0 &&
+                          tier.peak_active.load(std::memory_order_relaxed) * 4 <= capacity;
+        tier.window_misses.store(0, std::memory_order_relaxed);
+        tier.peak_active.store(tier.active.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        if (!idle || capacity <= tier.base_slots) {
+            return;
+        }
+
+        size_t expected = capacity;
+        const size_t shrunk = (std::max)(capacity / 2, tier.base_slots);
+        if (!tier.capacity.compare_exchange_strong(expected, shrunk, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+        tier.shrinks.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = shrunk; i < capacity; ++i) {
+            Buffer& buffer = tier.buffers[i];
+            if (TryClaim(buffer)) {
+                std::string().swap(buffer.data);
+                buffer.in_use.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+    /**
+     * @brief Acquire from a tier, growing it when the recent miss rate is too high
+     */
+    [[nodiscard]] Buffer* AcquireFromTier(size_t tier_index) noexcept {
+        TierState& tier = tiers_[tier_index];
+        tier.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t window = tier.window_acquisitions.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (window == SHRINK_WINDOW) {
+            tier.window_acquisitions.store(0, std::memory_order_relaxed);
+            MaybeShrinkTier(tier);
+        }
+
+        Buffer* buf = TryAcquireFromTier(tier_index);
+        if (buf) {
+            return buf;
+        }
+
+        tier.misses.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t window_misses = tier.window_misses.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (window_misses * GROWTH_MISS_DIVISOR >= tier.window_acquisitions.load(std::memory_order_relaxed) &&
+            GrowTier(tier)) {
+            buf = TryAcquireFromTier(tier_index);
+        }
+        return buf;
+    }
+
+    /**
+     * @brief Return a pooled buffer, trimming storage that grew far beyond its tier
+     */
+    void Release(Buffer* buffer) noexcept {
+        TierState& tier = tiers_[buffer->tier];
+        const bool retired = buffer->index >= tier.capacity.load(std::memory_order_relaxed);
+        if (retired || buffer->data.capacity() > buffer->tier_size * TRIM_FACTOR) {
+            std::string().swap(buffer->data);
+            if (!retired) {
+                tier.trims.fetch_add(1, std::memory_order_relaxed);
             }
+        } else {
+            buffer->data.clear();
         }
-        return nullptr;
+
+        LocalTierCache& local = LocalCache();
+        if (local.pool_id != pool_id_) {
+            local = LocalTierCache{};
+            local.pool_id = pool_id_;
+        }
+        uint32_t (&hints)[LOCAL_HINTS] = local.hints[buffer->tier];
+        uint32_t& count = local.hint_count[buffer->tier];
+        if (count == LOCAL_HINTS) {
+            std::copy(hints + 1, hints + LOCAL_HINTS, hints);
+            --count;
+        }
+        hints[count++] = buffer->index;
+
+        tier.active.fetch_sub(1, std::memory_order_relaxed);
+        buffer->in_use.store(false, std::memory_order_release);
     }
 
 public:
@@ -1111,36 +1676,35 @@ public:
      * @return BufferLease for the acquired buffer
      * 
      * Tier selection:
-     * - hint_size <= 4KB  → Small tier (32 buffers)
-     * - hint_size <= 64KB → Medium tier (8 buffers)
-     * - hint_size > 64KB  → Large tier (2 buffers)
+     * - hint_size <= 4KB  → Small tier (32 → 256 buffers)
+     * - hint_size <= 64KB → Medium tier (8 → 64 buffers)
+     * - hint_size > 64KB  → Large tier (2 → 32 buffers)
      */
     [[nodiscard]] UNICONV_HOT BufferLease acquire(size_t hint_size) noexcept {
         Buffer* buf = nullptr;
         
-        // Select tier based on size hint
+        // Select tier based on size hint; fall back one tier up if exhausted
         if (hint_size <= SMALL_BUFFER_SIZE) {
-            buf = TryAcquireFromTier(small_buffers_, small_next_index_);
-            // Fallback to medium if small is exhausted
-            if (!buf) buf = TryAcquireFromTier(medium_buffers_, medium_next_index_);
+            buf = AcquireFromTier(0);
+            if (!buf) buf = TryAcquireFromTier(1);
         } 
         else if (hint_size <= MEDIUM_BUFFER_SIZE) {
-            buf = TryAcquireFromTier(medium_buffers_, medium_next_index_);
-            // Fallback to large if medium is exhausted
-            if (!buf) buf = TryAcquireFromTier(large_buffers_, large_next_index_);
+            buf = AcquireFromTier(1);
+            if (!buf) buf = TryAcquireFromTier(2);
         } 
         else {
-            buf = TryAcquireFromTier(large_buffers_, large_next_index_);
+            buf = AcquireFromTier(2);
         }
         
         if (buf) {
-            // Ensure buffer has adequate capacity
-            if (buf->data.capacity() < hint_size) {
+            // Ensure buffer has adequate capacity (storage is reserved lazily)
+            const size_t wanted = (std::max)(hint_size, buf->tier_size);
+            if (buf->data.capacity() < wanted) {
                 try {
-                    buf->data.reserve(hint_size);
+                    buf->data.reserve(wanted);
                 } catch (...) {
                     // Release buffer and fall through to temp allocation
-                    buf->in_use.store(false, std::memory_order_release);
+                    Release(buf);
                     buf = nullptr;
                 }
             }
@@ -1148,19 +1712,23 @@ public:
         }
         
         // Fallback: allocate temporary buffer (rare case)
-        Buffer* temp = new (std::nothrow) Buffer(hint_size);
+        const void* span = detail::BeginBufferPoolFallbackSpan(hint_size);
+        Buffer* temp = new (std::nothrow) Buffer();
         if (temp) {
+            try { temp->data.reserve(hint_size); } catch (...) {}
             temp->in_use.store(true);
+            detail::EndBufferPoolFallbackSpan(span, hint_size, true);
             return BufferLease(temp, nullptr, false, false);
         }
         
         // Last resort: thread-local static buffer (cannot be deleted!)
-        static thread_local Buffer emergency_buffer(SMALL_BUFFER_SIZE);
+        static thread_local Buffer emergency_buffer;
         emergency_buffer.data.clear();
         if (hint_size > emergency_buffer.data.capacity()) {
             try { emergency_buffer.data.reserve(hint_size); } catch (...) {}
         }
         emergency_buffer.in_use.store(true);
+        detail::EndBufferPoolFallbackSpan(span, hint_size, false);
         return BufferLease(&emergency_buffer, nullptr, false, true);  // is_emergency = true
     }
 
@@ -1179,18 +1747,31 @@ public:
      */
     [[nodiscard]] size_t GetActiveBuffers() const noexcept {
         size_t count = 0;
-        for (const auto& buffer : small_buffers_) {
-            if (buffer.in_use.load(std::memory_order_relaxed)) ++count;
-        }
-        for (const auto& buffer : medium_buffers_) {
-            if (buffer.in_use.load(std::memory_order_relaxed)) ++count;
-        }
-        for (const auto& buffer : large_buffers_) {
-            if (buffer.in_use.load(std::memory_order_relaxed)) ++count;
+        for (const auto& tier : tiers_) {
+            count += tier.active.load(std::memory_order_relaxed);
         }
         return count;
     }
     
+    /**
+     * @brief Per-tier sizing and hit/miss counters
+     */
+    struct TierDetail {
+        size_t   buffer_size;   // Nominal buffer size of the tier
+        size_t   capacity;      // Slots currently participating in acquisition
+        size_t   max_capacity;  // Growth upper bound
+        size_t   active;        // Buffers currently leased
+        uint64_t acquisitions;  // Acquisitions targeting this tier
+        uint64_t misses;        // Acquisitions that found the tier exhausted
+        uint64_t grows;         // Capacity doublings
+        uint64_t shrinks;       // Capacity halvings
+        uint64_t trims;         // Oversized buffers released on return
+
+        [[nodiscard]] double miss_rate() const noexcept {
+            return acquisitions ? static_cast<double>(misses) / static_cast<double>(acquisitions) : 0.0;
+        }
+    };
+
     /**
      * @brief Get tier-specific statistics
      */
@@ -1198,23 +1779,29 @@ public:
         size_t small_active;
         size_t medium_active;
         size_t large_active;
-        size_t total_capacity;  // Total pre-allocated memory
+        size_t total_capacity;  // Nominal memory of all active slots
+        std::array<TierDetail, TIER_COUNT> tiers;  // Indexed by Tier
     };
     
     [[nodiscard]] TierStats GetTierStatistics() const noexcept {
         TierStats stats{};
-        for (const auto& buf : small_buffers_) {
-            if (buf.in_use.load(std::memory_order_relaxed)) ++stats.small_active;
-        }
-        for (const auto& buf : medium_buffers_) {
-            if (buf.in_use.load(std::memory_order_relaxed)) ++stats.medium_active;
+        for (size_t i = 0; i < TIER_COUNT; ++i) {
+            const TierState& tier = tiers_[i];
+            TierDetail& detail = stats.tiers[i];
+            detail.buffer_size  = tier.buffer_size;
+            detail.capacity     = tier.capacity.load(std::memory_order_relaxed);
+            detail.max_capacity = tier.max_slots;
+            detail.active       = tier.active.load(std::memory_order_relaxed);
+            detail.acquisitions = tier.acquisitions.load(std::memory_order_relaxed);
+            detail.misses       = tier.misses.load(std::memory_order_relaxed);
+            detail.grows        = tier.grows.load(std::memory_order_relaxed);
+            detail.shrinks      = tier.shrinks.load(std::memory_order_relaxed);
+            detail.trims        = tier.trims.load(std::memory_order_relaxed);
+            stats.total_capacity += detail.capacity * detail.buffer_size;
         }
-        for (const auto& buf : large_buffers_) {
-            if (buf.in_use.load(std::memory_order_relaxed)) ++stats.large_active;
-        }
-        stats.total_capacity = SMALL_POOL_SIZE * SMALL_BUFFER_SIZE 
-                             + MEDIUM_POOL_SIZE * MEDIUM_BUFFER_SIZE 
-                             + LARGE_POOL_SIZE * LARGE_BUFFER_SIZE;
+        stats.small_active  = stats.tiers[0].active;
+        stats.medium_active = stats.tiers[1].active;
+        stats.large_active  = stats.tiers[2].active;
         return stats;
     }
 };
@@ -1409,27 +1996,200 @@ using StringViewResult  = CompactResult<std::string_view>;
 using IntResult         = CompactResult<int>;
 using BoolResult        = CompactResult<bool>;
 
+//----------------------------------------------------------------------------------------------------------------------
+// === Error Policy ===
 //----------------------------------------------------------------------------------------------------------------------
 
-template <typename T>
-class Singleton {
-protected:
-
-	Singleton() = default;
-	Singleton(const Singleton<T>&) = delete;
-	Singleton& operator=(const Singleton<T>& st) = delete;
+/**
+ * @brief What a conversion does when it meets an invalid, incomplete or unmappable sequence
+ */
+enum class ErrorPolicy : uint8_t {
+    Strict,   ///< Fail the whole conversion (default behaviour of every other overload)
+    Replace,  ///< Emit U+FFFD in the target encoding ('?' when the target cannot represent it) and continue
+    Skip      ///< Drop the bad sequence and continue
+};
 
-	static std::shared_ptr<T> _instance;
-public:
-	static std::shared_ptr<T> GetInstance() {
-		static std::once_flag s_flag;
-		std::call_once(s_flag, [&]() {
-			_instance = std::shared_ptr<T>(new T);
-			});
+/**
+ * @brief Bad-sequence statistics reported by the ErrorPolicy overloads
+ */
+struct ConversionReport {
+    size_t replaced = 0;                                  ///< Bad sequences replaced (Replace) or dropped (Skip)
+    size_t first_error_offset = static_cast<size_t>(-1);  ///< Input offset of the first bad sequence (SIZE_MAX = none)
+    ErrorCode first_error = ErrorCode::Success;           ///< Error of the first bad sequence
 
-		return _instance;
-	}
-	~Singleton() = default;
+    /// True when the input converted without any bad sequence
+    [[nodiscard]] bool Clean() const noexcept { return replaced == 0 && first_error == ErrorCode::Success; }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+// === Unicode Normalization ===
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Unicode normalization form applied to UTF-8 output (UAX #15, Unicode 14.0 data)
+ */
+enum class NormalizationForm : uint8_t {
+    None,  ///< Leave the output as converted
+    NFC,   ///< Canonical decomposition followed by canonical composition
+    NFKC   ///< Compatibility decomposition followed by canonical composition
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+// === Conversion Metrics ===
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Path a single conversion call actually took
+ */
+enum class ConversionPath : uint8_t {
+    Copy,            ///< Same encoding: byte copy
+    AsciiShortcut,   ///< ASCII-compatible pair with pure ASCII input: byte copy
+    Simdutf,         ///< simdutf kernels
+    Native,          ///< Built-in UTF kernels and codepage tables
+    Iconv,           ///< Cached iconv descriptor
+    StatelessIconv   ///< Fresh iconv descriptor per call (ConvertEncodingStatelessFast / Stateless mode)
+};
+
+/**
+ * @brief Counters of one (source, target, path) series in a ConversionMetrics snapshot
+ * @details Latencies are timed with the raw cycle counter when it runs at a constant rate
+ *          (invariant TSC on x86, CNTVCT on AArch64) and with steady_clock otherwise.
+ *          latency_buckets[i] counts calls that took [2^i, 2^(i+1)) ticks of that clock; the
+ *          upper bound of each bucket in seconds is ConversionMetrics::bucket_upper_seconds[i]
+ *          and the last bucket is open-ended.
+ */
+struct PairMetrics {
+    static constexpr size_t LATENCY_BUCKETS = 32;
+
+    std::string    from_encoding;                         ///< Source encoding name as passed by the caller
+    std::string    to_encoding;                           ///< Target encoding name as passed by the caller
+    ConversionPath path = ConversionPath::Copy;           ///< Path taken
+    uint64_t       calls = 0;                             ///< Conversion calls
+    uint64_t       errors = 0;                            ///< Calls that returned an error
+    uint64_t       bytes_in = 0;                          ///< Input bytes
+    uint64_t       bytes_out = 0;                         ///< Output bytes
+    uint64_t       total_nanoseconds = 0;                 ///< Sum of call latencies
+    std::array<uint64_t, LATENCY_BUCKETS> latency_buckets{};  ///< log2-bucketed latency histogram
+};
+
+/**
+ * @brief Merged snapshot of all per-thread metrics shards (UniConv::GetConversionMetrics())
+ */
+struct ConversionMetrics {
+    bool                     enabled = false;  ///< False when built without UNICONV_ENABLE_METRICS
+    std::vector<PairMetrics> pairs;            ///< One entry per (source, target, path), sorted by descending calls
+    /// Upper bound in seconds of each latency bucket (shared by all pairs; the last one is +infinity)
+    std::array<double, PairMetrics::LATENCY_BUCKETS> bucket_upper_seconds{};
+
+    /// Name of a path as used in the "path" label ("copy", "ascii", "simdutf", "native", "iconv", "iconv_stateless")
+    [[nodiscard]] static const char* PathName(ConversionPath path) noexcept;
+
+    /**
+     * @brief Render in the Prometheus text exposition format
+     * @details Emits uniconv_conversions_total, uniconv_conversion_errors_total,
+     *          uniconv_conversion_bytes_in_total, uniconv_conversion_bytes_out_total and the
+     *          uniconv_conversion_duration_seconds histogram, labelled by from / to / path.
+     */
+    [[nodiscard]] std::string ToPrometheusText() const;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+// === Conversion Tracing ===
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief What a traced span covers
+ */
+enum class TraceSpanKind : uint8_t {
+    Conversion,          ///< One ConvertEncodingFast / ConvertEncodingStatelessFast / ConvertInto / PreparedConversion call
+    BatchParallel,       ///< One ConvertEncodingBatchParallel() call on the calling thread
+    BatchWorker,         ///< One thread's participation in a parallel batch, from its first to its last chunk
+    BatchChunk,          ///< One contiguous range of values of a parallel batch
+    DescriptorOpen,      ///< iconv_open() for a descriptor found in neither the thread cache nor the idle pool
+    BufferPoolFallback   ///< StringBufferPool heap allocation after every pooled buffer was taken
+};
+
+/**
+ * @brief Span passed to TraceHooks::begin and, completed, to TraceHooks::end
+ */
+struct TraceSpan {
+    TraceSpanKind  kind = TraceSpanKind::Conversion;
+    const char*    from_encoding = nullptr;      ///< Source encoding as passed by the caller (nullptr for BufferPoolFallback)
+    const char*    to_encoding = nullptr;        ///< Target encoding as passed by the caller (nullptr for BufferPoolFallback)
+    size_t         bytes_in = 0;                 ///< Input bytes covered; requested capacity for BufferPoolFallback
+    size_t         items = 0;                    ///< Batch values covered (BatchParallel / BatchChunk)
+    ConversionPath path = ConversionPath::Copy;  ///< Path taken (Conversion; end only)
+    size_t         bytes_out = 0;                ///< Output bytes (Conversion; end only)
+    ErrorCode      result = ErrorCode::Success;  ///< Outcome (end only; OutOfMemory for a failed fallback allocation)
+
+    /// Static event name of a kind ("uniconv.convert", "uniconv.batch", ...), usable as a Perfetto / ITT task name
+    [[nodiscard]] static const char* KindName(TraceSpanKind kind) noexcept;
+};
+
+/**
+ * @brief Tracing callbacks installed with UniConv::SetTraceHooks()
+ * @details begin and end of one span run on the same thread and spans nest strictly, so they map
+ *          directly onto TRACE_EVENT_BEGIN / TRACE_EVENT_END (Perfetto) or __itt_task_begin /
+ *          __itt_task_end (ITT). Callbacks run inside noexcept conversion paths and must not throw;
+ *          either pointer may be null.
+ */
+struct TraceHooks {
+    void* user_data = nullptr;                                   ///< Passed back to both callbacks
+    void (*begin)(void* user_data, const TraceSpan& span) = nullptr;
+    void (*end)(void* user_data, const TraceSpan& span) = nullptr;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+// === Encoding Detection ===
+//----------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief One ranked candidate returned by UniConv::DetectEncoding()
+ */
+struct EncodingCandidate {
+    const char* encoding = nullptr;  ///< Encoding name accepted as fromEncoding ("UTF-8", "GBK", "SHIFT_JIS", ...)
+    float confidence = 0.0f;         ///< Likelihood in (0, 1]; 1 only for a BOM or a fully probed ASCII/UTF-8 input
+};
+
+/**
+ * @brief Result of UniConv::DetectEncoding()
+ * @details Candidates are sorted by descending confidence; encodings ruled out by an invalid
+ *          sequence are not listed. A BOM yields a single candidate, and the caller should skip
+ *          bom_size bytes before converting.
+ */
+struct EncodingDetection {
+    static constexpr size_t MAX_CANDIDATES = 8;
+
+    EncodingCandidate candidates[MAX_CANDIDATES];  ///< Ranked candidates, first count entries valid
+    size_t count = 0;                              ///< Number of candidates (0 = empty input)
+    size_t bom_size = 0;                           ///< Length of the leading BOM (0 = none)
+    size_t probed_bytes = 0;                       ///< Bytes examined after the BOM
+
+    /// Best candidate, or nullptr when nothing was detected
+    [[nodiscard]] const char* Best() const noexcept { return count ? candidates[0].encoding : nullptr; }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+class Singleton {
+protected:
+
+	Singleton() = default;
+	Singleton(const Singleton<T>&) = delete;
+	Singleton& operator=(const Singleton<T>& st) = delete;
+
+	static std::shared_ptr<T> _instance;
+public:
+	static std::shared_ptr<T> GetInstance() {
+		static std::once_flag s_flag;
+		std::call_once(s_flag, [&]() {
+			_instance = std::shared_ptr<T>(new T);
+			});
+
+		return _instance;
+	}
+	~Singleton() = default;
 };
 
 template <typename T>
@@ -1467,19 +2227,106 @@ private:
 	};
 
 	/**
-	 * @brief Type alias for a shared pointer to iconv_t with custom deleter.
-	 * @details Uses std::shared_ptr<void> for maximum cross-platform compatibility.
-	 * The custom deleter ensures proper cleanup via iconv_close().
-	 * 
-	 * Platform compatibility:
-	 * - Works on Windows, Linux, macOS, and other POSIX systems
-	 * - Handles the special error value (iconv_t)(-1) correctly
-	 * - Type-safe through custom deleter functor
-	 * 
-	 * @see IconvDeleter
+	 * @brief An iconv descriptor borrowed from the thread-local cache, or owned outright.
+	 * @details A borrowed descriptor stays pinned in its ThreadLocalCache slot for the
+	 * lifetime of the lease. While it is pinned, the cache will not hand it back to the
+	 * shared idle pool. Pinning is a plain increment of a thread-private counter, so
+	 * borrowing has no atomic reference-count traffic (unlike a copied std::shared_ptr).
+	 * Owned leases (Stateless mode, or a full cache with every slot pinned) close the
+	 * descriptor via IconvDeleter when they end.
+	 *
+	 * @note Move-only. A lease is released on the thread that borrowed it and must not
+	 *       outlive the call that obtained it.
 	 * @see GetIconvDescriptor
 	 */
-	using IconvSharedPtr = std::shared_ptr<void>;
+	class IconvLease {
+	public:
+		IconvLease() noexcept = default;
+
+		/// Take ownership of a freshly opened descriptor
+		static IconvLease Adopt(void* handle) noexcept {
+			IconvLease lease;
+			lease.m_handle = handle;
+			lease.m_owned  = true;
+			return lease;
+		}
+
+		/// Borrow a descriptor pinned in a thread-local cache slot
+		static IconvLease Borrow(void* handle, uint32_t* pins) noexcept {
+			IconvLease lease;
+			lease.m_handle = handle;
+			lease.m_pins   = pins;
+			++*pins;
+			return lease;
+		}
+
+		IconvLease(IconvLease&& other) noexcept
+			: m_handle(other.m_handle), m_pins(other.m_pins), m_owned(other.m_owned) {
+			other.m_handle = nullptr;
+			other.m_pins   = nullptr;
+			other.m_owned  = false;
+		}
+
+		IconvLease& operator=(IconvLease&& other) noexcept {
+			if (this != &other) {
+				Reset();
+				m_handle = other.m_handle;
+				m_pins   = other.m_pins;
+				m_owned  = other.m_owned;
+				other.m_handle = nullptr;
+				other.m_pins   = nullptr;
+				other.m_owned  = false;
+			}
+			return *this;
+		}
+
+		IconvLease(const IconvLease&) = delete;
+		IconvLease& operator=(const IconvLease&) = delete;
+
+		~IconvLease() { Reset(); }
+
+		[[nodiscard]] void* get() const noexcept { return m_handle; }
+		explicit operator bool() const noexcept { return m_handle != nullptr; }
+
+	private:
+		void Reset() noexcept {
+			if (m_pins) {
+				--*m_pins;
+			} else if (m_owned) {
+				IconvDeleter()(m_handle);
+			}
+			m_handle = nullptr;
+			m_pins   = nullptr;
+			m_owned  = false;
+		}
+
+		void*     m_handle = nullptr;  /*!< iconv_t as void* */
+		uint32_t* m_pins = nullptr;    /*!< Pin counter of the lending cache slot (borrowed leases) */
+		bool      m_owned = false;     /*!< Close on release (owned leases) */
+	};
+
+	/**
+	 * @brief Conversion route chosen once per encoding pair
+	 */
+	enum class PairRoute : uint8_t {
+		Copy,     /*!< Same encoding: byte copy */
+		Simdutf,  /*!< simdutf kernels (UNICONV_HAS_SIMDUTF builds) */
+		Native,   /*!< Built-in UTF-8/16/32 SIMD kernels and single-/double-byte codepage tables */
+		Iconv     /*!< iconv descriptor (optional ASCII passthrough first) */
+	};
+
+	/**
+	 * @brief Everything about an encoding pair that does not depend on the input
+	 * @details Resolved by MakePairPlan() per call for the name-based API, or once by
+	 * Prepare() for PreparedConversion. Names are kept by the caller.
+	 */
+	struct PairPlan {
+		uint64_t  key = 0;                       /*!< MakeEncodingPairKey() hash (Iconv route only) */
+		uint8_t   fromId = 0;                    /*!< Source EncodingId */
+		uint8_t   toId = 0;                      /*!< Target EncodingId */
+		PairRoute route = PairRoute::Iconv;      /*!< Selected conversion route */
+		bool      asciiPassthrough = false;      /*!< Both sides ASCII-compatible: pure ASCII input is copied */
+	};
 
 	//----------------------------------------------------------------------------------------------------------------------
 	// === Thread Local Cache Structure ===
@@ -1491,76 +2338,101 @@ private:
 	struct ThreadLocalCache {
 		// Iconv descriptor local cache (max 32 entries)
 		static constexpr size_t LOCAL_CACHE_SIZE = 32;
-		
-		// O(1) LRU cache implementation using list + unordered_map
-		// - list maintains LRU order: front = oldest, back = most recently used
-		// - map stores uint64_t hash key -> (descriptor, list iterator) for O(1) lookup
-		// - Using uint64_t keys eliminates string allocation/concatenation overhead
-		std::list<uint64_t> lru_order_;
-		std::unordered_map<uint64_t, std::pair<IconvSharedPtr, std::list<uint64_t>::iterator>> iconv_cache_;
-		
+
+		// CLOCK (second-chance) replacement over a fixed slot array
+		// - lookup probes linearly from the key's home slot; a hit only reads the key
+		//   and sets the reference bit (a thread-private plain store, no RMW, no clock read)
+		// - eviction sweeps the hand, clearing reference bits, and takes the first slot
+		//   that is neither referenced nor pinned by an outstanding IconvLease - amortized O(1)
+		// - slots are replaced in place and never emptied, so a probe may stop at the first empty slot
+		struct Slot {
+			uint64_t key = 0;              // MakeEncodingPairKey() hash
+			void*    handle = nullptr;     // iconv_t owned by this thread, nullptr = empty slot
+			uint32_t pins = 0;             // outstanding IconvLease count
+			bool     referenced = false;   // CLOCK reference bit
+		};
+		Slot   slots_[LOCAL_CACHE_SIZE];
+		size_t hand_ = 0;
+
 		// System encoding cache
 		bool system_encoding_cached = false;
 		std::string system_encoding;
-		
+
+		ThreadLocalCache() = default;
+		ThreadLocalCache(const ThreadLocalCache&) = delete;
+		ThreadLocalCache& operator=(const ThreadLocalCache&) = delete;
+
+		~ThreadLocalCache() {
+			for (Slot& slot : slots_) {
+				IconvDeleter()(slot.handle);
+			}
+		}
+
 		/**
-		 * @brief Get or cache an iconv descriptor in thread-local storage
+		 * @brief Look up a descriptor owned by this thread
 		 * @param key Pre-computed 64-bit hash key from MakeEncodingPairKey()
-		 * @param fromcode Source encoding
-		 * @param tocode Target encoding
-		 * @return Cached or newly created iconv descriptor
-		 * 
-		 * Time complexity: O(1) average for all operations
-		 * Memory: No string allocation for cache key
+		 * @return The slot holding the descriptor, or nullptr on miss
+		 * @note Touches only thread-private memory: no atomics, no clock reads
 		 */
-		IconvSharedPtr GetOrCreateIconvDescriptor(uint64_t key, const char* fromcode, const char* tocode) {
-			// Check if already in cache - O(1)
-			auto it = iconv_cache_.find(key);
-			if (it != iconv_cache_.end()) {
-				// Move to back of LRU list (most recently used) - O(1)
-				lru_order_.splice(lru_order_.end(), lru_order_, it->second.second);
-				return it->second.first;
+		Slot* Find(uint64_t key) noexcept {
+			size_t index = static_cast<size_t>(key % LOCAL_CACHE_SIZE);
+			for (size_t probe = 0; probe < LOCAL_CACHE_SIZE; ++probe) {
+				Slot& slot = slots_[index];
+				if (!slot.handle) {
+					return nullptr;
+				}
+				if (slot.key == key) {
+					if (!slot.referenced) {
+						slot.referenced = true;
+					}
+					return &slot;
+				}
+				index = (index + 1) % LOCAL_CACHE_SIZE;
 			}
-			
-			// Create new descriptor
-			iconv_t cd = iconv_open(tocode, fromcode);
-			if (cd == reinterpret_cast<iconv_t>(-1)) {
-				return nullptr;
-			}
-			
-			// Create shared_ptr with custom deleter (cross-platform safe)
-			auto descriptor = std::shared_ptr<void>(static_cast<void*>(cd), IconvDeleter());
-			
-			// Check cache size and evict oldest if necessary - O(1)
-			if (iconv_cache_.size() >= LOCAL_CACHE_SIZE) {
-				EvictOldest();
-			}
-			
-			// Insert into LRU list (at back = most recently used) - O(1)
-			lru_order_.push_back(key);
-			auto list_it = std::prev(lru_order_.end());
-			
-			// Insert into cache map - O(1)
-			iconv_cache_[key] = std::make_pair(descriptor, list_it);
-			
-			return descriptor;
+			return nullptr;
 		}
-		
-	private:
+
 		/**
-		 * @brief Evict the oldest (least recently used) entry - O(1)
+		 * @brief Take ownership of a descriptor for this thread - amortized O(1)
+		 * @param key Pre-computed 64-bit hash key from MakeEncodingPairKey()
+		 * @param handle Exclusively owned descriptor
+		 * @param[out] evicted The (key, descriptor) pushed out when the cache was full, otherwise {0, nullptr}
+		 * @return The slot now holding handle, or nullptr when every slot is pinned (caller keeps ownership)
+		 * @note The evicted descriptor is handed back to the caller so it can be
+		 *       returned to the shared idle pool instead of being closed.
 		 */
-		void EvictOldest() {
-			if (lru_order_.empty()) return;
-			
-			// Front of list is the oldest entry - O(1)
-			uint64_t oldest_key = lru_order_.front();
-			
-			// Remove from cache map - O(1)
-			iconv_cache_.erase(oldest_key);
-			
-			// Remove from LRU list - O(1)
-			lru_order_.pop_front();
+		Slot* Insert(uint64_t key, void* handle, std::pair<uint64_t, void*>& evicted) noexcept {
+			evicted = {0, nullptr};
+			size_t index = static_cast<size_t>(key % LOCAL_CACHE_SIZE);
+			for (size_t probe = 0; probe < LOCAL_CACHE_SIZE; ++probe) {
+				Slot& slot = slots_[index];
+				if (!slot.handle) {
+					slot.key = key;
+					slot.handle = handle;
+					slot.referenced = true;
+					return &slot;
+				}
+				index = (index + 1) % LOCAL_CACHE_SIZE;
+			}
+
+			// Full: two sweeps always find an unreferenced slot unless every slot is pinned
+			for (size_t sweep = 0; sweep < 2 * LOCAL_CACHE_SIZE; ++sweep) {
+				Slot& slot = slots_[hand_];
+				hand_ = (hand_ + 1) % LOCAL_CACHE_SIZE;
+				if (slot.pins != 0) {
+					continue;
+				}
+				if (slot.referenced) {
+					slot.referenced = false;
+					continue;
+				}
+				evicted = {slot.key, slot.handle};
+				slot.key = key;
+				slot.handle = handle;
+				slot.referenced = true;
+				return &slot;
+			}
+			return nullptr;
 		}
 	};
 
@@ -1592,17 +2464,6 @@ private:
 	}
 #endif
 
-	/**
-	 * @struct EncodingInfo
-	 * @brief Structure to hold encoding information.
-	 * @details This structure holds information about a specific text encoding.
-	 */
-	struct EncodingInfo
-	{
-		std::string dotNetName;  /*!< .NET encoding name */
-		std::string extra_info;	 /*!< Extra information */
-	};
-
 public:
 
 	/**
@@ -1660,6 +2521,58 @@ public:
         #undef X
         count
         };
+
+	/**
+	 * @brief Interned encoding: an index into the encodings.inc table
+	 * @details Code-page names accepted by IsValidEncodingName that encodings.inc does not list
+	 * (e.g. "IBM437", "Windows-1255") get indices after the encodings.inc entries.
+	 * Obtain one from an Encoding enumerator (implicit) or InternEncoding(name) once,
+	 * then pass it to the EncodingHandle overloads. The conversion then skips everything that
+	 * depends on the text of the names (strlen, case folding, hashing, name validation):
+	 * the route comes from a per-pair table indexed by the two handles and the descriptor
+	 * cache key is computed arithmetically from them.
+	 * @code
+	 * static const auto gbk = UniConv::InternEncoding("GBK");
+	 * conv->ConvertEncodingFast(input, gbk, UniConv::Encoding::utf_8, output);
+	 * @endcode
+	 */
+	class EncodingHandle {
+	public:
+		/// Invalid handle (IsValid() == false)
+		constexpr EncodingHandle() noexcept = default;
+
+		/// Handle of an encodings.inc entry (invalid for Encoding::count and out-of-range values)
+		constexpr EncodingHandle(Encoding encoding) noexcept
+			: m_index(static_cast<uint16_t>(encoding) < static_cast<uint16_t>(Encoding::count)
+				? static_cast<uint16_t>(encoding) : kInvalidIndex) {}
+
+		[[nodiscard]] constexpr bool IsValid() const noexcept { return m_index != kInvalidIndex; }
+		[[nodiscard]] constexpr uint16_t Index() const noexcept { return m_index; }
+
+		constexpr bool operator==(EncodingHandle other) const noexcept { return m_index == other.m_index; }
+		constexpr bool operator!=(EncodingHandle other) const noexcept { return m_index != other.m_index; }
+
+	private:
+		friend class UniConv;
+		static constexpr uint16_t kInvalidIndex = 0xFFFF;
+
+		explicit constexpr EncodingHandle(uint16_t index) noexcept : m_index(index) {}
+
+		uint16_t m_index = kInvalidIndex;
+	};
+
+	/**
+	 * @brief Intern an encoding name
+	 * @param name Case-insensitive encodings.inc name, common alias ("utf8", "latin1", "sjis", ...)
+	 *             or any other name IsValidEncodingName accepts
+	 * @return Handle, or an invalid handle when IsValidEncodingName rejects the name
+	 */
+	static EncodingHandle InternEncoding(const char* name) noexcept;
+
+	/**
+	 * @brief Canonical encodings.inc name of a handle (nullptr for an invalid handle)
+	 */
+	static const char* GetEncodingName(EncodingHandle encoding) noexcept;
 	//---------------------------------------------------------------------------
 	//@} End of Supported encodings
 	//---------------------------------------------------------------------------
@@ -2257,6 +3170,7 @@ public:
 	ErrorCode ConvertEncodingStatelessFast(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept;
 	bool ConvertEncodingStateless(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept;
 	ErrorCode ConvertEncodingStatelessFast(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept;
+	ErrorCode ConvertEncodingStatelessFast(std::string_view input, EncodingHandle fromEncoding, EncodingHandle toEncoding, std::string& output) noexcept;
 
 	//----------------------------------------------------------------------------------------------------------------------
 	// === Zero-Copy Output Parameter API (High Performance) 
@@ -2358,6 +3272,63 @@ public:
 	 * @return ErrorCode indicating success or failure type
 	 */
 	ErrorCode ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept;
+
+	/**
+	 * @brief Conversion that replaces or skips bad sequences instead of failing the whole buffer
+	 * @param input Input string view
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name
+	 * @param output Output string (caller-provided)
+	 * @param policy Strict behaves like the overload above; Replace / Skip resume right after each bad sequence
+	 * @param report Optional statistics: number of bad sequences and the offset of the first one
+	 * @return ErrorCode::Success unless the names are invalid or the conversion itself cannot run
+	 * @note Invalid UTF-8 is replaced per maximal subpart (one U+FFFD per ill-formed prefix), UTF-16/32 per
+	 *       code unit, other encodings per byte; a valid character the target cannot map is replaced as a whole.
+	 * @note The converted prefix is never redone. Stateful encodings (ISO-2022-*, UTF-7) restart from the
+	 *       initial shift state after a bad sequence.
+	 */
+	ErrorCode ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding,
+		std::string& output, ErrorPolicy policy, ConversionReport* report = nullptr) noexcept;
+
+	/**
+	 * @brief Conversion to UTF-8 with NFC / NFKC normalization fused into the same pass
+	 * @param input Input string view
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name (must be UTF-8 unless form is None)
+	 * @param output Output string (caller-provided)
+	 * @param form Normalization form; None behaves like the overload without it
+	 * @return ErrorCode indicating success or failure type; InvalidParameter for a non-UTF-8 target
+	 * @details Input is converted in 64KB blocks (see ConversionPipeline). Each block of output is
+	 * quick-checked while still in cache: ASCII runs and U+4000-U+9FFF ideographs are skipped without
+	 * table lookups, and a block with only NFC_QC / NFKC_QC = Yes characters in canonical order is
+	 * left as is. Only segments that fail the check (from the preceding starter to the next one)
+	 * are decomposed, reordered and recomposed.
+	 */
+	ErrorCode ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding,
+		std::string& output, NormalizationForm form) noexcept;
+
+	/**
+	 * @brief Normalize UTF-8 text to NFC / NFKC
+	 * @param input UTF-8 input
+	 * @param form Normalization form (None copies the input)
+	 * @param output Normalized text (cleared on failure)
+	 * @return Success, or InvalidSequence / IncompleteSequence for ill-formed UTF-8
+	 * @note Already-normalized input costs one quick-check scan and one copy.
+	 */
+	static ErrorCode NormalizeUtf8(std::string_view input, NormalizationForm form, std::string& output) noexcept;
+
+	/**
+	 * @brief High-performance conversion with interned encodings (no per-call name parsing)
+	 * @return InvalidSourceEncoding / InvalidTargetEncoding for an invalid handle, otherwise as the name overload
+	 */
+	ErrorCode ConvertEncodingFast(std::string_view input, EncodingHandle fromEncoding, EncodingHandle toEncoding,
+		std::string& output) noexcept;
+
+	/**
+	 * @brief High-performance conversion with interned encodings returning CompactResult
+	 */
+	StringResult ConvertEncodingFast(std::string_view input, EncodingHandle fromEncoding,
+		EncodingHandle toEncoding) noexcept;
 	
 	// string_view input overloads (output parameter versions for buffer reuse)
 	bool ToUtf8FromLocale(std::string_view input, std::string& output) noexcept;
@@ -2368,6 +3339,170 @@ public:
 	bool ToUtf16LEFromLocale(std::string_view input, std::u16string& output) noexcept;
 	bool ToUtf16BEFromLocale(std::string_view input, std::u16string& output) noexcept;
 
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Caller-Supplied Buffer Conversion (No Allocation) ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief Convert into a caller-provided buffer (e.g. a registered I/O buffer)
+	 * @param input Input data
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name
+	 * @param output Caller-provided output buffer
+	 * @param outputCapacity Size of the output buffer in bytes
+	 * @param[out] consumed Bytes of input consumed
+	 * @param[out] written Bytes written to output
+	 * @return Success when the whole input was converted;
+	 *         BufferTooSmall when the buffer filled up first (consumed/written stop at a
+	 *         character boundary, call again with the unconsumed rest);
+	 *         InvalidSequence / IncompleteSequence with consumed pointing at the offending sequence;
+	 *         InvalidParameter / InvalidSourceEncoding / InvalidTargetEncoding / ConversionFailed
+	 * @details Writes only into the caller's buffer; no output or temporary storage is allocated
+	 * (the iconv path may open a descriptor the first time a pair is used on a thread).
+	 * UTF-8/16LE/16BE/32LE/32BE pairs use the built-in SIMD kernels
+	 * when outputCapacity >= MaxOutputSize(); smaller buffers and all other pairs go through
+	 * the thread-owned iconv descriptor. No BOM is written and no 10MB cap applies.
+	 * @note For stateful encodings (ISO-2022-*, UTF-7) split across calls, use StreamConverter.
+	 */
+	ErrorCode ConvertInto(std::string_view input, const char* fromEncoding, const char* toEncoding,
+	                      char* output, size_t outputCapacity, size_t& consumed, size_t& written) noexcept;
+
+	/**
+	 * @brief Upper bound of the output size of ConvertInto() for a given input size
+	 * @param inputSize Input size in bytes
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name
+	 * @return Buffer size in bytes that guarantees ConvertInto() never returns BufferTooSmall;
+	 *         SIZE_MAX if the bound overflows
+	 * @note Unlike the internal size estimate this is a hard worst-case bound: exact per-pair
+	 * factors for resynchronisable encodings, 8 bytes per input byte otherwise.
+	 */
+	static size_t MaxOutputSize(size_t inputSize, const char* fromEncoding, const char* toEncoding) noexcept;
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Validation & Output Length (No Output Written) ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief Check that input is well-formed in the given encoding without converting it
+	 * @param input Input data
+	 * @param encoding Encoding name
+	 * @param[out] errorOffset Offset of the first invalid or incomplete sequence; input.size() on success
+	 * @return Success, InvalidSequence, IncompleteSequence,
+	 *         InvalidParameter / InvalidSourceEncoding / ConversionFailed
+	 * @details UTF-8/16LE/16BE/32LE/32BE use the simdutf validator when linked, otherwise the
+	 * built-in decoder (ASCII runs skipped by the SIMD prescan); single-byte and double-byte
+	 * codepages with built-in tables are checked by table lookup. Other encodings are decoded
+	 * by iconv into a small stack buffer that is discarded.
+	 */
+	ErrorCode Validate(std::string_view input, const char* encoding, size_t& errorOffset) noexcept;
+
+	/**
+	 * @brief Validate() without the error offset
+	 */
+	ErrorCode Validate(std::string_view input, const char* encoding) noexcept;
+
+	/**
+	 * @brief Exact output length of a conversion, computed without writing any output
+	 * @param input Input data
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name
+	 * @param[out] units Output length in target code units: char16_t for UTF-16*, char32_t for
+	 *             UTF-32*, bytes otherwise. On failure, the units of the part before the error
+	 * @return The error ConvertEncodingFast() would report (InvalidSequence for characters the
+	 *         target cannot represent), or Success
+	 * @details Matches ConvertEncodingFast() / ConvertInto() exactly, including their passthrough of
+	 * same-encoding input. Use it to size a ConvertInto() buffer tightly or to reject bad input
+	 * before queuing it; MaxOutputSize() remains the cheaper worst-case bound.
+	 */
+	ErrorCode CountOutputUnits(std::string_view input, const char* fromEncoding, const char* toEncoding,
+	                           size_t& units) noexcept;
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Prepared Encoding Pair (Resolve Once, Convert Many) ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief Encoding pair resolved once for hot call sites that always convert the same pair
+	 * @details Name validation, EncodingId parsing, ASCII-compatibility checks, kernel choice
+	 * (copy / simdutf / built-in SIMD / iconv) and the descriptor cache key are computed by
+	 * Prepare(). Each call then only dispatches on the stored route; the iconv route looks up
+	 * the calling thread's descriptor by the precomputed key without strlen or hashing.
+	 *
+	 * Example:
+	 * @code
+	 * static const auto gbk_to_utf8 = conv->Prepare("GBK", "UTF-8");
+	 * std::string out;
+	 * ErrorCode ec = gbk_to_utf8.Convert(frame, out);
+	 * @endcode
+	 *
+	 * @note Thread-safe: const methods may be called concurrently (descriptors are thread-owned).
+	 * @note Must not outlive the UniConv instance that created it.
+	 */
+	class UNICONV_EXPORT PreparedConversion {
+	public:
+		/// Construct an invalid handle (GetStatus() == InvalidParameter)
+		PreparedConversion() noexcept = default;
+
+		/// Whether Prepare() succeeded
+		[[nodiscard]] bool IsValid() const noexcept { return m_status == ErrorCode::Success; }
+
+		/**
+		 * @brief Preparation status
+		 * @return Success, InvalidParameter, InvalidSourceEncoding, InvalidTargetEncoding or OutOfMemory
+		 */
+		[[nodiscard]] ErrorCode GetStatus() const noexcept { return m_status; }
+
+		[[nodiscard]] const char* GetFromEncoding() const noexcept { return m_from.c_str(); }
+		[[nodiscard]] const char* GetToEncoding() const noexcept { return m_to.c_str(); }
+
+		/**
+		 * @brief Convert with caller-provided output (same semantics as ConvertEncodingFast())
+		 */
+		ErrorCode Convert(std::string_view input, std::string& output) const noexcept;
+
+		/**
+		 * @brief Convert replacing or skipping bad sequences (see the ErrorPolicy overload of ConvertEncodingFast())
+		 */
+		ErrorCode Convert(std::string_view input, std::string& output, ErrorPolicy policy,
+		                  ConversionReport* report = nullptr) const noexcept;
+
+		/**
+		 * @brief Convert returning CompactResult
+		 */
+		StringResult Convert(std::string_view input) const noexcept;
+
+		/**
+		 * @brief Convert into a caller-provided buffer (same semantics as UniConv::ConvertInto())
+		 */
+		ErrorCode ConvertInto(std::string_view input, char* output, size_t outputCapacity,
+		                      size_t& consumed, size_t& written) const noexcept;
+
+		/**
+		 * @brief Worst-case output size for this pair (see UniConv::MaxOutputSize())
+		 */
+		[[nodiscard]] size_t MaxOutputSize(size_t inputSize) const noexcept;
+
+		/**
+		 * @brief Exact output length for this pair (see UniConv::CountOutputUnits())
+		 */
+		ErrorCode CountOutputUnits(std::string_view input, size_t& units) const noexcept;
+
+	private:
+		friend class UniConv;
+
+		UniConv*    m_owner = nullptr;                    /*!< Instance owning the descriptor cache */
+		std::string m_from;                               /*!< Source encoding name (for iconv_open) */
+		std::string m_to;                                 /*!< Target encoding name (for iconv_open) */
+		PairPlan    m_plan;                               /*!< Resolved route, ids and cache key */
+		ErrorCode   m_status = ErrorCode::InvalidParameter; /*!< Preparation status */
+	};
+
+	/**
+	 * @brief Resolve an encoding pair once for repeated conversions
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name
+	 * @return Prepared handle; check IsValid() / GetStatus()
+	 */
+	PreparedConversion Prepare(const char* fromEncoding, const char* toEncoding) noexcept;
+
 	//----------------------------------------------------------------------------------------------------------------------
 	// === High-Performance Methods using CompactResult ===
 	//----------------------------------------------------------------------------------------------------------------------
@@ -2414,6 +3549,14 @@ public:
 	 */
 	UNICONV_FLATTEN std::vector<StringResult> ConvertEncodingBatch(const std::vector<std::string>& inputs,const char* fromEncoding,const char* toEncoding) noexcept;
 
+	/**
+	 * @brief Batch conversion to UTF-8 with NFC / NFKC normalization of every value
+	 * @return Conversion result list; every entry fails with InvalidParameter for a non-UTF-8 target
+	 * @see ConvertEncodingFast(std::string_view, const char*, const char*, std::string&, NormalizationForm)
+	 */
+	std::vector<StringResult> ConvertEncodingBatch(const std::vector<std::string>& inputs,
+		const char* fromEncoding, const char* toEncoding, NormalizationForm form) noexcept;
+
 	/**
 	 * @brief Parallel batch encoding conversion (return value version)
 	 * @param inputs Input string list
@@ -2446,12 +3589,573 @@ public:
 		std::vector<std::string>& outputs,
 		size_t numThreads = 0) noexcept;
 
+	/**
+	 * @brief Batch conversion over contiguous storage (Arrow-style offsets layout)
+	 * @param data Concatenated input values
+	 * @param offsets count + 1 non-decreasing offsets into data; value i is [offsets[i], offsets[i + 1])
+	 * @param count Number of values
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name
+	 * @param outData Output arena (caller-provided, capacity reused); receives all converted values back to back
+	 * @param outOffsets Output offsets (resized to count + 1); value i is [outOffsets[i], outOffsets[i + 1])
+	 * @param itemErrors Optional per-value error codes (resized to count)
+	 * @return Success if every value converted; otherwise the first failing value's error code
+	 *         (failed values occupy an empty range). InvalidParameter if offsets are malformed.
+	 * @details The encoding pair is resolved once for the whole batch and every value is
+	 * converted straight into the tail of outData, which grows geometrically. Two output
+	 * containers are touched per batch instead of one std::string per value; reusing them
+	 * across batches makes the steady state allocation-free.
+	 */
+	ErrorCode ConvertEncodingBatch(
+		std::string_view data,
+		const size_t* offsets,
+		size_t count,
+		const char* fromEncoding,
+		const char* toEncoding,
+		std::string& outData,
+		std::vector<size_t>& outOffsets,
+		std::vector<ErrorCode>* itemErrors = nullptr) noexcept;
+
+	/**
+	 * @brief Contiguous-storage batch conversion to UTF-8 with NFC / NFKC normalization
+	 * @details Each value is quick-checked right after it is written to the tail of outData and
+	 * normalized in place only if the check fails. A non-UTF-8 target returns InvalidParameter.
+	 * @see ConvertEncodingBatch(std::string_view, const size_t*, size_t, const char*, const char*, std::string&, std::vector<size_t>&, std::vector<ErrorCode>*)
+	 */
+	ErrorCode ConvertEncodingBatch(
+		std::string_view data,
+		const size_t* offsets,
+		size_t count,
+		const char* fromEncoding,
+		const char* toEncoding,
+		std::string& outData,
+		std::vector<size_t>& outOffsets,
+		NormalizationForm form,
+		std::vector<ErrorCode>* itemErrors = nullptr) noexcept;
+
+	/**
+	 * @brief Contiguous-storage batch conversion with interned encodings
+	 * @see ConvertEncodingBatch(std::string_view, const size_t*, size_t, const char*, const char*, std::string&, std::vector<size_t>&, std::vector<ErrorCode>*)
+	 */
+	ErrorCode ConvertEncodingBatch(
+		std::string_view data,
+		const size_t* offsets,
+		size_t count,
+		EncodingHandle fromEncoding,
+		EncodingHandle toEncoding,
+		std::string& outData,
+		std::vector<size_t>& outOffsets,
+		std::vector<ErrorCode>* itemErrors = nullptr) noexcept;
+
+	/**
+	 * @brief Batch conversion with interned encodings (one result per input)
+	 */
+	std::vector<StringResult> ConvertEncodingBatch(const std::vector<std::string>& inputs,
+		EncodingHandle fromEncoding, EncodingHandle toEncoding) noexcept;
+
+#if UNICONV_HAS_PMR
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Polymorphic Memory Resource Outputs (std::pmr) ===
+	//----------------------------------------------------------------------------------------------------------------------
+	// 输出容器的分配器决定内存来源：同一请求的全部转换结果可分配自同一个
+	// std::pmr::monotonic_buffer_resource（或 jemalloc arena 包装的 memory_resource），请求结束时一次性释放。
+	// 转换直接写入这些容器，不经过全局堆上的中间 std::string。
+
+	/// 结果字符串分配自调用方 memory_resource 的 CompactResult
+	using PmrStringResult = CompactResult<std::pmr::string>;
+
+	/**
+	 * @brief High-performance conversion into a std::pmr::string (allocator of output is used)
+	 * @see ConvertEncodingFast(std::string_view, const char*, const char*, std::string&)
+	 */
+	ErrorCode ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding,
+		std::pmr::string& output) noexcept;
+
+	/**
+	 * @brief High-performance conversion returning a string allocated from resource
+	 * @param resource Memory resource for the result (nullptr = std::pmr::get_default_resource())
+	 */
+	PmrStringResult ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding,
+		std::pmr::memory_resource* resource) noexcept;
+
+	/**
+	 * @brief Batch conversion into pmr strings (each output uses outputs' allocator)
+	 * @return true if all conversions succeeded; failed items are left empty
+	 */
+	bool ConvertEncodingBatch(
+		const std::vector<std::string>& inputs,
+		const char* fromEncoding,
+		const char* toEncoding,
+		std::pmr::vector<std::pmr::string>& outputs) noexcept;
+
+	/**
+	 * @brief Contiguous-storage batch conversion into pmr containers
+	 * @see ConvertEncodingBatch(std::string_view, const size_t*, size_t, const char*, const char*, std::string&, std::vector<size_t>&, std::vector<ErrorCode>*)
+	 */
+	ErrorCode ConvertEncodingBatch(
+		std::string_view data,
+		const size_t* offsets,
+		size_t count,
+		const char* fromEncoding,
+		const char* toEncoding,
+		std::pmr::string& outData,
+		std::pmr::vector<size_t>& outOffsets,
+		std::vector<ErrorCode>* itemErrors = nullptr) noexcept;
+
+	// Typed conversions into pmr strings (output parameter versions)
+	bool ToUtf8FromLocale(std::string_view input, std::pmr::string& output) noexcept;
+	bool ToLocaleFromUtf8(std::string_view input, std::pmr::string& output) noexcept;
+	bool ToUtf8FromUtf16LE(std::u16string_view input, std::pmr::string& output) noexcept;
+	bool ToUtf8FromUtf16BE(std::u16string_view input, std::pmr::string& output) noexcept;
+	bool ToUtf8FromUtf32LE(std::u32string_view input, std::pmr::string& output) noexcept;
+	bool ToUtf16LEFromUtf8(std::string_view input, std::pmr::u16string& output) noexcept;
+	bool ToUtf16BEFromUtf8(std::string_view input, std::pmr::u16string& output) noexcept;
+	bool ToUtf16BEFromUtf16LE(std::u16string_view input, std::pmr::u16string& output) noexcept;
+	bool ToUtf16LEFromUtf16BE(std::u16string_view input, std::pmr::u16string& output) noexcept;
+	bool ToUtf16LEFromUtf32LE(std::u32string_view input, std::pmr::u16string& output) noexcept;
+	bool ToUtf16BEFromUtf32LE(std::u32string_view input, std::pmr::u16string& output) noexcept;
+	bool ToUtf32LEFromUtf8(std::string_view input, std::pmr::u32string& output) noexcept;
+	bool ToUtf32LEFromUtf16LE(std::u16string_view input, std::pmr::u32string& output) noexcept;
+	bool ToUtf32LEFromUtf16BE(std::u16string_view input, std::pmr::u32string& output) noexcept;
+#endif // UNICONV_HAS_PMR
+
+	/**
+	 * @brief Chunk-parallel conversion of a single large buffer (output parameter version)
+	 * @param input Input data
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name
+	 * @param output Output string (caller-provided)
+	 * @param numThreads Number of chunks/threads to use (0 = auto-detect)
+	 * @return ErrorCode indicating success or failure type
+	 * @details The input is split at safe character boundaries and each chunk is
+	 * converted on a ThreadPool::ParallelFor worker with its own iconv descriptor.
+	 * Every worker writes straight into one preallocated output at an offset taken
+	 * from a prefix scan of per-chunk worst-case sizes; a final in-place compaction
+	 * closes the gaps. No per-chunk strings are allocated and no 10MB cap applies.
+	 *
+	 * Splittable sources: UTF-8, UTF-16LE/BE, UTF-32LE/BE, single-byte codepages
+	 * (ASCII, ISO-8859-1, Windows-1252) and double-byte codepages whose trail-byte
+	 * range allows resynchronisation (GBK, GB2312, GB18030, Big5, Shift_JIS, EUC-JP, EUC-KR).
+	 * Other pairs (BOM-dependent UTF-16/UTF-32, unknown or stateful encodings) and
+	 * inputs below twice the pair's min_bytes_per_chunk threshold (default AdaptiveParallelPolicy::MIN_BYTES_PER_CHUNK,
+	 * see CalibrateParallelPolicy()) fall back to ConvertEncodingFast().
+	 */
+	ErrorCode ConvertEncodingParallel(
+		std::string_view input,
+		const char* fromEncoding,
+		const char* toEncoding,
+		std::string& output,
+		size_t numThreads = 0) noexcept;
+
+	/**
+	 * @brief Chunk-parallel conversion of a single large buffer (CompactResult version)
+	 * @see ConvertEncodingParallel(std::string_view, const char*, const char*, std::string&, size_t)
+	 */
+	StringResult ConvertEncodingParallel(
+		std::string_view input,
+		const char* fromEncoding,
+		const char* toEncoding,
+		size_t numThreads = 0) noexcept;
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Parallel Policy Calibration ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief 测量本机派发开销与各成本类每字节耗时，并据此设置并行阈值
+	 * @param sampleBytes 每个成本类的测量样本大小（0 = 默认 256KB）
+	 * @return 测量结果与已写入的阈值
+	 * @details 一次性微基准（通常数十毫秒）：在共享线程池上测量空 ParallelFor 的派发耗时，
+	 * 再对 memcpy、simdutf、内置 UTF 内核、iconv（Unicode / 单字节 / 多字节码页）各转换一段样本。
+	 * 某一类的串行阈值取“转换耗时达到派发开销若干倍”的字节数，轻度并行上限与分块最小字节数随线程数
+	 * 与每字节成本等比缩放。阈值为进程级全局设置，线程安全；未调用时使用 AdaptiveParallelPolicy 默认常量。
+	 */
+	static ParallelCalibration CalibrateParallelPolicy(size_t sampleBytes = 0) noexcept;
+
+	/**
+	 * @brief 获取某一成本类当前生效的并行阈值
+	 */
+	static ParallelThresholds GetParallelThresholds(ParallelCostClass costClass) noexcept;
+
+	/**
+	 * @brief 手动设置某一成本类的并行阈值（例如加载预先标定的配置）
+	 */
+	static void SetParallelThresholds(ParallelCostClass costClass, const ParallelThresholds& thresholds) noexcept;
+
+	/**
+	 * @brief 将全部成本类恢复为默认阈值
+	 */
+	static void ResetParallelPolicy() noexcept;
+
+	/**
+	 * @brief 编码对在单条转换（ConvertEncodingFast 路径）下所属的成本类
+	 */
+	static ParallelCostClass ClassifyParallelCost(const char* fromEncoding, const char* toEncoding) noexcept;
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Encoding Detection ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief 只读取有限前缀，猜测输入的编码（不做任何试转换）
+	 * @param input 待检测的数据
+	 * @param maxProbeBytes BOM 之后最多检查的字节数（0 = 整个输入）
+	 * @return 按置信度排序的候选编码
+	 * @details 依次判断：BOM（DetectAndRemoveBom）→ 无 BOM 的 UTF-16/32（按位置统计 NUL 字节）→
+	 * ASCII 兼容候选。最后一步中 ASCII 段由向量预扫描整段跳过，UTF-8 严格校验（启用 simdutf 时向量化）、GBK / GB18030 / Big5 /
+	 * Shift_JIS / EUC-JP / EUC-KR 结构校验加高频字符命中率、CP1252 / CP1250 / CP1251 / KOI8-R / CP1253
+	 * 按字母大小写形态打分；各模型独立扫描 probe，遇到非法序列即停止且不列出。
+	 * 高频字符按码点统计（由内置码表解码），短输入的置信度按字符数折扣。
+	 * @note 无 NUL 字节特征的 UTF-16/32（如纯中文的 UTF-16）无法识别；probe 末尾被截断的多字节序列不算非法
+	 */
+	EncodingDetection DetectEncoding(std::string_view input, size_t maxProbeBytes = 64 * 1024) noexcept;
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Fused Conversion Pipeline (BOM Strip → Detect → Convert → Normalize) ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief Composable conversion pipeline whose stages run fused over cache-sized blocks
+	 * @details Stages, in order:
+	 * - StripBom(): a leading BOM is removed and overrides the source encoding;
+	 * - DetectSource(): without a BOM, DetectEncoding() probes the first block only and its best
+	 *   candidate replaces the declared source encoding (which stays the fallback);
+	 * - conversion to the target encoding;
+	 * - NormalizeNewlines(): CRLF and lone CR become LF;
+	 * - StripNul(): U+0000 code units are dropped;
+	 * - Normalize(): NFC / NFKC for a UTF-8 target.
+	 *
+	 * Run() walks the input in windows of BlockSize() bytes. Each window is converted straight
+	 * into the output string, then the newline / NUL stages rewrite exactly the bytes just
+	 * produced, in place, while they are still in L1/L2; normalization quick-checks the same bytes
+	 * and holds back only the trailing segment after the last starter, which may still combine
+	 * with the next window. The input is therefore read once and
+	 * the output written once, instead of one full pass per stage with an intermediate string
+	 * in between. Windows may end inside a multibyte sequence; the tail is simply carried into
+	 * the next window. The iconv route keeps one descriptor for the whole run, so stateful
+	 * encodings keep their shift state across windows and the final shift sequence is flushed.
+	 *
+	 * Example:
+	 * @code
+	 * auto pipeline = conv->MakePipeline(nullptr, "UTF-8");    // source from BOM / detection
+	 * pipeline.StripBom().DetectSource().NormalizeNewlines().StripNul();
+	 * std::string text;
+	 * const char* source = nullptr;
+	 * ErrorCode ec = pipeline.Run(file_bytes, text, &source);
+	 * @endcode
+	 *
+	 * @note Newline / NUL stages operate on target code units and require an ASCII-compatible,
+	 *       UTF-16 or UTF-32 target; other targets make Run() return InvalidParameter.
+	 * @note Thread-safe: Run() is const. Must not outlive the UniConv instance that created it.
+	 */
+	class UNICONV_EXPORT ConversionPipeline {
+	public:
+		/// Default window size: input block plus its converted output stay within a typical L2
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+		/// Smallest accepted window (always holds a complete 4-byte sequence)
+		static constexpr size_t MIN_BLOCK_SIZE = 64;
+
+		/// Construct an invalid pipeline (GetStatus() == InvalidParameter)
+		ConversionPipeline() noexcept = default;
+
+		/// Whether MakePipeline() succeeded
+		[[nodiscard]] bool IsValid() const noexcept { return m_status == ErrorCode::Success; }
+
+		/**
+		 * @brief Construction status
+		 * @return Success, InvalidParameter, InvalidSourceEncoding, InvalidTargetEncoding or OutOfMemory
+		 */
+		[[nodiscard]] ErrorCode GetStatus() const noexcept { return m_status; }
+
+		/// Remove a leading BOM and let it override the source encoding
+		ConversionPipeline& StripBom(bool enable = true) noexcept;
+		/// Detect the source encoding from the first block when no BOM is present
+		ConversionPipeline& DetectSource(bool enable = true) noexcept;
+		/// Rewrite CRLF and lone CR to LF in the output
+		ConversionPipeline& NormalizeNewlines(bool enable = true) noexcept;
+		/// Drop NUL code units from the output
+		ConversionPipeline& StripNul(bool enable = true) noexcept;
+		/// Normalize the output to NFC / NFKC (UTF-8 target only; None disables the stage)
+		ConversionPipeline& Normalize(NormalizationForm form) noexcept;
+		/// Window size in input bytes (clamped to at least MIN_BLOCK_SIZE)
+		ConversionPipeline& BlockSize(size_t bytes) noexcept;
+
+		/**
+		 * @brief Run all enabled stages over the input
+		 * @param input Input bytes
+		 * @param[out] output Result (cleared on failure)
+		 * @param[out] sourceEncoding Optional; receives the source encoding actually used
+		 *             (a static name, or the declared name owned by this pipeline)
+		 * @return Success; InvalidSourceEncoding when no source was declared and none could be
+		 *         detected; InvalidSequence / IncompleteSequence on malformed input;
+		 *         InvalidParameter for newline / NUL stages on an unsupported target, or for
+		 *         normalization on a target other than UTF-8
+		 */
+		ErrorCode Run(std::string_view input, std::string& output,
+		              const char** sourceEncoding = nullptr) const noexcept;
+
+		/**
+		 * @brief Run returning CompactResult
+		 */
+		StringResult Run(std::string_view input) const noexcept;
+
+	private:
+		friend class UniConv;
+
+		static constexpr uint8_t STAGE_STRIP_BOM     = 1u << 0;
+		static constexpr uint8_t STAGE_DETECT_SOURCE = 1u << 1;
+		static constexpr uint8_t STAGE_NEWLINES      = 1u << 2;
+		static constexpr uint8_t STAGE_STRIP_NUL     = 1u << 3;
+
+		ConversionPipeline& SetStage(uint8_t stage, bool enable) noexcept;
+
+		UniConv*    m_owner = nullptr;                    /*!< Instance owning the descriptor cache */
+		std::string m_from;                               /*!< Declared source encoding (may be empty) */
+		std::string m_to;                                 /*!< Target encoding name */
+		uint8_t     m_stages = 0;                         /*!< Enabled STAGE_* bits */
+		size_t      m_blockSize = DEFAULT_BLOCK_SIZE;     /*!< Window size in input bytes */
+		NormalizationForm m_normalization = NormalizationForm::None; /*!< Normalize() stage */
+		ErrorCode   m_status = ErrorCode::InvalidParameter; /*!< Construction status */
+	};
+
+	/**
+	 * @brief Create a conversion pipeline for the given target encoding
+	 * @param fromEncoding Declared source encoding; nullptr enables DetectSource() and leaves
+	 *        the source to the BOM / detection stages
+	 * @param toEncoding Target encoding name
+	 * @return Pipeline with no optional stages enabled; check IsValid() / GetStatus()
+	 */
+	ConversionPipeline MakePipeline(const char* fromEncoding, const char* toEncoding) noexcept;
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Asynchronous Conversion ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief 异步执行器：接收一个任务并在任意线程上执行（例如包装 asio::post / gRPC 回调队列）
+	 * @note 为空时任务提交到 UniConvThreadPool
+	 */
+	using AsyncExecutor = std::function<void(std::function<void()>)>;
+
+	/// 单条异步转换完成回调
+	using AsyncCallback = std::function<void(StringResult)>;
+
+	/// 批量异步转换完成回调（结果与输入一一对应）
+	using AsyncBatchCallback = std::function<void(std::vector<StringResult>)>;
+
+	/**
+	 * @brief 异步转换：立即返回，完成后在执行线程上调用 onComplete
+	 * @param input 输入数据（按值接管，调用方无需保持其生命周期）
+	 * @param fromEncoding 源编码（调用期间复制）
+	 * @param toEncoding 目标编码（调用期间复制）
+	 * @param onComplete 完成回调；抛出的异常会被吞掉
+	 * @param executor 执行器（为空时使用 UniConvThreadPool）
+	 * @return 任务是否已提交；非 Success 时 onComplete 不会被调用
+	 * @details 大输入在执行线程上走 ConvertEncodingParallel() 分块并行（工作线程参与执行，不会死锁）。
+	 * 当前 UniConv 实例必须存活到回调返回。
+	 *
+	 * @code
+	 * conv->ConvertEncodingAsync(std::move(body), "GBK", "UTF-8",
+	 *     [session](StringResult r) { session->Reply(std::move(r)); });
+	 * @endcode
+	 */
+	ErrorCode ConvertEncodingAsync(std::string input, const char* fromEncoding, const char* toEncoding,
+		AsyncCallback onComplete, const AsyncExecutor& executor = {}) noexcept;
+
+	/**
+	 * @brief 批量异步转换：立即返回，全部完成后调用一次 onComplete
+	 * @param numThreads 并行线程数（0 = 自动）
+	 * @see ConvertEncodingAsync(), ConvertEncodingBatchParallel()
+	 */
+	ErrorCode ConvertEncodingBatchAsync(std::vector<std::string> inputs, const char* fromEncoding,
+		const char* toEncoding, AsyncBatchCallback onComplete, size_t numThreads = 0,
+		const AsyncExecutor& executor = {}) noexcept;
+
+#if UNICONV_HAS_COROUTINES
+	/**
+	 * @brief C++20 协程等待体：co_await 时提交 ConvertEncodingAsync，完成后在执行线程上恢复协程
+	 */
+	class ConversionAwaitable {
+	public:
+		bool await_ready() const noexcept { return false; }
+
+		bool await_suspend(std::coroutine_handle<> handle) noexcept {
+			const ErrorCode ec = m_owner->ConvertEncodingAsync(std::move(m_input), m_from.c_str(), m_to.c_str(),
+				[this, handle](StringResult result) {
+					m_result = std::move(result);
+					handle.resume();
+				}, m_executor);
+			if (ec != ErrorCode::Success) {
+				// 未提交：回调不会运行，直接恢复
+				m_result = StringResult::Failure(ec);
+				return false;
+			}
+			// 已提交后不得再访问 *this：回调可能已在其他线程恢复协程
+			return true;
+		}
+
+		StringResult await_resume() noexcept { return std::move(m_result); }
+
+	private:
+		friend class UniConv;
+		ConversionAwaitable(UniConv* owner, std::string input, const char* from, const char* to, AsyncExecutor executor)
+			: m_owner(owner), m_input(std::move(input)), m_from(from ? from : ""), m_to(to ? to : ""),
+			  m_executor(std::move(executor)) {}
+
+		UniConv*      m_owner;
+		std::string   m_input;
+		std::string   m_from;
+		std::string   m_to;
+		AsyncExecutor m_executor;
+		StringResult  m_result{ErrorCode::ConversionFailed};
+	};
+
+	/**
+	 * @brief 协程版异步转换
+	 * @code
+	 * StringResult r = co_await conv->AwaitConvertEncoding(std::move(body), "GBK", "UTF-8");
+	 * @endcode
+	 */
+	ConversionAwaitable AwaitConvertEncoding(std::string input, const char* fromEncoding, const char* toEncoding,
+		AsyncExecutor executor = {}) {
+		return ConversionAwaitable(this, std::move(input), fromEncoding, toEncoding, std::move(executor));
+	}
+#endif
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// === Streaming Conversion (Constant Memory) ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief Stateful streaming converter for inputs larger than memory
+	 * @details Owns a single iconv descriptor for its whole lifetime and converts
+	 * input fed in arbitrary chunks into a caller-provided fixed-size buffer.
+	 * Incomplete multibyte sequences at the end of a chunk (iconv EINVAL) are
+	 * carried over internally and completed by the next chunk, so chunk
+	 * boundaries never need to be aligned to character boundaries.
+	 * There is no output size cap: memory usage is constant regardless of input size.
+	 *
+	 * Example:
+	 * @code
+	 * UniConv::StreamConverter stream("GBK", "UTF-8");
+	 * char out[64 * 1024];
+	 * while (read_chunk(chunk)) {
+	 *     std::string_view pending = chunk;
+	 *     while (!pending.empty()) {
+	 *         size_t consumed = 0, written = 0;
+	 *         ErrorCode ec = stream.Convert(pending, out, sizeof(out), consumed, written);
+	 *         sink.write(out, written);
+	 *         pending.remove_prefix(consumed);
+	 *         if (ec != ErrorCode::Success && ec != ErrorCode::BufferTooSmall) return ec;
+	 *     }
+	 * }
+	 * size_t written = 0;
+	 * stream.Finish(out, sizeof(out), written);
+	 * sink.write(out, written);
+	 * @endcode
+	 *
+	 * @note Not thread-safe; use one StreamConverter per stream.
+	 */
+	class UNICONV_EXPORT StreamConverter {
+	public:
+		/// Maximum number of bytes that may be carried across chunk boundaries
+		static constexpr size_t MAX_PENDING_BYTES = 16;
+
+		/**
+		 * @brief Open a stream converter for the given encoding pair
+		 * @param fromEncoding Source encoding name
+		 * @param toEncoding Target encoding name
+		 * @note Check GetStatus() / IsOpen() before use.
+		 */
+		StreamConverter(const char* fromEncoding, const char* toEncoding) noexcept;
+
+		StreamConverter(StreamConverter&&) noexcept = default;
+		StreamConverter& operator=(StreamConverter&&) noexcept = default;
+		StreamConverter(const StreamConverter&) = delete;
+		StreamConverter& operator=(const StreamConverter&) = delete;
+
+		/**
+		 * @brief Whether the underlying descriptor was opened successfully
+		 */
+		[[nodiscard]] bool IsOpen() const noexcept { return m_descriptor != nullptr; }
+
+		/**
+		 * @brief Construction status
+		 * @return Success, InvalidParameter, InvalidSourceEncoding, InvalidTargetEncoding or ConversionFailed
+		 */
+		[[nodiscard]] ErrorCode GetStatus() const noexcept { return m_status; }
+
+		/**
+		 * @brief Convert one chunk of input into a fixed-size output buffer
+		 * @param input Input chunk (may end in the middle of a multibyte sequence)
+		 * @param output Caller-provided output buffer
+		 * @param outputCapacity Size of the output buffer in bytes
+		 * @param[out] consumed Bytes of input consumed (including bytes carried over internally)
+		 * @param[out] written Bytes written to output
+		 * @return Success when the whole chunk was consumed;
+		 *         BufferTooSmall when the output buffer filled up first (call again with the unconsumed rest);
+		 *         InvalidSequence on an invalid multibyte sequence (consumed points at it);
+		 *         InvalidParameter / ConversionFailed on misuse or if the converter is not open
+		 */
+		ErrorCode Convert(std::string_view input, char* output, size_t outputCapacity,
+		                  size_t& consumed, size_t& written) noexcept;
+
+		/**
+		 * @brief Flush the end of the stream
+		 * @param output Caller-provided output buffer
+		 * @param outputCapacity Size of the output buffer in bytes
+		 * @param[out] written Bytes written to output (shift sequences for stateful encodings)
+		 * @return Success; IncompleteSequence if a truncated sequence is still pending;
+		 *         BufferTooSmall if the shift sequence does not fit
+		 */
+		ErrorCode Finish(char* output, size_t outputCapacity, size_t& written) noexcept;
+
+		/**
+		 * @brief Reset shift state, pending bytes and counters so the converter can be reused
+		 */
+		void Reset() noexcept;
+
+		/// Number of bytes currently carried over from the previous chunk
+		[[nodiscard]] size_t GetPendingBytes() const noexcept { return m_pendingSize; }
+		/// Total input bytes consumed since construction / last Reset()
+		[[nodiscard]] uint64_t GetTotalBytesIn() const noexcept { return m_totalIn; }
+		/// Total output bytes produced since construction / last Reset()
+		[[nodiscard]] uint64_t GetTotalBytesOut() const noexcept { return m_totalOut; }
+
+	private:
+		std::unique_ptr<void, IconvDeleter>      m_descriptor;                 /*!< Exclusively owned iconv descriptor */
+		ErrorCode                                m_status;                     /*!< Construction status */
+		std::array<char, MAX_PENDING_BYTES>      m_pending{};                  /*!< Incomplete sequence carried across chunks */
+		size_t                                   m_pendingSize = 0;            /*!< Valid bytes in m_pending */
+		uint64_t                                 m_totalIn = 0;                /*!< Consumed input bytes */
+		uint64_t                                 m_totalOut = 0;               /*!< Produced output bytes */
+	};
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// === File-to-File Conversion (Memory-Mapped) ===
+	//----------------------------------------------------------------------------------------------------------------------
+	/**
+	 * @brief Convert a file into another file without loading it into a std::string
+	 * @param inputPath Source file path (UTF-8 on Windows)
+	 * @param fromEncoding Source encoding name
+	 * @param toEncoding Target encoding name
+	 * @param outputPath Destination file path (created or truncated)
+	 * @return ErrorCode indicating success or failure type
+	 * @details The source is memory-mapped (mmap / MapViewOfFile) and fed to a
+	 * StreamConverter; output is written through a page-aligned 1MB block buffer.
+	 * A leading BOM is detected in place via DetectAndRemoveBom(std::string_view),
+	 * stripped, and takes precedence over fromEncoding. No BOM is written.
+	 * Peak memory is independent of the file size.
+	 * @note On failure the partially written destination file is removed.
+	 * @note Returns InvalidParameter, leaving the file untouched, when outputPath names the
+	 * same file as inputPath (including through a hard link or symlink).
+	 */
+	ErrorCode ConvertFile(const std::string& inputPath, const char* fromEncoding,
+	                      const char* toEncoding, const std::string& outputPath) noexcept;
+
 	//---------------------------------------------------------------------------
 	// Pool Statistics @{
 	//---------------------------------------------------------------------------
 		/**
 		 * @brief Get statistics about the internal buffer pool and iconv cache.
 		 * @return Pool statistics
+		 * @note iconv_cache_* 统计的是全局空闲描述符池（冷路径）：hits 为从池中签出次数，
+		 *       misses 为 iconv_open 次数。线程私有缓存命中不计数，以保持热路径无共享写入。
 		 * @struct PoolStats
 		 */
 		struct PoolStats {
@@ -2470,84 +4174,113 @@ public:
 	//---------------------------------------------------------------------------
 	// @} End of Pool Statistics
 	//---------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------
+	// Conversion Metrics @{
+	//---------------------------------------------------------------------------
+		/**
+		 * @brief Merge the per-thread metrics shards into one snapshot
+		 * @return Per (source, target, path) call counts, byte totals and latency histograms;
+		 *         empty with enabled == false unless built with UNICONV_ENABLE_METRICS=1
+		 * @details Every ConvertEncodingFast / ConvertEncodingStatelessFast / ConvertInto /
+		 *          PreparedConversion call is recorded, as is each value of the batch APIs, each
+		 *          chunk of ConvertEncodingParallel and each window of ConversionPipeline.
+		 *          StreamConverter sessions are not recorded. The calling thread writes into its
+		 *          own shard, so the hot path takes no lock once a series exists. Shards of exited
+		 *          threads are folded into a retired total and keep contributing.
+		 * @note Series are keyed by the encoding names as passed ("utf-8" and "UTF-8" are distinct).
+		 */
+		static ConversionMetrics GetConversionMetrics();
+
+		/**
+		 * @brief Zero all counters; series stay registered
+		 * @note Increments that race with the reset may land on either side of it.
+		 */
+		static void ResetConversionMetrics() noexcept;
+	//---------------------------------------------------------------------------
+	// @} End of Conversion Metrics
+	//---------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------
+	// Conversion Tracing @{
+	//---------------------------------------------------------------------------
+		/**
+		 * @brief Install (or with nullptr remove) process-wide tracing hooks
+		 * @param hooks Caller-owned callbacks; must stay valid until replaced and every span begun
+		 *              with them has ended
+		 * @details Emits begin / end pairs for single conversion calls, for
+		 *          ConvertEncodingBatchParallel as a whole, per worker thread and per chunk, for
+		 *          iconv_open() of cold descriptors and for StringBufferPool fallback allocations;
+		 *          the gap between a batch span and its worker spans is thread pool queueing. Without hooks every site costs one
+		 *          relaxed atomic load and a predicted branch. A span always ends on the hooks it
+		 *          began with, even if they are replaced in between.
+		 * @code
+		 * static TraceHooks hooks{nullptr,
+		 *     [](void*, const TraceSpan& s) { TRACE_EVENT_BEGIN("uniconv", perfetto::StaticString(TraceSpan::KindName(s.kind))); },
+		 *     [](void*, const TraceSpan&)   { TRACE_EVENT_END("uniconv"); }};
+		 * UniConv::SetTraceHooks(&hooks);
+		 * @endcode
+		 */
+		static void SetTraceHooks(const TraceHooks* hooks) noexcept;
+
+		/// Currently installed hooks, nullptr when tracing is off
+		[[nodiscard]] static const TraceHooks* GetTraceHooks() noexcept;
+	//---------------------------------------------------------------------------
+	// @} End of Conversion Tracing
+	//---------------------------------------------------------------------------
 private:
 
 	//----------------------------------------------------------------------------------------------------------------------
 	// Private members @{
 	//----------------------------------------------------------------------------------------------------------------------
-	static const std::unordered_map<std::uint16_t,EncodingInfo>  m_encodingMap;                /*!< Encoding map           */
-	static const std::unordered_map<std::string,std::uint16_t>   m_encodingToCodePageMap;      /*!< Iconv code page map    */
+	static constexpr size_t                                      MAX_CACHE_SIZE = 128;         /*!< Idle descriptor pool capacity */
 
-	// Concurrent LRU-like cache for iconv descriptors using parallel-hashmap
-	struct IconvCacheEntry {
-		IconvSharedPtr                         descriptor;
-		mutable std::atomic<uint64_t>  last_used{0};     // 最后使用时间戳
-		mutable std::atomic<uint32_t>  hit_count{0};     // 命中次数
+	/**
+	 * @brief Shared pool of idle iconv descriptors (cold path only)
+	 * @details Visited only when a thread-local cache misses or pushes a descriptor out.
+	 * Keys are spread over SHARD_COUNT independently locked shards of SHARD_SLOTS slots.
+	 * Checkout empties the matching slot; a full shard evicts the slot under its rotating
+	 * hand (FIFO order) - O(1), no scan over other shards, no timestamps. Several idle
+	 * descriptors for the same pair may coexist so that threads churning on one pair
+	 * keep reusing them.
+	 */
+	struct IdleDescriptorPool {
+		static constexpr size_t SHARD_COUNT = 16;
+		static constexpr size_t SHARD_SLOTS = MAX_CACHE_SIZE / SHARD_COUNT;
+
+		struct Shard {
+			std::mutex mutex;
+			uint64_t   keys[SHARD_SLOTS] = {};
+			void*      handles[SHARD_SLOTS] = {};  // nullptr = empty slot
+			size_t     hand = 0;
+		};
 
-		IconvCacheEntry() = default;
+		/// Take an idle descriptor for key (exclusive ownership), or nullptr
+		void* Take(uint64_t key) noexcept;
 
-		IconvCacheEntry(IconvSharedPtr desc) : descriptor(std::move(desc)) {
-			last_used.store(GetCurrentTimestamp(), std::memory_order_relaxed);
-		}
+		/// Park a descriptor; returns the descriptor the caller must close (evicted one), or nullptr
+		void* Put(uint64_t key, void* handle) noexcept;
 
-		// 复制构造函数
-		IconvCacheEntry(const IconvCacheEntry& other) : descriptor(other.descriptor) {
-			last_used.store(other.last_used.load(), std::memory_order_relaxed);
-			hit_count.store(other.hit_count.load(), std::memory_order_relaxed);
-		}
+		/// Close every idle descriptor
+		void Clear() noexcept;
 
-		// 移动构造函数
-		IconvCacheEntry(IconvCacheEntry&& other) noexcept : descriptor(std::move(other.descriptor)) {
-			last_used.store(other.last_used.load(), std::memory_order_relaxed);
-			hit_count.store(other.hit_count.load(), std::memory_order_relaxed);
-		}
+		/// Number of idle descriptors (locks each shard in turn)
+		size_t Size() const noexcept;
 
-		// 复制赋值运算符
-		IconvCacheEntry& operator=(const IconvCacheEntry& other) {
-			if (this != &other) {
-				descriptor = other.descriptor;
-				last_used.store(other.last_used.load(), std::memory_order_relaxed);
-				hit_count.store(other.hit_count.load(), std::memory_order_relaxed);
-			}
-			return *this;
-		}
+		~IdleDescriptorPool() { Clear(); }
 
-		// 移动赋值运算符
-		IconvCacheEntry& operator=(IconvCacheEntry&& other) noexcept {
-			if (this != &other) {
-				descriptor = std::move(other.descriptor);
-				last_used.store(other.last_used.load(), std::memory_order_relaxed);
-				hit_count.store(other.hit_count.load(), std::memory_order_relaxed);
-			}
-			return *this;
-		}
-
-		static uint64_t GetCurrentTimestamp() noexcept {
-			return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+	private:
+		Shard& ShardFor(uint64_t key) noexcept {
+			return shards_[static_cast<size_t>((key ^ (key >> 32)) % SHARD_COUNT)];
 		}
 
-		void UpdateAccess() const noexcept {
-			last_used.store(GetCurrentTimestamp(), std::memory_order_relaxed);
-			hit_count.fetch_add(1, std::memory_order_relaxed);
-		}
+		mutable Shard shards_[SHARD_COUNT];
 	};
 
-	// Concurrent parallel hash map for iconv descriptor cache (thread-safe sharded locking)
-	// Using uint64_t keys (pre-computed hash) instead of std::string for:
-	// - No string allocation/copy on each lookup
-	// - Faster hash computation (identity hash)
-	// - Reduced memory usage per entry
-	mutable phmap::parallel_flat_hash_map<uint64_t, IconvCacheEntry,
-		phmap::priv::hash_default_hash<uint64_t>,
-		phmap::priv::hash_default_eq<uint64_t>,
-		phmap::priv::Allocator<phmap::priv::Pair<const uint64_t, IconvCacheEntry>>,
-		4,  // 4-way parallel (16 submaps for better concurrency)
-		std::mutex> m_iconvDescriptorCacheMap;    /*!< Concurrent iconv descriptor cache with LRU */
-	static constexpr size_t                                      MAX_CACHE_SIZE = 128;         /*!< Increased cache size for better hit rate */
+	mutable IdleDescriptorPool                                   m_idleDescriptors;            /*!< Sharded idle iconv descriptor pool */
 	mutable std::atomic<uint64_t>                                m_cacheHitCount{0};           /*!< Cache hit statistics */
 	mutable std::atomic<uint64_t>                                m_cacheMissCount{0};          /*!< Cache miss statistics */
 	mutable std::atomic<uint64_t>                                m_cacheEvictionCount{0};      /*!< Cache eviction statistics */
-	static const  std::string                                    m_encodingNames[];            /*!< Encoding map           */
 	static std::string                                           m_defaultEncoding;            /*!< Current encoding       */
 	// 高性能字符串缓冲池
 	mutable StringBufferPool                                     m_stringBufferPool;           /*!< String buffer pool for fast conversions */
@@ -2583,9 +4316,106 @@ private:
 	 * @param from_encoding 源编码
 	 * @param to_encoding 目标编码
 	 * @return 估算的输出大小
+	 * @note 只按编码对的膨胀系数估算，不读输入；需要精确长度时用 CountOutputUnits()（多扫描一遍输入）
 	 */
 	static size_t EstimateOutputSize(size_t input_size, const char* from_encoding, const char* to_encoding) noexcept;
 	static size_t EstimateOutputSizeById(size_t input_size, uint8_t from_id, uint8_t to_id) noexcept;
+	static size_t MaxOutputSizeById(size_t input_size, uint8_t from_id, uint8_t to_id) noexcept;
+
+	/**
+	 * @brief 解析编码对的转换路线（名称须已通过 IsValidEncodingName）
+	 */
+	static PairPlan MakePairPlan(const char* fromEncoding, const char* toEncoding) noexcept;
+
+	/**
+	 * @brief 按句柄查表得到转换路线（句柄须有效）：路线按编码对首次使用时计算并记入表中
+	 */
+	static PairPlan MakePairPlan(EncodingHandle fromEncoding, EncodingHandle toEncoding) noexcept;
+
+	/**
+	 * @brief 已校验并解析的编码对（名称与句柄两套接口共用后续实现）
+	 */
+	struct ResolvedPair {
+		ErrorCode   status = ErrorCode::InvalidParameter;  /*!< 名称/句柄校验结果 */
+		PairPlan    plan;                                  /*!< status == Success 时有效 */
+		const char* from = nullptr;                        /*!< iconv_open 使用的源编码名 */
+		const char* to = nullptr;                          /*!< iconv_open 使用的目标编码名 */
+	};
+	static ResolvedPair ResolvePair(const char* fromEncoding, const char* toEncoding) noexcept;
+	static ResolvedPair ResolvePair(EncodingHandle fromEncoding, EncodingHandle toEncoding) noexcept;
+
+	/**
+	 * @brief 无共享缓存的转换（每次 iconv_open），ConvertEncodingStatelessFast 两套接口共用
+	 */
+	ErrorCode ConvertStatelessPlanned(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+	                                  std::string_view input, std::string& output) noexcept;
+	ErrorCode ConvertStatelessRoute(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+	                                std::string_view input, std::string& output, ConversionPath& path) noexcept;
+
+	/**
+	 * @brief 按已解析的路线转换（ConvertEncodingFast / PreparedConversion 共用）
+	 */
+	template <typename ByteString>
+	ErrorCode ConvertPlanned(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+	                         std::string_view input, ByteString& output) noexcept;
+
+	/**
+	 * @brief ConvertPlanned 的路线实现；path 返回实际走过的路径（供指标记录）
+	 */
+	template <typename ByteString>
+	ErrorCode ConvertPlannedRoute(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+	                              std::string_view input, ByteString& output, ConversionPath& path) noexcept;
+
+	/**
+	 * @brief 连续存储批量转换实现（std 与 pmr 容器共用）
+	 */
+	template <typename ByteString, typename OffsetVector>
+	ErrorCode ConvertPackedBatch(std::string_view data, const size_t* offsets, size_t count,
+	                             const ResolvedPair& pair,
+	                             ByteString& outData, OffsetVector& outOffsets,
+	                             std::vector<ErrorCode>* itemErrors,
+	                             NormalizationForm form = NormalizationForm::None) noexcept;
+
+	/**
+	 * @brief 融合流水线的一次运行参数（ConversionPipeline 与带正规化选项的转换接口共用）
+	 */
+	struct PipelineConfig {
+		const char*       from = nullptr;                               /*!< 声明的源编码（可为空） */
+		const char*       to = nullptr;                                 /*!< 目标编码 */
+		uint8_t           stages = 0;                                   /*!< ConversionPipeline::STAGE_* */
+		size_t            blockSize = ConversionPipeline::DEFAULT_BLOCK_SIZE; /*!< 窗口字节数 */
+		NormalizationForm normalization = NormalizationForm::None;      /*!< 正规化阶段 */
+	};
+
+	/**
+	 * @brief 按窗口执行 BOM 剥离 → 检测 → 转换 → 换行 / NUL → 正规化（见 ConversionPipeline）
+	 */
+	ErrorCode RunPipeline(const PipelineConfig& config, std::string_view input, std::string& output,
+	                      const char** sourceEncoding) noexcept;
+
+	/**
+	 * @brief 按已解析的路线转换到调用方缓冲区（ConvertInto / PreparedConversion 共用）
+	 */
+	ErrorCode ConvertPlannedInto(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+	                             std::string_view input, char* output, size_t outputCapacity,
+	                             size_t& consumed, size_t& written) noexcept;
+	ErrorCode ConvertPlannedIntoRoute(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+	                                  std::string_view input, char* output, size_t outputCapacity,
+	                                  size_t& consumed, size_t& written, ConversionPath& path) noexcept;
+
+	/**
+	 * @brief 容错转换：逐段调用 ConvertPlannedInto，坏序列处写入替换字符（或跳过）后从其后续接
+	 */
+	ErrorCode ConvertPlannedTolerant(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+	                                 std::string_view input, std::string& output, ErrorPolicy policy,
+	                                 ConversionReport* report) noexcept;
+
+	/**
+	 * @brief 按已解析的路线计算输出码元数（CountOutputUnits / Validate / PreparedConversion 共用）
+	 * @param[out] consumed 失败时为出错序列的起始字节
+	 */
+	ErrorCode CountPlannedUnits(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+	                            std::string_view input, size_t& units, size_t& consumed) noexcept;
 
 	/**
 	 * @brief 快速检查编码名称是否有效
@@ -2608,18 +4438,31 @@ private:
 	 * @param toEncoding 目标编码
 	 * @param buffer_lease 缓冲区租用器
 	 * @param estimated_size 预估大小
+	 * @param ascii_prefix 已确认为 ASCII 的前导字节数（直接复制，不经过 iconv）
 	 * @return 转换结果
 	 */
-	UNICONV_HOT UNICONV_FLATTEN StringResult ConvertEncodingInternal(const std::string& input,const char* fromEncoding,const char* toEncoding,StringBufferPool::BufferLease& buffer_lease,size_t estimated_size) noexcept;
+	UNICONV_HOT UNICONV_FLATTEN StringResult ConvertEncodingInternal(const std::string& input,const char* fromEncoding,const char* toEncoding,StringBufferPool::BufferLease& buffer_lease,size_t estimated_size,size_t ascii_prefix) noexcept;
 
 	/**
-	 * @brief Get the iconv descriptor.
+	 * @brief Get the iconv descriptor owned by the calling thread.
 	 * @param fromcode The source encoding.
 	 * @param tocode The target encoding.
-	 * @return The iconv descriptor as an IconvSharedPtr.
+	 * @return The iconv descriptor lent by the calling thread's cache (empty lease on failure).
+	 * @details 热路径只访问线程私有缓存：命中时只置 CLOCK 引用位并钉住槽位，无原子操作、无时钟读取；
+	 *          未命中时从全局空闲池签出（所有权转移）或新建。
+	 *          iconv_t 带有移位状态，同一描述符不会被两个线程同时持有。
+	 */
+	UNICONV_HOT IconvLease                    GetIconvDescriptor(const char* fromcode, const char* tocode);
+	/**
+	 * @brief GetIconvDescriptor() with a precomputed MakeEncodingPairKey() key
+	 */
+	UNICONV_HOT IconvLease                    GetIconvDescriptorByKey(uint64_t key, const char* fromcode, const char* tocode);
+	/**
+	 * @brief Return a descriptor evicted from a thread-local cache to the shared idle pool.
+	 * @param key Encoding pair key from MakeEncodingPairKey()
+	 * @param descriptor Descriptor no longer used by its thread (ownership transferred)
 	 */
-	UNICONV_HOT IconvSharedPtr                GetIconvDescriptor(const char* fromcode, const char* tocode);
-	void                                      EvictLRUCacheEntries();
+	void                                      ReleaseIconvDescriptor(uint64_t key, void* descriptor) noexcept;
 	void                                      CleanupIconvCache();
 
 	std::pair<BomEncoding, std::string_view>  DetectAndRemoveBom(const std::string_view& data);
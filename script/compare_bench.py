@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+比较两次 UniConvBench 的 JSON 输出，发现性能回退
+
+    ./bin/UniConvBench --benchmark_out=base.json --benchmark_out_format=json
+    ./bin/UniConvBench --benchmark_out=head.json --benchmark_out_format=json
+    python script/compare_bench.py base.json head.json                 # 默认阈值 10%
+    python script/compare_bench.py base.json head.json --threshold 5 --filter 'BM_Scaling_.*'
+
+比较的指标：
+    real_time                      越低越好（统一换算为纳秒）
+    bytes_per_second / items_per_second  越高越好
+    *_ns 计数器（p50_ns / p99_ns / p999_ns / warm_ns 等）  越低越好
+
+使用 --benchmark_repetitions 时只比较 median 聚合行。任一指标变差超过阈值时退出码为 1，
+可直接用于 CI：例如 T16 吞吐量塌缩会表现为 BM_Scaling_Path/.../threads:16 的 bytes_per_second 大幅下降。
+"""
+
+import argparse
+import json
+import re
+import sys
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+HIGHER_IS_BETTER = ("bytes_per_second", "items_per_second")
+# 不参与比较的计数器（开销基线、数据量统计）
+IGNORED_COUNTERS = ("clock_ns",)
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    runs = data.get("benchmarks", [])
+    has_median = any(r.get("aggregate_name") == "median" for r in runs)
+    results = {}
+    for run in runs:
+        if run.get("error_occurred") or run.get("skipped"):
+            continue
+        if has_median:
+            if run.get("aggregate_name") != "median":
+                continue
+            name = run.get("run_name", run["name"])
+        else:
+            if run.get("run_type", "iteration") != "iteration":
+                continue
+            name = run["name"]
+        results[name] = run
+    return data.get("context", {}), results
+
+
+def metrics(run):
+    """返回 {指标名: (数值, 是否越高越好)}"""
+    out = {"real_time": (run["real_time"] * TIME_UNITS.get(run.get("time_unit", "ns"), 1.0), False)}
+    for key in HIGHER_IS_BETTER:
+        if key in run:
+            out[key] = (run[key], True)
+    for key, value in run.items():
+        if key.endswith("_ns") and key not in IGNORED_COUNTERS and isinstance(value, (int, float)):
+            out[key] = (value, False)
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="比较两次 UniConvBench JSON 输出")
+    parser.add_argument("baseline", help="基线 JSON（旧版本）")
+    parser.add_argument("contender", help="对比 JSON（新版本）")
+    parser.add_argument("--threshold", type=float, default=10.0, help="回退阈值（百分比，默认 10）")
+    parser.add_argument("--filter", default=None, help="只比较名称匹配该正则的基准")
+    parser.add_argument("--all", action="store_true", help="列出所有指标，而不只是超过阈值的变化")
+    args = parser.parse_args()
+
+    base_context, base = load(args.baseline)
+    head_context, head = load(args.contender)
+    for key in sorted(set(base_context) | set(head_context)):
+        if key.startswith("uniconv_") or key in ("num_cpus", "library_build_type"):
+            print(f"{key}: {base_context.get(key, '-')} -> {head_context.get(key, '-')}")
+
+    pattern = re.compile(args.filter) if args.filter else None
+    regressions = []
+    improvements = 0
+    compared = 0
+    for name in sorted(set(base) & set(head)):
+        if pattern and not pattern.search(name):
+            continue
+        head_metrics = metrics(head[name])
+        for metric, (old, higher_is_better) in metrics(base[name]).items():
+            if metric not in head_metrics or old == 0:
+                continue
+            new = head_metrics[metric][0]
+            change = (new - old) / old * 100.0
+            worse = -change if higher_is_better else change
+            compared += 1
+            if worse > args.threshold:
+                regressions.append((name, metric, old, new, change))
+            elif worse < -args.threshold:
+                improvements += 1
+            if args.all or abs(worse) > args.threshold:
+                flag = "REGRESSION" if worse > args.threshold else ("improved" if worse < -args.threshold else "")
+                print(f"{name:<72} {metric:<18} {old:>14.4g} -> {new:<14.4g} {change:+7.1f}% {flag}")
+
+    missing = sorted(set(base) - set(head))
+    if missing:
+        print(f"\n{len(missing)} 个基准只在基线中出现（已跳过），例如 {missing[0]}")
+    print(f"\n比较 {compared} 项指标：{len(regressions)} 项回退，{improvements} 项改进（阈值 {args.threshold:g}%）")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -2,9 +2,28 @@
 # -*- coding: utf-8 -*-
 """
 生成 UniConv 测试所需的各种编码格式文件（含/不含 BOM）
+
+    python script/generate_test_files.py                  # testdata/ 下的小样例文件
+    python script/generate_test_files.py --bench-corpus   # 另外生成 testdata/bench/ 基准语料
+    python script/generate_test_files.py --bench-corpus --huge-mb 512
+
+基准语料（UniConvBench 的 BM_Corpus_* 读取，目录可由环境变量 UNICONV_BENCH_CORPUS 覆盖）：
+    mixed_cjk_log.txt           UTF-8 应用日志：时间戳 / 级别 / 模块为 ASCII，消息混合中日韩文本
+    mixed_cjk_log_gb18030.txt   同一日志的 GB18030 版本
+    dirty_data.txt              UTF-8 抓取数据：约每 4KB 一处坏序列（非法字节、截断序列、代理项），混有 CRLF 与 NUL
+    huge_single_utf16le.txt     单个超大 UTF-16LE 文件（带 BOM），默认 256MB
 """
 
+import argparse
 import os
+import random
+
+parser = argparse.ArgumentParser(description="生成 UniConv 测试 / 基准数据")
+parser.add_argument("--bench-corpus", action="store_true", help="生成 testdata/bench/ 下的基准语料")
+parser.add_argument("--huge-mb", type=int, default=256, help="超大单文件的大小（MB，默认 256）")
+parser.add_argument("--log-mb", type=int, default=16, help="混合日志的大小（MB，默认 16）")
+parser.add_argument("--seed", type=int, default=20260301, help="随机种子（固定种子保证各版本对比同一份语料）")
+args = parser.parse_args()
 
 os.makedirs("testdata", exist_ok=True)
 os.makedirs("testdata/output", exist_ok=True)
@@ -44,4 +63,97 @@ for fname, encoding, bom in encodings:
             data = f.read()
         print(f"  {fname}: {len(data)} 字节，前12字节: {' '.join(f'{b:02x}' for b in data[:12])}")
     else:
-        print(f"  {fname}: ❌ 文件不存在")
\ No newline at end of file
+        print(f"  {fname}: ❌ 文件不存在")
+
+# ----------------------------------------------------------------------------
+# 基准语料
+# ----------------------------------------------------------------------------
+
+LEVELS = ["INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR"]
+MODULES = ["gateway", "order-service", "payment", "search", "user-profile", "push"]
+MESSAGES = [
+    "订单 #{n} 已发货，物流单号 SF{n:010d}",
+    "用户 {n} 登录成功，来源 IP 10.{a}.{b}.{c}",
+    "支付回调超时，重试第 {a} 次（商户号 {n}）",
+    "検索クエリ「東京 ラーメン」の結果 {a} 件を返却しました",
+    "ユーザー {n} のセッションが期限切れになりました",
+    "주문 {n} 처리 완료, 배송 예정일 {a}월 {b}일",
+    "결제 승인 실패: 잔액 부족 (계좌 {n})",
+    "cache miss for key user:{n}:profile, loading from db",
+    "request /api/v2/orders/{n} completed in {a}ms",
+    "推送消息 \"您的包裹已到达驿站，请凭取件码 {a}-{b}-{c} 领取\"",
+]
+
+
+def log_line(rng, n):
+    message = rng.choice(MESSAGES).format(n=n, a=rng.randint(1, 255), b=rng.randint(1, 28), c=rng.randint(1, 255))
+    return "2026-03-01T{:02d}:{:02d}:{:02d}.{:03d}Z [{}] {}: {}\n".format(
+        (n // 3600000) % 24, (n // 60000) % 60, (n // 1000) % 60, n % 1000,
+        rng.choice(LEVELS), rng.choice(MODULES), message)
+
+
+def generate_log(rng, target_bytes):
+    lines = []
+    size = 0
+    n = 0
+    while size < target_bytes:
+        line = log_line(rng, n)
+        lines.append(line)
+        size += len(line.encode("utf-8"))
+        n += 1
+    return "".join(lines)
+
+
+# 坏序列：非法起始字节、截断的多字节序列、编码后的代理项、超长编码
+BAD_SEQUENCES = [b"\xFF", b"\xC3", b"\xE4\xB8", b"\xED\xA0\x80", b"\xC0\xAF", b"\xF0\x9F\x98"]
+
+
+def generate_dirty(rng, clean_utf8, stride):
+    out = bytearray()
+    pos = 0
+    while pos < len(clean_utf8):
+        end = min(len(clean_utf8), pos + rng.randint(stride // 2, stride * 3 // 2))
+        # 只在字符边界插入，不破坏周围的合法字符
+        while end < len(clean_utf8) and (clean_utf8[end] & 0xC0) == 0x80:
+            end += 1
+        chunk = clean_utf8[pos:end]
+        if rng.random() < 0.3:
+            chunk = chunk.replace(b"\n", b"\r\n")
+        out += chunk
+        if end < len(clean_utf8):
+            out += rng.choice(BAD_SEQUENCES) if rng.random() < 0.9 else b"\x00"
+        pos = end
+    return bytes(out)
+
+
+def write_bytes(path, data):
+    with open(path, "wb") as f:
+        f.write(data)
+    print(f"生成 {path}: {len(data) / 1048576:.1f} MB")
+
+
+if args.bench_corpus:
+    os.makedirs("testdata/bench", exist_ok=True)
+    rng = random.Random(args.seed)
+    print("\n📦 生成基准语料 (testdata/bench):")
+
+    log = generate_log(rng, args.log_mb * 1048576)
+    log_utf8 = log.encode("utf-8")
+    write_bytes("testdata/bench/mixed_cjk_log.txt", log_utf8)
+    write_bytes("testdata/bench/mixed_cjk_log_gb18030.txt", log.encode("gb18030"))
+
+    write_bytes("testdata/bench/dirty_data.txt", generate_dirty(rng, log_utf8[: 8 * 1048576], 4096))
+
+    # 超大单文件：重复日志块直到目标大小，逐块写出，不在内存中拼出整个文件
+    block = log[: 4 * 1048576].encode("utf-16le")
+    block = block[: len(block) - len(block) % 2]
+    target = args.huge_mb * 1048576
+    written = 2
+    with open("testdata/bench/huge_single_utf16le.txt", "wb") as f:
+        f.write(b"\xFF\xFE")
+        while written < target:
+            piece = block[: min(len(block), target - written)]
+            f.write(piece)
+            written += len(piece)
+    print(f"生成 testdata/bench/huge_single_utf16le.txt: {written / 1048576:.1f} MB")
+    print("✅ 基准语料已生成！")
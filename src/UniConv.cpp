@@ -42,6 +42,19 @@
 
 #include <UniConv/UniConv.h>
 
+// 文件映射（ConvertFile）
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+#include <cstdio>
+#include <limits>
+#include <new>
+
 //==============================================================================
 // iconv 兼容性包装：处理不同平台的 const 签名差异
 // libiconv-native 使用 char**，而 POSIX/glibc 使用 const char**
@@ -61,6 +74,32 @@ inline size_t portable_iconv(iconv_t cd, const char** inbuf, size_t* inbytesleft
     #include <simdutf.h>
 #endif
 
+//==============================================================================
+// 内置 SIMD 内核（未链接 simdutf 时的 UTF 快速路径，运行时按 CpuOptimizationInfo 分派）
+//==============================================================================
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define UNICONV_NATIVE_SIMD_X86 1
+    #include <immintrin.h>
+    #if UNICONV_ENABLE_METRICS
+        #if defined(_MSC_VER)
+            #include <intrin.h>     // __rdtsc / __cpuid（指标计时）
+        #else
+            #include <x86intrin.h>  // __rdtsc（指标计时）
+            #include <cpuid.h>      // __get_cpuid
+        #endif
+    #endif
+    #if defined(__GNUC__) || defined(__clang__)
+        #define UNICONV_TARGET_SSE2 __attribute__((target("sse2")))
+        #define UNICONV_TARGET_AVX2 __attribute__((target("avx2")))
+    #else
+        #define UNICONV_TARGET_SSE2
+        #define UNICONV_TARGET_AVX2
+    #endif
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && !defined(__ARM_BIG_ENDIAN)
+    #define UNICONV_NATIVE_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
 namespace {
 
 /**
@@ -199,45 +238,113 @@ inline bool IsAsciiCompatibleEncoding(const char* encoding) noexcept {
     return false;
 }
 
+//==============================================================================
+// ASCII 前缀预扫描（所有转换路径共用，SSE2/AVX2/NEON 运行时分派）
+//==============================================================================
+// 向量内核只定位首个含高位字节的块，块内位置由标量循环确定（最多一个块）。
+// ASCII 兼容编码中首字节均 >= 0x80，因此前导 ASCII 段总是完整字符序列，
+// 调用方可直接复制该前缀，只把其后的部分交给 iconv 等慢路径。
+
+/**
+ * @brief 块扫描内核签名
+ * @return 首个含非 ASCII 字节的块的起始偏移（全部为 ASCII 时为已扫描的整块长度）
+ */
+using AsciiScanKernel = size_t (*)(const uint8_t* data, size_t len) noexcept;
+
+size_t AsciiScan_Scalar(const uint8_t* data, size_t len) noexcept {
+    size_t i = 0;
+    // string_view 可能未对齐，用 memcpy 读取（编译为单条加载指令）
+    for (; i + 8 <= len; i += 8) {
+        uint64_t block;
+        std::memcpy(&block, data + i, 8);
+        // 0x8080808080808080 是每个字节最高位的掩码
+        if (block & 0x8080808080808080ULL) break;
+    }
+    return i;
+}
+
+#if UNICONV_NATIVE_SIMD_X86
+
+UNICONV_TARGET_SSE2 size_t AsciiScan_SSE2(const uint8_t* data, size_t len) noexcept {
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 48));
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0) break;
+    }
+    for (; i + 16 <= len; i += 16) {
+        if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))) != 0) break;
+    }
+    return i;
+}
+
+UNICONV_TARGET_AVX2 size_t AsciiScan_AVX2(const uint8_t* data, size_t len) noexcept {
+    size_t i = 0;
+    for (; i + 128 <= len; i += 128) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 64));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 96));
+        if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d))) != 0) break;
+    }
+    for (; i + 32 <= len; i += 32) {
+        if (_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))) != 0) break;
+    }
+    return i;
+}
+
+#elif UNICONV_NATIVE_SIMD_NEON
+
+size_t AsciiScan_NEON(const uint8_t* data, size_t len) noexcept {
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        const uint8x16_t a = vld1q_u8(data + i);
+        const uint8x16_t b = vld1q_u8(data + i + 16);
+        const uint8x16_t c = vld1q_u8(data + i + 32);
+        const uint8x16_t d = vld1q_u8(data + i + 48);
+        if (vmaxvq_u8(vorrq_u8(vorrq_u8(a, b), vorrq_u8(c, d))) >= 0x80) break;
+    }
+    for (; i + 16 <= len; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(data + i)) >= 0x80) break;
+    }
+    return i;
+}
+
+#endif // UNICONV_NATIVE_SIMD_X86 / UNICONV_NATIVE_SIMD_NEON
+
+AsciiScanKernel SelectAsciiScanKernel() noexcept {
+    const CpuOptimizationInfo& cpu = CpuOptimization::GetInfo();
+    (void)cpu;
+#if UNICONV_NATIVE_SIMD_X86
+    if (cpu.has_avx2) return AsciiScan_AVX2;
+    if (cpu.has_sse2) return AsciiScan_SSE2;
+#elif UNICONV_NATIVE_SIMD_NEON
+    if (cpu.has_neon) return AsciiScan_NEON;
+#endif
+    return AsciiScan_Scalar;
+}
+
 /**
- * @brief 快速检查字符串是否全是 ASCII 字符（所有字节 < 0x80）
- * @param input 输入字符串
- * @return 如果所有字节都是 ASCII（0x00-0x7F）则返回 true
- * @note 使用位运算优化，一次检查 8 个字节
+ * @brief 返回输入开头连续 ASCII 字节（< 0x80）的长度
+ * @param input 输入数据
+ * @return 前导 ASCII 段长度；等于 input.size() 表示全部为 ASCII
+ * @note 短输入（< 32 字节）直接走标量循环，避免函数指针调用开销
  */
-inline bool IsAllAscii(const std::string& input) noexcept {
+inline size_t AsciiPrefixLength(std::string_view input) noexcept {
+    const auto* data = reinterpret_cast<const uint8_t*>(input.data());
     const size_t len = input.size();
-    const unsigned char* data = reinterpret_cast<const unsigned char*>(input.data());
-    
-    // 空字符串视为 ASCII
-    if (len == 0) return true;
-    
     size_t i = 0;
-    
-    // 使用 64 位批量检查（每次检查 8 字节）
-    // 如果任何字节的最高位为 1，则 OR 结果的对应位也为 1
-    if (len >= 8) {
-        const uint64_t* ptr64 = reinterpret_cast<const uint64_t*>(data);
-        const size_t count64 = len / 8;
-        
-        for (size_t j = 0; j < count64; ++j) {
-            // 检查是否有任何字节 >= 0x80
-            // 0x8080808080808080 是每个字节最高位的掩码
-            if (ptr64[j] & 0x8080808080808080ULL) {
-                return false;
-            }
-        }
-        i = count64 * 8;
+    if (len >= 32) {
+        static const AsciiScanKernel kernel = SelectAsciiScanKernel();
+        i = kernel(data, len);
     }
-    
-    // 处理剩余字节
-    for (; i < len; ++i) {
-        if (data[i] >= 0x80) {
-            return false;
-        }
+    i += AsciiScan_Scalar(data + i, len - i);
+    while (i < len && data[i] < 0x80) {
+        ++i;
     }
-    
-    return true;
+    return i;
 }
 
 //==============================================================================
@@ -259,10 +366,16 @@ enum class EncodingId : uint8_t {
     GB18030,
     BIG5,
     ShiftJIS,
-    ISO8859_1,
-    Windows1252,
     EUC_JP,
-    EUC_KR
+    EUC_KR,
+
+    // 单字节码页（内置码表，见 sbcs_tables.inc；ISO8859_1 为区间起点）
+#define UNICONV_SBCS(id, ...) id,
+#define UNICONV_SBCS_NAME(id, name)
+#include "sbcs_tables.inc"
+#undef UNICONV_SBCS_NAME
+#undef UNICONV_SBCS
+    SbcsEnd  ///< 单字节码页区间结束标记（不是编码）
 };
 
 inline EncodingId GetEncodingId(const char* encoding) noexcept {
@@ -306,6 +419,8 @@ inline EncodingId GetEncodingId(const char* encoding) noexcept {
         case detail::fnv1a_hash("GBK", 3):
             return EncodingId::GBK;
         case detail::fnv1a_hash("GB2312", 6):
+        case detail::fnv1a_hash("EUC-CN", 6):
+        case detail::fnv1a_hash("EUCCN", 5):
             return EncodingId::GB2312;
         case detail::fnv1a_hash("GB18030", 7):
             return EncodingId::GB18030;
@@ -328,6 +443,11 @@ inline EncodingId GetEncodingId(const char* encoding) noexcept {
         case detail::fnv1a_hash("EUC-KR", 6):
         case detail::fnv1a_hash("EUCKR", 5):
             return EncodingId::EUC_KR;
+#define UNICONV_SBCS(id, ...)
+#define UNICONV_SBCS_NAME(id, name) case detail::fnv1a_hash(name, sizeof(name) - 1): return EncodingId::id;
+#include "sbcs_tables.inc"
+#undef UNICONV_SBCS_NAME
+#undef UNICONV_SBCS
         default:
             if (strstr(normalized, "UTF-8") || strstr(normalized, "UTF8")) return EncodingId::UTF8;
             if (strstr(normalized, "UTF-16LE") || strstr(normalized, "UTF16LE")) return EncodingId::UTF16LE;
@@ -343,7 +463,17 @@ inline EncodingId GetEncodingId(const char* encoding) noexcept {
     }
 }
 
+/**
+ * @brief 是否为内置码表的单字节码页（0x00-0x7F 均与 ASCII 相同）
+ */
+constexpr bool IsSbcsId(EncodingId id) noexcept {
+    return id >= EncodingId::ISO8859_1 && id < EncodingId::SbcsEnd;
+}
+
 inline bool IsAsciiCompatibleById(EncodingId id) noexcept {
+    if (IsSbcsId(id)) {
+        return true;
+    }
     switch (id) {
         case EncodingId::UTF8:
         case EncodingId::ASCII:
@@ -352,8 +482,6 @@ inline bool IsAsciiCompatibleById(EncodingId id) noexcept {
         case EncodingId::GB18030:
         case EncodingId::BIG5:
         case EncodingId::ShiftJIS:
-        case EncodingId::ISO8859_1:
-        case EncodingId::Windows1252:
         case EncodingId::EUC_JP:
         case EncodingId::EUC_KR:
             return true;
@@ -362,6 +490,15 @@ inline bool IsAsciiCompatibleById(EncodingId id) noexcept {
     }
 }
 
+/**
+ * @brief from -> to 时 ASCII 字节能否原样透传
+ * @note Shift_JIS 的 0x5C / 0x7E 是 JIS-Roman 的 ¥ / ‾（与 iconv 一致），作为源编码时不能透传；
+ *       作为目标编码时 U+005C / U+007E 仍编码为 0x5C / 0x7E，不受影响
+ */
+inline bool IsAsciiPassthroughPair(EncodingId from_id, EncodingId to_id) noexcept {
+    return from_id != EncodingId::ShiftJIS && IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id);
+}
+
 inline bool AreSameEncoding(EncodingId from_id, EncodingId to_id, const char* from, const char* to) noexcept {
     if (from_id != EncodingId::Unknown && to_id != EncodingId::Unknown) {
         return from_id == to_id;
@@ -369,2008 +506,7994 @@ inline bool AreSameEncoding(EncodingId from_id, EncodingId to_id, const char* fr
     return CompareEncodingNamesEqual(from, to);
 }
 
-inline size_t ComputeMinChunkSize(size_t total_items, size_t target_tasks) noexcept {
-    if (target_tasks == 0 || total_items == 0) {
-        return 1;
+/**
+ * @brief 编码是否可在任意位置重新同步（分块并行的前提）
+ * @note 依赖 BOM 的 UTF-16/UTF-32 与状态型编码不可拆分
+ */
+inline bool IsChunkSplittable(EncodingId id) noexcept {
+    if (IsSbcsId(id)) {
+        return true;
+    }
+    switch (id) {
+        case EncodingId::UTF8:
+        case EncodingId::UTF16LE:
+        case EncodingId::UTF16BE:
+        case EncodingId::UTF32LE:
+        case EncodingId::UTF32BE:
+        case EncodingId::ASCII:
+        case EncodingId::GBK:
+        case EncodingId::GB2312:
+        case EncodingId::GB18030:
+        case EncodingId::BIG5:
+        case EncodingId::ShiftJIS:
+        case EncodingId::EUC_JP:
+        case EncodingId::EUC_KR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief iconv 路径下编码对所属的成本类
+ */
+inline ParallelCostClass IconvCostClass(EncodingId from, EncodingId to) noexcept {
+    auto is_unicode = [](EncodingId id) { return id >= EncodingId::UTF8 && id <= EncodingId::UTF32BE; };
+    auto is_single_byte = [](EncodingId id) {
+        return id == EncodingId::ASCII || IsSbcsId(id);
+    };
+    if (is_unicode(from) && is_unicode(to)) {
+        return ParallelCostClass::IconvUnicode;
     }
-    return (total_items + target_tasks - 1) / target_tasks;
+    if ((is_unicode(from) || is_single_byte(from)) && (is_unicode(to) || is_single_byte(to))) {
+        return ParallelCostClass::IconvSingleByte;
+    }
+    return ParallelCostClass::IconvMultiByte;
+}
+
+/**
+ * @brief 进程级并行阈值表（每个成本类一组），由 CalibrateParallelPolicy / SetParallelThresholds 更新
+ * @note 字段各自原子读写；并发更新期间读到新旧混合的值只影响调度选择，不影响结果正确性
+ */
+struct ParallelThresholdTable {
+    struct Slot {
+        std::atomic<size_t> serial_bytes{AdaptiveParallelPolicy::SERIAL_THRESHOLD_BYTES};
+        std::atomic<size_t> light_parallel_bytes{AdaptiveParallelPolicy::LIGHT_PARALLEL_BYTES};
+        std::atomic<size_t> light_parallel_threads{2};
+        std::atomic<size_t> min_bytes_per_chunk{AdaptiveParallelPolicy::MIN_BYTES_PER_CHUNK};
+    };
+    Slot slots[ParallelCalibration::CLASS_COUNT];
+};
+
+inline ParallelThresholdTable::Slot& GetParallelThresholdSlot(ParallelCostClass cls) noexcept {
+    static ParallelThresholdTable table;
+    const size_t index = static_cast<size_t>(cls);
+    return table.slots[index < ParallelCalibration::CLASS_COUNT ? index : 0];
+}
+
+inline ParallelThresholds LoadParallelThresholds(ParallelCostClass cls) noexcept {
+    const auto& slot = GetParallelThresholdSlot(cls);
+    ParallelThresholds t;
+    t.serial_bytes           = slot.serial_bytes.load(std::memory_order_relaxed);
+    t.light_parallel_bytes   = slot.light_parallel_bytes.load(std::memory_order_relaxed);
+    t.light_parallel_threads = slot.light_parallel_threads.load(std::memory_order_relaxed);
+    t.min_bytes_per_chunk    = slot.min_bytes_per_chunk.load(std::memory_order_relaxed);
+    return t;
+}
+
+inline void StoreParallelThresholds(ParallelCostClass cls, const ParallelThresholds& t) noexcept {
+    auto& slot = GetParallelThresholdSlot(cls);
+    slot.serial_bytes.store(t.serial_bytes, std::memory_order_relaxed);
+    slot.light_parallel_bytes.store((std::max)(t.light_parallel_bytes, t.serial_bytes), std::memory_order_relaxed);
+    slot.light_parallel_threads.store((std::max)(size_t(1), t.light_parallel_threads), std::memory_order_relaxed);
+    slot.min_bytes_per_chunk.store((std::max)(size_t(1), t.min_bytes_per_chunk), std::memory_order_relaxed);
 }
 
 //==============================================================================
-// simdutf 快速路径辅助函数（仅在启用 simdutf 时编译）
+// 转换追踪钩子（UniConv::SetTraceHooks）
 //==============================================================================
-#ifdef UNICONV_HAS_SIMDUTF
+
+std::atomic<const TraceHooks*> g_traceHooks{nullptr};
+
+inline const TraceHooks* ActiveTraceHooks() noexcept {
+    return g_traceHooks.load(std::memory_order_acquire);
+}
+
+UNICONV_NOINLINE UNICONV_COLD void EmitTraceBegin(const TraceHooks* hooks, const TraceSpan& span) noexcept {
+    if (hooks->begin) {
+        hooks->begin(hooks->user_data, span);
+    }
+}
+
+UNICONV_NOINLINE UNICONV_COLD void EmitTraceEnd(const TraceHooks* hooks, const TraceSpan& span) noexcept {
+    if (hooks->end) {
+        hooks->end(hooks->user_data, span);
+    }
+}
 
 /**
- * @brief 检查是否为 UTF-8 到 UTF-16LE 的转换
+ * @brief 一个追踪区间：构造时读取一次钩子并发出 begin，析构时向同一组钩子发出 end
+ * @details 未安装钩子时只有一次原子读与一次分支（区间本身不构造）；Finish() 在 end 之前补全路径、输出字节与结果
  */
-inline bool IsUtf8ToUtf16LE(const char* from, const char* to) noexcept {
-    std::string_view from_sv{from};
-    std::string_view to_sv{to};
-    
-    bool is_from_utf8 = (from_sv.find("UTF-8") != std::string_view::npos ||
-                         from_sv.find("utf-8") != std::string_view::npos ||
-                         from_sv.find("UTF8") != std::string_view::npos ||
-                         from_sv.find("utf8") != std::string_view::npos);
-    
-    bool is_to_utf16le = (to_sv.find("UTF-16LE") != std::string_view::npos ||
-                          to_sv.find("utf-16le") != std::string_view::npos ||
-                          to_sv.find("UTF16LE") != std::string_view::npos);
-    
-    return is_from_utf8 && is_to_utf16le;
-}
+class TraceScope {
+public:
+    TraceScope(TraceSpanKind kind, const char* from, const char* to, size_t bytesIn, size_t items = 0) noexcept
+        : m_hooks(ActiveTraceHooks()) {
+        if (UNICONV_UNLIKELY(m_hooks != nullptr)) {
+            new (&m_span) TraceSpan;
+            m_span.kind          = kind;
+            m_span.from_encoding = from;
+            m_span.to_encoding   = to;
+            m_span.bytes_in      = bytesIn;
+            m_span.items         = items;
+            EmitTraceBegin(m_hooks, m_span);
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() {
+        if (UNICONV_UNLIKELY(m_hooks != nullptr)) {
+            EmitTraceEnd(m_hooks, m_span);
+        }
+    }
+
+    void Finish(ConversionPath path, size_t bytesOut, ErrorCode result) noexcept {
+        if (UNICONV_UNLIKELY(m_hooks != nullptr)) {
+            m_span.path      = path;
+            m_span.bytes_out = bytesOut;
+            m_span.result    = result;
+        }
+    }
+
+    void SetResult(ErrorCode result) noexcept {
+        if (UNICONV_UNLIKELY(m_hooks != nullptr)) {
+            m_span.result = result;
+        }
+    }
+
+private:
+    const TraceHooks* m_hooks;
+    union {
+        TraceSpan     m_span;  // 只在安装了钩子时构造，未安装时不写栈
+    };
+};
 
 /**
- * @brief 检查是否为 UTF-16LE 到 UTF-8 的转换
+ * @brief 安装了追踪钩子时的单次转换：在 Conversion 区间内执行 run(path)
+ * @details 独立成冷函数，未安装钩子时转换入口保持原有的内联与尾调用形态；
+ *          outputSize(ec) 给出区间的输出字节数
  */
-inline bool IsUtf16LEToUtf8(const char* from, const char* to) noexcept {
-    std::string_view from_sv{from};
-    std::string_view to_sv{to};
-    
-    bool is_from_utf16le = (from_sv.find("UTF-16LE") != std::string_view::npos ||
-                            from_sv.find("utf-16le") != std::string_view::npos ||
-                            from_sv.find("UTF16LE") != std::string_view::npos);
-    
-    bool is_to_utf8 = (to_sv.find("UTF-8") != std::string_view::npos ||
-                       to_sv.find("utf-8") != std::string_view::npos ||
-                       to_sv.find("UTF8") != std::string_view::npos ||
-                       to_sv.find("utf8") != std::string_view::npos);
-    
-    return is_from_utf16le && is_to_utf8;
+template <typename Run, typename OutputSize>
+UNICONV_NOINLINE ErrorCode TracedConversion(const char* from, const char* to, size_t bytesIn,
+                                            Run&& run, OutputSize&& outputSize) noexcept {
+    TraceScope trace(TraceSpanKind::Conversion, from, to, bytesIn);
+    ConversionPath path = ConversionPath::Copy;
+    const ErrorCode ec = run(path);
+    trace.Finish(path, outputSize(ec), ec);
+    return ec;
+}
+
+/// 批量并行的参与线程区间：ThreadPool::ParticipantObserver 的上下文
+struct BatchWorkerTrace {
+    const TraceHooks* hooks = nullptr;
+    TraceSpan         span;
+};
+
+void EnterBatchWorker(const void* context) {
+    const auto* trace = static_cast<const BatchWorkerTrace*>(context);
+    EmitTraceBegin(trace->hooks, trace->span);
+}
+
+void LeaveBatchWorker(const void* context) {
+    const auto* trace = static_cast<const BatchWorkerTrace*>(context);
+    EmitTraceEnd(trace->hooks, trace->span);
 }
 
 /**
- * @brief 检查是否为 UTF-8 到 UTF-16BE 的转换
+ * @brief 批量并行的按字节权重划分结果
+ * @details 超大条目（不小于 large_threshold）由调用方逐个走单缓冲区分块并行，
+ *          其余条目按 (字节数 + 固定开销) 切成 bounds 描述的连续子区间
  */
-inline bool IsUtf8ToUtf16BE(const char* from, const char* to) noexcept {
-    std::string_view from_sv{from};
-    std::string_view to_sv{to};
-    
-    bool is_from_utf8 = (from_sv.find("UTF-8") != std::string_view::npos ||
-                         from_sv.find("utf-8") != std::string_view::npos ||
-                         from_sv.find("UTF8") != std::string_view::npos ||
-                         from_sv.find("utf8") != std::string_view::npos);
-    
-    bool is_to_utf16be = (to_sv.find("UTF-16BE") != std::string_view::npos ||
-                          to_sv.find("utf-16be") != std::string_view::npos ||
-                          to_sv.find("UTF16BE") != std::string_view::npos);
-    
-    return is_from_utf8 && is_to_utf16be;
-}
+struct BatchPartition {
+    std::vector<size_t> bounds;                                   ///< 子区间边界 [0, ..., n]
+    size_t large_threshold = (std::numeric_limits<size_t>::max)(); ///< 字节数达到此值的条目单独分块并行
+    size_t large_count = 0;                                       ///< 超大条目数
+
+    size_t PartCount() const noexcept { return bounds.empty() ? 0 : bounds.size() - 1; }
+    bool IsLarge(size_t bytes) const noexcept { return bytes >= large_threshold; }
+};
 
 /**
- * @brief 检查是否为 UTF-16BE 到 UTF-8 的转换
+ * @brief 编码对是否可走单缓冲区分块并行（两端均可拆分且不同编码）
  */
-inline bool IsUtf16BEToUtf8(const char* from, const char* to) noexcept {
-    std::string_view from_sv{from};
-    std::string_view to_sv{to};
-    
-    bool is_from_utf16be = (from_sv.find("UTF-16BE") != std::string_view::npos ||
-                            from_sv.find("utf-16be") != std::string_view::npos ||
-                            from_sv.find("UTF16BE") != std::string_view::npos);
-    
-    bool is_to_utf8 = (to_sv.find("UTF-8") != std::string_view::npos ||
-                       to_sv.find("utf-8") != std::string_view::npos ||
-                       to_sv.find("UTF8") != std::string_view::npos ||
-                       to_sv.find("utf8") != std::string_view::npos);
-    
-    return is_from_utf16be && is_to_utf8;
+inline bool IsChunkSplittablePair(const char* from, const char* to) noexcept {
+    const EncodingId from_id = GetEncodingId(from);
+    const EncodingId to_id   = GetEncodingId(to);
+    return from_id != to_id && IsChunkSplittable(from_id) && IsChunkSplittable(to_id);
 }
 
+/// 每个条目的固定开销（描述符复位、结果构造），按等价字节数计入权重
+constexpr size_t BATCH_ITEM_OVERHEAD_BYTES = 64;
+
 /**
- * @brief 使用 simdutf 进行 UTF-8 到 UTF-16LE 转换
+ * @brief 按字节权重规划批量并行
+ * @param splittable   编码对是否支持单缓冲区分块并行
+ * @param max_threads  可用线程数（超大条目按其公平份额判定）
+ * @param part_threads 普通条目的并行线程数（0 = 调用线程串行处理）
+ * @param min_chunk_bytes 分块并行的最小块字节数（成本类阈值）
+ * @details 条目超过单线程公平份额 total_bytes / max_threads 且不小于 2 * min_chunk_bytes 时
+ *          视为超大条目；其余条目切成约 part_threads * CHUNKS_PER_PARTICIPANT 段，每段字节权重相近，
+ *          使尾延迟随总字节数而非条目数变化
+ * @return 内存不足时返回 false
  */
-inline StringResult ConvertUtf8ToUtf16LE_SIMD(const std::string& input) noexcept {
-    // 先验证 UTF-8 是否有效
-    if (!simdutf::validate_utf8(input.data(), input.size())) {
-        return StringResult::Failure(ErrorCode::InvalidSequence);
+inline bool PlanBatchPartition(const std::vector<std::string>& inputs, size_t total_bytes, bool splittable,
+                               size_t max_threads, size_t part_threads, size_t min_chunk_bytes,
+                               BatchPartition& plan) noexcept {
+    plan.bounds.clear();
+    plan.large_threshold = (std::numeric_limits<size_t>::max)();
+    plan.large_count = 0;
+    if (splittable && max_threads > 1) {
+        plan.large_threshold = (std::max)(2 * min_chunk_bytes, total_bytes / max_threads + 1);
     }
-    
-    // 计算输出长度
-    size_t utf16_len = simdutf::utf16_length_from_utf8(input.data(), input.size());
-    
-    // 分配输出缓冲区
-    std::u16string utf16_output(utf16_len, u'\0');
-    
-    // 执行转换
-    size_t written = simdutf::convert_utf8_to_utf16le(
-        input.data(), input.size(),
-        utf16_output.data());
-    
-    if (written == 0 && utf16_len > 0) {
-        return StringResult::Failure(ErrorCode::ConversionFailed);
+
+    size_t small_weight = 0;
+    for (const auto& input : inputs) {
+        if (plan.IsLarge(input.size())) {
+            ++plan.large_count;
+        } else {
+            small_weight += input.size() + BATCH_ITEM_OVERHEAD_BYTES;
+        }
     }
-    
-    // 转换为字节字符串
-    std::string result;
-    result.resize(utf16_output.size() * sizeof(char16_t));
-    std::memcpy(result.data(), utf16_output.data(), result.size());
-    
-    return StringResult::Success(std::move(result));
+
+    const size_t n = inputs.size();
+    const size_t parts = (std::max)(size_t(1), (std::min)(n - plan.large_count,
+        part_threads * ThreadPool::CHUNKS_PER_PARTICIPANT));
+    try {
+        plan.bounds.reserve(parts + 1);
+        plan.bounds.push_back(0);
+        const size_t share = (std::max)(size_t(1), small_weight / parts);
+        size_t acc = 0;
+        size_t cut = 1;
+        for (size_t i = 0; i < n && cut < parts; ++i) {
+            if (!plan.IsLarge(inputs[i].size())) {
+                acc += inputs[i].size() + BATCH_ITEM_OVERHEAD_BYTES;
+            }
+            // 累计权重越过第 cut 份时切分；单个条目跨越多份时一次跳过
+            if (acc >= share * cut) {
+                plan.bounds.push_back(i + 1);
+                cut = acc / share + 1;
+            }
+        }
+        if (plan.bounds.back() != n) {
+            plan.bounds.push_back(n);
+        }
+    } catch (...) {
+        return false;
+    }
+    return true;
 }
 
 /**
- * @brief 使用 simdutf 进行 UTF-16LE 到 UTF-8 转换
+ * @brief 按规划结果执行批量转换：每段为连续条目区间，单段时在调用线程执行
+ * @tparam F void(size_t start, size_t end)，需跳过 plan.IsLarge() 的条目
+ * @details 安装了追踪钩子时，每个参与线程发出一个 BatchWorker 区间，每段发出一个 BatchChunk 区间
  */
-inline StringResult ConvertUtf16LEToUtf8_SIMD(const std::string& input) noexcept {
-    // 检查输入长度是否为偶数
-    if (input.size() % 2 != 0) {
-        return StringResult::Failure(ErrorCode::InvalidSequence);
+template<typename F>
+void RunBatchPartition(ThreadPool& pool, const BatchPartition& plan, const std::vector<std::string>& inputs,
+                       const char* from, const char* to, F&& convert_range) {
+    const size_t parts = plan.PartCount();
+    if (parts == 0) {
+        return;
     }
-    
-    const char16_t* utf16_data = reinterpret_cast<const char16_t*>(input.data());
-    size_t utf16_len = input.size() / 2;
-    
-    // 验证 UTF-16LE
-    if (!simdutf::validate_utf16le(utf16_data, utf16_len)) {
-        return StringResult::Failure(ErrorCode::InvalidSequence);
+    const TraceHooks* hooks = ActiveTraceHooks();
+    if (UNICONV_LIKELY(hooks == nullptr)) {
+        if (parts == 1) {
+            convert_range(plan.bounds[0], plan.bounds[1]);
+        } else {
+            pool.ParallelFor(parts, [&plan, &convert_range](size_t first, size_t last) {
+                convert_range(plan.bounds[first], plan.bounds[last]);
+            }, 1);
+        }
+        return;
     }
-    
-    // 计算输出长度
-    size_t utf8_len = simdutf::utf8_length_from_utf16le(utf16_data, utf16_len);
-    
-    // 分配输出缓冲区
-    std::string result(utf8_len, '\0');
-    
-    // 执行转换
-    size_t written = simdutf::convert_utf16le_to_utf8(
-        utf16_data, utf16_len,
-        result.data());
-    
-    if (written == 0 && utf8_len > 0) {
-        return StringResult::Failure(ErrorCode::ConversionFailed);
+
+    //  追踪路径：按段统计字节数（超大条目由调用方另行处理，不计入）
+    const auto traced_range = [&plan, &inputs, &convert_range, from, to](size_t start, size_t end) {
+        size_t bytes = 0;
+        for (size_t i = start; i < end; ++i) {
+            if (!plan.IsLarge(inputs[i].size())) {
+                bytes += inputs[i].size();
+            }
+        }
+        TraceScope trace(TraceSpanKind::BatchChunk, from, to, bytes, end - start);
+        convert_range(start, end);
+    };
+    BatchWorkerTrace worker;
+    worker.hooks              = hooks;
+    worker.span.kind          = TraceSpanKind::BatchWorker;
+    worker.span.from_encoding = from;
+    worker.span.to_encoding   = to;
+    ThreadPool::ParticipantObserver observer;
+    observer.context = &worker;
+    observer.enter   = &EnterBatchWorker;
+    observer.leave   = &LeaveBatchWorker;
+    pool.ParallelFor(parts, [&plan, &traced_range](size_t first, size_t last) {
+        for (size_t part = first; part < last; ++part) {
+            traced_range(plan.bounds[part], plan.bounds[part + 1]);
+        }
+    }, 1, &observer);
+}
+
+//==============================================================================
+// simdutf 快速路径辅助函数（仅在启用 simdutf 时编译）
+//==============================================================================
+#ifdef UNICONV_HAS_SIMDUTF
+
+/**
+ * @brief 按字节数调整输出缓冲区，复用调用方已有容量
+ * @return 分配失败时返回 false
+ */
+template<typename ByteString>
+inline bool ResizeSimdOutput(ByteString& output, size_t bytes) noexcept {
+    try {
+        output.resize(bytes);
+    } catch (...) {
+        return false;
     }
-    
-    result.resize(written);
-    return StringResult::Success(std::move(result));
+    return true;
 }
 
 /**
- * @brief 使用 simdutf 进行 UTF-8 到 UTF-16BE 转换
+ * @brief 使用 simdutf 进行 UTF-8 到 UTF-16LE/BE 转换，直接写入调用方缓冲区
+ * @tparam BigEndian 目标为 UTF-16BE 时为 true
  */
-inline StringResult ConvertUtf8ToUtf16BE_SIMD(const std::string& input) noexcept {
+template<bool BigEndian, typename ByteString>
+ErrorCode ConvertUtf8ToUtf16_SIMD(const char* data, size_t size, ByteString& output) noexcept {
     // 先验证 UTF-8 是否有效
-    if (!simdutf::validate_utf8(input.data(), input.size())) {
-        return StringResult::Failure(ErrorCode::InvalidSequence);
+    if (!simdutf::validate_utf8(data, size)) {
+        return ErrorCode::InvalidSequence;
     }
-    
-    // 计算输出长度
-    size_t utf16_len = simdutf::utf16_length_from_utf8(input.data(), input.size());
-    
-    // 分配输出缓冲区
-    std::u16string utf16_output(utf16_len, u'\0');
-    
-    // 执行转换
-    size_t written = simdutf::convert_utf8_to_utf16be(
-        input.data(), input.size(),
-        utf16_output.data());
-    
+
+    // 计算输出长度并按字节调整缓冲区（容量足够时不分配）
+    const size_t utf16_len = simdutf::utf16_length_from_utf8(data, size);
+    if (UNICONV_UNLIKELY(!ResizeSimdOutput(output, utf16_len * sizeof(char16_t)))) {
+        return ErrorCode::OutOfMemory;
+    }
+
+    char16_t* utf16_out = reinterpret_cast<char16_t*>(output.data());
+    const size_t written = BigEndian
+        ? simdutf::convert_utf8_to_utf16be(data, size, utf16_out)
+        : simdutf::convert_utf8_to_utf16le(data, size, utf16_out);
+
     if (written == 0 && utf16_len > 0) {
-        return StringResult::Failure(ErrorCode::ConversionFailed);
+        return ErrorCode::ConversionFailed;
     }
-    
-    // 转换为字节字符串
-    std::string result;
-    result.resize(utf16_output.size() * sizeof(char16_t));
-    std::memcpy(result.data(), utf16_output.data(), result.size());
-    
-    return StringResult::Success(std::move(result));
+
+    output.resize(written * sizeof(char16_t));
+    return ErrorCode::Success;
 }
 
 /**
- * @brief 使用 simdutf 进行 UTF-16BE 到 UTF-8 转换
+ * @brief 使用 simdutf 进行 UTF-16LE/BE 到 UTF-8 转换，直接写入调用方缓冲区
+ * @tparam BigEndian 源为 UTF-16BE 时为 true
  */
-inline StringResult ConvertUtf16BEToUtf8_SIMD(const std::string& input) noexcept {
-    // 检查输入长度是否为偶数
-    if (input.size() % 2 != 0) {
-        return StringResult::Failure(ErrorCode::InvalidSequence);
+template<bool BigEndian, typename ByteString>
+ErrorCode ConvertUtf16ToUtf8_SIMD(const char* data, size_t size, ByteString& output) noexcept {
+    // 奇数字节长度视为末尾截断，与内置内核保持一致
+    if (size % 2 != 0) {
+        return ErrorCode::IncompleteSequence;
     }
-    
-    const char16_t* utf16_data = reinterpret_cast<const char16_t*>(input.data());
-    size_t utf16_len = input.size() / 2;
-    
-    // 验证 UTF-16BE
-    if (!simdutf::validate_utf16be(utf16_data, utf16_len)) {
-        return StringResult::Failure(ErrorCode::InvalidSequence);
+
+    const char16_t* utf16_data = reinterpret_cast<const char16_t*>(data);
+    const size_t utf16_len = size / 2;
+
+    // 验证 UTF-16
+    const bool valid = BigEndian
+        ? simdutf::validate_utf16be(utf16_data, utf16_len)
+        : simdutf::validate_utf16le(utf16_data, utf16_len);
+    if (!valid) {
+        return ErrorCode::InvalidSequence;
     }
-    
-    // 计算输出长度
-    size_t utf8_len = simdutf::utf8_length_from_utf16be(utf16_data, utf16_len);
-    
-    // 分配输出缓冲区
-    std::string result(utf8_len, '\0');
-    
-    // 执行转换
-    size_t written = simdutf::convert_utf16be_to_utf8(
-        utf16_data, utf16_len,
-        result.data());
-    
+
+    // 计算输出长度并调整缓冲区（容量足够时不分配）
+    const size_t utf8_len = BigEndian
+        ? simdutf::utf8_length_from_utf16be(utf16_data, utf16_len)
+        : simdutf::utf8_length_from_utf16le(utf16_data, utf16_len);
+    if (UNICONV_UNLIKELY(!ResizeSimdOutput(output, utf8_len))) {
+        return ErrorCode::OutOfMemory;
+    }
+
+    const size_t written = BigEndian
+        ? simdutf::convert_utf16be_to_utf8(utf16_data, utf16_len, output.data())
+        : simdutf::convert_utf16le_to_utf8(utf16_data, utf16_len, output.data());
+
     if (written == 0 && utf8_len > 0) {
-        return StringResult::Failure(ErrorCode::ConversionFailed);
+        return ErrorCode::ConversionFailed;
     }
-    
-    result.resize(written);
-    return StringResult::Success(std::move(result));
+
+    output.resize(written);
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief simdutf 是否覆盖该编码对（UTF-8 ↔ UTF-16LE/BE）
+ */
+inline bool HasSimdutfKernel(EncodingId from, EncodingId to) noexcept {
+    if (from == EncodingId::UTF8) {
+        return to == EncodingId::UTF16LE || to == EncodingId::UTF16BE;
+    }
+    return to == EncodingId::UTF8 && (from == EncodingId::UTF16LE || from == EncodingId::UTF16BE);
+}
+
+/**
+ * @brief simdutf 快速路径统一入口
+ * @tparam ByteString std::string / std::pmr::string
+ * @details 输入为指针 + 长度，结果写入调用方提供的 output 并保留其容量；
+ *          失败时清空 output。调用前须经 HasSimdutfKernel 判定。
+ */
+template<typename ByteString>
+ErrorCode ConvertUtfSimdutf(EncodingId from, EncodingId to,
+                            const char* data, size_t size,
+                            ByteString& output) noexcept {
+    ErrorCode ec;
+    if (from == EncodingId::UTF8) {
+        ec = (to == EncodingId::UTF16BE) ? ConvertUtf8ToUtf16_SIMD<true>(data, size, output)
+                                         : ConvertUtf8ToUtf16_SIMD<false>(data, size, output);
+    } else {
+        ec = (from == EncodingId::UTF16BE) ? ConvertUtf16ToUtf8_SIMD<true>(data, size, output)
+                                           : ConvertUtf16ToUtf8_SIMD<false>(data, size, output);
+    }
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        output.clear();
+    }
+    return ec;
 }
 
 #endif // UNICONV_HAS_SIMDUTF
 
-} // anonymous namespace
+//==============================================================================
+// 内置 UTF 转码内核：UTF-8 / UTF-16LE / UTF-16BE / UTF-32LE / UTF-32BE 两两互转
+//==============================================================================
+// 结构：向量内核只负责批量处理“规整块”（遇到不规整块即返回已处理码元数）：
+//   - UTF-8 <-> UTF-16/32：纯 ASCII 块的加宽/收窄
+//   - UTF-16/32 <-> UTF-16/32：不含代理项的块的字节序交换、加宽、收窄
+// 其余码点由严格校验的标量编解码器处理，错误语义与 iconv 一致：
+// 非法序列 -> InvalidSequence，末尾截断 -> IncompleteSequence。
+// 输出按字节显式写出，与主机字节序无关。
 
+/**
+ * @brief 块内核签名
+ * @param in 输入字节
+ * @param units 输入码元数
+ * @param out 输出字节
+ * @return 已处理的码元数（整块处理，遇到不规整块提前返回）
+ */
+using UtfBlockKernel = size_t (*)(const uint8_t* in, size_t units, uint8_t* out) noexcept;
 
-#if !UNICONV_NO_THREAD_LOCAL
-// Thread-local cache instance definition (only when thread_local is enabled)
-thread_local UniConv::ThreadLocalCache UniConv::t_cache;
-#endif
+/**
+ * @brief 一组按指令集选定的块内核
+ * @details 下标 [w][be]：w = 0 表示 UTF-16、1 表示 UTF-32；be 表示大端
+ */
+struct UtfSimdKernels {
+    UtfBlockKernel widen_ascii[2][2];          ///< UTF-8（ASCII）-> UTF-16/32，[输出][输出字节序]
+    UtfBlockKernel narrow_ascii[2][2];         ///< UTF-16/32（ASCII）-> UTF-8，[输入][输入字节序]
+    UtfBlockKernel wide_to_wide[2][2][2][2];   ///< UTF-16/32 -> UTF-16/32，[输入][输入字节序][输出][输出字节序]
+    size_t         block_units;                ///< 内核单次处理的码元数，剩余不足时不调用内核
+};
 
-#if UNICONV_NO_THREAD_LOCAL
+size_t NoBlockKernel(const uint8_t*, size_t, uint8_t*) noexcept {
+    return 0;
+}
+
+#if UNICONV_NATIVE_SIMD_X86
+
+UNICONV_TARGET_SSE2 inline __m128i ByteSwap16_SSE2(__m128i v) noexcept {
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+UNICONV_TARGET_SSE2 inline __m128i ByteSwap32_SSE2(__m128i v) noexcept {
+    v = ByteSwap16_SSE2(v);
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+}
+
+template <size_t OutBytes, bool OutBE>
+UNICONV_TARGET_SSE2 size_t WidenAscii_SSE2(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= units; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (_mm_movemask_epi8(v) != 0) break;
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        uint8_t* dst = out + i * OutBytes;
+        if constexpr (OutBytes == 2) {
+            // ASCII 码元高字节为 0，大端即整体左移 8 位
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),      OutBE ? _mm_slli_epi16(lo, 8) : lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), OutBE ? _mm_slli_epi16(hi, 8) : hi);
+        } else {
+            const __m128i parts[4] = {_mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                                      _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)};
+            for (int k = 0; k < 4; ++k) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16 * k),
+                                 OutBE ? _mm_slli_epi32(parts[k], 24) : parts[k]);
+            }
+        }
+    }
+    return i;
+}
+
+template <size_t InBytes, bool InBE>
+UNICONV_TARGET_SSE2 size_t NarrowAscii_SSE2(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= units; i += 16) {
+        const uint8_t* src = in + i * InBytes;
+        if constexpr (InBytes == 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+            if (InBE) { a = ByteSwap16_SSE2(a); b = ByteSwap16_SSE2(b); }
+            const __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+        } else {
+            __m128i v[4];
+            for (int k = 0; k < 4; ++k) {
+                v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16 * k));
+                if (InBE) v[k] = ByteSwap32_SSE2(v[k]);
+            }
+            const __m128i any = _mm_or_si128(_mm_or_si128(v[0], v[1]), _mm_or_si128(v[2], v[3]));
+            const __m128i high = _mm_and_si128(any, _mm_set1_epi32(static_cast<int>(0xFFFFFF80u)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF) break;
+            const __m128i ab = _mm_packs_epi32(v[0], v[1]);
+            const __m128i cd = _mm_packs_epi32(v[2], v[3]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(ab, cd));
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief UTF-32 码元向量是否全部为合法码点（BMP16 为 true 时还要求不超出 BMP）
+ */
+template <bool BMP16>
+UNICONV_TARGET_SSE2 inline bool ValidScalars32_SSE2(__m128i v) noexcept {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bad = _mm_cmpeq_epi32(_mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFFFF800u))),
+                                  _mm_set1_epi32(0xD800));
+    if (BMP16) {
+        bad = _mm_or_si128(bad, _mm_xor_si128(_mm_cmpeq_epi32(_mm_srli_epi32(v, 16), zero),
+                                              _mm_set1_epi32(-1)));
+    } else {
+        bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmpgt_epi32(v, _mm_set1_epi32(0x10FFFF)),
+                                             _mm_cmplt_epi32(v, zero)));
+    }
+    return _mm_movemask_epi8(bad) == 0;
+}
+
+template <size_t InBytes, bool InBE, size_t OutBytes, bool OutBE>
+UNICONV_TARGET_SSE2 size_t WideToWide_SSE2(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= units; i += 8) {
+        const uint8_t* src = in + i * InBytes;
+        uint8_t* dst = out + i * OutBytes;
+        if constexpr (InBytes == 2) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            if (InBE) v = ByteSwap16_SSE2(v);
+            const __m128i surrogate = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xF800))),
+                                                      _mm_set1_epi16(static_cast<short>(0xD800)));
+            if (_mm_movemask_epi8(surrogate) != 0) break;
+            if constexpr (OutBytes == 2) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), OutBE ? ByteSwap16_SSE2(v) : v);
+            } else {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i lo = _mm_unpacklo_epi16(v, zero);
+                const __m128i hi = _mm_unpackhi_epi16(v, zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),      OutBE ? ByteSwap32_SSE2(lo) : lo);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), OutBE ? ByteSwap32_SSE2(hi) : hi);
+            }
+        } else {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+            if (InBE) { a = ByteSwap32_SSE2(a); b = ByteSwap32_SSE2(b); }
+            if (!ValidScalars32_SSE2<OutBytes == 2>(a) || !ValidScalars32_SSE2<OutBytes == 2>(b)) break;
+            if constexpr (OutBytes == 2) {
+                // 值 <= 0xFFFF：先符号扩展低 16 位，再用有符号饱和打包得到原位模式
+                const __m128i packed = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                                       _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), OutBE ? ByteSwap16_SSE2(packed) : packed);
+            } else {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),      OutBE ? ByteSwap32_SSE2(a) : a);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), OutBE ? ByteSwap32_SSE2(b) : b);
+            }
+        }
+    }
+    return i;
+}
+
+UNICONV_TARGET_AVX2 inline __m256i ByteSwap16_AVX2(__m256i v) noexcept {
+    const __m256i mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                          1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    return _mm256_shuffle_epi8(v, mask);
+}
+
+UNICONV_TARGET_AVX2 inline __m256i ByteSwap32_AVX2(__m256i v) noexcept {
+    const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                          3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    return _mm256_shuffle_epi8(v, mask);
+}
+
+template <size_t OutBytes, bool OutBE>
+UNICONV_TARGET_AVX2 size_t WidenAscii_AVX2(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    size_t i = 0;
+    for (; i + 32 <= units; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        if (_mm256_movemask_epi8(v) != 0) break;
+        const __m128i lo = _mm256_castsi256_si128(v);
+        const __m128i hi = _mm256_extracti128_si256(v, 1);
+        uint8_t* dst = out + i * OutBytes;
+        if constexpr (OutBytes == 2) {
+            const __m256i a = _mm256_cvtepu8_epi16(lo);
+            const __m256i b = _mm256_cvtepu8_epi16(hi);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),      OutBE ? _mm256_slli_epi16(a, 8) : a);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), OutBE ? _mm256_slli_epi16(b, 8) : b);
+        } else {
+            const __m256i parts[4] = {_mm256_cvtepu8_epi32(lo), _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)),
+                                      _mm256_cvtepu8_epi32(hi), _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8))};
+            for (int k = 0; k < 4; ++k) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32 * k),
+                                    OutBE ? _mm256_slli_epi32(parts[k], 24) : parts[k]);
+            }
+        }
+    }
+    return i;
+}
+
+template <size_t InBytes, bool InBE>
+UNICONV_TARGET_AVX2 size_t NarrowAscii_AVX2(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    size_t i = 0;
+    for (; i + 32 <= units; i += 32) {
+        const uint8_t* src = in + i * InBytes;
+        if constexpr (InBytes == 2) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+            if (InBE) { a = ByteSwap16_AVX2(a); b = ByteSwap16_AVX2(b); }
+            if (!_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_set1_epi16(static_cast<short>(0xFF80)))) break;
+            // packus 按 128 位通道交错，permute 恢复顺序
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+        } else {
+            __m256i v[4];
+            for (int k = 0; k < 4; ++k) {
+                v[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32 * k));
+                if (InBE) v[k] = ByteSwap32_AVX2(v[k]);
+            }
+            const __m256i any = _mm256_or_si256(_mm256_or_si256(v[0], v[1]), _mm256_or_si256(v[2], v[3]));
+            if (!_mm256_testz_si256(any, _mm256_set1_epi32(static_cast<int>(0xFFFFFF80u)))) break;
+            const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(v[0], v[1]), _mm256_packs_epi32(v[2], v[3]));
+            const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permutevar8x32_epi32(packed, order));
+        }
+    }
+    return i;
+}
+
+template <bool BMP16>
+UNICONV_TARGET_AVX2 inline bool ValidScalars32_AVX2(__m256i v) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i surrogate = _mm256_cmpeq_epi32(_mm256_and_si256(v, _mm256_set1_epi32(static_cast<int>(0xFFFFF800u))),
+                                                 _mm256_set1_epi32(0xD800));
+    if (!_mm256_testz_si256(surrogate, surrogate)) return false;
+    if (BMP16) {
+        return _mm256_testz_si256(v, _mm256_set1_epi32(static_cast<int>(0xFFFF0000u))) != 0;
+    }
+    const __m256i over = _mm256_or_si256(_mm256_cmpgt_epi32(v, _mm256_set1_epi32(0x10FFFF)),
+                                         _mm256_cmpgt_epi32(zero, v));
+    return _mm256_testz_si256(over, over) != 0;
+}
+
+template <size_t InBytes, bool InBE, size_t OutBytes, bool OutBE>
+UNICONV_TARGET_AVX2 size_t WideToWide_AVX2(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    size_t i = 0;
+    for (; i + 16 <= units; i += 16) {
+        const uint8_t* src = in + i * InBytes;
+        uint8_t* dst = out + i * OutBytes;
+        if constexpr (InBytes == 2) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            if (InBE) v = ByteSwap16_AVX2(v);
+            const __m256i surrogate = _mm256_cmpeq_epi16(
+                _mm256_and_si256(v, _mm256_set1_epi16(static_cast<short>(0xF800))),
+                _mm256_set1_epi16(static_cast<short>(0xD800)));
+            if (!_mm256_testz_si256(surrogate, surrogate)) break;
+            if constexpr (OutBytes == 2) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), OutBE ? ByteSwap16_AVX2(v) : v);
+            } else {
+                const __m256i lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v));
+                const __m256i hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),      OutBE ? ByteSwap32_AVX2(lo) : lo);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), OutBE ? ByteSwap32_AVX2(hi) : hi);
+            }
+        } else {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+            if (InBE) { a = ByteSwap32_AVX2(a); b = ByteSwap32_AVX2(b); }
+            if (!ValidScalars32_AVX2<OutBytes == 2>(a) || !ValidScalars32_AVX2<OutBytes == 2>(b)) break;
+            if constexpr (OutBytes == 2) {
+                // 值 <= 0xFFFF 时 packus_epi32 不饱和，permute 恢复通道顺序
+                __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), OutBE ? ByteSwap16_AVX2(packed) : packed);
+            } else {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),      OutBE ? ByteSwap32_AVX2(a) : a);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), OutBE ? ByteSwap32_AVX2(b) : b);
+            }
+        }
+    }
+    return i;
+}
+
+#elif UNICONV_NATIVE_SIMD_NEON
+
+template <size_t OutBytes, bool OutBE>
+size_t WidenAscii_NEON(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    size_t i = 0;
+    for (; i + 16 <= units; i += 16) {
+        const uint8x16_t v = vld1q_u8(in + i);
+        if (vmaxvq_u8(v) >= 0x80) break;
+        const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        const uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        uint8_t* dst = out + i * OutBytes;
+        if constexpr (OutBytes == 2) {
+            vst1q_u8(dst,      vreinterpretq_u8_u16(OutBE ? vshlq_n_u16(lo, 8) : lo));
+            vst1q_u8(dst + 16, vreinterpretq_u8_u16(OutBE ? vshlq_n_u16(hi, 8) : hi));
+        } else {
+            const uint32x4_t parts[4] = {vmovl_u16(vget_low_u16(lo)), vmovl_u16(vget_high_u16(lo)),
+                                         vmovl_u16(vget_low_u16(hi)), vmovl_u16(vget_high_u16(hi))};
+            for (int k = 0; k < 4; ++k) {
+                vst1q_u8(dst + 16 * k, vreinterpretq_u8_u32(OutBE ? vshlq_n_u32(parts[k], 24) : parts[k]));
+            }
+        }
+    }
+    return i;
+}
+
+template <size_t InBytes, bool InBE>
+size_t NarrowAscii_NEON(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    size_t i = 0;
+    for (; i + 16 <= units; i += 16) {
+        const uint8_t* src = in + i * InBytes;
+        if constexpr (InBytes == 2) {
+            uint8x16_t ra = vld1q_u8(src);
+            uint8x16_t rb = vld1q_u8(src + 16);
+            if (InBE) { ra = vrev16q_u8(ra); rb = vrev16q_u8(rb); }
+            const uint16x8_t a = vreinterpretq_u16_u8(ra);
+            const uint16x8_t b = vreinterpretq_u16_u8(rb);
+            if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) break;
+            vst1q_u8(out + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+        } else {
+            uint32x4_t v[4];
+            for (int k = 0; k < 4; ++k) {
+                uint8x16_t raw = vld1q_u8(src + 16 * k);
+                if (InBE) raw = vrev32q_u8(raw);
+                v[k] = vreinterpretq_u32_u8(raw);
+            }
+            if (vmaxvq_u32(vorrq_u32(vorrq_u32(v[0], v[1]), vorrq_u32(v[2], v[3]))) >= 0x80) break;
+            const uint16x8_t ab = vcombine_u16(vmovn_u32(v[0]), vmovn_u32(v[1]));
+            const uint16x8_t cd = vcombine_u16(vmovn_u32(v[2]), vmovn_u32(v[3]));
+            vst1q_u8(out + i, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+        }
+    }
+    return i;
+}
+
+template <bool BMP16>
+inline bool ValidScalars32_NEON(uint32x4_t v) noexcept {
+    const uint32x4_t surrogate = vceqq_u32(vandq_u32(v, vdupq_n_u32(0xFFFFF800u)), vdupq_n_u32(0xD800));
+    if (vmaxvq_u32(surrogate) != 0) return false;
+    return vmaxvq_u32(v) <= (BMP16 ? 0xFFFFu : 0x10FFFFu);
+}
+
+template <size_t InBytes, bool InBE, size_t OutBytes, bool OutBE>
+size_t WideToWide_NEON(const uint8_t* in, size_t units, uint8_t* out) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= units; i += 8) {
+        const uint8_t* src = in + i * InBytes;
+        uint8_t* dst = out + i * OutBytes;
+        if constexpr (InBytes == 2) {
+            uint8x16_t raw = vld1q_u8(src);
+            if (InBE) raw = vrev16q_u8(raw);
+            const uint16x8_t v = vreinterpretq_u16_u8(raw);
+            const uint16x8_t surrogate = vceqq_u16(vandq_u16(v, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800));
+            if (vmaxvq_u16(surrogate) != 0) break;
+            if constexpr (OutBytes == 2) {
+                vst1q_u8(dst, OutBE ? vrev16q_u8(vreinterpretq_u8_u16(v)) : vreinterpretq_u8_u16(v));
+            } else {
+                const uint8x16_t lo = vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(v)));
+                const uint8x16_t hi = vreinterpretq_u8_u32(vmovl_u16(vget_high_u16(v)));
+                vst1q_u8(dst,      OutBE ? vrev32q_u8(lo) : lo);
+                vst1q_u8(dst + 16, OutBE ? vrev32q_u8(hi) : hi);
+            }
+        } else {
+            uint8x16_t ra = vld1q_u8(src);
+            uint8x16_t rb = vld1q_u8(src + 16);
+            if (InBE) { ra = vrev32q_u8(ra); rb = vrev32q_u8(rb); }
+            const uint32x4_t a = vreinterpretq_u32_u8(ra);
+            const uint32x4_t b = vreinterpretq_u32_u8(rb);
+            if (!ValidScalars32_NEON<OutBytes == 2>(a) || !ValidScalars32_NEON<OutBytes == 2>(b)) break;
+            if constexpr (OutBytes == 2) {
+                const uint8x16_t packed = vreinterpretq_u8_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+                vst1q_u8(dst, OutBE ? vrev16q_u8(packed) : packed);
+            } else {
+                vst1q_u8(dst,      OutBE ? vrev32q_u8(ra) : ra);
+                vst1q_u8(dst + 16, OutBE ? vrev32q_u8(rb) : rb);
+            }
+        }
+    }
+    return i;
+}
+
+#endif // UNICONV_NATIVE_SIMD_X86 / UNICONV_NATIVE_SIMD_NEON
+
+// 分派表：函数模板不能作为模板模板参数传递，按指令集逐项展开（仅在 SelectUtfSimdKernels 中使用）
+#define UNICONV_UTF_KERNEL_TABLE(ISA, BLOCK)                                                               \
+    UtfSimdKernels{                                                                                        \
+        {{WidenAscii_##ISA<2, false>, WidenAscii_##ISA<2, true>},                                          \
+         {WidenAscii_##ISA<4, false>, WidenAscii_##ISA<4, true>}},                                         \
+        {{NarrowAscii_##ISA<2, false>, NarrowAscii_##ISA<2, true>},                                        \
+         {NarrowAscii_##ISA<4, false>, NarrowAscii_##ISA<4, true>}},                                       \
+        {{{{NoBlockKernel, WideToWide_##ISA<2, false, 2, true>},                                           \
+           {WideToWide_##ISA<2, false, 4, false>, WideToWide_##ISA<2, false, 4, true>}},                   \
+          {{WideToWide_##ISA<2, true, 2, false>, NoBlockKernel},                                           \
+           {WideToWide_##ISA<2, true, 4, false>, WideToWide_##ISA<2, true, 4, true>}}},                    \
+         {{{WideToWide_##ISA<4, false, 2, false>, WideToWide_##ISA<4, false, 2, true>},                    \
+           {NoBlockKernel, WideToWide_##ISA<4, false, 4, true>}},                                          \
+          {{WideToWide_##ISA<4, true, 2, false>, WideToWide_##ISA<4, true, 2, true>},                      \
+           {WideToWide_##ISA<4, true, 4, false>, NoBlockKernel}}}},                                        \
+        BLOCK}
+
+/**
+ * @brief 按运行时 CPU 特性选择内核（进程内只选择一次）
+ */
+UtfSimdKernels SelectUtfSimdKernels() noexcept {
+    const CpuOptimizationInfo& cpu = CpuOptimization::GetInfo();
+    (void)cpu;
+#if UNICONV_NATIVE_SIMD_X86
+    if (cpu.has_avx2) {
+        return UNICONV_UTF_KERNEL_TABLE(AVX2, 32);
+    }
+    if (cpu.has_sse2) {
+        return UNICONV_UTF_KERNEL_TABLE(SSE2, 16);
+    }
+#elif UNICONV_NATIVE_SIMD_NEON
+    if (cpu.has_neon) {
+        return UNICONV_UTF_KERNEL_TABLE(NEON, 16);
+    }
+#endif
+    UtfSimdKernels scalar{};
+    for (auto& row : scalar.widen_ascii)  for (auto& k : row) k = NoBlockKernel;
+    for (auto& row : scalar.narrow_ascii) for (auto& k : row) k = NoBlockKernel;
+    for (auto& a : scalar.wide_to_wide) for (auto& b : a) for (auto& c : b) for (auto& k : c) k = NoBlockKernel;
+    scalar.block_units = std::numeric_limits<size_t>::max();
+    return scalar;
+}
+#undef UNICONV_UTF_KERNEL_TABLE
+
+inline const UtfSimdKernels& GetUtfSimdKernels() noexcept {
+    static const UtfSimdKernels kernels = SelectUtfSimdKernels();
+    return kernels;
+}
+
+// ---- 标量编解码（严格校验：拒绝过长编码、代理项码点与超出 U+10FFFF 的值） ----
+
+/**
+ * @brief 解码一个非 ASCII 的 UTF-8 码点
+ * @param in 输入
+ * @param n 输入长度
+ * @param i 当前位置（成功时前移到下一码点）
+ * @param cp 输出码点
+ */
+inline ErrorCode DecodeUtf8NonAscii(const uint8_t* in, size_t n, size_t& i, uint32_t& cp) noexcept {
+    const uint8_t lead = in[i];
+    size_t length;
+    uint8_t lower = 0x80, upper = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2; cp = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3; cp = lead & 0x0F;
+        if (lead == 0xE0) lower = 0xA0;
+        if (lead == 0xED) upper = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4; cp = lead & 0x07;
+        if (lead == 0xF0) lower = 0x90;
+        if (lead == 0xF4) upper = 0x8F;
+    } else {
+        return ErrorCode::InvalidSequence;
+    }
+
+    for (size_t k = 1; k < length; ++k) {
+        if (i + k >= n) {
+            return ErrorCode::IncompleteSequence;
+        }
+        const uint8_t byte = in[i + k];
+        if (byte < lower || byte > upper) {
+            return ErrorCode::InvalidSequence;
+        }
+        lower = 0x80; upper = 0xBF;
+        cp = (cp << 6) | (byte & 0x3F);
+    }
+    i += length;
+    return ErrorCode::Success;
+}
+
+inline uint8_t* EncodeUtf8(uint8_t* out, uint32_t cp) noexcept {
+    if (cp < 0x80) {
+        *out++ = static_cast<uint8_t>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<uint8_t>(0xC0 | (cp >> 6));
+        *out++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<uint8_t>(0xE0 | (cp >> 12));
+        *out++ = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<uint8_t>(0xF0 | (cp >> 18));
+        *out++ = static_cast<uint8_t>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+template <size_t Bytes, bool BigEndian>
+inline uint32_t LoadUnit(const uint8_t* p) noexcept {
+    uint32_t value = 0;
+    for (size_t k = 0; k < Bytes; ++k) {
+        value |= static_cast<uint32_t>(p[BigEndian ? Bytes - 1 - k : k]) << (8 * k);
+    }
+    return value;
+}
+
+template <size_t Bytes, bool BigEndian>
+inline uint8_t* StoreUnit(uint8_t* out, uint32_t value) noexcept {
+    for (size_t k = 0; k < Bytes; ++k) {
+        out[BigEndian ? Bytes - 1 - k : k] = static_cast<uint8_t>(value >> (8 * k));
+    }
+    return out + Bytes;
+}
+
+/**
+ * @brief 解码一个 UTF-16/32 码点（校验代理对与取值范围）
+ */
+template <size_t Bytes, bool BigEndian>
+inline ErrorCode DecodeWide(const uint8_t* in, size_t units, size_t& i, uint32_t& cp) noexcept {
+    cp = LoadUnit<Bytes, BigEndian>(in + i * Bytes);
+    ++i;
+    if constexpr (Bytes == 2) {
+        if (cp >= 0xD800 && cp <= 0xDFFF) {
+            if (cp >= 0xDC00) return ErrorCode::InvalidSequence;
+            if (i >= units) return ErrorCode::IncompleteSequence;
+            const uint32_t low = LoadUnit<2, BigEndian>(in + i * 2);
+            if (low < 0xDC00 || low > 0xDFFF) return ErrorCode::InvalidSequence;
+            ++i;
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+    } else {
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return ErrorCode::InvalidSequence;
+    }
+    return ErrorCode::Success;
+}
+
+template <size_t Bytes, bool BigEndian>
+inline uint8_t* EncodeWide(uint8_t* out, uint32_t cp) noexcept {
+    if constexpr (Bytes == 2) {
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            out = StoreUnit<2, BigEndian>(out, 0xD800 | (cp >> 10));
+            return StoreUnit<2, BigEndian>(out, 0xDC00 | (cp & 0x3FF));
+        }
+    }
+    return StoreUnit<Bytes, BigEndian>(out, cp);
+}
+
+// ---- 转码驱动：块内核优先，不规整处退回标量，逐码点前进 ----
+// consumed/written 在任何返回路径上都有效：失败时 consumed 指向出错序列的起始字节，
+// written 为此前已写出的字节数
+
+using UtfTranscoder = ErrorCode (*)(const uint8_t* in, size_t n, uint8_t* out,
+                                    size_t& consumed, size_t& written) noexcept;
+
+template <size_t OutBytes, bool OutBE>
+ErrorCode TranscodeUtf8ToWide(const uint8_t* in, size_t n, uint8_t* out,
+                              size_t& consumed, size_t& written) noexcept {
+    const UtfSimdKernels& simd = GetUtfSimdKernels();
+    const UtfBlockKernel widen = simd.widen_ascii[OutBytes == 4][OutBE];
+    uint8_t* const begin = out;
+    size_t i = 0;
+    while (i < n) {
+        if (in[i] < 0x80) {
+            if (n - i >= simd.block_units) {
+                const size_t done = widen(in + i, n - i, out);
+                i += done;
+                out += done * OutBytes;
+            }
+            while (i < n && in[i] < 0x80) {
+                out = StoreUnit<OutBytes, OutBE>(out, in[i++]);
+            }
+            continue;
+        }
+        uint32_t cp;
+        const ErrorCode ec = DecodeUtf8NonAscii(in, n, i, cp);
+        if (ec != ErrorCode::Success) {
+            consumed = i;
+            written = static_cast<size_t>(out - begin);
+            return ec;
+        }
+        out = EncodeWide<OutBytes, OutBE>(out, cp);
+    }
+    consumed = n;
+    written = static_cast<size_t>(out - begin);
+    return ErrorCode::Success;
+}
+
+template <size_t InBytes, bool InBE>
+ErrorCode TranscodeWideToUtf8(const uint8_t* in, size_t n, uint8_t* out,
+                              size_t& consumed, size_t& written) noexcept {
+    const UtfSimdKernels& simd = GetUtfSimdKernels();
+    const UtfBlockKernel narrow = simd.narrow_ascii[InBytes == 4][InBE];
+    const size_t units = n / InBytes;
+    uint8_t* const begin = out;
+    size_t i = 0;
+    while (i < units) {
+        uint32_t unit = LoadUnit<InBytes, InBE>(in + i * InBytes);
+        if (unit < 0x80) {
+            if (units - i >= simd.block_units) {
+                const size_t done = narrow(in + i * InBytes, units - i, out);
+                i += done;
+                out += done;
+            }
+            while (i < units && (unit = LoadUnit<InBytes, InBE>(in + i * InBytes)) < 0x80) {
+                *out++ = static_cast<uint8_t>(unit);
+                ++i;
+            }
+            continue;
+        }
+        const size_t start = i;
+        uint32_t cp;
+        const ErrorCode ec = DecodeWide<InBytes, InBE>(in, units, i, cp);
+        if (ec != ErrorCode::Success) {
+            consumed = start * InBytes;
+            written = static_cast<size_t>(out - begin);
+            return ec;
+        }
+        out = EncodeUtf8(out, cp);
+    }
+    consumed = units * InBytes;
+    written = static_cast<size_t>(out - begin);
+    return (n % InBytes != 0) ? ErrorCode::IncompleteSequence : ErrorCode::Success;
+}
+
+template <size_t InBytes, bool InBE, size_t OutBytes, bool OutBE>
+ErrorCode TranscodeWideToWide(const uint8_t* in, size_t n, uint8_t* out,
+                              size_t& consumed, size_t& written) noexcept {
+    const UtfSimdKernels& simd = GetUtfSimdKernels();
+    const UtfBlockKernel kernel = simd.wide_to_wide[InBytes == 4][InBE][OutBytes == 4][OutBE];
+    const size_t units = n / InBytes;
+    uint8_t* const begin = out;
+    size_t i = 0;
+    while (i < units) {
+        if (units - i >= simd.block_units) {
+            const size_t done = kernel(in + i * InBytes, units - i, out);
+            i += done;
+            out += done * OutBytes;
+        }
+        // 块内含代理项/非 BMP 码点：标量处理一个块宽度后再尝试向量内核
+        const size_t scalar_end = (units - i > simd.block_units) ? i + simd.block_units : units;
+        while (i < scalar_end) {
+            const size_t start = i;
+            uint32_t cp;
+            const ErrorCode ec = DecodeWide<InBytes, InBE>(in, units, i, cp);
+            if (ec != ErrorCode::Success) {
+                consumed = start * InBytes;
+                written = static_cast<size_t>(out - begin);
+                return ec;
+            }
+            out = EncodeWide<OutBytes, OutBE>(out, cp);
+        }
+    }
+    consumed = units * InBytes;
+    written = static_cast<size_t>(out - begin);
+    return (n % InBytes != 0) ? ErrorCode::IncompleteSequence : ErrorCode::Success;
+}
+
+/**
+ * @brief 内置内核支持的编码形式下标：UTF-8, UTF-16LE, UTF-16BE, UTF-32LE, UTF-32BE；不支持返回 -1
+ */
+inline int NativeUtfFormIndex(EncodingId id) noexcept {
+    switch (id) {
+        case EncodingId::UTF8:    return 0;
+        case EncodingId::UTF16LE: return 1;
+        case EncodingId::UTF16BE: return 2;
+        case EncodingId::UTF32LE: return 3;
+        case EncodingId::UTF32BE: return 4;
+        default:                  return -1;
+    }
+}
+
+constexpr size_t kNativeUtfUnitBytes[5] = {1, 2, 2, 4, 4};
+
+constexpr UtfTranscoder kNativeUtfTranscoders[5][5] = {
+    {nullptr,
+     TranscodeUtf8ToWide<2, false>, TranscodeUtf8ToWide<2, true>,
+     TranscodeUtf8ToWide<4, false>, TranscodeUtf8ToWide<4, true>},
+    {TranscodeWideToUtf8<2, false>, nullptr,
+     TranscodeWideToWide<2, false, 2, true>,
+     TranscodeWideToWide<2, false, 4, false>, TranscodeWideToWide<2, false, 4, true>},
+    {TranscodeWideToUtf8<2, true>,
+     TranscodeWideToWide<2, true, 2, false>, nullptr,
+     TranscodeWideToWide<2, true, 4, false>, TranscodeWideToWide<2, true, 4, true>},
+    {TranscodeWideToUtf8<4, false>,
+     TranscodeWideToWide<4, false, 2, false>, TranscodeWideToWide<4, false, 2, true>,
+     nullptr, TranscodeWideToWide<4, false, 4, true>},
+    {TranscodeWideToUtf8<4, true>,
+     TranscodeWideToWide<4, true, 2, false>, TranscodeWideToWide<4, true, 2, true>,
+     TranscodeWideToWide<4, true, 4, false>, nullptr},
+};
+
+/**
+ * @brief 是否存在内置转码内核（UTF-8/16LE/16BE/32LE/32BE 之间的任意不同编码对）
+ */
+inline bool HasNativeUtfKernel(EncodingId from, EncodingId to) noexcept {
+    const int f = NativeUtfFormIndex(from);
+    const int t = NativeUtfFormIndex(to);
+    return f >= 0 && t >= 0 && f != t;
+}
+
+/**
+ * @brief 内置内核输出字节数上界
+ * @details 每个输入码元至多产生的字节数 —— UTF-8 字节 -> 1 个目标码元；
+ *          UTF-16 码元 -> 3 字节 UTF-8 / 1 个 UTF-16 码元 / 4 字节 UTF-32（代理对整体不超过 4 字节）；
+ *          UTF-32 码元 -> 4 字节
+ * @pre HasNativeUtfKernel(from, to)
+ * @return 上界；溢出时返回 SIZE_MAX
+ */
+inline size_t NativeUtfOutputBound(EncodingId from, EncodingId to, size_t size) noexcept {
+    const size_t in_unit = kNativeUtfUnitBytes[NativeUtfFormIndex(from)];
+    const size_t out_unit = kNativeUtfUnitBytes[NativeUtfFormIndex(to)];
+    const size_t per_unit = (in_unit == 1) ? out_unit
+                          : (in_unit == 2) ? (out_unit == 1 ? 3 : out_unit)
+                          : 4;
+    const size_t in_units = size / in_unit + 1;
+    if (UNICONV_UNLIKELY(in_units > std::numeric_limits<size_t>::max() / per_unit)) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return in_units * per_unit;
+}
+
+//==============================================================================
+// 内置单字节码页编解码：ISO-8859-x、KOI8、CP125x、CP8xx、Mac 系列（码表见 sbcs_tables.inc）
+//==============================================================================
+// 解码查 128 项表（高位字节 -> 码点，UTF-8 形式预先编码好）；编码按码点高 8 位索引 256 字节反查页。
+// 两个方向的 ASCII 段都走 AsciiPrefixLength / 加宽收窄向量内核整段处理，只有高位字节逐个查表。
+// 未定义字节与无法映射的码点报 InvalidSequence，与 iconv 的 EILSEQ 一致。
+
+constexpr uint16_t kSbcsUndefined = 0xFFFF;
+
+#define UNICONV_SBCS(id, ...) constexpr uint16_t kSbcsDecode_##id[128] = {__VA_ARGS__};
+#define UNICONV_SBCS_NAME(id, name)
+#include "sbcs_tables.inc"
+#undef UNICONV_SBCS_NAME
+#undef UNICONV_SBCS
+
+constexpr const uint16_t* kSbcsDecodeTables[] = {
+#define UNICONV_SBCS(id, ...) kSbcsDecode_##id,
+#define UNICONV_SBCS_NAME(id, name)
+#include "sbcs_tables.inc"
+#undef UNICONV_SBCS_NAME
+#undef UNICONV_SBCS
+};
+
+constexpr size_t kSbcsCount = static_cast<size_t>(EncodingId::SbcsEnd) - static_cast<size_t>(EncodingId::ISO8859_1);
+static_assert(sizeof(kSbcsDecodeTables) / sizeof(kSbcsDecodeTables[0]) == kSbcsCount,
+              "sbcs_tables.inc must list every single-byte EncodingId exactly once");
+
+/**
+ * @brief 单个码页的编解码数据
+ */
+struct SbcsCodec {
+    const uint16_t* decode = nullptr;      ///< 字节 0x80-0xFF -> 码点（kSbcsUndefined 表示未定义）
+    uint8_t         utf8[128][4] = {};     ///< 高位字节预编码的 UTF-8，[3] 为字节数
+    uint16_t        page_index[256] = {};  ///< 码点高 8 位 -> 反查页号 + 1（0 表示整页无映射）
+    const uint8_t*  pages = nullptr;       ///< 反查页（每页 256 字节，0 表示无映射）
+
+    /// 码点 -> 字节；无法映射返回 0（0x80 以下码点由调用方按 ASCII 处理）
+    uint8_t Encode(uint32_t cp) const noexcept {
+        if (cp > 0xFFFF) {
+            return 0;
+        }
+        const uint16_t page = page_index[cp >> 8];
+        return page ? pages[static_cast<size_t>(page - 1) * 256 + (cp & 0xFF)] : 0;
+    }
+};
+
+struct SbcsCodecSet {
+    SbcsCodec            codecs[kSbcsCount];
+    std::vector<uint8_t> pages;            ///< 所有码页共用的反查页存储
+};
+
+/**
+ * @brief 由解码表生成预编码 UTF-8 与反查页（进程内只生成一次）
+ */
+inline const SbcsCodecSet& GetSbcsCodecSet() noexcept {
+    static const SbcsCodecSet set = [] {
+        SbcsCodecSet result;
+        size_t page_count = 0;
+        for (size_t c = 0; c < kSbcsCount; ++c) {
+            SbcsCodec& codec = result.codecs[c];
+            codec.decode = kSbcsDecodeTables[c];
+            for (size_t b = 0; b < 128; ++b) {
+                const uint16_t cp = codec.decode[b];
+                if (cp == kSbcsUndefined) continue;
+                codec.utf8[b][3] = static_cast<uint8_t>(EncodeUtf8(codec.utf8[b], cp) - codec.utf8[b]);
+                if (codec.page_index[cp >> 8] == 0) {
+                    codec.page_index[cp >> 8] = static_cast<uint16_t>(++page_count);
+                }
+            }
+        }
+        result.pages.assign(page_count * 256, 0);
+        for (auto& codec : result.codecs) {
+            codec.pages = result.pages.data();
+            for (size_t b = 0; b < 128; ++b) {
+                const uint16_t cp = codec.decode[b];
+                if (cp == kSbcsUndefined) continue;
+                result.pages[static_cast<size_t>(codec.page_index[cp >> 8] - 1) * 256 + (cp & 0xFF)] =
+                    static_cast<uint8_t>(0x80 + b);
+            }
+        }
+        return result;
+    }();
+    return set;
+}
+
+inline const SbcsCodec* GetSbcsCodec(EncodingId id) noexcept {
+    return IsSbcsId(id)
+        ? &GetSbcsCodecSet().codecs[static_cast<size_t>(id) - static_cast<size_t>(EncodingId::ISO8859_1)]
+        : nullptr;
+}
+
+/**
+ * @brief 前导 ASCII 段长度；先标量检查 16 字节，段足够长时才调用向量预扫描
+ */
+inline size_t SbcsAsciiRun(const uint8_t* in, size_t n) noexcept {
+    size_t run = 0;
+    while (run < n && run < 16 && in[run] < 0x80) {
+        ++run;
+    }
+    if (run == 16) {
+        run += AsciiPrefixLength(std::string_view(reinterpret_cast<const char*>(in) + 16, n - 16));
+    }
+    return run;
+}
+
+/**
+ * @brief 复制（UTF-8 / 码页输出）或加宽（UTF-16/32 输出）开头的 ASCII 段
+ * @pre in[0] < 0x80
+ * @return ASCII 段长度；out 前移到写出位置之后
+ */
+template <size_t OutBytes, bool OutBE>
+inline size_t EmitAsciiRun(const uint8_t* in, size_t n, uint8_t*& out) noexcept {
+    const size_t run = SbcsAsciiRun(in, n);
+    if constexpr (OutBytes == 1) {
+        std::memcpy(out, in, run);
+    } else {
+        const UtfSimdKernels& simd = GetUtfSimdKernels();
+        size_t done = (run >= simd.block_units) ? simd.widen_ascii[OutBytes == 4][OutBE](in, run, out) : 0;
+        for (; done < run; ++done) {
+            StoreUnit<OutBytes, OutBE>(out + done * OutBytes, in[done]);
+        }
+    }
+    out += run * OutBytes;
+    return run;
+}
+
+/**
+ * @brief 复制（UTF-8 输入）或收窄（UTF-16/32 输入）开头的 ASCII 码元到单字节输出
+ * @pre 首个码元 < 0x80
+ * @return 消费的码元数；out 前移到写出位置之后
+ */
+template <size_t InBytes, bool InBE>
+inline size_t NarrowAsciiRun(const uint8_t* in, size_t units, uint8_t*& out) noexcept {
+    if constexpr (InBytes == 1) {
+        const size_t run = SbcsAsciiRun(in, units);
+        std::memcpy(out, in, run);
+        out += run;
+        return run;
+    } else {
+        const UtfSimdKernels& simd = GetUtfSimdKernels();
+        size_t i = 0;
+        if (units >= simd.block_units) {
+            i = simd.narrow_ascii[InBytes == 4][InBE](in, units, out);
+            out += i;
+        }
+        uint32_t unit;
+        while (i < units && (unit = LoadUnit<InBytes, InBE>(in + i * InBytes)) < 0x80) {
+            *out++ = static_cast<uint8_t>(unit);
+            ++i;
+        }
+        return i;
+    }
+}
+
+/**
+ * @brief 单字节码页转码器签名（from/to 中非码页一侧为 nullptr）
+ */
+using SbcsTranscoder = ErrorCode (*)(const SbcsCodec* from, const SbcsCodec* to, const uint8_t* in, size_t n,
+                                     uint8_t* out, size_t& consumed, size_t& written) noexcept;
+
+template <size_t OutBytes, bool OutBE>
+ErrorCode TranscodeSbcsToUtf(const SbcsCodec* from, const SbcsCodec*, const uint8_t* in, size_t n,
+                             uint8_t* out, size_t& consumed, size_t& written) noexcept {
+    uint8_t* const begin = out;
+    size_t i = 0;
+    while (i < n) {
+        const uint8_t byte = in[i];
+        if (byte < 0x80) {
+            i += EmitAsciiRun<OutBytes, OutBE>(in + i, n - i, out);
+            continue;
+        }
+        const uint16_t cp = from->decode[byte - 0x80];
+        if (UNICONV_UNLIKELY(cp == kSbcsUndefined)) {
+            consumed = i;
+            written = static_cast<size_t>(out - begin);
+            return ErrorCode::InvalidSequence;
+        }
+        if constexpr (OutBytes == 1) {
+            const uint8_t* utf8 = from->utf8[byte - 0x80];
+            std::memcpy(out, utf8, 3);  // 输出上界按每字节 3 字节预留
+            out += utf8[3];
+        } else {
+            out = StoreUnit<OutBytes, OutBE>(out, cp);  // 码表只含 BMP 码点，UTF-16 无需代理对
+        }
+        ++i;
+    }
+    consumed = n;
+    written = static_cast<size_t>(out - begin);
+    return ErrorCode::Success;
+}
+
+template <size_t InBytes, bool InBE>
+ErrorCode TranscodeUtfToSbcs(const SbcsCodec*, const SbcsCodec* to, const uint8_t* in, size_t n,
+                             uint8_t* out, size_t& consumed, size_t& written) noexcept {
+    uint8_t* const begin = out;
+    const size_t units = n / InBytes;
+    size_t i = 0;
+    while (i < units) {
+        if (LoadUnit<InBytes, InBE>(in + i * InBytes) < 0x80) {
+            i += NarrowAsciiRun<InBytes, InBE>(in + i * InBytes, units - i, out);
+            continue;
+        }
+        const size_t start = i;
+        uint32_t cp;
+        ErrorCode ec;
+        if constexpr (InBytes == 1) {
+            ec = DecodeUtf8NonAscii(in, n, i, cp);
+        } else {
+            ec = DecodeWide<InBytes, InBE>(in, units, i, cp);
+        }
+        const uint8_t byte = (ec == ErrorCode::Success) ? to->Encode(cp) : 0;
+        if (UNICONV_UNLIKELY(byte == 0)) {
+            consumed = start * InBytes;
+            written = static_cast<size_t>(out - begin);
+            return ec != ErrorCode::Success ? ec : ErrorCode::InvalidSequence;
+        }
+        *out++ = byte;
+    }
+    consumed = units * InBytes;
+    written = static_cast<size_t>(out - begin);
+    return (n % InBytes != 0) ? ErrorCode::IncompleteSequence : ErrorCode::Success;
+}
+
+inline ErrorCode TranscodeSbcsToSbcs(const SbcsCodec* from, const SbcsCodec* to, const uint8_t* in, size_t n,
+                                     uint8_t* out, size_t& consumed, size_t& written) noexcept {
+    size_t i = 0;
+    while (i < n) {
+        if (in[i] < 0x80) {
+            const size_t run = SbcsAsciiRun(in + i, n - i);
+            std::memcpy(out + i, in + i, run);
+            i += run;
+            continue;
+        }
+        const uint16_t cp = from->decode[in[i] - 0x80];
+        const uint8_t byte = (cp != kSbcsUndefined) ? to->Encode(cp) : 0;
+        if (UNICONV_UNLIKELY(byte == 0)) {
+            consumed = written = i;
+            return ErrorCode::InvalidSequence;
+        }
+        out[i++] = byte;
+    }
+    consumed = written = n;
+    return ErrorCode::Success;
+}
+
+constexpr size_t kSbcsFormCount = 6;   ///< 码页转码的编码形式数，同时是 SbcsFormIndex 的"不支持"值
+
+/**
+ * @brief 码页转码的编码形式下标：0 = 单字节码页，1-5 = NativeUtfFormIndex + 1；不支持返回 kSbcsFormCount
+ */
+inline size_t SbcsFormIndex(EncodingId id) noexcept {
+    if (IsSbcsId(id)) {
+        return 0;
+    }
+    const int utf = NativeUtfFormIndex(id);
+    return utf >= 0 ? static_cast<size_t>(utf) + 1 : kSbcsFormCount;
+}
+
+constexpr SbcsTranscoder kSbcsTranscoders[kSbcsFormCount][kSbcsFormCount] = {
+    {TranscodeSbcsToSbcs,
+     TranscodeSbcsToUtf<1, false>,
+     TranscodeSbcsToUtf<2, false>, TranscodeSbcsToUtf<2, true>,
+     TranscodeSbcsToUtf<4, false>, TranscodeSbcsToUtf<4, true>},
+    {TranscodeUtfToSbcs<1, false>},
+    {TranscodeUtfToSbcs<2, false>},
+    {TranscodeUtfToSbcs<2, true>},
+    {TranscodeUtfToSbcs<4, false>},
+    {TranscodeUtfToSbcs<4, true>},
+};
+
+/**
+ * @brief 是否存在内置码页转码器（一端为单字节码页，另一端为码页或 UTF-8/16LE/16BE/32LE/32BE）
+ */
+inline bool HasSbcsKernel(EncodingId from, EncodingId to) noexcept {
+    const size_t f = SbcsFormIndex(from);
+    const size_t t = SbcsFormIndex(to);
+    return from != to && f < kSbcsFormCount && t < kSbcsFormCount && (f == 0 || t == 0);
+}
+
+/**
+ * @brief 码页转码输出字节数上界：码页字节 -> UTF-8 至多 3 字节、UTF-16 2 字节、UTF-32 4 字节、码页 1 字节；
+ *        Unicode -> 码页每个输入码元至多 1 字节
+ * @pre HasSbcsKernel(from, to)
+ */
+inline size_t SbcsOutputBound(EncodingId from, EncodingId to, size_t size) noexcept {
+    constexpr size_t kUnitBytes[kSbcsFormCount] = {1, 1, 2, 2, 4, 4};
+    constexpr size_t kFromSbcsBytes[kSbcsFormCount] = {1, 3, 2, 2, 4, 4};
+    const size_t f = SbcsFormIndex(from);
+    const size_t t = SbcsFormIndex(to);
+    if (UNICONV_UNLIKELY(f >= kSbcsFormCount || t >= kSbcsFormCount)) {
+        return std::numeric_limits<size_t>::max();
+    }
+    const size_t per_unit = (f == 0) ? kFromSbcsBytes[t] : 1;
+    const size_t in_units = size / kUnitBytes[f] + 1;
+    if (UNICONV_UNLIKELY(in_units > std::numeric_limits<size_t>::max() / per_unit)) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return in_units * per_unit;
+}
+
+//==============================================================================
+// 内置双字节码页编解码：GBK、GB2312、GB18030、Big5、Shift_JIS、EUC-JP（码表见 dbcs_tables.inc）
+//==============================================================================
+// 解码为两级表：首字节 -> 行号 -> 按尾字节取码点，没有字符的首字节共用一行全零；编码为码点高 8 位 -> 256 项页，
+// 只为出现过的页分配。单个码页的解码与编码表合计约 100KB，常驻 L2。ASCII 段与单字节码页相同，整段复制或向量
+// 加宽/收窄。码表未收录的字符（各 iconv 实现有分歧的兼容字符、用户自定义区、非法或不完整序列）逐个交给线程
+// 私有的 iconv 描述符，输出与错误码与整段走 iconv 时一致。
+
+#define UNICONV_DBCS_TABLE_BEGIN(table, lead_lo, lead_hi, trail_lo, trail_hi) \
+    constexpr uint16_t kDbcsRows_##table[] = {
+#define UNICONV_DBCS_ROW(lead, ...) lead, __VA_ARGS__,
+#define UNICONV_DBCS_TABLE_END(table) };
+#define UNICONV_DBCS_PATCH(id, first, first_cp, count)
+#define UNICONV_GB18030_RANGE(first_linear, first_cp, count)
+#include "dbcs_tables.inc"
+#undef UNICONV_DBCS_TABLE_BEGIN
+#undef UNICONV_DBCS_ROW
+#undef UNICONV_DBCS_TABLE_END
+
+/**
+ * @brief dbcs_tables.inc 中的一张基础解码表：每行为首字节 + (trail_hi - trail_lo + 1) 个码点
+ */
+struct DbcsTableData {
+    const uint16_t* rows;
+    size_t          size;
+    uint8_t         lead_lo, lead_hi, trail_lo, trail_hi;
+};
+
+enum class DbcsTableId : uint8_t {
+#define UNICONV_DBCS_TABLE_BEGIN(table, ...) table,
+#define UNICONV_DBCS_ROW(lead, ...)
+#define UNICONV_DBCS_TABLE_END(table)
+#include "dbcs_tables.inc"
+#undef UNICONV_DBCS_TABLE_BEGIN
+};
+
+constexpr DbcsTableData kDbcsTables[] = {
+#define UNICONV_DBCS_TABLE_BEGIN(table, lead_lo, lead_hi, trail_lo, trail_hi) \
+    {kDbcsRows_##table, sizeof(kDbcsRows_##table) / sizeof(uint16_t), lead_lo, lead_hi, trail_lo, trail_hi},
+#include "dbcs_tables.inc"
+#undef UNICONV_DBCS_TABLE_BEGIN
+#undef UNICONV_DBCS_ROW
+#undef UNICONV_DBCS_TABLE_END
+#undef UNICONV_DBCS_PATCH
+};
+
+/**
+ * @brief 某个编码在基础表之上的差异：first 起同一行内连续 count 个位置改为 first_cp 起的码点（0 = 不收录）
+ */
+struct DbcsPatch {
+    EncodingId id;
+    uint16_t   first;
+    uint16_t   first_cp;
+    uint16_t   count;
+};
+
+#define UNICONV_DBCS_TABLE_BEGIN(table, ...)
+#define UNICONV_DBCS_ROW(lead, ...)
+#define UNICONV_DBCS_TABLE_END(table)
+#define UNICONV_DBCS_PATCH(id, first, first_cp, count) {EncodingId::id, first, first_cp, count},
+constexpr DbcsPatch kDbcsPatches[] = {
+#include "dbcs_tables.inc"
+};
+#undef UNICONV_DBCS_PATCH
+#undef UNICONV_GB18030_RANGE
+
+/**
+ * @brief GB18030 四字节 BMP 区的一段：线性序号 linear 起 count 个序列对应 cp 起的连续码点
+ */
+struct Gb18030Range {
+    uint32_t linear;
+    uint16_t cp;
+    uint16_t count;
+};
+
+#define UNICONV_DBCS_PATCH(id, first, first_cp, count)
+#define UNICONV_GB18030_RANGE(first_linear, first_cp, count) {first_linear, first_cp, count},
+constexpr Gb18030Range kGb18030Ranges[] = {
+#include "dbcs_tables.inc"
+};
+#undef UNICONV_DBCS_TABLE_BEGIN
+#undef UNICONV_DBCS_ROW
+#undef UNICONV_DBCS_TABLE_END
+#undef UNICONV_DBCS_PATCH
+#undef UNICONV_GB18030_RANGE
+
+constexpr bool Gb18030RangesSorted() noexcept {
+    for (size_t k = 1; k < sizeof(kGb18030Ranges) / sizeof(kGb18030Ranges[0]); ++k) {
+        const Gb18030Range& prev = kGb18030Ranges[k - 1];
+        if (kGb18030Ranges[k].linear < prev.linear + prev.count || kGb18030Ranges[k].cp < prev.cp + prev.count) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(Gb18030RangesSorted(), "GB18030 ranges must ascend in both linear index and code point");
+
+constexpr uint32_t kGb18030SupplementaryLinear = 189000;  ///< 0x90308130 的线性序号，对应 U+10000
+
+/// GB18030 四字节序列的线性序号 -> 码点；0 表示码表未收录
+inline uint32_t Gb18030LinearToCodePoint(uint32_t linear) noexcept {
+    if (linear >= kGb18030SupplementaryLinear) {
+        const uint32_t offset = linear - kGb18030SupplementaryLinear;
+        return offset <= 0x10FFFF - 0x10000 ? 0x10000 + offset : 0;
+    }
+    const Gb18030Range* end = std::end(kGb18030Ranges);
+    const Gb18030Range* it = std::upper_bound(std::begin(kGb18030Ranges), end, linear,
+        [](uint32_t value, const Gb18030Range& range) { return value < range.linear; });
+    if (it == std::begin(kGb18030Ranges)) return 0;
+    --it;
+    return linear - it->linear < it->count ? it->cp + (linear - it->linear) : 0;
+}
+
+/// 码点 -> GB18030 四字节线性序号；false 表示码表未收录
+inline bool Gb18030CodePointToLinear(uint32_t cp, uint32_t& linear) noexcept {
+    if (cp >= 0x10000) {
+        linear = kGb18030SupplementaryLinear + (cp - 0x10000);
+        return true;
+    }
+    const Gb18030Range* end = std::end(kGb18030Ranges);
+    const Gb18030Range* it = std::upper_bound(std::begin(kGb18030Ranges), end, cp,
+        [](uint32_t value, const Gb18030Range& range) { return value < range.cp; });
+    if (it == std::begin(kGb18030Ranges)) return false;
+    --it;
+    if (cp - it->cp >= it->count) return false;
+    linear = it->linear + (cp - it->cp);
+    return true;
+}
+
+/**
+ * @brief 两级解码表：首字节 -> 行号（0 为全零行），行内按尾字节下标取码点（0 表示未收录）
+ */
+struct DbcsPlane {
+    uint8_t               trail_lo = 0;
+    uint8_t               trail_hi = 0;
+    size_t                span = 0;
+    uint16_t              row_of[256] = {};
+    std::vector<uint16_t> rows;
+
+    uint16_t Decode(uint8_t lead, uint8_t trail) const noexcept {
+        if (trail < trail_lo || trail > trail_hi) {
+            return 0;
+        }
+        return rows[row_of[lead] * span + (trail - trail_lo)];
+    }
+};
+
+/**
+ * @brief 把 256 x span 的完整网格压缩为解码表的行（全零行共用第 0 行）
+ */
+inline void CompactDbcsPlane(DbcsPlane& plane, const std::vector<uint16_t>& grid) {
+    plane.rows.assign(plane.span, 0);
+    for (size_t lead = 0; lead < 256; ++lead) {
+        const auto row = grid.begin() + static_cast<std::ptrdiff_t>(lead * plane.span);
+        if (std::any_of(row, row + static_cast<std::ptrdiff_t>(plane.span), [](uint16_t cp) { return cp != 0; })) {
+            plane.row_of[lead] = static_cast<uint16_t>(plane.rows.size() / plane.span);
+            plane.rows.insert(plane.rows.end(), row, row + static_cast<std::ptrdiff_t>(plane.span));
+        }
+    }
+}
+
+/**
+ * @brief 由基础表生成解码表：只保留首/尾字节不小于 lead_min/trail_min 的位置，再套用该编码的差异
+ */
+inline DbcsPlane BuildDbcsPlane(DbcsTableId table_id, EncodingId id, uint8_t lead_min, uint8_t trail_min) {
+    const DbcsTableData& table = kDbcsTables[static_cast<size_t>(table_id)];
+    const size_t table_span = static_cast<size_t>(table.trail_hi - table.trail_lo) + 1;
+
+    DbcsPlane plane;
+    plane.trail_lo = (std::max)(table.trail_lo, trail_min);
+    plane.trail_hi = table.trail_hi;
+    plane.span = static_cast<size_t>(plane.trail_hi - plane.trail_lo) + 1;
+
+    std::vector<uint16_t> grid(256 * plane.span, 0);
+    for (size_t r = 0; r + table_span < table.size + 1; r += table_span + 1) {
+        const uint8_t lead = static_cast<uint8_t>(table.rows[r]);
+        if (lead < lead_min) continue;
+        for (size_t t = plane.trail_lo - table.trail_lo; t < table_span; ++t) {
+            grid[lead * plane.span + t - (plane.trail_lo - table.trail_lo)] = table.rows[r + 1 + t];
+        }
+    }
+    for (const DbcsPatch& patch : kDbcsPatches) {
+        if (patch.id != id) continue;
+        const size_t lead = patch.first >> 8;
+        const size_t trail = (patch.first & 0xFF) - plane.trail_lo;
+        for (size_t k = 0; k < patch.count; ++k) {
+            grid[lead * plane.span + trail + k] = patch.first_cp ? static_cast<uint16_t>(patch.first_cp + k) : 0;
+        }
+    }
+
+    CompactDbcsPlane(plane, grid);
+    return plane;
+}
+
+/**
+ * @brief 单个双字节码页的解码 / 编码数据
+ * @details 编码表的值：>= 0x8000 为两字节序列（首字节 << 8 | 尾字节）；0x2100-0x7EFF 为 EUC-JP 的 JIS X 0212
+ *          （0x8F 前缀，首尾字节去掉最高位）；0x00A1-0x00DF 为 Shift_JIS 单字节半角片假名；0 表示未收录
+ */
+struct DbcsCodec {
+    DbcsPlane             main;
+    DbcsPlane             supplement;        ///< EUC-JP 的 JIS X 0212（0x8F 前缀）
+    uint16_t              page_index[256] = {};
+    std::vector<uint16_t> pages;
+
+    uint16_t Lookup(uint32_t cp) const noexcept {
+        if (cp > 0xFFFF) {
+            return 0;
+        }
+        const uint16_t page = page_index[cp >> 8];
+        return page ? pages[static_cast<size_t>(page - 1) * 256 + (cp & 0xFF)] : 0;
+    }
+};
+
+/// JIS X 0208 行/列（EUC 形式，0xA1-0xFE）-> Shift_JIS 两字节
+inline uint16_t EucJisToShiftJis(uint8_t lead, uint8_t trail) noexcept {
+    const unsigned row = lead - 0x80u;
+    const unsigned col = trail - 0x80u;
+    const unsigned s1 = ((row + 1) >> 1) + (row <= 0x5E ? 0x70 : 0xB0);
+    const unsigned s2 = col + ((row & 1) ? (col < 0x60 ? 0x1F : 0x20) : 0x7E);
+    return static_cast<uint16_t>((s1 << 8) | s2);
+}
+
+/**
+ * @brief 把 EUC 形式的 JIS X 0208 解码表换成以 Shift_JIS 首/尾字节为下标，解码时免去行列换算
+ */
+inline DbcsPlane ShiftJisPlane(const DbcsPlane& euc) {
+    DbcsPlane plane;
+    plane.trail_lo = 0x40;
+    plane.trail_hi = 0xFC;
+    plane.span = static_cast<size_t>(plane.trail_hi - plane.trail_lo) + 1;
+
+    std::vector<uint16_t> grid(256 * plane.span, 0);
+    for (size_t lead = 0; lead < 256; ++lead) {
+        if (euc.row_of[lead] == 0) continue;
+        for (size_t t = 0; t < euc.span; ++t) {
+            const uint16_t cp = euc.rows[euc.row_of[lead] * euc.span + t];
+            if (cp != 0) {
+                const uint16_t sjis = EucJisToShiftJis(static_cast<uint8_t>(lead), static_cast<uint8_t>(euc.trail_lo + t));
+                grid[(sjis >> 8) * plane.span + ((sjis & 0xFF) - plane.trail_lo)] = cp;
+            }
+        }
+    }
+    CompactDbcsPlane(plane, grid);
+    return plane;
+}
+
+inline DbcsCodec BuildDbcsCodec(EncodingId id) {
+    DbcsCodec codec;
+    switch (id) {
+        case EncodingId::GB2312:   codec.main = BuildDbcsPlane(DbcsTableId::Gbk, id, 0xA1, 0xA1); break;
+        case EncodingId::BIG5:     codec.main = BuildDbcsPlane(DbcsTableId::Big5, id, 0, 0); break;
+        case EncodingId::ShiftJIS: codec.main = ShiftJisPlane(BuildDbcsPlane(DbcsTableId::Jis0208, id, 0, 0)); break;
+        case EncodingId::EUC_JP:   codec.main = BuildDbcsPlane(DbcsTableId::Jis0208, id, 0, 0); break;
+        default:                   codec.main = BuildDbcsPlane(DbcsTableId::Gbk, id, 0, 0); break;
+    }
+    if (id == EncodingId::EUC_JP) {
+        codec.supplement = BuildDbcsPlane(DbcsTableId::Jis0212, id, 0, 0);
+    }
+
+    std::vector<std::pair<uint16_t, uint16_t>> entries;  // (码点, 编码值)
+    auto collect = [&entries](const DbcsPlane& plane, auto&& encode) {
+        for (size_t lead = 0; lead < 256; ++lead) {
+            if (plane.row_of[lead] == 0) continue;
+            for (size_t t = 0; t < plane.span; ++t) {
+                const uint16_t cp = plane.rows[plane.row_of[lead] * plane.span + t];
+                if (cp != 0) {
+                    entries.emplace_back(cp, encode(static_cast<uint8_t>(lead), static_cast<uint8_t>(plane.trail_lo + t)));
+                }
+            }
+        }
+    };
+    collect(codec.main, [](uint8_t lead, uint8_t trail) { return static_cast<uint16_t>((lead << 8) | trail); });
+    if (id == EncodingId::EUC_JP) {
+        collect(codec.supplement, [](uint8_t lead, uint8_t trail) {
+            return static_cast<uint16_t>(((lead & 0x7F) << 8) | trail);
+        });
+    }
+    if (id == EncodingId::ShiftJIS) {
+        entries.emplace_back(uint16_t(0x00A5), uint16_t(0x5C));  // JIS-Roman ¥ / ‾
+        entries.emplace_back(uint16_t(0x203E), uint16_t(0x7E));
+    }
+    if (id == EncodingId::ShiftJIS || id == EncodingId::EUC_JP) {
+        for (uint16_t k = 0; k < 0x3F; ++k) {  // 半角片假名 U+FF61-U+FF9F
+            entries.emplace_back(static_cast<uint16_t>(0xFF61 + k),
+                                 static_cast<uint16_t>(id == EncodingId::ShiftJIS ? 0xA1 + k : 0x8EA1 + k));
+        }
+    }
+
+    size_t page_count = 0;
+    for (const auto& entry : entries) {
+        if (codec.page_index[entry.first >> 8] == 0) {
+            codec.page_index[entry.first >> 8] = static_cast<uint16_t>(++page_count);
+        }
+    }
+    codec.pages.assign(page_count * 256, 0);
+    for (const auto& entry : entries) {
+        uint16_t& slot = codec.pages[static_cast<size_t>(codec.page_index[entry.first >> 8] - 1) * 256 + (entry.first & 0xFF)];
+        if (slot == 0) {
+            slot = entry.second;
+        }
+    }
+    return codec;
+}
+
+/**
+ * @brief 双字节码页在转码表中的下标；不支持返回 -1
+ */
+inline int DbcsIndex(EncodingId id) noexcept {
+    switch (id) {
+        case EncodingId::GBK:      return 0;
+        case EncodingId::GB2312:   return 1;
+        case EncodingId::GB18030:  return 2;
+        case EncodingId::BIG5:     return 3;
+        case EncodingId::ShiftJIS: return 4;
+        case EncodingId::EUC_JP:   return 5;
+        default:                   return -1;
+    }
+}
+
+/**
+ * @brief 双字节码页编解码数据（每个码页首次使用时生成一次）
+ * @pre DbcsIndex(id) >= 0
+ */
+inline const DbcsCodec& GetDbcsCodec(EncodingId id) noexcept {
+    switch (id) {
+        case EncodingId::GBK:      { static const DbcsCodec codec = BuildDbcsCodec(EncodingId::GBK); return codec; }
+        case EncodingId::GB2312:   { static const DbcsCodec codec = BuildDbcsCodec(EncodingId::GB2312); return codec; }
+        case EncodingId::GB18030:  { static const DbcsCodec codec = BuildDbcsCodec(EncodingId::GB18030); return codec; }
+        case EncodingId::BIG5:     { static const DbcsCodec codec = BuildDbcsCodec(EncodingId::BIG5); return codec; }
+        case EncodingId::ShiftJIS: { static const DbcsCodec codec = BuildDbcsCodec(EncodingId::ShiftJIS); return codec; }
+        default:                   { static const DbcsCodec codec = BuildDbcsCodec(EncodingId::EUC_JP); return codec; }
+    }
+}
+
+/**
+ * @brief Shift_JIS 单字节区的 JIS-Roman 字符：0x5C 为 ¥（U+00A5）、0x7E 为 ‾（U+203E），其余同 ASCII
+ * @note 与 iconv 的 SHIFT_JIS 一致；CP932 / EUC-JP 的 0x5C / 0x7E 仍是 ASCII
+ */
+constexpr uint32_t JisRomanToUnicode(uint8_t byte) noexcept {
+    return byte == 0x5C ? 0x00A5 : byte == 0x7E ? 0x203E : byte;
+}
+
+/**
+ * @brief 低半区中不能按 ASCII 整段复制、须逐字符解码的字节
+ */
+template <EncodingId Id>
+constexpr bool IsDbcsSpecialAscii(uint8_t byte) noexcept {
+    return Id == EncodingId::ShiftJIS && (byte == 0x5C || byte == 0x7E);
+}
+
+/**
+ * @brief 开头可按 ASCII 整段复制的长度（Shift_JIS 在 0x5C / 0x7E 处截止）
+ * @pre in[0] < 0x80 且 !IsDbcsSpecialAscii<Id>(in[0])
+ */
+template <EncodingId Id>
+inline size_t DbcsAsciiRun(const uint8_t* in, size_t n) noexcept {
+    const size_t run = SbcsAsciiRun(in, n);
+    if constexpr (Id == EncodingId::ShiftJIS) {
+        for (size_t k = 0; k < run; ++k) {
+            if (IsDbcsSpecialAscii<Id>(in[k])) {
+                return k;
+            }
+        }
+    }
+    return run;
+}
+
+/**
+ * @brief 解码一个非 ASCII 字符（Shift_JIS 还包括 JIS-Roman 的 0x5C / 0x7E）
+ * @param n 剩余输入字节数（至少 1）
+ * @param len 输出：成功时为该字符的字节数
+ * @return 码点；0 表示码表未收录（也包括非法与不完整序列），由调用方交给 iconv
+ */
+template <EncodingId Id>
+inline uint32_t DecodeDbcsChar(const DbcsCodec& codec, const uint8_t* in, size_t n, size_t& len) noexcept {
+    const uint8_t lead = in[0];
+    len = 1;
+    if constexpr (Id == EncodingId::ShiftJIS) {
+        if (lead < 0x80) {
+            return JisRomanToUnicode(lead);
+        }
+        if (lead >= 0xA1 && lead <= 0xDF) {
+            return 0xFF61 + (lead - 0xA1u);
+        }
+        if (n < 2) {
+            return 0;
+        }
+        len = 2;
+        return codec.main.Decode(lead, in[1]);
+    } else if constexpr (Id == EncodingId::EUC_JP) {
+        if (lead == 0x8F) {
+            len = (std::min)(n, size_t(3));
+            return len == 3 ? codec.supplement.Decode(in[1], in[2]) : 0;
+        }
+        if ((lead != 0x8E && lead < 0xA1) || lead == 0xFF || n < 2) {
+            return 0;
+        }
+        len = 2;
+        if (lead == 0x8E) {
+            return (in[1] >= 0xA1 && in[1] <= 0xDF) ? 0xFF61 + (in[1] - 0xA1u) : 0;
+        }
+        return codec.main.Decode(lead, in[1]);
+    } else {
+        if (lead < 0x81 || lead == 0xFF || n < 2) {
+            return 0;
+        }
+        if constexpr (Id == EncodingId::GB18030) {
+            if (in[1] >= 0x30 && in[1] <= 0x39) {
+                len = (std::min)(n, size_t(4));
+                if (len < 4 || in[2] < 0x81 || in[2] == 0xFF || in[3] < 0x30 || in[3] > 0x39) {
+                    return 0;
+                }
+                return Gb18030LinearToCodePoint(
+                    (((lead - 0x81u) * 10 + (in[1] - 0x30u)) * 126 + (in[2] - 0x81u)) * 10 + (in[3] - 0x30u));
+            }
+        }
+        len = 2;
+        return codec.main.Decode(lead, in[1]);
+    }
+}
+
+/**
+ * @brief 编码一个非 ASCII 码点
+ * @return 写出的字节数；0 表示码表未收录
+ */
+template <EncodingId Id>
+inline size_t EncodeDbcsChar(const DbcsCodec& codec, uint32_t cp, uint8_t* out) noexcept {
+    const uint16_t value = codec.Lookup(cp);
+    if (UNICONV_LIKELY(value >= 0x8000)) {
+        out[0] = static_cast<uint8_t>(value >> 8);
+        out[1] = static_cast<uint8_t>(value);
+        return 2;
+    }
+    if constexpr (Id == EncodingId::ShiftJIS) {
+        if (value != 0) {
+            out[0] = static_cast<uint8_t>(value);
+            return 1;
+        }
+    } else if constexpr (Id == EncodingId::EUC_JP) {
+        if (value != 0) {
+            out[0] = 0x8F;
+            out[1] = static_cast<uint8_t>((value >> 8) | 0x80);
+            out[2] = static_cast<uint8_t>(value);
+            return 3;
+        }
+    } else if constexpr (Id == EncodingId::GB18030) {
+        uint32_t linear;
+        if (value == 0 && Gb18030CodePointToLinear(cp, linear)) {
+            out[3] = static_cast<uint8_t>(0x30 + linear % 10); linear /= 10;
+            out[2] = static_cast<uint8_t>(0x81 + linear % 126); linear /= 126;
+            out[1] = static_cast<uint8_t>(0x30 + linear % 10); linear /= 10;
+            out[0] = static_cast<uint8_t>(0x81 + linear);
+            return 4;
+        }
+    }
+    return 0;
+}
+
+inline ErrorCode IconvErrnoToErrorCode(int err) noexcept {
+    switch (err) {
+        case E2BIG:  return ErrorCode::BufferTooSmall;
+        case EILSEQ: return ErrorCode::InvalidSequence;
+        case EINVAL: return ErrorCode::IncompleteSequence;
+        default:     return ErrorCode::ConversionFailed;
+    }
+}
+
+/**
+ * @brief 码表未收录字符回退时使用的 iconv 编码名
+ */
+inline const char* DbcsIconvName(EncodingId id) noexcept {
+    switch (id) {
+        case EncodingId::GBK:      return "GBK";
+        case EncodingId::GB2312:   return "GB2312";
+        case EncodingId::GB18030:  return "GB18030";
+        case EncodingId::BIG5:     return "BIG5";
+        case EncodingId::ShiftJIS: return "SHIFT_JIS";
+        case EncodingId::EUC_JP:   return "EUC-JP";
+        case EncodingId::UTF8:     return "UTF-8";
+        case EncodingId::UTF16LE:  return "UTF-16LE";
+        case EncodingId::UTF16BE:  return "UTF-16BE";
+        case EncodingId::UTF32LE:  return "UTF-32LE";
+        default:                   return "UTF-32BE";
+    }
+}
+
+/**
+ * @brief 逐字符回退用的线程私有 iconv 描述符，[方向][码页][UTF 形式]，首次使用时打开
+ */
+struct DbcsFallbackDescriptors {
+    iconv_t cd[2][6][5];
+
+    DbcsFallbackDescriptors() noexcept {
+        std::fill(&cd[0][0][0], &cd[0][0][0] + 2 * 6 * 5, reinterpret_cast<iconv_t>(-1));
+    }
+    ~DbcsFallbackDescriptors() {
+        std::for_each(&cd[0][0][0], &cd[0][0][0] + 2 * 6 * 5, [](iconv_t descriptor) {
+            if (descriptor != reinterpret_cast<iconv_t>(-1)) {
+                iconv_close(descriptor);
+            }
+        });
+    }
+    DbcsFallbackDescriptors(const DbcsFallbackDescriptors&) = delete;
+    DbcsFallbackDescriptors& operator=(const DbcsFallbackDescriptors&) = delete;
+};
+
+/**
+ * @brief 用 iconv 转换码表未收录的字符
+ * @param in 从该字符开始的输入，至多 4 字节（码页一侧的最长字符）；iconv 对这段字节的判定即为结果
+ * @param out 输出位置，调用方按输出上界预留
+ * @param[out] used 消费的输入字节数（至少一个完整字符）
+ * @param[out] produced 写出的字节数
+ * @return 第一个字符就无法转换时返回 iconv 的错误码
+ */
+inline ErrorCode DbcsIconvFallback(EncodingId from, EncodingId to, const uint8_t* in, size_t len,
+                                   uint8_t* out, size_t& used, size_t& produced) noexcept {
+    static thread_local DbcsFallbackDescriptors descriptors;
+    const bool decoding = DbcsIndex(from) >= 0;
+    const EncodingId dbcs = decoding ? from : to;
+    const EncodingId utf  = decoding ? to : from;
+    iconv_t& cd = descriptors.cd[decoding][DbcsIndex(dbcs)][NativeUtfFormIndex(utf)];
+    if (cd == reinterpret_cast<iconv_t>(-1)) {
+        cd = iconv_open(DbcsIconvName(to), DbcsIconvName(from));
+        if (UNICONV_UNLIKELY(cd == reinterpret_cast<iconv_t>(-1))) {
+            return ErrorCode::ConversionFailed;
+        }
+    }
+    portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+
+    const char* in_ptr = reinterpret_cast<const char*>(in);
+    size_t in_left = len;
+    char* out_ptr = reinterpret_cast<char*>(out);
+    size_t out_left = 16;
+    const size_t ret = portable_iconv(cd, &in_ptr, &in_left, &out_ptr, &out_left);
+    const int err = errno;
+    used = len - in_left;
+    produced = 16 - out_left;
+    // 其后的字节若不完整或非法，留给下一轮判断；只有一个字符都没转换时才报错
+    if (UNICONV_UNLIKELY(ret == static_cast<size_t>(-1) && used == 0)) {
+        return IconvErrnoToErrorCode(err);
+    }
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief UTF 形式（码元字节数 + 字节序）对应的 EncodingId
+ */
+template <size_t Bytes, bool BE>
+constexpr EncodingId UtfFormId() noexcept {
+    return Bytes == 1 ? EncodingId::UTF8
+         : Bytes == 2 ? (BE ? EncodingId::UTF16BE : EncodingId::UTF16LE)
+                      : (BE ? EncodingId::UTF32BE : EncodingId::UTF32LE);
+}
+
+using DbcsTranscoder = ErrorCode (*)(const DbcsCodec& codec, const uint8_t* in, size_t n, uint8_t* out,
+                                     size_t& consumed, size_t& written) noexcept;
+
+template <EncodingId Id, size_t OutBytes, bool OutBE>
+ErrorCode TranscodeDbcsToUtf(const DbcsCodec& codec, const uint8_t* in, size_t n, uint8_t* out,
+                             size_t& consumed, size_t& written) noexcept {
+    uint8_t* const begin = out;
+    size_t i = 0;
+    while (i < n) {
+        if (in[i] < 0x80 && !IsDbcsSpecialAscii<Id>(in[i])) {
+            i += EmitAsciiRun<OutBytes, OutBE>(in + i, DbcsAsciiRun<Id>(in + i, n - i), out);
+            continue;
+        }
+        size_t len;
+        const uint32_t cp = DecodeDbcsChar<Id>(codec, in + i, n - i, len);
+        if (UNICONV_LIKELY(cp != 0)) {
+            if constexpr (OutBytes == 1) {
+                out = EncodeUtf8(out, cp);
+            } else {
+                out = EncodeWide<OutBytes, OutBE>(out, cp);
+            }
+        } else {
+            size_t produced = 0;
+            const ErrorCode ec = DbcsIconvFallback(Id, UtfFormId<OutBytes, OutBE>(), in + i,
+                                                   (std::min)(n - i, size_t(4)), out, len, produced);
+            if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+                consumed = i;
+                written = static_cast<size_t>(out - begin);
+                return ec;
+            }
+            out += produced;
+        }
+        i += len;
+    }
+    consumed = n;
+    written = static_cast<size_t>(out - begin);
+    return ErrorCode::Success;
+}
+
+template <EncodingId Id, size_t InBytes, bool InBE>
+ErrorCode TranscodeUtfToDbcs(const DbcsCodec& codec, const uint8_t* in, size_t n, uint8_t* out,
+                             size_t& consumed, size_t& written) noexcept {
+    uint8_t* const begin = out;
+    const size_t units = n / InBytes;
+    size_t i = 0;
+    while (i < units) {
+        if (LoadUnit<InBytes, InBE>(in + i * InBytes) < 0x80) {
+            i += NarrowAsciiRun<InBytes, InBE>(in + i * InBytes, units - i, out);
+            continue;
+        }
+        const size_t start = i;
+        uint32_t cp;
+        ErrorCode ec;
+        if constexpr (InBytes == 1) {
+            ec = DecodeUtf8NonAscii(in, n, i, cp);
+        } else {
+            ec = DecodeWide<InBytes, InBE>(in, units, i, cp);
+        }
+        if (UNICONV_LIKELY(ec == ErrorCode::Success)) {
+            const size_t bytes = EncodeDbcsChar<Id>(codec, cp, out);
+            if (UNICONV_LIKELY(bytes != 0)) {
+                out += bytes;
+                continue;
+            }
+            size_t used = 0;
+            size_t produced = 0;
+            ec = DbcsIconvFallback(UtfFormId<InBytes, InBE>(), Id, in + start * InBytes, (i - start) * InBytes,
+                                   out, used, produced);
+            if (ec == ErrorCode::Success) {
+                out += produced;
+                continue;
+            }
+        }
+        consumed = start * InBytes;
+        written = static_cast<size_t>(out - begin);
+        return ec;
+    }
+    consumed = units * InBytes;
+    written = static_cast<size_t>(out - begin);
+    return (n % InBytes != 0) ? ErrorCode::IncompleteSequence : ErrorCode::Success;
+}
+
+#define UNICONV_DBCS_TRANSCODERS(kernel, id)                                          \
+    {kernel<EncodingId::id, 1, false>, kernel<EncodingId::id, 2, false>,              \
+     kernel<EncodingId::id, 2, true>, kernel<EncodingId::id, 4, false>,               \
+     kernel<EncodingId::id, 4, true>}
+
+/// [DbcsIndex][NativeUtfFormIndex]
+constexpr DbcsTranscoder kDbcsDecoders[6][5] = {
+    UNICONV_DBCS_TRANSCODERS(TranscodeDbcsToUtf, GBK),
+    UNICONV_DBCS_TRANSCODERS(TranscodeDbcsToUtf, GB2312),
+    UNICONV_DBCS_TRANSCODERS(TranscodeDbcsToUtf, GB18030),
+    UNICONV_DBCS_TRANSCODERS(TranscodeDbcsToUtf, BIG5),
+    UNICONV_DBCS_TRANSCODERS(TranscodeDbcsToUtf, ShiftJIS),
+    UNICONV_DBCS_TRANSCODERS(TranscodeDbcsToUtf, EUC_JP),
+};
+
+constexpr DbcsTranscoder kDbcsEncoders[6][5] = {
+    UNICONV_DBCS_TRANSCODERS(TranscodeUtfToDbcs, GBK),
+    UNICONV_DBCS_TRANSCODERS(TranscodeUtfToDbcs, GB2312),
+    UNICONV_DBCS_TRANSCODERS(TranscodeUtfToDbcs, GB18030),
+    UNICONV_DBCS_TRANSCODERS(TranscodeUtfToDbcs, BIG5),
+    UNICONV_DBCS_TRANSCODERS(TranscodeUtfToDbcs, ShiftJIS),
+    UNICONV_DBCS_TRANSCODERS(TranscodeUtfToDbcs, EUC_JP),
+};
+
+#undef UNICONV_DBCS_TRANSCODERS
+
+/**
+ * @brief 是否存在内置双字节码页转码器（一端为 GBK/GB2312/GB18030/Big5/Shift_JIS/EUC-JP，另一端为 UTF-8/16/32）
+ */
+inline bool HasDbcsKernel(EncodingId from, EncodingId to) noexcept {
+    return (DbcsIndex(from) >= 0 && NativeUtfFormIndex(to) >= 0) ||
+           (DbcsIndex(to) >= 0 && NativeUtfFormIndex(from) >= 0);
+}
+
+/**
+ * @brief 双字节码页转码输出字节数上界：码页每字节至多产生 UTF-8 3 字节、UTF-16 2 字节、UTF-32 4 字节；
+ *        UTF-8/UTF-16 每字节至多产生码页 2 字节（GB18030 四字节序列），UTF-32 每字节 1 字节；另留一个字符的余量
+ * @pre HasDbcsKernel(from, to)
+ */
+inline size_t DbcsOutputBound(EncodingId from, EncodingId to, size_t size) noexcept {
+    constexpr size_t kFromDbcs[5] = {3, 2, 2, 4, 4};
+    constexpr size_t kToDbcs[5] = {2, 2, 2, 1, 1};
+    const size_t per_byte = DbcsIndex(from) >= 0 ? kFromDbcs[NativeUtfFormIndex(to)] : kToDbcs[NativeUtfFormIndex(from)];
+    if (UNICONV_UNLIKELY(size > (std::numeric_limits<size_t>::max() - 16) / per_byte)) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return size * per_byte + 16;
+}
+
+/**
+ * @brief 是否存在任一内置内核（UTF 形式之间、单字节码页或双字节码页）
+ */
+inline bool HasNativeKernel(EncodingId from, EncodingId to) noexcept {
+    return HasNativeUtfKernel(from, to) || HasSbcsKernel(from, to) || HasDbcsKernel(from, to);
+}
+
+/**
+ * @brief 内置内核输出字节数上界
+ * @pre HasNativeKernel(from, to)
+ */
+inline size_t NativeOutputBound(EncodingId from, EncodingId to, size_t size) noexcept {
+    if (HasSbcsKernel(from, to)) {
+        return SbcsOutputBound(from, to, size);
+    }
+    return HasDbcsKernel(from, to) ? DbcsOutputBound(from, to, size) : NativeUtfOutputBound(from, to, size);
+}
+
+/**
+ * @brief 使用内置内核（UTF 形式、单字节或双字节码页）直接转换到调用方缓冲区
+ * @pre HasNativeKernel(from, to)，且 out 至少有 NativeOutputBound(from, to, size) 字节
+ * @param[out] consumed 已消费的输入字节数（失败时指向出错序列）
+ * @param[out] written 已写出的字节数
+ */
+inline ErrorCode ConvertUtfNativeInto(EncodingId from, EncodingId to, const void* data, size_t size,
+                                      void* out, size_t& consumed, size_t& written) noexcept {
+    consumed = 0;
+    written = 0;
+    if (size == 0) {
+        return ErrorCode::Success;
+    }
+    // 下标在索引前检查（HasSbcsKernel 的条件），不支持的编码形式不会落到越界下标
+    const size_t sbcs_from = SbcsFormIndex(from);
+    const size_t sbcs_to = SbcsFormIndex(to);
+    if (from != to && sbcs_from < kSbcsFormCount && sbcs_to < kSbcsFormCount && (sbcs_from == 0 || sbcs_to == 0)) {
+        return kSbcsTranscoders[sbcs_from][sbcs_to](
+            GetSbcsCodec(from), GetSbcsCodec(to), static_cast<const uint8_t*>(data), size,
+            static_cast<uint8_t*>(out), consumed, written);
+    }
+    if (HasDbcsKernel(from, to)) {
+        const DbcsTranscoder transcoder = DbcsIndex(from) >= 0
+            ? kDbcsDecoders[DbcsIndex(from)][NativeUtfFormIndex(to)]
+            : kDbcsEncoders[DbcsIndex(to)][NativeUtfFormIndex(from)];
+        return transcoder(GetDbcsCodec(DbcsIndex(from) >= 0 ? from : to), static_cast<const uint8_t*>(data), size,
+                          static_cast<uint8_t*>(out), consumed, written);
+    }
+    return kNativeUtfTranscoders[NativeUtfFormIndex(from)][NativeUtfFormIndex(to)](
+        static_cast<const uint8_t*>(data), size, static_cast<uint8_t*>(out), consumed, written);
+}
+
+/**
+ * @brief 使用内置内核转换，结果以原始字节写入 output（复用其容量）
+ * @tparam OutString std::string / std::u16string / std::u32string 等，码元宽度需与目标编码一致
+ * @param data 输入字节
+ * @param size 输入字节数
+ * @pre HasNativeKernel(from, to)
+ * @return 错误码；失败时 output 被清空
+ */
+template <typename OutString>
+ErrorCode ConvertUtfNative(EncodingId from, EncodingId to, const void* data, size_t size,
+                           OutString& output) noexcept {
+    using Unit = typename OutString::value_type;
+    if (UNICONV_UNLIKELY(!HasNativeKernel(from, to))) {
+        return ErrorCode::ConversionFailed;
+    }
+    if (size == 0) {
+        output.clear();
+        return ErrorCode::Success;
+    }
+
+    const size_t bound_bytes = NativeOutputBound(from, to, size);
+    if (UNICONV_UNLIKELY(bound_bytes == std::numeric_limits<size_t>::max())) {
+        return ErrorCode::OutOfMemory;
+    }
+    try {
+        output.resize((bound_bytes + sizeof(Unit) - 1) / sizeof(Unit));
+    } catch (...) {
+        return ErrorCode::OutOfMemory;
+    }
+
+    size_t consumed = 0;
+    size_t written = 0;
+    const ErrorCode ec = ConvertUtfNativeInto(from, to, data, size, &output[0], consumed, written);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success || written % sizeof(Unit) != 0)) {
+        output.clear();
+        return ec != ErrorCode::Success ? ec : ErrorCode::ConversionFailed;
+    }
+    output.resize(written / sizeof(Unit));
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief ConvertUtfNative 的 CompactResult 包装（供类型化便捷接口使用）
+ */
+template <typename OutString>
+CompactResult<OutString> ConvertUtfNativeResult(EncodingId from, EncodingId to, const void* data, size_t size) noexcept {
+    OutString output;
+    const ErrorCode ec = ConvertUtfNative(from, to, data, size, output);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return CompactResult<OutString>::Failure(ec);
+    }
+    return CompactResult<OutString>::Success(std::move(output));
+}
+
+//==============================================================================
+// 校验与输出长度计算（Validate / CountOutputUnits）：只读输入，不写输出
+//==============================================================================
+// 源编码逐码点解码，目标编码只计算每个码点占用的码元数。ASCII 段整段跳过（任何目标编码中一个
+// ASCII 字符都是 1 个码元）；码表与回退规则与内置转码内核完全相同，因此计数与实际转换结果一致。
+
+/**
+ * @brief 目标编码的码元字节数：UTF-16 为 2，UTF-32 为 4，其余按字节计
+ */
+inline size_t OutputUnitBytes(EncodingId id) noexcept {
+    switch (id) {
+        case EncodingId::UTF16:
+        case EncodingId::UTF16LE:
+        case EncodingId::UTF16BE: return 2;
+        case EncodingId::UTF32:
+        case EncodingId::UTF32LE:
+        case EncodingId::UTF32BE: return 4;
+        default:                  return 1;
+    }
+}
+
+/// 目标为 UTF-8/16/32：码点 -> 码元数（OutBytes 为码元字节数）
+template <size_t OutBytes>
+struct UtfUnitCounter {
+    static constexpr bool kByLength = true;  ///< 码元数只取决于 UTF-8 序列长度，可不组装码点
+
+    size_t operator()(uint32_t cp) const noexcept {
+        if constexpr (OutBytes == 1) {
+            return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        } else if constexpr (OutBytes == 2) {
+            return cp < 0x10000 ? 1 : 2;
+        } else {
+            return 1;
+        }
+    }
+
+    /// 长度为 Length 的 UTF-8 序列对应的码元数
+    template <size_t Length>
+    static constexpr size_t ByLength() noexcept {
+        return OutBytes == 1 ? Length : (OutBytes == 2 && Length == 4 ? 2 : 1);
+    }
+};
+
+/// 目标为单字节码页：可映射为 1，否则 0
+struct SbcsUnitCounter {
+    static constexpr bool kByLength = false;
+    const SbcsCodec* codec;
+
+    size_t operator()(uint32_t cp) const noexcept {
+        return (cp < 0x80 || codec->Encode(cp) != 0) ? 1 : 0;
+    }
+};
+
+using DbcsCharEncoder = size_t (*)(const DbcsCodec&, uint32_t, uint8_t*) noexcept;
+
+/// [DbcsIndex]
+constexpr DbcsCharEncoder kDbcsCharEncoders[6] = {
+    EncodeDbcsChar<EncodingId::GBK>, EncodeDbcsChar<EncodingId::GB2312>, EncodeDbcsChar<EncodingId::GB18030>,
+    EncodeDbcsChar<EncodingId::BIG5>, EncodeDbcsChar<EncodingId::ShiftJIS>, EncodeDbcsChar<EncodingId::EUC_JP>,
+};
+
+/// 目标为双字节码页：码表未收录的码点与转码内核一样逐字符交给 iconv
+struct DbcsUnitCounter {
+    static constexpr bool kByLength = false;
+    const DbcsCodec* codec;
+    DbcsCharEncoder  encode;
+    EncodingId       id;
+
+    size_t operator()(uint32_t cp) const noexcept {
+        if (cp < 0x80) {
+            return 1;
+        }
+        uint8_t buffer[16];
+        const size_t bytes = encode(*codec, cp, buffer);
+        if (UNICONV_LIKELY(bytes != 0)) {
+            return bytes;
+        }
+        uint8_t utf8[4];
+        const size_t len = static_cast<size_t>(EncodeUtf8(utf8, cp) - utf8);
+        size_t used = 0;
+        size_t produced = 0;
+        return DbcsIconvFallback(EncodingId::UTF8, id, utf8, len, buffer, used, produced) == ErrorCode::Success
+            ? produced : 0;
+    }
+};
+
+/**
+ * @brief 计数用的源编码：UTF-8
+ * @details IsAscii() 判断位置处的码元，AsciiRun() 返回 ASCII 段的字节数；Next() 解码位置 i 处的
+ *          一个非 ASCII 字符并累加目标码元数，出错时 i 的值无意义（调用方记录字符起始位置），
+ *          无法映射到目标编码时返回 InvalidSequence
+ */
+struct Utf8CountSource {
+    static constexpr size_t kUnitBytes = 1;
+
+    bool IsAscii(const uint8_t* p) const noexcept { return p[0] < 0x80; }
+    size_t AsciiRun(const uint8_t* in, size_t n) const noexcept { return SbcsAsciiRun(in, n); }
+
+    template <typename Counter>
+    ErrorCode Next(const uint8_t* in, size_t n, size_t& i, const Counter& counter, size_t& units) const noexcept {
+        if constexpr (Counter::kByLength) {
+            // 常见的两字节与三字节字符（不含 E0 / ED 的特殊下界）只检查续字节，不组装码点
+            const uint8_t lead = in[i];
+            if (lead >= 0xE1 && lead != 0xED && lead <= 0xEF && n - i >= 3 &&
+                ((in[i + 1] & 0xC0) == 0x80) & ((in[i + 2] & 0xC0) == 0x80)) {
+                units += Counter::template ByLength<3>();
+                i += 3;
+                return ErrorCode::Success;
+            }
+            if (lead >= 0xC2 && lead <= 0xDF && n - i >= 2 && (in[i + 1] & 0xC0) == 0x80) {
+                units += Counter::template ByLength<2>();
+                i += 2;
+                return ErrorCode::Success;
+            }
+        }
+        uint32_t cp;
+        const ErrorCode ec = DecodeUtf8NonAscii(in, n, i, cp);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return ec;
+        }
+        const size_t produced = counter(cp);
+        units += produced;
+        return produced != 0 ? ErrorCode::Success : ErrorCode::InvalidSequence;
+    }
+};
+
+/// 计数用的源编码：UTF-16/32（i 以字节计）
+template <size_t Bytes, bool BigEndian>
+struct WideCountSource {
+    static constexpr size_t kUnitBytes = Bytes;
+
+    bool IsAscii(const uint8_t* p) const noexcept { return LoadUnit<Bytes, BigEndian>(p) < 0x80; }
+    size_t AsciiRun(const uint8_t* in, size_t n) const noexcept {
+        const size_t units = n / Bytes;
+        size_t i = 0;
+        // 16 个码元一组做无分支检查（可被编译器向量化），含非 ASCII 的组再逐个推进
+        for (; i + 16 <= units; i += 16) {
+            uint32_t any = 0;
+            for (size_t k = 0; k < 16; ++k) {
+                any |= LoadUnit<Bytes, BigEndian>(in + (i + k) * Bytes);
+            }
+            if (any >= 0x80) {
+                break;
+            }
+        }
+        while (i < units && LoadUnit<Bytes, BigEndian>(in + i * Bytes) < 0x80) {
+            ++i;
+        }
+        return i * Bytes;
+    }
+
+    template <typename Counter>
+    ErrorCode Next(const uint8_t* in, size_t n, size_t& i, const Counter& counter, size_t& units) const noexcept {
+        size_t unit = i / Bytes;
+        uint32_t cp;
+        const ErrorCode ec = DecodeWide<Bytes, BigEndian>(in, n / Bytes, unit, cp);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return ec;
+        }
+        i = unit * Bytes;
+        const size_t produced = counter(cp);
+        units += produced;
+        return produced != 0 ? ErrorCode::Success : ErrorCode::InvalidSequence;
+    }
+};
+
+/// 计数用的源编码：单字节码页
+struct SbcsCountSource {
+    static constexpr size_t kUnitBytes = 1;
+    const SbcsCodec* codec;
+
+    bool IsAscii(const uint8_t* p) const noexcept { return p[0] < 0x80; }
+    size_t AsciiRun(const uint8_t* in, size_t n) const noexcept { return SbcsAsciiRun(in, n); }
+
+    template <typename Counter>
+    ErrorCode Next(const uint8_t* in, size_t, size_t& i, const Counter& counter, size_t& units) const noexcept {
+        const uint16_t cp = codec->decode[in[i] - 0x80];
+        if (UNICONV_UNLIKELY(cp == kSbcsUndefined)) {
+            return ErrorCode::InvalidSequence;
+        }
+        const size_t produced = counter(cp);
+        units += produced;
+        ++i;
+        return produced != 0 ? ErrorCode::Success : ErrorCode::InvalidSequence;
+    }
+};
+
+/// 计数用的源编码：双字节码页（码表未收录的字符交给 iconv 解码为 UTF-32 后再计数）
+template <EncodingId Id>
+struct DbcsCountSource {
+    static constexpr size_t kUnitBytes = 1;
+    const DbcsCodec* codec;
+
+    bool IsAscii(const uint8_t* p) const noexcept { return p[0] < 0x80 && !IsDbcsSpecialAscii<Id>(p[0]); }
+    size_t AsciiRun(const uint8_t* in, size_t n) const noexcept { return DbcsAsciiRun<Id>(in, n); }
+
+    template <typename Counter>
+    ErrorCode Next(const uint8_t* in, size_t n, size_t& i, const Counter& counter, size_t& units) const noexcept {
+        size_t len;
+        const uint32_t cp = DecodeDbcsChar<Id>(*codec, in + i, n - i, len);
+        if (UNICONV_LIKELY(cp != 0)) {
+            const size_t produced = counter(cp);
+            units += produced;
+            i += len;
+            return produced != 0 ? ErrorCode::Success : ErrorCode::InvalidSequence;
+        }
+        uint8_t buffer[16];
+        size_t produced = 0;
+        const ErrorCode ec = DbcsIconvFallback(Id, EncodingId::UTF32LE, in + i, (std::min)(n - i, size_t(4)),
+                                               buffer, len, produced);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return ec;
+        }
+        for (size_t k = 0; k + 4 <= produced; k += 4) {
+            const size_t count = counter(LoadUnit<4, false>(buffer + k));
+            if (UNICONV_UNLIKELY(count == 0)) {
+                return ErrorCode::InvalidSequence;
+            }
+            units += count;
+        }
+        i += len;
+        return ErrorCode::Success;
+    }
+};
+
+/**
+ * @brief 计数驱动：ASCII 段整段跳过，其余逐字符解码
+ * @param[out] units 目标码元数（失败时为出错字符之前部分的码元数）
+ * @param[out] consumed 失败时为出错字符的起始字节，成功时为 n
+ */
+template <typename Source, typename Counter>
+ErrorCode CountUnitsWith(const Source& source, const Counter& counter, const uint8_t* in, size_t n,
+                         size_t& units, size_t& consumed) noexcept {
+    constexpr size_t kUnit = Source::kUnitBytes;
+    const size_t limit = n - n % kUnit;
+    size_t i = 0;
+    while (i < limit) {
+        if (source.IsAscii(in + i)) {
+            const size_t run = source.AsciiRun(in + i, limit - i);
+            units += run / kUnit;
+            i += run;
+            continue;
+        }
+        const size_t start = i;
+        const ErrorCode ec = source.Next(in, limit, i, counter, units);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            consumed = start;
+            return ec;
+        }
+    }
+    consumed = limit;
+    return (n % kUnit != 0) ? ErrorCode::IncompleteSequence : ErrorCode::Success;
+}
+
+/**
+ * @brief 可由内置码表逐码点解码/编码的编码形式（UTF-8/16LE/16BE/32LE/32BE、单字节与双字节码页）
+ */
+inline bool HasNativeCodec(EncodingId id) noexcept {
+    return NativeUtfFormIndex(id) >= 0 || IsSbcsId(id) || DbcsIndex(id) >= 0;
+}
+
+template <typename Source>
+ErrorCode CountUnitsTo(const Source& source, EncodingId to, const uint8_t* in, size_t n,
+                       size_t& units, size_t& consumed) noexcept {
+    if (IsSbcsId(to)) {
+        return CountUnitsWith(source, SbcsUnitCounter{GetSbcsCodec(to)}, in, n, units, consumed);
+    }
+    if (DbcsIndex(to) >= 0) {
+        const DbcsUnitCounter counter{&GetDbcsCodec(to), kDbcsCharEncoders[DbcsIndex(to)], to};
+        return CountUnitsWith(source, counter, in, n, units, consumed);
+    }
+    switch (OutputUnitBytes(to)) {
+        case 1:  return CountUnitsWith(source, UtfUnitCounter<1>{}, in, n, units, consumed);
+        case 2:  return CountUnitsWith(source, UtfUnitCounter<2>{}, in, n, units, consumed);
+        default: return CountUnitsWith(source, UtfUnitCounter<4>{}, in, n, units, consumed);
+    }
+}
+
+template <EncodingId Id>
+ErrorCode CountDbcsUnits(EncodingId to, const uint8_t* in, size_t n, size_t& units, size_t& consumed) noexcept {
+    return CountUnitsTo(DbcsCountSource<Id>{&GetDbcsCodec(Id)}, to, in, n, units, consumed);
+}
+
+/**
+ * @brief 用内置码表计算 from -> to 的输出码元数（不写输出）
+ * @pre HasNativeCodec(from) && HasNativeCodec(to)
+ */
+inline ErrorCode CountNativeUnits(EncodingId from, EncodingId to, const uint8_t* in, size_t n,
+                                  size_t& units, size_t& consumed) noexcept {
+    units = 0;
+    consumed = 0;
+#ifdef UNICONV_HAS_SIMDUTF
+    // 合法输入由 simdutf 一次向量化校验 + 计长；出错时回到逐字符路径以给出错误位置
+    const char* data = reinterpret_cast<const char*>(in);
+    if (from == EncodingId::UTF8 && (to == EncodingId::UTF16LE || to == EncodingId::UTF16BE) &&
+        simdutf::validate_utf8(data, n)) {
+        units = simdutf::utf16_length_from_utf8(data, n);
+        consumed = n;
+        return ErrorCode::Success;
+    }
+    if (to == EncodingId::UTF8 && (from == EncodingId::UTF16LE || from == EncodingId::UTF16BE) && n % 2 == 0) {
+        const auto* wide = reinterpret_cast<const char16_t*>(in);
+        const bool big_endian = from == EncodingId::UTF16BE;
+        if (big_endian ? simdutf::validate_utf16be(wide, n / 2) : simdutf::validate_utf16le(wide, n / 2)) {
+            units = big_endian ? simdutf::utf8_length_from_utf16be(wide, n / 2)
+                               : simdutf::utf8_length_from_utf16le(wide, n / 2);
+            consumed = n;
+            return ErrorCode::Success;
+        }
+    }
+#endif // UNICONV_HAS_SIMDUTF
+    if (IsSbcsId(from)) {
+        return CountUnitsTo(SbcsCountSource{GetSbcsCodec(from)}, to, in, n, units, consumed);
+    }
+    switch (from) {
+        case EncodingId::GBK:      return CountDbcsUnits<EncodingId::GBK>(to, in, n, units, consumed);
+        case EncodingId::GB2312:   return CountDbcsUnits<EncodingId::GB2312>(to, in, n, units, consumed);
+        case EncodingId::GB18030:  return CountDbcsUnits<EncodingId::GB18030>(to, in, n, units, consumed);
+        case EncodingId::BIG5:     return CountDbcsUnits<EncodingId::BIG5>(to, in, n, units, consumed);
+        case EncodingId::ShiftJIS: return CountDbcsUnits<EncodingId::ShiftJIS>(to, in, n, units, consumed);
+        case EncodingId::EUC_JP:   return CountDbcsUnits<EncodingId::EUC_JP>(to, in, n, units, consumed);
+        case EncodingId::UTF8:     return CountUnitsTo(Utf8CountSource{}, to, in, n, units, consumed);
+        case EncodingId::UTF16LE:  return CountUnitsTo(WideCountSource<2, false>{}, to, in, n, units, consumed);
+        case EncodingId::UTF16BE:  return CountUnitsTo(WideCountSource<2, true>{}, to, in, n, units, consumed);
+        case EncodingId::UTF32LE:  return CountUnitsTo(WideCountSource<4, false>{}, to, in, n, units, consumed);
+        default:                   return CountUnitsTo(WideCountSource<4, true>{}, to, in, n, units, consumed);
+    }
+}
+
+//==============================================================================
+// 容错转换（ErrorPolicy::Replace / Skip）：坏序列之后续接，已转换的前缀不重做
+//==============================================================================
+
+/**
+ * @brief 非法或不完整序列需要跳过的字节数（至少 1 个码元）
+ * @details UTF-8 按 Unicode 推荐的“最大子部分”处理：首字节与其后仍可能合法的续字节算作一个坏序列，
+ *          不会吞掉紧随其后的合法字符；UTF-16/32 跳过一个码元；码页跳过一个字节（尾字节可能是 ASCII）
+ */
+inline size_t IllFormedLength(EncodingId from, const uint8_t* in, size_t n) noexcept {
+    if (from != EncodingId::UTF8) {
+        return (std::min)(n, OutputUnitBytes(from));
+    }
+    const uint8_t lead = in[0];
+    size_t length;
+    uint8_t lower = 0x80, upper = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) lower = 0xA0;
+        if (lead == 0xED) upper = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) lower = 0x90;
+        if (lead == 0xF4) upper = 0x8F;
+    } else {
+        return 1;
+    }
+    size_t k = 1;
+    while (k < length && k < n && in[k] >= lower && in[k] <= upper) {
+        lower = 0x80;
+        upper = 0xBF;
+        ++k;
+    }
+    return k;
+}
+
+/**
+ * @brief 带 BOM 的 UTF-16/UTF-32 目标（iconv 每次调用都会重新写出 BOM）开头的 BOM 字节数
+ */
+inline size_t LeadingBomBytes(EncodingId to, const char* data, size_t size) noexcept {
+    const auto* p = reinterpret_cast<const uint8_t*>(data);
+    if (to == EncodingId::UTF16 && size >= 2 &&
+        ((p[0] == 0xFE && p[1] == 0xFF) || (p[0] == 0xFF && p[1] == 0xFE))) {
+        return 2;
+    }
+    if (to == EncodingId::UTF32 && size >= 4 &&
+        ((p[0] == 0 && p[1] == 0 && p[2] == 0xFE && p[3] == 0xFF) ||
+         (p[0] == 0xFF && p[1] == 0xFE && p[2] == 0 && p[3] == 0))) {
+        return 4;
+    }
+    return 0;
+}
+
+//==============================================================================
+// 编码检测（DetectEncoding）：只扫描有限前缀，每个候选编码一个模型
+//==============================================================================
+//
+// ASCII 段对所有 ASCII 兼容候选都是单字节字符，由向量预扫描整段跳过；每个模型只逐个处理高位字节。
+// 多字节模型分两层：结构校验（非法序列直接淘汰候选），以及统计“高频字符”命中率——频率表在码点空间定义，
+// 经内置码表换算成各码页的编码值，因此同一份中文/日文频率表可用于多个码页。单字节模型按字母大小写形态打分：
+// 误判的码页会产生大量非字母符号、词中突然出现的大写字母或与 ASCII 字母混排的非拉丁字母。
+
+/// 简体中文高频字与全角标点（按码点排序）
+constexpr uint16_t kDetectHanziSimplified[] = {
+    0x201C, 0x201D, 0x3001, 0x3002, 0x4E00, 0x4E0A, 0x4E0B, 0x4E0D, 0x4E2A, 0x4E2D, 0x4E3A, 0x4E4B,
+    0x4E5F, 0x4E86, 0x4E8E, 0x4EBA, 0x4ED6, 0x4EE5, 0x4EEC, 0x4F1A, 0x4F5C, 0x4F60, 0x51FA, 0x5230,
+    0x53D1, 0x53EF, 0x540E, 0x548C, 0x56FD, 0x5728, 0x5730, 0x5927, 0x5B50, 0x5BF9, 0x5C31, 0x5E74,
+    0x5F97, 0x6211, 0x65F6, 0x662F, 0x6709, 0x6765, 0x751F, 0x7684, 0x7740, 0x800C, 0x80FD, 0x81EA,
+    0x8981, 0x8BF4, 0x8FC7, 0x8FD9, 0x90A3, 0x91CC, 0xFF01, 0xFF0C, 0xFF1A, 0xFF1F,
+};
+
+/// 繁体中文高频字与全角标点（按码点排序）
+constexpr uint16_t kDetectHanziTraditional[] = {
+    0x201C, 0x201D, 0x3001, 0x3002, 0x300C, 0x300D, 0x4E00, 0x4E0A, 0x4E0B, 0x4E0D, 0x4E2D, 0x4E4B,
+    0x4E5F, 0x4E86, 0x4EBA, 0x4ED6, 0x4EE5, 0x4F5C, 0x4F60, 0x4F86, 0x500B, 0x5011, 0x51FA, 0x5230,
+    0x53EF, 0x548C, 0x570B, 0x5728, 0x5730, 0x5927, 0x5B50, 0x5C0D, 0x5C31, 0x5E74, 0x5F8C, 0x5F97,
+    0x6211, 0x65BC, 0x662F, 0x6642, 0x6703, 0x6709, 0x70BA, 0x751F, 0x767C, 0x7684, 0x800C, 0x80FD,
+    0x81EA, 0x8457, 0x88E1, 0x8981, 0x8AAA, 0x9019, 0x904E, 0x90A3, 0xFF01, 0xFF0C, 0xFF1A, 0xFF1F,
+};
+
+/// 韩文高频音节的 EUC-KR 编码（이 다 는 에 의 가 고 하 지 을 를 서 한 로 기 어 도 사 나 수 리 인 대 일 ...，按值排序）
+constexpr uint16_t kDetectHangulEucKr[] = {
+    0xB0A1, 0xB0CD, 0xB0D4, 0xB0ED, 0xB1D7, 0xB1E2, 0xB3AA, 0xB4C2, 0xB4D9, 0xB4EB, 0xB5B5, 0xB5E9,
+    0xB6F3, 0xB7CE, 0xB8A6, 0xB8AE, 0xB8B8, 0xBAB8, 0xBBE7, 0xBCAD, 0xBCF6, 0xBDC3, 0xBEC6, 0xBEEE,
+    0xBFA1, 0xBFE4, 0xBFF8, 0xC0B8, 0xC0BB, 0xC0C7, 0xC0CC, 0xC0CE, 0xC0CF, 0xC0D6, 0xC0DA, 0xC1A4,
+    0xC1D6, 0xC1F6, 0xC7CF, 0xC7D1, 0xC7D8,
+};
+
+/// 候选编码；顺序即置信度相同时的优先顺序
+enum class DetectCandidate : uint8_t {
+    UTF8, GBK, GB18030, BIG5, ShiftJIS, EUC_JP, EUC_KR,
+    CP1252, CP1250, CP1251, KOI8_R, CP1253,
+    Count
+};
+
+constexpr size_t kDetectMultiByteCount = static_cast<size_t>(DetectCandidate::CP1252);
+constexpr size_t kDetectCandidateCount = static_cast<size_t>(DetectCandidate::Count);
+constexpr size_t kDetectSbcsCount = kDetectCandidateCount - kDetectMultiByteCount;
+
+constexpr const char* kDetectCandidateNames[kDetectCandidateCount] = {
+    "UTF-8", "GBK", "GB18030", "BIG5", "SHIFT_JIS", "EUC-JP", "EUC-KR",
+    "CP1252", "CP1250", "CP1251", "KOI8-R", "CP1253",
+};
+
+constexpr EncodingId kDetectSbcsIds[kDetectSbcsCount] = {
+    EncodingId::Windows1252, EncodingId::Windows1250, EncodingId::Windows1251, EncodingId::KOI8_R,
+    EncodingId::Windows1253,
+};
+
+/// 单字节模型使用的字符形态
+enum class DetectLetter : uint8_t { Other, Lower, Upper };
+
+/**
+ * @brief 码点的大小写形态（覆盖 Latin-1、Latin Extended-A、希腊文、西里尔文；其余视为符号）
+ */
+inline DetectLetter DetectLetterClass(uint32_t cp) noexcept {
+    if (cp < 0x80) {
+        if (cp >= 'a' && cp <= 'z') return DetectLetter::Lower;
+        if (cp >= 'A' && cp <= 'Z') return DetectLetter::Upper;
+        return DetectLetter::Other;
+    }
+    if (cp >= 0xC0 && cp <= 0xFF) {
+        if (cp == 0xD7 || cp == 0xF7) return DetectLetter::Other;
+        return cp < 0xDF ? DetectLetter::Upper : DetectLetter::Lower;
+    }
+    if (cp >= 0x100 && cp <= 0x17F) {
+        const bool odd_upper = (cp >= 0x139 && cp <= 0x148) || cp >= 0x179;
+        if (cp == 0x178) return DetectLetter::Upper;
+        return ((cp & 1) != 0) == odd_upper ? DetectLetter::Upper : DetectLetter::Lower;
+    }
+    if (cp >= 0x386 && cp <= 0x3CE) {
+        if (cp == 0x387) return DetectLetter::Other;
+        return cp <= 0x3AB ? DetectLetter::Upper : DetectLetter::Lower;
+    }
+    if (cp >= 0x400 && cp <= 0x45F) {
+        return cp < 0x430 ? DetectLetter::Upper : DetectLetter::Lower;
+    }
+    if (cp >= 0x460 && cp <= 0x4FF) {
+        return (cp & 1) ? DetectLetter::Lower : DetectLetter::Upper;
+    }
+    return DetectLetter::Other;
+}
+
+/// 单字节模型的高位字节分类：低 2 位为 DetectLetter，其余为标志
+constexpr uint8_t kDetectNonLatin = 0x04;  ///< 非拉丁字母（希腊文、西里尔文）
+constexpr uint8_t kDetectInvalid = 0x08;   ///< 未定义或 C1 控制字符：出现即淘汰
+
+/**
+ * @brief 检测用的预计算数据（进程内只生成一次）
+ * @details 高频字符表在码点空间定义，由内置码表的编码方向换算成各码页的两字节值位图，
+ *          扫描时每个字符只需一次位测试；单字节码页的 128 个高位字节预先分类。
+ */
+struct DetectTables {
+    std::vector<uint64_t> hits[kDetectMultiByteCount];  ///< 两字节值（首字节 << 8 | 尾字节）-> 是否高频字符
+    uint8_t               sbcs[kDetectSbcsCount][128] = {};
+
+    bool Hit(size_t model, uint32_t value) const noexcept {
+        const auto& bits = hits[model];
+        return !bits.empty() && ((bits[value >> 6] >> (value & 63)) & 1);
+    }
+};
+
+inline const DetectTables& GetDetectTables() noexcept {
+    static const DetectTables tables = [] {
+        DetectTables result;
+        auto mark = [&result](DetectCandidate candidate, uint32_t value) {
+            auto& bits = result.hits[static_cast<size_t>(candidate)];
+            if (bits.empty()) bits.assign(65536 / 64, 0);
+            bits[value >> 6] |= uint64_t(1) << (value & 63);
+        };
+        auto mark_code_points = [&mark](DetectCandidate candidate, EncodingId id, auto&& code_points) {
+            const DbcsCodec& codec = GetDbcsCodec(id);
+            for (const uint32_t cp : code_points) {
+                const uint16_t value = codec.Lookup(cp);
+                if (value >= 0x8000) mark(candidate, value);
+            }
+        };
+        mark_code_points(DetectCandidate::GBK, EncodingId::GBK, kDetectHanziSimplified);
+        mark_code_points(DetectCandidate::GB18030, EncodingId::GB18030, kDetectHanziSimplified);
+        mark_code_points(DetectCandidate::BIG5, EncodingId::BIG5, kDetectHanziTraditional);
+        std::vector<uint32_t> kana = {0x3001, 0x3002, 0x30FC};  // 、。ー 与平假名、片假名
+        for (uint32_t cp = 0x3041; cp <= 0x30FA; ++cp) kana.push_back(cp);
+        mark_code_points(DetectCandidate::ShiftJIS, EncodingId::ShiftJIS, kana);
+        mark_code_points(DetectCandidate::EUC_JP, EncodingId::EUC_JP, kana);
+        for (const uint16_t value : kDetectHangulEucKr) mark(DetectCandidate::EUC_KR, value);
+
+        for (size_t k = 0; k < kDetectSbcsCount; ++k) {
+            const SbcsCodec& codec = *GetSbcsCodec(kDetectSbcsIds[k]);
+            for (size_t b = 0; b < 128; ++b) {
+                const uint16_t cp = codec.decode[b];
+                if (cp == kSbcsUndefined || (cp >= 0x80 && cp <= 0x9F)) {
+                    result.sbcs[k][b] = kDetectInvalid;
+                    continue;
+                }
+                const DetectLetter cls = DetectLetterClass(cp);
+                result.sbcs[k][b] = static_cast<uint8_t>(
+                    static_cast<uint8_t>(cls) | (cls != DetectLetter::Other && cp >= 0x250 ? kDetectNonLatin : 0));
+            }
+        }
+        return result;
+    }();
+    return tables;
+}
+
+/**
+ * @brief 多字节候选在当前位置的一个非 ASCII 字符（结构校验）
+ * @param value 输出：两字节字符的值（首字节 << 8 | 尾字节），其它长度为 0
+ * @return 字符长度；0 表示非法序列，SIZE_MAX 表示序列在输入末尾不完整
+ */
+template <DetectCandidate Candidate>
+inline size_t DetectMultiByteChar(const uint8_t* in, size_t n, uint32_t& value) noexcept {
+    constexpr size_t kIncomplete = std::numeric_limits<size_t>::max();
+    auto in_range = [](uint8_t b, uint8_t lo, uint8_t hi) { return b >= lo && b <= hi; };
+    const uint8_t lead = in[0];
+    value = 0;
+    switch (Candidate) {
+        case DetectCandidate::UTF8: {
+            size_t i = 0;
+            uint32_t cp = 0;
+            const ErrorCode ec = DecodeUtf8NonAscii(in, n, i, cp);
+            if (ec == ErrorCode::Success) return i;
+            return ec == ErrorCode::IncompleteSequence ? kIncomplete : 0;
+        }
+        case DetectCandidate::GBK:
+        case DetectCandidate::GB18030:
+            if (lead == 0x80 && Candidate == DetectCandidate::GBK) return 1;  // 单字节欧元符号
+            if (!in_range(lead, 0x81, 0xFE)) return 0;
+            if (n < 2) return kIncomplete;
+            if (Candidate == DetectCandidate::GB18030 && in_range(in[1], 0x30, 0x39)) {
+                if (n < 4) return kIncomplete;
+                return in_range(in[2], 0x81, 0xFE) && in_range(in[3], 0x30, 0x39) ? 4 : 0;
+            }
+            if (!in_range(in[1], 0x40, 0xFE) || in[1] == 0x7F) return 0;
+            break;
+        case DetectCandidate::BIG5:
+            if (!in_range(lead, 0xA1, 0xF9)) return 0;
+            if (n < 2) return kIncomplete;
+            if (!in_range(in[1], 0x40, 0x7E) && !in_range(in[1], 0xA1, 0xFE)) return 0;
+            break;
+        case DetectCandidate::ShiftJIS:
+            if (in_range(lead, 0xA1, 0xDF)) return 1;  // 半角片假名
+            if (!in_range(lead, 0x81, 0x9F) && !in_range(lead, 0xE0, 0xFC)) return 0;
+            if (n < 2) return kIncomplete;
+            if (!in_range(in[1], 0x40, 0xFC) || in[1] == 0x7F) return 0;
+            break;
+        case DetectCandidate::EUC_JP:
+            if (lead == 0x8F) {
+                if (n < 3) return kIncomplete;
+                return in_range(in[1], 0xA1, 0xFE) && in_range(in[2], 0xA1, 0xFE) ? 3 : 0;
+            }
+            if (lead != 0x8E && !in_range(lead, 0xA1, 0xFE)) return 0;
+            if (n < 2) return kIncomplete;
+            if (!in_range(in[1], 0xA1, lead == 0x8E ? 0xDF : 0xFE)) return 0;
+            break;
+        case DetectCandidate::EUC_KR:
+            if (!in_range(lead, 0xA1, 0xFE)) return 0;
+            if (n < 2) return kIncomplete;
+            if (!in_range(in[1], 0xA1, 0xFE)) return 0;
+            break;
+        default:
+            return 0;
+    }
+    value = static_cast<uint32_t>(lead) << 8 | in[1];
+    return 2;
+}
+
+/// 单个候选的扫描结果
+struct DetectState {
+    uint32_t bytes = 0;    ///< 非 ASCII 字符占用的字节数
+    uint32_t chars = 0;    ///< 非 ASCII 字符数
+    float    score = 0;    ///< 多字节：高频字符命中数；单字节：形态得分
+    bool     alive = true; ///< 出现非法序列即淘汰
+};
+
+/**
+ * @brief 用一个多字节模型扫描整个 probe
+ * @details 每个模型独立扫描（而不是逐字节轮流推进全部模型）：状态留在寄存器里，ASCII 段整段跳过，
+ *          遇到非法序列立即退出，误判的模型通常只付出前几个字符的代价。
+ */
+template <DetectCandidate Candidate>
+inline DetectState DetectMultiByteModel(const DetectTables& tables, const uint8_t* in, size_t n,
+                                        bool truncated) noexcept {
+    constexpr size_t k = static_cast<size_t>(Candidate);
+    DetectState state;
+    uint32_t hits = 0;
+    size_t i = 0;
+    while (i < n) {
+        if (in[i] < 0x80) {
+            i += AsciiPrefixLength(std::string_view(reinterpret_cast<const char*>(in) + i, n - i));
+            continue;
+        }
+        uint32_t value = 0;
+        const size_t len = DetectMultiByteChar<Candidate>(in + i, n - i, value);
+        if (UNICONV_UNLIKELY(len == std::numeric_limits<size_t>::max())) {
+            state.alive = truncated;
+            break;
+        }
+        if (UNICONV_UNLIKELY(len == 0)) {
+            state.alive = false;
+            return state;
+        }
+        ++state.chars;
+        state.bytes += static_cast<uint32_t>(len);
+        hits += tables.Hit(k, value);
+        i += len;
+    }
+    state.score = static_cast<float>(hits);
+    return state;
+}
+
+/// 证据量折扣：非 ASCII 字节越多越可信
+inline float DetectEvidence(uint32_t count, float half) noexcept {
+    return static_cast<float>(count) / (static_cast<float>(count) + half);
+}
+
+/**
+ * @brief 单字节模型处理一个高位字节的得分（以 1/4 分为单位）
+ * @param cls 该字节在此码页中的分类
+ * @param prev 前一个字符的字母形态（前一字节为 ASCII 时取 ASCII 字母形态）
+ * @param ascii_neighbor 前后是否紧贴 ASCII 字母
+ * @param prev_high 前一字节是否也是高位字节
+ */
+constexpr int8_t DetectSbcsScore(uint8_t cls, DetectLetter prev, bool ascii_neighbor, bool prev_high) noexcept {
+    const auto letter = static_cast<DetectLetter>(cls & 3);
+    if (letter == DetectLetter::Other) {
+        return 1;  // 标点、货币等符号
+    }
+    if ((cls & kDetectNonLatin) && ascii_neighbor) {
+        return -12;  // 非拉丁字母紧贴 ASCII 字母
+    }
+    if (letter == DetectLetter::Upper) {
+        return prev == DetectLetter::Lower ? -12 : (prev == DetectLetter::Upper ? 2 : 4);  // 词中大写
+    }
+    // 拉丁文本中带变音符的字母很少连续出现
+    return (!(cls & kDetectNonLatin) && prev_high && prev != DetectLetter::Other) ? 1 : 4;
+}
+
+/**
+ * @brief DetectSbcsScore 的查表形式，下标见 DetectSbcsScoreIndex()
+ * @details 误判码页的高位字节分类近似随机，按分支打分会频繁预测失败，因此整张表预先算好
+ */
+struct DetectSbcsScoreTable {
+    int8_t score[128] = {};
+
+    constexpr DetectSbcsScoreTable() noexcept {
+        for (unsigned index = 0; index < 128; ++index) {
+            score[index] = DetectSbcsScore(static_cast<uint8_t>(index & 7), static_cast<DetectLetter>((index >> 4) & 3),
+                                           (index >> 3) & 1, (index >> 6) & 1);
+        }
+    }
+};
+
+constexpr DetectSbcsScoreTable kDetectSbcsScores{};
+
+constexpr unsigned DetectSbcsScoreIndex(uint8_t cls, DetectLetter prev, bool ascii_neighbor, bool prev_high) noexcept {
+    return (cls & 7u) | (unsigned(ascii_neighbor) << 3) | (unsigned(prev) << 4) | (unsigned(prev_high) << 6);
+}
+
+/// ASCII 字节的字母形态（非 ASCII 为 Other）
+struct DetectAsciiLetterTable {
+    DetectLetter letter[256] = {};
+
+    constexpr DetectAsciiLetterTable() noexcept {
+        for (unsigned b = 'a'; b <= 'z'; ++b) letter[b] = DetectLetter::Lower;
+        for (unsigned b = 'A'; b <= 'Z'; ++b) letter[b] = DetectLetter::Upper;
+    }
+};
+
+constexpr DetectAsciiLetterTable kDetectAsciiLetters{};
+
+/**
+ * @brief UTF-8 模型；启用 simdutf 时先做向量化校验，合法输入只需再数一遍首字节
+ * @note probe 被截断时末尾可能切断一个字符，校验失败后回到逐字符模型（末尾不完整不淘汰）
+ */
+inline DetectState DetectUtf8Model(const DetectTables& tables, const uint8_t* in, size_t n, bool truncated) noexcept {
+#ifdef UNICONV_HAS_SIMDUTF
+    if (simdutf::validate_utf8(reinterpret_cast<const char*>(in), n)) {
+        DetectState state;
+        for (size_t i = 0; i < n; ++i) {
+            state.chars += in[i] >= 0xC0;
+        }
+        return state;
+    }
+#endif
+    return DetectMultiByteModel<DetectCandidate::UTF8>(tables, in, n, truncated);
+}
+
+/**
+ * @brief 用一个单字节码页模型扫描整个 probe
+ * @param classes 该码页 128 个高位字节的分类
+ */
+inline DetectState DetectSbcsModel(const uint8_t (&classes)[128], const uint8_t* in, size_t n) noexcept {
+    DetectState state;
+    int32_t score = 0;  // 以 1/4 分为单位
+    DetectLetter last = DetectLetter::Other;
+    size_t i = 0;
+    while (i < n) {
+        if (in[i] < 0x80) {
+            i += AsciiPrefixLength(std::string_view(reinterpret_cast<const char*>(in) + i, n - i));
+            continue;
+        }
+        const uint8_t cls = classes[in[i] - 0x80];
+        if (UNICONV_UNLIKELY(cls & kDetectInvalid)) {
+            state.alive = false;
+            return state;
+        }
+        const bool prev_high = i > 0 && in[i - 1] >= 0x80;
+        const DetectLetter prev_ascii = i > 0 ? kDetectAsciiLetters.letter[in[i - 1]] : DetectLetter::Other;
+        const DetectLetter next_ascii = i + 1 < n ? kDetectAsciiLetters.letter[in[i + 1]] : DetectLetter::Other;
+        const bool ascii_neighbor = prev_ascii != DetectLetter::Other || next_ascii != DetectLetter::Other;
+        score += kDetectSbcsScores.score[
+            DetectSbcsScoreIndex(cls, prev_high ? last : prev_ascii, ascii_neighbor, prev_high)];
+        last = static_cast<DetectLetter>(cls & 3);
+        ++state.chars;
+        ++i;
+    }
+    state.bytes = state.chars;
+    state.score = static_cast<float>(score) * 0.25f;
+    return state;
+}
+
+/**
+ * @brief 对 probe 运行全部 ASCII 兼容候选的模型（不含 BOM 与 UTF-16/32 判断）
+ * @param truncated probe 是否只是输入的前缀（末尾的不完整序列不淘汰候选）
+ * @param[out] confidence 各候选的置信度（0 表示淘汰或无证据）
+ * @return probe 是否全部为 ASCII
+ */
+inline bool DetectAsciiCompatible(const uint8_t* in, size_t n, bool truncated,
+                                  float (&confidence)[kDetectCandidateCount]) noexcept {
+    if (AsciiPrefixLength(std::string_view(reinterpret_cast<const char*>(in), n)) == n) {
+        std::fill(std::begin(confidence), std::end(confidence), 0.0f);
+        return true;
+    }
+    const DetectTables& tables = GetDetectTables();
+    const DetectState states[kDetectCandidateCount] = {
+        DetectUtf8Model(tables, in, n, truncated),
+        DetectMultiByteModel<DetectCandidate::GBK>(tables, in, n, truncated),
+        DetectMultiByteModel<DetectCandidate::GB18030>(tables, in, n, truncated),
+        DetectMultiByteModel<DetectCandidate::BIG5>(tables, in, n, truncated),
+        DetectMultiByteModel<DetectCandidate::ShiftJIS>(tables, in, n, truncated),
+        DetectMultiByteModel<DetectCandidate::EUC_JP>(tables, in, n, truncated),
+        DetectMultiByteModel<DetectCandidate::EUC_KR>(tables, in, n, truncated),
+        DetectSbcsModel(tables.sbcs[0], in, n),
+        DetectSbcsModel(tables.sbcs[1], in, n),
+        DetectSbcsModel(tables.sbcs[2], in, n),
+        DetectSbcsModel(tables.sbcs[3], in, n),
+        DetectSbcsModel(tables.sbcs[4], in, n),
+    };
+    static_assert(kDetectSbcsCount == 5, "DetectAsciiCompatible lists every single-byte model");
+
+    for (size_t k = 0; k < kDetectCandidateCount; ++k) {
+        const DetectState& state = states[k];
+        float value = 0.0f;
+        if (state.alive && state.chars > 0) {
+            const float rate = state.score / static_cast<float>(state.chars);
+            if (k == static_cast<size_t>(DetectCandidate::UTF8)) {
+                value = DetectEvidence(state.chars, 0.25f);
+            } else if (k < kDetectMultiByteCount) {
+                value = 0.95f * DetectEvidence(state.bytes, 4.0f) * (std::min)(1.0f, rate / 0.2f);
+                if (k == static_cast<size_t>(DetectCandidate::GB18030)) {
+                    value *= 0.98f;  // 仅当 GBK 被淘汰（出现四字节序列）时才排在 GBK 之前
+                }
+            } else {
+                value = 0.9f * DetectEvidence(state.bytes, 4.0f) * (std::max)(0.0f, (std::min)(1.0f, rate));
+            }
+        }
+        confidence[k] = value;
+    }
+    return false;
+}
+
+/**
+ * @brief 无 BOM 的 UTF-16/32 判断：按位置统计 NUL 字节（拉丁文本的高位字节几乎全为 0）
+ * @return 命中时的编码名，否则 nullptr
+ */
+inline const char* DetectWideByNulPattern(const uint8_t* in, size_t n, float& confidence) noexcept {
+    size_t zeros[4] = {};
+    for (size_t i = 0; i < n; ++i) {
+        zeros[i & 3] += in[i] == 0;
+    }
+    if (n >= 4 && n % 4 == 0) {
+        const size_t units = n / 4;
+        if (zeros[2] == units && zeros[3] == units && zeros[0] * 2 < units) {
+            confidence = 0.95f;
+            return "UTF-32LE";
+        }
+        if (zeros[0] == units && zeros[1] == units && zeros[3] * 2 < units) {
+            confidence = 0.95f;
+            return "UTF-32BE";
+        }
+    }
+    if (n >= 2) {
+        const size_t units = n / 2;
+        const size_t even = zeros[0] + zeros[2];
+        const size_t odd = zeros[1] + zeros[3];
+        if (odd * 2 >= units && even * 10 < units) {
+            confidence = 0.9f * static_cast<float>(odd) / static_cast<float>(units);
+            return "UTF-16LE";
+        }
+        if (even * 2 >= units && odd * 10 < units) {
+            confidence = 0.9f * static_cast<float>(even) / static_cast<float>(units);
+            return "UTF-16BE";
+        }
+    }
+    return nullptr;
+}
+
+//==============================================================================
+// Unicode 正规化（NFC / NFKC，数据见 norm_tables.inc）
+//==============================================================================
+//
+// 每个码点一个 16 位属性：[0..7] 规范组合类 | [8..9] NFC_QC | [10..11] NFKC_QC | [12] 有规范分解 | [13] 有兼容分解。
+// 属性按 256 码点一页两级查表，全零页共用；分解与合成表在首次使用时由 norm_tables.inc 生成。
+// 快速检查沿用 UAX #15：全部码点 QC = Yes 且非零组合类不降序即已正规化。“边界”是组合类为 0 且 QC = Yes 的码点：
+// 它既不会与前面的字符合成，也挡住后面的字符与更前面的字符合成，因此两个边界之间的片段可以独立正规化。
+
+constexpr uint32_t kNormCccRanges[][3] = {
+#define UNICONV_NORM_CCC(first, last, ccc) {first, last, ccc},
+#define UNICONV_NORM_QC(first, last, nfc, nfkc)
+#define UNICONV_NORM_DECOMP(cp, compat, count, ...)
+#define UNICONV_NORM_COMPOSE(first, second, composite)
+#include "norm_tables.inc"
+#undef UNICONV_NORM_COMPOSE
+#undef UNICONV_NORM_DECOMP
+#undef UNICONV_NORM_QC
+#undef UNICONV_NORM_CCC
+};
+
+constexpr uint32_t kNormQcRanges[][4] = {
+#define UNICONV_NORM_CCC(first, last, ccc)
+#define UNICONV_NORM_QC(first, last, nfc, nfkc) {first, last, nfc, nfkc},
+#define UNICONV_NORM_DECOMP(cp, compat, count, ...)
+#define UNICONV_NORM_COMPOSE(first, second, composite)
+#include "norm_tables.inc"
+#undef UNICONV_NORM_COMPOSE
+#undef UNICONV_NORM_DECOMP
+#undef UNICONV_NORM_QC
+#undef UNICONV_NORM_CCC
+};
+
+/// 分解表展开：每项为 cp, (compat << 8) | count, 随后 count 个码点
+constexpr uint32_t kNormDecompositionData[] = {
+#define UNICONV_NORM_CCC(first, last, ccc)
+#define UNICONV_NORM_QC(first, last, nfc, nfkc)
+#define UNICONV_NORM_DECOMP(cp, compat, count, ...) cp, (compat << 8) | count, __VA_ARGS__,
+#define UNICONV_NORM_COMPOSE(first, second, composite)
+#include "norm_tables.inc"
+#undef UNICONV_NORM_COMPOSE
+#undef UNICONV_NORM_DECOMP
+#undef UNICONV_NORM_QC
+#undef UNICONV_NORM_CCC
+};
+
+constexpr uint32_t kNormCompositions[][3] = {
+#define UNICONV_NORM_CCC(first, last, ccc)
+#define UNICONV_NORM_QC(first, last, nfc, nfkc)
+#define UNICONV_NORM_DECOMP(cp, compat, count, ...)
+#define UNICONV_NORM_COMPOSE(first, second, composite) {first, second, composite},
+#include "norm_tables.inc"
+#undef UNICONV_NORM_COMPOSE
+#undef UNICONV_NORM_DECOMP
+#undef UNICONV_NORM_QC
+#undef UNICONV_NORM_CCC
+};
+
+constexpr uint16_t kNormQcYes = 0, kNormQcMaybe = 1;
+constexpr unsigned kNormQcShiftNfc = 8, kNormQcShiftNfkc = 10;
+constexpr uint16_t kNormHasCanonical = 1u << 12;
+constexpr uint16_t kNormHasCompat    = 1u << 13;
+
+// 谚文音节按算法分解 / 合成（Unicode 第 3.12 节）
+constexpr uint32_t kHangulSBase = 0xAC00, kHangulLBase = 0x1100, kHangulVBase = 0x1161, kHangulTBase = 0x11A7;
+constexpr uint32_t kHangulLCount = 19, kHangulVCount = 21, kHangulTCount = 28;
+constexpr uint32_t kHangulSCount = kHangulLCount * kHangulVCount * kHangulTCount;
+
+struct NormDecomposition {
+    uint32_t cp;
+    uint32_t offset;  ///< kNormDecompositionData 中首个分解码点的下标
+    uint32_t length;
+};
+
+struct NormData {
+    std::vector<uint16_t>          pageIndex;      ///< cp >> 8 → 属性页（0 为全零页）
+    std::vector<uint16_t>          props;          ///< 属性页 * 256 + (cp & 0xFF)
+    std::vector<NormDecomposition> canonical;      ///< 按 cp 升序
+    std::vector<NormDecomposition> compatibility;  ///< 按 cp 升序
+    std::vector<uint64_t>          compositionKeys;  ///< (first << 21) | second，升序
+    std::vector<uint32_t>          composites;
+
+    uint16_t& Slot(uint32_t cp) {
+        uint16_t& page = pageIndex[cp >> 8];
+        if (page == 0) {
+            page = static_cast<uint16_t>(props.size() >> 8);
+            props.resize(props.size() + 256, 0);
+        }
+        return props[(static_cast<size_t>(page) << 8) | (cp & 0xFF)];
+    }
+};
+
+NormData BuildNormData() {
+    NormData data;
+    data.pageIndex.assign(0x110000 >> 8, 0);
+    data.props.assign(256, 0);
+    for (const auto& r : kNormCccRanges) {
+        for (uint32_t cp = r[0]; cp <= r[1]; ++cp) {
+            data.Slot(cp) |= static_cast<uint16_t>(r[2]);
+        }
+    }
+    for (const auto& r : kNormQcRanges) {
+        for (uint32_t cp = r[0]; cp <= r[1]; ++cp) {
+            data.Slot(cp) |= static_cast<uint16_t>((r[2] << kNormQcShiftNfc) | (r[3] << kNormQcShiftNfkc));
+        }
+    }
+    constexpr size_t kDataSize = sizeof(kNormDecompositionData) / sizeof(kNormDecompositionData[0]);
+    for (size_t i = 0; i < kDataSize;) {
+        const uint32_t cp = kNormDecompositionData[i];
+        const bool compat = (kNormDecompositionData[i + 1] >> 8) != 0;
+        const uint32_t length = kNormDecompositionData[i + 1] & 0xFF;
+        (compat ? data.compatibility : data.canonical).push_back({cp, static_cast<uint32_t>(i + 2), length});
+        data.Slot(cp) |= compat ? kNormHasCompat : kNormHasCanonical;
+        i += 2 + length;
+    }
+    for (const auto& c : kNormCompositions) {
+        data.compositionKeys.push_back((static_cast<uint64_t>(c[0]) << 21) | c[1]);
+        data.composites.push_back(c[2]);
+    }
+    return data;
+}
+
+inline const NormData& GetNormData() {
+    static const NormData data = BuildNormData();
+    return data;
+}
+
+inline uint16_t NormProps(const NormData& data, uint32_t cp) noexcept {
+    return data.props[(static_cast<size_t>(data.pageIndex[cp >> 8]) << 8) | (cp & 0xFF)];
+}
+
+inline bool IsNormBoundary(uint16_t props, unsigned qc_shift) noexcept {
+    return (props & 0xFF) == 0 && ((props >> qc_shift) & 3) == kNormQcYes;
+}
+
+inline unsigned NormQcShift(NormalizationForm form) noexcept {
+    return form == NormalizationForm::NFKC ? kNormQcShiftNfkc : kNormQcShiftNfc;
+}
+
+/**
+ * @brief 快速检查：找到首个未通过检查的码点所在片段的起点
+ * @param[out] start 片段起点（前一个边界）；全部通过时为 n；UTF-8 非法时为出错位置
+ * @return Success，或 InvalidSequence / IncompleteSequence
+ */
+ErrorCode FindNormSegment(const NormData& data, const uint8_t* p, size_t n, NormalizationForm form,
+                          size_t& start) noexcept {
+    const unsigned shift = NormQcShift(form);
+    size_t i = 0;
+    size_t boundary = 0;
+    uint8_t prev_ccc = 0;
+    while (i < n) {
+        const uint8_t lead = p[i];
+        if (lead < 0x80) {
+            i += AsciiPrefixLength(std::string_view(reinterpret_cast<const char*>(p + i), n - i));
+            boundary = i - 1;
+            prev_ccc = 0;
+            continue;
+        }
+        // U+4000-U+9FFF 的汉字全部是边界：只校验续字节，不查表
+        if (lead >= 0xE4 && lead <= 0xE9 && i + 2 < n && (p[i + 1] & 0xC0) == 0x80 && (p[i + 2] & 0xC0) == 0x80) {
+            boundary = i;
+            prev_ccc = 0;
+            i += 3;
+            continue;
+        }
+        const size_t at = i;
+        uint32_t cp = 0;
+        const ErrorCode ec = DecodeUtf8NonAscii(p, n, i, cp);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            start = at;
+            return ec;
+        }
+        const uint16_t props = NormProps(data, cp);
+        const uint8_t ccc = static_cast<uint8_t>(props & 0xFF);
+        if (IsNormBoundary(props, shift)) {
+            boundary = at;
+            prev_ccc = 0;
+            continue;
+        }
+        if (((props >> shift) & 3) != kNormQcYes || (ccc != 0 && prev_ccc > ccc)) {
+            start = boundary;
+            return ErrorCode::Success;
+        }
+        prev_ccc = ccc;
+    }
+    start = n;
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief from 之后（含 from）的下一个边界；没有则为 n
+ */
+size_t NextNormBoundary(const NormData& data, const uint8_t* p, size_t from, size_t n, unsigned shift) noexcept {
+    size_t i = from;
+    while (i < n) {
+        if (p[i] < 0x80) {
+            return i;
+        }
+        const size_t at = i;
+        uint32_t cp = 0;
+        if (DecodeUtf8NonAscii(p, n, i, cp) != ErrorCode::Success || IsNormBoundary(NormProps(data, cp), shift)) {
+            return at;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief [begin, end) 中最后一个边界的位置（其后的片段可能与后续输入合成）；没有则为 begin
+ */
+size_t LastNormBoundary(const NormData& data, const uint8_t* p, size_t begin, size_t end,
+                        NormalizationForm form) noexcept {
+    const unsigned shift = NormQcShift(form);
+    for (size_t i = end; i > begin;) {
+        --i;
+        if ((p[i] & 0xC0) == 0x80) {
+            continue;
+        }
+        if (p[i] < 0x80) {
+            return i;
+        }
+        size_t j = i;
+        uint32_t cp = 0;
+        const ErrorCode ec = DecodeUtf8NonAscii(p, end, j, cp);
+        // 末尾被窗口截断的序列不是边界：它可能是组合符，须与前面的字符一起留到下一窗口
+        if (ec == ErrorCode::IncompleteSequence) {
+            continue;
+        }
+        if (ec != ErrorCode::Success || IsNormBoundary(NormProps(data, cp), shift)) {
+            return i;
+        }
+    }
+    return begin;
+}
+
+inline const NormDecomposition* FindNormDecomposition(const std::vector<NormDecomposition>& table,
+                                                      uint32_t cp) noexcept {
+    const auto it = std::lower_bound(table.begin(), table.end(), cp,
+                                     [](const NormDecomposition& d, uint32_t value) { return d.cp < value; });
+    return (it != table.end() && it->cp == cp) ? &*it : nullptr;
+}
+
+inline uint32_t ComposeNormPair(const NormData& data, uint32_t first, uint32_t second) noexcept {
+    if (first - kHangulLBase < kHangulLCount && second - kHangulVBase < kHangulVCount) {
+        return kHangulSBase + ((first - kHangulLBase) * kHangulVCount + (second - kHangulVBase)) * kHangulTCount;
+    }
+    if (first - kHangulSBase < kHangulSCount && (first - kHangulSBase) % kHangulTCount == 0 &&
+        second - kHangulTBase - 1 < kHangulTCount - 1) {
+        return first + (second - kHangulTBase);
+    }
+    const uint64_t key = (static_cast<uint64_t>(first) << 21) | second;
+    const auto it = std::lower_bound(data.compositionKeys.begin(), data.compositionKeys.end(), key);
+    if (it == data.compositionKeys.end() || *it != key) {
+        return 0;
+    }
+    return data.composites[static_cast<size_t>(it - data.compositionKeys.begin())];
+}
+
+/**
+ * @brief 正规化一个片段（分解 → 规范排序 → 规范合成），结果追加到 out
+ * @param units 暂存区：码点 | (组合类 << 24)
+ */
+template <typename ByteString>
+ErrorCode NormalizeNormSegment(const NormData& data, const uint8_t* p, size_t n, NormalizationForm form,
+                               ByteString& out, std::vector<uint32_t>& units) {
+    units.clear();
+    auto push = [&](uint32_t cp) {
+        units.push_back(cp | (static_cast<uint32_t>(NormProps(data, cp) & 0xFF) << 24));
+    };
+    for (size_t i = 0; i < n;) {
+        uint32_t cp = p[i];
+        if (cp < 0x80) {
+            ++i;
+        } else {
+            const ErrorCode ec = DecodeUtf8NonAscii(p, n, i, cp);
+            if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+                return ec;
+            }
+        }
+        if (cp - kHangulSBase < kHangulSCount) {
+            const uint32_t index = cp - kHangulSBase;
+            push(kHangulLBase + index / (kHangulVCount * kHangulTCount));
+            push(kHangulVBase + (index % (kHangulVCount * kHangulTCount)) / kHangulTCount);
+            if (index % kHangulTCount != 0) {
+                push(kHangulTBase + index % kHangulTCount);
+            }
+            continue;
+        }
+        const uint16_t props = NormProps(data, cp);
+        const NormDecomposition* d = nullptr;
+        if (form == NormalizationForm::NFKC && (props & kNormHasCompat)) {
+            d = FindNormDecomposition(data.compatibility, cp);
+        } else if (props & kNormHasCanonical) {
+            d = FindNormDecomposition(data.canonical, cp);
+        }
+        if (d) {
+            for (uint32_t k = 0; k < d->length; ++k) {
+                push(kNormDecompositionData[d->offset + k]);
+            }
+        } else {
+            push(cp);
+        }
+    }
+
+    // 规范排序：非零组合类的连续段按组合类稳定插入排序
+    for (size_t i = 1; i < units.size(); ++i) {
+        const uint32_t unit = units[i];
+        const uint32_t ccc = unit >> 24;
+        if (ccc == 0) {
+            continue;
+        }
+        size_t j = i;
+        while (j > 0 && (units[j - 1] >> 24) > ccc) {
+            units[j] = units[j - 1];
+            --j;
+        }
+        units[j] = unit;
+    }
+
+    // 规范合成：与最近的起始字符合成，除非中间有组合类为 0 或不小于当前字符的字符阻断
+    size_t starter = 0;
+    uint32_t last_ccc = (units.front() >> 24) == 0 ? 0 : 256;
+    size_t kept = 1;
+    for (size_t i = 1; i < units.size(); ++i) {
+        const uint32_t cp = units[i] & 0xFFFFFF;
+        const uint32_t ccc = units[i] >> 24;
+        // last_ccc == 0 表示紧邻起始字符（两个起始字符也可合成，如谚文 L + V）
+        if (last_ccc < ccc || last_ccc == 0) {
+            const uint32_t composite = ComposeNormPair(data, units[starter] & 0xFFFFFF, cp);
+            if (composite != 0) {
+                units[starter] = composite;  // 合成结果的组合类恒为 0
+                continue;
+            }
+        }
+        if (ccc == 0) {
+            starter = kept;
+        }
+        last_ccc = ccc;
+        units[kept++] = units[i];
+    }
+
+    uint8_t buffer[4];
+    for (size_t i = 0; i < kept; ++i) {
+        const uint8_t* end = EncodeUtf8(buffer, units[i] & 0xFFFFFF);
+        out.append(reinterpret_cast<const char*>(buffer), static_cast<size_t>(end - buffer));
+    }
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief 正规化 [p, p + n) 并追加到 out：通过快速检查的部分原样复制，只重写未通过的片段
+ */
+template <typename ByteString>
+ErrorCode AppendNormalizedUtf8(const NormData& data, const uint8_t* p, size_t n, NormalizationForm form,
+                               ByteString& out, std::vector<uint32_t>& units) {
+    const unsigned shift = NormQcShift(form);
+    size_t i = 0;
+    while (i < n) {
+        size_t start = 0;
+        ErrorCode ec = FindNormSegment(data, p + i, n - i, form, start);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return ec;
+        }
+        out.append(reinterpret_cast<const char*>(p + i), start);
+        i += start;
+        if (i == n) {
+            break;
+        }
+        // 片段：起点之后的第一个边界为止（起点自身是边界，或位于文本开头）
+        size_t first = i;
+        uint32_t cp = p[i];
+        if (cp < 0x80) {
+            ++first;
+        } else if ((ec = DecodeUtf8NonAscii(p, n, first, cp)) != ErrorCode::Success) {
+            return ec;
+        }
+        const size_t end = NextNormBoundary(data, p, first, n, shift);
+        ec = NormalizeNormSegment(data, p + i, end - i, form, out, units);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return ec;
+        }
+        i = end;
+    }
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief 原地正规化 buf 的 [begin, end) 区间（begin 位于边界或文本开头，end 位于边界或文本结尾）
+ * @param[in,out] end 区间结尾，返回正规化后的结尾
+ * @param[in,out] used buf 中有效字节数；[end, used) 的内容随区间长度变化整体平移
+ * @details 快速检查通过时不写任何字节；否则只把首个未通过的片段之后的部分重写到 scratch 再拷回。
+ */
+template <typename ByteString>
+ErrorCode NormalizeUtf8Range(ByteString& buf, size_t begin, size_t& end, size_t& used, NormalizationForm form,
+                             std::string& scratch, std::vector<uint32_t>& units) noexcept {
+    const NormData& data = GetNormData();
+    const auto* p = reinterpret_cast<const uint8_t*>(buf.data());
+    size_t start = 0;
+    ErrorCode ec = FindNormSegment(data, p + begin, end - begin, form, start);
+    if (ec != ErrorCode::Success || start == end - begin) {
+        return ec;
+    }
+    start += begin;
+    try {
+        scratch.clear();
+        ec = AppendNormalizedUtf8(data, p + start, end - start, form, scratch, units);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return ec;
+        }
+        const size_t new_end = start + scratch.size();
+        const size_t new_used = used - end + new_end;
+        if (buf.size() < new_used) {
+            buf.resize((std::max)(buf.size() * 2, new_used));
+        }
+        char* data_ptr = &buf[0];
+        if (new_end != end && used > end) {
+            std::memmove(data_ptr + new_end, data_ptr + end, used - end);
+        }
+        std::memcpy(data_ptr + start, scratch.data(), scratch.size());
+        end = new_end;
+        used = new_used;
+    } catch (...) {
+        return ErrorCode::OutOfMemory;
+    }
+    return ErrorCode::Success;
+}
+
+#if UNICONV_ENABLE_METRICS
+// ===== 转换指标（UNICONV_ENABLE_METRICS）=====
+//  每个线程一个分片：序列只由所属线程插入（插入、快照与重置在分片锁下互斥），计数器只由所属
+//  线程写入（relaxed load + store，无 lock 前缀指令），快照线程只读。重置不改写计数器，而是在
+//  分片锁下记录基线，快照报告与基线之差。线程退出时分片并入 retired 汇总，快照仍能看到其计数。
+//  计时只读原始计数器（x86 不变 TSC / AArch64 虚拟计数器，否则 steady_clock 纳秒），
+//  换算系数在快照时由与 steady_clock 同步记录的起点标定。
+
+struct MetricsCounters {
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t ticks = 0;
+    std::array<uint64_t, PairMetrics::LATENCY_BUCKETS> buckets{};
+};
+
+struct MetricsSeries {
+    uint64_t                key = 0;
+    std::string             from;
+    std::string             to;
+    ConversionPath          path = ConversionPath::Copy;
+    std::atomic<uint64_t>   calls{0};
+    std::atomic<uint64_t>   errors{0};
+    std::atomic<uint64_t>   bytesIn{0};
+    std::atomic<uint64_t>   bytesOut{0};
+    std::atomic<uint64_t>   ticks{0};
+    std::array<std::atomic<uint64_t>, PairMetrics::LATENCY_BUCKETS> buckets{};
+    MetricsCounters         baseline;  // ResetConversionMetrics() 时的读数（分片锁保护）
+
+    /// 当前读数减去基线
+    MetricsCounters Read() const noexcept {
+        MetricsCounters c;
+        c.calls    = calls.load(std::memory_order_relaxed) - baseline.calls;
+        c.errors   = errors.load(std::memory_order_relaxed) - baseline.errors;
+        c.bytesIn  = bytesIn.load(std::memory_order_relaxed) - baseline.bytesIn;
+        c.bytesOut = bytesOut.load(std::memory_order_relaxed) - baseline.bytesOut;
+        c.ticks    = ticks.load(std::memory_order_relaxed) - baseline.ticks;
+        for (size_t i = 0; i < PairMetrics::LATENCY_BUCKETS; ++i) {
+            c.buckets[i] = buckets[i].load(std::memory_order_relaxed) - baseline.buckets[i];
+        }
+        return c;
+    }
+};
+
+struct MetricsShard {
+    std::mutex                                       mutex;   // 保护 series 的增长与基线（快照 / 重置 / 插入）
+    std::deque<MetricsSeries>                        series;  // 元素地址稳定
+    std::unordered_map<uint64_t, MetricsSeries*>     index;   // 只由所属线程访问（retired 分片由注册表锁保护）
+    std::array<MetricsSeries*, 8>                    recent{};  // 按名称指针直接映射的最近序列，命中时免哈希
+};
+
+/// 原始计时计数器与 steady_clock 的同步起点
+struct MetricsClock {
+    bool     fastTicks = false;
+    uint64_t ticks0 = 0;
+    uint64_t nanoseconds0 = 0;
+};
+
+inline uint64_t SteadyNanoseconds() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline uint64_t ReadFastTicks() noexcept {
+#if defined(UNICONV_NATIVE_SIMD_X86)
+    return __rdtsc();
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && (defined(__GNUC__) || defined(__clang__))
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+/// TSC 只在不变（CPUID 0x80000007 EDX[8]）时可用于计时；AArch64 虚拟计数器恒定频率
+bool HasFastTicks() noexcept {
+#if defined(UNICONV_NATIVE_SIMD_X86) && defined(_MSC_VER)
+    int regs[4] = {0};
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned>(regs[0]) < 0x80000007u) {
+        return false;
+    }
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8)) != 0;
+#elif defined(UNICONV_NATIVE_SIMD_X86)
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (edx & (1u << 8)) != 0;
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && (defined(__GNUC__) || defined(__clang__))
+    return true;
+#else
+    return false;
+#endif
+}
+
+const MetricsClock& GetMetricsClock() noexcept {
+    static const MetricsClock clock = [] {
+        MetricsClock c;
+        c.fastTicks    = HasFastTicks();
+        c.nanoseconds0 = SteadyNanoseconds();
+        c.ticks0       = c.fastTicks ? ReadFastTicks() : c.nanoseconds0;
+        return c;
+    }();
+    return clock;
+}
+
+inline uint64_t MetricsTicks() noexcept {
+    const MetricsClock& clock = GetMetricsClock();
+    return clock.fastTicks ? ReadFastTicks() : SteadyNanoseconds();
+}
+
+/// 每秒计数：快速计数器按起点以来的 steady_clock 时长标定（不足 10ms 时等待补足）
+double MetricsTicksPerSecond() noexcept {
+    const MetricsClock& clock = GetMetricsClock();
+    if (!clock.fastTicks) {
+        return 1e9;
+    }
+    constexpr uint64_t MIN_CALIBRATION_NS = 10 * 1000 * 1000;
+    uint64_t nanoseconds = SteadyNanoseconds();
+    if (nanoseconds - clock.nanoseconds0 < MIN_CALIBRATION_NS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(MIN_CALIBRATION_NS - (nanoseconds - clock.nanoseconds0)));
+        nanoseconds = SteadyNanoseconds();
+    }
+    const uint64_t ticks = ReadFastTicks();
+    return static_cast<double>(ticks - clock.ticks0) * 1e9 / static_cast<double>(nanoseconds - clock.nanoseconds0);
+}
+
+struct MetricsRegistry {
+    std::mutex                  mutex;
+    std::vector<MetricsShard*>  shards;
+    MetricsShard                retired;  // 已退出线程的累计值（基线已扣除）
+};
+
+//  故意不释放：线程可能在静态析构之后才退出并归还分片
+MetricsRegistry& GetMetricsRegistry() noexcept {
+    static MetricsRegistry* registry = new MetricsRegistry;
+    return *registry;
+}
+
+inline uint64_t MetricsSeriesKey(const char* from, const char* to, ConversionPath path) noexcept {
+    return detail::MakeEncodingPairKey(from, strlen(from), to, strlen(to)) ^
+           ((static_cast<uint64_t>(path) + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+inline size_t MetricsRecentSlot(const char* from, const char* to, ConversionPath path) noexcept {
+    const auto bits = reinterpret_cast<uintptr_t>(from) ^ (reinterpret_cast<uintptr_t>(to) >> 3);
+    return static_cast<size_t>((bits >> 4) + static_cast<uintptr_t>(path)) & 7u;
+}
+
+/// 调用方持有 shard.mutex（所属线程插入）或注册表锁（retired 分片）
+MetricsSeries* InsertMetricsSeries(MetricsShard& shard, uint64_t key, const char* from, const char* to,
+                                   ConversionPath path) {
+    shard.series.emplace_back();
+    MetricsSeries& series = shard.series.back();
+    series.key  = key;
+    series.path = path;
+    try {
+        series.from = from;
+        series.to   = to;
+        shard.index.emplace(key, &series);
+    } catch (...) {
+        shard.series.pop_back();
+        throw;
+    }
+    return &series;
+}
+
+/// retired 分片只在注册表锁下写入，可以直接累加
+void FoldMetricsSeries(MetricsSeries& into, const MetricsCounters& from) noexcept {
+    const auto add = [](std::atomic<uint64_t>& dst, uint64_t value) {
+        dst.store(dst.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+    add(into.calls, from.calls);
+    add(into.errors, from.errors);
+    add(into.bytesIn, from.bytesIn);
+    add(into.bytesOut, from.bytesOut);
+    add(into.ticks, from.ticks);
+    for (size_t i = 0; i < PairMetrics::LATENCY_BUCKETS; ++i) {
+        add(into.buckets[i], from.buckets[i]);
+    }
+}
+
+/// 线程退出：分片并入 retired 并注销
+void RetireMetricsShard(MetricsShard* shard) noexcept {
+    MetricsRegistry& registry = GetMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const MetricsSeries& series : shard->series) {
+        auto it = registry.retired.index.find(series.key);
+        MetricsSeries* target = nullptr;
+        if (it != registry.retired.index.end()) {
+            target = it->second;
+        } else {
+            try {
+                target = InsertMetricsSeries(registry.retired, series.key, series.from.c_str(),
+                                             series.to.c_str(), series.path);
+            } catch (...) {
+                continue;
+            }
+        }
+        FoldMetricsSeries(*target, series.Read());
+    }
+    registry.shards.erase(std::remove(registry.shards.begin(), registry.shards.end(), shard), registry.shards.end());
+    delete shard;
+}
+
+struct MetricsShardHolder {
+    MetricsShard* shard = nullptr;
+
+    ~MetricsShardHolder() {
+        if (shard) {
+            RetireMetricsShard(shard);
+        }
+    }
+};
+
+/// 当前线程的分片；首次使用时注册（分配失败返回 nullptr，本次不记录）
+MetricsShard* LocalMetricsShard() noexcept {
+    static thread_local MetricsShardHolder holder;
+    if (UNICONV_UNLIKELY(!holder.shard)) {
+        auto* shard = new (std::nothrow) MetricsShard;
+        if (!shard) {
+            return nullptr;
+        }
+        MetricsRegistry& registry = GetMetricsRegistry();
+        try {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.shards.push_back(shard);
+        } catch (...) {
+            delete shard;
+            return nullptr;
+        }
+        holder.shard = shard;
+    }
+    return holder.shard;
+}
+
+/// 计时起点（仅在启用指标时读取计数器）
+class MetricsTimer {
+public:
+    MetricsTimer() noexcept : m_start(MetricsTicks()) {}
+
+    uint64_t ElapsedTicks() const noexcept { return MetricsTicks() - m_start; }
+
+private:
+    uint64_t m_start;
+};
+
+/// 找到（或注册）当前线程上 (from, to, path) 的序列；名称指针命中最近表时只做两次短字符串比较
+MetricsSeries* FindMetricsSeries(MetricsShard& shard, const char* from, const char* to, ConversionPath path) noexcept {
+    MetricsSeries*& recent = shard.recent[MetricsRecentSlot(from, to, path)];
+    if (UNICONV_LIKELY(recent && recent->path == path && std::strcmp(recent->from.c_str(), from) == 0 &&
+                       std::strcmp(recent->to.c_str(), to) == 0)) {
+        return recent;
+    }
+
+    const uint64_t key = MetricsSeriesKey(from, to, path);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        recent = it->second;
+        return recent;
+    }
+    try {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        recent = InsertMetricsSeries(shard, key, from, to, path);
+    } catch (...) {
+        return nullptr;
+    }
+    return recent;
+}
+
+void RecordConversionMetrics(const char* from, const char* to, ConversionPath path, size_t bytesIn,
+                             size_t bytesOut, ErrorCode ec, const MetricsTimer& timer) noexcept {
+    const uint64_t ticks = timer.ElapsedTicks();
+    MetricsShard* shard = LocalMetricsShard();
+    if (UNICONV_UNLIKELY(!shard || !from || !to)) {
+        return;
+    }
+    MetricsSeries* series = FindMetricsSeries(*shard, from, to, path);
+    if (UNICONV_UNLIKELY(!series)) {
+        return;
+    }
+
+    //  log2 分桶：bucket i 覆盖 [2^i, 2^(i+1)) 个计数，最后一桶不设上限
+    size_t bucket = 0;
+    for (uint64_t v = ticks >> 1; v != 0 && bucket + 1 < PairMetrics::LATENCY_BUCKETS; v >>= 1) {
+        ++bucket;
+    }
+    //  只有所属线程写入：load + store 即可，不需要原子读改写
+    const auto add = [](std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+    add(series->calls, 1);
+    if (ec != ErrorCode::Success) {
+        add(series->errors, 1);
+    }
+    add(series->bytesIn, bytesIn);
+    add(series->bytesOut, bytesOut);
+    add(series->ticks, ticks);
+    add(series->buckets[bucket], 1);
+}
+
+/// 批量 / 并行循环中自行驱动 iconv 的逐条转换：析构时提交，循环在各出口改写 path、status 与 bytesOut
+class MetricsCall {
+public:
+    MetricsCall(const char* from, const char* to, ConversionPath defaultPath, size_t bytesIn) noexcept
+        : path(defaultPath), m_from(from), m_to(to), m_bytesIn(bytesIn) {}
+    MetricsCall(const MetricsCall&) = delete;
+    MetricsCall& operator=(const MetricsCall&) = delete;
+
+    ~MetricsCall() {
+        RecordConversionMetrics(m_from, m_to, path, m_bytesIn, bytesOut, status, m_timer);
+    }
+
+    ConversionPath path;
+    ErrorCode      status = ErrorCode::Success;
+    size_t         bytesOut = 0;
+
+private:
+    MetricsTimer   m_timer;
+    const char*    m_from;
+    const char*    m_to;
+    size_t         m_bytesIn;
+};
+
+#define UNICONV_METRICS_CALL(call, from, to, path, bytesIn) MetricsCall call(from, to, path, bytesIn)
+#define UNICONV_METRICS_NOTE(call, member, value)          (call.member = (value))
+#else
+#define UNICONV_METRICS_CALL(call, from, to, path, bytesIn) ((void)0)
+#define UNICONV_METRICS_NOTE(call, member, value)          ((void)0)
+#endif // UNICONV_ENABLE_METRICS
+
+} // anonymous namespace
+
+
+#if !UNICONV_NO_THREAD_LOCAL
+// Thread-local cache instance definition (only when thread_local is enabled)
+thread_local UniConv::ThreadLocalCache UniConv::t_cache;
+#endif
+
+#if UNICONV_NO_THREAD_LOCAL
 UniConv::ThreadLocalCache& UniConv::GetDllThreadLocalCache() noexcept {
     static thread_local ThreadLocalCache cache;
     return cache;
 }
-#endif
+#endif
+
+namespace {
+
+/// EncodingHandle 下标 → encodings.inc 规范名称（iconv_open 直接使用）
+constexpr const char* kInternedNames[] = {
+    #define X(name, str) str,
+    #include <UniConv/encodings.inc>
+    #undef X
+};
+constexpr size_t kInternedCount = sizeof(kInternedNames) / sizeof(kInternedNames[0]);
+static_assert(kInternedCount == static_cast<size_t>(UniConv::Encoding::count),
+              "kInternedNames must follow encodings.inc");
+
+} // anonymous namespace
+
+// Thread-safe default encoding management
+namespace {
+    std::atomic<const std::string*> g_defaultEncodingPtr{nullptr};
+    std::mutex g_defaultEncodingMutex;
+}
+
+std::string UniConv::m_defaultEncoding = {}; // Legacy static member (deprecated, kept for compatibility)
+
+/**************************  === 编码注册表（编译期完美哈希） ===  ***************************/
+namespace {
+
+/// Windows 码页 → .NET 名称与说明（GetEncodingNameByCodePage / GetEncodingNamePtr）
+struct CodePageInfo {
+    std::uint16_t code_page;
+    const char*   dotNetName;   /*!< .NET encoding name */
+    const char*   extra_info;   /*!< Extra information  */
+};
+
+constexpr CodePageInfo kCodePageInfos[] = {
+    {37,     "IBM037",       "IBM EBCDIC US-Canada"},
+    {437,    "IBM437",       "OEM United States"},
+    {850,    "IBM850",       "OEM Multilingual Latin 1; Western European (DOS)"},
+    {852,    "IBM852",       "OEM Latin 2; Central European (DOS)"},
+    {855,    "IBM855",       "OEM Cyrillic (primarily Russian)"},
+    {857,    "IBM857",       "OEM Turkish; Turkish (DOS)"},
+    {860,    "IBM860",       "OEM Portuguese; Portuguese (DOS)"},
+    {861,    "IBM861",       "OEM Icelandic; Icelandic (DOS)"},
+    {862,    "DOS-862",      "OEM Hebrew; Hebrew (DOS)"},
+    {863,    "IBM863",       "OEM French Canadian; French Canadian (DOS)"},
+    {865,    "IBM865",       "OEM Nordic; Nordic (DOS)"},
+    {866,    "CP866",        "OEM Russian; Cyrillic (DOS)"},
+    {874,    "Windows-874",  "Thai (Windows)"},
+    {932,    "Shift_JIS",    "ANSI/OEM Japanese; Japanese (Shift-JIS)"},
+    {936,    "GB2312",       "ANSI/OEM Simplified Chinese (PRC, Singapore); Chinese Simplified (GB2312)"},
+    {949,    "KS_C_5601-1987", "ANSI/OEM Korean (Unified Hangul Code)"},
+    {950,    "Big5",         "ANSI/OEM Traditional Chinese (Taiwan; Hong Kong SAR, PRC); Chinese Traditional (Big5)"},
+    {1200,   "UTF-16",       "Unicode UTF-16, little endian byte order (BMP of ISO 10646); available only to managed applications"},
+    {1201,   "UTF-16BE",     "Unicode UTF-16, big endian byte order; available only to managed applications"},
+    {1250,   "Windows-1250", "ANSI Central European; Central European (Windows)"},
+    {1251,   "Windows-1251", "ANSI Cyrillic; Cyrillic (Windows)"},
+    {1252,   "Windows-1252", "ANSI Latin 1; Western European (Windows)"},
+    {1253,   "Windows-1253", "ANSI Greek; Greek (Windows)"},
+    {1254,   "Windows-1254", "ANSI Turkish; Turkish (Windows)"},
+    {1255,   "Windows-1255", "ANSI Hebrew; Hebrew (Windows)"},
+    {1256,   "Windows-1256", "ANSI Arabic; Arabic (Windows)"},
+    {1257,   "Windows-1257", "ANSI Baltic; Baltic (Windows)"},
+    {1258,   "Windows-1258", "ANSI/OEM Vietnamese; Vietnamese (Windows)"},
+    {20866,  "KOI8-R",       "Russian (KOI8-R); Cyrillic (KOI8-R)"},
+    {21866,  "KOI8-U",       "Ukrainian (KOI8-U); Cyrillic (KOI8-U)"},
+    {28591,  "ISO-8859-1",   "ISO 8859-1 Latin 1; Western European (ISO)"},
+    {28592,  "ISO-8859-2",   "ISO 8859-2 Central European; Central European (ISO)"},
+    {28595,  "ISO-8859-5",   "ISO 8859-5 Cyrillic"},
+    {28597,  "ISO-8859-7",   "ISO 8859-7 Greek"},
+    {28599,  "ISO-8859-9",   "ISO 8859-9 Turkish"},
+    {28605,  "ISO-8859-15",  "ISO 8859-15 Latin 9"},
+    {50220,  "ISO-2022-JP",  "ISO 2022 Japanese with no halfwidth Katakana; Japanese (JIS)"},
+    {50225,  "ISO-2022-KR",  "ISO 2022 Korean"},
+    {51932,  "EUC-JP",       "EUC Japanese"},
+    {51936,  "EUC-CN",       "EUC Simplified Chinese; Chinese Simplified (EUC)"},
+    {51949,  "EUC-KR",       "EUC Korean"},
+    {52936,  "HZ-GB-2312",   "HZ-GB2312 Simplified Chinese; Chinese Simplified (HZ)"},
+    {54936,  "GB18030",      "Windows XP and later: GB18030 Simplified Chinese (4 byte); Chinese Simplified (GB18030)"},
+    {65000,  "UTF-7",        "Unicode (UTF-7)"},
+    {65001,  "UTF-8",        "Unicode (UTF-8)"},
+};
+
+/// iconv 编码名 → Windows 码页（GetCurrentSystemEncodingCodePage / GetSystemCodePageFast）
+struct NameCodePage {
+    const char*   name;
+    std::uint16_t code_page;
+};
+
+constexpr NameCodePage kNameCodePages[] = {
+    {"UTF-8",                  65001},    // Unicode (UTF-8)
+    {"ANSI_X3.4-1968",         20127},    // US-ASCII
+    {"ISO-8859-1",             28591},    // Latin-1
+    {"ISO-8859-2",             28592},    // Latin-2
+    {"ISO-8859-3",             28593},    // Latin-3
+    {"ISO-8859-4",             28594},    // Latin-4 (Baltic)
+    {"ISO-8859-5",             28595},    // Cyrillic
+    {"ISO-8859-6",             28596},    // Arabic
+    {"ISO-8859-7",             28597},    // Greek
+    {"ISO-8859-8",             28598},    // Hebrew
+    {"ISO-8859-9",             28599},    // Latin-5 (Turkish)
+    {"ISO-8859-10",            28600},    // Latin-6 (Nordic)
+    {"ISO-8859-11",            28601},    // Thai
+    {"ISO-8859-13",            28603},    // Latin-7 (Baltic Rim)
+    {"ISO-8859-14",            28604},    // Latin-8 (Celtic)
+    {"ISO-8859-15",            28605},    // Latin-9 (Western European with Euro)
+    {"ISO-8859-16",            28606},    // Latin-10 (South-Eastern European)
+    {"GB2312",                 936},      // Simplified Chinese
+    {"GBK",                    936},      // Simplified Chinese (GBK)
+    {"GB18030",                54936},    // Simplified Chinese (GB18030)
+    {"BIG5",                   950},      // Traditional Chinese
+    {"EUC-JP",                 20932},    // Japanese
+    {"EUC-KR",                 51949},    // Korean
+    {"KOI8-R",                 20866},    // Russian
+    {"KOI8-U",                 21866},    // Ukrainian
+    {"Windows-1250",           1250},     // Central European (Windows)
+    {"Windows-1251",           1251},     // Cyrillic (Windows)
+    {"Windows-1252",           1252},     // Western European (Windows)
+    {"Windows-1253",           1253},     // Greek (Windows)
+    {"Windows-1254",           1254},     // Turkish (Windows)
+    {"Windows-1255",           1255},     // Hebrew (Windows)
+    {"Windows-1256",           1256},     // Arabic (Windows)
+    {"Windows-1257",           1257},     // Baltic (Windows)
+    {"Windows-1258",           1258},     // Vietnamese (Windows)
+    {"Shift_JIS",              932},      // Japanese (Shift-JIS)
+    {"CP932",                  932},      // Japanese (Shift-JIS, Windows)
+    {"CP949",                  949},      // Korean (Unified Hangul Code, Windows)
+    {"CP950",                  950},      // Traditional Chinese (Big5, Windows)
+    {"CP866",                  866},      // Cyrillic (DOS)
+    {"CP850",                  850},      // Western European (DOS)
+    {"CP852",                  852},      // Central European (DOS)
+    {"CP855",                  855},      // Cyrillic (DOS, primarily Russian)
+    {"CP857",                  857},      // Turkish (DOS)
+    {"CP860",                  860},      // Portuguese (DOS)
+    {"CP861",                  861},      // Icelandic (DOS)
+    {"CP862",                  862},      // Hebrew (DOS)
+    {"CP863",                  863},      // French Canadian (DOS)
+    {"CP864",                  864},      // Arabic (DOS)
+    {"CP865",                  865},      // Nordic (DOS)
+    {"CP869",                  869},      // Modern Greek (DOS)
+    {"CP874",                  874},      // Thai (Windows)
+    {"CP1250",                 1250},     // Central European (Windows)
+    {"CP1251",                 1251},     // Cyrillic (Windows)
+    {"CP1252",                 1252},     // Western European (Windows)
+    {"CP1253",                 1253},     // Greek (Windows)
+    {"CP1254",                 1254},     // Turkish (Windows)
+    {"CP1255",                 1255},     // Hebrew (Windows)
+    {"CP1256",                 1256},     // Arabic (Windows)
+    {"CP1257",                 1257},     // Baltic (Windows)
+    {"CP1258",                 1258},     // Vietnamese (Windows)
+    {"MacRoman",               10000},    // Western European (Mac)
+    {"MacCyrillic",            10007},    // Cyrillic (Mac)
+    {"MacGreek",               10006},    // Greek (Mac)
+    {"MacTurkish",             10081},    // Turkish (Mac)
+    {"MacIcelandic",           10079},    // Icelandic (Mac)
+    {"MacCentralEurope",       10029},    // Central European (Mac)
+    {"MacThai",                10021},    // Thai (Mac)
+    {"MacJapanese",            10001},    // Japanese (Mac)
+    {"MacChineseTrad",         10002},    // Traditional Chinese (Mac)
+    {"MacChineseSimp",         10008},    // Simplified Chinese (Mac)
+    {"MacKorean",              10003},    // Korean (Mac)
+    {"MacArabic",              10004},    // Arabic (Mac)
+    {"MacHebrew",              10005},    // Hebrew (Mac)
+    {"TIS-620",                874},      // Thai (TIS-620)
+    {"ISCII-DEVANAGARI",       57002},    // ISCII Devanagari
+    {"ISCII-BENGALI",          57003},    // ISCII Bangla
+    {"ISCII-TAMIL",            57004},    // ISCII Tamil
+    {"ISCII-TELUGU",           57005},    // ISCII Telugu
+    {"ISCII-ASSAMESE",         57006},    // ISCII Assamese
+    {"ISCII-ORIYA",            57007},    // ISCII Odia
+    {"ISCII-KANNADA",          57008},    // ISCII Kannada
+    {"ISCII-MALAYALAM",        57009},    // ISCII Malayalam
+    {"ISCII-GUJARATI",         57010},    // ISCII Gujarati
+    {"ISCII-PUNJABI",          57011},    // ISCII Punjabi
+    {"VISCII",                 1258},     // Vietnamese (VISCII)
+    {"VPS",                    1258},     // Vietnamese (VPS)
+    {"UTF-16",                 1200},     // Unicode UTF-16 (Little Endian)
+    {"UTF-16BE",               1201},     // Unicode UTF-16 (Big Endian)
+    {"UTF-32",                 12000},    // Unicode UTF-32 (Little Endian)
+    {"UTF-32BE",               12001},    // Unicode UTF-32 (Big Endian)
+    {"UTF-7",                  65000},    // Unicode UTF-7
+    {"HZ-GB-2312",             52936},    // HZ-GB2312 Simplified Chinese
+    {"ISO-2022-JP",            50220},    // Japanese (ISO-2022-JP)
+    {"ISO-2022-KR",            50225},    // Korean (ISO-2022-KR)
+    {"ISO-2022-CN",            50227},    // Simplified Chinese (ISO-2022-CN)
+    {"EUC-TW",                 51950},    // Traditional Chinese (EUC-TW)
+    {"ARMSCII-8",              0},        // Armenian (ARMSCII-8, no Windows code page)
+    {"GEORGIAN-ACADEMY",       0},        // Georgian (Academy, no Windows code page)
+    {"GEORGIAN-PS",            0},        // Georgian (PS, no Windows code page)
+    {"TSCII",                  0},        // Tamil (TSCII, no Windows code page)
+    {"RK1048",                 0},        // Kazakh (RK1048, no Windows code page)
+    {"MULELAO-1",              0},        // Lao (MULELAO-1, no Windows code page)
+    {"TCVN",                   1258},     // Vietnamese (TCVN)
+    {"VISCII1.1",              1258},     // Vietnamese (VISCII 1.1)
+    {"VISCII1.1-HYBRID",       1258},     // Vietnamese (VISCII 1.1 Hybrid)
+};
+
+/// IsValidEncodingName 额外接受的常见别名和大小写变体
+constexpr const char* kNameAliases[] = {
+        // UTF 系列
+        "utf-8", "UTF8", "utf8",
+        "utf-16", "UTF16", "utf16",
+        "utf-32", "UTF32", "utf32",
+        "utf-16le", "UTF-16LE", "utf16le",
+        "utf-16be", "UTF-16BE", "utf16be",
+        "utf-32le", "UTF-32LE", "utf32le",
+        "utf-32be", "UTF-32BE", "utf32be",
+        // 中文编码
+        "gb2312", "GB2312", "gbk", "GBK",
+        "gb18030", "GB18030",
+        "big5", "BIG5", "Big5",
+        // 其他常见编码
+        "ascii", "ASCII", "us-ascii", "US-ASCII",
+        "iso-8859-1", "ISO-8859-1", "latin1", "LATIN1",
+        "windows-1252", "WINDOWS-1252", "cp1252", "CP1252",
+        "shift_jis", "SHIFT_JIS", "sjis", "SJIS",
+        "euc-jp", "EUC-JP", "eucjp", "EUCJP",
+        "euc-kr", "EUC-KR", "euckr", "EUCKR",
+        "euc-cn", "EUC-CN", "euccn", "EUCCN"
+};
+
+/// 内置单字节码页（sbcs_tables.inc）的名称，大写与小写各接受一份
+constexpr const char* kSbcsNames[] = {
+#define UNICONV_SBCS(id, ...)
+#define UNICONV_SBCS_NAME(id, name) name,
+#include "sbcs_tables.inc"
+#undef UNICONV_SBCS_NAME
+#undef UNICONV_SBCS
+};
+
+struct LowerName {
+    char text[24];
+};
+
+template <size_t N>
+constexpr bool NamesFit(const char* const (&names)[N], size_t capacity) noexcept {
+    for (const char* name : names) {
+        size_t len = 0;
+        while (name[len]) {
+            ++len;
+        }
+        if (len >= capacity) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(NamesFit(kSbcsNames, sizeof(LowerName::text)), "sbcs_tables.inc name too long for LowerName");
+
+template <size_t N>
+constexpr std::array<LowerName, N> MakeLowerNames(const char* const (&names)[N]) noexcept {
+    std::array<LowerName, N> lower{};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; names[i][j]; ++j) {
+            const char c = names[i][j];
+            lower[i].text[j] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c;
+        }
+    }
+    return lower;
+}
+
+constexpr std::array<LowerName, sizeof(kSbcsNames) / sizeof(kSbcsNames[0])> kSbcsLowerNames = MakeLowerNames(kSbcsNames);
+
+/// 注册表条目：名称 + 值（码页或 encodings.inc 下标）+ 标志
+struct RegistryEntry {
+    const char*   name;
+    std::uint16_t value;
+    std::uint8_t  flags;
+};
+
+constexpr std::uint8_t kEntryHasCodePage = 1;   ///< value 为 kNameCodePages 中的码页（0 = 无对应 Windows 码页）
+
+/**
+ * @brief 编译期生成的完美哈希名称表（hash-and-displace）
+ * @details 键按哈希高位分入 Buckets 个桶，从最大的桶开始逐个寻找位移 d，使桶内每个键的槽位
+ *          (lo + d * step) & (Slots - 1) 都空闲且互不相同。查找只有一次哈希、一次位移表读取和
+ *          一次名称比较，没有探测链；整张表是一块常量数据，进程启动时不执行任何初始化。
+ *          同名条目只保留第一次出现的那个。FoldCase 时哈希与比较都不区分 ASCII 大小写。
+ */
+template <size_t Slots, size_t Buckets, bool FoldCase>
+class PerfectNameTable {
+    static_assert((Slots & (Slots - 1)) == 0 && (Buckets & (Buckets - 1)) == 0, "table sizes must be powers of two");
+    static_assert(Slots <= 65536, "displacement is 16-bit");
+
+public:
+    template <size_t N>
+    static constexpr PerfectNameTable Build(const std::array<RegistryEntry, N>& entries) noexcept {
+        PerfectNameTable table;
+        // 按桶计数排序（稳定）：order[first[b] .. first[b + 1]) 为桶 b 的键，保持原有先后顺序
+        uint64_t hashes[N] = {};
+        size_t   order[N] = {};
+        size_t   first[Buckets + 1] = {};
+        size_t   fill[Buckets] = {};
+        for (size_t i = 0; i < N; ++i) {
+            hashes[i] = Hash(entries[i].name);
+            ++first[BucketOf(hashes[i]) + 1];
+        }
+        size_t largest = 0;
+        for (size_t b = 0; b < Buckets; ++b) {
+            largest = first[b + 1] > largest ? first[b + 1] : largest;
+            first[b + 1] += first[b];
+        }
+        for (size_t i = 0; i < N; ++i) {
+            const size_t b = BucketOf(hashes[i]);
+            order[first[b] + fill[b]++] = i;
+        }
+
+        // 大桶先放：表越空越容易找到可用位移
+        for (size_t size = largest; size > 0; --size) {
+            for (size_t b = 0; b < Buckets; ++b) {
+                if (first[b + 1] - first[b] != size) {
+                    continue;
+                }
+                size_t unique[kMaxBucket] = {};
+                size_t count = 0;
+                for (size_t k = first[b]; k < first[b + 1]; ++k) {
+                    bool duplicate = false;
+                    for (size_t u = 0; u < count && !duplicate; ++u) {
+                        duplicate = Equal(entries[unique[u]].name, entries[order[k]].name);
+                    }
+                    if (!duplicate) {
+                        if (count == kMaxBucket) {
+                            return table;
+                        }
+                        unique[count++] = order[k];
+                    }
+                }
+                bool placed = false;
+                for (size_t d = 0; d < Slots && !placed; ++d) {
+                    bool fits = true;
+                    for (size_t u = 0; u < count && fits; ++u) {
+                        const size_t slot = SlotOf(hashes[unique[u]], d);
+                        fits = table.m_slots[slot].name == nullptr;
+                        for (size_t v = 0; v < u && fits; ++v) {
+                            fits = SlotOf(hashes[unique[v]], d) != slot;
+                        }
+                    }
+                    if (fits) {
+                        for (size_t u = 0; u < count; ++u) {
+                            table.m_slots[SlotOf(hashes[unique[u]], d)] = entries[unique[u]];
+                        }
+                        table.m_displacement[b] = static_cast<std::uint16_t>(d);
+                        table.m_size += count;
+                        placed = true;
+                    }
+                }
+                if (!placed) {
+                    return table;
+                }
+            }
+        }
+        table.m_built = true;
+        return table;
+    }
+
+    /// 名称对应的条目；未注册返回 nullptr
+    UNICONV_HOT constexpr const RegistryEntry* Find(const char* name) const noexcept {
+        const uint64_t h = Hash(name);
+        const RegistryEntry& slot = m_slots[SlotOf(h, m_displacement[BucketOf(h)])];
+        return slot.name && Equal(slot.name, name) ? &slot : nullptr;
+    }
+
+    constexpr bool   Built() const noexcept { return m_built; }
+    constexpr size_t Size() const noexcept { return m_size; }
+
+private:
+    static constexpr size_t kMaxBucket = 16;
+
+    static constexpr char Fold(char c) noexcept {
+        return (FoldCase && c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+    }
+
+    /// FNV-1a 64 位 + 末尾混合（FNV 的低位只取决于输入字节的低位，槽位取低位前先打散）
+    static constexpr uint64_t Hash(const char* s) noexcept {
+        uint64_t h = 14695981039346656037ULL;
+        for (; *s; ++s) {
+            h = (h ^ static_cast<unsigned char>(Fold(*s))) * 1099511628211ULL;
+        }
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ULL;
+        return h ^ (h >> 32);
+    }
+
+    static constexpr bool Equal(const char* a, const char* b) noexcept {
+        for (; *a && Fold(*a) == Fold(*b); ++a, ++b) {
+        }
+        return Fold(*a) == Fold(*b);
+    }
+
+    static constexpr size_t BucketOf(uint64_t h) noexcept {
+        return static_cast<size_t>(h >> 48) & (Buckets - 1);
+    }
+
+    static constexpr size_t SlotOf(uint64_t h, size_t d) noexcept {
+        const uint32_t step = static_cast<uint32_t>(h >> 24) | 1u;
+        return (static_cast<uint32_t>(h) + static_cast<uint32_t>(d) * step) & (Slots - 1);
+    }
+
+    RegistryEntry m_slots[Slots] = {};
+    std::uint16_t m_displacement[Buckets] = {};
+    size_t        m_size = 0;
+    bool          m_built = false;
+};
+
+constexpr size_t kRegistryKeyCount = sizeof(kNameCodePages) / sizeof(kNameCodePages[0]) +
+                                     sizeof(kCodePageInfos) / sizeof(kCodePageInfos[0]) + kInternedCount +
+                                     sizeof(kNameAliases) / sizeof(kNameAliases[0]) +
+                                     2 * (sizeof(kSbcsNames) / sizeof(kSbcsNames[0]));
+
+/// IsValidEncodingName 接受的全部名称：码页对照表在前，同名条目保留其码页
+constexpr std::array<RegistryEntry, kRegistryKeyCount> MakeRegistryEntries() noexcept {
+    std::array<RegistryEntry, kRegistryKeyCount> entries{};
+    size_t n = 0;
+    for (const NameCodePage& e : kNameCodePages) {
+        entries[n++] = RegistryEntry{e.name, e.code_page, kEntryHasCodePage};
+    }
+    for (const CodePageInfo& e : kCodePageInfos) {
+        entries[n++] = RegistryEntry{e.dotNetName, 0, 0};
+    }
+    for (const char* name : kInternedNames) {
+        entries[n++] = RegistryEntry{name, 0, 0};
+    }
+    for (const char* name : kNameAliases) {
+        entries[n++] = RegistryEntry{name, 0, 0};
+    }
+    for (size_t i = 0; i < kSbcsLowerNames.size(); ++i) {
+        entries[n++] = RegistryEntry{kSbcsNames[i], 0, 0};
+        entries[n++] = RegistryEntry{kSbcsLowerNames[i].text, 0, 0};
+    }
+    return entries;
+}
+
+/// encodings.inc 规范名（不区分大小写）→ 下标，重复的名称（wchar_t_encoding）指向第一个
+constexpr std::array<RegistryEntry, kInternedCount> MakeInternEntries() noexcept {
+    std::array<RegistryEntry, kInternedCount> entries{};
+    for (size_t i = 0; i < kInternedCount; ++i) {
+        entries[i] = RegistryEntry{kInternedNames[i], static_cast<std::uint16_t>(i), 0};
+    }
+    return entries;
+}
+
+/// 编码名称注册表（区分大小写）：IsValidEncodingName、名称 → 码页
+constexpr auto kEncodingRegistry = PerfectNameTable<512, 256, false>::Build(MakeRegistryEntries());
+static_assert(kEncodingRegistry.Built(), "encoding registry: no collision-free displacement found");
+
+/// InternEncoding 的规范名表（不区分大小写）
+constexpr auto kInternRegistry = PerfectNameTable<256, 128, true>::Build(MakeInternEntries());
+static_assert(kInternRegistry.Built(), "intern registry: no collision-free displacement found");
+
+constexpr bool EqualNamesNoCase(const char* a, const char* b) noexcept {
+    auto upper = [](char c) { return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c; };
+    for (; *a && upper(*a) == upper(*b); ++a, ++b) {
+    }
+    return upper(*a) == upper(*b);
+}
+
+template <size_t N>
+constexpr bool ContainsNameNoCase(const char* const (&names)[N], const char* name) noexcept {
+    for (const char* candidate : names) {
+        if (EqualNamesNoCase(candidate, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr size_t kCodePageNameCount = sizeof(kNameCodePages) / sizeof(kNameCodePages[0]) +
+                                      sizeof(kCodePageInfos) / sizeof(kCodePageInfos[0]);
+
+/// 码页对照名称中 encodings.inc 没有、也不是 EncodingId 别名的那些（不区分大小写去重）
+struct InternExtraNames {
+    const char* names[kCodePageNameCount] = {};
+    size_t      count = 0;
+};
+
+constexpr InternExtraNames MakeInternExtraNames() noexcept {
+    InternExtraNames extras;
+    auto add = [&extras](const char* name) {
+        // 别名与单字节码页名由 GetEncodingId 映射到 encodings.inc 中同一 ID 的规范名
+        if (kInternRegistry.Find(name) || ContainsNameNoCase(kNameAliases, name) ||
+            ContainsNameNoCase(kSbcsNames, name)) {
+            return;
+        }
+        for (size_t k = 0; k < extras.count; ++k) {
+            if (EqualNamesNoCase(extras.names[k], name)) {
+                return;
+            }
+        }
+        extras.names[extras.count++] = name;
+    };
+    for (const NameCodePage& e : kNameCodePages) {
+        add(e.name);
+    }
+    for (const CodePageInfo& e : kCodePageInfos) {
+        add(e.dotNetName);
+    }
+    return extras;
+}
+
+constexpr InternExtraNames kInternExtraNames = MakeInternExtraNames();
+constexpr size_t kInternExtraCount = kInternExtraNames.count;
+
+/// 句柄总数：encodings.inc 在前，kInternExtraNames 在后
+constexpr size_t kHandleCount = kInternedCount + kInternExtraCount;
+static_assert(kHandleCount < 0xFFFF, "EncodingHandle index is 16-bit");
+
+constexpr std::array<RegistryEntry, kInternExtraCount> MakeInternExtraEntries() noexcept {
+    std::array<RegistryEntry, kInternExtraCount> entries{};
+    for (size_t i = 0; i < kInternExtraCount; ++i) {
+        entries[i] = RegistryEntry{kInternExtraNames.names[i], static_cast<std::uint16_t>(kInternedCount + i), 0};
+    }
+    return entries;
+}
+
+/// InternEncoding 的码页对照名称表（不区分大小写），值为句柄下标
+constexpr auto kInternExtraRegistry = PerfectNameTable<128, 64, true>::Build(MakeInternExtraEntries());
+static_assert(kInternExtraRegistry.Built(), "intern extra registry: no collision-free displacement found");
+
+/// 句柄下标 → 名称（iconv_open 直接使用）
+inline const char* HandleName(uint16_t index) noexcept {
+    return index < kInternedCount ? kInternedNames[index] : kInternExtraNames.names[index - kInternedCount];
+}
+
+/**
+ * @brief 句柄编码对 → 打包的转换路线，按编码对首次使用时填入（0 = 尚未计算）
+ * @details 位布局： [31] 已计算 | [30] ASCII 透传 | [24..25] PairRoute | [8..15] 源 EncodingId | [0..7] 目标 EncodingId。
+ *          结果只取决于两个名称，多个线程同时计算写入的是同一个值，relaxed 读写即可
+ */
+std::atomic<uint32_t> g_handlePairPlans[kHandleCount * kHandleCount];
+
+/// 句柄编码对的描述符缓存键：奇数乘数是双射，不同编码对的键互不相同
+constexpr uint64_t HandlePairKey(uint16_t from, uint16_t to) noexcept {
+    return ((static_cast<uint64_t>(from) << 16) | to) * 0x9E3779B97F4A7C15ULL;
+}
+
+/**
+ * @brief 码页 → kCodePageInfos 下标的完美哈希
+ * @details 编译期搜索乘数 mul，使 (code_page * mul) >> 24 对全部码页两两不同；查找为一次乘法、一次读表、一次比较
+ */
+struct CodePageIndex {
+    uint32_t     multiplier = 0;
+    std::uint8_t index[256] = {};   // 0xFF = 空
+};
+
+constexpr CodePageIndex BuildCodePageIndex() noexcept {
+    CodePageIndex table;
+    // 候选乘数取自 LCG 序列（相邻奇数乘数的分布高度相关，逐个递增很难找到）
+    uint32_t state = 0x9E3779B1u;
+    for (uint32_t candidate = 0; candidate < 1024; ++candidate) {
+        state = state * 1664525u + 1013904223u;
+        const uint32_t mul = state | 1u;
+        for (std::uint8_t& slot : table.index) {
+            slot = 0xFF;
+        }
+        bool ok = true;
+        for (size_t i = 0; i < sizeof(kCodePageInfos) / sizeof(kCodePageInfos[0]) && ok; ++i) {
+            std::uint8_t& slot = table.index[static_cast<uint32_t>(kCodePageInfos[i].code_page * mul) >> 24];
+            ok = slot == 0xFF;
+            slot = static_cast<std::uint8_t>(i);
+        }
+        if (ok) {
+            table.multiplier = mul;
+            return table;
+        }
+    }
+    return CodePageIndex{};
+}
+
+constexpr CodePageIndex kCodePageIndex = BuildCodePageIndex();
+static_assert(kCodePageIndex.multiplier != 0, "code page index: no collision-free multiplier found");
+
+/// 码页对应的 .NET 名称与说明；未收录返回 nullptr
+inline const CodePageInfo* FindCodePageInfo(std::uint16_t codePage) noexcept {
+    const std::uint8_t i = kCodePageIndex.index[static_cast<uint32_t>(codePage * kCodePageIndex.multiplier) >> 24];
+    return (i != 0xFF && kCodePageInfos[i].code_page == codePage) ? &kCodePageInfos[i] : nullptr;
+}
+
+/// 编码名对应的 Windows 码页；未收录返回 nullptr
+inline const RegistryEntry* FindNameCodePage(const char* encoding) noexcept {
+    const RegistryEntry* entry = kEncodingRegistry.Find(encoding);
+    return (entry && (entry->flags & kEntryHasCodePage)) ? entry : nullptr;
+}
+
+} // anonymous namespace
+
+
+
+void UniConv::SetDefaultEncoding(const std::string& encoding) noexcept
+{
+    // Thread-safe implementation using atomic pointer and mutex
+    std::lock_guard<std::mutex> lock(g_defaultEncodingMutex);
+    
+    // Load old pointer
+    const std::string* old_ptr = g_defaultEncodingPtr.load(std::memory_order_relaxed);
+    
+    // Create new string
+    const std::string* new_ptr = new std::string(encoding);
+    
+    // Atomically update pointer
+    g_defaultEncodingPtr.store(new_ptr, std::memory_order_release);
+    
+    // Delete old string (safe because we hold the mutex)
+    delete old_ptr;
+    
+    // Update legacy static member for backward compatibility
+    this->m_defaultEncoding = encoding;
+}
+
+
+// ===================== System encoding related functions =====================
+std::string UniConv::GetCurrentSystemEncoding() noexcept
+{
+#if !UNICONV_NO_THREAD_LOCAL
+    // Check thread-local cache first (fast path)
+    if (t_cache.system_encoding_cached) {
+        return t_cache.system_encoding;
+    }
+#else
+    // Without thread_local, always compute dynamically
+    // This is less efficient but provides DLL compatibility
+#endif
+    
+    // Check default encoding - need a static default since this is a static function
+    // For static functions, we cannot access instance members like m_defaultEncoding
+    // So we'll compute the system encoding each time when UNICONV_NO_THREAD_LOCAL is defined
+    
+	std::stringstream ss;
+#ifdef _WIN32
+	UINT codePage = GetACP();
+	if (const CodePageInfo* info = FindCodePageInfo(static_cast<std::uint16_t>(codePage)))
+        ss << info->dotNetName;
+
+#endif // _WIN32
+
+
+#if defined(__linux__) || defined(__APPLE__)
+	setlocale(LC_ALL, "");
+	char* locstr = setlocale(LC_CTYPE, NULL);
+	char* encoding = nl_langinfo(CODESET);
+	if (encoding && encoding[0] != '\0')
+		ss << encoding;
+#endif
+	if (ss.str().empty()) ss << "UTF-8";
+	
+#if !UNICONV_NO_THREAD_LOCAL	
+	// Cache the result in thread-local storage
+	t_cache.system_encoding = ss.str();
+	t_cache.system_encoding_cached = true;
+	
+	return t_cache.system_encoding;
+#else
+	// Return directly without caching when thread_local is disabled
+	return ss.str();
+#endif
+}
+
+
+std::uint16_t UniConv::GetCurrentSystemEncodingCodePage() noexcept {
+#ifdef _WIN32
+	UINT codePage = GetACP();
+	return static_cast<std::uint16_t>(codePage);
+#elif defined(__linux__) || defined(__APPLE__)
+	setlocale(LC_ALL, "");
+	char* locstr = setlocale(LC_CTYPE, NULL);
+	char* encoding = nl_langinfo(CODESET);
+	if (encoding) {
+		if (const RegistryEntry* entry = FindNameCodePage(encoding))
+			return entry->value;
+	}
+	return 0;
+#else
+	return static_cast<std::uint16_t>(-1);
+#endif
+}
+
+std::string  UniConv::GetEncodingNameByCodePage(std::uint16_t codePage) noexcept
+{
+	if (const CodePageInfo* info = FindCodePageInfo(codePage))
+		return info->dotNetName;
+	else
+		return "Encoding not found.";
+}
+
+
+// ===================== Refactored encoding conversion methods =====================
+
+// System local encoding -> UTF-8
+std::string UniConv::ToUtf8FromLocale(const std::string& input) {
+    if(input.empty())
+        return std::string{};
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8);
+    return result.IsSuccess() ? std::move(result).GetValue() : "";
+}
+
+std::string UniConv::ToUtf8FromLocale(const char* input) {
+    if (!input) return "";
+    return ToUtf8FromLocale(std::string(input));
+}
+
+// UTF-8 -> System local encoding
+std::string UniConv::ToLocaleFromUtf8(const std::string& input) {
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    auto result = ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str());
+    return result.IsSuccess() ? std::move(result).GetValue() : "";
+}
+
+std::string UniConv::ToLocaleFromUtf8(const char* input) {
+    if (!input) return "";
+    return ToLocaleFromUtf8(std::string(input));
+}
+
+// System local encoding -> UTF-16LE
+std::u16string UniConv::ToUtf16LEFromLocale(const std::string& input) {
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), UniConv::ToString(UniConv::Encoding::utf_16le).c_str());
+    if (result.IsSuccess()) {
+        auto value = std::move(result).GetValue();
+        if (value.size() % 2 == 0) {
+            return std::u16string(reinterpret_cast<const char16_t*>(value.data()),
+                                 value.size() / 2);
+        }
+    }
+    return std::u16string();
+}
+
+std::u16string UniConv::ToUtf16LEFromLocale(const char* input) {
+    if (!input) return std::u16string();
+    return ToUtf16LEFromLocale(std::string(input));
+}
+
+// System local encoding -> UTF-16BE
+std::u16string UniConv::ToUtf16BEFromLocale(const std::string& input) {
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16BE);
+    if (result.IsSuccess()) {
+        auto value = std::move(result).GetValue();
+        if (value.size() % 2 == 0) {
+            return std::u16string(reinterpret_cast<const char16_t*>(value.data()), 
+                                 value.size() / 2);
+        }
+    }
+    return std::u16string();
+}
+
+std::u16string UniConv::ToUtf16BEFromLocale(const char* input) {
+    if (!input) return std::u16string();
+    return ToUtf16BEFromLocale(std::string(input));
+}
+
+// UTF-16BE -> System local encoding
+std::string UniConv::ToLocaleFromUtf16BE(const std::u16string& input) {
+    if (input.empty()) return "";
+
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+    auto result = ConvertEncodingFast(input_bytes, ToString(UniConv::Encoding::utf_16be).c_str(), currentEncoding.c_str());
+    return result.IsSuccess() ? std::move(result).GetValue() : "";
+}
+
+std::string UniConv::ToLocaleFromUtf16BE(const char16_t* input) {
+    if (!input) return "";
+    return ToLocaleFromUtf16BE(std::u16string(input));
+}
+
+// UTF-16LE -> UTF-8
+std::string UniConv::ToUtf8FromUtf16LE(const std::u16string& input) {
+    std::string output;
+    ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF8, input.data(), input.size() * sizeof(char16_t), output);
+    return output;
+}
+
+// ===================== UTF-16LE with length parameter overloads =====================
+std::string UniConv::ToUtf8FromUtf16LE(const char16_t* input, size_t len) {
+    std::string output;
+    if (input) {
+        ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF8, input, len * sizeof(char16_t), output);
+    }
+    return output;
+}
+
+std::string UniConv::ToUtf8FromUtf16LE(const char16_t* input) {
+    if (!input) return "";
+    return ToUtf8FromUtf16LE(std::u16string(input));
+}
+
+// UTF-16BE -> UTF-8
+std::string UniConv::ToUtf8FromUtf16BE(const std::u16string& input) {
+    std::string output;
+    ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF8, input.data(), input.size() * sizeof(char16_t), output);
+    return output;
+}
+
+std::string UniConv::ToUtf8FromUtf16BE(const char16_t* input, size_t len) {
+    std::string output;
+    if (input) {
+        ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF8, input, len * sizeof(char16_t), output);
+    }
+    return output;
+}
+
+std::string UniConv::ToUtf8FromUtf16BE(const char16_t* input) {
+    if (!input) return "";
+    return ToUtf8FromUtf16BE(std::u16string(input));
+}
+
+// UTF-8 -> UTF-16LE
+std::u16string UniConv::ToUtf16LEFromUtf8(const std::string& input) {
+    std::u16string output;
+    ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16LE, input.data(), input.size(), output);
+    return output;
+}
+
+std::u16string UniConv::ToUtf16LEFromUtf8(const char* input) {
+    if (!input) return std::u16string();
+    return ToUtf16LEFromUtf8(std::string(input));
+}
+
+// UTF-8 -> UTF-16BE
+std::u16string UniConv::ToUtf16BEFromUtf8(const std::string& input) {
+    std::u16string output;
+    ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16BE, input.data(), input.size(), output);
+    return output;
+}
+
+std::u16string UniConv::ToUtf16BEFromUtf8(const char* input) {
+    if (!input) return std::u16string();
+    return ToUtf16BEFromUtf8(std::string(input));
+}
+
+// UTF-16LE -> UTF-16BE
+std::u16string UniConv::ToUtf16BEFromUtf16LE(const std::u16string& input) {
+    std::u16string output;
+    ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF16BE, input.data(), input.size() * sizeof(char16_t), output);
+    return output;
+}
+
+std::u16string UniConv::ToUtf16BEFromUtf16LE(const char16_t* input) {
+    if (!input) return std::u16string();
+    return ToUtf16BEFromUtf16LE(std::u16string(input));
+}
+
+// UTF-16BE -> UTF-16LE
+std::u16string UniConv::ToUtf16LEFromUtf16BE(const std::u16string& input) {
+    std::u16string output;
+    ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF16LE, input.data(), input.size() * sizeof(char16_t), output);
+    return output;
+}
+
+std::u16string UniConv::ToUtf16LEFromUtf16BE(const char16_t* input) {
+    if (!input) return std::u16string();
+    size_t len = 0;
+    while (input[len] != 0) ++len;
+    return ToUtf16LEFromUtf16BE(std::u16string(input, len));
+}
+
+// New standardized method implementations
+std::wstring UniConv::ToWideStringFromLocale(const std::string& input) {
+    if (input.empty()) return std::wstring{};
+    std::string currentEncoding = this->GetCurrentSystemEncoding();
+    auto result = this->ConvertEncodingFast(input, currentEncoding.c_str(), ENC_WCHAR);
+    if (!result.IsSuccess()) return std::wstring{};
+    auto value = std::move(result).GetValue();
+    if (value.size() % sizeof(wchar_t) == 0) {
+        return std::wstring(reinterpret_cast<const wchar_t*>(value.data()),
+                            value.size() / sizeof(wchar_t));
+    }
+    return std::wstring{};
+}
+
+std::wstring UniConv::ToWideStringFromLocale(const char* input) {
+	if (!input) return std::wstring{};
+	return this->ToWideStringFromLocale(std::string(input));
+}
+
+
+
+// New standardized method implementations
+std::string UniConv::ToLocaleFromWideString(const std::wstring& input)
+{
+	if (input.empty()) return std::string{};
+	std::string currentEncoding = this->GetCurrentSystemEncoding();
+	std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
+	auto result = this->ConvertEncodingFast(input_bytes, ENC_WCHAR, currentEncoding.c_str());
+	return result.IsSuccess() ? std::move(result).GetValue() : std::string{};
+}
+
+std::string UniConv::ToLocaleFromWideString(const wchar_t* input)
+{
+	return input ? this->ToLocaleFromWideString(std::wstring(input)) : std::string{};
+}
+
+
+
+// UTF-16LE -> Local
+std::string UniConv::ToLocaleFromUtf16LE(const std::u16string& input) {
+    if (input.empty()) return "";
+    
+    std::string currentEncoding = this->GetCurrentSystemEncoding();
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+    auto result = this->ConvertEncodingFast(input_bytes, ENC_UTF16LE, currentEncoding.c_str());
+    return result.IsSuccess() ? std::move(result).GetValue() : "";
+}
+
+std::string UniConv::ToLocaleFromUtf16LE(const char16_t* input) {
+    if (!input) return "";
+    return this->ToLocaleFromUtf16LE(std::u16string(input));
+}
+
+std::string UniConv::ToUtf8FromUtf32LE(const std::u32string& sInput)
+{
+    std::string output;
+    ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF8, sInput.data(), sInput.size() * sizeof(char32_t), output);
+    return output;
+}
+
+std::string UniConv::ToUtf8FromUtf32LE(const char32_t* sInput)
+{
+	if (!sInput) return std::string{};
+	return ToUtf8FromUtf32LE(std::u32string(sInput));
+}
+
+std::u16string UniConv::ToUtf16LEFromUtf32LE(const std::u32string& sInput)
+{
+    std::u16string output;
+    ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF16LE, sInput.data(), sInput.size() * sizeof(char32_t), output);
+    return output;
+}
+
+std::u16string UniConv::ToUtf16LEFromUtf32LE(const char32_t* sInput)
+{
+	if (!sInput) return std::u16string{};
+	return ToUtf16LEFromUtf32LE(std::u32string(sInput));
+}
+
+// New standardized method implementations
+std::u16string UniConv::ToUtf16BEFromUtf32LE(const std::u32string& input)
+{
+    std::u16string output;
+    ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF16BE, input.data(), input.size() * sizeof(char32_t), output);
+    return output;
+}
+
+std::u16string UniConv::ToUtf16BEFromUtf32LE(const char32_t* input)
+{
+   if (!input) return std::u16string{};
+   return ToUtf16BEFromUtf32LE(std::u32string(input));
+}
+
+
+
+// New standardized method implementations
+std::u32string UniConv::ToUtf32LEFromUtf8(const std::string& input)
+{
+    std::u32string output;
+    ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF32LE, input.data(), input.size(), output);
+    return output;
+}
+
+std::u32string UniConv::ToUtf32LEFromUtf8(const char* input)
+{
+	if (!input) return std::u32string{};
+	return ToUtf32LEFromUtf8(std::string(input));
+}
+
+
+
+// New standardized method implementations
+std::u32string UniConv::ToUtf32LEFromUtf16LE(const std::u16string& input)
+{
+    std::u32string output;
+    ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF32LE, input.data(), input.size() * sizeof(char16_t), output);
+    return output;
+}
+
+std::u32string UniConv::ToUtf32LEFromUtf16LE(const char16_t* input)
+{
+	if (input == nullptr) return std::u32string{};
+	return ToUtf32LEFromUtf16LE(std::u16string(input));
+}
+
+
+
+// New standardized method implementations
+std::u32string UniConv::ToUtf32LEFromUtf16BE(const std::u16string& input)
+{
+    std::u32string output;
+    ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF32LE, input.data(), input.size() * sizeof(char16_t), output);
+    return output;
+}
+
+std::u32string UniConv::ToUtf32LEFromUtf16BE(const char16_t* input)
+{
+	if (input == nullptr) return std::u32string{};
+	return ToUtf32LEFromUtf16BE(std::u16string(input));
+}
+
+
+
+// New standardized method implementations
+std::string UniConv::ToUtf8FromUcs4(const std::wstring& input)
+{
+    #if defined(_WIN32)
+        // Windows platform：Use Windows API WideCharToMultiByte
+        if (input.empty()) return std::string();
+    
+        int sizeRequired = WideCharToMultiByte(
+            CP_UTF8, 
+            0,
+            input.data(), 
+            (int)input.size(),
+            nullptr, 
+            0, 
+            nullptr,
+            nullptr);
+
+        if (sizeRequired <= 0)
+        {
+    		return std::string{}; // Error or empty string
+        }
+        std::vector<char> utf8Buffer(sizeRequired);
+        WideCharToMultiByte(CP_UTF8, 0, input.data(), (int)input.size(), utf8Buffer.data(), sizeRequired, nullptr, nullptr);
+        return std::string(utf8Buffer.begin(), utf8Buffer.end());
+
+    #elif defined(__linux__) || defined(__APPLE__)
+        if (input.empty()) return std::string();
+        std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
+        auto result = ConvertEncodingFast(input_bytes, ENC_WCHAR, ENC_UTF8);
+        return result.IsSuccess() ? std::move(result).GetValue() : std::string{};
+    #endif
+}
+
+std::wstring UniConv::ToUcs4FromUtf8(const std::string& input)
+{
+    if (input.empty()) return std::wstring{};
+    auto result = ConvertEncodingFast(input, ENC_UTF8, ENC_WCHAR);
+    if (result.IsSuccess()) {
+        auto value = std::move(result).GetValue();
+        if (value.size() % sizeof(wchar_t) == 0) {
+            return std::wstring(reinterpret_cast<const wchar_t*>(value.data()),
+                value.size() / sizeof(wchar_t));
+        }
+    }
+    return std::wstring{};
+}
+
+
+
+std::wstring UniConv::ToWStringFromU16String(const std::u16string& input)
+{
+    if (input.empty()) return std::wstring{};
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_WCHAR);
+    if (result.IsSuccess()) {
+        auto value = std::move(result).GetValue();
+        if (value.size() % sizeof(wchar_t) == 0) {
+            return std::wstring(reinterpret_cast<const wchar_t*>(value.data()),
+                value.size() / sizeof(wchar_t));
+        }
+    }
+    return std::wstring{};
+}
+
+std::wstring UniConv::ToWStringFromU16String(const char16_t* input)
+{
+    if (!input) return std::wstring{};
+    return ToWStringFromU16String(std::u16string(input));
+}
+
+// ===================== Error Handling Related =====================
+
+UniConv::IconvLease UniConv::GetIconvDescriptor(const char* fromcode, const char* tocode)
+{
+	// 参数有效性检查 - 预测参数通常有效
+	if (UNICONV_UNLIKELY(!fromcode || !tocode)) {
+        m_cacheMissCount.fetch_add(1, std::memory_order_relaxed);
+        return IconvLease{};
+    }
+
+    // 使用预计算哈希作为缓存键 - 避免字符串拼接分配
+    const size_t from_len = strlen(fromcode);
+    const size_t to_len   = strlen(tocode);
+    return GetIconvDescriptorByKey(detail::MakeEncodingPairKey(fromcode, from_len, tocode, to_len),
+                                   fromcode, tocode);
+}
+
+UniConv::IconvLease UniConv::GetIconvDescriptorByKey(uint64_t key, const char* fromcode, const char* tocode)
+{
+    // 热路径：线程私有缓存命中 - 只置引用位、钉住槽位，无原子操作、无时钟读取、无共享写入
+    // 上一次转换留下的状态（UTF-16/32 是否已写出 BOM、移位状态）必须清除，否则同一线程的后续调用输出不同
+    auto& local_cache = GetCache();
+    if (ThreadLocalCache::Slot* cached = local_cache.Find(key)) {
+        portable_iconv(static_cast<iconv_t>(cached->handle), nullptr, nullptr, nullptr, nullptr);
+        return IconvLease::Borrow(cached->handle, &cached->pins);
+    }
+
+    // 冷路径：从全局空闲池签出（取得独占所有权），iconv_t 带有移位状态，
+    // 同一描述符绝不能同时被两个线程使用
+    void* handle = m_idleDescriptors.Take(key);
+    if (handle) {
+        m_cacheHitCount.fetch_add(1, std::memory_order_relaxed);
+        // 上一个持有者可能在不完整序列处中止，签出时重置移位状态
+        portable_iconv(static_cast<iconv_t>(handle), nullptr, nullptr, nullptr, nullptr);
+    } else {
+        m_cacheMissCount.fetch_add(1, std::memory_order_relaxed);
+
+        TraceScope trace(TraceSpanKind::DescriptorOpen, fromcode, tocode, 0);
+        iconv_t cd = iconv_open(tocode, fromcode);
+        if (UNICONV_UNLIKELY(cd == reinterpret_cast<iconv_t>(-1))) {
+            trace.Finish(ConversionPath::Iconv, 0, ErrorCode::ConversionFailed);
+            #if defined(UNICONV_DEBUG_MODE) && UNICONV_DEBUG_MODE
+            // std::cout << "iconv_open error for " << fromcode << ">" << tocode << std::endl;
+            #endif
+            return IconvLease{};
+        }
+        trace.Finish(ConversionPath::Iconv, 0, ErrorCode::Success);
+        handle = static_cast<void*>(cd);
+    }
+
+    // 交给当前线程持有；被挤出线程缓存的描述符归还全局空闲池而不是关闭
+    std::pair<uint64_t, void*> evicted;
+    ThreadLocalCache::Slot* slot = local_cache.Insert(key, handle, evicted);
+    if (UNICONV_UNLIKELY(!slot)) {
+        // 所有槽位都在借出中（深度嵌套），调用方独占该描述符，用完即关闭
+        return IconvLease::Adopt(handle);
+    }
+    ReleaseIconvDescriptor(evicted.first, evicted.second);
+
+    #if defined(UNICONV_DEBUG_MODE) && UNICONV_DEBUG_MODE
+        // std::wcout << "Create and cached iconv descriptor: " << fromcode << ">" << tocode << std::endl;
+    #endif
+
+    return IconvLease::Borrow(slot->handle, &slot->pins);
+}
+
+void UniConv::ReleaseIconvDescriptor(uint64_t key, void* descriptor) noexcept
+{
+    if (!descriptor) {
+        return;
+    }
+    // 分片已满时挤出该分片指针处最早放入的描述符
+    if (void* overflow = m_idleDescriptors.Put(key, descriptor)) {
+        IconvDeleter()(overflow);
+        m_cacheEvictionCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void* UniConv::IdleDescriptorPool::Take(uint64_t key) noexcept
+{
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (size_t i = 0; i < SHARD_SLOTS; ++i) {
+        if (shard.handles[i] && shard.keys[i] == key) {
+            void* handle = shard.handles[i];
+            shard.handles[i] = nullptr;
+            return handle;
+        }
+    }
+    return nullptr;
+}
+
+void* UniConv::IdleDescriptorPool::Put(uint64_t key, void* handle) noexcept
+{
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (size_t i = 0; i < SHARD_SLOTS; ++i) {
+        if (!shard.handles[i]) {
+            shard.keys[i] = key;
+            shard.handles[i] = handle;
+            return nullptr;
+        }
+    }
+    // 已满：替换指针处的槽位并前移指针，被替换的描述符由调用方在锁外关闭
+    const size_t victim = shard.hand;
+    shard.hand = (shard.hand + 1) % SHARD_SLOTS;
+    void* evicted = shard.handles[victim];
+    shard.keys[victim] = key;
+    shard.handles[victim] = handle;
+    return evicted;
+}
+
+void UniConv::IdleDescriptorPool::Clear() noexcept
+{
+    for (Shard& shard : shards_) {
+        void* handles[SHARD_SLOTS];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            std::copy(std::begin(shard.handles), std::end(shard.handles), handles);
+            std::fill(std::begin(shard.handles), std::end(shard.handles), nullptr);
+        }
+        for (void* handle : handles) {
+            IconvDeleter()(handle);
+        }
+    }
+}
+
+size_t UniConv::IdleDescriptorPool::Size() const noexcept
+{
+    size_t size = 0;
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        size += static_cast<size_t>(std::count_if(std::begin(shard.handles), std::end(shard.handles),
+                                                  [](void* handle) { return handle != nullptr; }));
+    }
+    return size;
+}
+
+std::pair<UniConv::BomEncoding, std::string_view> UniConv::DetectAndRemoveBom(const std::string_view& data)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    size_t len = data.size();
+
+    // UTF-8 BOM (3 bytes)
+    if (len >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+        return { BomEncoding::UTF8, data.substr(3) };
+    
+    // UTF-32 检测必须在 UTF-16 之前！（UTF-32LE BOM 以 FF FE 开头，会被误判为 UTF-16LE）
+    if (len >= 4 && bytes[0] == 0xFF && bytes[1] == 0xFE && bytes[2] == 0x00 && bytes[3] == 0x00)
+        return { BomEncoding::UTF32_LE, data.substr(4) };
+    if (len >= 4 && bytes[0] == 0x00 && bytes[1] == 0x00 && bytes[2] == 0xFE && bytes[3] == 0xFF)
+        return { BomEncoding::UTF32_BE, data.substr(4) };
+    
+    // UTF-16 检测（在 UTF-32 之后）
+    if (len >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE)
+        return { BomEncoding::UTF16_LE, data.substr(2) };
+    if (len >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF)
+        return { BomEncoding::UTF16_BE, data.substr(2) };
+
+    return { BomEncoding::None, data };
+}
+
+std::pair<UniConv::BomEncoding, std::wstring_view> UniConv::DetectAndRemoveBom(const std::wstring_view& data)
+{
+    if (data.empty()) {
+        return { BomEncoding::None, data };
+    }
+
+    if constexpr (sizeof(wchar_t) == 2) {
+        // Windows ：UTF-16
+        if (data[0] == 0xFEFF)
+            return { BomEncoding::UTF16_BE, data.substr(1) };
+        if (data[0] == 0xFFFE)
+            return { BomEncoding::UTF16_LE, data.substr(1) };
+    }
+    else if constexpr (sizeof(wchar_t) == 4) {
+        // Linux/macOS：UTF-32
+        if (data.size() >= 1 && data[0] == 0x0000FEFF)
+            return { BomEncoding::UTF32_BE, data.substr(1) };
+        if (data.size() >= 1 && data[0] == 0xFFFE0000)
+            return { BomEncoding::UTF32_LE, data.substr(1) };
+    }
+
+    return { BomEncoding::None, data };
+}
+
+EncodingDetection UniConv::DetectEncoding(std::string_view input, size_t maxProbeBytes) noexcept {
+    EncodingDetection result;
+    auto add = [&result](const char* encoding, float confidence) {
+        if (result.count < EncodingDetection::MAX_CANDIDATES) {
+            result.candidates[result.count++] = {encoding, confidence};
+        }
+    };
+
+    const auto [bom, payload] = DetectAndRemoveBom(input);
+    result.bom_size = input.size() - payload.size();
+    switch (bom) {
+        case BomEncoding::UTF8:     add(ENC_UTF8, 1.0f); return result;
+        case BomEncoding::UTF16_LE: add(ENC_UTF16LE, 1.0f); return result;
+        case BomEncoding::UTF16_BE: add(ENC_UTF16BE, 1.0f); return result;
+        case BomEncoding::UTF32_LE: add(ENC_UTF32LE, 1.0f); return result;
+        case BomEncoding::UTF32_BE: add("UTF-32BE", 1.0f); return result;
+        case BomEncoding::None:     break;
+    }
+
+    const size_t probe = (maxProbeBytes == 0) ? payload.size() : (std::min)(payload.size(), maxProbeBytes);
+    const bool truncated = probe < payload.size();
+    const auto* data = reinterpret_cast<const uint8_t*>(payload.data());
+    result.probed_bytes = probe;
+    if (probe == 0) {
+        return result;
+    }
+
+    float wide_confidence = 0.0f;
+    if (const char* wide = DetectWideByNulPattern(data, probe - (truncated ? probe % 4 : 0), wide_confidence)) {
+        add(wide, wide_confidence);
+        return result;
+    }
+
+    float confidence[kDetectCandidateCount];
+    if (DetectAsciiCompatible(data, probe, truncated, confidence)) {
+        // 纯 ASCII 对所有 ASCII 兼容编码都相同；只读了前缀时其后的内容未知
+        add(ENC_UTF8, truncated ? 0.5f : 1.0f);
+        return result;
+    }
+
+    size_t order[kDetectCandidateCount];
+    for (size_t k = 0; k < kDetectCandidateCount; ++k) order[k] = k;
+    std::stable_sort(order, order + kDetectCandidateCount,
+                     [&confidence](size_t a, size_t b) { return confidence[a] > confidence[b]; });
+    for (const size_t k : order) {
+        if (confidence[k] <= 0.0f) break;
+        add(kDetectCandidateNames[k], confidence[k]);
+    }
+    return result;
+}
+
+
+void UniConv::CleanupIconvCache() {
+    m_idleDescriptors.Clear();
+    
+    #if defined(UNICONV_DEBUG_MODE) && UNICONV_DEBUG_MODE
+        // std::cout << "iconv descriptor cache cleared" << std::endl;
+    #endif
+}
+
+std::string UniConv::ToString(UniConv::Encoding  enc) noexcept {
+    int idx = static_cast<int>(enc);
+    if (idx >= 0 && idx < static_cast<int>(Encoding::count))
+        return kInternedNames[idx];
+    return {};
+}
+
+UniConv::EncodingHandle UniConv::InternEncoding(const char* name) noexcept {
+    if (UNICONV_UNLIKELY(!name || !*name)) {
+        return EncodingHandle{};
+    }
+
+    // 规范名（不区分大小写）查编译期完美哈希表；别名按 EncodingId 映射到该 ID 的第一个规范名；
+    // 其余 IsValidEncodingName 接受的码页对照名称使用排在 encodings.inc 之后的句柄
+    if (const RegistryEntry* entry = kInternRegistry.Find(name)) {
+        return EncodingHandle(static_cast<Encoding>(entry->value));
+    }
+    static const std::array<uint16_t, 256> by_id = [] {
+        std::array<uint16_t, 256> table;
+        table.fill(static_cast<uint16_t>(Encoding::count));
+        for (size_t i = 0; i < kInternedCount; ++i) {
+            const auto id = static_cast<uint8_t>(GetEncodingId(kInternedNames[i]));
+            if (static_cast<EncodingId>(id) != EncodingId::Unknown &&
+                table[id] == static_cast<uint16_t>(Encoding::count)) {
+                table[id] = static_cast<uint16_t>(i);
+            }
+        }
+        return table;
+    }();
+    const uint16_t index = by_id[static_cast<uint8_t>(GetEncodingId(name))];
+    if (index < kInternedCount) {
+        return EncodingHandle(static_cast<Encoding>(index));
+    }
+    const RegistryEntry* extra = kInternExtraRegistry.Find(name);
+    return extra ? EncodingHandle(extra->value) : EncodingHandle{};
+}
+
+const char* UniConv::GetEncodingName(EncodingHandle encoding) noexcept {
+    return encoding.IsValid() ? HandleName(encoding.Index()) : nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// === High-Performance Methods Implementation ===
+//----------------------------------------------------------------------------------------------------------------------
+
+StringResult UniConv::ConvertEncodingFast(const std::string& input,const char* fromEncoding, const char* toEncoding) noexcept {
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        return StringResult::Failure(ErrorCode::InvalidParameter);
+    }
+
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        return StringResult::Failure(ErrorCode::InvalidSourceEncoding);
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        return StringResult::Failure(ErrorCode::InvalidTargetEncoding);
+    }
+
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return StringResult::Success(std::string{});
+    }
+
+    std::string result;
+    const ErrorCode ec = ConvertPlanned(MakePairPlan(fromEncoding, toEncoding), fromEncoding, toEncoding,
+                                        input, result);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return StringResult::Failure(ec);
+    }
+    return StringResult::Success(std::move(result));
+}
+
+const char* UniConv::GetEncodingNamePtr(int codepage) noexcept {
+    // 预测codepage存在于映射中
+    const CodePageInfo* info = FindCodePageInfo(static_cast<std::uint16_t>(codepage));
+    return UNICONV_LIKELY(info != nullptr) ? info->dotNetName : nullptr;
+}
+
+StringViewResult UniConv::GetEncodingNameFast(int codepage) noexcept {
+    // 预测codepage存在于映射中
+    const CodePageInfo* info = FindCodePageInfo(static_cast<std::uint16_t>(codepage));
+    if (UNICONV_LIKELY(info != nullptr)) {
+        return StringViewResult::Success(std::string_view{info->dotNetName});
+    } else {
+        return StringViewResult::Failure(ErrorCode::EncodingNotFound);
+    }
+}
+
+IntResult UniConv::GetSystemCodePageFast() noexcept {
+#ifdef _WIN32
+    UINT codepage = GetACP();
+    return IntResult::Success(static_cast<int>(codepage));
+#elif defined(__linux__) || defined(__APPLE__)
+    setlocale(LC_ALL, "");
+    char* encoding = nl_langinfo(CODESET);
+    if (encoding) {
+        if (const RegistryEntry* entry = FindNameCodePage(encoding)) {
+            return IntResult::Success(static_cast<int>(entry->value));
+        }
+    }
+    return IntResult::Failure(ErrorCode::EncodingNotFound);
+#else
+    return IntResult::Failure(ErrorCode::SystemError);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// === High-Performance Internal Methods Implementation ===
+//----------------------------------------------------------------------------------------------------------------------
+
+// ===================================================================================================================
+// Encoding-Aware Output Size Estimation (P3 Optimization)
+// ===================================================================================================================
+
+namespace {
+    // Encoding expansion factor table (from_id, to_id) -> factor
+    // Factor < 1.0 means output is smaller, > 1.0 means output is larger
+    constexpr double GetExpansionFactor(EncodingId from, EncodingId to) noexcept {
+        // Same encoding family optimizations
+        if (from == to) return 1.0;
+        
+        // UTF-8 conversions
+        if (from == EncodingId::UTF8) {
+            switch (to) {
+                case EncodingId::UTF16:
+                case EncodingId::UTF16LE:
+                case EncodingId::UTF16BE:
+                    return 2.0;  // UTF-8 can expand to 2x in UTF-16
+                case EncodingId::UTF32:
+                case EncodingId::UTF32LE:
+                case EncodingId::UTF32BE:
+                    return 4.0;  // UTF-8 can expand to 4x in UTF-32
+                case EncodingId::ASCII:
+                    return 1.0;  // ASCII subset stays same
+                case EncodingId::GBK:
+                case EncodingId::GB2312:
+                case EncodingId::GB18030:
+                case EncodingId::BIG5:
+                    return 1.0;  // Similar size for CJK
+                default:
+                    return 1.5;
+            }
+        }
+        
+        // UTF-16 conversions
+        if (from == EncodingId::UTF16 || from == EncodingId::UTF16LE || from == EncodingId::UTF16BE) {
+            switch (to) {
+                case EncodingId::UTF8:
+                    return 1.5;  // UTF-16 to UTF-8 usually similar or smaller
+                case EncodingId::UTF32:
+                case EncodingId::UTF32LE:
+                case EncodingId::UTF32BE:
+                    return 2.0;  // Each UTF-16 unit becomes 4 bytes
+                case EncodingId::ASCII:
+                    return 0.5;  // 2 bytes -> 1 byte for ASCII range
+                case EncodingId::GBK:
+                case EncodingId::GB2312:
+                case EncodingId::GB18030:
+                    return 1.0;  // Similar size
+                default:
+                    return 1.0;
+            }
+        }
+        
+        // UTF-32 conversions
+        if (from == EncodingId::UTF32 || from == EncodingId::UTF32LE || from == EncodingId::UTF32BE) {
+            switch (to) {
+                case EncodingId::UTF8:
+                    return 1.0;  // UTF-32 to UTF-8 usually shrinks
+                case EncodingId::UTF16:
+                case EncodingId::UTF16LE:
+                case EncodingId::UTF16BE:
+                    return 0.5;  // 4 bytes -> 2 bytes typical
+                default:
+                    return 0.5;
+            }
+        }
+        
+        // CJK encodings (GBK, GB2312, GB18030, BIG5)
+        if (from == EncodingId::GBK || from == EncodingId::GB2312 || 
+            from == EncodingId::GB18030 || from == EncodingId::BIG5) {
+            switch (to) {
+                case EncodingId::UTF8:
+                    return 1.5;  // CJK characters: 2 bytes -> 3 bytes
+                case EncodingId::UTF16:
+                case EncodingId::UTF16LE:
+                case EncodingId::UTF16BE:
+                    return 1.0;  // Similar size
+                case EncodingId::UTF32:
+                case EncodingId::UTF32LE:
+                case EncodingId::UTF32BE:
+                    return 2.0;  // 2 bytes -> 4 bytes
+                default:
+                    return 1.2;
+            }
+        }
+        
+        // ASCII/single-byte codepage conversions
+        if (from == EncodingId::ASCII || IsSbcsId(from)) {
+            switch (to) {
+                case EncodingId::UTF8:
+                    return 1.5;  // Extended ASCII chars become multi-byte
+                case EncodingId::UTF16:
+                case EncodingId::UTF16LE:
+                case EncodingId::UTF16BE:
+                    return 2.0;  // 1 byte -> 2 bytes
+                case EncodingId::UTF32:
+                case EncodingId::UTF32LE:
+                case EncodingId::UTF32BE:
+                    return 4.0;  // 1 byte -> 4 bytes
+                default:
+                    return 1.2;
+            }
+        }
+        
+        // Default: conservative estimate
+        return 2.0;
+    }
+}
+
+size_t UniConv::EstimateOutputSize(size_t input_size, const char* from_encoding, const char* to_encoding) noexcept {
+    return EstimateOutputSizeById(input_size,
+                                  static_cast<uint8_t>(GetEncodingId(from_encoding)),
+                                  static_cast<uint8_t>(GetEncodingId(to_encoding)));
+}
+
+size_t UniConv::EstimateOutputSizeById(size_t input_size, uint8_t from_raw, uint8_t to_raw) noexcept {
+    if (input_size == 0) return 512;
+
+    auto from_id = static_cast<EncodingId>(from_raw);
+    auto to_id   = static_cast<EncodingId>(to_raw);
+
+    if (from_id == to_id && from_id != EncodingId::Unknown) {
+        return input_size + 16;
+    }
+
+    double expansion_factor = GetExpansionFactor(from_id, to_id);
+    double estimated = static_cast<double>(input_size) * expansion_factor * 1.15;
+
+    constexpr size_t MIN_BUFFER_SIZE = 512;
+    constexpr size_t MAX_REASONABLE_SIZE = 32 * 1024 * 1024;
+
+    return std::clamp(static_cast<size_t>(estimated), MIN_BUFFER_SIZE, MAX_REASONABLE_SIZE);
+}
+
+bool UniConv::IsValidEncodingName(const char* encoding) noexcept {
+    if (UNICONV_UNLIKELY(!encoding || *encoding == '\0')) {
+        return false;
+    }
+    // 编译期完美哈希表：一次哈希、一次名称比较，无静态初始化、无 std::string 构造
+    return kEncodingRegistry.Find(encoding) != nullptr;
+}
+
+constexpr int UniConv::GetEncodingMultiplier(const char* encoding) noexcept {
+    if (!encoding) return 4;
+
+    std::string_view enc{encoding};
+
+    // UTF编码
+    if (enc.find("UTF-32") != std::string_view::npos ||
+        enc.find("UCS-4") != std::string_view::npos) return 4;
+
+    if (enc.find("UTF-16") != std::string_view::npos ||
+        enc.find("UCS-2") != std::string_view::npos) return 4;  // 考虑代理对
+
+    if (enc.find("UTF-8") != std::string_view::npos) return 4;
+
+    // 中文编码
+    if (enc.find("GBK") != std::string_view::npos ||
+        enc.find("GB2312") != std::string_view::npos ||
+        enc.find("GB18030") != std::string_view::npos) return 4;  // GB18030可达4字节
+
+    if (enc.find("Big5") != std::string_view::npos) return 2;
+
+    // 欧洲编码
+    if (enc.find("ISO-8859") != std::string_view::npos) return 1;
+
+    if (enc.find("CP1252") != std::string_view::npos) return 1;
+    
+    // 日文编码
+    if (enc.find("SHIFT_JIS") != std::string_view::npos ||
+        enc.find("EUC-JP") != std::string_view::npos) return 3;
+    
+    // 默认保守估计
+    return 4;
+}
+
+StringResult UniConv::ConvertEncodingInternal(const std::string& input,const char* fromEncoding,const char* toEncoding,StringBufferPool::BufferLease& buffer_lease,size_t estimated_size,size_t ascii_prefix) noexcept {
+    // 更新统计
+    m_totalConversions.fetch_add(1, std::memory_order_relaxed);
+
+    // 获取缓冲区
+    std::string& result = buffer_lease.get();
+    result.clear();
+
+    // 预分配容量，前导 ASCII 段直接复制
+    try {
+        result.reserve(estimated_size);
+        result.append(input.data(), ascii_prefix);
+    } catch (...) {
+        return StringResult::Failure(ErrorCode::OutOfMemory);
+    }
+
+    // 获取iconv描述符
+    auto descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
+    if (!descriptor) {
+        return StringResult::Failure(ErrorCode::InvalidSourceEncoding);
+    }
+
+    // 准备转换参数（跳过已复制的 ASCII 前缀）
+    const char* inbuf = input.data() + ascii_prefix;
+    size_t inbytesleft = input.size() - ascii_prefix;
+
+    //  16 字节对齐的栈缓冲区，利于缓存行和 SIMD 操作
+    constexpr size_t CHUNK_SIZE = 8192;
+    alignas(16) char temp_chunk[CHUNK_SIZE];
+
+    // 转换循环
+    constexpr int MAX_ITERATIONS = 1000;  // 防止无限循环
+    int iteration_count = 0;
+
+    while (inbytesleft > 0 && iteration_count < MAX_ITERATIONS) {
+        char* outbuf = temp_chunk;
+        size_t outbytesleft = CHUNK_SIZE;
+        
+        size_t converted = portable_iconv(static_cast<iconv_t>(descriptor.get()), &inbuf, &inbytesleft,&outbuf, &outbytesleft);
+        
+        // 添加已转换的数据到结果
+        size_t chunk_converted = CHUNK_SIZE - outbytesleft;
+        if (chunk_converted > 0) {
+            try {
+                result.append(temp_chunk, chunk_converted);
+            } catch (...) {
+                return StringResult::Failure(ErrorCode::OutOfMemory);
+            }
+        }
+        
+        if (converted == (size_t)-1) {
+            switch (errno) {
+                case E2BIG:
+                    // 输出缓冲区满，继续下一轮
+                    continue;
+                case EILSEQ:
+                    return StringResult::Failure(ErrorCode::InvalidSequence);
+                case EINVAL:
+                    return StringResult::Failure(ErrorCode::IncompleteSequence);
+                default:
+                    return StringResult::Failure(ErrorCode::ConversionFailed);
+            }
+        }
+        
+        ++iteration_count;
+    }
+    
+    if (iteration_count >= MAX_ITERATIONS) {
+        return StringResult::Failure(ErrorCode::InternalError);
+    }
+    
+    // 成功，返回结果
+    return StringResult::Success(std::move(result));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// === Batch Processing Methods Implementation ===
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<StringResult> UniConv::ConvertEncodingBatch(const std::vector<std::string>& inputs,const char* fromEncoding,const char* toEncoding) noexcept {
+    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
+        std::vector<StringResult> results;
+        results.reserve(inputs.size());
+        for (const auto& input : inputs) {
+            std::string output;
+            ErrorCode ec = ConvertEncodingStatelessFast(input, fromEncoding, toEncoding, output);
+            if (ec == ErrorCode::Success) {
+                results.emplace_back(StringResult::Success(std::move(output)));
+            } else {
+                results.emplace_back(StringResult::Failure(ec));
+            }
+        }
+        return results;
+    }
+
+    std::vector<StringResult> results;
+    results.reserve(inputs.size());
+    
+    // 参数验证 - 预测参数通常有效
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        // 为所有输入返回错误结果
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            results.emplace_back(StringResult::Failure(ErrorCode::InvalidParameter));
+        }
+        return results;
+    }
+    
+    // 快速编码名称有效性检查
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            results.emplace_back(StringResult::Failure(ErrorCode::InvalidSourceEncoding));
+        }
+        return results;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            results.emplace_back(StringResult::Failure(ErrorCode::InvalidTargetEncoding));
+        }
+        return results;
+    }
+    
+    if (UNICONV_LIKELY(!inputs.empty())) {
+        UNICONV_PREFETCH(inputs.data(), 0, 2);
+    }
+    
+    auto descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
+    if (UNICONV_UNLIKELY(!descriptor)) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            results.emplace_back(StringResult::Failure(ErrorCode::InvalidSourceEncoding));
+        }
+        return results;
+    }
+    
+    const EncodingId from_id = GetEncodingId(fromEncoding);
+    const EncodingId to_id   = GetEncodingId(toEncoding);
+    const bool same_encoding = AreSameEncoding(from_id, to_id, fromEncoding, toEncoding);
+    const bool both_ascii    = IsAsciiPassthroughPair(from_id, to_id);
+    const uint8_t from_raw   = static_cast<uint8_t>(from_id);
+    const uint8_t to_raw     = static_cast<uint8_t>(to_id);
+
+    for (const auto& input : inputs) {
+        if (input.empty()) {
+            results.emplace_back(StringResult::Success(std::string{}));
+            continue;
+        }
+        UNICONV_METRICS_CALL(metrics, fromEncoding, toEncoding, ConversionPath::Iconv, input.size());
+        
+        if (UNICONV_UNLIKELY(same_encoding)) {
+            UNICONV_METRICS_NOTE(metrics, path, ConversionPath::Copy);
+            UNICONV_METRICS_NOTE(metrics, bytesOut, input.size());
+            results.emplace_back(StringResult::Success(std::string(input)));
+            continue;
+        }
+        const size_t ascii_prefix = both_ascii ? AsciiPrefixLength(input) : 0;
+        if (ascii_prefix == input.size()) {
+            UNICONV_METRICS_NOTE(metrics, path, ConversionPath::AsciiShortcut);
+            UNICONV_METRICS_NOTE(metrics, bytesOut, input.size());
+            results.emplace_back(StringResult::Success(std::string(input)));
+            continue;
+        }
+        
+        size_t estimated = ascii_prefix + EstimateOutputSizeById(input.size() - ascii_prefix, from_raw, to_raw);
+        
+        auto buffer_lease = m_stringBufferPool.acquire(estimated);
+        if (!buffer_lease.valid()) {
+            UNICONV_METRICS_NOTE(metrics, status, ErrorCode::OutOfMemory);
+            results.emplace_back(StringResult::Failure(ErrorCode::OutOfMemory));
+            continue;
+        }
+        
+        results.emplace_back(ConvertEncodingInternal(input, fromEncoding, toEncoding, buffer_lease, estimated, ascii_prefix));
+        UNICONV_METRICS_NOTE(metrics, status, results.back().GetErrorCode());
+        UNICONV_METRICS_NOTE(metrics, bytesOut, results.back().IsSuccess() ? results.back().GetValue().size() : 0);
+    }
+    
+    return results;
+}
 
-const std::string UniConv::m_encodingNames[] = {
-    #define X(name, str) str,
-    #include <UniConv/encodings.inc>
-    #undef X
-};
+UniConv::PoolStats UniConv::GetPoolStatistics() const {
+    PoolStats stats;
+    stats.active_buffers = m_stringBufferPool.GetActiveBuffers();
+    stats.total_conversions = m_totalConversions.load(std::memory_order_relaxed);
+    stats.cache_hits = m_poolCacheHits.load(std::memory_order_relaxed);
+    
+    // 计算缓存命中率
+    if (stats.total_conversions > 0) {
+        stats.hit_rate = static_cast<double>(stats.cache_hits) / stats.total_conversions;
+    } else {
+        stats.hit_rate = 0.0;
+    }
+    
+    // 全局空闲描述符池统计（冷路径计数）
+    stats.iconv_cache_size = m_idleDescriptors.Size();
+    stats.iconv_cache_hits = m_cacheHitCount.load(std::memory_order_relaxed);
+    stats.iconv_cache_misses = m_cacheMissCount.load(std::memory_order_relaxed);
+    stats.iconv_cache_evictions = m_cacheEvictionCount.load(std::memory_order_relaxed);
+    
+    // 计算iconv命中率
+    const uint64_t total_iconv_requests = stats.iconv_cache_hits + stats.iconv_cache_misses;
+    stats.iconv_cache_hit_rate = (total_iconv_requests > 0) ? 
+        (static_cast<double>(stats.iconv_cache_hits) / total_iconv_requests) : 0.0;
+    
+    // 平均每个空闲槽位被签出的次数（条目签出即离开池，不再逐条目计数）
+    stats.iconv_avg_hit_count = stats.iconv_cache_size > 0
+        ? static_cast<double>(stats.iconv_cache_hits) / stats.iconv_cache_size : 0.0;
+    
+    return stats;
+}
 
-// Thread-safe default encoding management
-namespace {
-    std::atomic<const std::string*> g_defaultEncodingPtr{nullptr};
-    std::mutex g_defaultEncodingMutex;
+//----------------------------------------------------------------------------------------------------------------------
+// === Conversion Metrics ===
+//----------------------------------------------------------------------------------------------------------------------
+
+ConversionMetrics UniConv::GetConversionMetrics() {
+    ConversionMetrics snapshot;
+#if UNICONV_ENABLE_METRICS
+    snapshot.enabled = true;
+    const double secondsPerTick = 1.0 / MetricsTicksPerSecond();
+    for (size_t i = 0; i + 1 < PairMetrics::LATENCY_BUCKETS; ++i) {
+        snapshot.bucket_upper_seconds[i] = static_cast<double>(uint64_t(1) << (i + 1)) * secondsPerTick;
+    }
+    snapshot.bucket_upper_seconds[PairMetrics::LATENCY_BUCKETS - 1] = std::numeric_limits<double>::infinity();
+
+    std::unordered_map<uint64_t, size_t> merged;
+    std::vector<uint64_t> ticks;
+    const auto collect = [&](const MetricsShard& shard) {
+        for (const MetricsSeries& series : shard.series) {
+            auto it = merged.find(series.key);
+            if (it == merged.end()) {
+                it = merged.emplace(series.key, snapshot.pairs.size()).first;
+                PairMetrics entry;
+                entry.from_encoding = series.from;
+                entry.to_encoding   = series.to;
+                entry.path          = series.path;
+                snapshot.pairs.push_back(std::move(entry));
+                ticks.push_back(0);
+            }
+            const MetricsCounters counters = series.Read();
+            PairMetrics& entry = snapshot.pairs[it->second];
+            entry.calls     += counters.calls;
+            entry.errors    += counters.errors;
+            entry.bytes_in  += counters.bytesIn;
+            entry.bytes_out += counters.bytesOut;
+            ticks[it->second] += counters.ticks;
+            for (size_t i = 0; i < PairMetrics::LATENCY_BUCKETS; ++i) {
+                entry.latency_buckets[i] += counters.buckets[i];
+            }
+        }
+    };
+
+    MetricsRegistry& registry = GetMetricsRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (MetricsShard* shard : registry.shards) {
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            collect(*shard);
+        }
+        collect(registry.retired);
+    }
+    for (size_t i = 0; i < snapshot.pairs.size(); ++i) {
+        snapshot.pairs[i].total_nanoseconds = static_cast<uint64_t>(static_cast<double>(ticks[i]) * secondsPerTick * 1e9);
+    }
+    std::stable_sort(snapshot.pairs.begin(), snapshot.pairs.end(),
+                     [](const PairMetrics& a, const PairMetrics& b) { return a.calls > b.calls; });
+#endif // UNICONV_ENABLE_METRICS
+    return snapshot;
+}
+
+void UniConv::ResetConversionMetrics() noexcept {
+#if UNICONV_ENABLE_METRICS
+    //  计数器只由所属线程写入，这里只在分片锁下记录基线
+    const auto reset = [](MetricsShard& shard) {
+        for (MetricsSeries& series : shard.series) {
+            const MetricsCounters current = series.Read();
+            MetricsCounters& base = series.baseline;
+            base.calls    += current.calls;
+            base.errors   += current.errors;
+            base.bytesIn  += current.bytesIn;
+            base.bytesOut += current.bytesOut;
+            base.ticks    += current.ticks;
+            for (size_t i = 0; i < PairMetrics::LATENCY_BUCKETS; ++i) {
+                base.buckets[i] += current.buckets[i];
+            }
+        }
+    };
+
+    MetricsRegistry& registry = GetMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (MetricsShard* shard : registry.shards) {
+        std::lock_guard<std::mutex> shard_lock(shard->mutex);
+        reset(*shard);
+    }
+    reset(registry.retired);
+#endif // UNICONV_ENABLE_METRICS
+}
+
+const char* ConversionMetrics::PathName(ConversionPath path) noexcept {
+    switch (path) {
+        case ConversionPath::Copy:           return "copy";
+        case ConversionPath::AsciiShortcut:  return "ascii";
+        case ConversionPath::Simdutf:        return "simdutf";
+        case ConversionPath::Native:         return "native";
+        case ConversionPath::Iconv:          return "iconv";
+        case ConversionPath::StatelessIconv: return "iconv_stateless";
+    }
+    return "unknown";
+}
+
+std::string ConversionMetrics::ToPrometheusText() const {
+    std::string text;
+    text.reserve(1024 + pairs.size() * 4096);  // 每个序列约 35 行
+    std::string labels;
+    char number[64];
+
+    const auto append_label = [&labels](const char* name, const std::string& value) {
+        labels += name;
+        labels += "=\"";
+        for (char c : value) {
+            if (c == '\\' || c == '"') {
+                labels += '\\';
+                labels += c;
+            } else if (c == '\n') {
+                labels += "\\n";
+            } else {
+                labels += c;
+            }
+        }
+        labels += '"';
+    };
+    const auto make_labels = [&](const PairMetrics& entry) {
+        labels.clear();
+        append_label("from", entry.from_encoding);
+        labels += ',';
+        append_label("to", entry.to_encoding);
+        labels += ",path=\"";
+        labels += PathName(entry.path);
+        labels += '"';
+    };
+    const auto counter = [&](const char* name, const char* help, uint64_t PairMetrics::*field) {
+        text += "# HELP ";
+        text += name;
+        text += ' ';
+        text += help;
+        text += "\n# TYPE ";
+        text += name;
+        text += " counter\n";
+        for (const PairMetrics& entry : pairs) {
+            make_labels(entry);
+            std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(entry.*field));
+            text += name;
+            text += '{';
+            text += labels;
+            text += "} ";
+            text += number;
+            text += '\n';
+        }
+    };
+
+    counter("uniconv_conversions_total", "Conversion calls.", &PairMetrics::calls);
+    counter("uniconv_conversion_errors_total", "Conversion calls that returned an error.", &PairMetrics::errors);
+    counter("uniconv_conversion_bytes_in_total", "Input bytes consumed.", &PairMetrics::bytes_in);
+    counter("uniconv_conversion_bytes_out_total", "Output bytes produced.", &PairMetrics::bytes_out);
+
+    //  直方图：bucket i 的上界取 bucket_upper_seconds[i]，le 为累计计数，最后一桶只出现在 +Inf
+    const char* histogram = "uniconv_conversion_duration_seconds";
+    text += "# HELP uniconv_conversion_duration_seconds Conversion call latency.\n";
+    text += "# TYPE uniconv_conversion_duration_seconds histogram\n";
+    //  各序列共用同一组上界：格式化一次（浮点格式化远比整数慢）
+    std::array<std::string, PairMetrics::LATENCY_BUCKETS - 1> bounds;
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        std::snprintf(number, sizeof(number), ",le=\"%.9g\"} ", bucket_upper_seconds[i]);
+        bounds[i] = number;
+    }
+    for (const PairMetrics& entry : pairs) {
+        make_labels(entry);
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            cumulative += entry.latency_buckets[i];
+            std::snprintf(number, sizeof(number), "%llu\n", static_cast<unsigned long long>(cumulative));
+            text += histogram;
+            text += "_bucket{";
+            text += labels;
+            text += bounds[i];
+            text += number;
+        }
+        std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(entry.calls));
+        text += histogram;
+        text += "_bucket{";
+        text += labels;
+        text += ",le=\"+Inf\"} ";
+        text += number;
+        text += '\n';
+
+        text += histogram;
+        text += "_sum{";
+        text += labels;
+        std::snprintf(number, sizeof(number), "} %.9g\n", static_cast<double>(entry.total_nanoseconds) * 1e-9);
+        text += number;
+
+        text += histogram;
+        text += "_count{";
+        text += labels;
+        std::snprintf(number, sizeof(number), "} %llu\n", static_cast<unsigned long long>(entry.calls));
+        text += number;
+    }
+    return text;
 }
 
-std::string UniConv::m_defaultEncoding = {}; // Legacy static member (deprecated, kept for compatibility)
+//----------------------------------------------------------------------------------------------------------------------
+// === Conversion Tracing ===
+//----------------------------------------------------------------------------------------------------------------------
 
-/**************************  === UniConv m_encodingMap ===  ***************************/
-const std::unordered_map<std::uint16_t, UniConv::EncodingInfo> UniConv::m_encodingMap = {
-    {37,     {"IBM037",       "IBM EBCDIC US-Canada"}},
-    {437,    {"IBM437",       "OEM United States"}},
-    {850,    {"IBM850",       "OEM Multilingual Latin 1; Western European (DOS)"}},
-    {852,    {"IBM852",       "OEM Latin 2; Central European (DOS)"}},
-    {855,    {"IBM855",       "OEM Cyrillic (primarily Russian)"}},
-    {857,    {"IBM857",       "OEM Turkish; Turkish (DOS)"}},
-    {860,    {"IBM860",       "OEM Portuguese; Portuguese (DOS)"}},
-    {861,    {"IBM861",       "OEM Icelandic; Icelandic (DOS)"}},
-    {862,    {"DOS-862",      "OEM Hebrew; Hebrew (DOS)"}},
-    {863,    {"IBM863",       "OEM French Canadian; French Canadian (DOS)"}},
-    {865,    {"IBM865",       "OEM Nordic; Nordic (DOS)"}},
-    {866,    {"CP866",        "OEM Russian; Cyrillic (DOS)"}},
-    {874,    {"Windows-874",  "Thai (Windows)"}},
-    {932,    {"Shift_JIS",    "ANSI/OEM Japanese; Japanese (Shift-JIS)"}},
-    {936,    {"GB2312",       "ANSI/OEM Simplified Chinese (PRC, Singapore); Chinese Simplified (GB2312)"}},
-    {949,    {"KS_C_5601-1987", "ANSI/OEM Korean (Unified Hangul Code)"}},
-    {950,    {"Big5",         "ANSI/OEM Traditional Chinese (Taiwan; Hong Kong SAR, PRC); Chinese Traditional (Big5)"}},
-    {1200,   {"UTF-16",       "Unicode UTF-16, little endian byte order (BMP of ISO 10646); available only to managed applications"}},
-    {1201,   {"UTF-16BE",     "Unicode UTF-16, big endian byte order; available only to managed applications"}},
-    {1250,   {"Windows-1250", "ANSI Central European; Central European (Windows)"}},
-    {1251,   {"Windows-1251", "ANSI Cyrillic; Cyrillic (Windows)"}},
-    {1252,   {"Windows-1252", "ANSI Latin 1; Western European (Windows)"}},
-    {1253,   {"Windows-1253", "ANSI Greek; Greek (Windows)"}},
-    {1254,   {"Windows-1254", "ANSI Turkish; Turkish (Windows)"}},
-    {1255,   {"Windows-1255", "ANSI Hebrew; Hebrew (Windows)"}},
-    {1256,   {"Windows-1256", "ANSI Arabic; Arabic (Windows)"}},
-    {1257,   {"Windows-1257", "ANSI Baltic; Baltic (Windows)"}},
-    {1258,   {"Windows-1258", "ANSI/OEM Vietnamese; Vietnamese (Windows)"}},
-    {20866,  {"KOI8-R",       "Russian (KOI8-R); Cyrillic (KOI8-R)"}},
-    {21866,  {"KOI8-U",       "Ukrainian (KOI8-U); Cyrillic (KOI8-U)"}},
-    {28591,  {"ISO-8859-1",   "ISO 8859-1 Latin 1; Western European (ISO)"}},
-    {28592,  {"ISO-8859-2",   "ISO 8859-2 Central European; Central European (ISO)"}},
-    {28595,  {"ISO-8859-5",   "ISO 8859-5 Cyrillic"}},
-    {28597,  {"ISO-8859-7",   "ISO 8859-7 Greek"}},
-    {28599,  {"ISO-8859-9",   "ISO 8859-9 Turkish"}},
-    {28605,  {"ISO-8859-15",  "ISO 8859-15 Latin 9"}},
-    {50220,  {"ISO-2022-JP",  "ISO 2022 Japanese with no halfwidth Katakana; Japanese (JIS)"}},
-    {50225,  {"ISO-2022-KR",  "ISO 2022 Korean"}},
-    {51932,  {"EUC-JP",       "EUC Japanese"}},
-    {51936,  {"EUC-CN",       "EUC Simplified Chinese; Chinese Simplified (EUC)"}},
-    {51949,  {"EUC-KR",       "EUC Korean"}},
-    {52936,  {"HZ-GB-2312",   "HZ-GB2312 Simplified Chinese; Chinese Simplified (HZ)"}},
-    {54936,  {"GB18030",      "Windows XP and later: GB18030 Simplified Chinese (4 byte); Chinese Simplified (GB18030)"}},
-    {65000,  {"UTF-7",        "Unicode (UTF-7)"}},
-    {65001,  {"UTF-8",        "Unicode (UTF-8)"}}
-};
-
-/**************************  === UniConv m_encodingToCodePageMap ===  ***************************/
-const std::unordered_map<std::string, std::uint16_t> UniConv::m_encodingToCodePageMap = {
-    {"UTF-8",                  65001},    // Unicode (UTF-8)
-    {"ANSI_X3.4-1968",         20127},    // US-ASCII
-    {"ISO-8859-1",             28591},    // Latin-1
-    {"ISO-8859-2",             28592},    // Latin-2
-    {"ISO-8859-3",             28593},    // Latin-3
-    {"ISO-8859-4",             28594},    // Latin-4 (Baltic)
-    {"ISO-8859-5",             28595},    // Cyrillic
-    {"ISO-8859-6",             28596},    // Arabic
-    {"ISO-8859-7",             28597},    // Greek
-    {"ISO-8859-8",             28598},    // Hebrew
-    {"ISO-8859-9",             28599},    // Latin-5 (Turkish)
-    {"ISO-8859-10",            28600},    // Latin-6 (Nordic)
-    {"ISO-8859-11",            28601},    // Thai
-    {"ISO-8859-13",            28603},    // Latin-7 (Baltic Rim)
-    {"ISO-8859-14",            28604},    // Latin-8 (Celtic)
-    {"ISO-8859-15",            28605},    // Latin-9 (Western European with Euro)
-    {"ISO-8859-16",            28606},    // Latin-10 (South-Eastern European)
-    {"GB2312",                 936},      // Simplified Chinese
-    {"GBK",                    936},      // Simplified Chinese (GBK)
-    {"GB18030",                54936},    // Simplified Chinese (GB18030)
-    {"BIG5",                   950},      // Traditional Chinese
-    {"EUC-JP",                 20932},    // Japanese
-    {"EUC-KR",                 51949},    // Korean
-    {"KOI8-R",                 20866},    // Russian
-    {"KOI8-U",                 21866},    // Ukrainian
-    {"Windows-1250",           1250},     // Central European (Windows)
-    {"Windows-1251",           1251},     // Cyrillic (Windows)
-    {"Windows-1252",           1252},     // Western European (Windows)
-    {"Windows-1253",           1253},     // Greek (Windows)
-    {"Windows-1254",           1254},     // Turkish (Windows)
-    {"Windows-1255",           1255},     // Hebrew (Windows)
-    {"Windows-1256",           1256},     // Arabic (Windows)
-    {"Windows-1257",           1257},     // Baltic (Windows)
-    {"Windows-1258",           1258},     // Vietnamese (Windows)
-    {"Shift_JIS",              932},      // Japanese (Shift-JIS)
-    {"CP932",                  932},      // Japanese (Shift-JIS, Windows)
-    {"CP949",                  949},      // Korean (Unified Hangul Code, Windows)
-    {"CP950",                  950},      // Traditional Chinese (Big5, Windows)
-    {"CP866",                  866},      // Cyrillic (DOS)
-    {"CP850",                  850},      // Western European (DOS)
-    {"CP852",                  852},      // Central European (DOS)
-    {"CP855",                  855},      // Cyrillic (DOS, primarily Russian)
-    {"CP857",                  857},      // Turkish (DOS)
-    {"CP860",                  860},      // Portuguese (DOS)
-    {"CP861",                  861},      // Icelandic (DOS)
-    {"CP862",                  862},      // Hebrew (DOS)
-    {"CP863",                  863},      // French Canadian (DOS)
-    {"CP864",                  864},      // Arabic (DOS)
-    {"CP865",                  865},      // Nordic (DOS)
-    {"CP869",                  869},      // Modern Greek (DOS)
-    {"CP874",                  874},      // Thai (Windows)
-    {"CP1250",                 1250},     // Central European (Windows)
-    {"CP1251",                 1251},     // Cyrillic (Windows)
-    {"CP1252",                 1252},     // Western European (Windows)
-    {"CP1253",                 1253},     // Greek (Windows)
-    {"CP1254",                 1254},     // Turkish (Windows)
-    {"CP1255",                 1255},     // Hebrew (Windows)
-    {"CP1256",                 1256},     // Arabic (Windows)
-    {"CP1257",                 1257},     // Baltic (Windows)
-    {"CP1258",                 1258},     // Vietnamese (Windows)
-    {"MacRoman",               10000},    // Western European (Mac)
-    {"MacCyrillic",            10007},    // Cyrillic (Mac)
-    {"MacGreek",               10006},    // Greek (Mac)
-    {"MacTurkish",             10081},    // Turkish (Mac)
-    {"MacIcelandic",           10079},    // Icelandic (Mac)
-    {"MacCentralEurope",       10029},    // Central European (Mac)
-    {"MacThai",                10021},    // Thai (Mac)
-    {"MacJapanese",            10001},    // Japanese (Mac)
-    {"MacChineseTrad",         10002},    // Traditional Chinese (Mac)
-    {"MacChineseSimp",         10008},    // Simplified Chinese (Mac)
-    {"MacKorean",              10003},    // Korean (Mac)
-    {"MacArabic",              10004},    // Arabic (Mac)
-    {"MacHebrew",              10005},    // Hebrew (Mac)
-    {"TIS-620",                874},      // Thai (TIS-620)
-    {"ISCII-DEVANAGARI",       57002},    // ISCII Devanagari
-    {"ISCII-BENGALI",          57003},    // ISCII Bangla
-    {"ISCII-TAMIL",            57004},    // ISCII Tamil
-    {"ISCII-TELUGU",           57005},    // ISCII Telugu
-    {"ISCII-ASSAMESE",         57006},    // ISCII Assamese
-    {"ISCII-ORIYA",            57007},    // ISCII Odia
-    {"ISCII-KANNADA",          57008},    // ISCII Kannada
-    {"ISCII-MALAYALAM",        57009},    // ISCII Malayalam
-    {"ISCII-GUJARATI",         57010},    // ISCII Gujarati
-    {"ISCII-PUNJABI",          57011},    // ISCII Punjabi
-    {"VISCII",                 1258},     // Vietnamese (VISCII)
-    {"VPS",                    1258},     // Vietnamese (VPS)
-    {"UTF-16",                 1200},     // Unicode UTF-16 (Little Endian)
-    {"UTF-16BE",               1201},     // Unicode UTF-16 (Big Endian)
-    {"UTF-32",                 12000},    // Unicode UTF-32 (Little Endian)
-    {"UTF-32BE",               12001},    // Unicode UTF-32 (Big Endian)
-    {"UTF-7",                  65000},    // Unicode UTF-7
-    {"HZ-GB-2312",             52936},    // HZ-GB2312 Simplified Chinese
-    {"ISO-2022-JP",            50220},    // Japanese (ISO-2022-JP)
-    {"ISO-2022-KR",            50225},    // Korean (ISO-2022-KR)
-    {"ISO-2022-CN",            50227},    // Simplified Chinese (ISO-2022-CN)
-    {"EUC-TW",                 51950},    // Traditional Chinese (EUC-TW)
-    {"ARMSCII-8",              0},        // Armenian (ARMSCII-8, no Windows code page)
-    {"GEORGIAN-ACADEMY",       0},        // Georgian (Academy, no Windows code page)
-    {"GEORGIAN-PS",            0},        // Georgian (PS, no Windows code page)
-    {"TSCII",                  0},        // Tamil (TSCII, no Windows code page)
-    {"RK1048",                 0},        // Kazakh (RK1048, no Windows code page)
-    {"MULELAO-1",              0},        // Lao (MULELAO-1, no Windows code page)
-    {"TCVN",                   1258},     // Vietnamese (TCVN)
-    {"VISCII1.1",              1258},     // Vietnamese (VISCII 1.1)
-    {"VISCII1.1-HYBRID",       1258},     // Vietnamese (VISCII 1.1 Hybrid)
-};
+void UniConv::SetTraceHooks(const TraceHooks* hooks) noexcept {
+    g_traceHooks.store(hooks, std::memory_order_release);
+}
 
+const TraceHooks* UniConv::GetTraceHooks() noexcept {
+    return ActiveTraceHooks();
+}
 
+const char* TraceSpan::KindName(TraceSpanKind kind) noexcept {
+    switch (kind) {
+        case TraceSpanKind::Conversion:         return "uniconv.convert";
+        case TraceSpanKind::BatchParallel:      return "uniconv.batch_parallel";
+        case TraceSpanKind::BatchWorker:        return "uniconv.batch_worker";
+        case TraceSpanKind::BatchChunk:         return "uniconv.batch_chunk";
+        case TraceSpanKind::DescriptorOpen:     return "uniconv.iconv_open";
+        case TraceSpanKind::BufferPoolFallback: return "uniconv.buffer_pool_fallback";
+    }
+    return "uniconv.unknown";
+}
 
-void UniConv::SetDefaultEncoding(const std::string& encoding) noexcept
-{
-    // Thread-safe implementation using atomic pointer and mutex
-    std::lock_guard<std::mutex> lock(g_defaultEncodingMutex);
+namespace detail {
+
+const void* BeginBufferPoolFallbackSpan(size_t bytes) noexcept {
+    const TraceHooks* hooks = ActiveTraceHooks();
+    if (UNICONV_LIKELY(hooks == nullptr)) {
+        return nullptr;
+    }
+    TraceSpan span;
+    span.kind     = TraceSpanKind::BufferPoolFallback;
+    span.bytes_in = bytes;
+    EmitTraceBegin(hooks, span);
+    return hooks;
+}
+
+void EndBufferPoolFallbackSpan(const void* token, size_t bytes, bool allocated) noexcept {
+    if (UNICONV_LIKELY(token == nullptr)) {
+        return;
+    }
+    TraceSpan span;
+    span.kind     = TraceSpanKind::BufferPoolFallback;
+    span.bytes_in = bytes;
+    span.result   = allocated ? ErrorCode::Success : ErrorCode::OutOfMemory;
+    EmitTraceEnd(static_cast<const TraceHooks*>(token), span);
+}
+
+} // namespace detail
+
+//----------------------------------------------------------------------------------------------------------------------
+// === Enhanced convenience methods with detailed error handling ===
+//----------------------------------------------------------------------------------------------------------------------
+
+CompactResult<std::string> UniConv::ToUtf8FromLocaleEx(const std::string& input) {
+    if (input.empty()) {
+        return CompactResult<std::string>::Success(std::string{});
+    }
     
-    // Load old pointer
-    const std::string* old_ptr = g_defaultEncodingPtr.load(std::memory_order_relaxed);
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    return ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8);
+}
+
+CompactResult<std::string> UniConv::ToLocaleFromUtf8Ex(const std::string& input) {
+    if (input.empty()) {
+        return CompactResult<std::string>::Success(std::string{});
+    }
     
-    // Create new string
-    const std::string* new_ptr = new std::string(encoding);
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    return ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str());
+}
+
+CompactResult<std::u16string> UniConv::ToUtf16LEFromLocaleEx(const std::string& input) {
+    if (input.empty()) {
+        return CompactResult<std::u16string>::Success(std::u16string{});
+    }
     
-    // Atomically update pointer
-    g_defaultEncodingPtr.store(new_ptr, std::memory_order_release);
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16LE);
     
-    // Delete old string (safe because we hold the mutex)
-    delete old_ptr;
+    if (!result.IsSuccess()) {
+        return CompactResult<std::u16string>::Failure(result.GetErrorCode());
+    }
     
-    // Update legacy static member for backward compatibility
-    this->m_defaultEncoding = encoding;
+    const std::string& str = result.GetValue();
+    if (str.size() % 2 != 0) {
+        return CompactResult<std::u16string>::Failure(ErrorCode::InvalidSequence);
+    }
+    
+    return CompactResult<std::u16string>::Success(
+        std::u16string(reinterpret_cast<const char16_t*>(str.data()), str.size() / 2));
 }
 
-
-// ===================== System encoding related functions =====================
-std::string UniConv::GetCurrentSystemEncoding() noexcept
-{
-#if !UNICONV_NO_THREAD_LOCAL
-    // Check thread-local cache first (fast path)
-    if (t_cache.system_encoding_cached) {
-        return t_cache.system_encoding;
+CompactResult<std::u16string> UniConv::ToUtf16BEFromLocaleEx(const std::string& input) {
+    if (input.empty()) {
+        return CompactResult<std::u16string>::Success(std::u16string{});
     }
-#else
-    // Without thread_local, always compute dynamically
-    // This is less efficient but provides DLL compatibility
-#endif
     
-    // Check default encoding - need a static default since this is a static function
-    // For static functions, we cannot access instance members like m_defaultEncoding
-    // So we'll compute the system encoding each time when UNICONV_NO_THREAD_LOCAL is defined
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16BE);
     
-	std::stringstream ss;
-#ifdef _WIN32
-	UINT codePage = GetACP();
-	auto it = m_encodingMap.find(codePage);
-	if (it != m_encodingMap.end())
-        ss << it->second.dotNetName;
+    if (!result.IsSuccess()) {
+        return CompactResult<std::u16string>::Failure(result.GetErrorCode());
+    }
+    
+    const std::string& str = result.GetValue();
+    if (str.size() % 2 != 0) {
+        return CompactResult<std::u16string>::Failure(ErrorCode::InvalidSequence);
+    }
+    
+    return CompactResult<std::u16string>::Success(
+        std::u16string(reinterpret_cast<const char16_t*>(str.data()), str.size() / 2));
+}
 
-#endif // _WIN32
+CompactResult<std::string> UniConv::ToUtf8FromUtf16LEEx(const std::u16string& input) {
+    return ConvertUtfNativeResult<std::string>(EncodingId::UTF16LE, EncodingId::UTF8, input.data(), input.size() * sizeof(char16_t));
+}
 
+CompactResult<std::string> UniConv::ToUtf8FromUtf16BEEx(const std::u16string& input) {
+    return ConvertUtfNativeResult<std::string>(EncodingId::UTF16BE, EncodingId::UTF8, input.data(), input.size() * sizeof(char16_t));
+}
 
-#if defined(__linux__) || defined(__APPLE__)
-	setlocale(LC_ALL, "");
-	char* locstr = setlocale(LC_CTYPE, NULL);
-	char* encoding = nl_langinfo(CODESET);
-	if (encoding && encoding[0] != '\0')
-		ss << encoding;
-#endif
-	if (ss.str().empty()) ss << "UTF-8";
-	
-#if !UNICONV_NO_THREAD_LOCAL	
-	// Cache the result in thread-local storage
-	t_cache.system_encoding = ss.str();
-	t_cache.system_encoding_cached = true;
-	
-	return t_cache.system_encoding;
-#else
-	// Return directly without caching when thread_local is disabled
-	return ss.str();
-#endif
+CompactResult<std::string> UniConv::ToUtf8FromUtf32LEEx(const std::u32string& input) {
+    return ConvertUtfNativeResult<std::string>(EncodingId::UTF32LE, EncodingId::UTF8, input.data(), input.size() * sizeof(char32_t));
 }
 
+CompactResult<std::u32string> UniConv::ToUtf32LEFromUtf8Ex(const std::string& input) {
+    return ConvertUtfNativeResult<std::u32string>(EncodingId::UTF8, EncodingId::UTF32LE, input.data(), input.size());
+}
 
-std::uint16_t UniConv::GetCurrentSystemEncodingCodePage() noexcept {
-#ifdef _WIN32
-	UINT codePage = GetACP();
-	return static_cast<std::uint16_t>(codePage);
-#elif defined(__linux__) || defined(__APPLE__)
-	setlocale(LC_ALL, "");
-	char* locstr = setlocale(LC_CTYPE, NULL);
-	char* encoding = nl_langinfo(CODESET);
-	if (encoding) {
-		auto it = m_encodingToCodePageMap.find(encoding);
-		if (it != m_encodingToCodePageMap.end())
-			return it->second;
-	}
-	return 0;
-#else
-	return static_cast<std::uint16_t>(-1);
-#endif
+CompactResult<std::u32string> UniConv::ToUtf32LEFromUtf16LEEx(const std::u16string& input) {
+    return ConvertUtfNativeResult<std::u32string>(EncodingId::UTF16LE, EncodingId::UTF32LE, input.data(), input.size() * sizeof(char16_t));
 }
 
-std::string  UniConv::GetEncodingNameByCodePage(std::uint16_t codePage) noexcept
-{
-	auto it = m_encodingMap.find(codePage);
-	if (it != m_encodingMap.end())
-		return it->second.dotNetName;
-	else
-		return "Encoding not found.";
+CompactResult<std::u32string> UniConv::ToUtf32LEFromUtf16BEEx(const std::u16string& input) {
+    return ConvertUtfNativeResult<std::u32string>(EncodingId::UTF16BE, EncodingId::UTF32LE, input.data(), input.size() * sizeof(char16_t));
 }
 
+CompactResult<std::u16string> UniConv::ToUtf16LEFromUtf16BEEx(const std::u16string& input) {
+    return ConvertUtfNativeResult<std::u16string>(EncodingId::UTF16BE, EncodingId::UTF16LE, input.data(), input.size() * sizeof(char16_t));
+}
 
-// ===================== Refactored encoding conversion methods =====================
+CompactResult<std::u16string> UniConv::ToUtf16BEFromUtf16LEEx(const std::u16string& input) {
+    return ConvertUtfNativeResult<std::u16string>(EncodingId::UTF16LE, EncodingId::UTF16BE, input.data(), input.size() * sizeof(char16_t));
+}
+
+CompactResult<std::wstring> UniConv::ToWideStringFromLocaleEx(const std::string& input) {
+    if (input.empty()) {
+        return CompactResult<std::wstring>::Success(std::wstring{});
+    }
 
-// System local encoding -> UTF-8
-std::string UniConv::ToUtf8FromLocale(const std::string& input) {
-    if(input.empty())
-        return std::string{};
     std::string currentEncoding = GetCurrentSystemEncoding();
-    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8);
-    return result.IsSuccess() ? std::move(result).GetValue() : "";
+    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_WCHAR);
+    if (result.IsSuccess()) {
+        auto& value = result.GetValue();
+        if (value.size() % sizeof(wchar_t) == 0) {
+            return CompactResult<std::wstring>::Success(
+                std::wstring(reinterpret_cast<const wchar_t*>(value.data()), value.size() / sizeof(wchar_t)));
+        }
+        return CompactResult<std::wstring>::Failure(ErrorCode::ConversionFailed);
+    }
+    return CompactResult<std::wstring>::Failure(result.GetErrorCode());
 }
 
-std::string UniConv::ToUtf8FromLocale(const char* input) {
-    if (!input) return "";
-    return ToUtf8FromLocale(std::string(input));
-}
+CompactResult<std::string> UniConv::ToLocaleFromWideStringEx(const std::wstring& input) {
+    if (input.empty()) {
+        return CompactResult<std::string>::Success(std::string{});
+    }
 
-// UTF-8 -> System local encoding
-std::string UniConv::ToLocaleFromUtf8(const std::string& input) {
     std::string currentEncoding = GetCurrentSystemEncoding();
-    auto result = ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str());
-    return result.IsSuccess() ? std::move(result).GetValue() : "";
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
+    return ConvertEncodingFast(input_bytes, ENC_WCHAR, currentEncoding.c_str());
 }
 
-std::string UniConv::ToLocaleFromUtf8(const char* input) {
-    if (!input) return "";
-    return ToLocaleFromUtf8(std::string(input));
+CompactResult<std::string> UniConv::ToUtf8FromUcs4Ex(const std::wstring& input) {
+    if (input.empty()) {
+        return CompactResult<std::string>::Success(std::string{});
+    }
+
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
+    return ConvertEncodingFast(input_bytes, ENC_WCHAR, ENC_UTF8);
 }
 
-// System local encoding -> UTF-16LE
-std::u16string UniConv::ToUtf16LEFromLocale(const std::string& input) {
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), UniConv::ToString(UniConv::Encoding::utf_16le).c_str());
+CompactResult<std::wstring> UniConv::ToUcs4FromUtf8Ex(const std::string& input) {
+    if (input.empty()) {
+        return CompactResult<std::wstring>::Success(std::wstring{});
+    }
+
+    auto result = ConvertEncodingFast(input, ENC_UTF8, ENC_WCHAR);
     if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 2 == 0) {
-            return std::u16string(reinterpret_cast<const char16_t*>(value.data()),
-                                 value.size() / 2);
+        auto& value = result.GetValue();
+        if (value.size() % sizeof(wchar_t) == 0) {
+            return CompactResult<std::wstring>::Success(
+                std::wstring(reinterpret_cast<const wchar_t*>(value.data()), value.size() / sizeof(wchar_t)));
         }
+        return CompactResult<std::wstring>::Failure(ErrorCode::ConversionFailed);
     }
-    return std::u16string();
+    return CompactResult<std::wstring>::Failure(result.GetErrorCode());
 }
 
-std::u16string UniConv::ToUtf16LEFromLocale(const char* input) {
-    if (!input) return std::u16string();
-    return ToUtf16LEFromLocale(std::string(input));
-}
+CompactResult<std::wstring> UniConv::ToWStringFromU16StringEx(const std::u16string& input) {
+    if (input.empty()) {
+        return CompactResult<std::wstring>::Success(std::wstring{});
+    }
 
-// System local encoding -> UTF-16BE
-std::u16string UniConv::ToUtf16BEFromLocale(const std::string& input) {
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16BE);
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_WCHAR);
     if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 2 == 0) {
-            return std::u16string(reinterpret_cast<const char16_t*>(value.data()), 
-                                 value.size() / 2);
+        auto& value = result.GetValue();
+        if (value.size() % sizeof(wchar_t) == 0) {
+            return CompactResult<std::wstring>::Success(
+                std::wstring(reinterpret_cast<const wchar_t*>(value.data()), value.size() / sizeof(wchar_t)));
         }
+        return CompactResult<std::wstring>::Failure(ErrorCode::ConversionFailed);
     }
-    return std::u16string();
+    return CompactResult<std::wstring>::Failure(result.GetErrorCode());
 }
 
-std::u16string UniConv::ToUtf16BEFromLocale(const char* input) {
-    if (!input) return std::u16string();
-    return ToUtf16BEFromLocale(std::string(input));
+//----------------------------------------------------------------------------------------------------------------------
+// === Zero-Copy Output Parameter API Implementation ===
+//----------------------------------------------------------------------------------------------------------------------
+
+void UniConv::SetApiLayerMode(ApiLayerMode mode) noexcept {
+    m_apiLayerMode.store(mode, std::memory_order_relaxed);
 }
 
-// UTF-16BE -> System local encoding
-std::string UniConv::ToLocaleFromUtf16BE(const std::u16string& input) {
-    if (input.empty()) return "";
+UniConv::ApiLayerMode UniConv::GetApiLayerMode() const noexcept {
+    return m_apiLayerMode.load(std::memory_order_relaxed);
+}
+
+bool UniConv::ConvertEncodingStateless(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
+    return ConvertEncodingStatelessFast(std::string_view{input}, fromEncoding, toEncoding, output) == ErrorCode::Success;
+}
+
+ErrorCode UniConv::ConvertEncodingStatelessFast(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
+    return ConvertEncodingStatelessFast(std::string_view{input}, fromEncoding, toEncoding, output);
+}
+
+bool UniConv::ConvertEncodingStateless(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
+    return ConvertEncodingStatelessFast(input, fromEncoding, toEncoding, output) == ErrorCode::Success;
+}
+
+ErrorCode UniConv::ConvertEncodingStatelessFast(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
+    output.clear();
+
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        return ErrorCode::InvalidParameter;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        return ErrorCode::InvalidSourceEncoding;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        return ErrorCode::InvalidTargetEncoding;
+    }
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return ErrorCode::Success;
+    }
+
+    return ConvertStatelessPlanned(MakePairPlan(fromEncoding, toEncoding), fromEncoding, toEncoding, input, output);
+}
+
+ErrorCode UniConv::ConvertEncodingStatelessFast(std::string_view input, EncodingHandle fromEncoding,
+                                                EncodingHandle toEncoding, std::string& output) noexcept {
+    output.clear();
+
+    const ResolvedPair pair = ResolvePair(fromEncoding, toEncoding);
+    if (UNICONV_UNLIKELY(pair.status != ErrorCode::Success)) {
+        return pair.status;
+    }
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return ErrorCode::Success;
+    }
+
+    return ConvertStatelessPlanned(pair.plan, pair.from, pair.to, input, output);
+}
+
+ErrorCode UniConv::ConvertStatelessPlanned(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+                                           std::string_view input, std::string& output) noexcept {
+    const auto run = [&](ConversionPath& path) noexcept {
+#if UNICONV_ENABLE_METRICS
+        const MetricsTimer timer;
+        const ErrorCode ec = ConvertStatelessRoute(plan, fromEncoding, toEncoding, input, output, path);
+        RecordConversionMetrics(fromEncoding, toEncoding, path, input.size(),
+                                ec == ErrorCode::Success ? output.size() : 0, ec, timer);
+        return ec;
+#else
+        return ConvertStatelessRoute(plan, fromEncoding, toEncoding, input, output, path);
+#endif
+    };
+    if (UNICONV_UNLIKELY(ActiveTraceHooks() != nullptr)) {
+        return TracedConversion(fromEncoding, toEncoding, input.size(), run,
+                                [&output](ErrorCode ec) { return ec == ErrorCode::Success ? output.size() : 0; });
+    }
+    ConversionPath path = ConversionPath::Copy;
+    return run(path);
+}
+
+ErrorCode UniConv::ConvertStatelessRoute(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+                                         std::string_view input, std::string& output, ConversionPath& path) noexcept {
+    const auto from_id = static_cast<EncodingId>(plan.fromId);
+    const auto to_id   = static_cast<EncodingId>(plan.toId);
+
+    if (UNICONV_LIKELY(plan.route == PairRoute::Copy)) {
+        path = ConversionPath::Copy;
+        output.assign(input.data(), input.size());
+        return ErrorCode::Success;
+    }
+
+    const size_t ascii_prefix = plan.asciiPassthrough ? AsciiPrefixLength(input) : 0;
+    if (ascii_prefix == input.size()) {
+        path = ConversionPath::AsciiShortcut;
+        output.assign(input.data(), input.size());
+        return ErrorCode::Success;
+    }
+
+#ifdef UNICONV_HAS_SIMDUTF
+    //  直接读取 string_view，写入调用方 output（保留容量），不复制输入
+    if (plan.route == PairRoute::Simdutf) {
+        path = ConversionPath::Simdutf;
+        return ConvertUtfSimdutf(from_id, to_id, input.data(), input.size(), output);
+    }
+#endif // UNICONV_HAS_SIMDUTF
+
+    if (plan.route == PairRoute::Native) {
+        path = ConversionPath::Native;
+        return ConvertUtfNative(from_id, to_id, input.data(), input.size(), output);
+    }
+
+    path = ConversionPath::StatelessIconv;
+    iconv_t cd = iconv_open(toEncoding, fromEncoding);
+    if (UNICONV_UNLIKELY(cd == reinterpret_cast<iconv_t>(-1))) {
+        return ErrorCode::ConversionFailed;
+    }
 
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ToString(UniConv::Encoding::utf_16be).c_str(), currentEncoding.c_str());
-    return result.IsSuccess() ? std::move(result).GetValue() : "";
-}
+    const char* inbuf_ptr = input.data() + ascii_prefix;
+    std::size_t inbuf_left = input.size() - ascii_prefix;
 
-std::string UniConv::ToLocaleFromUtf16BE(const char16_t* input) {
-    if (!input) return "";
-    return ToLocaleFromUtf16BE(std::u16string(input));
-}
+    size_t estimated_size = ascii_prefix + EstimateOutputSizeById(inbuf_left,
+                                                                   static_cast<uint8_t>(from_id),
+                                                                   static_cast<uint8_t>(to_id));
+    try {
+        output.resize(estimated_size);
+    } catch (...) {
+        iconv_close(cd);
+        return ErrorCode::OutOfMemory;
+    }
+    std::memcpy(output.data(), input.data(), ascii_prefix);
 
-// UTF-16LE -> UTF-8
-std::string UniConv::ToUtf8FromUtf16LE(const std::u16string& input) {
-    if (input.empty()) return "";
+    size_t written_total = ascii_prefix;
+    constexpr int max_iterations = 100;
+    int iteration_count = 0;
 
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_UTF8);
-    return result.IsSuccess() ? std::move(result).GetValue() : "";
-}
+    while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
+        char* outbuf_ptr = output.data() + written_total;
+        std::size_t outbuf_left = output.size() - written_total;
 
-// ===================== UTF-16LE with length parameter overloads =====================
-std::string UniConv::ToUtf8FromUtf16LE(const char16_t* input, size_t len) {
-    if (!input || len == 0) return "";
+        std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+        written_total = output.size() - outbuf_left;
 
-    std::string input_bytes(reinterpret_cast<const char*>(input), len * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_UTF8);
-    return result.IsSuccess() ? std::move(result).GetValue() : "";
-}
+        if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+            int current_errno = errno;
+            switch (current_errno) {
+                case E2BIG: {
+                    if (UNICONV_UNLIKELY(output.size() >= 1048576 * 10)) {
+                        iconv_close(cd);
+                        return ErrorCode::BufferTooSmall;
+                    }
+                    try {
+                        output.resize(output.size() * 2);
+                    } catch (...) {
+                        iconv_close(cd);
+                        return ErrorCode::OutOfMemory;
+                    }
+                    continue;
+                }
+                case EILSEQ:
+                    iconv_close(cd);
+                    return ErrorCode::InvalidSequence;
+                case EINVAL:
+                    iconv_close(cd);
+                    return ErrorCode::IncompleteSequence;
+                default:
+                    iconv_close(cd);
+                    return ErrorCode::ConversionFailed;
+            }
+        } else {
+            break;
+        }
+    }
 
-std::string UniConv::ToUtf8FromUtf16LE(const char16_t* input) {
-    if (!input) return "";
-    return ToUtf8FromUtf16LE(std::u16string(input));
-}
+    if (UNICONV_UNLIKELY(iteration_count >= max_iterations)) {
+        iconv_close(cd);
+        return ErrorCode::InternalError;
+    }
 
-// UTF-16BE -> UTF-8
-std::string UniConv::ToUtf8FromUtf16BE(const std::u16string& input) {
-    if (input.empty()) return "";
-    
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16BE,ENC_UTF8);
-    return result.IsSuccess() ? std::move(result).GetValue() : "";
+    output.resize(written_total);
+    iconv_close(cd);
+    return ErrorCode::Success;
 }
 
-std::string UniConv::ToUtf8FromUtf16BE(const char16_t* input, size_t len) {
-    if (!input || len == 0) return "";
-
-    std::string input_bytes(reinterpret_cast<const char*>(input), len * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16BE, ENC_UTF8);
-    return result.IsSuccess() ? std::move(result).GetValue() : "";
+bool UniConv::ConvertEncoding(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
+    ErrorCode result = ConvertEncodingFast(input, fromEncoding, toEncoding, output);
+    return result == ErrorCode::Success;
 }
 
-std::string UniConv::ToUtf8FromUtf16BE(const char16_t* input) {
-    if (!input) return "";
-    return ToUtf8FromUtf16BE(std::u16string(input));
+ErrorCode UniConv::ConvertEncodingFast(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
+    return ConvertEncodingFast(std::string_view(input), fromEncoding, toEncoding, output);
 }
 
-// UTF-8 -> UTF-16LE
-std::u16string UniConv::ToUtf16LEFromUtf8(const std::string& input) {
-    auto result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF16LE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 2 == 0) {
-            return std::u16string(reinterpret_cast<const char16_t*>(value.data()), 
-                                 value.size() / 2);
-        }
+// UTF-8 Conversion Series (output parameter versions)
+bool UniConv::ToUtf8FromLocale(const std::string& input, std::string& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
     }
-    return std::u16string();
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    return ErrorCode::Success == ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8, output);
 }
 
-std::u16string UniConv::ToUtf16LEFromUtf8(const char* input) {
-    if (!input) return std::u16string();
-    return ToUtf16LEFromUtf8(std::string(input));
+bool UniConv::ToLocaleFromUtf8(const std::string& input, std::string& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    return ErrorCode::Success == ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str(), output);
 }
 
-// UTF-8 -> UTF-16BE
-std::u16string UniConv::ToUtf16BEFromUtf8(const std::string& input) {
-    auto result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF16BE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 2 == 0) {
-            return std::u16string(reinterpret_cast<const char16_t*>(value.data()), 
-                                 value.size() / 2);
-        }
-    }
-    return std::u16string();
+bool UniConv::ToUtf8FromUtf16LE(const std::u16string& input, std::string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF8, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
 }
 
-std::u16string UniConv::ToUtf16BEFromUtf8(const char* input) {
-    if (!input) return std::u16string();
-    return ToUtf16BEFromUtf8(std::string(input));
+bool UniConv::ToUtf8FromUtf16BE(const std::u16string& input, std::string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF8, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
 }
 
-// UTF-16LE -> UTF-16BE
-std::u16string UniConv::ToUtf16BEFromUtf16LE(const std::u16string& input) {
-    if (input.empty()) return std::u16string();
+bool UniConv::ToUtf8FromUtf32LE(const std::u32string& input, std::string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF8, input.data(), input.size() * sizeof(char32_t), output) == ErrorCode::Success;
+}
 
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_UTF16BE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 2 == 0) {
-            return std::u16string(reinterpret_cast<const char16_t*>(value.data()), 
-                                 value.size() / 2);
-        }
-    }
-    return std::u16string();
+// UTF-16 Conversion Series (output parameter versions)
+bool UniConv::ToUtf16LEFromUtf8(const std::string& input, std::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16LE, input.data(), input.size(), output) == ErrorCode::Success;
 }
 
-std::u16string UniConv::ToUtf16BEFromUtf16LE(const char16_t* input) {
-    if (!input) return std::u16string();
-    return ToUtf16BEFromUtf16LE(std::u16string(input));
+bool UniConv::ToUtf16BEFromUtf8(const std::string& input, std::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16BE, input.data(), input.size(), output) == ErrorCode::Success;
 }
 
-// UTF-16BE -> UTF-16LE
-std::u16string UniConv::ToUtf16LEFromUtf16BE(const std::u16string& input) {
-    if (input.empty()) return std::u16string();
+bool UniConv::ToUtf16LEFromLocale(const std::string& input, std::u16string& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
     
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16BE, ENC_UTF16LE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 2 == 0) {
-            return std::u16string(reinterpret_cast<const char16_t*>(value.data()), 
-                                 value.size() / 2);
-        }
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    std::string temp_output;
+    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16LE, temp_output);
+    
+    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
+        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
+        return true;
     }
-    return std::u16string();
+    return false;
 }
 
-std::u16string UniConv::ToUtf16LEFromUtf16BE(const char16_t* input) {
-    if (!input) return std::u16string();
-    size_t len = 0;
-    while (input[len] != 0) ++len;
-    return ToUtf16LEFromUtf16BE(std::u16string(input, len));
+bool UniConv::ToUtf16BEFromLocale(const std::string& input, std::u16string& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
+    
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    std::string temp_output;
+    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16BE, temp_output);
+    
+    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
+        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
+        return true;
+    }
+    return false;
 }
 
-// New standardized method implementations
-std::wstring UniConv::ToWideStringFromLocale(const std::string& input) {
-    if (input.empty()) return std::wstring{};
-    std::string currentEncoding = this->GetCurrentSystemEncoding();
-    auto result = this->ConvertEncodingFast(input, currentEncoding.c_str(), ENC_WCHAR);
-    if (!result.IsSuccess()) return std::wstring{};
-    auto value = std::move(result).GetValue();
-    if (value.size() % sizeof(wchar_t) == 0) {
-        return std::wstring(reinterpret_cast<const wchar_t*>(value.data()),
-                            value.size() / sizeof(wchar_t));
-    }
-    return std::wstring{};
+bool UniConv::ToUtf16BEFromUtf16LE(const std::u16string& input, std::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF16BE, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
 }
 
-std::wstring UniConv::ToWideStringFromLocale(const char* input) {
-	if (!input) return std::wstring{};
-	return this->ToWideStringFromLocale(std::string(input));
+bool UniConv::ToUtf16LEFromUtf16BE(const std::u16string& input, std::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF16LE, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
 }
 
+// UTF-32 Conversion Series (output parameter versions)
+bool UniConv::ToUtf32LEFromUtf8(const std::string& input, std::u32string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF32LE, input.data(), input.size(), output) == ErrorCode::Success;
+}
 
+bool UniConv::ToUtf32LEFromUtf16LE(const std::u16string& input, std::u32string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF32LE, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
+}
 
-// New standardized method implementations
-std::string UniConv::ToLocaleFromWideString(const std::wstring& input)
-{
-	if (input.empty()) return std::string{};
-	std::string currentEncoding = this->GetCurrentSystemEncoding();
-	std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
-	auto result = this->ConvertEncodingFast(input_bytes, ENC_WCHAR, currentEncoding.c_str());
-	return result.IsSuccess() ? std::move(result).GetValue() : std::string{};
+bool UniConv::ToUtf32LEFromUtf16BE(const std::u16string& input, std::u32string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF32LE, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
 }
 
-std::string UniConv::ToLocaleFromWideString(const wchar_t* input)
-{
-	return input ? this->ToLocaleFromWideString(std::wstring(input)) : std::string{};
+// UTF-32 <-> UTF-16 Conversion Series (output parameter versions)
+bool UniConv::ToUtf16LEFromUtf32LE(const std::u32string& input, std::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF16LE, input.data(), input.size() * sizeof(char32_t), output) == ErrorCode::Success;
 }
 
+bool UniConv::ToUtf16BEFromUtf32LE(const std::u32string& input, std::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF16BE, input.data(), input.size() * sizeof(char32_t), output) == ErrorCode::Success;
+}
 
+// UCS-4 Conversion Series (output parameter versions)
+bool UniConv::ToUtf8FromUcs4(const std::wstring& input, std::string& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
 
-// UTF-16LE -> Local
-std::string UniConv::ToLocaleFromUtf16LE(const std::u16string& input) {
-    if (input.empty()) return "";
-    
-    std::string currentEncoding = this->GetCurrentSystemEncoding();
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = this->ConvertEncodingFast(input_bytes, ENC_UTF16LE, currentEncoding.c_str());
-    return result.IsSuccess() ? std::move(result).GetValue() : "";
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
+    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_WCHAR, ENC_UTF8, output);
 }
 
-std::string UniConv::ToLocaleFromUtf16LE(const char16_t* input) {
-    if (!input) return "";
-    return this->ToLocaleFromUtf16LE(std::u16string(input));
-}
+bool UniConv::ToUcs4FromUtf8(const std::string& input, std::wstring& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
+
+    std::string temp_output;
+    ErrorCode result = ConvertEncodingFast(input, ENC_UTF8, ENC_WCHAR, temp_output);
 
-std::string UniConv::ToUtf8FromUtf32LE(const std::u32string& sInput)
-{
-	if (sInput.empty()) return std::string{};
-	std::string input_bytes(reinterpret_cast<const char*>(sInput.data()), sInput.size() * sizeof(char32_t));
-	auto result = this->ConvertEncodingFast(input_bytes, ENC_UTF32LE, ENC_UTF8);
-	return result.IsSuccess() ? std::move(result).GetValue() : std::string{};
+    if (result == ErrorCode::Success && temp_output.size() % sizeof(wchar_t) == 0) {
+        output = std::wstring(reinterpret_cast<const wchar_t*>(temp_output.data()),
+                              temp_output.size() / sizeof(wchar_t));
+        return true;
+    }
+    return false;
 }
 
-std::string UniConv::ToUtf8FromUtf32LE(const char32_t* sInput)
-{
-	if (!sInput) return std::string{};
-	return ToUtf8FromUtf32LE(std::u32string(sInput));
+// Locale Conversion Series (output parameter versions)
+bool UniConv::ToLocaleFromUtf16LE(const std::u16string& input, std::string& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
+    
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+    
+    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_UTF16LE, currentEncoding.c_str(), output);
 }
 
-std::u16string UniConv::ToUtf16LEFromUtf32LE(const std::u32string& sInput)
-{
-	if (sInput.empty() ) return std::u16string{};
-	std::string input_bytes(reinterpret_cast<const char*>(sInput.data()), sInput.size() * sizeof(char32_t));
-	auto result = this->ConvertEncodingFast(input_bytes, ENC_UTF32LE, ENC_UTF16LE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 2 == 0) {
-            return std::u16string(reinterpret_cast<const char16_t*>(value.data()), 
-               value.size() / sizeof(char16_t));
-        }
+bool UniConv::ToLocaleFromUtf16BE(const std::u16string& input, std::string& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
     }
-    return std::u16string{};
+    
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+    
+    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_UTF16BE, currentEncoding.c_str(), output);
 }
 
-std::u16string UniConv::ToUtf16LEFromUtf32LE(const char32_t* sInput)
-{
-	if (!sInput) return std::u16string{};
-	return ToUtf16LEFromUtf32LE(std::u32string(sInput));
+bool UniConv::ToLocaleFromWideString(const std::wstring& input, std::string& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
+    
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
+    
+    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_WCHAR, currentEncoding.c_str(), output);
 }
 
-// New standardized method implementations
-std::u16string UniConv::ToUtf16BEFromUtf32LE(const std::u32string& input)
-{
-	if (input.empty()) return std::u16string{};
-	std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char32_t));
-    auto result = this->ConvertEncodingFast(input_bytes, ENC_UTF32LE, ENC_UTF16BE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 2 == 0) {
-            return std::u16string(reinterpret_cast<const char16_t*>(value.data()), 
-               value.size() / sizeof(char16_t));
-        }
+// Wide String Series (output parameter versions)
+bool UniConv::ToWideStringFromLocale(const std::string& input, std::wstring& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
+    
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    std::string temp_output;
+    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_WCHAR, temp_output);
+    
+    if (result == ErrorCode::Success && temp_output.size() % sizeof(wchar_t) == 0) {
+        output = std::wstring(reinterpret_cast<const wchar_t*>(temp_output.data()),
+                              temp_output.size() / sizeof(wchar_t));
+        return true;
     }
-    return std::u16string{};
+    return false;
 }
 
-std::u16string UniConv::ToUtf16BEFromUtf32LE(const char32_t* input)
-{
-   if (!input) return std::u16string{};
-   return ToUtf16BEFromUtf32LE(std::u32string(input));
+bool UniConv::ToWStringFromU16String(const std::u16string& input, std::wstring& output) noexcept {
+    if (input.empty()) {
+        output.clear();
+        return true;
+    }
+    
+    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+    std::string temp_output;
+    ErrorCode result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_WCHAR, temp_output);
+    
+    if (result == ErrorCode::Success && temp_output.size() % sizeof(wchar_t) == 0) {
+        output = std::wstring(reinterpret_cast<const wchar_t*>(temp_output.data()), temp_output.size() / sizeof(wchar_t));
+        return true;
+    }
+    return false;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// === Batch Conversion with Output Parameter (Phase 2) ===
+//----------------------------------------------------------------------------------------------------------------------
 
+bool UniConv::ConvertEncodingBatch(
+    const std::vector<std::string>& inputs,
+    const char* fromEncoding,
+    const char* toEncoding,
+    std::vector<std::string>& outputs) noexcept {
 
-// New standardized method implementations
-std::u32string UniConv::ToUtf32LEFromUtf8(const std::string& input)
-{
-	if (input.empty()) return std::u32string{};
-	auto result = this->ConvertEncodingFast(input, ENC_UTF8, ENC_UTF32LE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 4 == 0) {
-            return std::u32string(reinterpret_cast<const char32_t*>(value.data()), 
-                                 value.size() / sizeof(char32_t));
+    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
+        outputs.clear();
+        outputs.resize(inputs.size());
+        bool all_success = true;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            ErrorCode ec = ConvertEncodingStatelessFast(inputs[i], fromEncoding, toEncoding, outputs[i]);
+            if (ec != ErrorCode::Success) {
+                outputs[i].clear();
+                all_success = false;
+            }
         }
+        return all_success;
     }
-	return std::u32string{};
-}
+    
+    // Parameter validation
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        outputs.clear();
+        return false;
+    }
+    
+    // 快速编码名称有效性检查
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding) || !IsValidEncodingName(toEncoding))) {
+        outputs.clear();
+        return false;
+    }
+    
+    // Resize outputs to match inputs
+    try {
+        outputs.resize(inputs.size());
+    } catch (...) {
+        return false;
+    }
+    
+    // Early return for empty inputs
+    if (inputs.empty()) {
+        return true;
+    }
+    
+    // Prefetch inputs data
+    if (UNICONV_LIKELY(!inputs.empty())) {
+        UNICONV_PREFETCH(inputs.data(), 0, 2);
+    }
+    
+    // Thread-owned descriptor (thread-local hit or checkout from the shared idle pool)
+    auto descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
+    if (UNICONV_UNLIKELY(!descriptor)) {
+        outputs.clear();
+        return false;
+    }
+    
+    const EncodingId from_id = GetEncodingId(fromEncoding);
+    const EncodingId to_id   = GetEncodingId(toEncoding);
+    const bool same_encoding = AreSameEncoding(from_id, to_id, fromEncoding, toEncoding);
+    const bool both_ascii_compatible = IsAsciiPassthroughPair(from_id, to_id);
 
-std::u32string UniConv::ToUtf32LEFromUtf8(const char* input)
-{
-	if (!input) return std::u32string{};
-	return ToUtf32LEFromUtf8(std::string(input));
-}
+    iconv_t cd = static_cast<iconv_t>(descriptor.get());
+    bool all_success = true;
 
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const std::string& input = inputs[i];
+        std::string& output = outputs[i];
 
+        output.clear();
 
-// New standardized method implementations
-std::u32string UniConv::ToUtf32LEFromUtf16LE(const std::u16string& input)
-{
-	if (input.empty()) return std::u32string{};
-	std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = this->ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_UTF32LE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 4 == 0) {
-            return std::u32string(reinterpret_cast<const char32_t*>(value.data()), 
-                                 value.size() / sizeof(char32_t));
+        if (input.empty()) {
+            continue;
         }
-	}
-	return std::u32string{};
-}
+        UNICONV_METRICS_CALL(metrics, fromEncoding, toEncoding, ConversionPath::Iconv, input.size());
 
-std::u32string UniConv::ToUtf32LEFromUtf16LE(const char16_t* input)
-{
-	if (input == nullptr) return std::u32string{};
-	return ToUtf32LEFromUtf16LE(std::u16string(input));
-}
+        if (UNICONV_UNLIKELY(same_encoding)) {
+            UNICONV_METRICS_NOTE(metrics, path, ConversionPath::Copy);
+            UNICONV_METRICS_NOTE(metrics, bytesOut, input.size());
+            output = input;
+            continue;
+        }
+        const size_t ascii_prefix = both_ascii_compatible ? AsciiPrefixLength(input) : 0;
+        if (ascii_prefix == input.size()) {
+            UNICONV_METRICS_NOTE(metrics, path, ConversionPath::AsciiShortcut);
+            UNICONV_METRICS_NOTE(metrics, bytesOut, input.size());
+            output = input;
+            continue;
+        }
 
+        size_t estimated_size = ascii_prefix + EstimateOutputSizeById(input.size() - ascii_prefix,
+                                                                       static_cast<uint8_t>(from_id),
+                                                                       static_cast<uint8_t>(to_id));
+        try {
+            output.resize(estimated_size);
+        } catch (...) {
+            UNICONV_METRICS_NOTE(metrics, status, ErrorCode::OutOfMemory);
+            all_success = false;
+            continue;
+        }
+        std::memcpy(output.data(), input.data(), ascii_prefix);
 
+        const char* inbuf_ptr = input.data() + ascii_prefix;
+        std::size_t inbuf_left = input.size() - ascii_prefix;
+        size_t written_total = ascii_prefix;
+        constexpr int max_iterations = 100;
+        int iteration_count = 0;
+        bool conversion_success = true;
 
-// New standardized method implementations
-std::u32string UniConv::ToUtf32LEFromUtf16BE(const std::u16string& input)
-{
-	if (input.empty()) return std::u32string{};
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = this->ConvertEncodingFast(input_bytes, ENC_UTF16BE, ENC_UTF32LE);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % 4 == 0) {
-            return std::u32string(reinterpret_cast<const char32_t*>(value.data()), 
-                                 value.size() / sizeof(char32_t));
-        }
-	}
-	return std::u32string{};
-}
+        while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
+            char* outbuf_ptr = output.data() + written_total;
+            std::size_t outbuf_left = output.size() - written_total;
 
-std::u32string UniConv::ToUtf32LEFromUtf16BE(const char16_t* input)
-{
-	if (input == nullptr) return std::u32string{};
-	return ToUtf32LEFromUtf16BE(std::u16string(input));
-}
+            std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+            written_total = output.size() - outbuf_left;
+
+            if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+                int current_errno = errno;
+                switch (current_errno) {
+                    case E2BIG:
+                        if (UNICONV_UNLIKELY(output.size() >= 1048576 * 10)) {
+                            conversion_success = false;
+                            break;
+                        }
+                        try {
+                            output.resize(output.size() * 2);
+                        } catch (...) {
+                            conversion_success = false;
+                            break;
+                        }
+                        continue;
+                    case EILSEQ:
+                    case EINVAL:
+                    default:
+                        conversion_success = false;
+                        break;
+                }
+                if (!conversion_success) break;
+            } else {
+                break;
+            }
+        }
 
+        if (UNICONV_UNLIKELY(!conversion_success || iteration_count >= max_iterations)) {
+            UNICONV_METRICS_NOTE(metrics, status, ErrorCode::ConversionFailed);
+            all_success = false;
+            output.clear();
+        } else {
+            output.resize(written_total);
+            UNICONV_METRICS_NOTE(metrics, bytesOut, written_total);
+        }
 
+        portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+    }
 
-// New standardized method implementations
-std::string UniConv::ToUtf8FromUcs4(const std::wstring& input)
-{
-    #if defined(_WIN32)
-        // Windows platform：Use Windows API WideCharToMultiByte
-        if (input.empty()) return std::string();
-    
-        int sizeRequired = WideCharToMultiByte(
-            CP_UTF8, 
-            0,
-            input.data(), 
-            (int)input.size(),
-            nullptr, 
-            0, 
-            nullptr,
-            nullptr);
+    return all_success;
+}
 
-        if (sizeRequired <= 0)
-        {
-    		return std::string{}; // Error or empty string
-        }
-        std::vector<char> utf8Buffer(sizeRequired);
-        WideCharToMultiByte(CP_UTF8, 0, input.data(), (int)input.size(), utf8Buffer.data(), sizeRequired, nullptr, nullptr);
-        return std::string(utf8Buffer.begin(), utf8Buffer.end());
+//----------------------------------------------------------------------------------------------------------------------
+// === Batch Conversion over Contiguous Storage (Arrow-style offsets) ===
+//----------------------------------------------------------------------------------------------------------------------
 
-    #elif defined(__linux__) || defined(__APPLE__)
-        if (input.empty()) return std::string();
-        std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
-        auto result = ConvertEncodingFast(input_bytes, ENC_WCHAR, ENC_UTF8);
-        return result.IsSuccess() ? std::move(result).GetValue() : std::string{};
-    #endif
+ErrorCode UniConv::ConvertEncodingBatch(
+    std::string_view data,
+    const size_t* offsets,
+    size_t count,
+    const char* fromEncoding,
+    const char* toEncoding,
+    std::string& outData,
+    std::vector<size_t>& outOffsets,
+    std::vector<ErrorCode>* itemErrors) noexcept {
+    return ConvertPackedBatch(data, offsets, count, ResolvePair(fromEncoding, toEncoding),
+                              outData, outOffsets, itemErrors);
 }
 
-std::wstring UniConv::ToUcs4FromUtf8(const std::string& input)
-{
-    if (input.empty()) return std::wstring{};
-    auto result = ConvertEncodingFast(input, ENC_UTF8, ENC_WCHAR);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % sizeof(wchar_t) == 0) {
-            return std::wstring(reinterpret_cast<const wchar_t*>(value.data()),
-                value.size() / sizeof(wchar_t));
+ErrorCode UniConv::ConvertEncodingBatch(
+    std::string_view data,
+    const size_t* offsets,
+    size_t count,
+    const char* fromEncoding,
+    const char* toEncoding,
+    std::string& outData,
+    std::vector<size_t>& outOffsets,
+    NormalizationForm form,
+    std::vector<ErrorCode>* itemErrors) noexcept {
+    return ConvertPackedBatch(data, offsets, count, ResolvePair(fromEncoding, toEncoding),
+                              outData, outOffsets, itemErrors, form);
+}
+
+ErrorCode UniConv::ConvertEncodingBatch(
+    std::string_view data,
+    const size_t* offsets,
+    size_t count,
+    EncodingHandle fromEncoding,
+    EncodingHandle toEncoding,
+    std::string& outData,
+    std::vector<size_t>& outOffsets,
+    std::vector<ErrorCode>* itemErrors) noexcept {
+    return ConvertPackedBatch(data, offsets, count, ResolvePair(fromEncoding, toEncoding),
+                              outData, outOffsets, itemErrors);
+}
+
+std::vector<StringResult> UniConv::ConvertEncodingBatch(const std::vector<std::string>& inputs,
+                                                        EncodingHandle fromEncoding,
+                                                        EncodingHandle toEncoding) noexcept {
+    std::vector<StringResult> results;
+    try {
+        results.reserve(inputs.size());
+    } catch (...) {
+        return results;
+    }
+
+    // 编码对只解析一次；每个值直接按路线转换
+    const ResolvedPair pair = ResolvePair(fromEncoding, toEncoding);
+    const bool stateless = GetApiLayerMode() == ApiLayerMode::Stateless;
+    for (const std::string& input : inputs) {
+        std::string output;
+        ErrorCode ec = pair.status;
+        if (ec == ErrorCode::Success && !input.empty()) {
+            ec = stateless ? ConvertStatelessPlanned(pair.plan, pair.from, pair.to, input, output)
+                           : ConvertPlanned(pair.plan, pair.from, pair.to, input, output);
         }
+        results.emplace_back(ec == ErrorCode::Success ? StringResult::Success(std::move(output))
+                                                      : StringResult::Failure(ec));
     }
-    return std::wstring{};
+    return results;
 }
 
+std::vector<StringResult> UniConv::ConvertEncodingBatch(const std::vector<std::string>& inputs,
+                                                        const char* fromEncoding, const char* toEncoding,
+                                                        NormalizationForm form) noexcept {
+    if (form == NormalizationForm::None) {
+        return ConvertEncodingBatch(inputs, fromEncoding, toEncoding);
+    }
+    std::vector<StringResult> results;
+    try {
+        results.reserve(inputs.size());
+    } catch (...) {
+        return results;
+    }
 
-
-std::wstring UniConv::ToWStringFromU16String(const std::u16string& input)
-{
-    if (input.empty()) return std::wstring{};
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_WCHAR);
-    if (result.IsSuccess()) {
-        auto value = std::move(result).GetValue();
-        if (value.size() % sizeof(wchar_t) == 0) {
-            return std::wstring(reinterpret_cast<const wchar_t*>(value.data()),
-                value.size() / sizeof(wchar_t));
+    ResolvedPair pair = ResolvePair(fromEncoding, toEncoding);
+    if (pair.status == ErrorCode::Success && static_cast<EncodingId>(pair.plan.toId) != EncodingId::UTF8) {
+        pair.status = ErrorCode::InvalidParameter;
+    }
+    const bool stateless = GetApiLayerMode() == ApiLayerMode::Stateless;
+    std::string scratch;
+    std::vector<uint32_t> units;
+    for (const std::string& input : inputs) {
+        std::string output;
+        ErrorCode ec = pair.status;
+        if (ec == ErrorCode::Success && !input.empty()) {
+            ec = stateless ? ConvertStatelessPlanned(pair.plan, pair.from, pair.to, input, output)
+                           : ConvertPlanned(pair.plan, pair.from, pair.to, input, output);
+            // 刚转换出的值仍在缓存中：快速检查通过则不做任何改写
+            if (ec == ErrorCode::Success) {
+                size_t end = output.size();
+                size_t used = end;
+                ec = NormalizeUtf8Range(output, 0, end, used, form, scratch, units);
+                output.resize(used);
+            }
         }
+        results.emplace_back(ec == ErrorCode::Success ? StringResult::Success(std::move(output))
+                                                      : StringResult::Failure(ec));
     }
-    return std::wstring{};
-}
-
-std::wstring UniConv::ToWStringFromU16String(const char16_t* input)
-{
-    if (!input) return std::wstring{};
-    return ToWStringFromU16String(std::u16string(input));
+    return results;
 }
 
-// ===================== Error Handling Related =====================
+template <typename ByteString, typename OffsetVector>
+ErrorCode UniConv::ConvertPackedBatch(
+    std::string_view data,
+    const size_t* offsets,
+    size_t count,
+    const ResolvedPair& pair,
+    ByteString& outData,
+    OffsetVector& outOffsets,
+    std::vector<ErrorCode>* itemErrors,
+    NormalizationForm form) noexcept {
 
-UniConv::IconvSharedPtr UniConv::GetIconvDescriptor(const char* fromcode, const char* tocode)
-{
-	// 参数有效性检查 - 预测参数通常有效
-	if (UNICONV_UNLIKELY(!fromcode || !tocode)) {
-        m_cacheMissCount.fetch_add(1, std::memory_order_relaxed);
-        return nullptr;
+    outData.clear();
+    outOffsets.clear();
+    if (itemErrors) {
+        itemErrors->clear();
     }
 
-    // 使用预计算哈希作为缓存键 - 避免字符串拼接分配
-    const size_t from_len = strlen(fromcode);
-    const size_t to_len   = strlen(tocode);
-    const uint64_t key = detail::MakeEncodingPairKey(fromcode, from_len, tocode, to_len);
-
-    // Concurrent cache lookup using parallel-hashmap sharded buckets
-    // Try to find in cache (thread-safe read)
-    IconvCacheEntry entry;
-    if (UNICONV_LIKELY(m_iconvDescriptorCacheMap.if_contains(key, [&](const auto& item) {
-        entry = item.second;
-        item.second.UpdateAccess();
-    }))) {
-        // Cache hit - update statistics
-        m_cacheHitCount.fetch_add(1, std::memory_order_relaxed);
-        return entry.descriptor;
+    if (UNICONV_UNLIKELY(pair.status != ErrorCode::Success)) {
+        return pair.status;
     }
-
-    // Cache miss - need to create new descriptor
-    m_cacheMissCount.fetch_add(1, std::memory_order_relaxed);
-    
-    // Create new iconv descriptor
-    iconv_t cd = iconv_open(tocode, fromcode);
-    if (UNICONV_UNLIKELY(cd == reinterpret_cast<iconv_t>(-1))) {
-        #if defined(UNICONV_DEBUG_MODE) && UNICONV_DEBUG_MODE
-        // std::cout << "iconv_open error for " << fromcode << ">" << tocode << std::endl;
-        #endif
-        return nullptr;
+    if (UNICONV_UNLIKELY(form != NormalizationForm::None &&
+                         static_cast<EncodingId>(pair.plan.toId) != EncodingId::UTF8)) {
+        return ErrorCode::InvalidParameter;
+    }
+    if (UNICONV_UNLIKELY(!offsets && count > 0)) {
+        return ErrorCode::InvalidParameter;
+    }
+    // 偏移量必须单调不减且不越界
+    if (count > 0) {
+        if (UNICONV_UNLIKELY(offsets[count] > data.size())) {
+            return ErrorCode::InvalidParameter;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (UNICONV_UNLIKELY(offsets[i] > offsets[i + 1])) {
+                return ErrorCode::InvalidParameter;
+            }
+        }
     }
 
-    // Create smart pointer with custom deleter (cross-platform safe)
-    // Cast iconv_t to void* for std::shared_ptr<void>
-    auto iconvPtr = std::shared_ptr<void>(static_cast<void*>(cd), IconvDeleter());
-    
-    // LRU cache size management (concurrent but not lock-free)
-    if (UNICONV_UNLIKELY(m_iconvDescriptorCacheMap.size() >= MAX_CACHE_SIZE)) {
-        EvictLRUCacheEntries();
+    const PairPlan& plan = pair.plan;
+    try {
+        outOffsets.resize(count + 1);
+        if (itemErrors) {
+            itemErrors->assign(count, ErrorCode::Success);
+        }
+        // 初始容量按整批估算（复用调用方已有容量），之后按需倍增
+        if (count > 0) {
+            const size_t estimated = EstimateOutputSizeById(offsets[count] - offsets[0], plan.fromId, plan.toId);
+            if (outData.capacity() < estimated) {
+                outData.reserve(estimated);
+            }
+        }
+    } catch (...) {
+        outOffsets.clear();
+        if (itemErrors) {
+            itemErrors->clear();
+        }
+        return ErrorCode::OutOfMemory;
     }
-    
-    // Insert new cache entry (thread-safe insert or update)
-    IconvCacheEntry new_entry(iconvPtr);
-    m_iconvDescriptorCacheMap.insert_or_assign(key, std::move(new_entry));
 
-    #if defined(UNICONV_DEBUG_MODE) && UNICONV_DEBUG_MODE
-        // std::wcout << "Create and cached iconv descriptor: " << fromcode << ">" << tocode << std::endl;
-    #endif
+    ErrorCode first_error = ErrorCode::Success;
+    size_t used = 0;
+    outOffsets[0] = 0;
+    std::string norm_scratch;
+    std::vector<uint32_t> norm_units;
 
-    return iconvPtr;
-}
+    for (size_t i = 0; i < count; ++i) {
+        const std::string_view value = data.substr(offsets[i], offsets[i + 1] - offsets[i]);
+        ErrorCode ec = ErrorCode::Success;
 
-std::pair<UniConv::BomEncoding, std::string_view> UniConv::DetectAndRemoveBom(const std::string_view& data)
-{
-    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
-    size_t len = data.size();
+        if (!value.empty()) {
+            // 保证尾部空间覆盖最坏情况，转换不会因缓冲区不足而中途截断
+            const size_t bound = MaxOutputSizeById(value.size(), plan.fromId, plan.toId);
+            if (outData.size() - used < bound) {
+                try {
+                    outData.resize((std::max)(outData.size() * 2, used + bound));
+                } catch (...) {
+                    ec = ErrorCode::OutOfMemory;
+                }
+            }
+            if (ec == ErrorCode::Success) {
+                size_t consumed = 0, written = 0;
+                ec = ConvertPlannedInto(plan, pair.from, pair.to, value,
+                                        outData.data() + used, outData.size() - used, consumed, written);
+                // 正规化紧跟在该值写出之后，就地改写 arena 尾部
+                if (ec == ErrorCode::Success && form != NormalizationForm::None) {
+                    size_t end = used + written;
+                    size_t value_used = end;
+                    ec = NormalizeUtf8Range(outData, used, end, value_used, form, norm_scratch, norm_units);
+                    written = value_used - used;
+                }
+                if (ec == ErrorCode::Success) {
+                    used += written;
+                }
+            }
+        }
 
-    // UTF-8 BOM (3 bytes)
-    if (len >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
-        return { BomEncoding::UTF8, data.substr(3) };
-    
-    // UTF-32 检测必须在 UTF-16 之前！（UTF-32LE BOM 以 FF FE 开头，会被误判为 UTF-16LE）
-    if (len >= 4 && bytes[0] == 0xFF && bytes[1] == 0xFE && bytes[2] == 0x00 && bytes[3] == 0x00)
-        return { BomEncoding::UTF32_LE, data.substr(4) };
-    if (len >= 4 && bytes[0] == 0x00 && bytes[1] == 0x00 && bytes[2] == 0xFE && bytes[3] == 0xFF)
-        return { BomEncoding::UTF32_BE, data.substr(4) };
-    
-    // UTF-16 检测（在 UTF-32 之后）
-    if (len >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE)
-        return { BomEncoding::UTF16_LE, data.substr(2) };
-    if (len >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF)
-        return { BomEncoding::UTF16_BE, data.substr(2) };
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            if (first_error == ErrorCode::Success) {
+                first_error = ec;
+            }
+            if (itemErrors) {
+                (*itemErrors)[i] = ec;
+            }
+        }
+        outOffsets[i + 1] = used;
+    }
 
-    return { BomEncoding::None, data };
+    outData.resize(used);
+    return first_error;
 }
 
-std::pair<UniConv::BomEncoding, std::wstring_view> UniConv::DetectAndRemoveBom(const std::wstring_view& data)
-{
-    if (data.empty()) {
-        return { BomEncoding::None, data };
-    }
 
-    if constexpr (sizeof(wchar_t) == 2) {
-        // Windows ：UTF-16
-        if (data[0] == 0xFEFF)
-            return { BomEncoding::UTF16_BE, data.substr(1) };
-        if (data[0] == 0xFFFE)
-            return { BomEncoding::UTF16_LE, data.substr(1) };
-    }
-    else if constexpr (sizeof(wchar_t) == 4) {
-        // Linux/macOS：UTF-32
-        if (data.size() >= 1 && data[0] == 0x0000FEFF)
-            return { BomEncoding::UTF32_BE, data.substr(1) };
-        if (data.size() >= 1 && data[0] == 0xFFFE0000)
-            return { BomEncoding::UTF32_LE, data.substr(1) };
-    }
 
-    return { BomEncoding::None, data };
-}
+std::vector<StringResult> UniConv::ConvertEncodingBatchParallel(
+    const std::vector<std::string>& inputs,
+    const char* fromEncoding,
+    const char* toEncoding,
+    size_t numThreads) noexcept {
 
+    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
+        std::vector<StringResult> results;
+        results.reserve(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            results.emplace_back(StringResult::Success(std::string{}));
+        }
 
-void UniConv::CleanupIconvCache() {
-    // Concurrent clear using phmap's thread-safe operations
-    m_iconvDescriptorCacheMap.clear();
-    
-    #if defined(UNICONV_DEBUG_MODE) && UNICONV_DEBUG_MODE
-        // std::cout << "iconv descriptor cache cleared" << std::endl;
-    #endif
-}
+        if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+            for (auto& r : results) r = StringResult::Failure(ErrorCode::InvalidParameter);
+            return results;
+        }
 
-std::string UniConv::ToString(UniConv::Encoding  enc) noexcept {
-    int idx = static_cast<int>(enc);
-    if (idx >= 0 && idx < static_cast<int>(Encoding::count))
-        return m_encodingNames[idx];
-    return {};
-}
+        size_t total_bytes = 0;
+        for (const auto& input : inputs) {
+            total_bytes += input.size();
+        }
+        TraceScope trace(TraceSpanKind::BatchParallel, fromEncoding, toEncoding, total_bytes, inputs.size());
 
-//----------------------------------------------------------------------------------------------------------------------
-// === High-Performance Methods Implementation ===
-//----------------------------------------------------------------------------------------------------------------------
+        ThreadPool& pool = UniConvThreadPool::GetInstance();
+        size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
+        const ParallelThresholds thresholds = LoadParallelThresholds(ClassifyParallelCost(fromEncoding, toEncoding));
+        size_t recommended_threads = AdaptiveParallelPolicy::GetRecommendedThreads(
+            inputs.size(), total_bytes, max_threads, thresholds);
 
-StringResult UniConv::ConvertEncodingFast(const std::string& input,const char* fromEncoding, const char* toEncoding) noexcept {
+        BatchPartition plan;
+        const bool splittable = IsChunkSplittablePair(fromEncoding, toEncoding);
+        if (UNICONV_UNLIKELY(!PlanBatchPartition(inputs, total_bytes, splittable, max_threads,
+                                                 recommended_threads, thresholds.min_bytes_per_chunk, plan))) {
+            for (auto& r : results) r = StringResult::Failure(ErrorCode::OutOfMemory);
+            return results;
+        }
+
+        auto convert_range = [this, &inputs, &results, &plan, fromEncoding, toEncoding](size_t start, size_t end) {
+            for (size_t i = start; i < end; ++i) {
+                if (plan.IsLarge(inputs[i].size())) continue;
+                std::string output;
+                ErrorCode ec = ConvertEncodingStatelessFast(inputs[i], fromEncoding, toEncoding, output);
+                results[i] = (ec == ErrorCode::Success)
+                    ? StringResult::Success(std::move(output))
+                    : StringResult::Failure(ec);
+            }
+        };
+        // 超大条目逐个在全部线程上分块并行，其余条目按字节权重分段
+        for (size_t i = 0; plan.large_count > 0 && i < inputs.size(); ++i) {
+            if (!plan.IsLarge(inputs[i].size())) continue;
+            std::string output;
+            ErrorCode ec = ConvertEncodingParallel(inputs[i], fromEncoding, toEncoding, output, max_threads);
+            results[i] = (ec == ErrorCode::Success)
+                ? StringResult::Success(std::move(output))
+                : StringResult::Failure(ec);
+        }
+        RunBatchPartition(pool, plan, inputs, fromEncoding, toEncoding, convert_range);
+        return results;
+    }
+    
+    std::vector<StringResult> results;
+    results.reserve(inputs.size());
+    
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        results.emplace_back(StringResult::Success(std::string{}));
+    }
+    
     if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
-        return StringResult::Failure(ErrorCode::InvalidParameter);
+        for (auto& r : results) r = StringResult::Failure(ErrorCode::InvalidParameter);
+        return results;
     }
-
     if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
-        return StringResult::Failure(ErrorCode::InvalidSourceEncoding);
+        for (auto& r : results) r = StringResult::Failure(ErrorCode::InvalidSourceEncoding);
+        return results;
     }
     if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
-        return StringResult::Failure(ErrorCode::InvalidTargetEncoding);
+        for (auto& r : results) r = StringResult::Failure(ErrorCode::InvalidTargetEncoding);
+        return results;
     }
-
-    if (UNICONV_UNLIKELY(input.empty())) {
-        return StringResult::Success(std::string{});
+    
+    size_t total_bytes = 0;
+    for (const auto& input : inputs) {
+        total_bytes += input.size();
     }
-
-    //  一次性解析编码 ID，后续全部用整数比较
+    TraceScope trace(TraceSpanKind::BatchParallel, fromEncoding, toEncoding, total_bytes, inputs.size());
+    
+    ThreadPool& pool = UniConvThreadPool::GetInstance();
+    size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
     const EncodingId from_id = GetEncodingId(fromEncoding);
     const EncodingId to_id   = GetEncodingId(toEncoding);
 
-    if (UNICONV_LIKELY(AreSameEncoding(from_id, to_id, fromEncoding, toEncoding))) {
-        return StringResult::Success(std::string(input));
-    }
-
-    if (IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id)) {
-        if (UNICONV_LIKELY(IsAllAscii(input))) {
-            return StringResult::Success(std::string(input));
-        }
-    }
+    // 该路径逐条走 iconv，按 iconv 成本类取阈值
+    const ParallelThresholds thresholds = LoadParallelThresholds(
+        from_id != EncodingId::Unknown && from_id == to_id ? ParallelCostClass::Copy : IconvCostClass(from_id, to_id));
+    size_t recommended_threads = AdaptiveParallelPolicy::GetRecommendedThreads(
+        inputs.size(), total_bytes, max_threads, thresholds);
 
-    //==========================================================================
-    //  simdutf SIMD 加速快速路径
-    //==========================================================================
-#ifdef UNICONV_HAS_SIMDUTF
-    if (from_id == EncodingId::UTF8 && to_id == EncodingId::UTF16LE) {
-        return ConvertUtf8ToUtf16LE_SIMD(input);
-    }
-    if (from_id == EncodingId::UTF16LE && to_id == EncodingId::UTF8) {
-        return ConvertUtf16LEToUtf8_SIMD(input);
-    }
-    if (from_id == EncodingId::UTF8 && to_id == EncodingId::UTF16BE) {
-        return ConvertUtf8ToUtf16BE_SIMD(input);
-    }
-    if (from_id == EncodingId::UTF16BE && to_id == EncodingId::UTF8) {
-        return ConvertUtf16BEToUtf8_SIMD(input);
+    BatchPartition plan;
+    const bool splittable = from_id != to_id && IsChunkSplittable(from_id) && IsChunkSplittable(to_id);
+    if (UNICONV_UNLIKELY(!PlanBatchPartition(inputs, total_bytes, splittable, max_threads,
+                                             recommended_threads, thresholds.min_bytes_per_chunk, plan))) {
+        for (auto& r : results) r = StringResult::Failure(ErrorCode::OutOfMemory);
+        return results;
     }
-#endif // UNICONV_HAS_SIMDUTF
-    //==========================================================================
-
-    UNICONV_PREFETCH(input.data(), 0, 3);
-
-    auto descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
-    if (UNICONV_UNLIKELY(!descriptor)) {
-        return StringResult::Failure(ErrorCode::ConversionFailed);
+    if (recommended_threads == 0 && plan.large_count == 0) {
+        return ConvertEncodingBatch(inputs, fromEncoding, toEncoding);
     }
+    const bool same_encoding = AreSameEncoding(from_id, to_id, fromEncoding, toEncoding);
+    const bool both_ascii    = IsAsciiPassthroughPair(from_id, to_id);
+    const uint8_t from_raw   = static_cast<uint8_t>(from_id);
+    const uint8_t to_raw     = static_cast<uint8_t>(to_id);
 
-    iconv_t cd = static_cast<iconv_t>(descriptor.get());
+    auto convert_range =
+        [this, &inputs, &results, &plan, fromEncoding, toEncoding,
+         same_encoding, both_ascii, from_raw, to_raw](size_t start, size_t end) {
 
-    const char* inbuf_ptr = input.data();
-    std::size_t inbuf_left = input.size();
+            IconvLease descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
+            if (UNICONV_UNLIKELY(!descriptor)) {
+                for (size_t i = start; i < end; ++i)
+                    if (!plan.IsLarge(inputs[i].size()))
+                        results[i] = StringResult::Failure(ErrorCode::ConversionFailed);
+                return;
+            }
+            iconv_t cd = static_cast<iconv_t>(descriptor.get());
 
-    // 传入已解析的 EncodingId，避免 EstimateOutputSize 内部重复解析
-    size_t estimated_size = EstimateOutputSizeById(input.size(),
-                                                    static_cast<uint8_t>(from_id),
-                                                    static_cast<uint8_t>(to_id));
-    std::string result;
-    result.resize(estimated_size);
+            for (size_t i = start; i < end; ++i) {
+                const auto& input = inputs[i];
+                if (input.empty() || plan.IsLarge(input.size())) continue;
+                UNICONV_METRICS_CALL(metrics, fromEncoding, toEncoding, ConversionPath::Iconv, input.size());
 
-    size_t written_total = 0;
-    constexpr int max_iterations = 100;
-    int iteration_count = 0;
+                if (UNICONV_UNLIKELY(same_encoding)) {
+                    UNICONV_METRICS_NOTE(metrics, path, ConversionPath::Copy);
+                    UNICONV_METRICS_NOTE(metrics, bytesOut, input.size());
+                    results[i] = StringResult::Success(std::string(input));
+                    continue;
+                }
+                const size_t ascii_prefix = both_ascii ? AsciiPrefixLength(input) : 0;
+                if (ascii_prefix == input.size()) {
+                    UNICONV_METRICS_NOTE(metrics, path, ConversionPath::AsciiShortcut);
+                    UNICONV_METRICS_NOTE(metrics, bytesOut, input.size());
+                    results[i] = StringResult::Success(std::string(input));
+                    continue;
+                }
 
-    while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
-        char* outbuf_ptr = result.data() + written_total;
-        std::size_t outbuf_left = result.size() - written_total;
+                size_t estimated_size = ascii_prefix + EstimateOutputSizeById(input.size() - ascii_prefix, from_raw, to_raw);
+                std::string result;
+                result.resize(estimated_size);
+                std::memcpy(result.data(), input.data(), ascii_prefix);
 
-        UNICONV_PREFETCH(outbuf_ptr, 1, 2);
+                const char* inbuf_ptr = input.data() + ascii_prefix;
+                std::size_t inbuf_left = input.size() - ascii_prefix;
+                size_t written_total = ascii_prefix;
+                constexpr int max_iterations = 100;
+                int iteration_count = 0;
+                bool ok = true;
 
-        std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+                while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
+                    char* outbuf_ptr = result.data() + written_total;
+                    std::size_t outbuf_left = result.size() - written_total;
 
-        written_total = result.size() - outbuf_left;
+                    std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+                    written_total = result.size() - outbuf_left;
 
-        if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
-            int current_errno = errno;
-            switch (current_errno) {
-                case E2BIG: {
-                    if (UNICONV_UNLIKELY(result.size() >= 1048576 * 10)) {
-                        return StringResult::Failure(ErrorCode::BufferTooSmall);
+                    if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+                        int e = errno;
+                        if (e == E2BIG && result.size() < 1048576 * 10) {
+                            result.resize(result.size() * 2);
+                            continue;
+                        }
+                        ok = false;
+                        break;
+                    } else {
+                        break;
                     }
-                    result.resize(result.size() * 2);
-                    continue;
                 }
-                case EILSEQ:
-                    return StringResult::Failure(ErrorCode::InvalidSequence);
-                case EINVAL:
-                    return StringResult::Failure(ErrorCode::IncompleteSequence);
-                default:
-                    return StringResult::Failure(ErrorCode::ConversionFailed);
+
+                if (UNICONV_UNLIKELY(!ok || iteration_count >= max_iterations)) {
+                    UNICONV_METRICS_NOTE(metrics, status, ErrorCode::ConversionFailed);
+                    results[i] = StringResult::Failure(ErrorCode::ConversionFailed);
+                } else {
+                    result.resize(written_total);
+                    UNICONV_METRICS_NOTE(metrics, bytesOut, written_total);
+                    results[i] = StringResult::Success(std::move(result));
+                }
+                portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
             }
-        } else {
-            break;
-        }
-    }
+        };
 
-    if (UNICONV_UNLIKELY(iteration_count >= max_iterations)) {
-        return StringResult::Failure(ErrorCode::InternalError);
+    // 超大条目逐个在全部线程上分块并行，其余条目按字节权重分段
+    for (size_t i = 0; plan.large_count > 0 && i < inputs.size(); ++i) {
+        if (!plan.IsLarge(inputs[i].size())) continue;
+        std::string output;
+        ErrorCode ec = ConvertEncodingParallel(inputs[i], fromEncoding, toEncoding, output, max_threads);
+        results[i] = (ec == ErrorCode::Success)
+            ? StringResult::Success(std::move(output))
+            : StringResult::Failure(ec);
     }
-
-    result.resize(written_total);
-    return StringResult::Success(std::move(result));
+    RunBatchPartition(pool, plan, inputs, fromEncoding, toEncoding, convert_range);
+    
+    return results;
 }
 
-const char* UniConv::GetEncodingNamePtr(int codepage) noexcept {
-    // 预测codepage存在于映射中
-    auto it = m_encodingMap.find(static_cast<std::uint16_t>(codepage));
-    return UNICONV_LIKELY(it != m_encodingMap.end()) ? it->second.dotNetName.c_str() : nullptr;
-}
+bool UniConv::ConvertEncodingBatchParallel(
+    const std::vector<std::string>& inputs,
+    const char* fromEncoding,
+    const char* toEncoding,
+    std::vector<std::string>& outputs,
+    size_t numThreads) noexcept {
 
-StringViewResult UniConv::GetEncodingNameFast(int codepage) noexcept {
-    // 预测codepage存在于映射中
-    auto it = m_encodingMap.find(static_cast<std::uint16_t>(codepage));
-    if (UNICONV_LIKELY(it != m_encodingMap.end())) {
-        return StringViewResult::Success(std::string_view{it->second.dotNetName});
-    } else {
-        return StringViewResult::Failure(ErrorCode::EncodingNotFound);
-    }
-}
+    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
+        outputs.clear();
+        outputs.resize(inputs.size());
 
-IntResult UniConv::GetSystemCodePageFast() noexcept {
-#ifdef _WIN32
-    UINT codepage = GetACP();
-    return IntResult::Success(static_cast<int>(codepage));
-#elif defined(__linux__) || defined(__APPLE__)
-    setlocale(LC_ALL, "");
-    char* encoding = nl_langinfo(CODESET);
-    if (encoding) {
-        auto it = m_encodingToCodePageMap.find(encoding);
-        if (it != m_encodingToCodePageMap.end()) {
-            return IntResult::Success(static_cast<int>(it->second));
+        if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+            return false;
         }
-    }
-    return IntResult::Failure(ErrorCode::EncodingNotFound);
-#else
-    return IntResult::Failure(ErrorCode::SystemError);
-#endif
-}
 
-//----------------------------------------------------------------------------------------------------------------------
-// === High-Performance Internal Methods Implementation ===
-//----------------------------------------------------------------------------------------------------------------------
+        size_t total_bytes = 0;
+        for (const auto& input : inputs) {
+            total_bytes += input.size();
+        }
+        TraceScope trace(TraceSpanKind::BatchParallel, fromEncoding, toEncoding, total_bytes, inputs.size());
 
-// ===================================================================================================================
-// Encoding-Aware Output Size Estimation (P3 Optimization)
-// ===================================================================================================================
+        ThreadPool& pool = UniConvThreadPool::GetInstance();
+        size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
+        const ParallelThresholds thresholds = LoadParallelThresholds(ClassifyParallelCost(fromEncoding, toEncoding));
+        size_t recommended_threads = AdaptiveParallelPolicy::GetRecommendedThreads(
+            inputs.size(), total_bytes, max_threads, thresholds);
 
-namespace {
-    // Encoding expansion factor table (from_id, to_id) -> factor
-    // Factor < 1.0 means output is smaller, > 1.0 means output is larger
-    constexpr double GetExpansionFactor(EncodingId from, EncodingId to) noexcept {
-        // Same encoding family optimizations
-        if (from == to) return 1.0;
-        
-        // UTF-8 conversions
-        if (from == EncodingId::UTF8) {
-            switch (to) {
-                case EncodingId::UTF16:
-                case EncodingId::UTF16LE:
-                case EncodingId::UTF16BE:
-                    return 2.0;  // UTF-8 can expand to 2x in UTF-16
-                case EncodingId::UTF32:
-                case EncodingId::UTF32LE:
-                case EncodingId::UTF32BE:
-                    return 4.0;  // UTF-8 can expand to 4x in UTF-32
-                case EncodingId::ASCII:
-                    return 1.0;  // ASCII subset stays same
-                case EncodingId::GBK:
-                case EncodingId::GB2312:
-                case EncodingId::GB18030:
-                case EncodingId::BIG5:
-                    return 1.0;  // Similar size for CJK
-                default:
-                    return 1.5;
-            }
-        }
-        
-        // UTF-16 conversions
-        if (from == EncodingId::UTF16 || from == EncodingId::UTF16LE || from == EncodingId::UTF16BE) {
-            switch (to) {
-                case EncodingId::UTF8:
-                    return 1.5;  // UTF-16 to UTF-8 usually similar or smaller
-                case EncodingId::UTF32:
-                case EncodingId::UTF32LE:
-                case EncodingId::UTF32BE:
-                    return 2.0;  // Each UTF-16 unit becomes 4 bytes
-                case EncodingId::ASCII:
-                    return 0.5;  // 2 bytes -> 1 byte for ASCII range
-                case EncodingId::GBK:
-                case EncodingId::GB2312:
-                case EncodingId::GB18030:
-                    return 1.0;  // Similar size
-                default:
-                    return 1.0;
-            }
-        }
-        
-        // UTF-32 conversions
-        if (from == EncodingId::UTF32 || from == EncodingId::UTF32LE || from == EncodingId::UTF32BE) {
-            switch (to) {
-                case EncodingId::UTF8:
-                    return 1.0;  // UTF-32 to UTF-8 usually shrinks
-                case EncodingId::UTF16:
-                case EncodingId::UTF16LE:
-                case EncodingId::UTF16BE:
-                    return 0.5;  // 4 bytes -> 2 bytes typical
-                default:
-                    return 0.5;
-            }
-        }
-        
-        // CJK encodings (GBK, GB2312, GB18030, BIG5)
-        if (from == EncodingId::GBK || from == EncodingId::GB2312 || 
-            from == EncodingId::GB18030 || from == EncodingId::BIG5) {
-            switch (to) {
-                case EncodingId::UTF8:
-                    return 1.5;  // CJK characters: 2 bytes -> 3 bytes
-                case EncodingId::UTF16:
-                case EncodingId::UTF16LE:
-                case EncodingId::UTF16BE:
-                    return 1.0;  // Similar size
-                case EncodingId::UTF32:
-                case EncodingId::UTF32LE:
-                case EncodingId::UTF32BE:
-                    return 2.0;  // 2 bytes -> 4 bytes
-                default:
-                    return 1.2;
-            }
-        }
-        
-        // ASCII/Latin1 conversions
-        if (from == EncodingId::ASCII || from == EncodingId::ISO8859_1 || from == EncodingId::Windows1252) {
-            switch (to) {
-                case EncodingId::UTF8:
-                    return 1.5;  // Extended ASCII chars become multi-byte
-                case EncodingId::UTF16:
-                case EncodingId::UTF16LE:
-                case EncodingId::UTF16BE:
-                    return 2.0;  // 1 byte -> 2 bytes
-                case EncodingId::UTF32:
-                case EncodingId::UTF32LE:
-                case EncodingId::UTF32BE:
-                    return 4.0;  // 1 byte -> 4 bytes
-                default:
-                    return 1.2;
-            }
+        BatchPartition plan;
+        const bool splittable = IsChunkSplittablePair(fromEncoding, toEncoding);
+        if (UNICONV_UNLIKELY(!PlanBatchPartition(inputs, total_bytes, splittable, max_threads,
+                                                 recommended_threads, thresholds.min_bytes_per_chunk, plan))) {
+            return false;
         }
-        
-        // Default: conservative estimate
-        return 2.0;
-    }
-}
-
-size_t UniConv::EstimateOutputSize(size_t input_size, const char* from_encoding, const char* to_encoding) noexcept {
-    return EstimateOutputSizeById(input_size,
-                                  static_cast<uint8_t>(GetEncodingId(from_encoding)),
-                                  static_cast<uint8_t>(GetEncodingId(to_encoding)));
-}
 
-size_t UniConv::EstimateOutputSizeById(size_t input_size, uint8_t from_raw, uint8_t to_raw) noexcept {
-    if (input_size == 0) return 512;
+        std::atomic<bool> all_success{true};
+        auto convert_range = [this, &inputs, &outputs, &all_success, &plan, fromEncoding, toEncoding](size_t start, size_t end) {
+            bool chunk_success = true;
+            for (size_t i = start; i < end; ++i) {
+                if (plan.IsLarge(inputs[i].size())) continue;
+                ErrorCode ec = ConvertEncodingStatelessFast(inputs[i], fromEncoding, toEncoding, outputs[i]);
+                if (ec != ErrorCode::Success) {
+                    outputs[i].clear();
+                    chunk_success = false;
+                }
+            }
+            if (!chunk_success) {
+                all_success.store(false, std::memory_order_relaxed);
+            }
+        };
 
-    auto from_id = static_cast<EncodingId>(from_raw);
-    auto to_id   = static_cast<EncodingId>(to_raw);
+        // 超大条目逐个在全部线程上分块并行，其余条目按字节权重分段
+        for (size_t i = 0; plan.large_count > 0 && i < inputs.size(); ++i) {
+            if (!plan.IsLarge(inputs[i].size())) continue;
+            if (ConvertEncodingParallel(inputs[i], fromEncoding, toEncoding, outputs[i], max_threads) != ErrorCode::Success) {
+                outputs[i].clear();
+                all_success.store(false, std::memory_order_relaxed);
+            }
+        }
+        RunBatchPartition(pool, plan, inputs, fromEncoding, toEncoding, convert_range);
 
-    if (from_id == to_id && from_id != EncodingId::Unknown) {
-        return input_size + 16;
+        if (!all_success.load(std::memory_order_relaxed)) {
+            trace.SetResult(ErrorCode::ConversionFailed);
+            return false;
+        }
+        return true;
     }
+    
+    outputs.clear();
+    outputs.resize(inputs.size());
+    
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        return false;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding) || !IsValidEncodingName(toEncoding))) {
+        return false;
+    }
+    
+    size_t total_bytes = 0;
+    for (const auto& input : inputs) {
+        total_bytes += input.size();
+    }
+    TraceScope trace(TraceSpanKind::BatchParallel, fromEncoding, toEncoding, total_bytes, inputs.size());
+    
+    ThreadPool& pool = UniConvThreadPool::GetInstance();
+    size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
+    const EncodingId from_id = GetEncodingId(fromEncoding);
+    const EncodingId to_id   = GetEncodingId(toEncoding);
 
-    double expansion_factor = GetExpansionFactor(from_id, to_id);
-    double estimated = static_cast<double>(input_size) * expansion_factor * 1.15;
-
-    constexpr size_t MIN_BUFFER_SIZE = 512;
-    constexpr size_t MAX_REASONABLE_SIZE = 32 * 1024 * 1024;
-
-    return std::clamp(static_cast<size_t>(estimated), MIN_BUFFER_SIZE, MAX_REASONABLE_SIZE);
-}
+    // 该路径逐条走 iconv，按 iconv 成本类取阈值
+    const ParallelThresholds thresholds = LoadParallelThresholds(
+        from_id != EncodingId::Unknown && from_id == to_id ? ParallelCostClass::Copy : IconvCostClass(from_id, to_id));
+    size_t recommended_threads = AdaptiveParallelPolicy::GetRecommendedThreads(
+        inputs.size(), total_bytes, max_threads, thresholds);
 
-bool UniConv::IsValidEncodingName(const char* encoding) noexcept {
-    if (UNICONV_UNLIKELY(!encoding || strlen(encoding) == 0)) {
+    BatchPartition plan;
+    const bool splittable = from_id != to_id && IsChunkSplittable(from_id) && IsChunkSplittable(to_id);
+    if (UNICONV_UNLIKELY(!PlanBatchPartition(inputs, total_bytes, splittable, max_threads,
+                                             recommended_threads, thresholds.min_bytes_per_chunk, plan))) {
         return false;
     }
+    if (recommended_threads == 0 && plan.large_count == 0) {
+        return ConvertEncodingBatch(inputs, fromEncoding, toEncoding, outputs);
+    }
+    const bool same_encoding = AreSameEncoding(from_id, to_id, fromEncoding, toEncoding);
+    const bool both_ascii    = IsAsciiPassthroughPair(from_id, to_id);
+    const uint8_t from_raw   = static_cast<uint8_t>(from_id);
+    const uint8_t to_raw     = static_cast<uint8_t>(to_id);
+
+    std::atomic<bool> all_success{true};
     
-    // 使用静态集合进行 O(1) 查找（线程安全的静态初始化）
-    // 使用 lambda 初始化以访问类的私有静态成员
-    static const std::unordered_set<std::string> valid_encodings = []() {
-        std::unordered_set<std::string> valid_set;
-        valid_set.reserve(256);  // 预留足够空间
-        
-        // 从 m_encodingMap 提取标准编码名称
-        for (const auto& [cp, info] : m_encodingMap) {
-            valid_set.insert(info.dotNetName);
-        }
-        
-        // 从 m_encodingToCodePageMap 提取所有已知编码
-        for (const auto& [name, cp] : m_encodingToCodePageMap) {
-            valid_set.insert(name);
-        }
-        
-        // 添加常见别名和大小写变体
-        const char* common_aliases[] = {
-            // UTF 系列
-            "utf-8", "UTF8", "utf8",
-            "utf-16", "UTF16", "utf16",
-            "utf-32", "UTF32", "utf32",
-            "utf-16le", "UTF-16LE", "utf16le",
-            "utf-16be", "UTF-16BE", "utf16be",
-            "utf-32le", "UTF-32LE", "utf32le",
-            "utf-32be", "UTF-32BE", "utf32be",
-            // 中文编码
-            "gb2312", "GB2312", "gbk", "GBK",
-            "gb18030", "GB18030",
-            "big5", "BIG5", "Big5",
-            // 其他常见编码
-            "ascii", "ASCII", "us-ascii", "US-ASCII",
-            "iso-8859-1", "ISO-8859-1", "latin1", "LATIN1",
-            "windows-1252", "WINDOWS-1252", "cp1252", "CP1252",
-            "shift_jis", "SHIFT_JIS", "sjis", "SJIS",
-            "euc-jp", "EUC-JP", "eucjp", "EUCJP",
-            "euc-kr", "EUC-KR", "euckr", "EUCKR",
-            "euc-cn", "EUC-CN", "euccn", "EUCCN"
-        };
-        
-        for (const char* alias : common_aliases) {
-            valid_set.insert(alias);
-        }
-        
-        return valid_set;
-    }();
-    
-    // 直接查找，避免前缀匹配和字符验证的开销
-    return valid_encodings.find(encoding) != valid_encodings.end();
-}
+    auto convert_range =
+        [this, &inputs, &outputs, &all_success, &plan, fromEncoding, toEncoding,
+         same_encoding, both_ascii, from_raw, to_raw](size_t start, size_t end) {
 
-constexpr int UniConv::GetEncodingMultiplier(const char* encoding) noexcept {
-    if (!encoding) return 4;
+            IconvLease descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
+            if (UNICONV_UNLIKELY(!descriptor)) {
+                all_success.store(false, std::memory_order_relaxed);
+                return;
+            }
+            iconv_t cd = static_cast<iconv_t>(descriptor.get());
+            bool chunk_success = true;
 
-    std::string_view enc{encoding};
+            for (size_t i = start; i < end; ++i) {
+                const auto& input = inputs[i];
+                if (plan.IsLarge(input.size())) continue;
+                std::string& output = outputs[i];
+                output.clear();
 
-    // UTF编码
-    if (enc.find("UTF-32") != std::string_view::npos ||
-        enc.find("UCS-4") != std::string_view::npos) return 4;
+                if (input.empty()) continue;
+                UNICONV_METRICS_CALL(metrics, fromEncoding, toEncoding, ConversionPath::Iconv, input.size());
 
-    if (enc.find("UTF-16") != std::string_view::npos ||
-        enc.find("UCS-2") != std::string_view::npos) return 4;  // 考虑代理对
+                if (UNICONV_UNLIKELY(same_encoding)) {
+                    UNICONV_METRICS_NOTE(metrics, path, ConversionPath::Copy);
+                    UNICONV_METRICS_NOTE(metrics, bytesOut, input.size());
+                    output = input;
+                    continue;
+                }
+                const size_t ascii_prefix = both_ascii ? AsciiPrefixLength(input) : 0;
+                if (ascii_prefix == input.size()) {
+                    UNICONV_METRICS_NOTE(metrics, path, ConversionPath::AsciiShortcut);
+                    UNICONV_METRICS_NOTE(metrics, bytesOut, input.size());
+                    output = input;
+                    continue;
+                }
 
-    if (enc.find("UTF-8") != std::string_view::npos) return 4;
+                size_t estimated_size = ascii_prefix + EstimateOutputSizeById(input.size() - ascii_prefix, from_raw, to_raw);
+                try {
+                    output.resize(estimated_size);
+                } catch (...) {
+                    UNICONV_METRICS_NOTE(metrics, status, ErrorCode::OutOfMemory);
+                    chunk_success = false;
+                    continue;
+                }
+                std::memcpy(output.data(), input.data(), ascii_prefix);
 
-    // 中文编码
-    if (enc.find("GBK") != std::string_view::npos ||
-        enc.find("GB2312") != std::string_view::npos ||
-        enc.find("GB18030") != std::string_view::npos) return 4;  // GB18030可达4字节
+                const char* inbuf_ptr = input.data() + ascii_prefix;
+                std::size_t inbuf_left = input.size() - ascii_prefix;
+                size_t written_total = ascii_prefix;
+                constexpr int max_iterations = 100;
+                int iteration_count = 0;
+                bool ok = true;
 
-    if (enc.find("Big5") != std::string_view::npos) return 2;
+                while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
+                    char* outbuf_ptr = output.data() + written_total;
+                    std::size_t outbuf_left = output.size() - written_total;
 
-    // 欧洲编码
-    if (enc.find("ISO-8859") != std::string_view::npos) return 1;
+                    std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+                    written_total = output.size() - outbuf_left;
 
-    if (enc.find("CP1252") != std::string_view::npos) return 1;
-    
-    // 日文编码
-    if (enc.find("SHIFT_JIS") != std::string_view::npos ||
-        enc.find("EUC-JP") != std::string_view::npos) return 3;
-    
-    // 默认保守估计
-    return 4;
-}
+                    if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+                        int e = errno;
+                        if (e == E2BIG && output.size() < 1048576 * 10) {
+                            try { output.resize(output.size() * 2); } catch (...) { ok = false; break; }
+                            continue;
+                        }
+                        ok = false;
+                        break;
+                    } else {
+                        break;
+                    }
+                }
 
-StringResult UniConv::ConvertEncodingInternal(const std::string& input,const char* fromEncoding,const char* toEncoding,StringBufferPool::BufferLease& buffer_lease,size_t estimated_size) noexcept {
-    // 更新统计
-    m_totalConversions.fetch_add(1, std::memory_order_relaxed);
+                if (UNICONV_UNLIKELY(!ok || iteration_count >= max_iterations)) {
+                    UNICONV_METRICS_NOTE(metrics, status, ErrorCode::ConversionFailed);
+                    chunk_success = false;
+                    output.clear();
+                } else {
+                    output.resize(written_total);
+                    UNICONV_METRICS_NOTE(metrics, bytesOut, written_total);
+                }
+                portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+            }
 
-    // 获取缓冲区
-    std::string& result = buffer_lease.get();
-    result.clear();
+            if (!chunk_success) {
+                all_success.store(false, std::memory_order_relaxed);
+            }
+        };
 
-    // 预分配容量
-    try {
-        result.reserve(estimated_size);
-    } catch (...) {
-        return StringResult::Failure(ErrorCode::OutOfMemory);
+    // 超大条目逐个在全部线程上分块并行，其余条目按字节权重分段
+    for (size_t i = 0; plan.large_count > 0 && i < inputs.size(); ++i) {
+        if (!plan.IsLarge(inputs[i].size())) continue;
+        if (ConvertEncodingParallel(inputs[i], fromEncoding, toEncoding, outputs[i], max_threads) != ErrorCode::Success) {
+            outputs[i].clear();
+            all_success.store(false, std::memory_order_relaxed);
+        }
     }
-
-    // 获取iconv描述符
-    auto descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
-    if (!descriptor) {
-        return StringResult::Failure(ErrorCode::InvalidSourceEncoding);
+    RunBatchPartition(pool, plan, inputs, fromEncoding, toEncoding, convert_range);
+    
+    if (!all_success.load(std::memory_order_relaxed)) {
+        trace.SetResult(ErrorCode::ConversionFailed);
+        return false;
     }
+    return true;
+}
 
-    // 准备转换参数
-    const char* inbuf = input.data();
-    size_t inbytesleft = input.size();
-
-    //  16 字节对齐的栈缓冲区，利于缓存行和 SIMD 操作
-    constexpr size_t CHUNK_SIZE = 8192;
-    alignas(16) char temp_chunk[CHUNK_SIZE];
+// ===================================================================================================================
+// Chunk-Parallel Single-Buffer Conversion
+// ===================================================================================================================
 
-    // 转换循环
-    constexpr int MAX_ITERATIONS = 1000;  // 防止无限循环
-    int iteration_count = 0;
+namespace {
 
-    while (inbytesleft > 0 && iteration_count < MAX_ITERATIONS) {
-        char* outbuf = temp_chunk;
-        size_t outbytesleft = CHUNK_SIZE;
-        
-        size_t converted = portable_iconv(static_cast<iconv_t>(descriptor.get()), &inbuf, &inbytesleft,&outbuf, &outbytesleft);
-        
-        // 添加已转换的数据到结果
-        size_t chunk_converted = CHUNK_SIZE - outbytesleft;
-        if (chunk_converted > 0) {
-            try {
-                result.append(temp_chunk, chunk_converted);
-            } catch (...) {
-                return StringResult::Failure(ErrorCode::OutOfMemory);
-            }
-        }
-        
-        if (converted == (size_t)-1) {
-            switch (errno) {
-                case E2BIG:
-                    // 输出缓冲区满，继续下一轮
-                    continue;
-                case EILSEQ:
-                    return StringResult::Failure(ErrorCode::InvalidSequence);
-                case EINVAL:
-                    return StringResult::Failure(ErrorCode::IncompleteSequence);
-                default:
-                    return StringResult::Failure(ErrorCode::ConversionFailed);
-            }
-        }
-        
-        ++iteration_count;
+/**
+ * @brief 目标编码单个字符的最大字节数
+ */
+inline size_t MaxBytesPerChar(EncodingId id) noexcept {
+    if (IsSbcsId(id)) {
+        return 1;
     }
-    
-    if (iteration_count >= MAX_ITERATIONS) {
-        return StringResult::Failure(ErrorCode::InternalError);
+    switch (id) {
+        case EncodingId::ASCII:
+            return 1;
+        case EncodingId::GBK:
+        case EncodingId::GB2312:
+        case EncodingId::BIG5:
+        case EncodingId::ShiftJIS:
+        case EncodingId::EUC_KR:
+            return 2;
+        case EncodingId::EUC_JP:
+            return 3;
+        default:
+            return 4;  // UTF-*, GB18030
     }
-    
-    // 成功，返回结果
-    return StringResult::Success(std::move(result));
 }
 
-//----------------------------------------------------------------------------------------------------------------------
-// === Batch Processing Methods Implementation ===
-//----------------------------------------------------------------------------------------------------------------------
+/**
+ * @brief 分块输出的严格上界（字节）
+ * @details 按“每输入字节最多产出的输出字节数”（×2 定点）计算，保证 iconv 不会 E2BIG
+ */
+inline size_t MaxChunkOutputBytes(size_t len, EncodingId from, EncodingId to) noexcept {
+    const bool to_utf8  = to == EncodingId::UTF8;
+    const bool to_utf16 = to == EncodingId::UTF16LE || to == EncodingId::UTF16BE;
+    const bool to_utf32 = to == EncodingId::UTF32LE || to == EncodingId::UTF32BE;
 
-std::vector<StringResult> UniConv::ConvertEncodingBatch(const std::vector<std::string>& inputs,const char* fromEncoding,const char* toEncoding) noexcept {
-    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
-        std::vector<StringResult> results;
-        results.reserve(inputs.size());
-        for (const auto& input : inputs) {
-            std::string output;
-            ErrorCode ec = ConvertEncodingStatelessFast(input, fromEncoding, toEncoding, output);
-            if (ec == ErrorCode::Success) {
-                results.emplace_back(StringResult::Success(std::move(output)));
-            } else {
-                results.emplace_back(StringResult::Failure(ec));
+    size_t factor2;
+    switch (from) {
+        case EncodingId::UTF8:
+            factor2 = to_utf8 ? 2 : to_utf16 ? 4 : to_utf32 ? 8 : (std::max)(size_t(2), MaxBytesPerChar(to));
+            break;
+        case EncodingId::UTF16LE:
+        case EncodingId::UTF16BE:
+            factor2 = to_utf8 ? 3 : to_utf16 ? 2 : to_utf32 ? 4 : MaxBytesPerChar(to);
+            break;
+        case EncodingId::UTF32LE:
+        case EncodingId::UTF32BE:
+            factor2 = 2;
+            break;
+        default:  // 单字节/双字节传统编码
+            factor2 = to_utf8 ? 6 : to_utf16 ? 4 : to_utf32 ? 8 : 2 * MaxBytesPerChar(to);
+            break;
+    }
+    return (len * factor2 + 1) / 2 + 16;
+}
+
+/**
+ * @brief 从 pos 起寻找不拆分字符的安全分割点
+ * @return 分割点（<= len）
+ */
+inline size_t FindSafeSplit(const unsigned char* data, size_t len, size_t pos, EncodingId id) noexcept {
+    switch (id) {
+        case EncodingId::UTF8:
+            // 跳过续字节 10xxxxxx
+            while (pos < len && (data[pos] & 0xC0) == 0x80) ++pos;
+            return pos;
+        case EncodingId::UTF16LE:
+        case EncodingId::UTF16BE: {
+            pos &= ~size_t(1);
+            if (pos + 1 < len) {
+                const uint16_t unit = (id == EncodingId::UTF16LE)
+                    ? static_cast<uint16_t>(data[pos] | (data[pos + 1] << 8))
+                    : static_cast<uint16_t>((data[pos] << 8) | data[pos + 1]);
+                if (unit >= 0xDC00 && unit <= 0xDFFF) pos += 2;  // 不拆分代理对
+            }
+            return (std::min)(pos, len);
+        }
+        case EncodingId::UTF32LE:
+        case EncodingId::UTF32BE:
+            return pos & ~size_t(3);
+        case EncodingId::ASCII:
+            return pos;
+        default: {
+            if (IsSbcsId(id)) {
+                return pos;
             }
+            // 双字节编码：低于尾字节下界的字节必为独立字符，其后即为字符边界
+            //   GBK / Big5 / Shift_JIS: 尾字节 >= 0x40
+            //   GB18030: 四字节序列第 2/4 字节为 0x30-0x39
+            //   EUC-CN(GB2312) / EUC-JP / EUC-KR: 多字节序列全部 >= 0x80
+            unsigned char limit = 0x40;
+            if (id == EncodingId::GB18030) limit = 0x30;
+            else if (id == EncodingId::GB2312 || id == EncodingId::EUC_JP || id == EncodingId::EUC_KR) limit = 0x80;
+            while (pos < len) {
+                if (data[pos++] < limit) return pos;
+            }
+            return len;
         }
-        return results;
     }
+}
+
+} // anonymous namespace
+
+ErrorCode UniConv::ConvertEncodingParallel(
+    std::string_view input,
+    const char* fromEncoding,
+    const char* toEncoding,
+    std::string& output,
+    size_t numThreads) noexcept {
+
+    output.clear();
 
-    std::vector<StringResult> results;
-    results.reserve(inputs.size());
-    
-    // 参数验证 - 预测参数通常有效
     if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
-        // 为所有输入返回错误结果
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            results.emplace_back(StringResult::Failure(ErrorCode::InvalidParameter));
-        }
-        return results;
+        return ErrorCode::InvalidParameter;
     }
-    
-    // 快速编码名称有效性检查
     if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            results.emplace_back(StringResult::Failure(ErrorCode::InvalidSourceEncoding));
-        }
-        return results;
+        return ErrorCode::InvalidSourceEncoding;
     }
     if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            results.emplace_back(StringResult::Failure(ErrorCode::InvalidTargetEncoding));
-        }
-        return results;
-    }
-    
-    if (UNICONV_LIKELY(!inputs.empty())) {
-        UNICONV_PREFETCH(inputs.data(), 0, 2);
-    }
-    
-    auto descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
-    if (UNICONV_UNLIKELY(!descriptor)) {
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            results.emplace_back(StringResult::Failure(ErrorCode::InvalidSourceEncoding));
-        }
-        return results;
+        return ErrorCode::InvalidTargetEncoding;
     }
-    
+
     const EncodingId from_id = GetEncodingId(fromEncoding);
     const EncodingId to_id   = GetEncodingId(toEncoding);
-    const bool same_encoding = AreSameEncoding(from_id, to_id, fromEncoding, toEncoding);
-    const bool both_ascii    = IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id);
-    const uint8_t from_raw   = static_cast<uint8_t>(from_id);
-    const uint8_t to_raw     = static_cast<uint8_t>(to_id);
 
-    for (const auto& input : inputs) {
-        if (input.empty()) {
-            results.emplace_back(StringResult::Success(std::string{}));
-            continue;
+    const size_t min_chunk_bytes = LoadParallelThresholds(IconvCostClass(from_id, to_id)).min_bytes_per_chunk;
+
+    // 小输入、不可拆分编码、同编码：走串行路径
+    if (input.size() < 2 * min_chunk_bytes ||
+        !IsChunkSplittable(from_id) || !IsChunkSplittable(to_id) ||
+        from_id == to_id ||
+        input.size() > (std::numeric_limits<size_t>::max)() / 8) {
+        return ConvertEncodingFast(input, fromEncoding, toEncoding, output);
+    }
+
+    ThreadPool& pool = UniConvThreadPool::GetInstance();
+    const size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
+    const size_t num_chunks  = (std::max)(size_t(1),
+        (std::min)(max_threads, input.size() / min_chunk_bytes));
+
+    const auto* data = reinterpret_cast<const unsigned char*>(input.data());
+    const size_t len = input.size();
+
+    std::vector<size_t>    bounds;    // 输入分割点 [0, ..., len]
+    std::vector<size_t>    offsets;   // 输出区域前缀和（按上界）
+    std::vector<size_t>    written;   // 各块实际输出字节数
+    std::vector<ErrorCode> errors;
+    try {
+        bounds.reserve(num_chunks + 1);
+        bounds.push_back(0);
+        for (size_t i = 1; i < num_chunks; ++i) {
+            const size_t split = FindSafeSplit(data, len, len / num_chunks * i, from_id);
+            if (split > bounds.back() && split < len) {
+                bounds.push_back(split);
+            }
         }
-        
-        if (UNICONV_UNLIKELY(same_encoding)) {
-            results.emplace_back(StringResult::Success(std::string(input)));
-            continue;
+        bounds.push_back(len);
+
+        const size_t chunk_count = bounds.size() - 1;
+        offsets.resize(chunk_count + 1);
+        offsets[0] = 0;
+        for (size_t c = 0; c < chunk_count; ++c) {
+            offsets[c + 1] = offsets[c] + MaxChunkOutputBytes(bounds[c + 1] - bounds[c], from_id, to_id);
         }
-        if (both_ascii && IsAllAscii(input)) {
-            results.emplace_back(StringResult::Success(std::string(input)));
-            continue;
+        written.assign(chunk_count, 0);
+        errors.assign(chunk_count, ErrorCode::Success);
+        output.resize(offsets.back());
+    } catch (...) {
+        output.clear();
+        return ErrorCode::OutOfMemory;
+    }
+
+    const size_t chunk_count = bounds.size() - 1;
+    const bool stateless = GetApiLayerMode() == ApiLayerMode::Stateless;
+    char* const out_base = output.data();
+
+    auto convert_chunks = [&, this](size_t start, size_t end) {
+        // 每个工作线程独占自己的 iconv 描述符
+        IconvLease descriptor;
+        if (stateless) {
+            iconv_t cd = iconv_open(toEncoding, fromEncoding);
+            if (cd != reinterpret_cast<iconv_t>(-1)) {
+                descriptor = IconvLease::Adopt(static_cast<void*>(cd));
+            }
+        } else {
+            descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
         }
-        
-        size_t estimated = EstimateOutputSizeById(input.size(), from_raw, to_raw);
-        
-        auto buffer_lease = m_stringBufferPool.acquire(estimated);
-        if (!buffer_lease.valid()) {
-            results.emplace_back(StringResult::Failure(ErrorCode::OutOfMemory));
-            continue;
+        if (UNICONV_UNLIKELY(!descriptor)) {
+            for (size_t c = start; c < end; ++c) errors[c] = ErrorCode::ConversionFailed;
+            return;
         }
-        
-        results.emplace_back(ConvertEncodingInternal(input, fromEncoding, toEncoding, buffer_lease, estimated));
+        iconv_t cd = static_cast<iconv_t>(descriptor.get());
+
+        for (size_t c = start; c < end; ++c) {
+            const char* inbuf_ptr   = input.data() + bounds[c];
+            std::size_t inbuf_left  = bounds[c + 1] - bounds[c];
+            char*       outbuf_ptr  = out_base + offsets[c];
+            std::size_t outbuf_left = offsets[c + 1] - offsets[c];
+            const std::size_t capacity = outbuf_left;
+            UNICONV_METRICS_CALL(metrics, fromEncoding, toEncoding,
+                                 stateless ? ConversionPath::StatelessIconv : ConversionPath::Iconv, inbuf_left);
+
+            std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+            if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+                errors[c] = IconvErrnoToErrorCode(errno);
+                UNICONV_METRICS_NOTE(metrics, status, errors[c]);
+            }
+            written[c] = capacity - outbuf_left;
+            UNICONV_METRICS_NOTE(metrics, bytesOut, written[c]);
+            portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+        }
+    };
+
+    if (chunk_count == 1) {
+        convert_chunks(0, 1);
+    } else {
+        pool.ParallelFor(chunk_count, convert_chunks, 1);
     }
-    
-    return results;
-}
 
-void UniConv::EvictLRUCacheEntries()
-{
-    // Concurrent eviction using phmap's thread-safe operations
-    if (m_iconvDescriptorCacheMap.empty()) {
-        return;
+    for (size_t c = 0; c < chunk_count; ++c) {
+        if (UNICONV_UNLIKELY(errors[c] != ErrorCode::Success)) {
+            output.clear();
+            return errors[c];
+        }
     }
-    
-    constexpr size_t TARGET_SIZE = MAX_CACHE_SIZE * 3 / 4;  // 清理到75%容量
-    
-    // 收集所有条目及其访问时间和键（现在是uint64_t哈希值）
-    std::vector<std::pair<uint64_t, uint64_t>> entries;  // (timestamp, hash_key)
-    entries.reserve(m_iconvDescriptorCacheMap.size());
-    
-    // Thread-safe iteration using phmap
-    m_iconvDescriptorCacheMap.for_each([&](const auto& item) {
-        entries.emplace_back(item.second.last_used.load(std::memory_order_relaxed), item.first);
-    });
-    
-    // 按访问时间排序（最旧的在前）
-    std::sort(entries.begin(), entries.end());
-    
-    // 删除最旧的条目直到达到目标大小
-    size_t to_remove = m_iconvDescriptorCacheMap.size() - TARGET_SIZE;
-    for (size_t i = 0; i < to_remove && i < entries.size(); ++i) {
-        if (m_iconvDescriptorCacheMap.erase(entries[i].second)) {
-            m_cacheEvictionCount.fetch_add(1, std::memory_order_relaxed);
+
+    // 原地压实：按实际输出长度的前缀和左移各块（目标地址总不大于源地址）
+    size_t total = written[0];
+    for (size_t c = 1; c < chunk_count; ++c) {
+        if (offsets[c] != total) {
+            std::memmove(out_base + total, out_base + offsets[c], written[c]);
         }
+        total += written[c];
     }
+    output.resize(total);
+    return ErrorCode::Success;
 }
 
-UniConv::PoolStats UniConv::GetPoolStatistics() const {
-    PoolStats stats;
-    stats.active_buffers = m_stringBufferPool.GetActiveBuffers();
-    stats.total_conversions = m_totalConversions.load(std::memory_order_relaxed);
-    stats.cache_hits = m_poolCacheHits.load(std::memory_order_relaxed);
-    
-    // 计算缓存命中率
-    if (stats.total_conversions > 0) {
-        stats.hit_rate = static_cast<double>(stats.cache_hits) / stats.total_conversions;
-    } else {
-        stats.hit_rate = 0.0;
-    }
-    
-    // Concurrent iconv cache statistics using phmap
-    stats.iconv_cache_size = m_iconvDescriptorCacheMap.size();
-    stats.iconv_cache_hits = m_cacheHitCount.load(std::memory_order_relaxed);
-    stats.iconv_cache_misses = m_cacheMissCount.load(std::memory_order_relaxed);
-    stats.iconv_cache_evictions = m_cacheEvictionCount.load(std::memory_order_relaxed);
-    
-    // 计算iconv命中率
-    const uint64_t total_iconv_requests = stats.iconv_cache_hits + stats.iconv_cache_misses;
-    stats.iconv_cache_hit_rate = (total_iconv_requests > 0) ? 
-        (static_cast<double>(stats.iconv_cache_hits) / total_iconv_requests) : 0.0;
-    
-    // 计算平均命中次数
-    if (stats.iconv_cache_size > 0) {
-        uint64_t total_hit_count = 0;
-        for (const auto& [key, entry] : m_iconvDescriptorCacheMap) {
-            total_hit_count += entry.hit_count.load(std::memory_order_relaxed);
-        }
-        stats.iconv_avg_hit_count = static_cast<double>(total_hit_count) / stats.iconv_cache_size;
-    } else {
-        stats.iconv_avg_hit_count = 0.0;
+StringResult UniConv::ConvertEncodingParallel(
+    std::string_view input,
+    const char* fromEncoding,
+    const char* toEncoding,
+    size_t numThreads) noexcept {
+    std::string output;
+    ErrorCode ec = ConvertEncodingParallel(input, fromEncoding, toEncoding, output, numThreads);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return StringResult::Failure(ec);
     }
-    
-    return stats;
+    return StringResult::Success(std::move(output));
 }
 
-//----------------------------------------------------------------------------------------------------------------------
-// === Enhanced convenience methods with detailed error handling ===
-//----------------------------------------------------------------------------------------------------------------------
+// ===================================================================================================================
+// Parallel Policy Calibration
+// ===================================================================================================================
 
-CompactResult<std::string> UniConv::ToUtf8FromLocaleEx(const std::string& input) {
-    if (input.empty()) {
-        return CompactResult<std::string>::Success(std::string{});
+namespace {
+
+constexpr size_t CALIBRATION_DEFAULT_SAMPLE_BYTES = 256 * 1024;
+constexpr int    CALIBRATION_SAMPLES = 15;
+constexpr double CALIBRATION_SERIAL_DISPATCH_MULTIPLE = 8.0;   ///< 串行阈值：转换耗时 ≥ 8 次派发
+constexpr double CALIBRATION_CHUNK_DISPATCH_MULTIPLE = 64.0;   ///< 分块阈值：每块耗时 ≥ 64 次派发
+
+/**
+ * @brief 重复执行并返回单次耗时的中位数（纳秒）
+ */
+template<typename F>
+double MeasureMedianNs(F&& run) {
+    double samples[CALIBRATION_SAMPLES];
+    run();  // 预热：页错误、缓存、描述符初始化
+    for (double& sample : samples) {
+        const auto t0 = std::chrono::steady_clock::now();
+        run();
+        sample = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
     }
-    
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    return ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8);
+    std::nth_element(samples, samples + CALIBRATION_SAMPLES / 2, samples + CALIBRATION_SAMPLES);
+    return samples[CALIBRATION_SAMPLES / 2];
 }
 
-CompactResult<std::string> UniConv::ToLocaleFromUtf8Ex(const std::string& input) {
-    if (input.empty()) {
-        return CompactResult<std::string>::Success(std::string{});
-    }
-    
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    return ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str());
+/**
+ * @brief 将样本模式重复填充到指定字节数（只在完整模式边界截断，保证编码合法）
+ */
+std::string RepeatSample(std::string_view pattern, size_t bytes) {
+    std::string out;
+    out.reserve(bytes + pattern.size());
+    while (out.size() < bytes) out.append(pattern.data(), pattern.size());
+    return out;
 }
 
-CompactResult<std::u16string> UniConv::ToUtf16LEFromLocaleEx(const std::string& input) {
-    if (input.empty()) {
-        return CompactResult<std::u16string>::Success(std::u16string{});
-    }
-    
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16LE);
-    
-    if (!result.IsSuccess()) {
-        return CompactResult<std::u16string>::Failure(result.GetErrorCode());
-    }
-    
-    const std::string& str = result.GetValue();
-    if (str.size() % 2 != 0) {
-        return CompactResult<std::u16string>::Failure(ErrorCode::InvalidSequence);
-    }
-    
-    return CompactResult<std::u16string>::Success(
-        std::u16string(reinterpret_cast<const char16_t*>(str.data()), str.size() / 2));
+/**
+ * @brief 用独立 iconv 描述符测量每字节耗时；描述符不可用时返回 0
+ */
+double MeasureIconvNsPerByte(const char* from, const char* to, const std::string& input, std::string& buffer) {
+    iconv_t cd = iconv_open(to, from);
+    if (cd == reinterpret_cast<iconv_t>(-1)) {
+        return 0.0;
+    }
+    buffer.resize(input.size() * 4 + 16);
+    bool ok = true;
+    const double ns = MeasureMedianNs([&] {
+        const char* in = input.data();
+        size_t in_left = input.size();
+        char* out = buffer.data();
+        size_t out_left = buffer.size();
+        if (portable_iconv(cd, &in, &in_left, &out, &out_left) == static_cast<size_t>(-1)) ok = false;
+        portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+    });
+    iconv_close(cd);
+    return ok ? ns / static_cast<double>(input.size()) : 0.0;
 }
 
-CompactResult<std::u16string> UniConv::ToUtf16BEFromLocaleEx(const std::string& input) {
-    if (input.empty()) {
-        return CompactResult<std::u16string>::Success(std::u16string{});
-    }
-    
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16BE);
-    
-    if (!result.IsSuccess()) {
-        return CompactResult<std::u16string>::Failure(result.GetErrorCode());
-    }
-    
-    const std::string& str = result.GetValue();
-    if (str.size() % 2 != 0) {
-        return CompactResult<std::u16string>::Failure(ErrorCode::InvalidSequence);
-    }
-    
-    return CompactResult<std::u16string>::Success(
-        std::u16string(reinterpret_cast<const char16_t*>(str.data()), str.size() / 2));
+/**
+ * @brief 由派发开销与每字节耗时推导一组阈值
+ */
+ParallelThresholds DeriveParallelThresholds(double dispatch_ns, double ns_per_byte, size_t threads) noexcept {
+    auto bytes_for = [&](double multiple, size_t lo, size_t hi) {
+        const double bytes = multiple * dispatch_ns / ns_per_byte;
+        if (!(bytes > static_cast<double>(lo))) return lo;
+        if (bytes > static_cast<double>(hi)) return hi;
+        return static_cast<size_t>(bytes);
+    };
+    ParallelThresholds t;
+    t.serial_bytes = bytes_for(CALIBRATION_SERIAL_DISPATCH_MULTIPLE, 1024, 8 * 1024 * 1024);
+    // 满并行时每个线程分到的字节数仍值得一次派发
+    t.light_parallel_bytes = t.serial_bytes * (std::max)(size_t(2), threads);
+    t.light_parallel_threads = 2;
+    t.min_bytes_per_chunk = bytes_for(CALIBRATION_CHUNK_DISPATCH_MULTIPLE, 16 * 1024, 16 * 1024 * 1024);
+    return t;
 }
 
-CompactResult<std::string> UniConv::ToUtf8FromUtf16LEEx(const std::u16string& input) {
-    if (input.empty()) {
-        return CompactResult<std::string>::Success(std::string{});
+} // anonymous namespace
+
+ParallelCalibration UniConv::CalibrateParallelPolicy(size_t sampleBytes) noexcept {
+    ParallelCalibration report;
+    for (size_t c = 0; c < ParallelCalibration::CLASS_COUNT; ++c) {
+        report.thresholds[c] = LoadParallelThresholds(static_cast<ParallelCostClass>(c));
     }
-    
-    // Convert std::u16string to std::string for iconv processing
-    std::string inputStr;
-    inputStr.reserve(input.size() * 2);
-    
-    for (char16_t ch : input) {
-        inputStr.push_back(static_cast<char>(ch & 0xFF));
-        inputStr.push_back(static_cast<char>((ch >> 8) & 0xFF));
+    if (sampleBytes == 0) {
+        sampleBytes = CALIBRATION_DEFAULT_SAMPLE_BYTES;
     }
-    
-    return ConvertEncodingFast(inputStr, ENC_UTF16LE, ENC_UTF8);
-}
 
-CompactResult<std::string> UniConv::ToUtf8FromUtf16BEEx(const std::u16string& input) {
-    if (input.empty()) {
-        return CompactResult<std::string>::Success(std::string{});
-    }
+    try {
+        ThreadPool& pool = UniConvThreadPool::GetInstance();
+        const size_t threads = pool.GetThreadCount();
+
+        // 派发开销：一次覆盖全部参与者的空 ParallelFor（含唤醒与等待）
+        std::atomic<size_t> sink{0};
+        report.dispatch_ns = MeasureMedianNs([&] {
+            pool.ParallelFor((threads + 1) * ThreadPool::CHUNKS_PER_PARTICIPANT, [&sink](size_t start, size_t end) {
+                sink.fetch_add(end - start, std::memory_order_relaxed);
+            });
+        });
+
+        // 样本：混合 ASCII/CJK 的 UTF-8、Latin-1 可表示文本、中文为主文本
+        const std::string utf8_mixed = RepeatSample("UniConv \xe7\xbc\x96\xe7\xa0\x81 test 0123 \xf0\x9f\x98\x80 ", sampleBytes);
+        const std::string utf8_latin = RepeatSample("Gr\xc3\xbc\xc3\x9f""e caf\xc3\xa9 \xc3\xa0 la carte. ", sampleBytes);
+        const std::string utf8_cjk   = RepeatSample("\xe4\xbd\xa0\xe5\xa5\xbd\xef\xbc\x8c\xe4\xb8\x96\xe7\x95\x8c\xe3\x80\x82 ab ", sampleBytes);
+        std::string buffer(sampleBytes * 4 + 16, '\0');
+
+        auto& ns = report.ns_per_byte;
+        ns[static_cast<size_t>(ParallelCostClass::Copy)] = MeasureMedianNs([&] {
+            std::memcpy(buffer.data(), utf8_mixed.data(), utf8_mixed.size());
+            sink.fetch_add(static_cast<unsigned char>(buffer[utf8_mixed.size() / 2]), std::memory_order_relaxed);
+        }) / static_cast<double>(utf8_mixed.size());
+
+        bool native_ok = true;
+        ns[static_cast<size_t>(ParallelCostClass::NativeUtf)] = MeasureMedianNs([&] {
+            if (ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16LE, utf8_mixed.data(), utf8_mixed.size(), buffer) != ErrorCode::Success) {
+                native_ok = false;
+            }
+        }) / static_cast<double>(utf8_mixed.size());
+        if (!native_ok) ns[static_cast<size_t>(ParallelCostClass::NativeUtf)] = 0.0;
+
+#ifdef UNICONV_HAS_SIMDUTF
+        bool simd_ok = true;
+        ns[static_cast<size_t>(ParallelCostClass::Simdutf)] = MeasureMedianNs([&] {
+            if (ConvertUtfSimdutf(EncodingId::UTF8, EncodingId::UTF16LE, utf8_mixed.data(), utf8_mixed.size(), buffer) != ErrorCode::Success) {
+                simd_ok = false;
+            }
+        }) / static_cast<double>(utf8_mixed.size());
+        if (!simd_ok) ns[static_cast<size_t>(ParallelCostClass::Simdutf)] = 0.0;
+#endif
 
-    std::string inputStr(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+        ns[static_cast<size_t>(ParallelCostClass::IconvUnicode)] =
+            MeasureIconvNsPerByte("UTF-8", "UTF-16", utf8_mixed, buffer);
+        ns[static_cast<size_t>(ParallelCostClass::IconvSingleByte)] =
+            MeasureIconvNsPerByte("UTF-8", "ISO-8859-1", utf8_latin, buffer);
+        ns[static_cast<size_t>(ParallelCostClass::IconvMultiByte)] =
+            MeasureIconvNsPerByte("UTF-8", "GBK", utf8_cjk, buffer);
+
+        // 只更新测量成功的成本类，其余保持当前阈值
+        for (size_t c = 0; c < ParallelCalibration::CLASS_COUNT; ++c) {
+            if (ns[c] > 0.0 && report.dispatch_ns > 0.0) {
+                const ParallelThresholds t = DeriveParallelThresholds(report.dispatch_ns, ns[c], threads);
+                StoreParallelThresholds(static_cast<ParallelCostClass>(c), t);
+                report.thresholds[c] = LoadParallelThresholds(static_cast<ParallelCostClass>(c));
+            }
+        }
+    } catch (...) {
+        // 内存不足等：保持已有阈值
+    }
+    return report;
+}
 
-    return ConvertEncodingFast(inputStr, ENC_UTF16BE, ENC_UTF8);
+ParallelThresholds UniConv::GetParallelThresholds(ParallelCostClass costClass) noexcept {
+    return LoadParallelThresholds(costClass);
 }
 
-CompactResult<std::string> UniConv::ToUtf8FromUtf32LEEx(const std::u32string& input) {
-    if (input.empty()) {
-        return CompactResult<std::string>::Success(std::string{});
+void UniConv::SetParallelThresholds(ParallelCostClass costClass, const ParallelThresholds& thresholds) noexcept {
+    if (static_cast<size_t>(costClass) >= ParallelCalibration::CLASS_COUNT) {
+        return;
     }
+    StoreParallelThresholds(costClass, thresholds);
+}
 
-    std::string inputStr(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char32_t));
-    return ConvertEncodingFast(inputStr, ENC_UTF32LE, ENC_UTF8);
+void UniConv::ResetParallelPolicy() noexcept {
+    for (size_t c = 0; c < ParallelCalibration::CLASS_COUNT; ++c) {
+        StoreParallelThresholds(static_cast<ParallelCostClass>(c), ParallelThresholds{});
+    }
 }
 
-CompactResult<std::u32string> UniConv::ToUtf32LEFromUtf8Ex(const std::string& input) {
-    if (input.empty()) {
-        return CompactResult<std::u32string>::Success(std::u32string{});
+ParallelCostClass UniConv::ClassifyParallelCost(const char* fromEncoding, const char* toEncoding) noexcept {
+    const PairPlan plan = MakePairPlan(fromEncoding, toEncoding);
+    switch (plan.route) {
+        case PairRoute::Copy:    return ParallelCostClass::Copy;
+        case PairRoute::Simdutf: return ParallelCostClass::Simdutf;
+        case PairRoute::Native:  return ParallelCostClass::NativeUtf;
+        case PairRoute::Iconv:
+        default:
+            return IconvCostClass(static_cast<EncodingId>(plan.fromId), static_cast<EncodingId>(plan.toId));
     }
+}
 
-    auto result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF32LE);
-    if (result.IsSuccess()) {
-        auto& value = result.GetValue();
-        if (value.size() % 4 == 0) {
-            return CompactResult<std::u32string>::Success(
-                std::u32string(reinterpret_cast<const char32_t*>(value.data()), value.size() / 4));
+// ===================================================================================================================
+// Asynchronous Conversion
+// ===================================================================================================================
+
+namespace {
+
+/**
+ * @brief 将任务交给执行器；执行器为空时提交到共享线程池
+ * @return 提交失败（线程池已停止、执行器抛出、内存不足）时返回错误码，任务不会运行
+ */
+ErrorCode DispatchAsyncTask(const UniConv::AsyncExecutor& executor, std::function<void()> task) noexcept {
+    try {
+        if (executor) {
+            executor(std::move(task));
+        } else {
+            // future 直接丢弃：完成通过回调通知，任务异常已在任务内部处理
+            UniConvThreadPool::GetInstance().Submit(std::move(task));
         }
-        return CompactResult<std::u32string>::Failure(ErrorCode::ConversionFailed);
+        return ErrorCode::Success;
+    } catch (const std::bad_alloc&) {
+        return ErrorCode::OutOfMemory;
+    } catch (...) {
+        return ErrorCode::InternalError;
     }
-    return CompactResult<std::u32string>::Failure(result.GetErrorCode());
 }
 
-CompactResult<std::u32string> UniConv::ToUtf32LEFromUtf16LEEx(const std::u16string& input) {
-    if (input.empty()) {
-        return CompactResult<std::u32string>::Success(std::u32string{});
-    }
+} // anonymous namespace
 
-    std::string inputStr(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(inputStr, ENC_UTF16LE, ENC_UTF32LE);
-    if (result.IsSuccess()) {
-        auto& value = result.GetValue();
-        if (value.size() % 4 == 0) {
-            return CompactResult<std::u32string>::Success(
-                std::u32string(reinterpret_cast<const char32_t*>(value.data()), value.size() / 4));
-        }
-        return CompactResult<std::u32string>::Failure(ErrorCode::ConversionFailed);
+ErrorCode UniConv::ConvertEncodingAsync(std::string input, const char* fromEncoding, const char* toEncoding,
+    AsyncCallback onComplete, const AsyncExecutor& executor) noexcept {
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding || !onComplete)) {
+        return ErrorCode::InvalidParameter;
+    }
+    try {
+        auto task = [this, input = std::move(input), from = std::string(fromEncoding),
+                     to = std::string(toEncoding), callback = std::move(onComplete)]() {
+            StringResult result = ConvertEncodingParallel(input, from.c_str(), to.c_str());
+            try {
+                callback(std::move(result));
+            } catch (...) {
+                // 回调异常不传播到执行线程
+            }
+        };
+        return DispatchAsyncTask(executor, std::move(task));
+    } catch (...) {
+        return ErrorCode::OutOfMemory;
     }
-    return CompactResult<std::u32string>::Failure(result.GetErrorCode());
 }
 
-CompactResult<std::u32string> UniConv::ToUtf32LEFromUtf16BEEx(const std::u16string& input) {
-    if (input.empty()) {
-        return CompactResult<std::u32string>::Success(std::u32string{});
+ErrorCode UniConv::ConvertEncodingBatchAsync(std::vector<std::string> inputs, const char* fromEncoding,
+    const char* toEncoding, AsyncBatchCallback onComplete, size_t numThreads,
+    const AsyncExecutor& executor) noexcept {
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding || !onComplete)) {
+        return ErrorCode::InvalidParameter;
     }
-
-    std::string inputStr(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(inputStr, ENC_UTF16BE, ENC_UTF32LE);
-    if (result.IsSuccess()) {
-        auto& value = result.GetValue();
-        if (value.size() % 4 == 0) {
-            return CompactResult<std::u32string>::Success(
-                std::u32string(reinterpret_cast<const char32_t*>(value.data()), value.size() / 4));
-        }
-        return CompactResult<std::u32string>::Failure(ErrorCode::ConversionFailed);
+    try {
+        auto task = [this, inputs = std::move(inputs), from = std::string(fromEncoding),
+                     to = std::string(toEncoding), callback = std::move(onComplete), numThreads]() {
+            std::vector<StringResult> results = ConvertEncodingBatchParallel(inputs, from.c_str(), to.c_str(), numThreads);
+            try {
+                callback(std::move(results));
+            } catch (...) {
+                // 回调异常不传播到执行线程
+            }
+        };
+        return DispatchAsyncTask(executor, std::move(task));
+    } catch (...) {
+        return ErrorCode::OutOfMemory;
     }
-    return CompactResult<std::u32string>::Failure(result.GetErrorCode());
 }
 
-CompactResult<std::u16string> UniConv::ToUtf16LEFromUtf16BEEx(const std::u16string& input) {
-    if (input.empty()) {
-        return CompactResult<std::u16string>::Success(std::u16string{});
-    }
+// ===================================================================================================================
+// Caller-Supplied Buffer Conversion (No Allocation)
+// ===================================================================================================================
 
-    std::string inputStr(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(inputStr, ENC_UTF16BE, ENC_UTF16LE);
-    if (result.IsSuccess()) {
-        auto& value = result.GetValue();
-        if (value.size() % 2 == 0) {
-            return CompactResult<std::u16string>::Success(
-                std::u16string(reinterpret_cast<const char16_t*>(value.data()), value.size() / 2));
-        }
-        return CompactResult<std::u16string>::Failure(ErrorCode::ConversionFailed);
+size_t UniConv::MaxOutputSize(size_t inputSize, const char* fromEncoding, const char* toEncoding) noexcept {
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        return MaxOutputSizeById(inputSize, static_cast<uint8_t>(EncodingId::Unknown),
+                                 static_cast<uint8_t>(EncodingId::Unknown));
     }
-    return CompactResult<std::u16string>::Failure(result.GetErrorCode());
+    return MaxOutputSizeById(inputSize,
+                             static_cast<uint8_t>(GetEncodingId(fromEncoding)),
+                             static_cast<uint8_t>(GetEncodingId(toEncoding)));
 }
 
-CompactResult<std::u16string> UniConv::ToUtf16BEFromUtf16LEEx(const std::u16string& input) {
-    if (input.empty()) {
-        return CompactResult<std::u16string>::Success(std::u16string{});
-    }
+size_t UniConv::MaxOutputSizeById(size_t input_size, uint8_t from_raw, uint8_t to_raw) noexcept {
+    const auto from_id = static_cast<EncodingId>(from_raw);
+    const auto to_id   = static_cast<EncodingId>(to_raw);
 
-    std::string inputStr(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(inputStr, ENC_UTF16LE, ENC_UTF16BE);
-    if (result.IsSuccess()) {
-        auto& value = result.GetValue();
-        if (value.size() % 2 == 0) {
-            return CompactResult<std::u16string>::Success(
-                std::u16string(reinterpret_cast<const char16_t*>(value.data()), value.size() / 2));
-        }
-        return CompactResult<std::u16string>::Failure(ErrorCode::ConversionFailed);
+    if (UNICONV_UNLIKELY(input_size > ((std::numeric_limits<size_t>::max)() - 16) / 8)) {
+        return (std::numeric_limits<size_t>::max)();
+    }
+    // 可重新同步的编码对：与分块并行转换共用逐字节最坏膨胀系数
+    if (IsChunkSplittable(from_id) && IsChunkSplittable(to_id)) {
+        return MaxChunkOutputBytes(input_size, from_id, to_id);
     }
-    return CompactResult<std::u16string>::Failure(result.GetErrorCode());
+    // BOM 形式的 UTF-16/32、状态型与未识别编码：每输入字节至多 8 字节（含 BOM 与换码序列）
+    return input_size * 8 + 16;
 }
 
-CompactResult<std::wstring> UniConv::ToWideStringFromLocaleEx(const std::string& input) {
-    if (input.empty()) {
-        return CompactResult<std::wstring>::Success(std::wstring{});
-    }
+ErrorCode UniConv::ConvertInto(std::string_view input, const char* fromEncoding, const char* toEncoding,
+                               char* output, size_t outputCapacity, size_t& consumed, size_t& written) noexcept {
+    consumed = 0;
+    written  = 0;
 
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    auto result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_WCHAR);
-    if (result.IsSuccess()) {
-        auto& value = result.GetValue();
-        if (value.size() % sizeof(wchar_t) == 0) {
-            return CompactResult<std::wstring>::Success(
-                std::wstring(reinterpret_cast<const wchar_t*>(value.data()), value.size() / sizeof(wchar_t)));
-        }
-        return CompactResult<std::wstring>::Failure(ErrorCode::ConversionFailed);
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding || (!output && outputCapacity > 0))) {
+        return ErrorCode::InvalidParameter;
     }
-    return CompactResult<std::wstring>::Failure(result.GetErrorCode());
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        return ErrorCode::InvalidSourceEncoding;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        return ErrorCode::InvalidTargetEncoding;
+    }
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return ErrorCode::Success;
+    }
+
+    return ConvertPlannedInto(MakePairPlan(fromEncoding, toEncoding), fromEncoding, toEncoding,
+                              input, output, outputCapacity, consumed, written);
 }
 
-CompactResult<std::string> UniConv::ToLocaleFromWideStringEx(const std::wstring& input) {
-    if (input.empty()) {
-        return CompactResult<std::string>::Success(std::string{});
+ErrorCode UniConv::ConvertPlannedInto(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+                                      std::string_view input, char* output, size_t outputCapacity,
+                                      size_t& consumed, size_t& written) noexcept {
+    const auto run = [&](ConversionPath& path) noexcept {
+#if UNICONV_ENABLE_METRICS
+        const MetricsTimer timer;
+        const ErrorCode ec = ConvertPlannedIntoRoute(plan, fromEncoding, toEncoding, input, output, outputCapacity,
+                                                     consumed, written, path);
+        RecordConversionMetrics(fromEncoding, toEncoding, path, consumed, written, ec, timer);
+        return ec;
+#else
+        return ConvertPlannedIntoRoute(plan, fromEncoding, toEncoding, input, output, outputCapacity,
+                                       consumed, written, path);
+#endif
+    };
+    if (UNICONV_UNLIKELY(ActiveTraceHooks() != nullptr)) {
+        return TracedConversion(fromEncoding, toEncoding, input.size(), run,
+                                [&written](ErrorCode) { return written; });
     }
-
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
-    return ConvertEncodingFast(input_bytes, ENC_WCHAR, currentEncoding.c_str());
+    ConversionPath path = ConversionPath::Copy;
+    return run(path);
 }
 
-CompactResult<std::string> UniConv::ToUtf8FromUcs4Ex(const std::wstring& input) {
-    if (input.empty()) {
-        return CompactResult<std::string>::Success(std::string{});
+ErrorCode UniConv::ConvertPlannedIntoRoute(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+                                           std::string_view input, char* output, size_t outputCapacity,
+                                           size_t& consumed, size_t& written, ConversionPath& path) noexcept {
+    consumed = 0;
+    written  = 0;
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return ErrorCode::Success;
     }
 
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
-    return ConvertEncodingFast(input_bytes, ENC_WCHAR, ENC_UTF8);
-}
+    const auto from_id = static_cast<EncodingId>(plan.fromId);
+    const auto to_id   = static_cast<EncodingId>(plan.toId);
 
-CompactResult<std::wstring> UniConv::ToUcs4FromUtf8Ex(const std::string& input) {
-    if (input.empty()) {
-        return CompactResult<std::wstring>::Success(std::wstring{});
+    //  同编码直接复制（放不下时交给 iconv 按字符边界截断）
+    if (plan.route == PairRoute::Copy && input.size() <= outputCapacity) {
+        path = ConversionPath::Copy;
+        std::memcpy(output, input.data(), input.size());
+        consumed = written = input.size();
+        return ErrorCode::Success;
     }
 
-    auto result = ConvertEncodingFast(input, ENC_UTF8, ENC_WCHAR);
-    if (result.IsSuccess()) {
-        auto& value = result.GetValue();
-        if (value.size() % sizeof(wchar_t) == 0) {
-            return CompactResult<std::wstring>::Success(
-                std::wstring(reinterpret_cast<const wchar_t*>(value.data()), value.size() / sizeof(wchar_t)));
+    //  ASCII 兼容编码间互转：前导 ASCII 段逐字节复制，任意位置都是字符边界
+    const size_t ascii_prefix = plan.asciiPassthrough ? AsciiPrefixLength(input) : 0;
+    if (ascii_prefix > 0 && (ascii_prefix == input.size() || ascii_prefix >= outputCapacity)) {
+        path = ConversionPath::AsciiShortcut;
+        const size_t n = (std::min)(ascii_prefix, outputCapacity);
+        if (n > 0) {
+            std::memcpy(output, input.data(), n);
         }
-        return CompactResult<std::wstring>::Failure(ErrorCode::ConversionFailed);
+        consumed = written = n;
+        return n == input.size() ? ErrorCode::Success : ErrorCode::BufferTooSmall;
     }
-    return CompactResult<std::wstring>::Failure(result.GetErrorCode());
-}
 
-CompactResult<std::wstring> UniConv::ToWStringFromU16StringEx(const std::u16string& input) {
-    if (input.empty()) {
-        return CompactResult<std::wstring>::Success(std::wstring{});
+    //  内置 SIMD 内核直接写入调用方缓冲区（容量需覆盖上界）
+    if ((plan.route == PairRoute::Native || plan.route == PairRoute::Simdutf) &&
+        outputCapacity >= NativeOutputBound(from_id, to_id, input.size())) {
+        path = plan.route == PairRoute::Native ? ConversionPath::Native : ConversionPath::Simdutf;
+        return ConvertUtfNativeInto(from_id, to_id, input.data(), input.size(), output, consumed, written);
     }
 
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    auto result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_WCHAR);
-    if (result.IsSuccess()) {
-        auto& value = result.GetValue();
-        if (value.size() % sizeof(wchar_t) == 0) {
-            return CompactResult<std::wstring>::Success(
-                std::wstring(reinterpret_cast<const wchar_t*>(value.data()), value.size() / sizeof(wchar_t)));
+    IconvLease descriptor;
+    if (GetApiLayerMode() == ApiLayerMode::Stateless) {
+        path = ConversionPath::StatelessIconv;
+        iconv_t cd = iconv_open(toEncoding, fromEncoding);
+        if (cd != reinterpret_cast<iconv_t>(-1)) {
+            descriptor = IconvLease::Adopt(static_cast<void*>(cd));
         }
-        return CompactResult<std::wstring>::Failure(ErrorCode::ConversionFailed);
+    } else {
+        path = ConversionPath::Iconv;
+        // 仅 Iconv 路线预先计算了缓存键；其余路线容量不足时才会走到这里
+        descriptor = plan.route == PairRoute::Iconv
+            ? GetIconvDescriptorByKey(plan.key, fromEncoding, toEncoding)
+            : GetIconvDescriptor(fromEncoding, toEncoding);
     }
-    return CompactResult<std::wstring>::Failure(result.GetErrorCode());
-}
+    if (UNICONV_UNLIKELY(!descriptor)) {
+        return ErrorCode::ConversionFailed;
+    }
+    iconv_t cd = static_cast<iconv_t>(descriptor.get());
 
-//----------------------------------------------------------------------------------------------------------------------
-// === Zero-Copy Output Parameter API Implementation ===
-//----------------------------------------------------------------------------------------------------------------------
+    if (ascii_prefix > 0) {
+        std::memcpy(output, input.data(), ascii_prefix);
+    }
+    const char* inbuf_ptr = input.data() + ascii_prefix;
+    std::size_t inbuf_left = input.size() - ascii_prefix;
+    char* outbuf_ptr = output + ascii_prefix;
+    std::size_t outbuf_left = outputCapacity - ascii_prefix;
 
-void UniConv::SetApiLayerMode(ApiLayerMode mode) noexcept {
-    m_apiLayerMode.store(mode, std::memory_order_relaxed);
-}
+    const std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+    const int current_errno = errno;
+    consumed = input.size() - inbuf_left;
+    written  = outputCapacity - outbuf_left;
+    // 描述符会被复用：无论成功与否都复位移位状态
+    portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
 
-UniConv::ApiLayerMode UniConv::GetApiLayerMode() const noexcept {
-    return m_apiLayerMode.load(std::memory_order_relaxed);
+    if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+        return IconvErrnoToErrorCode(current_errno);
+    }
+    return ErrorCode::Success;
 }
 
-bool UniConv::ConvertEncodingStateless(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
-    return ConvertEncodingStatelessFast(std::string_view{input}, fromEncoding, toEncoding, output) == ErrorCode::Success;
-}
+// ===================================================================================================================
+// Validation & Output Length (No Output Written)
+// ===================================================================================================================
 
-ErrorCode UniConv::ConvertEncodingStatelessFast(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
-    return ConvertEncodingStatelessFast(std::string_view{input}, fromEncoding, toEncoding, output);
-}
+ErrorCode UniConv::Validate(std::string_view input, const char* encoding, size_t& errorOffset) noexcept {
+    errorOffset = 0;
+    if (UNICONV_UNLIKELY(!encoding)) {
+        return ErrorCode::InvalidParameter;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(encoding))) {
+        return ErrorCode::InvalidSourceEncoding;
+    }
 
-bool UniConv::ConvertEncodingStateless(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
-    return ConvertEncodingStatelessFast(input, fromEncoding, toEncoding, output) == ErrorCode::Success;
+    size_t units = 0;
+    const EncodingId id = GetEncodingId(encoding);
+    if (HasNativeCodec(id)) {
+#ifdef UNICONV_HAS_SIMDUTF
+        if (id == EncodingId::UTF8 && simdutf::validate_utf8(input.data(), input.size())) {
+            errorOffset = input.size();
+            return ErrorCode::Success;
+        }
+#endif // UNICONV_HAS_SIMDUTF
+        // 解码到 UTF-32 的计数接受任意码点，等价于只校验源编码
+        return CountNativeUnits(id, EncodingId::UTF32LE, reinterpret_cast<const uint8_t*>(input.data()),
+                                input.size(), units, errorOffset);
+    }
+    // 其余编码由 iconv 解码为 UTF-8，输出丢弃
+    const ErrorCode ec = CountPlannedUnits(MakePairPlan(encoding, "UTF-8"), encoding, "UTF-8",
+                                           input, units, errorOffset);
+    return ec == ErrorCode::InvalidTargetEncoding ? ErrorCode::InvalidSourceEncoding : ec;
 }
 
-ErrorCode UniConv::ConvertEncodingStatelessFast(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
-    output.clear();
+ErrorCode UniConv::Validate(std::string_view input, const char* encoding) noexcept {
+    size_t errorOffset = 0;
+    return Validate(input, encoding, errorOffset);
+}
 
+ErrorCode UniConv::CountOutputUnits(std::string_view input, const char* fromEncoding, const char* toEncoding,
+                                    size_t& units) noexcept {
+    units = 0;
     if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
         return ErrorCode::InvalidParameter;
     }
@@ -2380,140 +8503,191 @@ ErrorCode UniConv::ConvertEncodingStatelessFast(std::string_view input, const ch
     if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
         return ErrorCode::InvalidTargetEncoding;
     }
+    size_t consumed = 0;
+    return CountPlannedUnits(MakePairPlan(fromEncoding, toEncoding), fromEncoding, toEncoding,
+                             input, units, consumed);
+}
+
+ErrorCode UniConv::CountPlannedUnits(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+                                     std::string_view input, size_t& units, size_t& consumed) noexcept {
+    units    = 0;
+    consumed = 0;
     if (UNICONV_UNLIKELY(input.empty())) {
         return ErrorCode::Success;
     }
 
-    const EncodingId from_id = GetEncodingId(fromEncoding);
-    const EncodingId to_id   = GetEncodingId(toEncoding);
+    const auto from_id = static_cast<EncodingId>(plan.fromId);
+    const auto to_id   = static_cast<EncodingId>(plan.toId);
+    const size_t unit_bytes = OutputUnitBytes(to_id);
 
-    if (UNICONV_LIKELY(AreSameEncoding(from_id, to_id, fromEncoding, toEncoding))) {
-        output.assign(input.data(), input.size());
+    //  同编码：转换路径原样复制
+    if (plan.route == PairRoute::Copy) {
+        units = input.size() / unit_bytes;
+        consumed = input.size();
         return ErrorCode::Success;
     }
 
-    if (IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id)) {
-        bool all_ascii = true;
-        const auto* data = reinterpret_cast<const unsigned char*>(input.data());
-        size_t i = 0;
-        for (; i + 8 <= input.size(); i += 8) {
-            uint64_t block;
-            std::memcpy(&block, data + i, 8);
-            if (block & 0x8080808080808080ULL) { all_ascii = false; break; }
-        }
-        if (all_ascii) {
-            for (; i < input.size(); ++i) {
-                if (data[i] >= 0x80) { all_ascii = false; break; }
-            }
-        }
-        if (all_ascii) {
-            output.assign(input.data(), input.size());
-            return ErrorCode::Success;
-        }
+    //  内置内核转换的编码对按同一码表逐码点计数；双字节码页之间等其余编码对由 iconv 转换，
+    //  计数也走 iconv（码表未收录与 glibc 映射不同的字符，不能代替 iconv）
+    if (plan.route == PairRoute::Native || plan.route == PairRoute::Simdutf) {
+        return CountNativeUnits(from_id, to_id, reinterpret_cast<const uint8_t*>(input.data()), input.size(),
+                                units, consumed);
     }
 
-#ifdef UNICONV_HAS_SIMDUTF
-    {
-        std::string input_str(input.data(), input.size());
-        if (from_id == EncodingId::UTF8 && to_id == EncodingId::UTF16LE) {
-            auto result = ConvertUtf8ToUtf16LE_SIMD(input_str);
-            if (result.IsSuccess()) { output = std::move(result).GetValue(); return ErrorCode::Success; }
-            return result.GetErrorCode();
-        }
-        if (from_id == EncodingId::UTF16LE && to_id == EncodingId::UTF8) {
-            auto result = ConvertUtf16LEToUtf8_SIMD(input_str);
-            if (result.IsSuccess()) { output = std::move(result).GetValue(); return ErrorCode::Success; }
-            return result.GetErrorCode();
-        }
-        if (from_id == EncodingId::UTF8 && to_id == EncodingId::UTF16BE) {
-            auto result = ConvertUtf8ToUtf16BE_SIMD(input_str);
-            if (result.IsSuccess()) { output = std::move(result).GetValue(); return ErrorCode::Success; }
-            return result.GetErrorCode();
-        }
-        if (from_id == EncodingId::UTF16BE && to_id == EncodingId::UTF8) {
-            auto result = ConvertUtf16BEToUtf8_SIMD(input_str);
-            if (result.IsSuccess()) { output = std::move(result).GetValue(); return ErrorCode::Success; }
-            return result.GetErrorCode();
-        }
+    //  iconv：前导 ASCII 段直接计数，其余分块转换到栈上暂存区，只累计字节数
+    const size_t ascii_prefix = plan.asciiPassthrough ? AsciiPrefixLength(input) : 0;
+    if (ascii_prefix == input.size()) {
+        units = consumed = ascii_prefix;
+        return ErrorCode::Success;
     }
-#endif
 
-    iconv_t cd = iconv_open(toEncoding, fromEncoding);
-    if (UNICONV_UNLIKELY(cd == reinterpret_cast<iconv_t>(-1))) {
+    IconvLease descriptor;
+    if (GetApiLayerMode() == ApiLayerMode::Stateless) {
+        iconv_t cd = iconv_open(toEncoding, fromEncoding);
+        if (cd != reinterpret_cast<iconv_t>(-1)) {
+            descriptor = IconvLease::Adopt(static_cast<void*>(cd));
+        }
+    } else {
+        descriptor = plan.route == PairRoute::Iconv
+            ? GetIconvDescriptorByKey(plan.key, fromEncoding, toEncoding)
+            : GetIconvDescriptor(fromEncoding, toEncoding);
+    }
+    if (UNICONV_UNLIKELY(!descriptor)) {
         return ErrorCode::ConversionFailed;
     }
+    iconv_t cd = static_cast<iconv_t>(descriptor.get());
+
+    char scratch[4096];
+    const char* inbuf_ptr = input.data() + ascii_prefix;
+    std::size_t inbuf_left = input.size() - ascii_prefix;
+    size_t bytes = ascii_prefix;
+    ErrorCode ec = ErrorCode::Success;
+    for (;;) {
+        char* outbuf_ptr = scratch;
+        std::size_t outbuf_left = sizeof(scratch);
+        const std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+        const int current_errno = errno;
+        bytes += sizeof(scratch) - outbuf_left;
+        if (static_cast<std::size_t>(-1) != ret) {
+            break;
+        }
+        if (current_errno != E2BIG) {
+            ec = IconvErrnoToErrorCode(current_errno);
+            break;
+        }
+    }
+    consumed = input.size() - inbuf_left;
+    units = bytes / unit_bytes;
+    // 描述符会被复用：无论成功与否都复位移位状态
+    portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+    return ec;
+}
 
-    const char* inbuf_ptr = input.data();
-    std::size_t inbuf_left = input.size();
+// ===================================================================================================================
+// Prepared Encoding Pair (Resolve Once, Convert Many)
+// ===================================================================================================================
 
-    size_t estimated_size = EstimateOutputSizeById(input.size(),
-                                                    static_cast<uint8_t>(from_id),
-                                                    static_cast<uint8_t>(to_id));
+UniConv::PreparedConversion UniConv::Prepare(const char* fromEncoding, const char* toEncoding) noexcept {
+    PreparedConversion prepared;
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        prepared.m_status = ErrorCode::InvalidParameter;
+        return prepared;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        prepared.m_status = ErrorCode::InvalidSourceEncoding;
+        return prepared;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        prepared.m_status = ErrorCode::InvalidTargetEncoding;
+        return prepared;
+    }
     try {
-        output.resize(estimated_size);
+        prepared.m_from = fromEncoding;
+        prepared.m_to   = toEncoding;
     } catch (...) {
-        iconv_close(cd);
-        return ErrorCode::OutOfMemory;
+        prepared.m_status = ErrorCode::OutOfMemory;
+        return prepared;
     }
+    prepared.m_owner  = this;
+    prepared.m_plan   = MakePairPlan(fromEncoding, toEncoding);
+    prepared.m_status = ErrorCode::Success;
+    return prepared;
+}
 
-    size_t written_total = 0;
-    constexpr int max_iterations = 100;
-    int iteration_count = 0;
+ErrorCode UniConv::PreparedConversion::Convert(std::string_view input, std::string& output) const noexcept {
+    if (UNICONV_UNLIKELY(m_status != ErrorCode::Success)) {
+        output.clear();
+        return m_status;
+    }
+    if (UNICONV_UNLIKELY(m_owner->GetApiLayerMode() == ApiLayerMode::Stateless)) {
+        return m_owner->ConvertEncodingStatelessFast(input, m_from.c_str(), m_to.c_str(), output);
+    }
+    return m_owner->ConvertPlanned(m_plan, m_from.c_str(), m_to.c_str(), input, output);
+}
 
-    while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
-        char* outbuf_ptr = output.data() + written_total;
-        std::size_t outbuf_left = output.size() - written_total;
+ErrorCode UniConv::PreparedConversion::Convert(std::string_view input, std::string& output, ErrorPolicy policy,
+                                               ConversionReport* report) const noexcept {
+    if (UNICONV_UNLIKELY(m_status != ErrorCode::Success)) {
+        output.clear();
+        if (report) {
+            *report = ConversionReport{};
+        }
+        return m_status;
+    }
+    if (policy == ErrorPolicy::Strict) {
+        return m_owner->ConvertEncodingFast(input, m_from.c_str(), m_to.c_str(), output, policy, report);
+    }
+    if (report) {
+        *report = ConversionReport{};
+    }
+    return m_owner->ConvertPlannedTolerant(m_plan, m_from.c_str(), m_to.c_str(), input, output, policy, report);
+}
 
-        std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
-        written_total = output.size() - outbuf_left;
+StringResult UniConv::PreparedConversion::Convert(std::string_view input) const noexcept {
+    std::string output;
+    const ErrorCode ec = Convert(input, output);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return StringResult::Failure(ec);
+    }
+    return StringResult::Success(std::move(output));
+}
 
-        if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
-            int current_errno = errno;
-            switch (current_errno) {
-                case E2BIG: {
-                    if (UNICONV_UNLIKELY(output.size() >= 1048576 * 10)) {
-                        iconv_close(cd);
-                        return ErrorCode::BufferTooSmall;
-                    }
-                    try {
-                        output.resize(output.size() * 2);
-                    } catch (...) {
-                        iconv_close(cd);
-                        return ErrorCode::OutOfMemory;
-                    }
-                    continue;
-                }
-                case EILSEQ:
-                    iconv_close(cd);
-                    return ErrorCode::InvalidSequence;
-                case EINVAL:
-                    iconv_close(cd);
-                    return ErrorCode::IncompleteSequence;
-                default:
-                    iconv_close(cd);
-                    return ErrorCode::ConversionFailed;
-            }
-        } else {
-            break;
-        }
+ErrorCode UniConv::PreparedConversion::ConvertInto(std::string_view input, char* output, size_t outputCapacity,
+                                                   size_t& consumed, size_t& written) const noexcept {
+    consumed = 0;
+    written  = 0;
+    if (UNICONV_UNLIKELY(m_status != ErrorCode::Success)) {
+        return m_status;
+    }
+    if (UNICONV_UNLIKELY(!output && outputCapacity > 0)) {
+        return ErrorCode::InvalidParameter;
     }
+    return m_owner->ConvertPlannedInto(m_plan, m_from.c_str(), m_to.c_str(),
+                                       input, output, outputCapacity, consumed, written);
+}
 
-    if (UNICONV_UNLIKELY(iteration_count >= max_iterations)) {
-        iconv_close(cd);
-        return ErrorCode::InternalError;
-    }
+size_t UniConv::PreparedConversion::MaxOutputSize(size_t inputSize) const noexcept {
+    return MaxOutputSizeById(inputSize, m_plan.fromId, m_plan.toId);
+}
 
-    output.resize(written_total);
-    iconv_close(cd);
-    return ErrorCode::Success;
+ErrorCode UniConv::PreparedConversion::CountOutputUnits(std::string_view input, size_t& units) const noexcept {
+    units = 0;
+    if (UNICONV_UNLIKELY(m_status != ErrorCode::Success)) {
+        return m_status;
+    }
+    size_t consumed = 0;
+    return m_owner->CountPlannedUnits(m_plan, m_from.c_str(), m_to.c_str(), input, units, consumed);
 }
 
-bool UniConv::ConvertEncoding(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
-    ErrorCode result = ConvertEncodingFast(input, fromEncoding, toEncoding, output);
-    return result == ErrorCode::Success;
+// ===================================================================================================================
+// string_view Input Overloads 
+// ===================================================================================================================
+
+bool UniConv::ConvertEncoding(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
+    return ConvertEncodingFast(input, fromEncoding, toEncoding, output) == ErrorCode::Success;
 }
 
-ErrorCode UniConv::ConvertEncodingFast(const std::string& input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
+ErrorCode UniConv::ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
     if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
         return ConvertEncodingStatelessFast(input, fromEncoding, toEncoding, output);
     }
@@ -2523,1034 +8697,1158 @@ ErrorCode UniConv::ConvertEncodingFast(const std::string& input, const char* fro
     if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
         return ErrorCode::InvalidParameter;
     }
-
     if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
         return ErrorCode::InvalidSourceEncoding;
     }
     if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
         return ErrorCode::InvalidTargetEncoding;
     }
-
     if (UNICONV_UNLIKELY(input.empty())) {
         return ErrorCode::Success;
     }
 
-    // 一次性解析编码 ID
-    const EncodingId from_id = GetEncodingId(fromEncoding);
-    const EncodingId to_id   = GetEncodingId(toEncoding);
-
-    if (UNICONV_LIKELY(AreSameEncoding(from_id, to_id, fromEncoding, toEncoding))) {
-        output = input;
-        return ErrorCode::Success;
-    }
-
-    if (IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id)) {
-        if (UNICONV_LIKELY(IsAllAscii(input))) {
-            output = input;
-            return ErrorCode::Success;
-        }
-    }
+    return ConvertPlanned(MakePairPlan(fromEncoding, toEncoding), fromEncoding, toEncoding, input, output);
+}
 
-    //==========================================================================
-    // simdutf SIMD 加速快速路径
-    //==========================================================================
-#ifdef UNICONV_HAS_SIMDUTF
-    if (from_id == EncodingId::UTF8 && to_id == EncodingId::UTF16LE) {
-        auto result = ConvertUtf8ToUtf16LE_SIMD(input);
-        if (result.IsSuccess()) { output = std::move(result).GetValue(); return ErrorCode::Success; }
-        return result.GetErrorCode();
-    }
-    if (from_id == EncodingId::UTF16LE && to_id == EncodingId::UTF8) {
-        auto result = ConvertUtf16LEToUtf8_SIMD(input);
-        if (result.IsSuccess()) { output = std::move(result).GetValue(); return ErrorCode::Success; }
-        return result.GetErrorCode();
-    }
-    if (from_id == EncodingId::UTF8 && to_id == EncodingId::UTF16BE) {
-        auto result = ConvertUtf8ToUtf16BE_SIMD(input);
-        if (result.IsSuccess()) { output = std::move(result).GetValue(); return ErrorCode::Success; }
-        return result.GetErrorCode();
-    }
-    if (from_id == EncodingId::UTF16BE && to_id == EncodingId::UTF8) {
-        auto result = ConvertUtf16BEToUtf8_SIMD(input);
-        if (result.IsSuccess()) { output = std::move(result).GetValue(); return ErrorCode::Success; }
-        return result.GetErrorCode();
+ErrorCode UniConv::ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding,
+                                       std::string& output, ErrorPolicy policy, ConversionReport* report) noexcept {
+    if (report) {
+        *report = ConversionReport{};
     }
-#endif // UNICONV_HAS_SIMDUTF
-    //==========================================================================
-
-    UNICONV_PREFETCH(input.data(), 0, 3);
-
-    const size_t from_len = strlen(fromEncoding);
-    const size_t to_len   = strlen(toEncoding);
-    const uint64_t key = detail::MakeEncodingPairKey(fromEncoding, from_len, toEncoding, to_len);
-
-    auto descriptor = GetCache().GetOrCreateIconvDescriptor(key, fromEncoding, toEncoding);
-    if (UNICONV_UNLIKELY(!descriptor)) {
-        descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
-        if (UNICONV_UNLIKELY(!descriptor)) {
-            return ErrorCode::ConversionFailed;
+    if (policy == ErrorPolicy::Strict) {
+        const ErrorCode ec = ConvertEncodingFast(input, fromEncoding, toEncoding, output);
+        if (report && (ec == ErrorCode::InvalidSequence || ec == ErrorCode::IncompleteSequence)) {
+            // 只在失败时重新扫描一次以定位出错位置，成功路径不受影响
+            size_t units = 0;
+            CountPlannedUnits(MakePairPlan(fromEncoding, toEncoding), fromEncoding, toEncoding,
+                              input, units, report->first_error_offset);
+            report->first_error = ec;
         }
+        return ec;
     }
 
-    iconv_t cd = static_cast<iconv_t>(descriptor.get());
-
-    const char* inbuf_ptr = input.data();
-    std::size_t inbuf_left = input.size();
+    output.clear();
 
-    // 传入已解析的 EncodingId，避免重复字符串解析
-    size_t estimated_size = EstimateOutputSizeById(input.size(),
-                                                    static_cast<uint8_t>(from_id),
-                                                    static_cast<uint8_t>(to_id));
-    try {
-        output.resize(estimated_size);
-    } catch (...) {
-        return ErrorCode::OutOfMemory;
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        return ErrorCode::InvalidParameter;
     }
-
-    size_t written_total = 0;
-    constexpr int max_iterations = 100;
-    int iteration_count = 0;
-
-    while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
-        char* outbuf_ptr = output.data() + written_total;
-        std::size_t outbuf_left = output.size() - written_total;
-
-        UNICONV_PREFETCH(outbuf_ptr, 1, 2);
-
-        std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
-
-        written_total = output.size() - outbuf_left;
-
-        if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
-            int current_errno = errno;
-            switch (current_errno) {
-                case E2BIG: {
-                    if (UNICONV_UNLIKELY(output.size() >= 1048576 * 10)) {
-                        return ErrorCode::BufferTooSmall;
-                    }
-                    try {
-                        output.resize(output.size() * 2);
-                    } catch (...) {
-                        return ErrorCode::OutOfMemory;
-                    }
-                    continue;
-                }
-                case EILSEQ:
-                    return ErrorCode::InvalidSequence;
-                case EINVAL:
-                    return ErrorCode::IncompleteSequence;
-                default:
-                    return ErrorCode::ConversionFailed;
-            }
-        } else {
-            break;
-        }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        return ErrorCode::InvalidSourceEncoding;
     }
-
-    if (UNICONV_UNLIKELY(iteration_count >= max_iterations)) {
-        return ErrorCode::InternalError;
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        return ErrorCode::InvalidTargetEncoding;
     }
 
-    output.resize(written_total);
-    return ErrorCode::Success;
+    return ConvertPlannedTolerant(MakePairPlan(fromEncoding, toEncoding), fromEncoding, toEncoding,
+                                  input, output, policy, report);
 }
 
-// UTF-8 Conversion Series (output parameter versions)
-bool UniConv::ToUtf8FromLocale(const std::string& input, std::string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+ErrorCode UniConv::ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding,
+                                       std::string& output, NormalizationForm form) noexcept {
+    if (form == NormalizationForm::None) {
+        return ConvertEncodingFast(input, fromEncoding, toEncoding, output);
     }
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    return ErrorCode::Success == ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8, output);
-}
-
-bool UniConv::ToLocaleFromUtf8(const std::string& input, std::string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+    output.clear();
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        return ErrorCode::InvalidParameter;
     }
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    return ErrorCode::Success == ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str(), output);
-}
-
-bool UniConv::ToUtf8FromUtf16LE(const std::u16string& input, std::string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        return ErrorCode::InvalidSourceEncoding;
     }
-    
-    std::string input_bytes;
-    input_bytes.reserve(input.size() * 2);
-    for (char16_t ch : input) {
-        input_bytes.push_back(static_cast<char>(ch & 0xFF));
-        input_bytes.push_back(static_cast<char>((ch >> 8) & 0xFF));
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        return ErrorCode::InvalidTargetEncoding;
     }
-    
-    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_UTF8, output);
-}
 
-bool UniConv::ToUtf8FromUtf16BE(const std::u16string& input, std::string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
-    }
-    
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    
-    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_UTF16BE, ENC_UTF8, output);
+    //  转换与正规化按窗口融合：每块输出写出后立即快速检查
+    PipelineConfig config;
+    config.from          = fromEncoding;
+    config.to            = toEncoding;
+    config.normalization = form;
+    return RunPipeline(config, input, output, nullptr);
 }
 
-bool UniConv::ToUtf8FromUtf32LE(const std::u32string& input, std::string& output) noexcept {
-    if (input.empty()) {
+ErrorCode UniConv::NormalizeUtf8(std::string_view input, NormalizationForm form, std::string& output) noexcept {
+    output.clear();
+    try {
+        if (form == NormalizationForm::None) {
+            output.assign(input.data(), input.size());
+            return ErrorCode::Success;
+        }
+        const NormData& data = GetNormData();
+        const auto* p = reinterpret_cast<const uint8_t*>(input.data());
+        size_t start = 0;
+        ErrorCode ec = FindNormSegment(data, p, input.size(), form, start);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return ec;
+        }
+        //  已正规化：一次扫描 + 一次复制
+        output.reserve(input.size());
+        output.assign(input.data(), start);
+        if (start < input.size()) {
+            std::vector<uint32_t> units;
+            ec = AppendNormalizedUtf8(data, p + start, input.size() - start, form, output, units);
+            if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+                output.clear();
+                return ec;
+            }
+        }
+    } catch (...) {
         output.clear();
-        return true;
-    }
-    
-    std::string input_bytes;
-    input_bytes.reserve(input.size() * 4);
-    for (char32_t ch : input) {
-        input_bytes.push_back(static_cast<char>(ch & 0xFF));
-        input_bytes.push_back(static_cast<char>((ch >> 8) & 0xFF));
-        input_bytes.push_back(static_cast<char>((ch >> 16) & 0xFF));
-        input_bytes.push_back(static_cast<char>((ch >> 24) & 0xFF));
+        return ErrorCode::OutOfMemory;
     }
-    
-    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_UTF32LE, ENC_UTF8, output);
+    return ErrorCode::Success;
 }
 
-// UTF-16 Conversion Series (output parameter versions)
-bool UniConv::ToUtf16LEFromUtf8(const std::string& input, std::u16string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
-    }
-    
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF16LE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+ErrorCode UniConv::ConvertPlannedTolerant(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+                                          std::string_view input, std::string& output, ErrorPolicy policy,
+                                          ConversionReport* report) noexcept {
+    output.clear();
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return ErrorCode::Success;
     }
-    return false;
-}
 
-bool UniConv::ToUtf16BEFromUtf8(const std::string& input, std::u16string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
-    }
-    
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF16BE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+    const auto from_id = static_cast<EncodingId>(plan.fromId);
+    const auto to_id   = static_cast<EncodingId>(plan.toId);
+    const bool native  = plan.route == PairRoute::Native || plan.route == PairRoute::Simdutf;
+    // 同编码的复制路线不检查内容：改用“解码到 UTF-32”的计数定位坏序列，合法段原样复制
+    const PairPlan probe = MakePairPlan(fromEncoding, "UTF-32LE");
+
+    //  替换序列：目标编码中的 U+FFFD，目标无法表示时退化为 '?'
+    char replacement[16];
+    size_t replacement_size = 0;
+    size_t replacement_bom = 0;
+    if (policy == ErrorPolicy::Replace) {
+        const PairPlan utf8_plan = MakePairPlan("UTF-8", toEncoding);
+        size_t used = 0;
+        if (ConvertPlannedInto(utf8_plan, "UTF-8", toEncoding, std::string_view("\xEF\xBF\xBD", 3),
+                               replacement, sizeof(replacement), used, replacement_size) != ErrorCode::Success &&
+            ConvertPlannedInto(utf8_plan, "UTF-8", toEncoding, std::string_view("?", 1),
+                               replacement, sizeof(replacement), used, replacement_size) != ErrorCode::Success) {
+            return ErrorCode::ConversionFailed;
+        }
+        replacement_bom = LeadingBomBytes(to_id, replacement, replacement_size);
     }
-    return false;
-}
 
-bool UniConv::ToUtf16LEFromLocale(const std::string& input, std::u16string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
-    }
-    
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16LE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
-    }
-    return false;
-}
+    size_t pos = 0;
+    size_t written = 0;
+    size_t slack = 0;
+    try {
+        while (pos < input.size()) {
+            const std::string_view rest = input.substr(pos);
+            size_t consumed = 0;
+            size_t produced = 0;
+            ErrorCode ec;
+            if (plan.route == PairRoute::Copy) {
+                size_t units = 0;
+                ec = CountPlannedUnits(probe, fromEncoding, "UTF-32LE", rest, units, consumed);
+                output.resize(written + consumed + replacement_size);
+                std::memcpy(&output[written], rest.data(), consumed);
+                produced = consumed;
+            } else {
+                const size_t capacity = (native ? NativeOutputBound(from_id, to_id, rest.size())
+                                                : EstimateOutputSizeById(rest.size(), plan.fromId, plan.toId)) + slack;
+                if (output.size() < written + capacity) {
+                    output.resize(written + capacity);
+                }
+                ec = ConvertPlannedInto(plan, fromEncoding, toEncoding, rest, &output[written],
+                                        output.size() - written, consumed, produced);
+                // iconv 每段都会为 UTF-16/UTF-32 重新写出 BOM，只保留整个输出开头的那一个
+                if (written > 0 && produced > 0) {
+                    const size_t bom = LeadingBomBytes(to_id, &output[written], produced);
+                    if (bom > 0) {
+                        std::memmove(&output[written], &output[written + bom], produced - bom);
+                        produced -= bom;
+                    }
+                }
+            }
+            written += produced;
+            pos += consumed;
 
-bool UniConv::ToUtf16BEFromLocale(const std::string& input, std::u16string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
-    }
-    
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16BE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
-    }
-    return false;
-}
+            if (ec == ErrorCode::Success) {
+                break;
+            }
+            if (ec == ErrorCode::BufferTooSmall) {
+                slack = (consumed == 0) ? (slack * 2 + 64) : 0;
+                continue;
+            }
+            if (ec != ErrorCode::InvalidSequence && ec != ErrorCode::IncompleteSequence) {
+                output.clear();
+                return ec;
+            }
 
-bool UniConv::ToUtf16BEFromUtf16LE(const std::u16string& input, std::u16string& output) noexcept {
-    if (input.empty()) {
+            //  坏序列：记录、写入替换字符，然后从其后续接
+            if (report) {
+                if (report->replaced == 0) {
+                    report->first_error_offset = pos;
+                    report->first_error = ec;
+                }
+                ++report->replaced;
+            }
+            const std::string_view bad = input.substr(pos);
+            // 源字符本身合法（目标无法表示）时整字符替换，否则按非法序列长度跳过
+            size_t skip = 0;
+            size_t units = 0;
+            size_t window_consumed = 0;
+            const size_t step = OutputUnitBytes(from_id);
+            for (size_t len = step; len <= (std::min)(bad.size(), size_t{4}); len += step) {
+                if (CountPlannedUnits(probe, fromEncoding, "UTF-32LE", bad.substr(0, len),
+                                      units, window_consumed) == ErrorCode::Success) {
+                    skip = len;
+                    break;
+                }
+            }
+            if (skip == 0) {
+                skip = IllFormedLength(from_id, reinterpret_cast<const uint8_t*>(bad.data()), bad.size());
+            }
+            pos += (std::max)(skip, size_t{1});
+
+            if (replacement_size > 0) {
+                const size_t bom = written > 0 ? replacement_bom : 0;
+                const size_t n = replacement_size - bom;
+                if (output.size() < written + n) {
+                    output.resize(written + n);
+                }
+                std::memcpy(&output[written], replacement + bom, n);
+                written += n;
+            }
+        }
+        output.resize(written);
+    } catch (...) {
         output.clear();
-        return true;
-    }
-    
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_UTF16BE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+        return ErrorCode::OutOfMemory;
     }
-    return false;
+    return ErrorCode::Success;
 }
 
-bool UniConv::ToUtf16LEFromUtf16BE(const std::u16string& input, std::u16string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+ErrorCode UniConv::ConvertEncodingFast(std::string_view input, EncodingHandle fromEncoding,
+                                       EncodingHandle toEncoding, std::string& output) noexcept {
+    output.clear();
+
+    const ResolvedPair pair = ResolvePair(fromEncoding, toEncoding);
+    if (UNICONV_UNLIKELY(pair.status != ErrorCode::Success)) {
+        return pair.status;
     }
-    
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input_bytes, ENC_UTF16BE, ENC_UTF16LE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return ErrorCode::Success;
     }
-    return false;
+    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
+        return ConvertStatelessPlanned(pair.plan, pair.from, pair.to, input, output);
+    }
+    return ConvertPlanned(pair.plan, pair.from, pair.to, input, output);
 }
 
-// UTF-32 Conversion Series (output parameter versions)
-bool UniConv::ToUtf32LEFromUtf8(const std::string& input, std::u32string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+StringResult UniConv::ConvertEncodingFast(std::string_view input, EncodingHandle fromEncoding,
+                                          EncodingHandle toEncoding) noexcept {
+    std::string output;
+    const ErrorCode ec = ConvertEncodingFast(input, fromEncoding, toEncoding, output);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return StringResult::Failure(ec);
     }
-    
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF32LE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 4 == 0) {
-        output = std::u32string(reinterpret_cast<const char32_t*>(temp_output.data()), temp_output.size() / 4);
-        return true;
+    return StringResult::Success(std::move(output));
+}
+
+UniConv::ResolvedPair UniConv::ResolvePair(const char* fromEncoding, const char* toEncoding) noexcept {
+    ResolvedPair pair;
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        pair.status = ErrorCode::InvalidParameter;
+    } else if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        pair.status = ErrorCode::InvalidSourceEncoding;
+    } else if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        pair.status = ErrorCode::InvalidTargetEncoding;
+    } else {
+        pair.status = ErrorCode::Success;
+        pair.plan   = MakePairPlan(fromEncoding, toEncoding);
+        pair.from   = fromEncoding;
+        pair.to     = toEncoding;
     }
-    return false;
+    return pair;
 }
 
-bool UniConv::ToUtf32LEFromUtf16LE(const std::u16string& input, std::u32string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+UniConv::ResolvedPair UniConv::ResolvePair(EncodingHandle fromEncoding, EncodingHandle toEncoding) noexcept {
+    ResolvedPair pair;
+    if (UNICONV_UNLIKELY(!fromEncoding.IsValid())) {
+        pair.status = ErrorCode::InvalidSourceEncoding;
+    } else if (UNICONV_UNLIKELY(!toEncoding.IsValid())) {
+        pair.status = ErrorCode::InvalidTargetEncoding;
+    } else {
+        pair.status = ErrorCode::Success;
+        pair.plan   = MakePairPlan(fromEncoding, toEncoding);
+        pair.from   = HandleName(fromEncoding.Index());
+        pair.to     = HandleName(toEncoding.Index());
     }
-    
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_UTF32LE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 4 == 0) {
-        output = std::u32string(reinterpret_cast<const char32_t*>(temp_output.data()), temp_output.size() / 4);
-        return true;
+    return pair;
+}
+
+UniConv::PairPlan UniConv::MakePairPlan(EncodingHandle fromEncoding, EncodingHandle toEncoding) noexcept {
+    const uint16_t from = fromEncoding.Index();
+    const uint16_t to   = toEncoding.Index();
+    std::atomic<uint32_t>& entry = g_handlePairPlans[static_cast<size_t>(from) * kHandleCount + to];
+
+    uint32_t packed = entry.load(std::memory_order_relaxed);
+    if (UNICONV_UNLIKELY(packed == 0)) {
+        // 首次使用：按名称解析一次，之后只查表
+        const PairPlan resolved = MakePairPlan(HandleName(from), HandleName(to));
+        packed = (1u << 31) | (resolved.asciiPassthrough ? 1u << 30 : 0u) |
+                 (static_cast<uint32_t>(resolved.route) << 24) |
+                 (static_cast<uint32_t>(resolved.fromId) << 8) | resolved.toId;
+        entry.store(packed, std::memory_order_relaxed);
     }
-    return false;
+
+    PairPlan plan;
+    plan.key              = HandlePairKey(from, to);
+    plan.fromId           = static_cast<uint8_t>(packed >> 8);
+    plan.toId             = static_cast<uint8_t>(packed);
+    plan.route            = static_cast<PairRoute>((packed >> 24) & 0x3);
+    plan.asciiPassthrough = (packed >> 30) & 1u;
+    return plan;
 }
 
-bool UniConv::ToUtf32LEFromUtf16BE(const std::u16string& input, std::u32string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+UniConv::PairPlan UniConv::MakePairPlan(const char* fromEncoding, const char* toEncoding) noexcept {
+    const EncodingId from_id = GetEncodingId(fromEncoding);
+    const EncodingId to_id   = GetEncodingId(toEncoding);
+
+    PairPlan plan;
+    plan.fromId = static_cast<uint8_t>(from_id);
+    plan.toId   = static_cast<uint8_t>(to_id);
+
+    if (AreSameEncoding(from_id, to_id, fromEncoding, toEncoding)) {
+        plan.route = PairRoute::Copy;
+        return plan;
     }
-    
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input_bytes, ENC_UTF16BE, ENC_UTF32LE, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % 4 == 0) {
-        output = std::u32string(reinterpret_cast<const char32_t*>(temp_output.data()), temp_output.size() / 4);
-        return true;
+    plan.asciiPassthrough = IsAsciiPassthroughPair(from_id, to_id);
+
+#ifdef UNICONV_HAS_SIMDUTF
+    if (HasSimdutfKernel(from_id, to_id)) {
+        plan.route = PairRoute::Simdutf;
+        return plan;
     }
-    return false;
+#endif // UNICONV_HAS_SIMDUTF
+    if (HasNativeKernel(from_id, to_id)) {
+        plan.route = PairRoute::Native;
+        return plan;
+    }
+
+    plan.route = PairRoute::Iconv;
+    plan.key = detail::MakeEncodingPairKey(fromEncoding, strlen(fromEncoding), toEncoding, strlen(toEncoding));
+    return plan;
+}
+
+template <typename ByteString>
+ErrorCode UniConv::ConvertPlanned(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+                                  std::string_view input, ByteString& output) noexcept {
+    const auto run = [&](ConversionPath& path) noexcept {
+#if UNICONV_ENABLE_METRICS
+        const MetricsTimer timer;
+        const ErrorCode ec = ConvertPlannedRoute(plan, fromEncoding, toEncoding, input, output, path);
+        RecordConversionMetrics(fromEncoding, toEncoding, path, input.size(),
+                                ec == ErrorCode::Success ? output.size() : 0, ec, timer);
+        return ec;
+#else
+        return ConvertPlannedRoute(plan, fromEncoding, toEncoding, input, output, path);
+#endif
+    };
+    if (UNICONV_UNLIKELY(ActiveTraceHooks() != nullptr)) {
+        return TracedConversion(fromEncoding, toEncoding, input.size(), run,
+                                [&output](ErrorCode ec) { return ec == ErrorCode::Success ? output.size() : 0; });
+    }
+    ConversionPath path = ConversionPath::Copy;
+    return run(path);
 }
 
-// UTF-32 <-> UTF-16 Conversion Series (output parameter versions)
-bool UniConv::ToUtf16LEFromUtf32LE(const std::u32string& input, std::u16string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+template <typename ByteString>
+ErrorCode UniConv::ConvertPlannedRoute(const PairPlan& plan, const char* fromEncoding, const char* toEncoding,
+                                       std::string_view input, ByteString& output, ConversionPath& path) noexcept {
+    output.clear();
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return ErrorCode::Success;
     }
 
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char32_t));
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input_bytes, ENC_UTF32LE, ENC_UTF16LE, temp_output);
-
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+    if (UNICONV_LIKELY(plan.route == PairRoute::Copy)) {
+        path = ConversionPath::Copy;
+        output.assign(input.data(), input.size());
+        return ErrorCode::Success;
     }
-    return false;
-}
 
-bool UniConv::ToUtf16BEFromUtf32LE(const std::u32string& input, std::u16string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+    //  前导 ASCII 段直接复制，只把其后的部分交给慢路径
+    const size_t ascii_prefix = plan.asciiPassthrough ? AsciiPrefixLength(input) : 0;
+    if (ascii_prefix == input.size()) {
+        path = ConversionPath::AsciiShortcut;
+        output.assign(input.data(), input.size());
+        return ErrorCode::Success;
     }
 
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char32_t));
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input_bytes, ENC_UTF32LE, ENC_UTF16BE, temp_output);
+    const auto from_id = static_cast<EncodingId>(plan.fromId);
+    const auto to_id   = static_cast<EncodingId>(plan.toId);
 
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+#ifdef UNICONV_HAS_SIMDUTF
+    if (plan.route == PairRoute::Simdutf) {
+        path = ConversionPath::Simdutf;
+        return ConvertUtfSimdutf(from_id, to_id, input.data(), input.size(), output);
     }
-    return false;
-}
+#endif // UNICONV_HAS_SIMDUTF
 
-// UCS-4 Conversion Series (output parameter versions)
-bool UniConv::ToUtf8FromUcs4(const std::wstring& input, std::string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+    if (plan.route == PairRoute::Native) {
+        path = ConversionPath::Native;
+        return ConvertUtfNative(from_id, to_id, input.data(), input.size(), output);
     }
 
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
-    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_WCHAR, ENC_UTF8, output);
-}
+    path = ConversionPath::Iconv;
+    UNICONV_PREFETCH(input.data(), 0, 3);
 
-bool UniConv::ToUcs4FromUtf8(const std::string& input, std::wstring& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+    auto descriptor = GetIconvDescriptorByKey(plan.key, fromEncoding, toEncoding);
+    if (UNICONV_UNLIKELY(!descriptor)) {
+        return ErrorCode::ConversionFailed;
     }
 
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, ENC_UTF8, ENC_WCHAR, temp_output);
+    iconv_t cd = static_cast<iconv_t>(descriptor.get());
 
-    if (result == ErrorCode::Success && temp_output.size() % sizeof(wchar_t) == 0) {
-        output = std::wstring(reinterpret_cast<const wchar_t*>(temp_output.data()),
-                              temp_output.size() / sizeof(wchar_t));
-        return true;
+    // [优化9] 直接用 string_view 的指针，不构造临时 std::string
+    const char* inbuf_ptr = input.data() + ascii_prefix;
+    std::size_t inbuf_left = input.size() - ascii_prefix;
+
+    size_t estimated_size = ascii_prefix + EstimateOutputSizeById(inbuf_left, plan.fromId, plan.toId);
+    try {
+        output.resize(estimated_size);
+    } catch (...) {
+        return ErrorCode::OutOfMemory;
     }
-    return false;
-}
+    std::memcpy(output.data(), input.data(), ascii_prefix);
 
-// Locale Conversion Series (output parameter versions)
-bool UniConv::ToLocaleFromUtf16LE(const std::u16string& input, std::string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+    size_t written_total = ascii_prefix;
+    constexpr int max_iterations = 100;
+    int iteration_count = 0;
+
+    while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
+        char* outbuf_ptr = output.data() + written_total;
+        std::size_t outbuf_left = output.size() - written_total;
+
+        std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+
+        written_total = output.size() - outbuf_left;
+
+        if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+            int current_errno = errno;
+            switch (current_errno) {
+                case E2BIG: {
+                    if (UNICONV_UNLIKELY(output.size() >= 1048576 * 10)) {
+                        return ErrorCode::BufferTooSmall;
+                    }
+                    try {
+                        output.resize(output.size() * 2);
+                    } catch (...) {
+                        return ErrorCode::OutOfMemory;
+                    }
+                    continue;
+                }
+                case EILSEQ:
+                    return ErrorCode::InvalidSequence;
+                case EINVAL:
+                    return ErrorCode::IncompleteSequence;
+                default:
+                    return ErrorCode::ConversionFailed;
+            }
+        } else {
+            break;
+        }
     }
-    
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    
-    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_UTF16LE, currentEncoding.c_str(), output);
-}
 
-bool UniConv::ToLocaleFromUtf16BE(const std::u16string& input, std::string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
+    if (UNICONV_UNLIKELY(iteration_count >= max_iterations)) {
+        return ErrorCode::InternalError;
     }
-    
+
+    output.resize(written_total);
+    return ErrorCode::Success;
+}
+
+bool UniConv::ToUtf8FromLocale(std::string_view input, std::string& output) noexcept {
+    if (input.empty()) { output.clear(); return true; }
     std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
-    
-    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_UTF16BE, currentEncoding.c_str(), output);
+    return ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8, output) == ErrorCode::Success;
 }
 
-bool UniConv::ToLocaleFromWideString(const std::wstring& input, std::string& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
-    }
-    
+bool UniConv::ToLocaleFromUtf8(std::string_view input, std::string& output) noexcept {
+    if (input.empty()) { output.clear(); return true; }
     std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(wchar_t));
-    
-    return ErrorCode::Success == ConvertEncodingFast(input_bytes, ENC_WCHAR, currentEncoding.c_str(), output);
+    return ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str(), output) == ErrorCode::Success;
 }
 
-// Wide String Series (output parameter versions)
-bool UniConv::ToWideStringFromLocale(const std::string& input, std::wstring& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
-    }
-    
+bool UniConv::ToUtf16LEFromUtf8(std::string_view input, std::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16LE, input.data(), input.size(), output) == ErrorCode::Success;
+}
+
+bool UniConv::ToUtf16BEFromUtf8(std::string_view input, std::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16BE, input.data(), input.size(), output) == ErrorCode::Success;
+}
+
+bool UniConv::ToUtf32LEFromUtf8(std::string_view input, std::u32string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF32LE, input.data(), input.size(), output) == ErrorCode::Success;
+}
+
+bool UniConv::ToUtf16LEFromLocale(std::string_view input, std::u16string& output) noexcept {
+    if (input.empty()) { output.clear(); return true; }
     std::string currentEncoding = GetCurrentSystemEncoding();
     std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_WCHAR, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % sizeof(wchar_t) == 0) {
-        output = std::wstring(reinterpret_cast<const wchar_t*>(temp_output.data()),
-                              temp_output.size() / sizeof(wchar_t));
+    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16LE, temp_output);
+    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
+        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
         return true;
     }
     return false;
 }
 
-bool UniConv::ToWStringFromU16String(const std::u16string& input, std::wstring& output) noexcept {
-    if (input.empty()) {
-        output.clear();
-        return true;
-    }
-    
-    std::string input_bytes(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(char16_t));
+bool UniConv::ToUtf16BEFromLocale(std::string_view input, std::u16string& output) noexcept {
+    if (input.empty()) { output.clear(); return true; }
+    std::string currentEncoding = GetCurrentSystemEncoding();
     std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input_bytes, ENC_UTF16LE, ENC_WCHAR, temp_output);
-    
-    if (result == ErrorCode::Success && temp_output.size() % sizeof(wchar_t) == 0) {
-        output = std::wstring(reinterpret_cast<const wchar_t*>(temp_output.data()), temp_output.size() / sizeof(wchar_t));
+    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16BE, temp_output);
+    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
+        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
         return true;
     }
     return false;
 }
 
-//----------------------------------------------------------------------------------------------------------------------
-// === Batch Conversion with Output Parameter (Phase 2) ===
-//----------------------------------------------------------------------------------------------------------------------
 
-bool UniConv::ConvertEncodingBatch(
-    const std::vector<std::string>& inputs,
-    const char* fromEncoding,
-    const char* toEncoding,
-    std::vector<std::string>& outputs) noexcept {
+#if UNICONV_HAS_PMR
+// ===================================================================================================================
+// Polymorphic Memory Resource Outputs (std::pmr)
+// ===================================================================================================================
+
+ErrorCode UniConv::ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding,
+                                       std::pmr::string& output) noexcept {
+    output.clear();
+
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+        return ErrorCode::InvalidParameter;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
+        return ErrorCode::InvalidSourceEncoding;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        return ErrorCode::InvalidTargetEncoding;
+    }
+    if (UNICONV_UNLIKELY(input.empty())) {
+        return ErrorCode::Success;
+    }
 
-    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
-        outputs.clear();
-        outputs.resize(inputs.size());
-        bool all_success = true;
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            ErrorCode ec = ConvertEncodingStatelessFast(inputs[i], fromEncoding, toEncoding, outputs[i]);
-            if (ec != ErrorCode::Success) {
-                outputs[i].clear();
-                all_success = false;
+    const PairPlan plan = MakePairPlan(fromEncoding, toEncoding);
+    if (UNICONV_UNLIKELY(plan.route == PairRoute::Iconv && GetApiLayerMode() == ApiLayerMode::Stateless)) {
+        // 无状态模式不使用共享描述符缓存：经私有描述符转换后复制到 output
+        std::string temp;
+        const ErrorCode ec = ConvertEncodingStatelessFast(input, fromEncoding, toEncoding, temp);
+        if (ec == ErrorCode::Success) {
+            try {
+                output.assign(temp.data(), temp.size());
+            } catch (...) {
+                return ErrorCode::OutOfMemory;
             }
         }
-        return all_success;
+        return ec;
     }
-    
-    // Parameter validation
-    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
-        outputs.clear();
-        return false;
+    const ErrorCode ec = ConvertPlanned(plan, fromEncoding, toEncoding, input, output);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        output.clear();
     }
-    
-    // 快速编码名称有效性检查
-    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding) || !IsValidEncodingName(toEncoding))) {
-        outputs.clear();
-        return false;
+    return ec;
+}
+
+UniConv::PmrStringResult UniConv::ConvertEncodingFast(std::string_view input, const char* fromEncoding,
+                                                      const char* toEncoding,
+                                                      std::pmr::memory_resource* resource) noexcept {
+    try {
+        std::pmr::string output(resource ? resource : std::pmr::get_default_resource());
+        const ErrorCode ec = ConvertEncodingFast(input, fromEncoding, toEncoding, output);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return PmrStringResult::Failure(ec);
+        }
+        return PmrStringResult::Success(std::move(output));
+    } catch (...) {
+        return PmrStringResult::Failure(ErrorCode::OutOfMemory);
     }
-    
-    // Resize outputs to match inputs
+}
+
+bool UniConv::ConvertEncodingBatch(const std::vector<std::string>& inputs, const char* fromEncoding,
+                                   const char* toEncoding, std::pmr::vector<std::pmr::string>& outputs) noexcept {
     try {
+        // 元素按 uses-allocator 构造，共用 outputs 的 memory_resource
         outputs.resize(inputs.size());
     } catch (...) {
         return false;
     }
-    
-    // Early return for empty inputs
-    if (inputs.empty()) {
-        return true;
-    }
-    
-    // Prefetch inputs data
-    if (UNICONV_LIKELY(!inputs.empty())) {
-        UNICONV_PREFETCH(inputs.data(), 0, 2);
+    for (auto& output : outputs) {
+        output.clear();
     }
-    
-    // 使用预计算哈希作为缓存键 - 批量转换只计算一次
-    const size_t from_len = strlen(fromEncoding);
-    const size_t to_len   = strlen(toEncoding);
-    const uint64_t key = detail::MakeEncodingPairKey(fromEncoding, from_len, toEncoding, to_len);
-    
-    // Try cache first (thread-safe in both modes)
-    auto descriptor = GetCache().GetOrCreateIconvDescriptor(key, fromEncoding, toEncoding);
-    if (UNICONV_UNLIKELY(!descriptor)) {
-        // Fallback to global cache
-        descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
-        if (UNICONV_UNLIKELY(!descriptor)) {
-            outputs.clear();
-            return false;
-        }
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding ||
+                         !IsValidEncodingName(fromEncoding) || !IsValidEncodingName(toEncoding))) {
+        return false;
     }
-    
-    const EncodingId from_id = GetEncodingId(fromEncoding);
-    const EncodingId to_id   = GetEncodingId(toEncoding);
-    const bool same_encoding = AreSameEncoding(from_id, to_id, fromEncoding, toEncoding);
-    const bool both_ascii_compatible = IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id);
 
-    iconv_t cd = static_cast<iconv_t>(descriptor.get());
+    // 编码对只解析一次；无状态模式的 iconv 路线逐条走私有描述符
+    const PairPlan plan = MakePairPlan(fromEncoding, toEncoding);
+    const bool stateless_iconv = plan.route == PairRoute::Iconv && GetApiLayerMode() == ApiLayerMode::Stateless;
     bool all_success = true;
-
     for (size_t i = 0; i < inputs.size(); ++i) {
-        const std::string& input = inputs[i];
-        std::string& output = outputs[i];
-
-        output.clear();
-
-        if (input.empty()) {
-            continue;
-        }
-
-        if (UNICONV_UNLIKELY(same_encoding)) {
-            output = input;
-            continue;
-        }
-        if (both_ascii_compatible && IsAllAscii(input)) {
-            output = input;
-            continue;
-        }
-
-        size_t estimated_size = EstimateOutputSizeById(input.size(),
-                                                       static_cast<uint8_t>(from_id),
-                                                       static_cast<uint8_t>(to_id));
-        try {
-            output.resize(estimated_size);
-        } catch (...) {
+        if (inputs[i].empty()) continue;
+        const std::string_view input(inputs[i]);
+        const ErrorCode ec = stateless_iconv
+            ? ConvertEncodingFast(input, fromEncoding, toEncoding, outputs[i])
+            : ConvertPlanned(plan, fromEncoding, toEncoding, input, outputs[i]);
+        if (ec != ErrorCode::Success) {
+            outputs[i].clear();
             all_success = false;
-            continue;
         }
+    }
+    return all_success;
+}
 
-        const char* inbuf_ptr = input.data();
-        std::size_t inbuf_left = input.size();
-        size_t written_total = 0;
-        constexpr int max_iterations = 100;
-        int iteration_count = 0;
-        bool conversion_success = true;
+ErrorCode UniConv::ConvertEncodingBatch(std::string_view data, const size_t* offsets, size_t count,
+                                        const char* fromEncoding, const char* toEncoding,
+                                        std::pmr::string& outData, std::pmr::vector<size_t>& outOffsets,
+                                        std::vector<ErrorCode>* itemErrors) noexcept {
+    return ConvertPackedBatch(data, offsets, count, ResolvePair(fromEncoding, toEncoding),
+                              outData, outOffsets, itemErrors);
+}
 
-        while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
-            char* outbuf_ptr = output.data() + written_total;
-            std::size_t outbuf_left = output.size() - written_total;
+bool UniConv::ToUtf8FromLocale(std::string_view input, std::pmr::string& output) noexcept {
+    if (input.empty()) { output.clear(); return true; }
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    return ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8, output) == ErrorCode::Success;
+}
 
-            std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
-            written_total = output.size() - outbuf_left;
+bool UniConv::ToLocaleFromUtf8(std::string_view input, std::pmr::string& output) noexcept {
+    if (input.empty()) { output.clear(); return true; }
+    std::string currentEncoding = GetCurrentSystemEncoding();
+    return ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str(), output) == ErrorCode::Success;
+}
 
-            if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
-                int current_errno = errno;
-                switch (current_errno) {
-                    case E2BIG:
-                        if (UNICONV_UNLIKELY(output.size() >= 1048576 * 10)) {
-                            conversion_success = false;
-                            break;
-                        }
-                        try {
-                            output.resize(output.size() * 2);
-                        } catch (...) {
-                            conversion_success = false;
-                            break;
-                        }
-                        continue;
-                    case EILSEQ:
-                    case EINVAL:
-                    default:
-                        conversion_success = false;
-                        break;
-                }
-                if (!conversion_success) break;
-            } else {
-                break;
-            }
-        }
+bool UniConv::ToUtf8FromUtf16LE(std::u16string_view input, std::pmr::string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF8, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
+}
 
-        if (UNICONV_UNLIKELY(!conversion_success || iteration_count >= max_iterations)) {
-            all_success = false;
-            output.clear();
-        } else {
-            output.resize(written_total);
-        }
+bool UniConv::ToUtf8FromUtf16BE(std::u16string_view input, std::pmr::string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF8, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
+}
 
-        portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
-    }
+bool UniConv::ToUtf8FromUtf32LE(std::u32string_view input, std::pmr::string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF8, input.data(), input.size() * sizeof(char32_t), output) == ErrorCode::Success;
+}
 
-    return all_success;
+bool UniConv::ToUtf16LEFromUtf8(std::string_view input, std::pmr::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16LE, input.data(), input.size(), output) == ErrorCode::Success;
 }
 
+bool UniConv::ToUtf16BEFromUtf8(std::string_view input, std::pmr::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF16BE, input.data(), input.size(), output) == ErrorCode::Success;
+}
 
+bool UniConv::ToUtf16BEFromUtf16LE(std::u16string_view input, std::pmr::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF16BE, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
+}
 
-std::vector<StringResult> UniConv::ConvertEncodingBatchParallel(
-    const std::vector<std::string>& inputs,
-    const char* fromEncoding,
-    const char* toEncoding,
-    size_t numThreads) noexcept {
+bool UniConv::ToUtf16LEFromUtf16BE(std::u16string_view input, std::pmr::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF16LE, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
+}
 
-    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
-        std::vector<StringResult> results;
-        results.reserve(inputs.size());
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            results.emplace_back(StringResult::Success(std::string{}));
-        }
+bool UniConv::ToUtf16LEFromUtf32LE(std::u32string_view input, std::pmr::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF16LE, input.data(), input.size() * sizeof(char32_t), output) == ErrorCode::Success;
+}
 
-        if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
-            for (auto& r : results) r = StringResult::Failure(ErrorCode::InvalidParameter);
-            return results;
-        }
+bool UniConv::ToUtf16BEFromUtf32LE(std::u32string_view input, std::pmr::u16string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF32LE, EncodingId::UTF16BE, input.data(), input.size() * sizeof(char32_t), output) == ErrorCode::Success;
+}
 
-        size_t total_bytes = 0;
-        for (const auto& input : inputs) {
-            total_bytes += input.size();
-        }
+bool UniConv::ToUtf32LEFromUtf8(std::string_view input, std::pmr::u32string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF8, EncodingId::UTF32LE, input.data(), input.size(), output) == ErrorCode::Success;
+}
 
-        ThreadPool& pool = UniConvThreadPool::GetInstance();
-        size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
-        size_t recommended_threads = AdaptiveParallelPolicy::GetRecommendedThreads(
-            inputs.size(), total_bytes, max_threads);
-        const size_t min_chunk_size = ComputeMinChunkSize(inputs.size(), recommended_threads);
+bool UniConv::ToUtf32LEFromUtf16LE(std::u16string_view input, std::pmr::u32string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16LE, EncodingId::UTF32LE, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
+}
 
-        if (recommended_threads == 0) {
-            for (size_t i = 0; i < inputs.size(); ++i) {
-                std::string output;
-                ErrorCode ec = ConvertEncodingStatelessFast(inputs[i], fromEncoding, toEncoding, output);
-                results[i] = (ec == ErrorCode::Success)
-                    ? StringResult::Success(std::move(output))
-                    : StringResult::Failure(ec);
-            }
-            return results;
-        }
+bool UniConv::ToUtf32LEFromUtf16BE(std::u16string_view input, std::pmr::u32string& output) noexcept {
+    return ConvertUtfNative(EncodingId::UTF16BE, EncodingId::UTF32LE, input.data(), input.size() * sizeof(char16_t), output) == ErrorCode::Success;
+}
 
-        pool.ParallelFor(inputs.size(),
-            [this, &inputs, &results, fromEncoding, toEncoding](size_t start, size_t end) {
-                for (size_t i = start; i < end; ++i) {
-                    std::string output;
-                    ErrorCode ec = ConvertEncodingStatelessFast(inputs[i], fromEncoding, toEncoding, output);
-                    results[i] = (ec == ErrorCode::Success)
-                        ? StringResult::Success(std::move(output))
-                        : StringResult::Failure(ec);
-                }
-            },
-            min_chunk_size
-        );
+#endif // UNICONV_HAS_PMR
 
-        return results;
-    }
-    
-    std::vector<StringResult> results;
-    results.reserve(inputs.size());
-    
-    for (size_t i = 0; i < inputs.size(); ++i) {
-        results.emplace_back(StringResult::Success(std::string{}));
-    }
-    
+// ===================================================================================================================
+// Streaming Conversion (Constant Memory)
+// ===================================================================================================================
+
+UniConv::StreamConverter::StreamConverter(const char* fromEncoding, const char* toEncoding) noexcept
+    : m_status(ErrorCode::Success) {
     if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
-        for (auto& r : results) r = StringResult::Failure(ErrorCode::InvalidParameter);
-        return results;
+        m_status = ErrorCode::InvalidParameter;
+        return;
     }
     if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
-        for (auto& r : results) r = StringResult::Failure(ErrorCode::InvalidSourceEncoding);
-        return results;
+        m_status = ErrorCode::InvalidSourceEncoding;
+        return;
     }
     if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
-        for (auto& r : results) r = StringResult::Failure(ErrorCode::InvalidTargetEncoding);
-        return results;
-    }
-    
-    size_t total_bytes = 0;
-    for (const auto& input : inputs) {
-        total_bytes += input.size();
-    }
-    
-    ThreadPool& pool = UniConvThreadPool::GetInstance();
-    size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
-    size_t recommended_threads = AdaptiveParallelPolicy::GetRecommendedThreads(
-        inputs.size(), total_bytes, max_threads);
-    const size_t min_chunk_size = ComputeMinChunkSize(inputs.size(), recommended_threads);
-
-    
-    if (recommended_threads == 0) {
-        return ConvertEncodingBatch(inputs, fromEncoding, toEncoding);
+        m_status = ErrorCode::InvalidTargetEncoding;
+        return;
     }
-    
-    const EncodingId from_id = GetEncodingId(fromEncoding);
-    const EncodingId to_id   = GetEncodingId(toEncoding);
-    const bool same_encoding = AreSameEncoding(from_id, to_id, fromEncoding, toEncoding);
-    const bool both_ascii    = IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id);
-    const uint8_t from_raw   = static_cast<uint8_t>(from_id);
-    const uint8_t to_raw     = static_cast<uint8_t>(to_id);
-
-    pool.ParallelFor(inputs.size(), 
-        [this, &inputs, &results, fromEncoding, toEncoding,
-         same_encoding, both_ascii, from_raw, to_raw](size_t start, size_t end) {
-
-            const size_t from_len = strlen(fromEncoding);
-            const size_t to_len   = strlen(toEncoding);
-            const uint64_t key = detail::MakeEncodingPairKey(fromEncoding, from_len, toEncoding, to_len);
-            IconvSharedPtr descriptor;
-            {
-                auto& cache = GetCache();
-                descriptor = cache.GetOrCreateIconvDescriptor(key, fromEncoding, toEncoding);
-            }
-            if (UNICONV_UNLIKELY(!descriptor)) {
-                descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
-                if (UNICONV_UNLIKELY(!descriptor)) {
-                    for (size_t i = start; i < end; ++i)
-                        results[i] = StringResult::Failure(ErrorCode::ConversionFailed);
-                    return;
-                }
-            }
-            iconv_t cd = static_cast<iconv_t>(descriptor.get());
-
-            for (size_t i = start; i < end; ++i) {
-                const auto& input = inputs[i];
-                if (input.empty()) continue;
-
-                if (UNICONV_UNLIKELY(same_encoding)) {
-                    results[i] = StringResult::Success(std::string(input));
-                    continue;
-                }
-                if (both_ascii && IsAllAscii(input)) {
-                    results[i] = StringResult::Success(std::string(input));
-                    continue;
-                }
-
-                size_t estimated_size = EstimateOutputSizeById(input.size(), from_raw, to_raw);
-                std::string result;
-                result.resize(estimated_size);
 
-                const char* inbuf_ptr = input.data();
-                std::size_t inbuf_left = input.size();
-                size_t written_total = 0;
-                constexpr int max_iterations = 100;
-                int iteration_count = 0;
-                bool ok = true;
+    iconv_t cd = iconv_open(toEncoding, fromEncoding);
+    if (UNICONV_UNLIKELY(cd == reinterpret_cast<iconv_t>(-1))) {
+        m_status = ErrorCode::ConversionFailed;
+        return;
+    }
+    m_descriptor.reset(static_cast<void*>(cd));
+}
 
-                while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
-                    char* outbuf_ptr = result.data() + written_total;
-                    std::size_t outbuf_left = result.size() - written_total;
+ErrorCode UniConv::StreamConverter::Convert(std::string_view input, char* output, size_t outputCapacity,
+                                            size_t& consumed, size_t& written) noexcept {
+    consumed = 0;
+    written  = 0;
 
-                    std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
-                    written_total = result.size() - outbuf_left;
+    if (UNICONV_UNLIKELY(!m_descriptor)) {
+        return m_status != ErrorCode::Success ? m_status : ErrorCode::ConversionFailed;
+    }
+    if (UNICONV_UNLIKELY(!output && outputCapacity > 0)) {
+        return ErrorCode::InvalidParameter;
+    }
 
-                    if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
-                        int e = errno;
-                        if (e == E2BIG && result.size() < 1048576 * 10) {
-                            result.resize(result.size() * 2);
-                            continue;
-                        }
-                        ok = false;
-                        break;
-                    } else {
-                        break;
-                    }
-                }
+    iconv_t cd = static_cast<iconv_t>(m_descriptor.get());
+    char* outbuf_ptr = output;
+    std::size_t outbuf_left = outputCapacity;
 
-                if (UNICONV_UNLIKELY(!ok || iteration_count >= max_iterations)) {
-                    results[i] = StringResult::Failure(ErrorCode::ConversionFailed);
-                } else {
-                    result.resize(written_total);
-                    results[i] = StringResult::Success(std::move(result));
-                }
-                portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
-            }
-        }, 
-        min_chunk_size
-    );
-    
-    return results;
-}
+    auto finish = [&](ErrorCode code) noexcept {
+        written = outputCapacity - outbuf_left;
+        m_totalIn  += consumed;
+        m_totalOut += written;
+        return code;
+    };
 
-bool UniConv::ConvertEncodingBatchParallel(
-    const std::vector<std::string>& inputs,
-    const char* fromEncoding,
-    const char* toEncoding,
-    std::vector<std::string>& outputs,
-    size_t numThreads) noexcept {
+    //==========================================================================
+    // 1. 先用新数据补全上一块遗留的不完整序列
+    //==========================================================================
+    if (m_pendingSize > 0) {
+        const size_t take = (std::min)(MAX_PENDING_BYTES - m_pendingSize, input.size());
+        std::memcpy(m_pending.data() + m_pendingSize, input.data(), take);
 
-    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
-        outputs.clear();
-        outputs.resize(inputs.size());
+        const size_t combined = m_pendingSize + take;
+        const char* inbuf_ptr = m_pending.data();
+        std::size_t inbuf_left = combined;
 
-        if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
-            return false;
-        }
+        std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+        const int current_errno = errno;
+        const size_t used = combined - inbuf_left;
 
-        size_t total_bytes = 0;
-        for (const auto& input : inputs) {
-            total_bytes += input.size();
+        if (used >= m_pendingSize) {
+            // 遗留字节已全部转换，剩余部分交给主循环（主循环会复现同一错误）
+            consumed = used - m_pendingSize;
+            m_pendingSize = 0;
+        } else {
+            // 遗留字节尚未转换完毕：合并缓冲区中未转换的尾部（遗留字节 + 新数据）前移到开头，
+            // 新数据只有在下面全部暂存时才计入 consumed，否则下一次调用会在 m_pendingSize 处重新复制
+            const size_t leftover = combined - used;
+            if (UNICONV_LIKELY(used > 0)) {
+                std::memmove(m_pending.data(), m_pending.data() + used, leftover);
+                m_pendingSize -= used;
+            }
+            if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) != ret)) {
+                return finish(ErrorCode::InternalError);
+            }
+            switch (current_errno) {
+                case E2BIG:
+                    return finish(ErrorCode::BufferTooSmall);
+                case EINVAL:
+                    // 新数据仍不足以补全序列：全部暂存
+                    if (take < input.size()) {
+                        return finish(ErrorCode::InvalidSequence);
+                    }
+                    m_pendingSize = leftover;
+                    consumed = take;
+                    return finish(ErrorCode::Success);
+                case EILSEQ:
+                    return finish(ErrorCode::InvalidSequence);
+                default:
+                    return finish(ErrorCode::ConversionFailed);
+            }
         }
+    }
 
-        ThreadPool& pool = UniConvThreadPool::GetInstance();
-        size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
-        size_t recommended_threads = AdaptiveParallelPolicy::GetRecommendedThreads(
-            inputs.size(), total_bytes, max_threads);
-        const size_t min_chunk_size = ComputeMinChunkSize(inputs.size(), recommended_threads);
+    //==========================================================================
+    // 2. 主转换：直接从调用方输入写入调用方缓冲区
+    //==========================================================================
+    const char* inbuf_ptr = input.data() + consumed;
+    std::size_t inbuf_left = input.size() - consumed;
 
-        if (recommended_threads == 0) {
-            bool all_success = true;
-            for (size_t i = 0; i < inputs.size(); ++i) {
-                ErrorCode ec = ConvertEncodingStatelessFast(inputs[i], fromEncoding, toEncoding, outputs[i]);
-                if (ec != ErrorCode::Success) {
-                    outputs[i].clear();
-                    all_success = false;
-                }
+    if (inbuf_left > 0) {
+        std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+        consumed = input.size() - inbuf_left;
+
+        if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+            switch (errno) {
+                case E2BIG:
+                    return finish(ErrorCode::BufferTooSmall);
+                case EINVAL:
+                    // 块尾的不完整序列：暂存到下一块
+                    if (UNICONV_UNLIKELY(inbuf_left > MAX_PENDING_BYTES)) {
+                        return finish(ErrorCode::IncompleteSequence);
+                    }
+                    std::memcpy(m_pending.data(), inbuf_ptr, inbuf_left);
+                    m_pendingSize = inbuf_left;
+                    consumed = input.size();
+                    return finish(ErrorCode::Success);
+                case EILSEQ:
+                    return finish(ErrorCode::InvalidSequence);
+                default:
+                    return finish(ErrorCode::ConversionFailed);
             }
-            return all_success;
         }
+    }
 
-        std::atomic<bool> all_success{true};
-        pool.ParallelFor(inputs.size(),
-            [this, &inputs, &outputs, &all_success, fromEncoding, toEncoding](size_t start, size_t end) {
-                bool chunk_success = true;
-                for (size_t i = start; i < end; ++i) {
-                    ErrorCode ec = ConvertEncodingStatelessFast(inputs[i], fromEncoding, toEncoding, outputs[i]);
-                    if (ec != ErrorCode::Success) {
-                        outputs[i].clear();
-                        chunk_success = false;
-                    }
-                }
-                if (!chunk_success) {
-                    all_success.store(false, std::memory_order_relaxed);
-                }
-            },
-            min_chunk_size
-        );
+    return finish(ErrorCode::Success);
+}
 
-        return all_success.load(std::memory_order_relaxed);
+ErrorCode UniConv::StreamConverter::Finish(char* output, size_t outputCapacity, size_t& written) noexcept {
+    written = 0;
+
+    if (UNICONV_UNLIKELY(!m_descriptor)) {
+        return m_status != ErrorCode::Success ? m_status : ErrorCode::ConversionFailed;
     }
-    
-    outputs.clear();
-    outputs.resize(inputs.size());
-    
-    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
-        return false;
+    if (UNICONV_UNLIKELY(m_pendingSize > 0)) {
+        return ErrorCode::IncompleteSequence;
     }
-    if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding) || !IsValidEncodingName(toEncoding))) {
-        return false;
+    if (UNICONV_UNLIKELY(!output && outputCapacity > 0)) {
+        return ErrorCode::InvalidParameter;
     }
-    
-    size_t total_bytes = 0;
-    for (const auto& input : inputs) {
-        total_bytes += input.size();
+
+    // 输出状态型编码（如 ISO-2022-JP）的复位序列
+    iconv_t cd = static_cast<iconv_t>(m_descriptor.get());
+    char* outbuf_ptr = output;
+    std::size_t outbuf_left = outputCapacity;
+    std::size_t ret = portable_iconv(cd, nullptr, nullptr, &outbuf_ptr, &outbuf_left);
+    written = outputCapacity - outbuf_left;
+    m_totalOut += written;
+
+    if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
+        return errno == E2BIG ? ErrorCode::BufferTooSmall : ErrorCode::ConversionFailed;
     }
-    
-    ThreadPool& pool = UniConvThreadPool::GetInstance();
-    size_t max_threads = (numThreads > 0) ? numThreads : pool.GetThreadCount();
-    size_t recommended_threads = AdaptiveParallelPolicy::GetRecommendedThreads(
-        inputs.size(), total_bytes, max_threads);
-    const size_t min_chunk_size = ComputeMinChunkSize(inputs.size(), recommended_threads);
+    return ErrorCode::Success;
+}
 
-    
-    if (recommended_threads == 0) {
-        return ConvertEncodingBatch(inputs, fromEncoding, toEncoding, outputs);
+void UniConv::StreamConverter::Reset() noexcept {
+    if (m_descriptor) {
+        portable_iconv(static_cast<iconv_t>(m_descriptor.get()), nullptr, nullptr, nullptr, nullptr);
     }
-    
-    const EncodingId from_id = GetEncodingId(fromEncoding);
-    const EncodingId to_id   = GetEncodingId(toEncoding);
-    const bool same_encoding = AreSameEncoding(from_id, to_id, fromEncoding, toEncoding);
-    const bool both_ascii    = IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id);
-    const uint8_t from_raw   = static_cast<uint8_t>(from_id);
-    const uint8_t to_raw     = static_cast<uint8_t>(to_id);
+    m_pendingSize = 0;
+    m_totalIn = 0;
+    m_totalOut = 0;
+}
 
-    std::atomic<bool> all_success{true};
-    
-    pool.ParallelFor(inputs.size(),
-        [this, &inputs, &outputs, &all_success, fromEncoding, toEncoding,
-         same_encoding, both_ascii, from_raw, to_raw](size_t start, size_t end) {
+// ===================================================================================================================
+// File-to-File Conversion (Memory-Mapped)
+// ===================================================================================================================
 
-            const size_t from_len = strlen(fromEncoding);
-            const size_t to_len   = strlen(toEncoding);
-            const uint64_t key = detail::MakeEncodingPairKey(fromEncoding, from_len, toEncoding, to_len);
-            IconvSharedPtr descriptor;
-            {
-                auto& cache = GetCache();
-                descriptor = cache.GetOrCreateIconvDescriptor(key, fromEncoding, toEncoding);
-            }
-            if (UNICONV_UNLIKELY(!descriptor)) {
-                descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
-                if (UNICONV_UNLIKELY(!descriptor)) {
-                    all_success.store(false, std::memory_order_relaxed);
-                    return;
-                }
-            }
-            iconv_t cd = static_cast<iconv_t>(descriptor.get());
-            bool chunk_success = true;
+namespace {
 
-            for (size_t i = start; i < end; ++i) {
-                const auto& input = inputs[i];
-                std::string& output = outputs[i];
-                output.clear();
+constexpr size_t FILE_BLOCK_ALIGNMENT = 4096;       // 页对齐写缓冲
+constexpr size_t FILE_BLOCK_SIZE      = 1u << 20;   // 1MB 写块
 
-                if (input.empty()) continue;
+#ifdef _WIN32
+/**
+ * @brief UTF-8 路径转宽字符路径（CreateFileW）
+ */
+std::wstring Utf8PathToWide(const std::string& path) noexcept {
+    int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (len <= 0) return std::wstring();
+    try {
+        std::wstring wide(static_cast<size_t>(len), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wide[0], len);
+        wide.resize(static_cast<size_t>(len - 1));
+        return wide;
+    } catch (...) {
+        return std::wstring();
+    }
+}
+#endif
 
-                if (UNICONV_UNLIKELY(same_encoding)) {
-                    output = input;
-                    continue;
-                }
-                if (both_ascii && IsAllAscii(input)) {
-                    output = input;
-                    continue;
-                }
+/**
+ * @brief 文件身份：POSIX 为 st_dev / st_ino，Windows 为卷序列号 / 文件索引
+ */
+struct FileIdentity {
+    uint64_t device = 0;
+    uint64_t index  = 0;
+    bool     known  = false;
 
-                size_t estimated_size = EstimateOutputSizeById(input.size(), from_raw, to_raw);
-                try {
-                    output.resize(estimated_size);
-                } catch (...) {
-                    chunk_success = false;
-                    continue;
-                }
+    bool SameAs(const FileIdentity& other) const noexcept {
+        return known && other.known && device == other.device && index == other.index;
+    }
+};
 
-                const char* inbuf_ptr = input.data();
-                std::size_t inbuf_left = input.size();
-                size_t written_total = 0;
-                constexpr int max_iterations = 100;
-                int iteration_count = 0;
-                bool ok = true;
+#ifdef _WIN32
+inline FileIdentity GetFileIdentity(HANDLE file) noexcept {
+    FileIdentity id;
+    BY_HANDLE_FILE_INFORMATION info;
+    if (GetFileInformationByHandle(file, &info)) {
+        id.device = info.dwVolumeSerialNumber;
+        id.index  = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+        id.known  = true;
+    }
+    return id;
+}
+#else
+inline FileIdentity GetFileIdentity(const struct stat& st) noexcept {
+    FileIdentity id;
+    id.device = static_cast<uint64_t>(st.st_dev);
+    id.index  = static_cast<uint64_t>(st.st_ino);
+    id.known  = true;
+    return id;
+}
+#endif
 
-                while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
-                    char* outbuf_ptr = output.data() + written_total;
-                    std::size_t outbuf_left = output.size() - written_total;
+/**
+ * @brief 只读内存映射文件（RAII）
+ */
+class MappedInputFile {
+public:
+    MappedInputFile() = default;
+    MappedInputFile(const MappedInputFile&) = delete;
+    MappedInputFile& operator=(const MappedInputFile&) = delete;
+    ~MappedInputFile() { Close(); }
+
+    ErrorCode Open(const std::string& path) noexcept {
+#ifdef _WIN32
+        std::wstring wpath = Utf8PathToWide(path);
+        m_file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            const DWORD err = GetLastError();
+            return (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND)
+                ? ErrorCode::FileNotFound : ErrorCode::FileReadError;
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(m_file, &file_size)) {
+            return ErrorCode::FileReadError;
+        }
+        m_identity = GetFileIdentity(m_file);
+        m_size = static_cast<size_t>(file_size.QuadPart);
+        if (m_size == 0) {
+            return ErrorCode::Success;
+        }
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) {
+            return ErrorCode::FileReadError;
+        }
+        m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        return m_data ? ErrorCode::Success : ErrorCode::FileReadError;
+#else
+        m_fd = ::open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) {
+            return errno == ENOENT ? ErrorCode::FileNotFound : ErrorCode::FileReadError;
+        }
+        struct stat st;
+        if (::fstat(m_fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            return ErrorCode::FileReadError;
+        }
+        m_identity = GetFileIdentity(st);
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size == 0) {
+            return ErrorCode::Success;
+        }
+        void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (addr == MAP_FAILED) {
+            return ErrorCode::FileReadError;
+        }
+        m_data = static_cast<const char*>(addr);
+    #if defined(POSIX_MADV_SEQUENTIAL)
+        ::posix_madvise(addr, m_size, POSIX_MADV_SEQUENTIAL);
+    #endif
+        return ErrorCode::Success;
+#endif
+    }
 
-                    std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
-                    written_total = output.size() - outbuf_left;
+    std::string_view View() const noexcept {
+        return m_data ? std::string_view(m_data, m_size) : std::string_view();
+    }
 
-                    if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
-                        int e = errno;
-                        if (e == E2BIG && output.size() < 1048576 * 10) {
-                            try { output.resize(output.size() * 2); } catch (...) { ok = false; break; }
-                            continue;
-                        }
-                        ok = false;
-                        break;
-                    } else {
-                        break;
-                    }
-                }
+    const FileIdentity& Identity() const noexcept { return m_identity; }
 
-                if (UNICONV_UNLIKELY(!ok || iteration_count >= max_iterations)) {
-                    chunk_success = false;
-                    output.clear();
-                } else {
-                    output.resize(written_total);
+private:
+    void Close() noexcept {
+#ifdef _WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+#ifdef _WIN32
+    HANDLE      m_file    = INVALID_HANDLE_VALUE;
+    HANDLE      m_mapping = nullptr;
+#else
+    int         m_fd      = -1;
+#endif
+    const char*  m_data    = nullptr;
+    size_t       m_size    = 0;
+    FileIdentity m_identity;
+};
+
+/**
+ * @brief 顺序写出文件（RAII），失败时删除半成品
+ */
+class OutputFileWriter {
+public:
+    OutputFileWriter() = default;
+    OutputFileWriter(const OutputFileWriter&) = delete;
+    OutputFileWriter& operator=(const OutputFileWriter&) = delete;
+    ~OutputFileWriter() {
+        if (IsOpen()) {
+            CloseHandleOnly();
+            if (!m_committed) RemoveFile();
+        }
+    }
+
+    /**
+     * @brief 创建或截断输出文件
+     * @param source 输入文件的身份；输出与输入是同一文件（含硬链接）时不截断，返回 InvalidParameter
+     */
+    ErrorCode Open(const std::string& path, const FileIdentity& source) noexcept {
+        try {
+            m_path = path;
+        } catch (...) {
+            return ErrorCode::OutOfMemory;
+        }
+#ifdef _WIN32
+        std::wstring wpath = Utf8PathToWide(path);
+        m_file = CreateFileW(wpath.c_str(), GENERIC_WRITE, 0, nullptr,
+                             CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file != INVALID_HANDLE_VALUE) {
+            return ErrorCode::Success;
+        }
+        // 输入以 FILE_SHARE_READ 打开，同一文件的写打开必然是共享冲突；只读属性打开一次确认身份
+        if (GetLastError() == ERROR_SHARING_VIOLATION) {
+            HANDLE probe = CreateFileW(wpath.c_str(), FILE_READ_ATTRIBUTES,
+                                       FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                       OPEN_EXISTING, 0, nullptr);
+            if (probe != INVALID_HANDLE_VALUE) {
+                const bool same = GetFileIdentity(probe).SameAs(source);
+                CloseHandle(probe);
+                if (same) {
+                    return ErrorCode::InvalidParameter;
                 }
-                portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
             }
+        }
+        return ErrorCode::FileWriteError;
+#else
+        // 先不带 O_TRUNC 打开：输出若就是输入，截断会使输入映射的页失效（读取时 SIGBUS）
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (m_fd < 0) {
+            return ErrorCode::FileWriteError;
+        }
+        struct stat st;
+        if (::fstat(m_fd, &st) != 0) {
+            CloseHandleOnly();  // 无法确认身份时不删除：它可能就是输入文件
+            return ErrorCode::FileWriteError;
+        }
+        if (GetFileIdentity(st).SameAs(source)) {
+            CloseHandleOnly();
+            return ErrorCode::InvalidParameter;
+        }
+        return ::ftruncate(m_fd, 0) == 0 ? ErrorCode::Success : ErrorCode::FileWriteError;
+#endif
+    }
 
-            if (!chunk_success) {
-                all_success.store(false, std::memory_order_relaxed);
+    ErrorCode Write(const char* data, size_t size) noexcept {
+        while (size > 0) {
+#ifdef _WIN32
+            const DWORD chunk = static_cast<DWORD>((std::min)(size, static_cast<size_t>(0x40000000)));
+            DWORD done = 0;
+            if (!WriteFile(m_file, data, chunk, &done, nullptr) || done == 0) {
+                return ErrorCode::FileWriteError;
             }
-        },
-        min_chunk_size
-    );
-    
-    return all_success.load(std::memory_order_relaxed);
-}
+#else
+            const ssize_t done = ::write(m_fd, data, size);
+            if (done < 0) {
+                if (errno == EINTR) continue;
+                return ErrorCode::FileWriteError;
+            }
+            if (done == 0) {
+                return ErrorCode::FileWriteError;
+            }
+#endif
+            data += done;
+            size -= static_cast<size_t>(done);
+        }
+        return ErrorCode::Success;
+    }
 
-// ===================================================================================================================
-// string_view Input Overloads 
-// ===================================================================================================================
+    ErrorCode Commit() noexcept {
+        const bool ok = CloseHandleOnly();
+        m_committed = ok;
+        if (!ok) RemoveFile();
+        return ok ? ErrorCode::Success : ErrorCode::FileWriteError;
+    }
 
-bool UniConv::ConvertEncoding(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
-    return ConvertEncodingFast(input, fromEncoding, toEncoding, output) == ErrorCode::Success;
-}
+private:
+    void RemoveFile() noexcept {
+#ifdef _WIN32
+        // 与 CreateFileW 使用同一宽字符路径：窄字符 API 按 ANSI 码页解释 UTF-8 路径
+        const std::wstring wpath = Utf8PathToWide(m_path);
+        if (!wpath.empty()) DeleteFileW(wpath.c_str());
+#else
+        ::unlink(m_path.c_str());
+#endif
+    }
 
-ErrorCode UniConv::ConvertEncodingFast(std::string_view input, const char* fromEncoding, const char* toEncoding, std::string& output) noexcept {
-    if (UNICONV_UNLIKELY(GetApiLayerMode() == ApiLayerMode::Stateless)) {
-        return ConvertEncodingStatelessFast(input, fromEncoding, toEncoding, output);
+#ifdef _WIN32
+    bool IsOpen() const noexcept { return m_file != INVALID_HANDLE_VALUE; }
+    bool CloseHandleOnly() noexcept {
+        const bool ok = CloseHandle(m_file) != 0;
+        m_file = INVALID_HANDLE_VALUE;
+        return ok;
+    }
+    HANDLE      m_file = INVALID_HANDLE_VALUE;
+#else
+    bool IsOpen() const noexcept { return m_fd >= 0; }
+    bool CloseHandleOnly() noexcept {
+        const bool ok = ::close(m_fd) == 0;
+        m_fd = -1;
+        return ok;
     }
+    int         m_fd = -1;
+#endif
+    std::string m_path;
+    bool        m_committed = false;
+};
 
-    output.clear();
+/**
+ * @brief 页对齐写缓冲（RAII）
+ */
+struct AlignedBlockDeleter {
+    void operator()(char* p) const noexcept {
+        ::operator delete[](p, std::align_val_t(FILE_BLOCK_ALIGNMENT));
+    }
+};
 
-    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding)) {
+const char* BomEncodingName(UniConv::BomEncoding bom) noexcept {
+    switch (bom) {
+        case UniConv::BomEncoding::UTF8:     return "UTF-8";
+        case UniConv::BomEncoding::UTF16_LE: return "UTF-16LE";
+        case UniConv::BomEncoding::UTF16_BE: return "UTF-16BE";
+        case UniConv::BomEncoding::UTF32_LE: return "UTF-32LE";
+        case UniConv::BomEncoding::UTF32_BE: return "UTF-32BE";
+        default:                             return nullptr;
+    }
+}
+
+} // anonymous namespace
+
+ErrorCode UniConv::ConvertFile(const std::string& inputPath, const char* fromEncoding,
+                               const char* toEncoding, const std::string& outputPath) noexcept {
+    if (UNICONV_UNLIKELY(!fromEncoding || !toEncoding || inputPath.empty() || outputPath.empty())) {
         return ErrorCode::InvalidParameter;
     }
     if (UNICONV_UNLIKELY(!IsValidEncodingName(fromEncoding))) {
@@ -3559,179 +9857,509 @@ ErrorCode UniConv::ConvertEncodingFast(std::string_view input, const char* fromE
     if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
         return ErrorCode::InvalidTargetEncoding;
     }
-    if (UNICONV_UNLIKELY(input.empty())) {
-        return ErrorCode::Success;
+
+    MappedInputFile source;
+    ErrorCode ec = source.Open(inputPath);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return ec;
     }
 
-    const EncodingId from_id = GetEncodingId(fromEncoding);
-    const EncodingId to_id   = GetEncodingId(toEncoding);
+    // BOM 检测无需拷贝：直接作用于映射视图
+    auto [bom, payload] = DetectAndRemoveBom(source.View());
+    if (const char* bom_encoding = BomEncodingName(bom)) {
+        fromEncoding = bom_encoding;
+    }
 
-    if (UNICONV_LIKELY(AreSameEncoding(from_id, to_id, fromEncoding, toEncoding))) {
-        output.assign(input.data(), input.size());
-        return ErrorCode::Success;
+    OutputFileWriter sink;
+    ec = sink.Open(outputPath, source.Identity());
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return ec;
     }
 
-    if (IsAsciiCompatibleById(from_id) && IsAsciiCompatibleById(to_id)) {
-        bool all_ascii = true;
-        const auto* data = reinterpret_cast<const unsigned char*>(input.data());
-        size_t i = 0;
-        for (; i + 8 <= input.size(); i += 8) {
-            uint64_t block;
-            std::memcpy(&block, data + i, 8);
-            if (block & 0x8080808080808080ULL) { all_ascii = false; break; }
-        }
-        if (all_ascii) {
-            for (; i < input.size(); ++i) {
-                if (data[i] >= 0x80) { all_ascii = false; break; }
-            }
-        }
-        if (all_ascii) {
-            output.assign(input.data(), input.size());
-            return ErrorCode::Success;
-        }
+    // 同编码：映射视图直接写出
+    if (AreSameEncoding(GetEncodingId(fromEncoding), GetEncodingId(toEncoding), fromEncoding, toEncoding)) {
+        ec = sink.Write(payload.data(), payload.size());
+        return ec == ErrorCode::Success ? sink.Commit() : ec;
     }
 
-    UNICONV_PREFETCH(input.data(), 0, 3);
+    StreamConverter stream(fromEncoding, toEncoding);
+    if (UNICONV_UNLIKELY(!stream.IsOpen())) {
+        return stream.GetStatus();
+    }
 
-    const size_t from_len = strlen(fromEncoding);
-    const size_t to_len   = strlen(toEncoding);
-    const uint64_t key = detail::MakeEncodingPairKey(fromEncoding, from_len, toEncoding, to_len);
+    std::unique_ptr<char[], AlignedBlockDeleter> block(
+        static_cast<char*>(::operator new[](FILE_BLOCK_SIZE, std::align_val_t(FILE_BLOCK_ALIGNMENT), std::nothrow)));
+    if (UNICONV_UNLIKELY(!block)) {
+        return ErrorCode::OutOfMemory;
+    }
 
-    auto descriptor = GetCache().GetOrCreateIconvDescriptor(key, fromEncoding, toEncoding);
-    if (UNICONV_UNLIKELY(!descriptor)) {
-        descriptor = GetIconvDescriptor(fromEncoding, toEncoding);
-        if (UNICONV_UNLIKELY(!descriptor)) {
-            return ErrorCode::ConversionFailed;
+    while (!payload.empty()) {
+        size_t consumed = 0, written = 0;
+        ec = stream.Convert(payload, block.get(), FILE_BLOCK_SIZE, consumed, written);
+        payload.remove_prefix(consumed);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success && ec != ErrorCode::BufferTooSmall)) {
+            return ec;
+        }
+        if (written > 0) {
+            ErrorCode write_ec = sink.Write(block.get(), written);
+            if (UNICONV_UNLIKELY(write_ec != ErrorCode::Success)) {
+                return write_ec;
+            }
         }
     }
 
-    iconv_t cd = static_cast<iconv_t>(descriptor.get());
+    size_t written = 0;
+    ec = stream.Finish(block.get(), FILE_BLOCK_SIZE, written);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return ec;
+    }
+    if (written > 0) {
+        ec = sink.Write(block.get(), written);
+        if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+            return ec;
+        }
+    }
+    return sink.Commit();
+}
 
-    // [优化9] 直接用 string_view 的指针，不构造临时 std::string
-    const char* inbuf_ptr = input.data();
-    std::size_t inbuf_left = input.size();
+// ===================================================================================================================
+// Fused Conversion Pipeline
+// ===================================================================================================================
 
-    size_t estimated_size = EstimateOutputSizeById(input.size(),
-                                                    static_cast<uint8_t>(from_id),
-                                                    static_cast<uint8_t>(to_id));
-    try {
-        output.resize(estimated_size);
-    } catch (...) {
-        return ErrorCode::OutOfMemory;
-    }
+namespace {
 
-    size_t written_total = 0;
-    constexpr int max_iterations = 100;
-    int iteration_count = 0;
+/**
+ * @brief 流水线换行 / NUL 阶段所见的目标码元布局
+ * @details 单字节布局覆盖所有 ASCII 兼容编码：UTF-8 与各 DBCS 的后续字节都不会是 0x00 / 0x0A / 0x0D，
+ *          因此逐字节改写不会破坏多字节字符。BOM 形式的 UTF-16/32 字节序由首块输出里的 BOM 决定。
+ */
+struct PipelineUnitLayout {
+    size_t unit      = 0;      ///< 码元字节数；0 表示不支持换行 / NUL 阶段
+    bool   bigEndian = false;  ///< 宽码元的字节序
+    bool   fromBom   = false;  ///< 字节序待由输出 BOM 确定
+};
 
-    while (UNICONV_LIKELY(inbuf_left > 0) && UNICONV_LIKELY(iteration_count++ < max_iterations)) {
-        char* outbuf_ptr = output.data() + written_total;
-        std::size_t outbuf_left = output.size() - written_total;
+inline PipelineUnitLayout GetPipelineUnitLayout(EncodingId id) noexcept {
+    switch (id) {
+        case EncodingId::UTF16LE: return {2, false, false};
+        case EncodingId::UTF16BE: return {2, true, false};
+        case EncodingId::UTF16:   return {2, true, true};
+        case EncodingId::UTF32LE: return {4, false, false};
+        case EncodingId::UTF32BE: return {4, true, false};
+        case EncodingId::UTF32:   return {4, true, true};
+        default:                  return {IsAsciiCompatibleById(id) ? size_t{1} : size_t{0}, false, false};
+    }
+}
 
-        std::size_t ret = portable_iconv(cd, &inbuf_ptr, &inbuf_left, &outbuf_ptr, &outbuf_left);
+/**
+ * @brief 从 BOM 形式输出的开头确定字节序（无 BOM 时按大端，与 iconv 的默认一致）
+ */
+inline void ResolvePipelineByteOrder(PipelineUnitLayout& layout, const char* data, size_t size) noexcept {
+    const auto* p = reinterpret_cast<const uint8_t*>(data);
+    if (layout.unit == 2) {
+        layout.bigEndian = !(size >= 2 && p[0] == 0xFF && p[1] == 0xFE);
+    } else {
+        layout.bigEndian = !(size >= 4 && p[0] == 0xFF && p[1] == 0xFE && p[2] == 0 && p[3] == 0);
+    }
+    layout.fromBom = false;
+}
 
-        written_total = output.size() - outbuf_left;
+inline const uint8_t* FindByteOrEnd(const uint8_t* from, const uint8_t* end, uint8_t value) noexcept {
+    if (from >= end) {
+        return end;
+    }
+    const void* hit = std::memchr(from, value, static_cast<size_t>(end - from));
+    return hit ? static_cast<const uint8_t*>(hit) : end;
+}
 
-        if (UNICONV_UNLIKELY(static_cast<std::size_t>(-1) == ret)) {
-            int current_errno = errno;
-            switch (current_errno) {
-                case E2BIG: {
-                    if (UNICONV_UNLIKELY(output.size() >= 1048576 * 10)) {
-                        return ErrorCode::BufferTooSmall;
-                    }
-                    try {
-                        output.resize(output.size() * 2);
-                    } catch (...) {
-                        return ErrorCode::OutOfMemory;
-                    }
-                    continue;
-                }
-                case EILSEQ:
-                    return ErrorCode::InvalidSequence;
-                case EINVAL:
-                    return ErrorCode::IncompleteSequence;
-                default:
-                    return ErrorCode::ConversionFailed;
+/**
+ * @brief 单字节码元：原地把 CRLF / CR 改写为 LF、删除 NUL，返回新长度
+ * @param after_cr 跨块状态：上一块以 CR 结束时为 true，本块开头的 LF 随之丢弃
+ * @details CR 与 NUL 的下一个位置各由 memchr 查找并缓存，两者之间的整段用 memmove 搬运；
+ *          不含 CR / NUL 的块只有两次 memchr，不逐字节改写。
+ */
+size_t FilterPipelineBytes(char* data, size_t size, bool newlines, bool strip_nul, bool& after_cr) noexcept {
+    auto* base = reinterpret_cast<uint8_t*>(data);
+    const uint8_t* end = base + size;
+    const uint8_t* r = base;
+    uint8_t* w = base;
+
+    if (after_cr && r < end && *r == '\n') {
+        ++r;
+    }
+    after_cr = false;
+
+    const uint8_t* next_cr  = newlines  ? FindByteOrEnd(r, end, '\r') : end;
+    const uint8_t* next_nul = strip_nul ? FindByteOrEnd(r, end, 0)    : end;
+    for (;;) {
+        const uint8_t* stop = (std::min)(next_cr, next_nul);
+        if (stop != r) {
+            if (w != r) {
+                std::memmove(w, r, static_cast<size_t>(stop - r));
             }
-        } else {
+            w += stop - r;
+            r = stop;
+        }
+        if (r == end) {
             break;
         }
+        if (r == next_cr) {
+            *w++ = '\n';
+            if (++r == end) {
+                after_cr = true;
+                break;
+            }
+            if (*r == '\n') {
+                ++r;
+            }
+            next_cr = FindByteOrEnd(r, end, '\r');
+        } else {
+            next_nul = FindByteOrEnd(++r, end, 0);
+        }
     }
+    return static_cast<size_t>(w - base);
+}
 
-    if (UNICONV_UNLIKELY(iteration_count >= max_iterations)) {
-        return ErrorCode::InternalError;
+template <size_t Unit, bool BigEndian>
+inline uint32_t LoadPipelineUnit(const uint8_t* p) noexcept {
+    uint32_t v = 0;
+    for (size_t i = 0; i < Unit; ++i) {
+        v |= static_cast<uint32_t>(p[BigEndian ? i : Unit - 1 - i]) << (8 * (Unit - 1 - i));
     }
-
-    output.resize(written_total);
-    return ErrorCode::Success;
+    return v;
 }
 
-bool UniConv::ToUtf8FromLocale(std::string_view input, std::string& output) noexcept {
-    if (input.empty()) { output.clear(); return true; }
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    return ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF8, output) == ErrorCode::Success;
+template <size_t Unit, bool BigEndian>
+inline void StorePipelineLf(uint8_t* p) noexcept {
+    std::memset(p, 0, Unit);
+    p[BigEndian ? Unit - 1 : 0] = '\n';
 }
 
-bool UniConv::ToLocaleFromUtf8(std::string_view input, std::string& output) noexcept {
-    if (input.empty()) { output.clear(); return true; }
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    return ConvertEncodingFast(input, ENC_UTF8, currentEncoding.c_str(), output) == ErrorCode::Success;
+/**
+ * @brief UTF-16/32 码元版本的 FilterPipelineBytes()
+ */
+template <size_t Unit, bool BigEndian>
+size_t FilterPipelineWide(char* data, size_t size, bool newlines, bool strip_nul, bool& after_cr) noexcept {
+    auto* p = reinterpret_cast<uint8_t*>(data);
+    size_t w = 0;
+    for (size_t r = 0; r + Unit <= size; r += Unit) {
+        const uint32_t unit = LoadPipelineUnit<Unit, BigEndian>(p + r);
+        if (newlines && unit == '\r') {
+            StorePipelineLf<Unit, BigEndian>(p + w);
+            w += Unit;
+            after_cr = true;
+            continue;
+        }
+        if (strip_nul && unit == 0) {
+            continue;
+        }
+        if (!(after_cr && unit == '\n')) {
+            if (w != r) {
+                std::memmove(p + w, p + r, Unit);
+            }
+            w += Unit;
+        }
+        after_cr = false;
+    }
+    return w;
 }
 
-bool UniConv::ToUtf16LEFromUtf8(std::string_view input, std::u16string& output) noexcept {
-    if (input.empty()) { output.clear(); return true; }
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF16LE, temp_output);
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+size_t FilterPipelineUnits(const PipelineUnitLayout& layout, char* data, size_t size,
+                           bool newlines, bool strip_nul, bool& after_cr) noexcept {
+    if (layout.unit == 1) {
+        return FilterPipelineBytes(data, size, newlines, strip_nul, after_cr);
     }
-    return false;
+    if (layout.unit == 2) {
+        return layout.bigEndian ? FilterPipelineWide<2, true>(data, size, newlines, strip_nul, after_cr)
+                                : FilterPipelineWide<2, false>(data, size, newlines, strip_nul, after_cr);
+    }
+    return layout.bigEndian ? FilterPipelineWide<4, true>(data, size, newlines, strip_nul, after_cr)
+                            : FilterPipelineWide<4, false>(data, size, newlines, strip_nul, after_cr);
 }
 
-bool UniConv::ToUtf16BEFromUtf8(std::string_view input, std::u16string& output) noexcept {
-    if (input.empty()) { output.clear(); return true; }
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF16BE, temp_output);
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+} // anonymous namespace
+
+UniConv::ConversionPipeline UniConv::MakePipeline(const char* fromEncoding, const char* toEncoding) noexcept {
+    ConversionPipeline pipeline;
+    if (UNICONV_UNLIKELY(!toEncoding)) {
+        pipeline.m_status = ErrorCode::InvalidParameter;
+        return pipeline;
     }
-    return false;
+    if (UNICONV_UNLIKELY(fromEncoding && !IsValidEncodingName(fromEncoding))) {
+        pipeline.m_status = ErrorCode::InvalidSourceEncoding;
+        return pipeline;
+    }
+    if (UNICONV_UNLIKELY(!IsValidEncodingName(toEncoding))) {
+        pipeline.m_status = ErrorCode::InvalidTargetEncoding;
+        return pipeline;
+    }
+    try {
+        if (fromEncoding) {
+            pipeline.m_from = fromEncoding;
+        }
+        pipeline.m_to = toEncoding;
+    } catch (...) {
+        pipeline.m_status = ErrorCode::OutOfMemory;
+        return pipeline;
+    }
+    pipeline.m_owner  = this;
+    pipeline.m_stages = fromEncoding ? 0 : ConversionPipeline::STAGE_DETECT_SOURCE;
+    pipeline.m_status = ErrorCode::Success;
+    return pipeline;
 }
 
-bool UniConv::ToUtf32LEFromUtf8(std::string_view input, std::u32string& output) noexcept {
-    if (input.empty()) { output.clear(); return true; }
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, ENC_UTF8, ENC_UTF32LE, temp_output);
-    if (result == ErrorCode::Success && temp_output.size() % 4 == 0) {
-        output = std::u32string(reinterpret_cast<const char32_t*>(temp_output.data()), temp_output.size() / 4);
-        return true;
-    }
-    return false;
+UniConv::ConversionPipeline& UniConv::ConversionPipeline::SetStage(uint8_t stage, bool enable) noexcept {
+    m_stages = enable ? static_cast<uint8_t>(m_stages | stage) : static_cast<uint8_t>(m_stages & ~stage);
+    return *this;
 }
 
-bool UniConv::ToUtf16LEFromLocale(std::string_view input, std::u16string& output) noexcept {
-    if (input.empty()) { output.clear(); return true; }
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16LE, temp_output);
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+UniConv::ConversionPipeline& UniConv::ConversionPipeline::StripBom(bool enable) noexcept {
+    return SetStage(STAGE_STRIP_BOM, enable);
+}
+
+UniConv::ConversionPipeline& UniConv::ConversionPipeline::DetectSource(bool enable) noexcept {
+    return SetStage(STAGE_DETECT_SOURCE, enable);
+}
+
+UniConv::ConversionPipeline& UniConv::ConversionPipeline::NormalizeNewlines(bool enable) noexcept {
+    return SetStage(STAGE_NEWLINES, enable);
+}
+
+UniConv::ConversionPipeline& UniConv::ConversionPipeline::StripNul(bool enable) noexcept {
+    return SetStage(STAGE_STRIP_NUL, enable);
+}
+
+UniConv::ConversionPipeline& UniConv::ConversionPipeline::BlockSize(size_t bytes) noexcept {
+    m_blockSize = (std::max)(bytes, MIN_BLOCK_SIZE);
+    return *this;
+}
+
+UniConv::ConversionPipeline& UniConv::ConversionPipeline::Normalize(NormalizationForm form) noexcept {
+    m_normalization = form;
+    return *this;
+}
+
+ErrorCode UniConv::ConversionPipeline::Run(std::string_view input, std::string& output,
+                                           const char** sourceEncoding) const noexcept {
+    if (UNICONV_UNLIKELY(m_status != ErrorCode::Success)) {
+        output.clear();
+        if (sourceEncoding) {
+            *sourceEncoding = nullptr;
+        }
+        return m_status;
     }
-    return false;
+    PipelineConfig config;
+    config.from          = m_from.empty() ? nullptr : m_from.c_str();
+    config.to            = m_to.c_str();
+    config.stages        = m_stages;
+    config.blockSize     = m_blockSize;
+    config.normalization = m_normalization;
+    return m_owner->RunPipeline(config, input, output, sourceEncoding);
 }
 
-bool UniConv::ToUtf16BEFromLocale(std::string_view input, std::u16string& output) noexcept {
-    if (input.empty()) { output.clear(); return true; }
-    std::string currentEncoding = GetCurrentSystemEncoding();
-    std::string temp_output;
-    ErrorCode result = ConvertEncodingFast(input, currentEncoding.c_str(), ENC_UTF16BE, temp_output);
-    if (result == ErrorCode::Success && temp_output.size() % 2 == 0) {
-        output = std::u16string(reinterpret_cast<const char16_t*>(temp_output.data()), temp_output.size() / 2);
-        return true;
+ErrorCode UniConv::RunPipeline(const PipelineConfig& config, std::string_view input, std::string& output,
+                               const char** sourceEncoding) noexcept {
+    using Stages = ConversionPipeline;
+    output.clear();
+    if (sourceEncoding) {
+        *sourceEncoding = nullptr;
+    }
+
+    //  阶段 1-2：BOM 与编码检测只看输入开头（检测探测量 = 首块），随后首块就地转换，仍在缓存中
+    const char* from = config.from;
+    const char* to   = config.to;
+    std::string_view payload = input;
+    bool from_bom = false;
+    if (config.stages & Stages::STAGE_STRIP_BOM) {
+        const auto [bom, rest] = DetectAndRemoveBom(input);
+        if (const char* bom_encoding = BomEncodingName(bom)) {
+            from     = bom_encoding;
+            payload  = rest;
+            from_bom = true;
+        }
     }
-    return false;
+    if (!from_bom && (config.stages & Stages::STAGE_DETECT_SOURCE) && !payload.empty()) {
+        if (const char* detected = DetectEncoding(payload, config.blockSize).Best()) {
+            from = detected;
+        }
+    }
+    if (UNICONV_UNLIKELY(!from)) {
+        return payload.empty() ? ErrorCode::Success : ErrorCode::InvalidSourceEncoding;
+    }
+    if (sourceEncoding) {
+        *sourceEncoding = from;
+    }
+    if (payload.empty()) {
+        return ErrorCode::Success;
+    }
+
+    const PairPlan plan = MakePairPlan(from, to);
+    const auto from_id = static_cast<EncodingId>(plan.fromId);
+    const auto to_id   = static_cast<EncodingId>(plan.toId);
+    const bool newlines  = (config.stages & Stages::STAGE_NEWLINES) != 0;
+    const bool strip_nul = (config.stages & Stages::STAGE_STRIP_NUL) != 0;
+    const bool filtering = newlines || strip_nul;
+    const NormalizationForm form = config.normalization;
+    const bool normalizing = form != NormalizationForm::None;
+    PipelineUnitLayout layout = GetPipelineUnitLayout(to_id);
+    if (UNICONV_UNLIKELY((filtering && layout.unit == 0) || (normalizing && to_id != EncodingId::UTF8))) {
+        if (sourceEncoding) {
+            *sourceEncoding = nullptr;
+        }
+        return ErrorCode::InvalidParameter;
+    }
+
+    //  iconv 路线整个流水线只持有一个描述符：窗口之间保留移位状态，结束时统一冲刷
+    IconvLease descriptor;
+    if (plan.route == PairRoute::Iconv) {
+        if (GetApiLayerMode() == ApiLayerMode::Stateless) {
+            iconv_t cd = iconv_open(to, from);
+            if (cd != reinterpret_cast<iconv_t>(-1)) {
+                descriptor = IconvLease::Adopt(static_cast<void*>(cd));
+            }
+        } else {
+            descriptor = GetIconvDescriptorByKey(plan.key, from, to);
+        }
+        if (UNICONV_UNLIKELY(!descriptor)) {
+            return ErrorCode::ConversionFailed;
+        }
+    }
+    const auto cd = static_cast<iconv_t>(descriptor.get());
+    auto fail = [&](ErrorCode ec) noexcept {
+        if (cd) {
+            portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+        }
+        output.clear();
+        if (sourceEncoding) {
+            *sourceEncoding = nullptr;
+        }
+        return ec;
+    };
+
+    const bool native = plan.route == PairRoute::Native || plan.route == PairRoute::Simdutf;
+    size_t pos = 0;
+    size_t written = 0;
+    size_t slack = 0;
+    bool after_cr = false;
+    size_t normalized = 0;                 // [0, normalized) 已是最终结果
+    std::string norm_scratch;              // 只在快速检查未通过时使用
+    std::vector<uint32_t> norm_units;
+    try {
+        output.reserve(EstimateOutputSizeById(payload.size(), plan.fromId, plan.toId));
+        while (pos < payload.size()) {
+            //  阶段 3：当前窗口直接转换到输出尾部；原样复制的路线不报告截断，窗口须落在码元边界上，
+            //  否则后续窗口的过滤会按错位的码元读取
+            size_t window_size = config.blockSize;
+            if (plan.route == PairRoute::Copy && layout.unit > 1 && window_size < payload.size() - pos) {
+                window_size = (std::max)(window_size - window_size % layout.unit, layout.unit);
+            }
+            const std::string_view window = payload.substr(pos, window_size);
+            size_t capacity = MaxOutputSizeById(window.size(), plan.fromId, plan.toId) + slack;
+            if (native) {
+                capacity = (std::max)(capacity, NativeOutputBound(from_id, to_id, window.size()));
+            }
+            if (output.size() < written + capacity) {
+                output.resize(written + capacity);
+            }
+            char* block = &output[written];
+            size_t consumed = 0;
+            size_t produced = 0;
+            ErrorCode ec = ErrorCode::Success;
+            if (cd) {
+#if UNICONV_ENABLE_METRICS
+                const MetricsTimer timer;
+#endif
+                const size_t ascii_prefix = plan.asciiPassthrough ? AsciiPrefixLength(window) : 0;
+                std::memcpy(block, window.data(), ascii_prefix);
+                const char* in_ptr = window.data() + ascii_prefix;
+                size_t in_left = window.size() - ascii_prefix;
+                char* out_ptr = block + ascii_prefix;
+                size_t out_left = capacity - ascii_prefix;
+                if (in_left > 0 &&
+                    portable_iconv(cd, &in_ptr, &in_left, &out_ptr, &out_left) == static_cast<size_t>(-1)) {
+                    ec = IconvErrnoToErrorCode(errno);
+                }
+                consumed = window.size() - in_left;
+                produced = capacity - out_left;
+#if UNICONV_ENABLE_METRICS
+                RecordConversionMetrics(from, to,
+                                        GetApiLayerMode() == ApiLayerMode::Stateless ? ConversionPath::StatelessIconv
+                                                                                     : ConversionPath::Iconv,
+                                        consumed, produced, ec, timer);
+#endif
+            } else {
+                ec = ConvertPlannedInto(plan, from, to, window, block, capacity, consumed, produced);
+            }
+
+            //  阶段 4-5：只改写本窗口刚写出的字节
+            if (filtering && produced > 0) {
+                if (layout.fromBom) {
+                    ResolvePipelineByteOrder(layout, block, produced);
+                }
+                produced = FilterPipelineUnits(layout, block, produced, newlines, strip_nul, after_cr);
+            }
+            written += produced;
+            pos += consumed;
+
+            //  阶段 6：正规化到最后一个边界为止，其后的片段留到下一窗口（可能与后续字符合成）
+            if (normalizing && produced > 0) {
+                size_t end = LastNormBoundary(GetNormData(), reinterpret_cast<const uint8_t*>(output.data()),
+                                              normalized, written, form);
+                if (end > normalized) {
+                    const ErrorCode norm_ec = NormalizeUtf8Range(output, normalized, end, written, form,
+                                                                 norm_scratch, norm_units);
+                    if (UNICONV_UNLIKELY(norm_ec != ErrorCode::Success)) {
+                        return fail(norm_ec);
+                    }
+                    normalized = end;
+                }
+            }
+
+            if (ec == ErrorCode::Success) {
+                slack = 0;
+                continue;
+            }
+            if (ec == ErrorCode::BufferTooSmall) {
+                slack = (consumed == 0) ? (slack * 2 + 64) : 0;
+                continue;
+            }
+            // 窗口末尾被截断的多字节序列：从其起点开始下一个窗口
+            if (ec == ErrorCode::IncompleteSequence && consumed > 0 && pos < payload.size()) {
+                continue;
+            }
+            return fail(ec);
+        }
+
+        if (cd) {
+            if (output.size() < written + 16) {
+                output.resize(written + 16);
+            }
+            char* out_ptr = &output[written];
+            size_t out_left = output.size() - written;
+            portable_iconv(cd, nullptr, nullptr, &out_ptr, &out_left);
+            written = output.size() - out_left;
+            portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+        }
+        if (normalizing && written > normalized) {
+            size_t end = written;
+            const ErrorCode norm_ec = NormalizeUtf8Range(output, normalized, end, written, form,
+                                                         norm_scratch, norm_units);
+            if (UNICONV_UNLIKELY(norm_ec != ErrorCode::Success)) {
+                return fail(norm_ec);
+            }
+        }
+        output.resize(written);
+    } catch (...) {
+        return fail(ErrorCode::OutOfMemory);
+    }
+    return ErrorCode::Success;
 }
 
+StringResult UniConv::ConversionPipeline::Run(std::string_view input) const noexcept {
+    std::string output;
+    const ErrorCode ec = Run(input, output);
+    if (UNICONV_UNLIKELY(ec != ErrorCode::Success)) {
+        return StringResult::Failure(ec);
+    }
+    return StringResult::Success(std::move(output));
+}
@@ -15,6 +15,16 @@
 #include <string>
 #include <vector>
 #include <thread>
+#include <atomic>
+#include <fstream>
+#include <cstdio>
+#include <random>
+#include <chrono>
+#include <future>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <set>
 
 // ============================================================================
 // 测试夹具
@@ -1885,3 +1895,3030 @@ TEST_F(EncodingConversionTest, StringView_ToUtf16BEFromLocale_ConsistencyWithStd
     conv->ToUtf16BEFromLocale(ascii_text, str_output);
     EXPECT_EQ(sv_output, str_output);
 }
+
+// ============================================================================
+// 41. StreamConverter 流式转换（常量内存、任意分块）
+// ============================================================================
+namespace {
+// 以固定分块 + 固定输出缓冲驱动 StreamConverter，返回完整输出
+ErrorCode StreamConvertAll(UniConv::StreamConverter& stream, const std::string& input,
+                           size_t chunk_size, size_t out_cap, std::string& result) {
+    std::vector<char> out(out_cap);
+    result.clear();
+    for (size_t pos = 0; pos < input.size(); pos += chunk_size) {
+        std::string_view pending(input.data() + pos, (std::min)(chunk_size, input.size() - pos));
+        while (!pending.empty()) {
+            size_t consumed = 0, written = 0;
+            ErrorCode ec = stream.Convert(pending, out.data(), out.size(), consumed, written);
+            result.append(out.data(), written);
+            pending.remove_prefix(consumed);
+            if (ec == ErrorCode::BufferTooSmall) continue;
+            if (ec != ErrorCode::Success) return ec;
+        }
+    }
+    size_t written = 0;
+    ErrorCode ec = stream.Finish(out.data(), out.size(), written);
+    result.append(out.data(), written);
+    return ec;
+}
+} // namespace
+
+TEST_F(EncodingConversionTest, Stream_InvalidEncoding) {
+    UniConv::StreamConverter stream("NOT-AN-ENCODING", "UTF-8");
+    EXPECT_FALSE(stream.IsOpen());
+    EXPECT_EQ(stream.GetStatus(), ErrorCode::InvalidSourceEncoding);
+
+    UniConv::StreamConverter null_stream(nullptr, "UTF-8");
+    EXPECT_EQ(null_stream.GetStatus(), ErrorCode::InvalidParameter);
+
+    char out[16];
+    size_t consumed = 0, written = 0;
+    EXPECT_NE(stream.Convert(ascii_text, out, sizeof(out), consumed, written), ErrorCode::Success);
+    EXPECT_EQ(consumed, 0u);
+    EXPECT_EQ(written, 0u);
+}
+
+TEST_F(EncodingConversionTest, Stream_ByteByByte_Utf8ToUtf16LE) {
+    UniConv::StreamConverter stream("UTF-8", "UTF-16LE");
+    ASSERT_TRUE(stream.IsOpen());
+    auto expected = conv->ConvertEncodingFast(full_text, "UTF-8", "UTF-16LE");
+    ASSERT_TRUE(expected.IsSuccess());
+
+    std::string result;
+    ASSERT_EQ(StreamConvertAll(stream, full_text, 1, 64, result), ErrorCode::Success);
+    EXPECT_EQ(result, expected.GetValue());
+    EXPECT_EQ(stream.GetTotalBytesIn(), full_text.size());
+    EXPECT_EQ(stream.GetTotalBytesOut(), result.size());
+}
+
+TEST_F(EncodingConversionTest, Stream_PendingCarriedAcrossChunks) {
+    UniConv::StreamConverter stream("UTF-8", "UTF-16LE");
+    ASSERT_TRUE(stream.IsOpen());
+    char out[16];
+    size_t consumed = 0, written = 0;
+
+    // 😀 = F0 9F 98 80，先喂前 2 字节
+    ASSERT_EQ(stream.Convert(std::string_view("\xf0\x9f", 2), out, sizeof(out), consumed, written), ErrorCode::Success);
+    EXPECT_EQ(consumed, 2u);
+    EXPECT_EQ(written, 0u);
+    EXPECT_EQ(stream.GetPendingBytes(), 2u);
+
+    ASSERT_EQ(stream.Convert(std::string_view("\x98\x80" "A", 3), out, sizeof(out), consumed, written), ErrorCode::Success);
+    EXPECT_EQ(consumed, 3u);
+    EXPECT_EQ(stream.GetPendingBytes(), 0u);
+    ASSERT_EQ(written, 6u);
+    EXPECT_EQ(std::string(out, written), std::string("\x3d\xd8\x00\xde" "A\x00", 6));
+}
+
+TEST_F(EncodingConversionTest, Stream_PendingGrowsOverSeveralChunks) {
+    // GB18030 四字节序列与 UTF-16 代理对逐字节送入：遗留字节跨多次调用累积后再补全
+    const std::string text = "a\xF0\x9F\x98\x80\xE4\xB8\xAD\xC2\x80" + emoji_text + "z";
+    for (const char* encoding : {"GB18030", "UTF-16LE", "UTF-32BE"}) {
+        SCOPED_TRACE(encoding);
+        const auto input = conv->ConvertEncodingFast(text, "UTF-8", encoding);
+        ASSERT_TRUE(input.IsSuccess());
+        for (size_t out_cap : {4u, 6u, 64u}) {
+            UniConv::StreamConverter stream(encoding, "UTF-8");
+            std::string result;
+            ASSERT_EQ(StreamConvertAll(stream, input.GetValue(), 1, out_cap, result), ErrorCode::Success) << out_cap;
+            EXPECT_EQ(result, text) << out_cap;
+            EXPECT_EQ(stream.GetTotalBytesIn(), input.GetValue().size());
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, Stream_ResetRestoresInitialShiftState) {
+    UniConv::StreamConverter stream("ISO-2022-JP", "UTF-8");
+    ASSERT_TRUE(stream.IsOpen());
+    char out[64];
+    size_t consumed = 0, written = 0;
+    // ESC $ B 切换到 JIS X 0208，"$\"" 为「あ」
+    ASSERT_EQ(stream.Convert(std::string_view("\x1B$B$\"", 5), out, sizeof(out), consumed, written), ErrorCode::Success);
+    EXPECT_EQ(std::string(out, written), "\xE3\x81\x82");
+
+    // 复位后回到 ASCII 状态：同样的字节不再按双字节解释
+    stream.Reset();
+    ASSERT_EQ(stream.Convert(std::string_view("$\"", 2), out, sizeof(out), consumed, written), ErrorCode::Success);
+    EXPECT_EQ(std::string(out, written), "$\"");
+}
+
+TEST_F(EncodingConversionTest, Stream_TinyOutputBuffer_Utf8ToGBK) {
+    UniConv::StreamConverter stream("UTF-8", "GBK");
+    ASSERT_TRUE(stream.IsOpen());
+    auto expected = conv->ConvertEncodingFast(mixed_text, "UTF-8", "GBK");
+    ASSERT_TRUE(expected.IsSuccess());
+
+    std::string result;
+    ASSERT_EQ(StreamConvertAll(stream, mixed_text, 5, 2, result), ErrorCode::Success);
+    EXPECT_EQ(result, expected.GetValue());
+}
+
+TEST_F(EncodingConversionTest, Stream_BeyondTenMegabytes) {
+    // 超过 ConvertEncodingFast 的 10MB 输出上限，分块大小刻意切断多字节序列
+    std::string input;
+    input.reserve(12 * 1024 * 1024);
+    while (input.size() < 12 * 1024 * 1024) input += chinese_text;
+
+    UniConv::StreamConverter stream("UTF-8", "UTF-16LE");
+    ASSERT_TRUE(stream.IsOpen());
+    std::vector<char> out(4096);
+    uint64_t total_out = 0;
+    std::string tail;
+    for (size_t pos = 0; pos < input.size(); pos += 65537) {
+        std::string_view pending(input.data() + pos, (std::min)(static_cast<size_t>(65537), input.size() - pos));
+        while (!pending.empty()) {
+            size_t consumed = 0, written = 0;
+            ErrorCode ec = stream.Convert(pending, out.data(), out.size(), consumed, written);
+            ASSERT_TRUE(ec == ErrorCode::Success || ec == ErrorCode::BufferTooSmall);
+            total_out += written;
+            if (written >= 8) tail.assign(out.data() + written - 8, 8);
+            pending.remove_prefix(consumed);
+        }
+    }
+    size_t written = 0;
+    EXPECT_EQ(stream.Finish(out.data(), out.size(), written), ErrorCode::Success);
+
+    // 每个汉字 3 字节 UTF-8 -> 2 字节 UTF-16LE
+    EXPECT_EQ(total_out, input.size() / 3 * 2);
+    EXPECT_EQ(stream.GetTotalBytesIn(), input.size());
+    EXPECT_EQ(tail, std::string("\x60\x4f\x7d\x59\x16\x4e\x4c\x75", 8));  // 你好世界
+}
+
+TEST_F(EncodingConversionTest, Stream_TruncatedTail_FinishReportsIncomplete) {
+    UniConv::StreamConverter stream("UTF-8", "UTF-16LE");
+    char out[64];
+    size_t consumed = 0, written = 0;
+    ASSERT_EQ(stream.Convert(std::string_view("Hi\xe4\xbd", 4), out, sizeof(out), consumed, written), ErrorCode::Success);
+    EXPECT_EQ(consumed, 4u);
+    EXPECT_EQ(written, 4u);
+    EXPECT_EQ(stream.Finish(out, sizeof(out), written), ErrorCode::IncompleteSequence);
+
+    stream.Reset();
+    EXPECT_EQ(stream.GetPendingBytes(), 0u);
+    EXPECT_EQ(stream.GetTotalBytesIn(), 0u);
+    EXPECT_EQ(stream.Finish(out, sizeof(out), written), ErrorCode::Success);
+}
+
+TEST_F(EncodingConversionTest, Stream_InvalidSequence_ReportsOffset) {
+    UniConv::StreamConverter stream("UTF-8", "UTF-16LE");
+    char out[64];
+    size_t consumed = 0, written = 0;
+    EXPECT_EQ(stream.Convert(std::string_view("AB\xff" "CD", 5), out, sizeof(out), consumed, written),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(consumed, 2u);
+    EXPECT_EQ(written, 4u);
+}
+
+// ============================================================================
+// 42. ConvertFile 文件到文件转换（内存映射）
+// ============================================================================
+namespace {
+std::string TempFilePath(const char* name) {
+    return ::testing::TempDir() + "uniconv_" + name;
+}
+
+void WriteBinaryFile(const std::string& path, const std::string& data) {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+std::string ReadBinaryFile(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+}
+
+bool FileExists(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return ifs.good();
+}
+} // namespace
+
+TEST_F(EncodingConversionTest, File_Utf8ToGBK_MatchesInMemory) {
+    std::string input;
+    for (int i = 0; i < 50000; ++i) input += mixed_text;   // > 1MB 写块
+    const std::string in_path  = TempFilePath("file_utf8.txt");
+    const std::string out_path = TempFilePath("file_gbk.txt");
+    WriteBinaryFile(in_path, input);
+
+    ASSERT_EQ(conv->ConvertFile(in_path, "UTF-8", "GBK", out_path), ErrorCode::Success);
+
+    std::string expected;
+    ASSERT_EQ(conv->ConvertEncodingFast(input, "UTF-8", "GBK", expected), ErrorCode::Success);
+    EXPECT_EQ(ReadBinaryFile(out_path), expected);
+
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+}
+
+TEST_F(EncodingConversionTest, File_BomDetectedAndStripped) {
+    auto utf16 = conv->ConvertEncodingFast(chinese_text, "UTF-8", "UTF-16LE");
+    ASSERT_TRUE(utf16.IsSuccess());
+    const std::string in_path  = TempFilePath("file_bom.txt");
+    const std::string out_path = TempFilePath("file_bom_out.txt");
+    WriteBinaryFile(in_path, std::string("\xff\xfe", 2) + utf16.GetValue());
+
+    // BOM 优先于声明的源编码
+    ASSERT_EQ(conv->ConvertFile(in_path, "UTF-8", "UTF-8", out_path), ErrorCode::Success);
+    EXPECT_EQ(ReadBinaryFile(out_path), chinese_text);
+
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+}
+
+TEST_F(EncodingConversionTest, File_EmptyInput) {
+    const std::string in_path  = TempFilePath("file_empty.txt");
+    const std::string out_path = TempFilePath("file_empty_out.txt");
+    WriteBinaryFile(in_path, "");
+
+    ASSERT_EQ(conv->ConvertFile(in_path, "UTF-8", "UTF-16LE", out_path), ErrorCode::Success);
+    EXPECT_TRUE(FileExists(out_path));
+    EXPECT_TRUE(ReadBinaryFile(out_path).empty());
+
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+}
+
+TEST_F(EncodingConversionTest, File_NotFound) {
+    EXPECT_EQ(conv->ConvertFile(TempFilePath("does_not_exist.txt"), "UTF-8", "GBK", TempFilePath("nowhere.txt")),
+              ErrorCode::FileNotFound);
+    EXPECT_EQ(conv->ConvertFile("", "UTF-8", "GBK", TempFilePath("nowhere.txt")), ErrorCode::InvalidParameter);
+}
+
+TEST_F(EncodingConversionTest, File_InvalidInput_RemovesPartialOutput) {
+    const std::string in_path  = TempFilePath("file_invalid.txt");
+    const std::string out_path = TempFilePath("file_invalid_out.txt");
+    WriteBinaryFile(in_path, std::string("Hello\xff\xfe World", 13));
+
+    EXPECT_EQ(conv->ConvertFile(in_path, "UTF-8", "UTF-16LE", out_path), ErrorCode::InvalidSequence);
+    EXPECT_FALSE(FileExists(out_path));
+
+    std::remove(in_path.c_str());
+}
+
+TEST_F(EncodingConversionTest, File_SameInputAndOutput_Rejected) {
+    std::string input;
+    for (int i = 0; i < 20000; ++i) input += mixed_text;
+    const std::string in_path = TempFilePath("file_same.txt");
+    WriteBinaryFile(in_path, input);
+
+    // 输出就是输入时截断会使映射失效：拒绝且不改动文件
+    EXPECT_EQ(conv->ConvertFile(in_path, "UTF-8", "UTF-16LE", in_path), ErrorCode::InvalidParameter);
+    EXPECT_EQ(conv->ConvertFile(in_path, "UTF-8", "UTF-8", in_path), ErrorCode::InvalidParameter);
+    EXPECT_EQ(ReadBinaryFile(in_path), input);
+#ifndef _WIN32
+    const std::string link_path = TempFilePath("file_same_link.txt");
+    std::remove(link_path.c_str());
+    ASSERT_EQ(::link(in_path.c_str(), link_path.c_str()), 0);
+    EXPECT_EQ(conv->ConvertFile(in_path, "UTF-8", "GBK", link_path), ErrorCode::InvalidParameter);
+    EXPECT_EQ(ReadBinaryFile(in_path), input);
+    std::remove(link_path.c_str());
+#endif
+
+    std::remove(in_path.c_str());
+}
+
+// ============================================================================
+// 43. ConvertEncodingParallel 单缓冲区分块并行转换
+// ============================================================================
+namespace {
+std::string RepeatToSize(const std::string& unit, size_t min_size) {
+    std::string out;
+    out.reserve(min_size + unit.size());
+    while (out.size() < min_size) out += unit;
+    return out;
+}
+} // namespace
+
+TEST_F(EncodingConversionTest, ChunkParallel_Utf8ToUtf16LE_MatchesSerial) {
+    const std::string input = RepeatToSize(full_text + mixed_text + emoji_text, 2 * 1024 * 1024);
+    std::string serial;
+    ASSERT_EQ(conv->ConvertEncodingFast(input, "UTF-8", "UTF-16LE", serial), ErrorCode::Success);
+
+    std::string parallel;
+    ASSERT_EQ(conv->ConvertEncodingParallel(input, "UTF-8", "UTF-16LE", parallel, 4), ErrorCode::Success);
+    EXPECT_EQ(parallel, serial);
+}
+
+TEST_F(EncodingConversionTest, ChunkParallel_Utf16LEToUtf8_SurrogatePairs) {
+    auto utf16 = conv->ConvertEncodingFast(RepeatToSize(emoji_text + chinese_text, 1536 * 1024), "UTF-8", "UTF-16LE");
+    ASSERT_TRUE(utf16.IsSuccess());
+
+    auto serial   = conv->ConvertEncodingFast(utf16.GetValue(), "UTF-16LE", "UTF-8");
+    auto parallel = conv->ConvertEncodingParallel(utf16.GetValue(), "UTF-16LE", "UTF-8", 7);
+    ASSERT_TRUE(serial.IsSuccess());
+    ASSERT_TRUE(parallel.IsSuccess());
+    EXPECT_EQ(parallel.GetValue(), serial.GetValue());
+}
+
+TEST_F(EncodingConversionTest, ChunkParallel_GBKToUtf8_LeadTrailBoundaries) {
+    // 无换行/空格的纯双字节文本也必须能找到分割点（或安全退化为少分块）
+    auto gbk_dense = conv->ConvertEncodingFast(RepeatToSize(chinese_text, 1024 * 1024), "UTF-8", "GBK");
+    auto gbk_mixed = conv->ConvertEncodingFast(RepeatToSize(mixed_text + "\n", 1024 * 1024), "UTF-8", "GBK");
+    ASSERT_TRUE(gbk_dense.IsSuccess());
+    ASSERT_TRUE(gbk_mixed.IsSuccess());
+
+    for (const std::string* gbk : {&gbk_dense.GetValue(), &gbk_mixed.GetValue()}) {
+        std::string serial, parallel;
+        ASSERT_EQ(conv->ConvertEncodingFast(*gbk, "GBK", "UTF-8", serial), ErrorCode::Success);
+        ASSERT_EQ(conv->ConvertEncodingParallel(*gbk, "GBK", "UTF-8", parallel, 4), ErrorCode::Success);
+        EXPECT_EQ(parallel, serial);
+    }
+}
+
+TEST_F(EncodingConversionTest, ChunkParallel_BeyondTenMegabytes) {
+    // UTF-8 -> UTF-32LE 输出超过 ConvertEncodingFast 的 10MB 上限
+    const std::string input = RepeatToSize(full_text, 4 * 1024 * 1024);
+    std::string utf32;
+    ASSERT_EQ(conv->ConvertEncodingParallel(input, "UTF-8", "UTF-32LE", utf32, 4), ErrorCode::Success);
+    EXPECT_GT(utf32.size(), 10u * 1024 * 1024);
+    EXPECT_EQ(utf32.size() % 4, 0u);
+
+    std::string back;
+    ASSERT_EQ(conv->ConvertEncodingParallel(utf32, "UTF-32LE", "UTF-8", back, 4), ErrorCode::Success);
+    EXPECT_EQ(back, input);
+}
+
+TEST_F(EncodingConversionTest, ChunkParallel_InvalidSequenceReported) {
+    std::string input = RepeatToSize(chinese_text, 2 * 1024 * 1024);
+    input[input.size() / 2 + 1] = '\xff';
+    std::string output;
+    EXPECT_EQ(conv->ConvertEncodingParallel(input, "UTF-8", "UTF-16LE", output, 4), ErrorCode::InvalidSequence);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST_F(EncodingConversionTest, ChunkParallel_SmallInputAndErrors) {
+    auto result = conv->ConvertEncodingParallel(chinese_text, "UTF-8", "UTF-16LE");
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(result.GetValue(), conv->ConvertEncodingFast(chinese_text, "UTF-8", "UTF-16LE").GetValue());
+
+    EXPECT_EQ(conv->ConvertEncodingParallel(chinese_text, nullptr, "UTF-8").GetErrorCode(), ErrorCode::InvalidParameter);
+    EXPECT_EQ(conv->ConvertEncodingParallel(chinese_text, "UTF-8", "NOT-AN-ENCODING").GetErrorCode(),
+              ErrorCode::InvalidTargetEncoding);
+}
+
+// ============================================================================
+// 44. iconv 描述符线程独占（线程私有热路径 + 全局空闲池冷路径）
+// ============================================================================
+TEST_F(EncodingConversionTest, DescriptorOwnership_RepeatedConversionSkipsSharedPool) {
+    // 首次调用可能签出或新建描述符，之后同线程的重复转换只命中线程私有缓存
+    ASSERT_TRUE(conv->ConvertEncodingFast(chinese_text, "UTF-8", "GB18030").IsSuccess());
+    const auto before = conv->GetPoolStatistics();
+
+    for (int i = 0; i < 100; ++i) {
+        auto result = conv->ConvertEncodingFast(chinese_text, "UTF-8", "GB18030");
+        ASSERT_TRUE(result.IsSuccess());
+    }
+
+    const auto after = conv->GetPoolStatistics();
+    EXPECT_EQ(after.iconv_cache_misses, before.iconv_cache_misses);
+    EXPECT_EQ(after.iconv_cache_hits, before.iconv_cache_hits);
+}
+
+TEST_F(EncodingConversionTest, DescriptorOwnership_ConcurrentMixedPairsConsistent) {
+    // 对数超过线程私有缓存容量（32），迫使描述符在线程缓存与全局池之间反复流转
+    const std::vector<const char*> targets = {
+        "UTF-16LE", "UTF-16BE", "UTF-32LE", "UTF-32BE", "GBK", "GB18030", "BIG5", "UTF-32",
+        "utf-16le", "utf-16be", "utf-32le", "utf-32be", "gbk", "gb18030", "big5", "GB2312",
+        "UTF-16", "utf16le", "utf16be", "utf32le", "utf32be", "gb2312", "Big5", "EUC-CN", "euc-cn",
+        "utf16", "utf32", "UTF16", "UTF32", "utf-16", "utf-32", "euccn", "EUCCN"
+    };
+    const std::string input = mixed_text + chinese_text;
+
+    std::vector<std::string> expected;
+    for (const char* target : targets) {
+        auto encoded = conv->ConvertEncodingFast(input, "UTF-8", target);
+        ASSERT_TRUE(encoded.IsSuccess()) << target;
+        expected.push_back(encoded.GetValue());
+    }
+
+    constexpr int kThreads = 8;
+    constexpr int kRounds  = 20;
+    std::vector<int> failures(kThreads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int round = 0; round < kRounds; ++round) {
+                for (size_t i = 0; i < targets.size(); ++i) {
+                    const size_t idx = (i + static_cast<size_t>(t)) % targets.size();
+                    auto encoded = conv->ConvertEncodingFast(input, "UTF-8", targets[idx]);
+                    if (!encoded.IsSuccess() || encoded.GetValue() != expected[idx]) {
+                        ++failures[t];
+                        continue;
+                    }
+                    auto decoded = conv->ConvertEncodingFast(encoded.GetValue(), targets[idx], "UTF-8");
+                    if (!decoded.IsSuccess() || decoded.GetValue() != input) {
+                        ++failures[t];
+                    }
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    for (int t = 0; t < kThreads; ++t) {
+        EXPECT_EQ(failures[t], 0) << "thread " << t;
+    }
+    EXPECT_LE(conv->GetPoolStatistics().iconv_cache_size, 128u);
+}
+
+// ============================================================================
+// 45. 内置 SIMD UTF 内核（ASCII 块向量化 + 严格校验的标量编解码）
+// ============================================================================
+namespace {
+struct UtfForms {
+    std::string utf8, utf16le, utf16be, utf32le, utf32be;
+};
+
+void AppendUnit(std::string& out, uint32_t value, int bytes, bool big_endian) {
+    for (int k = 0; k < bytes; ++k) {
+        const int shift = 8 * (big_endian ? bytes - 1 - k : k);
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+// 参考编码器：与被测实现无关，直接按定义生成各编码形式
+UtfForms EncodeCodePoints(const std::vector<uint32_t>& code_points) {
+    UtfForms forms;
+    for (uint32_t cp : code_points) {
+        if (cp < 0x80) {
+            forms.utf8.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            forms.utf8.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            forms.utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            forms.utf8.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            forms.utf8.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            forms.utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            forms.utf8.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            forms.utf8.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            forms.utf8.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            forms.utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        if (cp >= 0x10000) {
+            const uint32_t v = cp - 0x10000;
+            for (bool be : {false, true}) {
+                std::string& out = be ? forms.utf16be : forms.utf16le;
+                AppendUnit(out, 0xD800 | (v >> 10), 2, be);
+                AppendUnit(out, 0xDC00 | (v & 0x3FF), 2, be);
+            }
+        } else {
+            AppendUnit(forms.utf16le, cp, 2, false);
+            AppendUnit(forms.utf16be, cp, 2, true);
+        }
+        AppendUnit(forms.utf32le, cp, 4, false);
+        AppendUnit(forms.utf32be, cp, 4, true);
+    }
+    return forms;
+}
+
+// ASCII 长短游程与 2/3/4 字节码点交错，覆盖向量块边界
+std::vector<uint32_t> RandomCodePoints(std::mt19937& rng, size_t count) {
+    std::vector<uint32_t> cps;
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::uniform_int_distribution<int> run(0, 80);
+    while (cps.size() < count) {
+        switch (kind(rng)) {
+            case 0: case 1: case 2: case 3: {
+                const int n = run(rng);
+                for (int k = 0; k < n; ++k) cps.push_back(0x20 + static_cast<uint32_t>(rng() % 0x5F));
+                break;
+            }
+            case 4: cps.push_back(0x80 + static_cast<uint32_t>(rng() % 0x780)); break;
+            case 5: cps.push_back(0x800 + static_cast<uint32_t>(rng() % 0xD000)); break;
+            case 6: cps.push_back(0xE000 + static_cast<uint32_t>(rng() % 0x2000)); break;
+            case 7: cps.push_back(0x10000 + static_cast<uint32_t>(rng() % 0x100000)); break;
+            default: cps.push_back(static_cast<uint32_t>(rng() % 0x80)); break;
+        }
+    }
+    return cps;
+}
+} // namespace
+
+TEST_F(EncodingConversionTest, NativeUtf_RandomTextMatchesReference) {
+    std::mt19937 rng(20260114);
+    for (size_t count : {1u, 15u, 16u, 17u, 31u, 32u, 33u, 64u, 257u, 4099u}) {
+        const UtfForms forms = EncodeCodePoints(RandomCodePoints(rng, count));
+        const std::pair<const char*, const std::string*> targets[] = {
+            {"UTF-16LE", &forms.utf16le}, {"UTF-16BE", &forms.utf16be}, {"UTF-32LE", &forms.utf32le}};
+        for (const auto& [name, expected] : targets) {
+            auto encoded = conv->ConvertEncodingFast(forms.utf8, "UTF-8", name);
+            ASSERT_TRUE(encoded.IsSuccess()) << name << " count=" << count;
+            EXPECT_EQ(encoded.GetValue(), *expected) << name << " count=" << count;
+
+            std::string decoded;
+            ASSERT_EQ(conv->ConvertEncodingFast(std::string_view(*expected), name, "UTF-8", decoded), ErrorCode::Success);
+            EXPECT_EQ(decoded, forms.utf8) << name << " count=" << count;
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, NativeUtf_PureAsciiBlocks) {
+    std::string ascii;
+    for (int i = 0; i < 1000; ++i) ascii.push_back(static_cast<char>(0x20 + i % 0x5F));
+    const UtfForms forms = EncodeCodePoints(std::vector<uint32_t>(ascii.begin(), ascii.end()));
+
+    std::string out;
+    ASSERT_EQ(conv->ConvertEncodingFast(ascii, "UTF-8", "UTF-16BE", out), ErrorCode::Success);
+    EXPECT_EQ(out, forms.utf16be);
+    ASSERT_EQ(conv->ConvertEncodingFast(forms.utf32le, "UTF-32LE", "UTF-8", out), ErrorCode::Success);
+    EXPECT_EQ(out, ascii);
+    ASSERT_EQ(conv->ConvertEncodingFast(forms.utf16be, "UTF-16BE", "UTF-8", out), ErrorCode::Success);
+    EXPECT_EQ(out, ascii);
+}
+
+TEST_F(EncodingConversionTest, NativeUtf_InvalidUtf8Rejected) {
+    const std::string prefix(100, 'a');  // 先走向量块，再在标量路径遇到错误
+    const std::pair<std::string, ErrorCode> cases[] = {
+        {"\xC0\x80", ErrorCode::InvalidSequence},          // 过长编码
+        {"\xE0\x80\x80", ErrorCode::InvalidSequence},      // 过长编码
+        {"\xED\xA0\x80", ErrorCode::InvalidSequence},      // 代理项 U+D800
+        {"\xF4\x90\x80\x80", ErrorCode::InvalidSequence},  // 超出 U+10FFFF
+        {"\x80", ErrorCode::InvalidSequence},              // 孤立续字节
+        {"\xE4\xBD", ErrorCode::IncompleteSequence},       // 末尾截断
+    };
+    for (const auto& [bytes, expected] : cases) {
+        for (const char* target : {"UTF-16LE", "UTF-16BE", "UTF-32LE"}) {
+            auto result = conv->ConvertEncodingFast(prefix + bytes, "UTF-8", target);
+            EXPECT_EQ(result.GetErrorCode(), expected) << target;
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, NativeUtf_InvalidUtf16AndUtf32Rejected) {
+    std::string lone_low = std::string(64, 'a');
+    lone_low = EncodeCodePoints(std::vector<uint32_t>(lone_low.begin(), lone_low.end())).utf16le;
+    std::string with_low = lone_low + std::string("\x00\xDC", 2);
+    EXPECT_EQ(conv->ConvertEncodingFast(with_low, "UTF-16LE", "UTF-8").GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(lone_low + std::string("\x00\xD8", 2), "UTF-16LE", "UTF-8").GetErrorCode(),
+              ErrorCode::IncompleteSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string("\xD8\x00\x00\x41", 4), "UTF-16BE", "UTF-8").GetErrorCode(),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(lone_low + "a", "UTF-16LE", "UTF-8").GetErrorCode(),
+              ErrorCode::IncompleteSequence);
+
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string("\x00\x00\x11\x00", 4), "UTF-32LE", "UTF-8").GetErrorCode(),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string("\x00\xD8\x00\x00", 4), "UTF-32LE", "UTF-8").GetErrorCode(),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string("A\x00\x00\x00" "B", 5), "UTF-32LE", "UTF-8").GetErrorCode(),
+              ErrorCode::IncompleteSequence);
+}
+
+TEST_F(EncodingConversionTest, NativeUtf_AllPairsMatchReference) {
+    std::mt19937 rng(20260115);
+    for (size_t count : {7u, 16u, 33u, 100u, 2049u}) {
+        const UtfForms forms = EncodeCodePoints(RandomCodePoints(rng, count));
+        const std::pair<const char*, const std::string*> encodings[] = {
+            {"UTF-8", &forms.utf8}, {"UTF-16LE", &forms.utf16le}, {"UTF-16BE", &forms.utf16be},
+            {"UTF-32LE", &forms.utf32le}, {"UTF-32BE", &forms.utf32be}};
+        for (const auto& [from, input] : encodings) {
+            for (const auto& [to, expected] : encodings) {
+                std::string output;
+                ASSERT_EQ(conv->ConvertEncodingFast(*input, from, to, output), ErrorCode::Success)
+                    << from << " -> " << to << " count=" << count;
+                EXPECT_EQ(output, *expected) << from << " -> " << to << " count=" << count;
+            }
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, NativeUtf_BmpOnlyWideBlocks) {
+    // 纯 BMP（无代理项）文本走 UTF-16/32 之间的向量块内核
+    std::vector<uint32_t> cps;
+    for (uint32_t i = 0; i < 5000; ++i) cps.push_back(0x4E00 + (i * 7) % 0x5000);
+    const UtfForms forms = EncodeCodePoints(cps);
+
+    std::string out;
+    ASSERT_EQ(conv->ConvertEncodingFast(forms.utf16le, "UTF-16LE", "UTF-16BE", out), ErrorCode::Success);
+    EXPECT_EQ(out, forms.utf16be);
+    ASSERT_EQ(conv->ConvertEncodingFast(forms.utf16be, "UTF-16BE", "UTF-32LE", out), ErrorCode::Success);
+    EXPECT_EQ(out, forms.utf32le);
+    ASSERT_EQ(conv->ConvertEncodingFast(forms.utf32le, "UTF-32LE", "UTF-16BE", out), ErrorCode::Success);
+    EXPECT_EQ(out, forms.utf16be);
+    ASSERT_EQ(conv->ConvertEncodingFast(forms.utf32be, "UTF-32BE", "UTF-32LE", out), ErrorCode::Success);
+    EXPECT_EQ(out, forms.utf32le);
+}
+
+TEST_F(EncodingConversionTest, NativeUtf_TypedWrappersMatchReference) {
+    std::mt19937 rng(20260116);
+    const UtfForms forms = EncodeCodePoints(RandomCodePoints(rng, 3000));
+    auto as_u16 = [](const std::string& bytes) {
+        return std::u16string(reinterpret_cast<const char16_t*>(bytes.data()), bytes.size() / 2);
+    };
+    auto as_u32 = [](const std::string& bytes) {
+        return std::u32string(reinterpret_cast<const char32_t*>(bytes.data()), bytes.size() / 4);
+    };
+    const std::u16string u16le = as_u16(forms.utf16le);
+    const std::u16string u16be = as_u16(forms.utf16be);
+    const std::u32string u32le = as_u32(forms.utf32le);
+
+    EXPECT_EQ(conv->ToUtf32LEFromUtf8(forms.utf8), u32le);
+    EXPECT_EQ(conv->ToUtf16BEFromUtf32LE(u32le), u16be);
+    EXPECT_EQ(conv->ToUtf16LEFromUtf32LE(u32le), u16le);
+    EXPECT_EQ(conv->ToUtf32LEFromUtf16BE(u16be), u32le);
+    EXPECT_EQ(conv->ToUtf16LEFromUtf16BE(u16be), u16le);
+    EXPECT_EQ(conv->ToUtf8FromUtf16BE(u16be.data(), u16be.size()), forms.utf8);
+    EXPECT_EQ(conv->ToUtf8FromUtf32LEEx(u32le).GetValue(), forms.utf8);
+    EXPECT_EQ(conv->ToUtf16BEFromUtf16LEEx(u16le).GetValue(), u16be);
+
+    std::u32string u32_out;
+    ASSERT_TRUE(conv->ToUtf32LEFromUtf16LE(u16le, u32_out));
+    EXPECT_EQ(u32_out, u32le);
+    std::u16string u16_out;
+    ASSERT_TRUE(conv->ToUtf16BEFromUtf8(std::string_view(forms.utf8), u16_out));
+    EXPECT_EQ(u16_out, u16be);
+}
+
+TEST_F(EncodingConversionTest, NativeUtf_WideToWideInvalidRejected) {
+    const std::string lone_low("\x00\xDC" "A\x00", 4);
+    EXPECT_EQ(conv->ConvertEncodingFast(lone_low, "UTF-16LE", "UTF-16BE").GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(lone_low, "UTF-16LE", "UTF-32BE").GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string("\xD8\x3D", 2), "UTF-16BE", "UTF-32LE").GetErrorCode(),
+              ErrorCode::IncompleteSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string("\x00\x11\x00\x00", 4), "UTF-32BE", "UTF-16LE").GetErrorCode(),
+              ErrorCode::InvalidSequence);
+
+    // 合法块之后出现非法码点：向量内核必须在该块停下交给标量校验
+    std::vector<uint32_t> cps(64, 0x4E2D);
+    UtfForms forms = EncodeCodePoints(cps);
+    forms.utf32le += std::string("\x00\xD8\x00\x00", 4);
+    EXPECT_EQ(conv->ConvertEncodingFast(forms.utf32le, "UTF-32LE", "UTF-32BE").GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_TRUE(conv->ToUtf16LEFromUtf32LE(std::u32string(64, U'\x110000')).empty());
+}
+
+// ============================================================================
+// 46. 无状态 string_view 快速路径：不复制输入，复用调用方缓冲区
+// ============================================================================
+
+TEST_F(EncodingConversionTest, StatelessFast_ReusesOutputCapacity) {
+    std::mt19937 rng(46);
+    const UtfForms forms = EncodeCodePoints(RandomCodePoints(rng, 4096));
+
+    const struct { const std::string* input; const char* from; const char* to; const std::string* expected; } cases[] = {
+        {&forms.utf8,    "UTF-8",    "UTF-16LE", &forms.utf16le},
+        {&forms.utf16le, "UTF-16LE", "UTF-8",    &forms.utf8},
+        {&forms.utf8,    "UTF-8",    "UTF-16BE", &forms.utf16be},
+        {&forms.utf16be, "UTF-16BE", "UTF-8",    &forms.utf8},
+        {&forms.utf8,    "UTF-8",    "UTF-32LE", &forms.utf32le},
+    };
+
+    for (const auto& c : cases) {
+        std::string output;
+        const std::string_view input(*c.input);
+        ASSERT_EQ(conv->ConvertEncodingStatelessFast(input, c.from, c.to, output), ErrorCode::Success)
+            << c.from << " -> " << c.to;
+        ASSERT_EQ(output, *c.expected) << c.from << " -> " << c.to;
+
+        // 稳态复用：同一 output 反复转换不应重新分配（缓冲区地址与容量不变）
+        const char* buffer = output.data();
+        const size_t capacity = output.capacity();
+        for (int round = 0; round < 16; ++round) {
+            ASSERT_EQ(conv->ConvertEncodingStatelessFast(input, c.from, c.to, output), ErrorCode::Success);
+            EXPECT_EQ(output.data(), buffer) << c.from << " -> " << c.to;
+            EXPECT_EQ(output.capacity(), capacity) << c.from << " -> " << c.to;
+        }
+        EXPECT_EQ(output, *c.expected) << c.from << " -> " << c.to;
+    }
+}
+
+TEST_F(EncodingConversionTest, StatelessFast_FailureClearsReusedOutput) {
+    std::string output;
+    ASSERT_EQ(conv->ConvertEncodingStatelessFast(std::string_view("\xE4\xB8\xAD\xE6\x96\x87"), "UTF-8", "UTF-16LE", output),
+              ErrorCode::Success);
+    EXPECT_EQ(output.size(), 4u);
+
+    EXPECT_EQ(conv->ConvertEncodingStatelessFast(std::string_view("\xE4\xB8\xAD\xFF"), "UTF-8", "UTF-16LE", output),
+              ErrorCode::InvalidSequence);
+    EXPECT_TRUE(output.empty());
+    EXPECT_EQ(conv->ConvertEncodingStatelessFast(std::string_view("A\x00\x42", 3), "UTF-16LE", "UTF-8", output),
+              ErrorCode::IncompleteSequence);
+    EXPECT_TRUE(output.empty());
+}
+
+// ============================================================================
+// 47. 调用方缓冲区转换 ConvertInto / MaxOutputSize
+// ============================================================================
+
+TEST_F(EncodingConversionTest, ConvertInto_MaxOutputSizeBufferMatchesFast) {
+    std::mt19937 rng(47);
+    const UtfForms forms = EncodeCodePoints(RandomCodePoints(rng, 2048));
+    const std::pair<const char*, const std::string*> utf[] = {
+        {"UTF-8", &forms.utf8}, {"UTF-16LE", &forms.utf16le}, {"UTF-16BE", &forms.utf16be},
+        {"UTF-32LE", &forms.utf32le}, {"UTF-32BE", &forms.utf32be},
+    };
+
+    std::vector<char> buffer;
+    for (const auto& [from, input] : utf) {
+        for (const auto& [to, expected] : utf) {
+            buffer.assign(UniConv::MaxOutputSize(input->size(), from, to), '\0');
+            size_t consumed = 0, written = 0;
+            ASSERT_EQ(conv->ConvertInto(*input, from, to, buffer.data(), buffer.size(), consumed, written),
+                      ErrorCode::Success) << from << " -> " << to;
+            EXPECT_EQ(consumed, input->size());
+            EXPECT_EQ(std::string(buffer.data(), written), *expected) << from << " -> " << to;
+        }
+    }
+
+    const std::string gbk = conv->ConvertEncodingFast(chinese_text, "UTF-8", "GBK").GetValue();
+    buffer.assign(UniConv::MaxOutputSize(gbk.size(), "GBK", "UTF-8"), '\0');
+    size_t consumed = 0, written = 0;
+    ASSERT_EQ(conv->ConvertInto(gbk, "GBK", "UTF-8", buffer.data(), buffer.size(), consumed, written),
+              ErrorCode::Success);
+    EXPECT_EQ(std::string(buffer.data(), written), chinese_text);
+}
+
+TEST_F(EncodingConversionTest, ConvertInto_SmallBufferResumesAtCharBoundary) {
+    std::string utf8;
+    for (int i = 0; i < 64; ++i) utf8 += chinese_text + "abc";
+    const std::string gbk = conv->ConvertEncodingFast(utf8, "UTF-8", "GBK").GetValue();
+    const std::string utf16le = conv->ConvertEncodingFast(utf8, "UTF-8", "UTF-16LE").GetValue();
+
+    const struct { const std::string* input; const char* from; const char* to; const std::string* expected; } cases[] = {
+        {&gbk,  "GBK",   "UTF-8",    &utf8},
+        {&utf8, "UTF-8", "UTF-16LE", &utf16le},
+        {&utf8, "UTF-8", "UTF-8",    &utf8},
+    };
+    for (const auto& c : cases) {
+        char frame[7];
+        std::string assembled;
+        std::string_view pending(*c.input);
+        ErrorCode ec = ErrorCode::BufferTooSmall;
+        while (ec == ErrorCode::BufferTooSmall) {
+            size_t consumed = 0, written = 0;
+            ec = conv->ConvertInto(pending, c.from, c.to, frame, sizeof(frame), consumed, written);
+            ASSERT_TRUE(ec == ErrorCode::Success || ec == ErrorCode::BufferTooSmall) << c.from << " -> " << c.to;
+            ASSERT_GT(consumed, 0u);
+            assembled.append(frame, written);
+            pending.remove_prefix(consumed);
+        }
+        EXPECT_TRUE(pending.empty());
+        EXPECT_EQ(assembled, *c.expected) << c.from << " -> " << c.to;
+    }
+}
+
+TEST_F(EncodingConversionTest, ConvertInto_ErrorsReportPosition) {
+    char buffer[64];
+    size_t consumed = 99, written = 99;
+
+    const std::string bad_utf8 = "ab\xE4\xB8\xAD\xFF" "cd";
+    EXPECT_EQ(conv->ConvertInto(bad_utf8, "UTF-8", "UTF-16LE", buffer, sizeof(buffer), consumed, written),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(consumed, 5u);
+    EXPECT_EQ(written, 6u);
+
+    EXPECT_EQ(conv->ConvertInto(std::string_view("A\x00\x3D\xD8", 4), "UTF-16LE", "UTF-8", buffer, sizeof(buffer),
+                                consumed, written), ErrorCode::IncompleteSequence);
+    EXPECT_EQ(consumed, 2u);
+    EXPECT_EQ(written, 1u);
+
+    EXPECT_EQ(conv->ConvertInto(bad_utf8, "UTF-8", "GBK", buffer, sizeof(buffer), consumed, written),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(consumed, 5u);
+
+    EXPECT_EQ(conv->ConvertInto("abc", "UTF-8", "UTF-16LE", nullptr, 8, consumed, written), ErrorCode::InvalidParameter);
+    EXPECT_EQ(consumed, 0u);
+    EXPECT_EQ(conv->ConvertInto("abc", "NOT-AN-ENCODING", "UTF-8", buffer, sizeof(buffer), consumed, written),
+              ErrorCode::InvalidSourceEncoding);
+    EXPECT_EQ(conv->ConvertInto("", "UTF-8", "UTF-16LE", nullptr, 0, consumed, written), ErrorCode::Success);
+    EXPECT_EQ(written, 0u);
+}
+
+TEST_F(EncodingConversionTest, ConvertInto_MaxOutputSizeIsUpperBound) {
+    EXPECT_GE(UniConv::MaxOutputSize(100, "UTF-8", "UTF-16LE"), 200u);
+    EXPECT_GE(UniConv::MaxOutputSize(100, "UTF-8", "UTF-32BE"), 400u);
+    EXPECT_GE(UniConv::MaxOutputSize(100, "GBK", "UTF-8"), 150u);
+    EXPECT_GE(UniConv::MaxOutputSize(100, "Windows-1252", "UTF-8"), 300u);
+    EXPECT_GE(UniConv::MaxOutputSize(100, "UTF-16", "UTF-8"), 150u);
+    EXPECT_EQ(UniConv::MaxOutputSize((std::numeric_limits<size_t>::max)(), "UTF-8", "UTF-16LE"),
+              (std::numeric_limits<size_t>::max)());
+
+    // Windows-1252 高位字节 -> 3 字节 UTF-8（€ 等）：最坏情况必须放得下
+    const std::string cp1252(200, '\x80');
+    std::vector<char> buffer(UniConv::MaxOutputSize(cp1252.size(), "Windows-1252", "UTF-8"));
+    size_t consumed = 0, written = 0;
+    ASSERT_EQ(conv->ConvertInto(cp1252, "Windows-1252", "UTF-8", buffer.data(), buffer.size(), consumed, written),
+              ErrorCode::Success);
+    EXPECT_EQ(written, 600u);
+}
+
+// ============================================================================
+// 48. 预解析编码对 Prepare / PreparedConversion
+// ============================================================================
+
+TEST_F(EncodingConversionTest, Prepared_InvalidPairsReportStatus) {
+    EXPECT_EQ(conv->Prepare(nullptr, "UTF-8").GetStatus(), ErrorCode::InvalidParameter);
+    EXPECT_EQ(conv->Prepare("NOT-AN-ENCODING", "UTF-8").GetStatus(), ErrorCode::InvalidSourceEncoding);
+    EXPECT_EQ(conv->Prepare("UTF-8", "NOT-AN-ENCODING").GetStatus(), ErrorCode::InvalidTargetEncoding);
+
+    UniConv::PreparedConversion empty;
+    EXPECT_FALSE(empty.IsValid());
+    std::string output = "stale";
+    EXPECT_EQ(empty.Convert(ascii_text, output), ErrorCode::InvalidParameter);
+    EXPECT_TRUE(output.empty());
+
+    const auto prepared = conv->Prepare("GBK", "UTF-8");
+    ASSERT_TRUE(prepared.IsValid());
+    EXPECT_STREQ(prepared.GetFromEncoding(), "GBK");
+    EXPECT_STREQ(prepared.GetToEncoding(), "UTF-8");
+}
+
+TEST_F(EncodingConversionTest, Prepared_MatchesNameBasedApi) {
+    const std::string gbk = conv->ConvertEncodingFast(mixed_text, "UTF-8", "GBK").GetValue();
+    const struct { const char* from; const char* to; std::string input; } cases[] = {
+        {"UTF-8", "GBK",      mixed_text},
+        {"GBK",   "UTF-8",    gbk},
+        {"UTF-8", "UTF-16LE", full_text},
+        {"UTF-8", "UTF-32BE", emoji_text},
+        {"UTF-8", "UTF-8",    chinese_text},
+        {"UTF-8", "GBK",      ascii_text},
+        {"UTF-8", "GBK",      std::string{}},
+    };
+    for (const auto& c : cases) {
+        const auto prepared = conv->Prepare(c.from, c.to);
+        ASSERT_TRUE(prepared.IsValid()) << c.from << " -> " << c.to;
+
+        std::string expected;
+        ASSERT_EQ(conv->ConvertEncodingFast(std::string_view(c.input), c.from, c.to, expected), ErrorCode::Success);
+
+        std::string output;
+        EXPECT_EQ(prepared.Convert(c.input, output), ErrorCode::Success) << c.from << " -> " << c.to;
+        EXPECT_EQ(output, expected) << c.from << " -> " << c.to;
+        EXPECT_EQ(prepared.Convert(c.input).GetValue(), expected) << c.from << " -> " << c.to;
+
+        std::vector<char> buffer(prepared.MaxOutputSize(c.input.size()));
+        size_t consumed = 0, written = 0;
+        EXPECT_EQ(prepared.ConvertInto(c.input, buffer.data(), buffer.size(), consumed, written), ErrorCode::Success);
+        EXPECT_EQ(consumed, c.input.size());
+        EXPECT_EQ(std::string(buffer.data(), written), expected) << c.from << " -> " << c.to;
+    }
+
+    const auto prepared = conv->Prepare("UTF-8", "GBK");
+    std::string output;
+    EXPECT_EQ(prepared.Convert(std::string_view("ab\xFF"), output), ErrorCode::InvalidSequence);
+}
+
+TEST_F(EncodingConversionTest, Prepared_SharedHandleAcrossThreads) {
+    const std::string gbk = conv->ConvertEncodingFast(mixed_text, "UTF-8", "GBK").GetValue();
+    const auto gbk_to_utf8 = conv->Prepare("GBK", "UTF-8");
+    ASSERT_TRUE(gbk_to_utf8.IsValid());
+
+    std::atomic<int> failures{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([&] {
+            std::string output;
+            for (int round = 0; round < 200; ++round) {
+                if (gbk_to_utf8.Convert(gbk, output) != ErrorCode::Success || output != mixed_text) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_F(EncodingConversionTest, Prepared_HonoursStatelessMode) {
+    auto stateless = UniConv::Create();
+    stateless->SetApiLayerMode(UniConv::ApiLayerMode::Stateless);
+    const auto prepared = stateless->Prepare("UTF-8", "GBK");
+    ASSERT_TRUE(prepared.IsValid());
+
+    std::string output;
+    ASSERT_EQ(prepared.Convert(mixed_text, output), ErrorCode::Success);
+    EXPECT_EQ(output, conv->ConvertEncodingFast(mixed_text, "UTF-8", "GBK").GetValue());
+}
+
+// ============================================================================
+// 49. 连续存储批量转换（Arrow 风格 data + offsets）
+// ============================================================================
+
+namespace {
+
+struct PackedBatch {
+    std::string data;
+    std::vector<size_t> offsets{0};
+
+    void Append(const std::string& value) {
+        data += value;
+        offsets.push_back(data.size());
+    }
+    size_t Count() const { return offsets.size() - 1; }
+};
+
+std::string_view PackedValue(const std::string& data, const std::vector<size_t>& offsets, size_t i) {
+    return std::string_view(data).substr(offsets[i], offsets[i + 1] - offsets[i]);
+}
+
+} // namespace
+
+TEST_F(EncodingConversionTest, PackedBatch_MatchesPerValueConversion) {
+    PackedBatch batch;
+    const std::string values[] = {ascii_text, chinese_text, "", mixed_text, full_text, emoji_text, "x"};
+    for (int round = 0; round < 50; ++round) {
+        for (const auto& v : values) batch.Append(v);
+    }
+
+    const std::pair<const char*, const char*> pairs[] = {
+        {"UTF-8", "UTF-16LE"}, {"UTF-8", "UTF-32BE"}, {"UTF-8", "UTF-8"}, {"UTF-8", "GB18030"},
+    };
+    for (const auto& [from, to] : pairs) {
+        std::string out_data;
+        std::vector<size_t> out_offsets;
+        std::vector<ErrorCode> errors;
+        ASSERT_EQ(conv->ConvertEncodingBatch(batch.data, batch.offsets.data(), batch.Count(), from, to,
+                                             out_data, out_offsets, &errors), ErrorCode::Success) << from << " -> " << to;
+        ASSERT_EQ(out_offsets.size(), batch.Count() + 1);
+        ASSERT_EQ(errors.size(), batch.Count());
+        EXPECT_EQ(out_offsets.back(), out_data.size());
+        for (size_t i = 0; i < batch.Count(); ++i) {
+            std::string expected;
+            ASSERT_EQ(conv->ConvertEncodingFast(PackedValue(batch.data, batch.offsets, i), from, to, expected),
+                      ErrorCode::Success);
+            EXPECT_EQ(PackedValue(out_data, out_offsets, i), expected) << from << " -> " << to << " value " << i;
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, PackedBatch_FailedValuesAreEmptyRanges) {
+    PackedBatch batch;
+    batch.Append(chinese_text);
+    batch.Append("bad\xFF");
+    batch.Append(mixed_text);
+    batch.Append(std::string("\xE4\xBD", 2));
+
+    std::string out_data;
+    std::vector<size_t> out_offsets;
+    std::vector<ErrorCode> errors;
+    EXPECT_EQ(conv->ConvertEncodingBatch(batch.data, batch.offsets.data(), batch.Count(), "UTF-8", "GBK",
+                                         out_data, out_offsets, &errors), ErrorCode::InvalidSequence);
+    ASSERT_EQ(errors.size(), 4u);
+    EXPECT_EQ(errors[0], ErrorCode::Success);
+    EXPECT_EQ(errors[1], ErrorCode::InvalidSequence);
+    EXPECT_EQ(errors[2], ErrorCode::Success);
+    EXPECT_EQ(errors[3], ErrorCode::IncompleteSequence);
+    EXPECT_TRUE(PackedValue(out_data, out_offsets, 1).empty());
+    EXPECT_TRUE(PackedValue(out_data, out_offsets, 3).empty());
+    EXPECT_EQ(PackedValue(out_data, out_offsets, 2), conv->ConvertEncodingFast(mixed_text, "UTF-8", "GBK").GetValue());
+
+    // 非法偏移量
+    const size_t bad_offsets[] = {0, 5, 3};
+    EXPECT_EQ(conv->ConvertEncodingBatch(batch.data, bad_offsets, 2, "UTF-8", "GBK", out_data, out_offsets),
+              ErrorCode::InvalidParameter);
+    const size_t past_end[] = {0, batch.data.size() + 1};
+    EXPECT_EQ(conv->ConvertEncodingBatch(batch.data, past_end, 1, "UTF-8", "GBK", out_data, out_offsets),
+              ErrorCode::InvalidParameter);
+    EXPECT_EQ(conv->ConvertEncodingBatch(batch.data, nullptr, 0, "UTF-8", "GBK", out_data, out_offsets),
+              ErrorCode::Success);
+    EXPECT_EQ(out_offsets.size(), 1u);
+}
+
+TEST_F(EncodingConversionTest, PackedBatch_ReusesArenaCapacity) {
+    PackedBatch batch;
+    for (int i = 0; i < 1000; ++i) batch.Append(i % 3 == 0 ? chinese_text : mixed_text);
+
+    std::string out_data;
+    std::vector<size_t> out_offsets;
+    ASSERT_EQ(conv->ConvertEncodingBatch(batch.data, batch.offsets.data(), batch.Count(), "UTF-8", "GBK",
+                                         out_data, out_offsets), ErrorCode::Success);
+    const std::string first = out_data;
+    const char* arena = out_data.data();
+    const size_t* offsets = out_offsets.data();
+    for (int round = 0; round < 4; ++round) {
+        ASSERT_EQ(conv->ConvertEncodingBatch(batch.data, batch.offsets.data(), batch.Count(), "UTF-8", "GBK",
+                                             out_data, out_offsets), ErrorCode::Success);
+        EXPECT_EQ(out_data.data(), arena);
+        EXPECT_EQ(out_offsets.data(), offsets);
+    }
+    EXPECT_EQ(out_data, first);
+}
+
+// ============================================================================
+// 50. 工作窃取线程池 ThreadPool
+// ============================================================================
+
+TEST(ThreadPoolTest, ParallelFor_CoversEveryIndexOnce) {
+    ThreadPool pool(4);
+    for (size_t total : {size_t(1), size_t(7), size_t(1000), size_t(100003)}) {
+        std::vector<std::atomic<int>> hits(total);
+        pool.ParallelFor(total, [&hits](size_t start, size_t end) {
+            // 不均匀负载：靠前的块更重，促使空闲线程窃取
+            for (size_t i = start; i < end; ++i) {
+                if (i < 64) std::this_thread::sleep_for(std::chrono::microseconds(50));
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        for (size_t i = 0; i < total; ++i) {
+            ASSERT_EQ(hits[i].load(), 1) << "total=" << total << " index=" << i;
+        }
+    }
+}
+
+TEST(ThreadPoolTest, ParallelFor_NestedCallsDoNotDeadlock) {
+    ThreadPool pool(2);
+    std::atomic<size_t> sum{0};
+    pool.ParallelFor(16, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            pool.ParallelFor(256, [&sum](size_t s, size_t e) {
+                sum.fetch_add(e - s, std::memory_order_relaxed);
+            });
+        }
+    });
+    EXPECT_EQ(sum.load(), 16u * 256u);
+}
+
+TEST(ThreadPoolTest, ParallelFor_RethrowsTaskException) {
+    ThreadPool pool(3);
+    std::atomic<size_t> processed{0};
+    EXPECT_THROW(pool.ParallelFor(1024, [&processed](size_t start, size_t end) {
+        if (start <= 500 && 500 < end) throw std::runtime_error("chunk failed");
+        processed.fetch_add(end - start, std::memory_order_relaxed);
+    }), std::runtime_error);
+    EXPECT_LT(processed.load(), 1024u);
+
+    // 异常之后线程池仍可正常使用
+    std::atomic<size_t> count{0};
+    pool.ParallelFor(1024, [&count](size_t start, size_t end) { count.fetch_add(end - start); });
+    EXPECT_EQ(count.load(), 1024u);
+}
+
+TEST(ThreadPoolTest, Submit_ReturnsFutureResults) {
+    ThreadPool pool(2);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.Submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(futures[i].get(), i * i);
+    }
+
+    // 在工作线程内提交的任务进入本地队列，等待期间不会阻塞其他任务
+    auto outer = pool.Submit([&pool] {
+        auto inner = pool.Submit([] { return 42; });
+        return inner.get();
+    });
+    EXPECT_EQ(outer.get(), 42);
+}
+
+// ============================================================================
+// 51. 批量并行按字节权重划分（超大条目走分块并行）
+// ============================================================================
+
+TEST_F(EncodingConversionTest, BatchParallel_SkewedSizesMatchSerial) {
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 2000; ++i) {
+        if (i == 700) {
+            std::string large;
+            while (large.size() < 3 * 1024 * 1024) large += chinese_text + mixed_text;
+            inputs.push_back(std::move(large));
+        } else {
+            inputs.push_back(i % 2 ? chinese_text : mixed_text);
+        }
+    }
+
+    for (auto mode : {UniConv::ApiLayerMode::Convenience, UniConv::ApiLayerMode::Stateless}) {
+        conv->SetApiLayerMode(mode);
+        auto results = conv->ConvertEncodingBatchParallel(inputs, "UTF-8", "GBK", 4);
+        std::vector<std::string> outputs;
+        EXPECT_TRUE(conv->ConvertEncodingBatchParallel(inputs, "UTF-8", "GBK", outputs, 4));
+        ASSERT_EQ(results.size(), inputs.size());
+        ASSERT_EQ(outputs.size(), inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            auto expected = conv->ConvertEncodingFast(inputs[i], "UTF-8", "GBK");
+            ASSERT_TRUE(expected.IsSuccess());
+            ASSERT_TRUE(results[i].IsSuccess()) << "index " << i;
+            ASSERT_EQ(results[i].GetValue(), expected.GetValue()) << "index " << i;
+            ASSERT_EQ(outputs[i], expected.GetValue()) << "index " << i;
+        }
+    }
+    conv->SetApiLayerMode(UniConv::ApiLayerMode::Convenience);
+}
+
+TEST_F(EncodingConversionTest, BatchParallel_LargeItemFailureIsIsolated) {
+    std::string large;
+    while (large.size() < 2 * 1024 * 1024) large += chinese_text;
+    large[large.size() / 2] = '\xff';
+
+    std::vector<std::string> inputs(64, chinese_text);
+    inputs.push_back(large);
+
+    auto results = conv->ConvertEncodingBatchParallel(inputs, "UTF-8", "UTF-16LE", 4);
+    ASSERT_EQ(results.size(), inputs.size());
+    EXPECT_FALSE(results.back().IsSuccess());
+    for (size_t i = 0; i + 1 < results.size(); ++i) {
+        EXPECT_TRUE(results[i].IsSuccess()) << "index " << i;
+    }
+
+    std::vector<std::string> outputs;
+    EXPECT_FALSE(conv->ConvertEncodingBatchParallel(inputs, "UTF-8", "UTF-16LE", outputs, 4));
+    EXPECT_TRUE(outputs.back().empty());
+    EXPECT_EQ(outputs.front(), conv->ConvertEncodingFast(chinese_text, "UTF-8", "UTF-16LE").GetValue());
+}
+
+// ============================================================================
+// 52. 并行策略标定 CalibrateParallelPolicy
+// ============================================================================
+
+TEST(ParallelPolicyTest, ClassifyParallelCost_FollowsConversionPath) {
+    EXPECT_EQ(UniConv::ClassifyParallelCost("UTF-8", "UTF-8"), ParallelCostClass::Copy);
+    EXPECT_EQ(UniConv::ClassifyParallelCost("UTF-8", "GBK"), ParallelCostClass::NativeUtf);
+    EXPECT_EQ(UniConv::ClassifyParallelCost("SHIFT_JIS", "UTF-8"), ParallelCostClass::NativeUtf);
+    EXPECT_EQ(UniConv::ClassifyParallelCost("UTF-8", "EUC-KR"), ParallelCostClass::IconvMultiByte);
+    EXPECT_EQ(UniConv::ClassifyParallelCost("UTF-16", "GBK"), ParallelCostClass::IconvMultiByte);
+    EXPECT_EQ(UniConv::ClassifyParallelCost("UTF-8", "ISO-8859-1"), ParallelCostClass::NativeUtf);
+    EXPECT_EQ(UniConv::ClassifyParallelCost("UTF-16", "ISO-8859-1"), ParallelCostClass::IconvSingleByte);
+    EXPECT_EQ(UniConv::ClassifyParallelCost("UTF-8", "UTF-16"), ParallelCostClass::IconvUnicode);
+    const ParallelCostClass utf = UniConv::ClassifyParallelCost("UTF-8", "UTF-16LE");
+    EXPECT_TRUE(utf == ParallelCostClass::NativeUtf || utf == ParallelCostClass::Simdutf);
+}
+
+TEST(ParallelPolicyTest, SetGetReset_RoundTrips) {
+    ParallelThresholds custom;
+    custom.serial_bytes = 4096;
+    custom.light_parallel_bytes = 1 << 20;
+    custom.light_parallel_threads = 3;
+    custom.min_bytes_per_chunk = 64 * 1024;
+    UniConv::SetParallelThresholds(ParallelCostClass::IconvMultiByte, custom);
+
+    const ParallelThresholds got = UniConv::GetParallelThresholds(ParallelCostClass::IconvMultiByte);
+    EXPECT_EQ(got.serial_bytes, 4096u);
+    EXPECT_EQ(got.light_parallel_bytes, size_t(1) << 20);
+    EXPECT_EQ(got.light_parallel_threads, 3u);
+    EXPECT_EQ(got.min_bytes_per_chunk, 64u * 1024u);
+    EXPECT_EQ(AdaptiveParallelPolicy::GetRecommendedThreads(100, 8192, 8, got), 3u);
+    EXPECT_EQ(AdaptiveParallelPolicy::GetRecommendedThreads(100, 8192, 8), 0u);
+
+    UniConv::ResetParallelPolicy();
+    const ParallelThresholds reset = UniConv::GetParallelThresholds(ParallelCostClass::IconvMultiByte);
+    EXPECT_EQ(reset.serial_bytes, AdaptiveParallelPolicy::SERIAL_THRESHOLD_BYTES);
+    EXPECT_EQ(reset.light_parallel_bytes, AdaptiveParallelPolicy::LIGHT_PARALLEL_BYTES);
+    EXPECT_EQ(reset.min_bytes_per_chunk, AdaptiveParallelPolicy::MIN_BYTES_PER_CHUNK);
+}
+
+TEST_F(EncodingConversionTest, CalibrateParallelPolicy_InstallsMeasuredThresholds) {
+    const ParallelCalibration report = UniConv::CalibrateParallelPolicy(64 * 1024);
+    EXPECT_GT(report.dispatch_ns, 0.0);
+    for (auto cls : {ParallelCostClass::Copy, ParallelCostClass::NativeUtf, ParallelCostClass::IconvMultiByte}) {
+        const size_t c = static_cast<size_t>(cls);
+        EXPECT_GT(report.ns_per_byte[c], 0.0) << "class " << c;
+        const ParallelThresholds live = UniConv::GetParallelThresholds(cls);
+        EXPECT_EQ(live.serial_bytes, report.thresholds[c].serial_bytes);
+        EXPECT_GE(live.light_parallel_bytes, live.serial_bytes);
+        EXPECT_GT(live.min_bytes_per_chunk, 0u);
+    }
+    // 即使阈值变化，并行批量与分块并行的结果也必须与串行一致
+    std::vector<std::string> inputs(500, chinese_text + mixed_text);
+    auto results = conv->ConvertEncodingBatchParallel(inputs, "UTF-8", "GBK", 4);
+    const std::string expected = conv->ConvertEncodingFast(inputs[0], "UTF-8", "GBK").GetValue();
+    for (const auto& r : results) {
+        ASSERT_TRUE(r.IsSuccess());
+        EXPECT_EQ(r.GetValue(), expected);
+    }
+    std::string large;
+    while (large.size() < 1024 * 1024) large += chinese_text + mixed_text;
+    EXPECT_EQ(conv->ConvertEncodingParallel(large, "UTF-8", "GBK", 4).GetValue(),
+              conv->ConvertEncodingFast(large, "UTF-8", "GBK").GetValue());
+    UniConv::ResetParallelPolicy();
+}
+
+// ============================================================================
+// 53. 异步转换 ConvertEncodingAsync / ConvertEncodingBatchAsync
+// ============================================================================
+
+TEST_F(EncodingConversionTest, Async_CompletesOnThreadPool) {
+    std::promise<StringResult> done;
+    auto future = done.get_future();
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic<bool> ran_elsewhere{false};
+
+    ASSERT_EQ(conv->ConvertEncodingAsync(chinese_text, "UTF-8", "GBK",
+        [&](StringResult r) {
+            ran_elsewhere = std::this_thread::get_id() != caller;
+            done.set_value(std::move(r));
+        }), ErrorCode::Success);
+
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    StringResult r = future.get();
+    ASSERT_TRUE(r.IsSuccess());
+    EXPECT_EQ(r.GetValue(), conv->ConvertEncodingFast(chinese_text, "UTF-8", "GBK").GetValue());
+    EXPECT_TRUE(ran_elsewhere.load());
+
+    // 转换失败同样通过回调通知
+    std::promise<ErrorCode> failed;
+    auto failed_future = failed.get_future();
+    ASSERT_EQ(conv->ConvertEncodingAsync(std::string("\xff\xfe", 2), "UTF-8", "GBK",
+        [&](StringResult r) { failed.set_value(r.GetErrorCode()); }), ErrorCode::Success);
+    ASSERT_EQ(failed_future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_NE(failed_future.get(), ErrorCode::Success);
+}
+
+TEST_F(EncodingConversionTest, Async_UsesCustomExecutor) {
+    std::vector<std::function<void()>> queued;
+    UniConv::AsyncExecutor executor = [&queued](std::function<void()> task) { queued.push_back(std::move(task)); };
+
+    std::string result;
+    ASSERT_EQ(conv->ConvertEncodingAsync(mixed_text, "UTF-8", "UTF-16LE",
+        [&result](StringResult r) { result = std::move(r).GetValue(); }, executor), ErrorCode::Success);
+    // 执行器尚未运行任务：调用立即返回
+    ASSERT_EQ(queued.size(), 1u);
+    EXPECT_TRUE(result.empty());
+    queued.front()();
+    EXPECT_EQ(result, conv->ConvertEncodingFast(mixed_text, "UTF-8", "UTF-16LE").GetValue());
+
+    // 执行器抛出：提交失败，回调不会运行
+    bool called = false;
+    UniConv::AsyncExecutor broken = [](std::function<void()>) { throw std::runtime_error("queue closed"); };
+    EXPECT_EQ(conv->ConvertEncodingAsync(mixed_text, "UTF-8", "GBK", [&called](StringResult) { called = true; }, broken),
+              ErrorCode::InternalError);
+    EXPECT_FALSE(called);
+    EXPECT_EQ(conv->ConvertEncodingAsync(mixed_text, nullptr, "GBK", [](StringResult) {}), ErrorCode::InvalidParameter);
+    EXPECT_EQ(conv->ConvertEncodingAsync(mixed_text, "UTF-8", "GBK", nullptr), ErrorCode::InvalidParameter);
+}
+
+TEST_F(EncodingConversionTest, BatchAsync_DeliversAllResults) {
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 300; ++i) inputs.push_back(i % 2 ? chinese_text : mixed_text);
+    const auto expected = conv->ConvertEncodingBatch(inputs, "UTF-8", "GBK");
+
+    std::promise<std::vector<StringResult>> done;
+    auto future = done.get_future();
+    ASSERT_EQ(conv->ConvertEncodingBatchAsync(inputs, "UTF-8", "GBK",
+        [&done](std::vector<StringResult> results) { done.set_value(std::move(results)); }), ErrorCode::Success);
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    const auto results = future.get();
+    ASSERT_EQ(results.size(), inputs.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        ASSERT_TRUE(results[i].IsSuccess());
+        EXPECT_EQ(results[i].GetValue(), expected[i].GetValue());
+    }
+}
+
+// ============================================================================
+// 54. std::pmr 输出（调用方 memory_resource）
+// ============================================================================
+#if UNICONV_HAS_PMR
+
+namespace {
+
+/// 统计分配次数与字节数的上游资源，用于确认结果确实来自调用方资源
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+private:
+    void* do_allocate(size_t n, size_t align) override {
+        ++allocations;
+        bytes += n;
+        return std::pmr::new_delete_resource()->allocate(n, align);
+    }
+    void do_deallocate(void* p, size_t n, size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(p, n, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+} // anonymous namespace
+
+TEST_F(EncodingConversionTest, Pmr_ConvertEncodingFastUsesCallerResource) {
+    std::string long_text;
+    for (int i = 0; i < 64; ++i) long_text += chinese_text + mixed_text;
+
+    for (const char* to : {"GBK", "UTF-16LE", "UTF-32LE", "UTF-8"}) {
+        CountingResource counting;
+        std::pmr::string output(&counting);
+        ASSERT_EQ(conv->ConvertEncodingFast(long_text, "UTF-8", to, output), ErrorCode::Success) << to;
+        EXPECT_EQ(std::string(output.data(), output.size()), conv->ConvertEncodingFast(long_text, "UTF-8", to).GetValue()) << to;
+        EXPECT_GT(counting.allocations, 0u) << to;
+
+        auto result = conv->ConvertEncodingFast(long_text, "UTF-8", to, &counting);
+        ASSERT_TRUE(result.IsSuccess()) << to;
+        EXPECT_EQ(result.GetValue(), output) << to;
+        EXPECT_EQ(result.GetValue().get_allocator().resource(), &counting) << to;
+    }
+
+    std::pmr::string failed(std::pmr::new_delete_resource());
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string_view("\xff\xfe", 2), "UTF-8", "GBK", failed), ErrorCode::InvalidSequence);
+    EXPECT_TRUE(failed.empty());
+    EXPECT_EQ(conv->ConvertEncodingFast(long_text, "NOT-AN-ENCODING", "GBK", std::pmr::get_default_resource()).GetErrorCode(),
+              ErrorCode::InvalidSourceEncoding);
+}
+
+TEST_F(EncodingConversionTest, Pmr_BatchAndTypedWrappersUseMonotonicBuffer) {
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 100; ++i) inputs.push_back(i % 2 ? chinese_text : mixed_text);
+    const auto expected = conv->ConvertEncodingBatch(inputs, "UTF-8", "GBK");
+
+    CountingResource upstream;
+    {
+        std::pmr::monotonic_buffer_resource arena(64 * 1024, &upstream);
+        std::pmr::vector<std::pmr::string> outputs(&arena);
+        ASSERT_TRUE(conv->ConvertEncodingBatch(inputs, "UTF-8", "GBK", outputs));
+        ASSERT_EQ(outputs.size(), inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            EXPECT_EQ(outputs[i].get_allocator().resource(), &arena);
+            EXPECT_EQ(std::string(outputs[i].data(), outputs[i].size()), expected[i].GetValue());
+        }
+
+        PackedBatch batch;
+        for (const auto& s : inputs) batch.Append(s);
+        std::pmr::string out_data(&arena);
+        std::pmr::vector<size_t> out_offsets(&arena);
+        ASSERT_EQ(conv->ConvertEncodingBatch(batch.data, batch.offsets.data(), batch.Count(), "UTF-8", "GBK",
+                                             out_data, out_offsets), ErrorCode::Success);
+        ASSERT_EQ(out_offsets.size(), inputs.size() + 1);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            EXPECT_EQ(std::string(out_data.data() + out_offsets[i], out_offsets[i + 1] - out_offsets[i]),
+                      expected[i].GetValue());
+        }
+
+        std::pmr::u16string u16(&arena);
+        ASSERT_TRUE(conv->ToUtf16LEFromUtf8(mixed_text, u16));
+        EXPECT_EQ(std::u16string(u16.data(), u16.size()), conv->ToUtf16LEFromUtf8(mixed_text));
+        std::pmr::u32string u32(&arena);
+        ASSERT_TRUE(conv->ToUtf32LEFromUtf16LE(std::u16string_view(u16), u32));
+        std::pmr::string back(&arena);
+        ASSERT_TRUE(conv->ToUtf8FromUtf32LE(std::u32string_view(u32), back));
+        EXPECT_EQ(std::string(back.data(), back.size()), mixed_text);
+
+        // 全部结果位于同一个单调缓冲区：上游只看到少量大块分配
+        EXPECT_LT(upstream.allocations, 8u);
+    }
+}
+
+#endif // UNICONV_HAS_PMR
+
+// ============================================================================
+// 55. StringBufferPool 自适应 tier 与线程本地槽位
+// ============================================================================
+
+TEST(StringBufferPoolTest, LargeTierGrowsUnderConcurrentDemand) {
+    StringBufferPool pool;
+    const size_t large = static_cast<size_t>(StringBufferPool::Tier::Large);
+    const auto initial = pool.GetTierStatistics().tiers[large];
+    EXPECT_EQ(initial.capacity, 2u);
+
+    // 同时持有 8 个大缓冲：初始 2 个槽位很快耗尽，miss 触发扩容
+    {
+        std::vector<StringBufferPool::BufferLease> leases;
+        for (int i = 0; i < 8; ++i) leases.push_back(pool.acquire(256 * 1024));
+        for (const auto& lease : leases) EXPECT_TRUE(lease.is_from_pool());
+        EXPECT_EQ(pool.GetTierStatistics().large_active, 8u);
+    }
+
+    const auto grown = pool.GetTierStatistics().tiers[large];
+    EXPECT_GE(grown.capacity, 8u);
+    EXPECT_LE(grown.capacity, grown.max_capacity);
+    EXPECT_GT(grown.grows, 0u);
+    EXPECT_GT(grown.misses, 0u);
+    EXPECT_EQ(pool.GetActiveBuffers(), 0u);
+
+    // 扩容后同样的负载不再 miss
+    {
+        std::vector<StringBufferPool::BufferLease> leases;
+        for (int i = 0; i < 8; ++i) leases.push_back(pool.acquire(256 * 1024));
+    }
+    EXPECT_EQ(pool.GetTierStatistics().tiers[large].misses, grown.misses);
+}
+
+TEST(StringBufferPoolTest, IdleTierShrinksBackAndTrimsOversizedBuffers) {
+    StringBufferPool pool;
+    const size_t medium = static_cast<size_t>(StringBufferPool::Tier::Medium);
+    {
+        std::vector<StringBufferPool::BufferLease> leases;
+        for (int i = 0; i < 32; ++i) leases.push_back(pool.acquire(32 * 1024));
+    }
+    ASSERT_GT(pool.GetTierStatistics().tiers[medium].capacity, 8u);
+
+    // 长时间只有单个并发使用：逐窗口减半直至回到初始槽位数
+    for (int i = 0; i < 8 * 1024; ++i) {
+        auto lease = pool.acquire(32 * 1024);
+        ASSERT_TRUE(lease.is_from_pool());
+    }
+    const auto shrunk = pool.GetTierStatistics().tiers[medium];
+    EXPECT_EQ(shrunk.capacity, 8u);
+    EXPECT_GT(shrunk.shrinks, 0u);
+
+    // 使用中膨胀到远超 tier 尺寸的缓冲区在归还时被释放
+    const void* slot = nullptr;
+    {
+        auto lease = pool.acquire(32 * 1024);
+        lease.get().assign(4 * 1024 * 1024, 'x');
+        slot = &lease.get();
+    }
+    EXPECT_EQ(pool.GetTierStatistics().tiers[medium].trims, 1u);
+    auto again = pool.acquire(32 * 1024);
+    EXPECT_EQ(&again.get(), slot);  // 线程本地提示命中同一槽位
+    EXPECT_TRUE(again.get().empty());
+    EXPECT_LT(again.get().capacity(), 1024u * 1024u);
+}
+
+TEST(StringBufferPoolTest, ConcurrentLeasesStayExclusive) {
+    StringBufferPool pool;
+    constexpr int kThreads = 8;
+    constexpr int kIterations = 2000;
+    std::atomic<int> corrupted{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&pool, &corrupted, t] {
+            const char tag = static_cast<char>('a' + t);
+            for (int i = 0; i < kIterations; ++i) {
+                const size_t hint = (i % 3 == 0) ? 128 * 1024 : (i % 3 == 1) ? 16 * 1024 : 512;
+                auto lease = pool.acquire(hint);
+                std::string& buf = lease.get();
+                if (!buf.empty()) corrupted.fetch_add(1);
+                buf.assign(64, tag);
+                std::this_thread::yield();
+                if (buf != std::string(64, tag)) corrupted.fetch_add(1);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(corrupted.load(), 0);
+    EXPECT_EQ(pool.GetActiveBuffers(), 0u);
+    const auto stats = pool.GetTierStatistics();
+    for (const auto& tier : stats.tiers) {
+        EXPECT_EQ(tier.active, 0u);
+        EXPECT_LE(tier.capacity, tier.max_capacity);
+    }
+}
+
+// ============================================================================
+// 56. 前导 ASCII 段预扫描（复制前缀，只把尾部交给 iconv）
+// ============================================================================
+
+TEST_F(EncodingConversionTest, AsciiPrefix_MixedInputMatchesAcrossBlockBoundaries) {
+    const auto cjk = conv->ConvertEncodingFast(chinese_text, "UTF-8", "GBK");
+    ASSERT_TRUE(cjk.IsSuccess());
+
+    // 覆盖标量 / 16 / 32 / 64 / 128 字节块的各个边界
+    const size_t prefix_lengths[] = {0, 1, 7, 8, 15, 16, 31, 32, 33, 63, 64, 65, 127, 128, 129, 200, 257, 4099};
+    std::vector<std::string> inputs;
+    std::vector<std::string> expected;
+    for (size_t n : prefix_lengths) {
+        std::string ascii;
+        for (size_t i = 0; i < n; ++i) ascii.push_back(static_cast<char>('!' + i % 90));
+        inputs.push_back(ascii + chinese_text + " tail");
+        expected.push_back(ascii + cjk.GetValue() + " tail");
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        SCOPED_TRACE(prefix_lengths[i]);
+        const auto result = conv->ConvertEncodingFast(inputs[i], "UTF-8", "GBK");
+        ASSERT_TRUE(result.IsSuccess());
+        EXPECT_EQ(result.GetValue(), expected[i]);
+
+        std::string out;
+        ASSERT_EQ(conv->ConvertEncodingFast(inputs[i], "UTF-8", "GBK", out), ErrorCode::Success);
+        EXPECT_EQ(out, expected[i]);
+        ASSERT_EQ(conv->ConvertEncodingFast(std::string_view(inputs[i]), "UTF-8", "GBK", out), ErrorCode::Success);
+        EXPECT_EQ(out, expected[i]);
+        ASSERT_EQ(conv->ConvertEncodingStatelessFast(inputs[i], "UTF-8", "GBK", out), ErrorCode::Success);
+        EXPECT_EQ(out, expected[i]);
+    }
+
+    const auto batch = conv->ConvertEncodingBatch(inputs, "UTF-8", "GBK");
+    const auto parallel = conv->ConvertEncodingBatchParallel(inputs, "UTF-8", "GBK");
+    std::vector<std::string> outputs;
+    ASSERT_TRUE(conv->ConvertEncodingBatch(inputs, "UTF-8", "GBK", outputs));
+    ASSERT_EQ(batch.size(), inputs.size());
+    ASSERT_EQ(parallel.size(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        EXPECT_EQ(batch[i].GetValue(), expected[i]);
+        EXPECT_EQ(parallel[i].GetValue(), expected[i]);
+        EXPECT_EQ(outputs[i], expected[i]);
+    }
+}
+
+TEST_F(EncodingConversionTest, AsciiPrefix_ErrorsAndConvertIntoOffsetsIncludePrefix) {
+    const std::string ascii(100, 'x');
+    EXPECT_EQ(conv->ConvertEncodingFast(ascii + "\xff" + chinese_text, "UTF-8", "GBK").GetErrorCode(),
+              ErrorCode::InvalidSequence);
+
+    const std::string input = ascii + chinese_text;
+    std::vector<char> buffer(256);
+    size_t consumed = 0, written = 0;
+
+    // 容量落在前缀内：按字节截断，前缀之后的部分留待续传
+    EXPECT_EQ(conv->ConvertInto(input, "UTF-8", "GBK", buffer.data(), 40, consumed, written),
+              ErrorCode::BufferTooSmall);
+    EXPECT_EQ(consumed, 40u);
+    EXPECT_EQ(written, 40u);
+
+    ASSERT_EQ(conv->ConvertInto(input, "UTF-8", "GBK", buffer.data(), buffer.size(), consumed, written),
+              ErrorCode::Success);
+    EXPECT_EQ(consumed, input.size());
+    EXPECT_EQ(std::string(buffer.data(), written), ascii + conv->ConvertEncodingFast(chinese_text, "UTF-8", "GBK").GetValue());
+
+    // 非法字节位于前缀之后：consumed 指向该字节
+    const std::string broken = ascii + "\xff";
+    EXPECT_EQ(conv->ConvertInto(broken, "UTF-8", "GBK", buffer.data(), buffer.size(), consumed, written),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(consumed, ascii.size());
+    EXPECT_EQ(written, ascii.size());
+}
+
+// ============================================================================
+// 57. 内置单字节码页编解码（查表，不经 iconv）
+// ============================================================================
+
+namespace {
+
+const char* const kBuiltinSbcsNames[] = {
+    "ISO-8859-1", "ISO-8859-2", "ISO-8859-3", "ISO-8859-4", "ISO-8859-5", "ISO-8859-6", "ISO-8859-7",
+    "ISO-8859-8", "ISO-8859-9", "ISO-8859-10", "ISO-8859-13", "ISO-8859-14", "ISO-8859-15", "ISO-8859-16",
+    "KOI8-R", "KOI8-U", "CP1250", "CP1251", "CP1252", "CP1253", "CP1254", "CP1256", "CP1257",
+    "CP850", "CP862", "CP866", "CP874", "PT154",
+    "MACROMAN", "MACCENTRALEUROPE", "MACICELAND", "MACCROATIAN", "MACROMANIA", "MACCYRILLIC",
+    "MACGREEK", "MACTURKISH",
+};
+
+/// 码页中全部已定义的字节（ASCII 与逐字节解码成功的高位字节）
+std::string DefinedSbcsBytes(UniConv& conv, const char* encoding) {
+    std::string bytes;
+    for (int b = 1; b < 256; ++b) {
+        const std::string one(1, static_cast<char>(b));
+        if (conv.ConvertEncodingFast(one, encoding, "UTF-8").IsSuccess()) {
+            bytes += one;
+        }
+    }
+    return bytes;
+}
+
+} // namespace
+
+TEST_F(EncodingConversionTest, SbcsNative_DecodeMatchesIconv) {
+    // "UTF-16"（带 BOM）不走内置内核，作为 iconv 的参照；BOM 与字节序按实际输出识别
+    for (const char* encoding : kBuiltinSbcsNames) {
+        if (std::string(encoding).rfind("MAC", 0) == 0) continue;  // glibc iconv 不提供 Mac 系列
+        SCOPED_TRACE(encoding);
+        const std::string bytes = DefinedSbcsBytes(*conv, encoding);
+
+        const auto native = conv->ConvertEncodingFast(bytes, encoding, "UTF-16LE");
+        const auto reference = conv->ConvertEncodingFast(bytes, encoding, "UTF-16");
+        ASSERT_TRUE(native.IsSuccess());
+        ASSERT_TRUE(reference.IsSuccess());
+
+        std::string ref = reference.GetValue();
+        bool big_endian = false;
+        if (ref.size() >= 2 && static_cast<uint8_t>(ref[0]) == 0xFE && static_cast<uint8_t>(ref[1]) == 0xFF) {
+            big_endian = true;
+            ref.erase(0, 2);
+        } else if (ref.size() >= 2 && static_cast<uint8_t>(ref[0]) == 0xFF && static_cast<uint8_t>(ref[1]) == 0xFE) {
+            ref.erase(0, 2);
+        }
+        if (big_endian) {
+            for (size_t i = 0; i + 1 < ref.size(); i += 2) std::swap(ref[i], ref[i + 1]);
+        }
+        EXPECT_EQ(native.GetValue(), ref);
+
+        // 未定义字节两边都拒绝
+        for (int b = 0x80; b < 256; ++b) {
+            const std::string one(1, static_cast<char>(b));
+            if (bytes.find(one) == std::string::npos) {
+                EXPECT_FALSE(conv->ConvertEncodingFast(one, encoding, "UTF-16").IsSuccess()) << b;
+            }
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, SbcsNative_RoundTripsThroughUtfForms) {
+    for (const char* encoding : kBuiltinSbcsNames) {
+        SCOPED_TRACE(encoding);
+        const std::string bytes = DefinedSbcsBytes(*conv, encoding);
+        ASSERT_GT(bytes.size(), 128u);
+        for (const char* utf : {"UTF-8", "UTF-16LE", "UTF-16BE", "UTF-32LE", "UTF-32BE"}) {
+            SCOPED_TRACE(utf);
+            const auto decoded = conv->ConvertEncodingFast(bytes, encoding, utf);
+            ASSERT_TRUE(decoded.IsSuccess());
+            const auto encoded = conv->ConvertEncodingFast(decoded.GetValue(), utf, encoding);
+            ASSERT_TRUE(encoded.IsSuccess());
+            EXPECT_EQ(encoded.GetValue(), bytes);
+        }
+    }
+
+    EXPECT_EQ(conv->ConvertEncodingFast("\x80", "CP1252", "UTF-8").GetValue(), "\xE2\x82\xAC");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xC1", "KOI8-R", "UTF-8").GetValue(), "\xD0\xB0");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xA4", "ISO-8859-15", "UTF-8").GetValue(), "\xE2\x82\xAC");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xC3\x84", "UTF-8", "macintosh").GetValue(), "\x80");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xC3\x84", "UTF-8", "MacRoman").GetValue(), "\x80");
+
+    // 长 ASCII 段与高位字节交错，覆盖向量扫描的块边界
+    std::string mixed;
+    for (int i = 0; i < 300; ++i) {
+        mixed += std::string(static_cast<size_t>(i % 70), 'a');
+        mixed += "\xC0\xFF";
+    }
+    const auto utf16 = conv->ConvertEncodingFast(mixed, "CP1251", "UTF-16BE");
+    ASSERT_TRUE(utf16.IsSuccess());
+    EXPECT_EQ(conv->ConvertEncodingFast(utf16.GetValue(), "UTF-16BE", "CP1251").GetValue(), mixed);
+}
+
+TEST_F(EncodingConversionTest, SbcsNative_CodepageToCodepageAndErrors) {
+    // "Вер"：CP1251 -> KOI8-R 直接查表转换
+    const auto koi8 = conv->ConvertEncodingFast("ab\xC2\xE5\xF0", "CP1251", "KOI8-R");
+    ASSERT_TRUE(koi8.IsSuccess());
+    EXPECT_EQ(koi8.GetValue(), "ab\xF7\xC5\xD2");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xE4", "ISO-8859-1", "KOI8-R").GetErrorCode(), ErrorCode::InvalidSequence);
+
+    // 未定义字节与无法映射的码点
+    EXPECT_EQ(conv->ConvertEncodingFast("x\x81", "CP1252", "UTF-8").GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast(chinese_text, "UTF-8", "ISO-8859-1").GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast("\xE2\x82", "UTF-8", "CP1252").GetErrorCode(), ErrorCode::IncompleteSequence);
+
+    std::vector<char> buffer(64);
+    size_t consumed = 0, written = 0;
+    const std::string input = "abc\xE2\x82\xAC" + chinese_text;
+    EXPECT_EQ(conv->ConvertInto(input, "UTF-8", "CP1252", buffer.data(), buffer.size(), consumed, written),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(consumed, 6u);
+    EXPECT_EQ(std::string(buffer.data(), written), "abc\x80");
+
+    ASSERT_EQ(conv->ConvertInto(std::string("caf\xE9"), "ISO-8859-1", "UTF-8", buffer.data(), buffer.size(),
+                                consumed, written), ErrorCode::Success);
+    EXPECT_EQ(std::string(buffer.data(), written), "caf\xC3\xA9");
+}
+
+// ============================================================================
+// 58. 内置双字节码页编解码（查表，码表未收录的字符交给 iconv）
+// ============================================================================
+
+namespace {
+
+const char* const kBuiltinDbcsNames[] = {"GBK", "GB2312", "GB18030", "BIG5", "SHIFT_JIS", "EUC-JP"};
+
+/// iconv "UTF-16"（带 BOM，不走内置内核）的结果，去掉 BOM 并统一为小端
+StringResult IconvUtf16Reference(UniConv& conv, const std::string& bytes, const char* encoding) {
+    auto result = conv.ConvertEncodingFast(bytes, encoding, "UTF-16");
+    if (!result.IsSuccess()) {
+        return result;
+    }
+    std::string ref = result.GetValue();
+    if (ref.size() >= 2 && static_cast<uint8_t>(ref[0]) == 0xFE && static_cast<uint8_t>(ref[1]) == 0xFF) {
+        ref.erase(0, 2);
+        for (size_t i = 0; i + 1 < ref.size(); i += 2) std::swap(ref[i], ref[i + 1]);
+    } else if (ref.size() >= 2 && static_cast<uint8_t>(ref[0]) == 0xFF && static_cast<uint8_t>(ref[1]) == 0xFE) {
+        ref.erase(0, 2);
+    }
+    return StringResult::Success(std::move(ref));
+}
+
+} // namespace
+
+TEST_F(EncodingConversionTest, DbcsNative_DecodeMatchesIconv) {
+    for (const char* encoding : kBuiltinDbcsNames) {
+        SCOPED_TRACE(encoding);
+        for (int lead = 0x80; lead < 256; ++lead) {
+            for (int trail = 0x20; trail < 256; ++trail) {
+                const std::string bytes{static_cast<char>(lead), static_cast<char>(trail)};
+                const auto native = conv->ConvertEncodingFast(bytes, encoding, "UTF-16LE");
+                const auto reference = IconvUtf16Reference(*conv, bytes, encoding);
+                ASSERT_EQ(native.GetErrorCode(), reference.GetErrorCode()) << lead << ' ' << trail;
+                if (reference.IsSuccess()) {
+                    ASSERT_EQ(native.GetValue(), reference.GetValue()) << lead << ' ' << trail;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, DbcsNative_RoundTripsThroughUtfForms) {
+    for (const char* encoding : kBuiltinDbcsNames) {
+        SCOPED_TRACE(encoding);
+        // 逐个可往返的双字节字符拼成长输入，中间穿插 ASCII
+        std::string bytes;
+        for (int lead = 0x81; lead < 0xFF; ++lead) {
+            for (int trail = 0x40; trail < 0xFF; ++trail) {
+                const std::string one{static_cast<char>(lead), static_cast<char>(trail)};
+                const auto utf8 = conv->ConvertEncodingFast(one, encoding, "UTF-8");
+                if (utf8.IsSuccess() && conv->ConvertEncodingFast(utf8.GetValue(), "UTF-8", encoding).GetValue() == one) {
+                    bytes += one;
+                    if (trail % 37 == 0) bytes += "ab";
+                }
+            }
+        }
+        ASSERT_GT(bytes.size(), 10000u);
+        for (const char* utf : {"UTF-8", "UTF-16LE", "UTF-16BE", "UTF-32LE", "UTF-32BE"}) {
+            SCOPED_TRACE(utf);
+            const auto decoded = conv->ConvertEncodingFast(bytes, encoding, utf);
+            ASSERT_TRUE(decoded.IsSuccess());
+            const auto encoded = conv->ConvertEncodingFast(decoded.GetValue(), utf, encoding);
+            ASSERT_TRUE(encoded.IsSuccess());
+            EXPECT_EQ(encoded.GetValue(), bytes);
+        }
+    }
+
+    EXPECT_EQ(conv->ConvertEncodingFast(chinese_text, "UTF-8", "GBK").GetValue(), "\xC4\xE3\xBA\xC3\xCA\xC0\xBD\xE7");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xE4\xB8\xAD", "UTF-8", "BIG5").GetValue(), "\xA4\xA4");
+    EXPECT_EQ(conv->ConvertEncodingFast("\x8F\xB0\xA1", "EUC-JP", "UTF-8").GetValue(), "\xE4\xB8\x82");
+    EXPECT_EQ(conv->ConvertEncodingFast("\x8E\xB1", "EUC-JP", "UTF-8").GetValue(), "\xEF\xBD\xB1");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xB1", "SHIFT_JIS", "UTF-16LE").GetValue(), std::string("\x71\xFF", 2));
+
+    // GB18030 四字节区间与辅助平面
+    EXPECT_EQ(conv->ConvertEncodingFast("\x81\x30\x81\x30", "GB18030", "UTF-8").GetValue(), "\xC2\x80");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xF0\x90\x80\x80", "UTF-8", "GB18030").GetValue(), "\x90\x30\x81\x30");
+    EXPECT_EQ(conv->ConvertEncodingFast("\x90\x30\x81\x30", "GB18030", "UTF-32LE").GetValue(),
+              std::string("\x00\x00\x01\x00", 4));
+}
+
+TEST_F(EncodingConversionTest, DbcsNative_ShiftJisRomanMatchesIconv) {
+    // Shift_JIS 的 0x5C / 0x7E 与 iconv 一样解码为 ¥ / ‾，ASCII 段整段复制与纯 ASCII 透传都不能越过它们
+    const std::string run(40, 'a');
+    for (const std::string& bytes : {std::string("a\\b~c"), std::string("\\~"), run + "\\" + run + "~" + run,
+                                     run + "\xB1\\\x82\xA0~", std::string("\x81\x5C\\")}) {
+        SCOPED_TRACE(bytes);
+        const auto reference = IconvUtf16Reference(*conv, bytes, "SHIFT_JIS");
+        ASSERT_TRUE(reference.IsSuccess());
+        EXPECT_EQ(conv->ConvertEncodingFast(bytes, "SHIFT_JIS", "UTF-16LE").GetValue(), reference.GetValue());
+        const auto utf8 = conv->ConvertEncodingFast(bytes, "SHIFT_JIS", "UTF-8");
+        ASSERT_TRUE(utf8.IsSuccess());
+        EXPECT_EQ(conv->ConvertEncodingFast(reference.GetValue(), "UTF-16LE", "UTF-8").GetValue(), utf8.GetValue());
+        size_t units = 0;
+        EXPECT_EQ(conv->CountOutputUnits(bytes, "SHIFT_JIS", "UTF-8", units), ErrorCode::Success);
+        EXPECT_EQ(units, utf8.GetValue().size());
+        // ¥ / ‾ 编码回 0x5C / 0x7E，输入可往返
+        EXPECT_EQ(conv->ConvertEncodingFast(utf8.GetValue(), "UTF-8", "SHIFT_JIS").GetValue(), bytes);
+    }
+    EXPECT_EQ(conv->ConvertEncodingFast("a\\b~c", "SHIFT_JIS", "UTF-8").GetValue(), "a\xC2\xA5" "b\xE2\x80\xBE" "c");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xE2\x80\xBE", "UTF-8", "SHIFT_JIS").GetValue(), "~");
+    // ASCII 的反斜杠与波浪号仍编码为 0x5C / 0x7E；EUC-JP 的 0x5C / 0x7E 是 ASCII
+    EXPECT_EQ(conv->ConvertEncodingFast("\\~", "UTF-8", "SHIFT_JIS").GetValue(), "\\~");
+    EXPECT_EQ(conv->ConvertEncodingFast("\\~", "EUC-JP", "UTF-8").GetValue(), "\\~");
+}
+
+TEST_F(EncodingConversionTest, DbcsNative_FallbackAndErrors) {
+    // 各码页自身的差异项（单字节欧元符号、GB2312 子集）按 iconv 的结果输出
+    EXPECT_EQ(conv->ConvertEncodingFast("\x80", "GBK", "UTF-8").GetValue(), "\xE2\x82\xAC");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xE2\x82\xAC", "UTF-8", "GBK").GetValue(), "\x80");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xE2\x82\xAC", "UTF-8", "GB18030").GetValue(), "\xA2\xE3");
+    EXPECT_EQ(conv->ConvertEncodingFast("\xE2\x82\xAC", "UTF-8", "GB2312").GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast("\xC2\xA5", "UTF-8", "SHIFT_JIS").GetValue(), "\x5C");
+
+    EXPECT_EQ(conv->ConvertEncodingFast("a\xD6", "GBK", "UTF-8").GetErrorCode(), ErrorCode::IncompleteSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast("\x81\x30\x81", "GB18030", "UTF-8").GetErrorCode(),
+              ErrorCode::IncompleteSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast("\xA0\x20", "EUC-JP", "UTF-8").GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingFast("a\xF0\x9F\x98\x80", "UTF-8", "GBK").GetErrorCode(),
+              ErrorCode::InvalidSequence);
+
+    std::vector<char> buffer(64);
+    size_t consumed = 0, written = 0;
+    const std::string input = "ab" + chinese_text + "\xF0\x9F\x98\x80";
+    EXPECT_EQ(conv->ConvertInto(input, "UTF-8", "GBK", buffer.data(), buffer.size(), consumed, written),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(consumed, 2 + chinese_text.size());
+    EXPECT_EQ(std::string(buffer.data(), written), "ab\xC4\xE3\xBA\xC3\xCA\xC0\xBD\xE7");
+
+    EXPECT_EQ(conv->ConvertInto(std::string("x\xC4\xE3\xBA"), "GBK", "UTF-16LE", buffer.data(), buffer.size(),
+                                consumed, written), ErrorCode::IncompleteSequence);
+    EXPECT_EQ(consumed, 3u);
+    EXPECT_EQ(std::string(buffer.data(), written), std::string("x\x00\x60\x4F", 4));
+}
+
+// ============================================================================
+// 59. 编码检测（DetectEncoding）
+// ============================================================================
+
+namespace {
+
+/// 我们今天在这里讨论一个重要的问题……
+const char* const kDetectChinese =
+    "\xE6\x88\x91\xE4\xBB\xAC\xE4\xBB\x8A\xE5\xA4\xA9\xE5\x9C\xA8\xE8\xBF\x99\xE9\x87\x8C\xE8\xAE\xA8"
+    "\xE8\xAE\xBA\xE4\xB8\x80\xE4\xB8\xAA\xE9\x87\x8D\xE8\xA6\x81\xE7\x9A\x84\xE9\x97\xAE\xE9\xA2\x98"
+    "\xE3\x80\x82\xE8\xBF\x99\xE4\xB8\xAA\xE9\x97\xAE\xE9\xA2\x98\xE5\x85\xB3\xE7\xB3\xBB\xE5\x88\xB0"
+    "\xE6\xAF\x8F\xE4\xB8\xAA\xE4\xBA\xBA\xE7\x9A\x84\xE7\x94\x9F\xE6\xB4\xBB\xE3\x80\x82";
+/// 我們今天在這裡討論……
+const char* const kDetectTraditional =
+    "\xE6\x88\x91\xE5\x80\x91\xE4\xBB\x8A\xE5\xA4\xA9\xE5\x9C\xA8\xE9\x80\x99\xE8\xA3\xA1\xE8\xA8\x8E"
+    "\xE8\xAB\x96\xE4\xB8\x80\xE5\x80\x8B\xE9\x87\x8D\xE8\xA6\x81\xE7\x9A\x84\xE5\x95\x8F\xE9\xA1\x8C"
+    "\xE3\x80\x82\xE9\x80\x99\xE5\x80\x8B\xE5\x95\x8F\xE9\xA1\x8C\xE9\x97\x9C\xE4\xBF\x82\xE5\x88\xB0"
+    "\xE6\xAF\x8F\xE5\x80\x8B\xE4\xBA\xBA\xE7\x9A\x84\xE7\x94\x9F\xE6\xB4\xBB\xE3\x80\x82";
+/// 今日はとても良い天気ですね……
+const char* const kDetectJapanese =
+    "\xE4\xBB\x8A\xE6\x97\xA5\xE3\x81\xAF\xE3\x81\xA8\xE3\x81\xA6\xE3\x82\x82\xE8\x89\xAF\xE3\x81\x84"
+    "\xE5\xA4\xA9\xE6\xB0\x97\xE3\x81\xA7\xE3\x81\x99\xE3\x81\xAD\xE3\x80\x82\xE7\xA7\x81\xE3\x81\xAF"
+    "\xE5\x8F\x8B\xE9\x81\x94\xE3\x81\xA8\xE4\xB8\x80\xE7\xB7\x92\xE3\x81\xAB\xE5\x85\xAC\xE5\x9C\x92"
+    "\xE3\x81\xB8\xE8\xA1\x8C\xE3\x81\x8D\xE3\x81\xBE\xE3\x81\x97\xE3\x81\x9F\xE3\x80\x82";
+/// 오늘은 날씨가 정말 좋습니다……
+const char* const kDetectKorean =
+    "\xEC\x98\xA4\xEB\x8A\x98\xEC\x9D\x80 \xEB\x82\xA0\xEC\x94\xA8\xEA\xB0\x80 \xEC\xA0\x95\xEB\xA7"
+    "\x90 \xEC\xA2\x8B\xEC\x8A\xB5\xEB\x8B\x88\xEB\x8B\xA4. \xEB\x82\x98\xEB\x8A\x94 \xEC\xB9\x9C\xEA"
+    "\xB5\xAC\xEC\x99\x80 \xED\x95\xA8\xEA\xBB\x98 \xEA\xB3\xB5\xEC\x9B\x90\xEC\x97\x90 \xEA\xB0\x94"
+    "\xEC\x8A\xB5\xEB\x8B\x88\xEB\x8B\xA4.";
+/// Привет, мир! ……
+const char* const kDetectRussian =
+    "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, \xD0\xBC\xD0\xB8\xD1\x80! \xD0\xA1\xD0\xB5\xD0"
+    "\xB3\xD0\xBE\xD0\xB4\xD0\xBD\xD1\x8F \xD0\xBC\xD1\x8B \xD0\xBF\xD0\xBE\xD0\xB3\xD0\xBE\xD0\xB2"
+    "\xD0\xBE\xD1\x80\xD0\xB8\xD0\xBC \xD0\xBE \xD1\x82\xD0\xBE\xD0\xBC, \xD0\xBA\xD0\xB0\xD0\xBA "
+    "\xD1\x80\xD0\xB0\xD0\xB1\xD0\xBE\xD1\x82\xD0\xB0\xD0\xB5\xD1\x82 \xD1\x81\xD0\xB8\xD1\x81\xD1"
+    "\x82\xD0\xB5\xD0\xBC\xD0\xB0.";
+/// Le café est très bon ……
+const char* const kDetectFrench =
+    "Le caf\xC3\xA9 est tr\xC3\xA8s bon \xC3\xA0 Paris, o\xC3\xB9 l'\xC3\xA9t\xC3\xA9 dernier \xC3"
+    "\xA9tait chaud.";
+/// Καλημέρα κόσμε. ……
+const char* const kDetectGreek =
+    "\xCE\x9A\xCE\xB1\xCE\xBB\xCE\xB7\xCE\xBC\xCE\xAD\xCF\x81\xCE\xB1 \xCE\xBA\xCF\x8C\xCF\x83\xCE"
+    "\xBC\xCE\xB5. \xCE\xA3\xCE\xAE\xCE\xBC\xCE\xB5\xCF\x81\xCE\xB1 \xCE\xB8\xCE\xB1 \xCE\xBC\xCE\xB9"
+    "\xCE\xBB\xCE\xAE\xCF\x83\xCE\xBF\xCF\x85\xCE\xBC\xCE\xB5 \xCE\xB3\xCE\xB9\xCE\xB1 \xCF\x84\xCE"
+    "\xB7\xCE\xBD \xCE\xB1\xCE\xBD\xCE\xAF\xCF\x87\xCE\xBD\xCE\xB5\xCF\x85\xCF\x83\xCE\xB7.";
+
+} // namespace
+
+TEST_F(EncodingConversionTest, DetectEncoding_BomAndWideForms) {
+    const auto utf8 = conv->DetectEncoding("\xEF\xBB\xBFhello");
+    ASSERT_EQ(utf8.count, 1u);
+    EXPECT_STREQ(utf8.Best(), "UTF-8");
+    EXPECT_EQ(utf8.bom_size, 3u);
+    EXPECT_FLOAT_EQ(utf8.candidates[0].confidence, 1.0f);
+
+    EXPECT_STREQ(conv->DetectEncoding(std::string("\xFF\xFEh\x00", 4)).Best(), "UTF-16LE");
+    EXPECT_STREQ(conv->DetectEncoding(std::string("\xFE\xFF\x00h", 4)).Best(), "UTF-16BE");
+    EXPECT_STREQ(conv->DetectEncoding(std::string("\xFF\xFE\x00\x00h\x00\x00\x00", 8)).Best(), "UTF-32LE");
+    EXPECT_EQ(conv->DetectEncoding(std::string("\x00\x00\xFE\xFF", 4)).bom_size, 4u);
+
+    // 无 BOM：按 NUL 字节位置识别
+    const std::string text = "Hello world, this is plain text.";
+    for (const char* wide : {"UTF-16LE", "UTF-16BE", "UTF-32LE", "UTF-32BE"}) {
+        SCOPED_TRACE(wide);
+        const auto result = conv->DetectEncoding(conv->ConvertEncodingFast(text, "UTF-8", wide).GetValue());
+        ASSERT_EQ(result.count, 1u);
+        EXPECT_STREQ(result.Best(), wide);
+        EXPECT_EQ(result.bom_size, 0u);
+    }
+
+    // 纯 ASCII 与空输入
+    const auto ascii = conv->DetectEncoding(text);
+    ASSERT_EQ(ascii.count, 1u);
+    EXPECT_STREQ(ascii.Best(), "UTF-8");
+    EXPECT_FLOAT_EQ(ascii.candidates[0].confidence, 1.0f);
+    const auto empty = conv->DetectEncoding("");
+    EXPECT_EQ(empty.count, 0u);
+    EXPECT_EQ(empty.Best(), nullptr);
+}
+
+TEST_F(EncodingConversionTest, DetectEncoding_RanksCodepages) {
+    const struct {
+        const char* text;
+        const char* encoding;
+    } cases[] = {
+        {kDetectChinese, "UTF-8"},       {kDetectChinese, "GBK"},        {kDetectTraditional, "BIG5"},
+        {kDetectJapanese, "SHIFT_JIS"},  {kDetectJapanese, "EUC-JP"},    {kDetectKorean, "EUC-KR"},
+        {kDetectRussian, "CP1251"},      {kDetectRussian, "KOI8-R"},     {kDetectFrench, "CP1252"},
+        {kDetectGreek, "CP1253"},        {kDetectJapanese, "UTF-8"},
+    };
+    for (const auto& c : cases) {
+        SCOPED_TRACE(c.encoding);
+        const auto encoded = conv->ConvertEncodingFast(c.text, "UTF-8", c.encoding);
+        ASSERT_TRUE(encoded.IsSuccess());
+        const auto result = conv->DetectEncoding(encoded.GetValue());
+        ASSERT_GE(result.count, 1u);
+        EXPECT_STREQ(result.Best(), c.encoding);
+        EXPECT_GT(result.candidates[0].confidence, 0.5f);
+        EXPECT_EQ(result.probed_bytes, encoded.GetValue().size());
+        for (size_t k = 1; k < result.count; ++k) {
+            EXPECT_LE(result.candidates[k].confidence, result.candidates[k - 1].confidence);
+        }
+        // 检测结果可直接用于转换
+        EXPECT_EQ(conv->ConvertEncodingFast(encoded.GetValue(), result.Best(), "UTF-8").GetValue(), c.text);
+    }
+
+    // GBK 之外的 GB18030 四字节序列淘汰 GBK
+    const auto gb18030 = conv->ConvertEncodingFast(std::string(kDetectChinese) + "\xF0\x9F\x98\x80", "UTF-8", "GB18030");
+    ASSERT_TRUE(gb18030.IsSuccess());
+    const auto result = conv->DetectEncoding(gb18030.GetValue());
+    EXPECT_STREQ(result.Best(), "GB18030");
+    for (size_t k = 0; k < result.count; ++k) {
+        EXPECT_STRNE(result.candidates[k].encoding, "GBK");
+    }
+
+    // 很短的输入也能排对，但置信度较低
+    const auto short_gbk = conv->DetectEncoding("\xD6\xD0\xCE\xC4");  // "中文"
+    EXPECT_STREQ(short_gbk.Best(), "GBK");
+    EXPECT_LT(short_gbk.candidates[0].confidence, 0.6f);
+}
+
+TEST_F(EncodingConversionTest, DetectEncoding_ProbeLimit) {
+    const std::string gbk = conv->ConvertEncodingFast(kDetectChinese, "UTF-8", "GBK").GetValue();
+
+    // 前缀全为 ASCII：其后的内容未读，置信度降低
+    const std::string input = std::string(4096, 'a') + gbk;
+    const auto prefix_only = conv->DetectEncoding(input, 1024);
+    EXPECT_EQ(prefix_only.probed_bytes, 1024u);
+    ASSERT_EQ(prefix_only.count, 1u);
+    EXPECT_LT(prefix_only.candidates[0].confidence, 1.0f);
+
+    EXPECT_STREQ(conv->DetectEncoding(input, 0).Best(), "GBK");
+    EXPECT_EQ(conv->DetectEncoding(input, 0).probed_bytes, input.size());
+
+    // probe 截断在双字节字符中间不淘汰候选；输入本身以不完整序列结尾则淘汰
+    EXPECT_STREQ(conv->DetectEncoding(gbk, gbk.size() - 1).Best(), "GBK");
+    const auto truncated = conv->DetectEncoding(gbk.substr(0, gbk.size() - 1));
+    for (size_t k = 0; k < truncated.count; ++k) {
+        EXPECT_STRNE(truncated.candidates[k].encoding, "GBK");
+    }
+
+    // 非法 UTF-8 不列出 UTF-8
+    const auto latin = conv->DetectEncoding("caf\xE9 cr\xE8me");
+    ASSERT_GE(latin.count, 1u);
+    EXPECT_STREQ(latin.Best(), "CP1252");
+    for (size_t k = 0; k < latin.count; ++k) {
+        EXPECT_STRNE(latin.candidates[k].encoding, "UTF-8");
+    }
+}
+
+// ============================================================================
+// 60. 校验与输出长度计算（Validate / CountOutputUnits，不写输出）
+// ============================================================================
+
+TEST_F(EncodingConversionTest, Validate_ReportsFirstErrorOffset) {
+    size_t offset = 0;
+    const std::string utf8 = std::string("abc") + kDetectChinese;
+    EXPECT_EQ(conv->Validate(utf8, "UTF-8", offset), ErrorCode::Success);
+    EXPECT_EQ(offset, utf8.size());
+    EXPECT_EQ(conv->Validate("", "UTF-8", offset), ErrorCode::Success);
+    EXPECT_EQ(offset, 0u);
+
+    // 非法字节、过长编码与代理项码点
+    EXPECT_EQ(conv->Validate(std::string(40, 'a') + "\xFF" + "b", "UTF-8", offset), ErrorCode::InvalidSequence);
+    EXPECT_EQ(offset, 40u);
+    EXPECT_EQ(conv->Validate("ab\xC0\xAF", "UTF-8", offset), ErrorCode::InvalidSequence);
+    EXPECT_EQ(offset, 2u);
+    EXPECT_EQ(conv->Validate("\xED\xA0\x80", "UTF-8", offset), ErrorCode::InvalidSequence);
+    EXPECT_EQ(offset, 0u);
+    EXPECT_EQ(conv->Validate("ab\xE4\xBD", "UTF-8", offset), ErrorCode::IncompleteSequence);
+    EXPECT_EQ(offset, 2u);
+
+    // UTF-16：孤立低代理、末尾高代理、奇数字节
+    EXPECT_EQ(conv->Validate(std::string("a\0\x00\xDC", 4), "UTF-16LE", offset), ErrorCode::InvalidSequence);
+    EXPECT_EQ(offset, 2u);
+    EXPECT_EQ(conv->Validate(std::string("\0a\xD8\x3D", 4), "UTF-16BE", offset), ErrorCode::IncompleteSequence);
+    EXPECT_EQ(offset, 2u);
+    EXPECT_EQ(conv->Validate(std::string("a\0b", 3), "UTF-16LE", offset), ErrorCode::IncompleteSequence);
+    EXPECT_EQ(offset, 2u);
+    EXPECT_EQ(conv->Validate(std::string("\x00\x00\x11\x00", 4), "UTF-32LE", offset), ErrorCode::InvalidSequence);
+
+    // 码页（内置码表与 iconv 路径）
+    const std::string gbk = conv->ConvertEncodingFast(kDetectChinese, "UTF-8", "GBK").GetValue();
+    EXPECT_EQ(conv->Validate(gbk, "GBK", offset), ErrorCode::Success);
+    EXPECT_EQ(conv->Validate(gbk + "\x81", "GBK", offset), ErrorCode::IncompleteSequence);
+    EXPECT_EQ(offset, gbk.size());
+    EXPECT_EQ(conv->Validate("ok\x81\x20", "GBK", offset), ErrorCode::InvalidSequence);
+    EXPECT_EQ(offset, 2u);
+    EXPECT_EQ(conv->Validate("\x80", "GBK", offset), ErrorCode::Success);  // 单字节欧元符号（iconv 回退）
+    EXPECT_EQ(conv->Validate("caf\xE9", "CP1252"), ErrorCode::Success);
+    EXPECT_EQ(conv->Validate("x\x81y", "CP1252", offset), ErrorCode::InvalidSequence);
+    EXPECT_EQ(offset, 1u);
+    const std::string euckr = conv->ConvertEncodingFast(kDetectKorean, "UTF-8", "EUC-KR").GetValue();
+    EXPECT_EQ(conv->Validate(euckr, "EUC-KR"), ErrorCode::Success);
+    EXPECT_EQ(conv->Validate("abc\xB0\x20", "EUC-KR", offset), ErrorCode::InvalidSequence);
+    EXPECT_EQ(offset, 3u);
+
+    EXPECT_EQ(conv->Validate("abc", nullptr), ErrorCode::InvalidParameter);
+    EXPECT_EQ(conv->Validate("abc", "NOT-AN-ENCODING"), ErrorCode::InvalidSourceEncoding);
+}
+
+TEST_F(EncodingConversionTest, CountOutputUnits_MatchesConversion) {
+    const std::string mixed = std::string("Hello, ") + kDetectChinese + " \xF0\x9F\x98\x80 caf\xC3\xA9 " +
+                              std::string(100, 'x') + kDetectJapanese;
+    const std::string gbk_text = std::string("GBK: ") + kDetectChinese;
+    const std::string sjis_text = std::string("SJIS: ") + kDetectJapanese;
+    const std::string cyrillic = std::string("Text: ") + kDetectRussian;
+    const std::string hangul = std::string("KR: ") + kDetectKorean;
+
+    struct Case { std::string utf8; const char* from; const char* to; };
+    const Case cases[] = {
+        {mixed, "UTF-8", "UTF-16LE"}, {mixed, "UTF-8", "UTF-16BE"}, {mixed, "UTF-8", "UTF-32LE"},
+        {mixed, "UTF-16LE", "UTF-8"}, {mixed, "UTF-16BE", "UTF-32BE"}, {mixed, "UTF-32LE", "UTF-16LE"},
+        {mixed, "UTF-8", "UTF-16"}, {mixed, "UTF-8", "UTF-8"},
+        {gbk_text, "UTF-8", "GBK"}, {gbk_text, "GBK", "UTF-16LE"}, {gbk_text, "GBK", "UTF-8"},
+        {gbk_text, "GBK", "GB18030"}, {hangul, "UTF-8", "EUC-KR"}, {hangul, "EUC-KR", "UTF-16BE"},
+        {mixed, "UTF-8", "GB18030"}, {mixed, "GB18030", "UTF-8"},
+        {sjis_text, "UTF-8", "SHIFT_JIS"}, {sjis_text, "SHIFT_JIS", "UTF-8"}, {sjis_text, "EUC-JP", "UTF-16LE"},
+        {cyrillic, "UTF-8", "CP1251"}, {cyrillic, "CP1251", "KOI8-R"}, {cyrillic, "KOI8-R", "UTF-32BE"},
+    };
+    for (const Case& c : cases) {
+        SCOPED_TRACE(std::string(c.from) + " -> " + c.to);
+        // 先从 UTF-8 得到源编码的输入，再与实际转换的输出长度比较
+        const std::string input = std::string(c.from) == "UTF-8"
+            ? c.utf8 : conv->ConvertEncodingFast(c.utf8, "UTF-8", c.from).GetValue();
+        ASSERT_FALSE(input.empty());
+        std::string output;
+        ASSERT_EQ(conv->ConvertEncodingFast(std::string_view(input), c.from, c.to, output), ErrorCode::Success);
+        const std::string target(c.to);
+        const size_t unit = target.find("32") != std::string::npos ? 4 : target.find("16") != std::string::npos ? 2 : 1;
+
+        size_t units = 0;
+        ASSERT_EQ(conv->CountOutputUnits(input, c.from, c.to, units), ErrorCode::Success);
+        EXPECT_EQ(units * unit, output.size());
+
+        const auto prepared = conv->Prepare(c.from, c.to);
+        size_t prepared_units = 0;
+        ASSERT_EQ(prepared.CountOutputUnits(input, prepared_units), ErrorCode::Success);
+        EXPECT_EQ(prepared_units, units);
+    }
+
+    // 失败时与转换报告同样的错误
+    size_t units = 0;
+    EXPECT_EQ(conv->CountOutputUnits("ab\xF0\x9F\x98\x80", "UTF-8", "GBK", units), ErrorCode::InvalidSequence);
+    EXPECT_EQ(units, 2u);
+    EXPECT_EQ(conv->CountOutputUnits("\xE4\xBD", "UTF-8", "UTF-16LE", units), ErrorCode::IncompleteSequence);
+    EXPECT_EQ(conv->CountOutputUnits("abc\xFF", "CP1252", "UTF-16LE", units), ErrorCode::Success);
+    EXPECT_EQ(units, 4u);
+    EXPECT_EQ(conv->CountOutputUnits("", "UTF-8", "UTF-16LE", units), ErrorCode::Success);
+    EXPECT_EQ(units, 0u);
+    EXPECT_EQ(conv->CountOutputUnits("abc", "UTF-8", "NOT-AN-ENCODING", units), ErrorCode::InvalidTargetEncoding);
+    EXPECT_EQ(conv->CountOutputUnits("abc", nullptr, "UTF-8", units), ErrorCode::InvalidParameter);
+}
+
+TEST_F(EncodingConversionTest, CountOutputUnits_DbcsPairsMatchIconvConversion) {
+    // 双字节码页之间由 iconv 转换，计数也须与之一致（含码表未收录的字符与错误码）
+    size_t units = 0;
+    EXPECT_EQ(conv->CountOutputUnits("\xA1\xA4", "GB2312", "BIG5", units), ErrorCode::Success);
+    EXPECT_EQ(units, conv->ConvertEncodingFast("\xA1\xA4", "GB2312", "BIG5").GetValue().size());
+
+    const std::pair<const char*, const char*> pairs[] = {
+        {"GB2312", "GBK"}, {"GBK", "GB2312"}, {"GB2312", "BIG5"}, {"BIG5", "GB2312"}, {"SHIFT_JIS", "EUC-JP"},
+    };
+    for (const auto& pair : pairs) {
+        SCOPED_TRACE(std::string(pair.first) + " -> " + pair.second);
+        for (int lead = 0x81; lead < 0xFF; ++lead) {
+            for (int trail = 0x40; trail < 0xFF; ++trail) {
+                const std::string bytes{static_cast<char>(lead), static_cast<char>(trail)};
+                std::string output;
+                const ErrorCode expected = conv->ConvertEncodingFast(std::string_view(bytes), pair.first,
+                                                                     pair.second, output);
+                ASSERT_EQ(conv->CountOutputUnits(bytes, pair.first, pair.second, units), expected) << lead << ' ' << trail;
+                if (expected == ErrorCode::Success) {
+                    ASSERT_EQ(units, output.size()) << lead << ' ' << trail;
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// 61. 容错转换（ErrorPolicy::Replace / Skip）
+// ============================================================================
+
+TEST_F(EncodingConversionTest, ErrorPolicy_ReplaceAndSkipResumeAfterBadSequence) {
+    // 截断的三字节序列按最大子部分只替换一次，紧随其后的 'A' 不被吞掉
+    const std::string dirty = "ab\xE4\xBD" "A\xFF" "c\xE4\xBD\xA0";
+    std::string output;
+    ConversionReport report;
+    ASSERT_EQ(conv->ConvertEncodingFast(dirty, "UTF-8", "UTF-16LE", output, ErrorPolicy::Replace, &report),
+              ErrorCode::Success);
+    EXPECT_EQ(output, std::string("a\0b\0\xFD\xFF" "A\0\xFD\xFF" "c\0\x60\x4F", 14));
+    EXPECT_EQ(report.replaced, 2u);
+    EXPECT_EQ(report.first_error_offset, 2u);
+    EXPECT_EQ(report.first_error, ErrorCode::InvalidSequence);
+
+    ASSERT_EQ(conv->ConvertEncodingFast(dirty, "UTF-8", "UTF-8", output, ErrorPolicy::Replace, &report),
+              ErrorCode::Success);
+    EXPECT_EQ(output, "ab\xEF\xBF\xBD" "A\xEF\xBF\xBD" "c\xE4\xBD\xA0");
+    EXPECT_EQ(report.replaced, 2u);
+
+    ASSERT_EQ(conv->ConvertEncodingFast(dirty, "UTF-8", "UTF-8", output, ErrorPolicy::Skip, &report),
+              ErrorCode::Success);
+    EXPECT_EQ(output, "abAc\xE4\xBD\xA0");
+    EXPECT_EQ(report.replaced, 2u);
+
+    // 目标无法表示的合法字符整字符替换；U+FFFD 也无法表示时使用 '?'
+    ASSERT_EQ(conv->ConvertEncodingFast("x\xF0\x9F\x98\x80y\xE4\xBD\xA0", "UTF-8", "GBK", output,
+                                        ErrorPolicy::Replace, &report), ErrorCode::Success);
+    EXPECT_EQ(output, "x?y\xC4\xE3");
+    EXPECT_EQ(report.first_error_offset, 1u);
+    ASSERT_EQ(conv->ConvertEncodingFast("caf\xC3\xA9 \xE4\xBD\xA0", "UTF-8", "ISO-8859-1", output,
+                                        ErrorPolicy::Replace, &report), ErrorCode::Success);
+    EXPECT_EQ(output, "caf\xE9 ?");
+
+    // 码页源：坏的首字节只跳过一个字节，尾随 ASCII 保留
+    ASSERT_EQ(conv->ConvertEncodingFast("a\x81" " b\xC4\xE3", "GBK", "UTF-8", output, ErrorPolicy::Skip, &report),
+              ErrorCode::Success);
+    EXPECT_EQ(output, "a b\xE4\xBD\xA0");
+    EXPECT_EQ(report.first_error_offset, 1u);
+
+    // 末尾不完整序列替换后结束
+    ASSERT_EQ(conv->ConvertEncodingFast("ok\xE4\xBD", "UTF-8", "UTF-32LE", output, ErrorPolicy::Replace, &report),
+              ErrorCode::Success);
+    EXPECT_EQ(output, std::string("o\0\0\0k\0\0\0\xFD\xFF\0\0", 12));
+    EXPECT_EQ(report.first_error, ErrorCode::IncompleteSequence);
+
+    // 带 BOM 的目标只在输出开头保留一个 BOM
+    std::string clean_utf16;
+    ASSERT_EQ(conv->ConvertEncodingFast(std::string_view("ab\xEF\xBF\xBD" "cd"), "UTF-8", "UTF-16", clean_utf16),
+              ErrorCode::Success);
+    ASSERT_EQ(conv->ConvertEncodingFast("ab\xFF" "cd", "UTF-8", "UTF-16", output, ErrorPolicy::Replace, &report),
+              ErrorCode::Success);
+    EXPECT_EQ(output, clean_utf16);
+}
+
+TEST_F(EncodingConversionTest, ErrorPolicy_StrictAndCleanInput) {
+    const std::string text = std::string("Hello ") + kDetectChinese + std::string(300, 'x');
+    std::string strict;
+    ASSERT_EQ(conv->ConvertEncodingFast(std::string_view(text), "UTF-8", "GBK", strict), ErrorCode::Success);
+
+    // 干净输入：三种策略与普通转换结果一致，报告为空
+    for (const ErrorPolicy policy : {ErrorPolicy::Strict, ErrorPolicy::Replace, ErrorPolicy::Skip}) {
+        std::string output;
+        ConversionReport report;
+        ASSERT_EQ(conv->ConvertEncodingFast(text, "UTF-8", "GBK", output, policy, &report), ErrorCode::Success);
+        EXPECT_EQ(output, strict);
+        EXPECT_TRUE(report.Clean());
+        EXPECT_EQ(report.first_error_offset, static_cast<size_t>(-1));
+    }
+
+    // Strict 失败时报告出错位置，不计入替换次数
+    std::string output;
+    ConversionReport report;
+    EXPECT_EQ(conv->ConvertEncodingFast("abc\xFF", "UTF-8", "UTF-16LE", output, ErrorPolicy::Strict, &report),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(report.first_error_offset, 3u);
+    EXPECT_EQ(report.replaced, 0u);
+
+    // PreparedConversion 与一次性接口一致
+    const auto prepared = conv->Prepare("GBK", "UTF-8");
+    ASSERT_EQ(prepared.Convert("\xC4\xE3\xFF\xC4\xE3", output, ErrorPolicy::Replace, &report), ErrorCode::Success);
+    EXPECT_EQ(output, "\xE4\xBD\xA0\xEF\xBF\xBD\xE4\xBD\xA0");
+    EXPECT_EQ(report.replaced, 1u);
+
+    EXPECT_EQ(conv->ConvertEncodingFast("abc", "UTF-8", "NOT-AN-ENCODING", output, ErrorPolicy::Replace),
+              ErrorCode::InvalidTargetEncoding);
+    EXPECT_EQ(conv->ConvertEncodingFast("abc", nullptr, "UTF-8", output, ErrorPolicy::Skip),
+              ErrorCode::InvalidParameter);
+}
+
+// ============================================================================
+// 62. iconv 描述符缓存（线程私有 CLOCK 槽位 + 分片空闲池）
+// ============================================================================
+
+TEST_F(EncodingConversionTest, DescriptorCache_ChurnBeyondCapacityReusesIdlePool) {
+    // 56 个 iconv 编码对（往返各一个），超过线程私有缓存的 32 个槽位：被挤出的描述符进入空闲池，下一轮从池中签出
+    const char* encodings[] = {
+        "EUC-KR", "euc-kr", "EUCKR", "euckr", "CP949", "EUC-TW", "CP932", "CP950",
+        "ISO-2022-JP", "ISO-2022-KR", "ISO-2022-CN", "UTF-7", "ARMSCII-8", "GEORGIAN-PS",
+        "VISCII", "CP1255", "TIS-620", "CP852", "CP855", "CP857", "CP860", "CP861",
+        "CP863", "CP864", "CP865", "CP869", "UTF-16", "UTF-32",
+    };
+    const std::string utf16_input("a\0b\0c\0", 6);
+
+    std::vector<std::string> expected;
+    auto run_round = [&](bool record) {
+        size_t index = 0;
+        for (const char* encoding : encodings) {
+            auto encoded = conv->ConvertEncodingFast(utf16_input, "UTF-16LE", encoding);
+            ASSERT_TRUE(encoded.IsSuccess()) << encoding;
+            auto decoded = conv->ConvertEncodingFast(encoded.GetValue(), encoding, "UTF-16LE");
+            ASSERT_TRUE(decoded.IsSuccess()) << encoding;
+            EXPECT_EQ(decoded.GetValue(), utf16_input) << encoding;
+            if (record) {
+                expected.push_back(encoded.GetValue());
+            } else {
+                EXPECT_EQ(encoded.GetValue(), expected[index]) << encoding;
+            }
+            ++index;
+        }
+    };
+
+    run_round(true);
+    const auto before = conv->GetPoolStatistics();
+    EXPECT_GT(before.iconv_cache_size, 0u);
+    EXPECT_LE(before.iconv_cache_size, 128u);
+
+    run_round(false);
+    const auto after = conv->GetPoolStatistics();
+    EXPECT_EQ(after.iconv_cache_misses, before.iconv_cache_misses);
+    EXPECT_GT(after.iconv_cache_hits, before.iconv_cache_hits);
+    EXPECT_LE(after.iconv_cache_size, 128u);
+}
+
+// ============================================================================
+// 63. EncodingHandle（按 encodings.inc 下标驻留的编码，免去每次调用的名称解析）
+// ============================================================================
+
+TEST_F(EncodingConversionTest, EncodingHandle_InternAndNames) {
+    using Encoding = UniConv::Encoding;
+    EXPECT_EQ(UniConv::InternEncoding("GBK"), UniConv::EncodingHandle(Encoding::gbk));
+    EXPECT_EQ(UniConv::InternEncoding("gbk"), UniConv::EncodingHandle(Encoding::gbk));
+    EXPECT_EQ(UniConv::InternEncoding("utf-16le"), UniConv::EncodingHandle(Encoding::utf_16le));
+    // 常见别名映射到同一编码的规范名
+    EXPECT_EQ(UniConv::InternEncoding("utf8"), UniConv::EncodingHandle(Encoding::utf_8));
+    EXPECT_EQ(UniConv::InternEncoding("LATIN1"), UniConv::EncodingHandle(Encoding::iso_8859_1));
+    EXPECT_EQ(UniConv::InternEncoding("SJIS"), UniConv::EncodingHandle(Encoding::shift_jis));
+
+    EXPECT_FALSE(UniConv::InternEncoding("NOT-AN-ENCODING").IsValid());
+    EXPECT_FALSE(UniConv::InternEncoding("").IsValid());
+    EXPECT_FALSE(UniConv::InternEncoding(nullptr).IsValid());
+    EXPECT_FALSE(UniConv::EncodingHandle().IsValid());
+
+    EXPECT_STREQ(UniConv::GetEncodingName(Encoding::euc_kr), "EUC-KR");
+    EXPECT_STREQ(UniConv::GetEncodingName(UniConv::InternEncoding("big5")), "BIG5");
+    EXPECT_EQ(UniConv::GetEncodingName(UniConv::EncodingHandle()), nullptr);
+}
+
+TEST_F(EncodingConversionTest, EncodingHandle_MatchesNameOverloads) {
+    using Encoding = UniConv::Encoding;
+    struct Case { std::string utf8; Encoding from; Encoding to; };
+    const std::string cjk = std::string("Hello ") + kDetectChinese;
+    const Case cases[] = {
+        {mixed_text, Encoding::utf_8, Encoding::utf_16le},     // 内置 UTF 内核
+        {mixed_text, Encoding::utf_16be, Encoding::utf_32le},
+        {cjk, Encoding::utf_8, Encoding::gbk},                 // 内置双字节码表
+        {cjk, Encoding::gb18030, Encoding::utf_8},
+        {std::string("KR: ") + kDetectKorean, Encoding::utf_8, Encoding::euc_kr},  // iconv
+        {mixed_text, Encoding::utf_8, Encoding::utf_16},       // iconv（带 BOM）
+        {cjk, Encoding::utf_8, Encoding::utf_8},               // 复制
+    };
+    for (const Case& c : cases) {
+        const char* from = UniConv::GetEncodingName(c.from);
+        const char* to = UniConv::GetEncodingName(c.to);
+        SCOPED_TRACE(std::string(from) + " -> " + to);
+        const std::string input = c.from == Encoding::utf_8
+            ? c.utf8 : conv->ConvertEncodingFast(c.utf8, "UTF-8", from).GetValue();
+
+        std::string by_name;
+        ASSERT_EQ(conv->ConvertEncodingFast(std::string_view(input), from, to, by_name), ErrorCode::Success);
+        for (int round = 0; round < 2; ++round) {  // 第二轮命中已计算的编码对表项
+            std::string by_handle;
+            ASSERT_EQ(conv->ConvertEncodingFast(input, c.from, c.to, by_handle), ErrorCode::Success);
+            EXPECT_EQ(by_handle, by_name);
+        }
+        EXPECT_EQ(conv->ConvertEncodingFast(input, c.from, c.to).GetValue(), by_name);
+
+        std::string stateless;
+        ASSERT_EQ(conv->ConvertEncodingStatelessFast(input, c.from, c.to, stateless), ErrorCode::Success);
+        EXPECT_EQ(stateless, by_name);
+
+        // 批量：连续存储与逐个结果两种形式
+        const std::string data = input + input;
+        const size_t offsets[] = {0, input.size(), data.size()};
+        std::string out_data;
+        std::vector<size_t> out_offsets;
+        ASSERT_EQ(conv->ConvertEncodingBatch(data, offsets, 2, c.from, c.to, out_data, out_offsets),
+                  ErrorCode::Success);
+        EXPECT_EQ(out_data, by_name + by_name);
+        const auto results = conv->ConvertEncodingBatch(std::vector<std::string>{input, input}, c.from, c.to);
+        ASSERT_EQ(results.size(), 2u);
+        EXPECT_EQ(results[1].GetValue(), by_name);
+    }
+}
+
+TEST_F(EncodingConversionTest, EncodingHandle_ErrorsMatchNameOverloads) {
+    using Encoding = UniConv::Encoding;
+    std::string output = "stale";
+    EXPECT_EQ(conv->ConvertEncodingFast("abc", UniConv::EncodingHandle(), Encoding::utf_8, output),
+              ErrorCode::InvalidSourceEncoding);
+    EXPECT_TRUE(output.empty());
+    EXPECT_EQ(conv->ConvertEncodingFast("abc", Encoding::utf_8, UniConv::InternEncoding("NOPE"), output),
+              ErrorCode::InvalidTargetEncoding);
+    EXPECT_EQ(conv->ConvertEncodingFast("ab\xFF", Encoding::utf_8, Encoding::utf_16le, output),
+              ErrorCode::InvalidSequence);
+    EXPECT_EQ(conv->ConvertEncodingStatelessFast("ab\xE4\xBD", Encoding::utf_8, Encoding::euc_kr, output),
+              ErrorCode::IncompleteSequence);
+
+    const auto results = conv->ConvertEncodingBatch(std::vector<std::string>{"ok", "bad\xFF", ""},
+                                                    Encoding::utf_8, Encoding::gbk);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0].IsSuccess());
+    EXPECT_EQ(results[1].GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_TRUE(results[2].IsSuccess());
+}
+
+// ============================================================================
+// 64. 融合转换流水线（BOM → 检测 → 转换 → 换行 / NUL 规整，按块一次完成）
+// ============================================================================
+
+namespace {
+
+/// 逐阶段参考实现：在 UTF-8 上把 CRLF / CR 改为 LF 并删除 NUL
+std::string NormalizeUtf8Reference(const std::string& text) {
+    std::string out;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\r') {
+            out += '\n';
+            if (i + 1 < text.size() && text[i + 1] == '\n') {
+                ++i;
+            }
+        } else if (text[i] != '\0') {
+            out += text[i];
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_F(EncodingConversionTest, Pipeline_MatchesSeparatePasses) {
+    struct Case {
+        const char* sample;
+        const char* from;
+        const char* to;
+    };
+    const Case cases[] = {
+        {kDetectChinese, "UTF-8", "UTF-16LE"}, {kDetectChinese, "UTF-8", "UTF-32BE"},  // 内置 UTF 内核
+        {kDetectChinese, "UTF-16BE", "UTF-8"},
+        {kDetectChinese, "GBK", "UTF-8"},      {kDetectChinese, "UTF-8", "GB18030"},   // 内置双字节码表
+        {kDetectKorean, "UTF-8", "EUC-KR"},    {kDetectChinese, "UTF-8", "UTF-16"},    // iconv（后者带 BOM）
+        {kDetectChinese, "UTF-8", "UTF-8"},                                            // 复制
+    };
+    for (const Case& c : cases) {
+        std::string utf8;
+        for (int i = 0; i < 40; ++i) {
+            // CRLF、孤立 CR、NUL 与多字节字符反复出现，小窗口下会落在各种块边界上
+            utf8 += std::string("line ") + std::to_string(i) + "\r\n" + c.sample + "\r";
+            utf8 += std::string("x\0y", 3) + (i % 3 == 0 ? "\r\r\n" : "\n");
+        }
+        const std::string input = conv->ConvertEncodingFast(utf8, "UTF-8", c.from).GetValue();
+        const std::string expected = conv->ConvertEncodingFast(NormalizeUtf8Reference(utf8), "UTF-8", c.to).GetValue();
+        ASSERT_FALSE(expected.empty());
+        for (size_t block : {size_t{64}, size_t{97}, UniConv::ConversionPipeline::DEFAULT_BLOCK_SIZE}) {
+            SCOPED_TRACE(std::string(c.from) + " -> " + c.to + " block " + std::to_string(block));
+            auto pipeline = conv->MakePipeline(c.from, c.to);
+            ASSERT_TRUE(pipeline.IsValid());
+            pipeline.NormalizeNewlines().StripNul().BlockSize(block);
+            std::string output;
+            const char* source = nullptr;
+            ASSERT_EQ(pipeline.Run(input, output, &source), ErrorCode::Success);
+            EXPECT_EQ(output, expected);
+            EXPECT_STREQ(source, c.from);
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, Pipeline_StagesToggleIndependently) {
+    const std::string input("a\r\nb\0c\rd", 8);
+    auto pipeline = conv->MakePipeline("UTF-8", "UTF-8");
+    EXPECT_EQ(pipeline.Run(input).GetValue(), input);
+    EXPECT_EQ(pipeline.NormalizeNewlines().Run(input).GetValue(), std::string("a\nb\0c\nd", 7));
+    EXPECT_EQ(pipeline.StripNul().Run(input).GetValue(), "a\nbc\nd");
+    EXPECT_EQ(pipeline.NormalizeNewlines(false).Run(input).GetValue(), "a\r\nbc\rd");
+}
+
+TEST_F(EncodingConversionTest, Pipeline_CopyRouteKeepsWideUnitsAligned) {
+    std::string utf8;
+    for (int i = 0; i < 40; ++i) {
+        utf8 += "x\r\n";
+    }
+    std::string long_utf8;
+    for (int i = 0; i < 600; ++i) {
+        long_utf8 += std::string("line ") + std::to_string(i) + "\r\n" + kDetectChinese + "\r";
+    }
+    // 同编码原样复制：奇数块长不得把 UTF-16/32 码元拆到两个窗口
+    for (const char* encoding : {"UTF-16LE", "UTF-16BE", "UTF-16", "UTF-32LE", "UTF-32BE"}) {
+        for (const std::string* text : {&utf8, &long_utf8}) {
+            const std::string input = conv->ConvertEncodingFast(*text, "UTF-8", encoding).GetValue();
+            const std::string expected =
+                conv->ConvertEncodingFast(NormalizeUtf8Reference(*text), "UTF-8", encoding).GetValue();
+            ASSERT_FALSE(expected.empty());
+            for (size_t block : {size_t{65}, size_t{66}, size_t{67}, size_t{97}}) {
+                SCOPED_TRACE(std::string(encoding) + " block " + std::to_string(block) + " size " +
+                             std::to_string(text->size()));
+                auto pipeline = conv->MakePipeline(encoding, encoding);
+                ASSERT_TRUE(pipeline.IsValid());
+                pipeline.NormalizeNewlines().BlockSize(block);
+                EXPECT_EQ(pipeline.Run(input).GetValue(), expected);
+            }
+        }
+    }
+}
+
+TEST_F(EncodingConversionTest, Pipeline_BomAndDetection) {
+    const std::string text = std::string(kDetectChinese) + "\r\n";
+
+    // BOM 覆盖声明的源编码并被剥离
+    const std::string utf16 = "\xFF\xFE" + conv->ConvertEncodingFast(text, "UTF-8", "UTF-16LE").GetValue();
+    auto pipeline = conv->MakePipeline("GBK", "UTF-8");
+    pipeline.StripBom();
+    std::string output;
+    const char* source = nullptr;
+    ASSERT_EQ(pipeline.Run(utf16, output, &source), ErrorCode::Success);
+    EXPECT_EQ(output, text);
+    EXPECT_STREQ(source, "UTF-16LE");
+
+    // 未剥离 BOM 时按声明编码原样转换（U+FEFF 保留）
+    const std::string utf8_bom = "\xEF\xBB\xBF" + text;
+    EXPECT_EQ(conv->MakePipeline("UTF-8", "UTF-8").Run(utf8_bom).GetValue(), utf8_bom);
+    EXPECT_EQ(conv->MakePipeline("UTF-8", "UTF-8").StripBom().Run(utf8_bom).GetValue(), text);
+
+    // 不声明源编码：无 BOM 时由首块检测
+    const std::string gbk = conv->ConvertEncodingFast(text, "UTF-8", "GBK").GetValue();
+    auto detecting = conv->MakePipeline(nullptr, "UTF-8");
+    ASSERT_TRUE(detecting.IsValid());
+    detecting.StripBom().NormalizeNewlines();
+    ASSERT_EQ(detecting.Run(gbk, output, &source), ErrorCode::Success);
+    EXPECT_STREQ(source, "GBK");
+    EXPECT_EQ(output, std::string(kDetectChinese) + "\n");
+
+    // 空输入无需源编码；检测关闭且未声明源编码则失败
+    EXPECT_EQ(detecting.Run("", output), ErrorCode::Success);
+    EXPECT_TRUE(output.empty());
+    detecting.DetectSource(false);
+    EXPECT_EQ(detecting.Run(gbk, output), ErrorCode::InvalidSourceEncoding);
+}
+
+TEST_F(EncodingConversionTest, Pipeline_StatefulTargetAcrossBlocks) {
+    std::string text;
+    for (int i = 0; i < 20; ++i) {
+        text += std::string("abc ") + kDetectJapanese + " ";
+    }
+    const std::string expected = conv->ConvertEncodingFast(text, "UTF-8", "ISO-2022-JP").GetValue();
+    auto pipeline = conv->MakePipeline("UTF-8", "ISO-2022-JP");
+    pipeline.BlockSize(70);
+    EXPECT_EQ(pipeline.Run(text).GetValue(), expected);
+    EXPECT_EQ(conv->MakePipeline("ISO-2022-JP", "UTF-8").BlockSize(64).Run(expected).GetValue(), text);
+}
+
+TEST_F(EncodingConversionTest, Pipeline_Errors) {
+    EXPECT_EQ(conv->MakePipeline("UTF-8", nullptr).GetStatus(), ErrorCode::InvalidParameter);
+    EXPECT_EQ(conv->MakePipeline("NOPE", "UTF-8").GetStatus(), ErrorCode::InvalidSourceEncoding);
+    EXPECT_EQ(conv->MakePipeline("UTF-8", "NOPE").GetStatus(), ErrorCode::InvalidTargetEncoding);
+    EXPECT_EQ(UniConv::ConversionPipeline().Run("abc").GetErrorCode(), ErrorCode::InvalidParameter);
+
+    std::string output = "stale";
+    auto pipeline = conv->MakePipeline("UTF-8", "UTF-16LE");
+    pipeline.NormalizeNewlines().BlockSize(64);
+    EXPECT_EQ(pipeline.Run(std::string(100, 'a') + "\xFF" + "b", output), ErrorCode::InvalidSequence);
+    EXPECT_TRUE(output.empty());
+    EXPECT_EQ(pipeline.Run(std::string(100, 'a') + "\xE4\xBD", output), ErrorCode::IncompleteSequence);
+
+    // 换行 / NUL 阶段只支持 ASCII 兼容与 UTF-16/32 目标
+    auto stateful = conv->MakePipeline("UTF-8", "UTF-7");
+    EXPECT_TRUE(stateful.Run("a\r\n").IsSuccess());
+    EXPECT_EQ(stateful.StripNul().Run("a\r\n", output), ErrorCode::InvalidParameter);
+}
+
+// ============================================================================
+// 65. Unicode 正规化（NFC / NFKC，与转换融合）
+// ============================================================================
+
+namespace {
+
+struct NormalizationVector {
+    const char* input;
+    const char* nfc;
+    const char* nfkc;
+};
+
+const NormalizationVector kNormalizationVectors[] = {
+    {"e\xCC\x81", "\xC3\xA9", "\xC3\xA9"},                                          // e + 组合尖音符
+    {"\xE2\x84\xAB", "\xC3\x85", "\xC3\x85"},                                      // U+212B 埃符号（单例分解）
+    {"\xC3\x85\xCC\x81", "\xC7\xBA", "\xC7\xBA"},                                  // 已组合字符继续组合
+    {"\xEF\xAC\x81", "\xEF\xAC\x81", "fi"},                                        // ﬁ 连字仅兼容分解
+    {"\xE2\x91\xA0", "\xE2\x91\xA0", "1"},                                          // ① 带圈数字
+    {"\xE1\x84\x80\xE1\x85\xA1\xE1\x86\xA8", "\xEA\xB0\x81", "\xEA\xB0\x81"},      // 谚文字母 LVT → 각
+    {"q\xCC\x87\xCC\xA3", "q\xCC\xA3\xCC\x87", "q\xCC\xA3\xCC\x87"},              // 组合符按 ccc 重排
+    {"\xE1\xB8\x8B\xCC\xA3", "\xE1\xB8\x8D\xCC\x87", "\xE1\xB8\x8D\xCC\x87"},     // ḋ + 下点 → ḍ + 上点
+    {"\xE3\x81\x8B\xE3\x82\x99", "\xE3\x81\x8C", "\xE3\x81\x8C"},                  // か + 浊音符 → が
+    {"\xE0\xA5\x98", "\xE0\xA4\x95\xE0\xA4\xBC", "\xE0\xA4\x95\xE0\xA4\xBC"},     // 组合排除字符保持分解
+};
+
+} // namespace
+
+TEST_F(EncodingConversionTest, Normalize_KnownVectors) {
+    std::string output;
+    for (const auto& v : kNormalizationVectors) {
+        SCOPED_TRACE(v.input);
+        ASSERT_EQ(UniConv::NormalizeUtf8(v.input, NormalizationForm::NFC, output), ErrorCode::Success);
+        EXPECT_EQ(output, v.nfc);
+        ASSERT_EQ(UniConv::NormalizeUtf8(v.input, NormalizationForm::NFKC, output), ErrorCode::Success);
+        EXPECT_EQ(output, v.nfkc);
+
+        // 嵌在上下文中：只有非正规片段被改写
+        const std::string wrapped = std::string("ab ") + v.input + " " + kDetectChinese;
+        ASSERT_EQ(UniConv::NormalizeUtf8(wrapped, NormalizationForm::NFC, output), ErrorCode::Success);
+        EXPECT_EQ(output, std::string("ab ") + v.nfc + " " + kDetectChinese);
+    }
+
+    // 已正规化的 ASCII / CJK 原样通过；None 为纯校验复制
+    for (const std::string& text : {ascii_text, chinese_text, mixed_text, full_text, emoji_text}) {
+        ASSERT_EQ(UniConv::NormalizeUtf8(text, NormalizationForm::NFKC, output), ErrorCode::Success);
+        EXPECT_EQ(output, text);
+    }
+    ASSERT_EQ(UniConv::NormalizeUtf8("e\xCC\x81", NormalizationForm::None, output), ErrorCode::Success);
+    EXPECT_EQ(output, "e\xCC\x81");
+
+    EXPECT_EQ(UniConv::NormalizeUtf8("ab\xFF", NormalizationForm::NFC, output), ErrorCode::InvalidSequence);
+    EXPECT_EQ(UniConv::NormalizeUtf8("ab\xE4\xBD", NormalizationForm::NFC, output), ErrorCode::IncompleteSequence);
+}
+
+TEST_F(EncodingConversionTest, Normalize_FusedWithConversion) {
+    std::string decomposed;
+    std::string composed;
+    for (int i = 0; i < 50; ++i) {
+        for (const auto& v : kNormalizationVectors) {
+            decomposed += v.input;
+            composed += v.nfc;
+        }
+        decomposed += ' ';
+        composed += ' ';
+    }
+
+    std::string output;
+    const std::string utf16 = conv->ConvertEncodingFast(decomposed, "UTF-8", "UTF-16LE").GetValue();
+    ASSERT_EQ(conv->ConvertEncodingFast(utf16, "UTF-16LE", "UTF-8", output, NormalizationForm::NFC),
+              ErrorCode::Success);
+    EXPECT_EQ(output, composed);
+    ASSERT_EQ(conv->ConvertEncodingFast(decomposed, "UTF-8", "UTF-8", output, NormalizationForm::NFC),
+              ErrorCode::Success);
+    EXPECT_EQ(output, composed);
+
+    // iconv 路由：GBK 文本本身已是 NFC，结果与普通转换一致
+    const std::string gbk = conv->ConvertEncodingFast(chinese_text, "UTF-8", "GBK").GetValue();
+    ASSERT_EQ(conv->ConvertEncodingFast(gbk, "GBK", "UTF-8", output, NormalizationForm::NFKC), ErrorCode::Success);
+    EXPECT_EQ(output, chinese_text);
+
+    // None 与普通重载一致；正规化只支持 UTF-8 目标
+    ASSERT_EQ(conv->ConvertEncodingFast(decomposed, "UTF-8", "UTF-8", output, NormalizationForm::None),
+              ErrorCode::Success);
+    EXPECT_EQ(output, decomposed);
+    EXPECT_EQ(conv->ConvertEncodingFast(decomposed, "UTF-8", "UTF-16LE", output, NormalizationForm::NFC),
+              ErrorCode::InvalidParameter);
+    EXPECT_EQ(conv->ConvertEncodingFast(decomposed, "NOPE", "UTF-8", output, NormalizationForm::NFC),
+              ErrorCode::InvalidSourceEncoding);
+
+    // 流水线小窗口：组合序列跨越窗口边界
+    for (size_t block : {size_t(64), size_t(100), size_t(4096)}) {
+        SCOPED_TRACE(block);
+        auto pipeline = conv->MakePipeline("UTF-16LE", "UTF-8");
+        pipeline.Normalize(NormalizationForm::NFC).BlockSize(block);
+        EXPECT_EQ(pipeline.Run(utf16).GetValue(), composed);
+
+        // UTF-8 源按字节整窗拷贝：窗口可能只含组合符的首字节，重排须跨窗口进行
+        auto utf8_pipeline = conv->MakePipeline("UTF-8", "UTF-8");
+        utf8_pipeline.Normalize(NormalizationForm::NFC).BlockSize(block);
+        EXPECT_EQ(utf8_pipeline.Run(decomposed).GetValue(), composed);
+        for (size_t n = block - 4; n <= block + 1; ++n) {
+            const std::string split = std::string(n, 'x') + "\xCC\x81\xCC\xA3";   // U+0301 U+0323
+            std::string expected;
+            ASSERT_EQ(UniConv::NormalizeUtf8(split, NormalizationForm::NFC, expected), ErrorCode::Success);
+            EXPECT_EQ(utf8_pipeline.Run(split).GetValue(), expected) << n;
+        }
+    }
+    for (size_t n : {size_t(65532), size_t(65533), size_t(65534)}) {
+        const std::string split = std::string(n, 'x') + "\xCC\x81\xCC\xA3";
+        for (NormalizationForm form : {NormalizationForm::NFC, NormalizationForm::NFKC}) {
+            std::string expected;
+            ASSERT_EQ(UniConv::NormalizeUtf8(split, form, expected), ErrorCode::Success);
+            ASSERT_EQ(conv->ConvertEncodingFast(split, "UTF-8", "UTF-8", output, form), ErrorCode::Success);
+            EXPECT_EQ(output, expected) << n;
+        }
+    }
+    EXPECT_EQ(conv->MakePipeline("UTF-8", "GBK").Normalize(NormalizationForm::NFC).Run("abc").GetErrorCode(),
+              ErrorCode::InvalidParameter);
+}
+
+TEST_F(EncodingConversionTest, Normalize_BatchOverloads) {
+    std::vector<std::string> inputs;
+    PackedBatch batch;
+    for (const auto& v : kNormalizationVectors) {
+        const std::string utf16 = conv->ConvertEncodingFast(v.input, "UTF-8", "UTF-16LE").GetValue();
+        inputs.push_back(utf16);
+        batch.Append(utf16);
+    }
+
+    const auto results = conv->ConvertEncodingBatch(inputs, "UTF-16LE", "UTF-8", NormalizationForm::NFKC);
+    ASSERT_EQ(results.size(), inputs.size());
+    std::string out_data;
+    std::vector<size_t> out_offsets;
+    std::vector<ErrorCode> errors;
+    ASSERT_EQ(conv->ConvertEncodingBatch(batch.data, batch.offsets.data(), batch.Count(), "UTF-16LE", "UTF-8",
+                                         out_data, out_offsets, NormalizationForm::NFKC, &errors),
+              ErrorCode::Success);
+    ASSERT_EQ(out_offsets.size(), batch.offsets.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        EXPECT_EQ(results[i].GetValue(), kNormalizationVectors[i].nfkc);
+        EXPECT_EQ(PackedValue(out_data, out_offsets, i), kNormalizationVectors[i].nfkc);
+        EXPECT_EQ(errors[i], ErrorCode::Success);
+    }
+
+    // 单项失败不影响其余项；非 UTF-8 目标整体拒绝
+    const auto mixed = conv->ConvertEncodingBatch({"e\xCC\x81", "\xFF", "\xEF\xAC\x81"}, "UTF-8", "UTF-8",
+                                                  NormalizationForm::NFKC);
+    ASSERT_EQ(mixed.size(), 3u);
+    EXPECT_EQ(mixed[0].GetValue(), "\xC3\xA9");
+    EXPECT_EQ(mixed[1].GetErrorCode(), ErrorCode::InvalidSequence);
+    EXPECT_EQ(mixed[2].GetValue(), "fi");
+    for (const auto& r : conv->ConvertEncodingBatch(inputs, "UTF-16LE", "GBK", NormalizationForm::NFC)) {
+        EXPECT_EQ(r.GetErrorCode(), ErrorCode::InvalidParameter);
+    }
+    EXPECT_EQ(conv->ConvertEncodingBatch(batch.data, batch.offsets.data(), batch.Count(), "UTF-16LE", "GBK",
+                                         out_data, out_offsets, NormalizationForm::NFC),
+              ErrorCode::InvalidParameter);
+}
+
+// ============================================================================
+// 66. 转换指标（UNICONV_ENABLE_METRICS：按编码对 / 路径的调用数、字节数与延迟直方图）
+// ============================================================================
+
+#if UNICONV_ENABLE_METRICS
+namespace {
+
+const PairMetrics* FindPairMetrics(const ConversionMetrics& metrics, const char* from, const char* to,
+                                   ConversionPath path) {
+    for (const auto& entry : metrics.pairs) {
+        if (entry.from_encoding == from && entry.to_encoding == to && entry.path == path) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t HistogramTotal(const PairMetrics& entry) {
+    uint64_t total = 0;
+    for (uint64_t count : entry.latency_buckets) {
+        total += count;
+    }
+    return total;
+}
+
+} // namespace
+#endif
+
+TEST_F(EncodingConversionTest, Metrics_RecordsPairsAndPaths) {
+    UniConv::ResetConversionMetrics();
+    std::string output;
+    const std::string japanese = std::string("JP: ") + kDetectJapanese;
+    ASSERT_EQ(conv->ConvertEncodingFast(chinese_text, "UTF-8", "UTF-16LE", output), ErrorCode::Success);
+    [[maybe_unused]] const size_t utf16_size = output.size();
+    ASSERT_EQ(conv->ConvertEncodingFast(chinese_text, "UTF-8", "UTF-16LE", output), ErrorCode::Success);
+    ASSERT_EQ(conv->ConvertEncodingFast(chinese_text, "UTF-8", "UTF-8", output), ErrorCode::Success);
+    ASSERT_EQ(conv->ConvertEncodingFast(ascii_text, "UTF-8", "GBK", output), ErrorCode::Success);
+    ASSERT_EQ(conv->ConvertEncodingFast(japanese, "UTF-8", "ISO-2022-JP", output), ErrorCode::Success);
+    ASSERT_EQ(conv->ConvertEncodingStatelessFast(japanese, "UTF-8", "ISO-2022-JP", output), ErrorCode::Success);
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string("ab\xFF"), "UTF-8", "UTF-16LE", output), ErrorCode::InvalidSequence);
+
+    const ConversionMetrics metrics = UniConv::GetConversionMetrics();
+    const std::string text = metrics.ToPrometheusText();
+    EXPECT_NE(text.find("# TYPE uniconv_conversions_total counter"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE uniconv_conversion_duration_seconds histogram"), std::string::npos);
+#if UNICONV_ENABLE_METRICS
+    ASSERT_TRUE(metrics.enabled);
+#ifdef UNICONV_HAS_SIMDUTF
+    const ConversionPath utf_path = ConversionPath::Simdutf;
+#else
+    const ConversionPath utf_path = ConversionPath::Native;
+#endif
+    const PairMetrics* utf16 = FindPairMetrics(metrics, "UTF-8", "UTF-16LE", utf_path);
+    ASSERT_NE(utf16, nullptr);
+    EXPECT_EQ(utf16->calls, 3u);
+    EXPECT_EQ(utf16->errors, 1u);
+    EXPECT_EQ(utf16->bytes_in, 2 * chinese_text.size() + 3);
+    EXPECT_EQ(utf16->bytes_out, 2 * utf16_size);
+    EXPECT_EQ(HistogramTotal(*utf16), utf16->calls);
+
+    const PairMetrics* copy = FindPairMetrics(metrics, "UTF-8", "UTF-8", ConversionPath::Copy);
+    ASSERT_NE(copy, nullptr);
+    EXPECT_EQ(copy->calls, 1u);
+    EXPECT_EQ(copy->bytes_out, chinese_text.size());
+    const PairMetrics* ascii = FindPairMetrics(metrics, "UTF-8", "GBK", ConversionPath::AsciiShortcut);
+    ASSERT_NE(ascii, nullptr);
+    EXPECT_EQ(ascii->bytes_in, ascii_text.size());
+    ASSERT_NE(FindPairMetrics(metrics, "UTF-8", "ISO-2022-JP", ConversionPath::Iconv), nullptr);
+    ASSERT_NE(FindPairMetrics(metrics, "UTF-8", "ISO-2022-JP", ConversionPath::StatelessIconv), nullptr);
+    EXPECT_EQ(metrics.pairs.front().calls, 3u);  // 按调用数降序
+
+    EXPECT_NE(text.find("uniconv_conversions_total{from=\"UTF-8\",to=\"UTF-16LE\",path=\"" +
+                        std::string(ConversionMetrics::PathName(utf_path)) + "\"} 3"),
+              std::string::npos);
+    EXPECT_NE(text.find("le=\"+Inf\"} 3"), std::string::npos);
+    for (size_t i = 1; i < PairMetrics::LATENCY_BUCKETS; ++i) {
+        EXPECT_GT(metrics.bucket_upper_seconds[i], metrics.bucket_upper_seconds[i - 1]);
+    }
+    EXPECT_TRUE(std::isinf(metrics.bucket_upper_seconds.back()));
+
+    // 重置只清零计数，序列保留；之后的调用从零开始累计
+    UniConv::ResetConversionMetrics();
+    for (const auto& entry : UniConv::GetConversionMetrics().pairs) {
+        EXPECT_EQ(entry.calls, 0u);
+        EXPECT_EQ(entry.bytes_in, 0u);
+        EXPECT_EQ(HistogramTotal(entry), 0u);
+    }
+    ASSERT_EQ(conv->ConvertEncodingFast(chinese_text, "UTF-8", "UTF-16LE", output), ErrorCode::Success);
+    const ConversionMetrics after_reset = UniConv::GetConversionMetrics();
+    utf16 = FindPairMetrics(after_reset, "UTF-8", "UTF-16LE", utf_path);
+    ASSERT_NE(utf16, nullptr);
+    EXPECT_EQ(utf16->calls, 1u);
+    EXPECT_EQ(utf16->bytes_in, chinese_text.size());
+#else
+    EXPECT_FALSE(metrics.enabled);
+    EXPECT_TRUE(metrics.pairs.empty());
+#endif
+}
+
+TEST_F(EncodingConversionTest, Metrics_ThreadShardsSurviveThreadExit) {
+    UniConv::ResetConversionMetrics();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([this] {
+            std::string output;
+            for (int i = 0; i < 25; ++i) {
+                conv->ConvertEncodingFast(chinese_text, "UTF-8", "UTF-32LE", output);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const ConversionMetrics metrics = UniConv::GetConversionMetrics();
+#if UNICONV_ENABLE_METRICS
+    uint64_t calls = 0;
+    uint64_t bytes_in = 0;
+    for (const auto& entry : metrics.pairs) {
+        if (entry.from_encoding == "UTF-8" && entry.to_encoding == "UTF-32LE") {
+            calls += entry.calls;
+            bytes_in += entry.bytes_in;
+        }
+    }
+    EXPECT_EQ(calls, 100u);
+    EXPECT_EQ(bytes_in, 100u * chinese_text.size());
+#else
+    EXPECT_TRUE(metrics.pairs.empty());
+#endif
+}
+
+// ============================================================================
+// 67. 追踪钩子（TraceHooks：转换、批量并行、描述符创建与缓冲池回退的 begin / end 区间）
+// ============================================================================
+
+namespace {
+
+struct RecordedSpan {
+    bool            begin;
+    std::thread::id thread;
+    TraceSpan       span;
+};
+
+struct SpanRecorder {
+    std::mutex                mutex;
+    std::vector<RecordedSpan> events;
+
+    static void Begin(void* user_data, const TraceSpan& span) {
+        static_cast<SpanRecorder*>(user_data)->Add(true, span);
+    }
+    static void End(void* user_data, const TraceSpan& span) {
+        static_cast<SpanRecorder*>(user_data)->Add(false, span);
+    }
+    void Add(bool begin, const TraceSpan& span) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back({begin, std::this_thread::get_id(), span});
+    }
+    size_t Count(TraceSpanKind kind, bool begin) const {
+        size_t n = 0;
+        for (const auto& e : events) {
+            n += (e.span.kind == kind && e.begin == begin) ? 1 : 0;
+        }
+        return n;
+    }
+    /// 每个线程上的 begin / end 必须严格嵌套且种类一致
+    bool WellNested() const {
+        std::map<std::thread::id, std::vector<TraceSpanKind>> stacks;
+        for (const auto& e : events) {
+            auto& stack = stacks[e.thread];
+            if (e.begin) {
+                stack.push_back(e.span.kind);
+            } else if (stack.empty() || stack.back() != e.span.kind) {
+                return false;
+            } else {
+                stack.pop_back();
+            }
+        }
+        for (const auto& entry : stacks) {
+            if (!entry.second.empty()) return false;
+        }
+        return true;
+    }
+};
+
+/// 测试结束时恢复为未安装
+struct ScopedTraceHooks {
+    explicit ScopedTraceHooks(const TraceHooks* hooks) { UniConv::SetTraceHooks(hooks); }
+    ~ScopedTraceHooks() { UniConv::SetTraceHooks(nullptr); }
+};
+
+} // namespace
+
+TEST_F(EncodingConversionTest, Tracing_ConversionAndDescriptorSpans) {
+    EXPECT_EQ(UniConv::GetTraceHooks(), nullptr);
+    SpanRecorder recorder;
+    const TraceHooks hooks{&recorder, &SpanRecorder::Begin, &SpanRecorder::End};
+    {
+        ScopedTraceHooks scoped(&hooks);
+        EXPECT_EQ(UniConv::GetTraceHooks(), &hooks);
+
+        std::string output;
+        ASSERT_EQ(conv->ConvertEncodingFast(std::string_view(chinese_text), "UTF-8", "UTF-16LE", output),
+                  ErrorCode::Success);
+        const size_t utf16_size = output.size();
+
+        // 新线程 + 新实例：线程缓存与空闲池都没有该编码对，必须 iconv_open
+        std::thread([] {
+            auto fresh = UniConv::Create();
+            std::string out;
+            EXPECT_EQ(fresh->ConvertEncodingFast(std::string_view("\xE3\x81\x82"), "UTF-8", "ISO-2022-JP", out),
+                      ErrorCode::Success);
+        }).join();
+
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        ASSERT_GE(recorder.events.size(), 2u);
+        const RecordedSpan& first = recorder.events[0];
+        EXPECT_TRUE(first.begin);
+        EXPECT_EQ(first.span.kind, TraceSpanKind::Conversion);
+        EXPECT_STREQ(first.span.from_encoding, "UTF-8");
+        EXPECT_STREQ(first.span.to_encoding, "UTF-16LE");
+        EXPECT_EQ(first.span.bytes_in, chinese_text.size());
+        const RecordedSpan& second = recorder.events[1];
+        EXPECT_FALSE(second.begin);
+        EXPECT_EQ(second.span.bytes_out, utf16_size);
+        EXPECT_EQ(second.span.result, ErrorCode::Success);
+#ifdef UNICONV_HAS_SIMDUTF
+        EXPECT_EQ(second.span.path, ConversionPath::Simdutf);
+#else
+        EXPECT_EQ(second.span.path, ConversionPath::Native);
+#endif
+        EXPECT_EQ(recorder.Count(TraceSpanKind::DescriptorOpen, true), 1u);
+        EXPECT_EQ(recorder.Count(TraceSpanKind::DescriptorOpen, false), 1u);
+        EXPECT_TRUE(recorder.WellNested());
+        EXPECT_STREQ(TraceSpan::KindName(TraceSpanKind::DescriptorOpen), "uniconv.iconv_open");
+    }
+
+    // 卸载后不再发出任何区间
+    const size_t before = recorder.events.size();
+    std::string output;
+    conv->ConvertEncodingFast(std::string_view(chinese_text), "UTF-8", "UTF-16LE", output);
+    EXPECT_EQ(recorder.events.size(), before);
+}
+
+TEST_F(EncodingConversionTest, Tracing_BatchParallelWorkerAndChunkSpans) {
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 256; ++i) {
+        std::string text;
+        while (text.size() < 8192) text += chinese_text;
+        inputs.push_back(std::move(text));
+    }
+    size_t total_bytes = 0;
+    for (const auto& input : inputs) total_bytes += input.size();
+
+    SpanRecorder recorder;
+    const TraceHooks hooks{&recorder, &SpanRecorder::Begin, &SpanRecorder::End};
+    std::vector<std::string> outputs;
+    {
+        ScopedTraceHooks scoped(&hooks);
+        ASSERT_TRUE(conv->ConvertEncodingBatchParallel(inputs, "UTF-8", "GB18030", outputs, 4));
+    }
+    ASSERT_EQ(outputs.size(), inputs.size());
+
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    EXPECT_TRUE(recorder.WellNested());
+    ASSERT_EQ(recorder.Count(TraceSpanKind::BatchParallel, true), 1u);
+    const RecordedSpan& batch = recorder.events.front();
+    EXPECT_EQ(batch.span.kind, TraceSpanKind::BatchParallel);
+    EXPECT_EQ(batch.span.items, inputs.size());
+    EXPECT_EQ(batch.span.bytes_in, total_bytes);
+    EXPECT_EQ(recorder.events.back().span.kind, TraceSpanKind::BatchParallel);
+    EXPECT_EQ(recorder.events.back().span.result, ErrorCode::Success);
+
+    // 各段恰好覆盖全部条目；每个出现过的线程各有一个 worker 区间
+    size_t chunk_items = 0;
+    size_t chunk_bytes = 0;
+    std::set<std::thread::id> chunk_threads;
+    for (const auto& e : recorder.events) {
+        if (e.span.kind == TraceSpanKind::BatchChunk && e.begin) {
+            chunk_items += e.span.items;
+            chunk_bytes += e.span.bytes_in;
+            chunk_threads.insert(e.thread);
+        }
+    }
+    EXPECT_EQ(chunk_items, inputs.size());
+    EXPECT_EQ(chunk_bytes, total_bytes);
+    EXPECT_GE(recorder.Count(TraceSpanKind::BatchChunk, true), 2u);
+    EXPECT_EQ(recorder.Count(TraceSpanKind::BatchWorker, true), chunk_threads.size());
+    EXPECT_EQ(recorder.Count(TraceSpanKind::BatchWorker, false), chunk_threads.size());
+}
+
+TEST_F(EncodingConversionTest, Tracing_BufferPoolFallbackSpan) {
+    StringBufferPool pool;
+    SpanRecorder recorder;
+    const TraceHooks hooks{&recorder, &SpanRecorder::Begin, &SpanRecorder::End};
+    std::vector<StringBufferPool::BufferLease> leases;
+    {
+        ScopedTraceHooks scoped(&hooks);
+        // 大档上限 32 个槽位：持有 40 个租约必然有回退分配
+        for (int i = 0; i < 40; ++i) {
+            leases.push_back(pool.acquire(size_t(1) << 17));
+        }
+    }
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    const size_t fallbacks = recorder.Count(TraceSpanKind::BufferPoolFallback, true);
+    EXPECT_GE(fallbacks, 8u);
+    EXPECT_EQ(recorder.Count(TraceSpanKind::BufferPoolFallback, false), fallbacks);
+    for (const auto& e : recorder.events) {
+        EXPECT_EQ(e.span.bytes_in, size_t(1) << 17);
+        EXPECT_EQ(e.span.from_encoding, nullptr);
+    }
+    size_t pooled = 0;
+    for (const auto& lease : leases) {
+        pooled += lease.is_from_pool() ? 1 : 0;
+    }
+    EXPECT_EQ(pooled + fallbacks, leases.size());
+}
+
+// ============================================================================
+// 68. 编码注册表（编译期完美哈希：名称校验、码页 ↔ 名称、InternEncoding）
+// ============================================================================
+
+TEST_F(EncodingConversionTest, Registry_CodePageLookups) {
+    EXPECT_EQ(UniConv::GetEncodingNameByCodePage(936), "GB2312");
+    EXPECT_EQ(UniConv::GetEncodingNameByCodePage(37), "IBM037");
+    EXPECT_EQ(UniConv::GetEncodingNameByCodePage(54936), "GB18030");
+    EXPECT_EQ(UniConv::GetEncodingNameByCodePage(12345), "Encoding not found.");
+    ASSERT_NE(conv->GetEncodingNamePtr(932), nullptr);
+    EXPECT_STREQ(conv->GetEncodingNamePtr(932), "Shift_JIS");
+    EXPECT_EQ(conv->GetEncodingNamePtr(0), nullptr);
+    EXPECT_EQ(conv->GetEncodingNamePtr(65002), nullptr);
+    EXPECT_EQ(conv->GetEncodingNameFast(51949).GetValue(), "EUC-KR");
+    EXPECT_EQ(conv->GetEncodingNameFast(1).GetErrorCode(), ErrorCode::EncodingNotFound);
+}
+
+TEST_F(EncodingConversionTest, Registry_NameValidationIsCaseSensitiveWithListedVariants) {
+    std::string output;
+    // 码页对照表、常见别名、内置单字节码页名称及其全小写形式
+    for (const char* name : {"Windows-1251", "CP1251", "cp1251", "koi8-r", "KOI8-R", "utf8", "Big5", "latin1"}) {
+        EXPECT_EQ(conv->ConvertEncodingFast(std::string_view("abc"), "UTF-8", name, output), ErrorCode::Success) << name;
+        EXPECT_EQ(output, "abc") << name;
+    }
+    // encodings.inc 中的规范名同样可用（句柄接口一直接受它们）
+    EXPECT_EQ(conv->ConvertEncodingFast(std::string_view("abc"), "UTF-8", "MacCroatian", output), ErrorCode::Success);
+    EXPECT_EQ(output, "abc");
+    // 未列出的大小写混写形式不被接受
+    for (const char* name : {"Koi8-R", "bIG5", "Utf-8x", "UTF-"}) {
+        EXPECT_EQ(conv->ConvertEncodingFast(std::string_view("abc"), "UTF-8", name, output),
+                  ErrorCode::InvalidTargetEncoding) << name;
+    }
+}
+
+TEST_F(EncodingConversionTest, Registry_InternEncodingCoversEveryCanonicalName) {
+    using Encoding = UniConv::Encoding;
+    for (size_t i = 0; i < static_cast<size_t>(Encoding::count); ++i) {
+        const auto enc = static_cast<Encoding>(i);
+        const std::string name = UniConv::ToString(enc);
+        const auto handle = UniConv::InternEncoding(name.c_str());
+        ASSERT_TRUE(handle.IsValid()) << name;
+        // 重复的规范名（如 wchar_t_encoding）解析到第一次出现的条目
+        EXPECT_EQ(UniConv::ToString(static_cast<Encoding>(handle.Index())), name);
+        EXPECT_LE(handle.Index(), i);
+    }
+    EXPECT_EQ(UniConv::InternEncoding("maccroatian"), UniConv::EncodingHandle(Encoding::mac_croatian));
+    EXPECT_EQ(UniConv::InternEncoding("Shift_Jis"), UniConv::EncodingHandle(Encoding::shift_jis));
+    EXPECT_FALSE(UniConv::InternEncoding("NOT-AN-ENCODING").IsValid());
+}
+
+TEST_F(EncodingConversionTest, Registry_InternEncodingAcceptsEveryValidName) {
+    using Encoding = UniConv::Encoding;
+    // 名称接口接受的名称：encodings.inc 规范名、各码页的 .NET 名称、iconv 码页名与常见别名（含大小写变体）
+    std::vector<std::string> names;
+    for (size_t i = 0; i < static_cast<size_t>(Encoding::count); ++i) {
+        names.push_back(UniConv::ToString(static_cast<Encoding>(i)));
+    }
+    for (int cp = 0; cp < 65536; ++cp) {
+        if (const char* name = conv->GetEncodingNamePtr(cp)) names.emplace_back(name);
+    }
+    for (const char* name : {"ANSI_X3.4-1968", "TCVN", "VISCII1.1", "ISO-8859-11", "GB2312", "gb2312", "EUC-CN",
+                             "euccn", "EUCCN", "us-ascii", "latin1", "sjis", "eucjp", "euckr", "utf16le", "CP437"}) {
+        names.emplace_back(name);
+    }
+    for (size_t i = 0, n = names.size(); i < n; ++i) {
+        std::string lower = names[i];
+        std::string upper = names[i];
+        for (char& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        for (char& c : upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        names.push_back(lower);
+        names.push_back(upper);
+    }
+
+    size_t accepted = 0;
+    std::string by_name;
+    std::string by_handle;
+    for (const std::string& name : names) {
+        const ErrorCode ec = conv->ConvertEncodingFast(std::string_view("abc"), "UTF-8", name.c_str(), by_name);
+        if (ec == ErrorCode::InvalidTargetEncoding) {
+            continue;
+        }
+        ++accepted;
+        const auto handle = UniConv::InternEncoding(name.c_str());
+        ASSERT_TRUE(handle.IsValid()) << name;
+        // 句柄与名称的转换结果一致（包括 iconv 打不开的名称）
+        EXPECT_EQ(conv->ConvertEncodingFast(std::string_view("abc"), Encoding::utf_8, handle, by_handle), ec) << name;
+        if (ec == ErrorCode::Success) {
+            EXPECT_EQ(by_handle, by_name) << name;
+        }
+    }
+    EXPECT_GT(accepted, 300u);
+
+    EXPECT_EQ(UniConv::InternEncoding("GB2312"), UniConv::EncodingHandle(Encoding::euc_cn));
+    EXPECT_STREQ(UniConv::GetEncodingName(UniConv::InternEncoding("ibm437")), "IBM437");
+    EXPECT_FALSE(UniConv::EncodingHandle(Encoding::count).IsValid());
+}